@@ -41,6 +41,11 @@
 #define ASPEP_PING_RESET         0
 #define ASPEP_PING_CFG           1
 
+/* Beacon bits 4..6 were the version field; bit 6 now offers the MCPA delta
+ * format. Controllers that predate it send 0 there and get raw async data. */
+#define ASPEP_BEACON_VERSION_MSK   0x30U
+#define ASPEP_BEACON_MCPA_DELTA    0x40U
+
 #define ASPEP_HEADER_SIZE        4
 #define ASPEP_CTRL_SIZE          4
 #define ASPEP_DATACRC_SIZE       2U
@@ -106,6 +111,7 @@ typedef struct
   uint8_t TXS_maxSize;
   uint8_t TXA_maxSize;
   uint8_t version;
+  uint8_t MCPA_DELTA;       /* Delta coded MCPA async buffers (MCTL_ASYNC_DELTA) */
 } ASPEP_Capabilities_def;
 
 /**
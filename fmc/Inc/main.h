@@ -96,6 +96,32 @@ void Error_Handler(void);
 #define TCK_GPIO_Port GPIOA
 
 /* USER CODE BEGIN Private defines */
+/* Motor 2 power stage (NBR_OF_MOTORS == 2), not in fmc.ioc: TIM8 CH1..3 high
+   sides, GPIO enables of the three half bridges, shunt amplifiers on ADC12_IN6..8,
+   gate driver fault on TIM8_BKIN2 (as M1_DP on TIM1_BKIN2).
+   The assignment below is a placeholder: once it matches the board, set
+   M2_PINS_PLACEHOLDER to 0, dual_drive.c refuses to build M2 until then. */
+#define M2_PINS_PLACEHOLDER 1
+#define M2_PWM_UH_Pin GPIO_PIN_6
+#define M2_PWM_UH_GPIO_Port GPIOC
+#define M2_PWM_VH_Pin GPIO_PIN_7
+#define M2_PWM_VH_GPIO_Port GPIOC
+#define M2_PWM_WH_Pin GPIO_PIN_8
+#define M2_PWM_WH_GPIO_Port GPIOC
+#define M2_PWM_EN_U_Pin GPIO_PIN_10
+#define M2_PWM_EN_U_GPIO_Port GPIOC
+#define M2_PWM_EN_V_Pin GPIO_PIN_11
+#define M2_PWM_EN_V_GPIO_Port GPIOC
+#define M2_PWM_EN_W_Pin GPIO_PIN_12
+#define M2_PWM_EN_W_GPIO_Port GPIOC
+#define M2_CURR_AMPL_U_Pin GPIO_PIN_0
+#define M2_CURR_AMPL_U_GPIO_Port GPIOC
+#define M2_CURR_AMPL_V_Pin GPIO_PIN_1
+#define M2_CURR_AMPL_V_GPIO_Port GPIOC
+#define M2_CURR_AMPL_W_Pin GPIO_PIN_2
+#define M2_CURR_AMPL_W_GPIO_Port GPIOC
+#define M2_DP_Pin GPIO_PIN_9
+#define M2_DP_GPIO_Port GPIOC
 
 /* USER CODE END Private defines */
 
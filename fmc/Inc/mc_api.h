@@ -179,6 +179,18 @@ MCI_State_t  MC_GetSTMStateMotor1(void);
 /* returns the current power of Motor 1 in float_t format */
 float_t MC_GetAveragePowerMotor1_F(void);
 
+#if (NBR_OF_MOTORS > 1)
+/* Motor 2 subset (dual drive, see mc_config.c) */
+bool MC_StartMotor2(void);
+bool MC_StopMotor2(void);
+void MC_ProgramSpeedRampMotor2(int16_t hFinalSpeed, uint16_t hDurationms);
+int16_t MC_GetMecSpeedAverageMotor2(void);
+bool MC_AcknowledgeFaultMotor2(void);
+uint16_t MC_GetOccurredFaultsMotor2(void);
+uint16_t MC_GetCurrentFaultsMotor2(void);
+MCI_State_t MC_GetSTMStateMotor2(void);
+#endif
+
 /* Call the Profiler command */
 uint8_t MC_ProfilerCommand (uint16_t rxLength, uint8_t *rxBuffer, int16_t txSyncFreeSpace, uint16_t *txLength, uint8_t *txBuffer);
 
@@ -59,6 +59,19 @@ extern SpeednTorqCtrl_Handle_t *pSTC[NBR_OF_MOTORS];
 extern MCI_Handle_t Mci[NBR_OF_MOTORS];
 extern SpeednTorqCtrl_Handle_t SpeednTorqCtrlM1;
 extern PID_Handle_t PIDSpeedHandle_M1;
+#if (NBR_OF_MOTORS > 1)
+extern PID_Handle_t PIDIqHandle_M2;
+extern PID_Handle_t PIDIdHandle_M2;
+extern PWMC_R3_2_Handle_t PWM_Handle_M2;
+extern PQD_MotorPowMeas_Handle_t PQD_MotorPowMeasM2;
+extern STO_Handle_t STO_M2;
+extern RevUpCtrl_Handle_t RevUpControlM2;
+extern STO_PLL_Handle_t STO_PLL_M2;
+extern CircleLimitation_Handle_t CircleLimitationM2;
+extern RampExtMngr_Handle_t RampExtMngrHFParamsM2;
+extern SpeednTorqCtrl_Handle_t SpeednTorqCtrlM2;
+extern PID_Handle_t PIDSpeedHandle_M2;
+#endif
 
 /* USER CODE BEGIN Additional extern */
 
@@ -38,6 +38,10 @@ extern RegConv_t VbusRegConv_M1;
 extern RDivider_Handle_t BusVoltageSensor_M1;
 extern PWMC_Handle_t *pwmcHandle[NBR_OF_MOTORS];
 extern NTC_Handle_t *pTemperatureSensor[NBR_OF_MOTORS];
+#if (NBR_OF_MOTORS > 1)
+extern VirtualSpeedSensor_Handle_t VirtualSpeedSensorM2;
+extern NTC_Handle_t TempSensor_M2;
+#endif
 
 /* USER CODE BEGIN Additional extern */
 
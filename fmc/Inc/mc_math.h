@@ -26,6 +26,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "mc_type.h"
+#include "cordic_batch.h"
 
 /** @addtogroup MCSDK
   * @{
@@ -132,6 +133,28 @@ alphabeta_t MCM_Rev_Park(qd_t Input, int16_t Theta);
   */
 Trig_Components MCM_Trig_Functions(int16_t hAngle);
 
+/**
+  * @brief  Starts a CORDIC cosine/sine computation without waiting for the result.
+  * @param  hAngle: angle in q1.15 format.
+  */
+void MCM_Trig_Start(int16_t hAngle);
+
+/**
+  * @brief  Returns the result of the computation started by MCM_Trig_Start().
+  * @retval Trig_Components Cos(angle) and Sin(angle) in Trig_Components format.
+  */
+Trig_Components MCM_Trig_Finish(void);
+
+/**
+  * @brief  MCM_Park() with precomputed cos/sin of the rotating frame angle.
+  */
+qd_t MCM_Park_Trig(alphabeta_t Input, Trig_Components Local_Vector_Components);
+
+/**
+  * @brief  MCM_Rev_Park() with precomputed cos/sin of the rotating frame angle.
+  */
+alphabeta_t MCM_Rev_Park_Trig(qd_t Input, Trig_Components Local_Vector_Components);
+
 /**
   * @brief  It calculates the square root of a non-negative s32. It returns 0 for negative s32.
   * @param  wInput int32_t number.
@@ -299,6 +322,7 @@ static inline int16_t MCM_Modulus(int16_t alpha, int16_t beta)
 {
   uint32_t temp_val;
   __disable_irq();
+  cordic_batch_claim();
   /* Configure and call to CORDIC- */
   WRITE_REG(CORDIC->CSR,CORDIC_CONFIG_MODULUS);
   LL_CORDIC_WriteData(CORDIC, (((uint32_t)beta << 16U) | (((uint32_t)alpha) & 0x0000FFFFU)));
@@ -309,11 +333,52 @@ static inline int16_t MCM_Modulus(int16_t alpha, int16_t beta)
   }
   /* Read computed modulus */
   temp_val = ((LL_CORDIC_ReadData(CORDIC) << 16U) >> 16U); /* Avoid Over/underflow when cast to int16_t */
+  cordic_batch_release();
   __enable_irq();
   return ((int16_t)temp_val);
 
 }
 
+/**
+  * @brief  Launches a CORDIC square root of @p wInput and returns immediately,
+  *         without masking interrupts. The CSR found on entry is returned so that
+  *         MCM_Sqrt_Finish() can put it back: a CORDIC user configured once
+  *         (MCM_Trig_Functions() callers, CLI batches) keeps its configuration.
+  * @note   Only for the highest priority CORDIC user (the HF task) or with
+  *         interrupts masked; a computation in flight in an interrupted user is
+  *         lost either way. Not between MCM_Trig_Start() and MCM_Trig_Finish().
+  *         The caller holds a cordic_batch_claim().
+  * @param  wInput strictly positive int32_t number.
+  * @retval uint32_t CORDIC CSR value to give to MCM_Sqrt_Finish().
+  */
+static inline uint32_t MCM_Sqrt_Start(int32_t wInput)
+{
+  uint32_t saved_csr = READ_REG(CORDIC->CSR);
+  WRITE_REG(CORDIC->CSR, CORDIC_CONFIG_SQRT);
+  LL_CORDIC_WriteData(CORDIC, ((uint32_t)wInput));
+  return (saved_csr);
+}
+
+/**
+  * @brief  Collects the square root launched by MCM_Sqrt_Start() and restores
+  *         the CORDIC configuration it replaced. Reading RDATA stalls only for
+  *         what is left of the CORDIC latency.
+  * @param  wSavedCSR value returned by MCM_Sqrt_Start().
+  * @retval int32_t Square root of the MCM_Sqrt_Start() input.
+  */
+static inline int32_t MCM_Sqrt_Finish(uint32_t wSavedCSR)
+{
+  uint32_t retVal;
+#ifndef FULL_MISRA_C_COMPLIANCY_MC_MATH
+  retVal = (LL_CORDIC_ReadData(CORDIC)) >> 15; //cstat !MISRAC2012-Rule-1.3_n !ATH-shift-neg !MISRAC2012-Rule-10.1_R6
+#else
+  retVal = (LL_CORDIC_ReadData(CORDIC)) / 32768U;
+#endif
+  /* RRDY is read-only */
+  WRITE_REG(CORDIC->CSR, wSavedCSR & ~CORDIC_CSR_RRDY);
+  return ((int32_t)retVal);
+}
+
 /**
   * @brief  It executes CORDIC algorithm for rotor position extraction from B-emf alpha and beta.
   * @param  wBemf_alfa_est estimated Bemf alpha on the stator reference frame.
@@ -324,6 +389,7 @@ static inline int16_t MCM_PhaseComputation(int32_t wBemf_alfa_est, int32_t wBemf
 {
 
   /* Configure and call to CORDIC */
+  cordic_batch_claim();
   WRITE_REG(CORDIC->CSR,CORDIC_CONFIG_PHASE);
   LL_CORDIC_WriteData(CORDIC, (uint32_t)wBemf_alfa_est);
   LL_CORDIC_WriteData(CORDIC, (uint32_t)wBemf_beta_est);
@@ -331,6 +397,7 @@ static inline int16_t MCM_PhaseComputation(int32_t wBemf_alfa_est, int32_t wBemf
   /* Read computed angle */
   uint32_t result;
   result = LL_CORDIC_ReadData(CORDIC) >> 16U;
+  cordic_batch_release();
   return ((int16_t)result);
 
 }
@@ -31,6 +31,9 @@
 /* USER CODE END Additional include */
 
 extern const R3_2_Params_t R3_2_ParamsM1;
+#if (NBR_OF_MOTORS > 1)
+extern const R3_2_Params_t R3_2_ParamsM2;
+#endif
 
 extern ScaleParams_t scaleParams_M1;
 
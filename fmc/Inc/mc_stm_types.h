@@ -107,7 +107,10 @@
   #include "stm32g4xx_ll_spi.h"
 
 /* Make this define visible for all projects */
+/* Overridable on the command line: 2 adds the M2 drive on TIM8 (see mc_config.c) */
+#ifndef NBR_OF_MOTORS
 #define NBR_OF_MOTORS             1
+#endif
 
 __STATIC_INLINE void LL_DMA_ClearFlag_TC(DMA_TypeDef *DMAx, uint32_t Channel)
 {
@@ -34,6 +34,14 @@
 #define DMACH_TX_A LL_DMA_CHANNEL_2
 
 #define MCP_USER_CALLBACK_MAX 2U
+/* User command slot of the register pages (RI_RegPageCommand), MCP header 0x0100 | motor */
+#define MCP_USER_CMD_REG_PAGE 0U
+
+/* Data CRC offered in the beacon (1U) or not (0U); the controller's beacon
+ * decides, see ASPEP_CheckBeacon. CRC-16 in crc16.h */
+#define ASPEP_DATA_CRC 1U
+/* Delta coded MCPA async buffers offered in the beacon (1U) or not (0U) */
+#define ASPEP_MCPA_DELTA 1U
 
 #define MCP_TX_SYNC_PAYLOAD_MAX 256U
 #define MCP_RX_SYNC_PAYLOAD_MAX 256U
@@ -157,6 +157,12 @@
 #define PQD_CONVERSION_FACTOR               (float_t)(((1.732 * ADC_REFERENCE_VOLTAGE) /\
                                             (RSHUNT * AMPLIFICATION_GAIN)) / 65536.0f)
 
+/* Motor 2 (NBR_OF_MOTORS == 2): same motor and power stage as Motor 1, driven by
+   TIM8 at the same PWM frequency, so its timings alias the Motor 1 ones */
+#define PWM_PERIOD_CYCLES2                  PWM_PERIOD_CYCLES
+#define REP_COUNTER2                        REP_COUNTER
+#define M2_VIRTUAL_HEAT_SINK_TEMPERATURE_VALUE M1_VIRTUAL_HEAT_SINK_TEMPERATURE_VALUE
+
 /****** Prepares the UI configurations according the MCconfxx settings ********/
 #define DAC_ENABLE
 #define DAC_OP_ENABLE
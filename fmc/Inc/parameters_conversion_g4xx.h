@@ -39,6 +39,8 @@
 /*************************  IRQ Handler Mapping  *********************/
 #define TIMx_UP_M1_IRQHandler            TIM1_UP_TIM16_IRQHandler
 #define TIMx_BRK_M1_IRQHandler           TIM1_BRK_TIM15_IRQHandler
+#define TIMx_UP_M2_IRQHandler            TIM8_UP_IRQHandler
+#define TIMx_BRK_M2_IRQHandler           TIM8_BRK_IRQHandler
 
 #define ADC_TRIG_CONV_LATENCY_CYCLES     3.5
 #define ADC_SAR_CYCLES                   12.5
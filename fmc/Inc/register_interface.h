@@ -259,6 +259,52 @@
 #define HF_CMD_NOK                      0x01U
 #define HF_ERROR_UNKNOWN_REG            0x05U
 
+/* Scalar register access rights */
+#define RI_REG_R                        0x01U
+#define RI_REG_W                        0x02U
+#define RI_REG_RW                       (RI_REG_R | RI_REG_W)
+
+/* Register pages, MCP user command MCP_USER_CMD_REG_PAGE */
+#define RI_PAGE_DEFINE                  0x00U
+#define RI_PAGE_READ                    0x01U
+#define RI_PAGE_WRITE                   0x02U
+#define RI_PAGE_NBR                     4U
+#define RI_PAGE_MAX_REG                 32U
+
+/**
+  * @brief  Descriptor of a scalar (8, 16 or 32-bit) register
+  *
+  * The accessors convert between the protocol unit of the register and the firmware unit
+  * (rpm for speeds, float bit pattern for the motor power...).
+  */
+typedef struct
+{
+  uint16_t regID;                            /*!< MC_REG_xxx, type bits included; sort key of the table */
+  uint8_t access;                            /*!< RI_REG_R and/or RI_REG_W */
+  void *obj;                                 /*!< Instance handed to the accessors */
+  int32_t (*get)(void *obj);                 /*!< Returns the value in protocol unit, MC_NULL reads 0 */
+  void (*set)(void *obj, int32_t value);     /*!< Applies a value in protocol unit, MC_NULL ignores it */
+} RI_RegDesc_t;
+
+/**
+  * @brief  Scalar registers of one motor (or the global ones), sorted by regID
+  */
+typedef struct
+{
+  const RI_RegDesc_t *table;
+  uint16_t nbrOfReg;
+} RI_RegMap_t;
+
+/**
+  * @brief  Register page: descriptors resolved when the page is defined
+  */
+typedef struct
+{
+  const RI_RegDesc_t *reg[RI_PAGE_MAX_REG];
+  uint8_t nbrOfReg;
+  uint16_t size;                             /*!< Bytes of the page values */
+} RI_RegPage_t;
+
 uint8_t RI_SetRegisterGlobal(uint16_t regID, uint8_t typeID, uint8_t *data, uint16_t *size, int16_t dataAvailable);
 
 uint8_t RI_SetRegisterMotor1(uint16_t regID,  uint8_t typeID,uint8_t *data, uint16_t *size, int16_t dataAvailable);
@@ -269,6 +315,11 @@ uint8_t RI_GetRegisterMotor1(uint16_t regID, uint8_t typeID, uint8_t * data, uin
 
 uint8_t RI_MovString(const char_t * srcString, char_t * destString, uint16_t *size, int16_t maxSize);
 
+const RI_RegMap_t *RI_GetRegMap(uint8_t motorID);
+const RI_RegDesc_t *RI_FindReg(const RI_RegMap_t *pMap, uint16_t regID);
+uint8_t RI_RegPageCommand(uint16_t rxLength, uint8_t *rxBuffer, int16_t txSyncFreeSpace, uint16_t *txLength,
+                          uint8_t *txBuffer);
+
 uint8_t HF_GetPtrReg(uint16_t dataID, void **dataPtr);
 uint8_t HF_GetIDSize(uint16_t dataID);
 
@@ -30,6 +30,33 @@
 /* Includes ------------------------------------------------------------------*/
 #include "mc_type.h"
 
+/* Exported defines ----------------------------------------------------------*/
+
+/**
+  * @brief Selects the regular conversion backend.
+  *
+  * - 0: conversions are scheduled one at a time by the high frequency task
+  *      (RCM_ExecNextConv() / RCM_ReadOngoingConv()), as in the original MC SDK.
+  * - 1: all registered conversions of an ADC form one regular scan sequence started by a
+  *      hardware trigger (#RCM_DMA_TRIGGER). A circular DMA channel stores the results in a
+  *      double buffer and RCM_GetRegularConv() returns the last complete sequence. The high
+  *      frequency task does not access the regular group. Conversions on an ADC without DMA
+  *      sequence (other than ADC1/ADC2) are polled by RCM_ExecRegularConv() instead.
+  */
+#ifndef RCM_USE_DMA
+#define RCM_USE_DMA  1
+#endif
+
+#define RCM_DMA_TRIG_TIM1_TRGO2  0U /*!< TIM1 TRGO2 on update: one sequence per PWM period */
+#define RCM_DMA_TRIG_TIM6_TRGO   1U /*!< TIM6 TRGO on update, at the TIM6 time base rate */
+
+/**
+  * @brief Hardware trigger of the regular sequences when #RCM_USE_DMA is 1.
+  */
+#ifndef RCM_DMA_TRIGGER
+#define RCM_DMA_TRIGGER  RCM_DMA_TRIG_TIM1_TRGO2
+#endif
+
 /** @addtogroup MCSDK
   * @{
   */
@@ -71,14 +98,23 @@ void RCM_ReadOngoingConv(void);
 /*  Function used to execute an already registered regular conversion */
 uint16_t RCM_ExecRegularConv(RegConv_t *regConv);
 
+#if (RCM_USE_DMA == 1)
+/* Returns the result of a registered conversion from the last complete DMA sequence. */
+uint16_t RCM_ReadDMAConv(const RegConv_t *regConv);
+#endif
+
 /* This function is used to read the result of a regular conversion stored in the data structure. */
 static inline uint16_t RCM_GetRegularConv(const RegConv_t *regConv)
 {
+#if (RCM_USE_DMA == 1)
+  return (RCM_ReadDMAConv(regConv));
+#else
 #ifdef NULL_PTR_CHECK_REG_CON_MNG
   return ((MC_NULL == regConv) ? 0U : regConv->data);
 #else
   return (regConv->data);
 #endif
+#endif
 }
 
 /* This function is used to wait for a the result of a regular conversion. */
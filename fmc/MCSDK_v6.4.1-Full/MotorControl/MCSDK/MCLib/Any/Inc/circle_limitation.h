@@ -47,11 +47,29 @@ typedef struct
   uint16_t MaxVd;                   /**<  Circle limitation maximum allowed module */
 } CircleLimitation_Handle_t;
 
+/* Current loop circle limitation: 1 = Circle_Limitation_Cordic() (constant
+ * time, CORDIC root started before the limit test), 0 = Circle_Limitation() */
+#if !defined (CIRCLE_LIMITATION_CORDIC)
+#if defined CIRCLE_LIMITATION_SQRT_M0
+#define CIRCLE_LIMITATION_CORDIC  0
+#else
+#define CIRCLE_LIMITATION_CORDIC  1
+#endif
+#endif
+
 /* Exported functions ------------------------------------------------------- */
 
 /* Returns the saturated @f$v_q, v_d@f$ component values */
 qd_t Circle_Limitation(const CircleLimitation_Handle_t *pHandle, qd_t Vqd);
 
+#if !defined CIRCLE_LIMITATION_SQRT_M0
+/*
+ * Same saturated values as Circle_Limitation(), with one CORDIC square root
+ * on every call instead of an MCM_Sqrt() call on the over-limit branches
+ */
+qd_t Circle_Limitation_Cordic(const CircleLimitation_Handle_t *pHandle, qd_t Vqd);
+#endif
+
 /**
   * @}
   */
@@ -53,6 +53,13 @@ typedef struct
   uint16_t bufferIndex;               /*!< Index of the position inside the bufer, a new buffer is allocated when bufferIndex = 0. */
   uint16_t bufferTxTrigger;           /*!< Threshold upon which data is dumped. */
   uint16_t bufferTxTriggerBuff;       /*!< Buffered version of bufferTxTrigger. */
+  uint16_t bufferTxTriggerDelta;      /*!< Threshold for MCTL_ASYNC_DELTA buffers (3 bytes worst case per HF value), 0 if the buffer is too small. */
+  uint16_t bufferTxTriggerDeltaBuff;  /*!< Buffered version of bufferTxTriggerDelta. */
+  uint16_t hfBytes;                   /*!< Copy plan, compiled by MCPA_cfgLog: bytes of one HF sample (raw format). */
+  uint16_t hfBytesBuff;               /*!< Buffered version of hfBytes. */
+  uint16_t mfBytes;                   /*!< Copy plan: bytes of one MF dump, sum of the MF sizes. */
+  uint16_t mfBytesBuff;               /*!< Buffered version of mfBytes. */
+  uint16_t *deltaPrevTable;           /*!< 2 * nbrOfDataLog entries: last and previous HF value logged per channel, predictor history. NULL disables the delta format. */
 #ifdef MCP_DEBUG_METRICS
   uint16_t bufferMissed;              /*!< Incremented each time a buffer is missed. Debug only. */
 #endif
@@ -69,6 +76,8 @@ typedef struct
   uint8_t MFNumBuff;                  /*!< Buffered version of MFNum. */
   uint8_t Mark;                       /*!< Configuration of the ASYNC communication. */
   uint8_t MarkBuff;                   /*!< Buffered version of Mark. */
+  uint8_t asyncIdBuff;                /*!< Format of the current buffer (MCTL_ASYNC_RAW / MCTL_ASYNC_DELTA), sent as ASYNCID. */
+  uint8_t deltaHistory;               /*!< HF samples already in the current delta buffer (saturates at 2): selects keyframe, 1st or 2nd order prediction. */
 } MCPA_Handle_t; /* MCP Async handle type */
 
 
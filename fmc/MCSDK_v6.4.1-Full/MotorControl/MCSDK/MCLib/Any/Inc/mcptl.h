@@ -30,6 +30,10 @@
 #define MCTL_ASYNC ( uint8_t )0x9U
 #define MCTL_SYNC_NOT_EXPECTED 1
 
+/* Async payload formats, sent as the ASYNCID byte after the MARK */
+#define MCTL_ASYNC_RAW   ( uint8_t )0x0U /* HF values as raw 16-bit words */
+#define MCTL_ASYNC_DELTA ( uint8_t )0x1U /* HF keyframe then zig-zag varint prediction residuals, see mcpa.c */
+
 
 typedef struct MCTL_Handle MCTL_Handle_t; //cstat !MISRAC2012-Rule-2.4
 typedef bool (* MCTL_GetBuf)(MCTL_Handle_t *pHandle, void **buffer, uint8_t syncAsync);
@@ -66,6 +70,7 @@ struct MCTL_Handle
   uint16_t txSyncMaxPayload;
   uint16_t txAsyncMaxPayload;
   bool MCP_PacketAvailable; /* Packet available for Motor control protocol*/
+  uint8_t txAsyncFormat;    /* MCTL_ASYNC_RAW or MCTL_ASYNC_DELTA, as negotiated by the transport layer */
 } ;
 
 bool MCTL_decodeCRCData(MCTL_Handle_t *pHandle);
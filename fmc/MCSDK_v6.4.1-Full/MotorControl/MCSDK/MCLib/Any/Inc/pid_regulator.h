@@ -225,6 +225,12 @@ void PID_SetKDDivisorPOW2(PID_Handle_t *pHandle, uint16_t hKdDivisorPOW2);
  */
 int16_t PI_Controller(PID_Handle_t *pHandle, int32_t wProcessVarError);
 
+/*
+ * Computes the outputs of the q and d axis current PI regulators in one call,
+ * bit-exact with two PI_Controller() calls
+ */
+qd_t PI_Controller_dq(PID_Handle_t *pHandleQ, PID_Handle_t *pHandleD, int32_t wErrorQ, int32_t wErrorD);
+
 /* 
  * Computes the output of a PID Regulator component, sum of its proportional, 
  * integral and derivative terms
@@ -147,6 +147,103 @@ __weak qd_t Circle_Limitation(const CircleLimitation_Handle_t *pHandle, qd_t Vqd
   return (local_vqd);
 }
 
+#if !defined CIRCLE_LIMITATION_SQRT_M0
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__((section(".ccmram")))
+#endif
+#endif
+/**
+  * @brief  Returns the saturated @f$v_q, v_d@f$ component values, bit-exact
+  *         with Circle_Limitation()
+  * @param  pHandle Handler of the CircleLimitation component
+  * @param  Vqd @f$v_q, v_d@f$ values
+  * @retval Saturated @f$v_q, v_d@f$ values
+  *
+  * Both over-limit branches of Circle_Limitation() take the root of
+  * @f$MaxModule^2 - \min(v_d^2, MaxVd^2)@f$ and saturate @f$v_d@f$ to MaxVd.
+  * That root is launched on the CORDIC (MCM_Sqrt_Start()) before the limit
+  * test and collected after it, on every call: the execution time no longer
+  * depends on the branch, and the interrupt masking and the call of MCM_Sqrt()
+  * are gone. The CORDIC configuration found on entry is restored.
+  *
+  * @note   Runs in the HF task after MCM_Trig_Finish(), like the current loop.
+  */
+__weak qd_t Circle_Limitation_Cordic(const CircleLimitation_Handle_t *pHandle, qd_t Vqd)
+{
+  qd_t local_vqd = Vqd;
+#ifdef NULL_PTR_CHECK_CRC_LIM
+  if (MC_NULL == pHandle)
+  {
+    local_vqd.q = 0;
+    local_vqd.d = 0;
+  }
+  else
+  {
+#endif
+    int32_t maxModule;
+    int32_t maxVd;
+    int32_t square_q;
+    int32_t square_temp;
+    int32_t square_d;
+    int32_t square_sum;
+    int32_t square_limit;
+    int32_t vd_square_limit;
+    int32_t new_q;
+    int32_t new_d;
+    uint32_t saved_csr;
+
+    maxModule = (int32_t)pHandle->MaxModule;
+    maxVd = (int32_t)pHandle->MaxVd;
+
+    square_d = ((int32_t)(Vqd.d)) * Vqd.d;
+    square_limit = maxModule * maxModule;
+    vd_square_limit = maxVd * maxVd;
+    if (square_d <= vd_square_limit)
+    {
+      square_temp = square_limit - square_d;
+      new_d = Vqd.d;
+    }
+    else
+    {
+      square_temp = square_limit - vd_square_limit;
+      new_d = (Vqd.d < 0) ? -maxVd : maxVd;
+    }
+    /* MCM_Sqrt() returns 0 without touching the CORDIC for a non-positive input */
+    saved_csr = MCM_Sqrt_Start((square_temp > 0) ? square_temp : 1);
+
+    square_q = ((int32_t)(Vqd.q)) * Vqd.q;
+    square_sum = square_q + square_d;
+
+    new_q = MCM_Sqrt_Finish(saved_csr);
+    new_q = (square_temp > 0) ? new_q : 0;
+    if (Vqd.q < 0)
+    {
+      new_q = -new_q;
+    }
+    else
+    {
+      /* Nothing to do */
+    }
+
+    if (square_sum > square_limit)
+    {
+      local_vqd.q = (int16_t)new_q;
+      local_vqd.d = (int16_t)new_d;
+    }
+    else
+    {
+      /* Nothing to do */
+    }
+#ifdef NULL_PTR_CHECK_CRC_LIM
+  }
+#endif
+  return (local_vqd);
+}
+#endif
+
 /**
   * @}
   */
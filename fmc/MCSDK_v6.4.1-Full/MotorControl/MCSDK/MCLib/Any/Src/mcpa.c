@@ -27,6 +27,10 @@
 
 uint32_t GLOBAL_TIMESTAMP = 0U;
 static void MCPA_stopDataLog(MCPA_Handle_t *pHandle);
+static void MCPA_sendBuffer(MCPA_Handle_t *pHandle);
+static uint16_t MCPA_logHFDelta(MCPA_Handle_t *pHandle, uint16_t index);
+static void MCPA_gatherHF(const MCPA_Handle_t *pHandle, uint8_t *dst);
+static void MCPA_gatherMF(const MCPA_Handle_t *pHandle, uint8_t *dst);
 
 /** @addtogroup MCSDK
   * @{
@@ -36,6 +40,158 @@ static void MCPA_stopDataLog(MCPA_Handle_t *pHandle);
   * @{
   */
 
+/**
+  * @brief  Copies the HF values of one sample (raw format) to @p dst
+  *
+  * Two 16-bit values are gathered per 32-bit store, and the buffer index is
+  * advanced once by the caller (hfBytesBuff) instead of per value: with stores
+  * through a uint16_t pointer the compiler has to assume they may alias
+  * pHandle->bufferIndex and reloads it on every iteration.
+  * @p dst may be unaligned (after delta coded data or odd MF sizes); the
+  * Cortex-M4 accepts unaligned STR.
+  *
+  * @param  *pHandle Pointer to the MCPA Handle
+  * @param  *dst Position of the sample in the current buffer
+  */
+static void MCPA_gatherHF(const MCPA_Handle_t *pHandle, uint8_t *dst)
+{
+  void * const *src = pHandle->dataPtrTableBuff;
+  uint8_t n = pHandle->HFNumBuff;
+  uint8_t i = 0U;
+
+  for (; (i + 2U) <= n; i += 2U)
+  {
+    uint32_t pair = (uint32_t)*((const uint16_t *)src[i]) //cstat !MISRAC2012-Rule-11.5
+                  | ((uint32_t)*((const uint16_t *)src[i + 1U]) << 16U); //cstat !MISRAC2012-Rule-11.5
+    (void)memcpy(&dst[2U * i], &pair, 4U);
+  }
+  if (i < n)
+  {
+    uint16_t last = *((const uint16_t *)src[i]); //cstat !MISRAC2012-Rule-11.5
+    (void)memcpy(&dst[2U * i], &last, 2U);
+  }
+}
+
+/**
+  * @brief  Copies the MF values (1, 2 or 4 bytes each, in configuration order) to @p dst
+  *
+  * The order is the one the controller asked for in MCPA_cfgLog, so it cannot be
+  * regrouped by size; each copy has a constant size and the caller advances the
+  * buffer index once by mfBytesBuff.
+  *
+  * @param  *pHandle Pointer to the MCPA Handle
+  * @param  *dst Position of the MF values in the current buffer
+  */
+static void MCPA_gatherMF(const MCPA_Handle_t *pHandle, uint8_t *dst)
+{
+  uint8_t *out = dst;
+  uint8_t i;
+
+  for (i = pHandle->HFNumBuff; i < (pHandle->MFNumBuff + pHandle->HFNumBuff); i++)
+  {
+    switch (pHandle->dataSizeTableBuff[i])
+    {
+      case 1U:
+      {
+        *out = *((const uint8_t *)pHandle->dataPtrTableBuff[i]); //cstat !MISRAC2012-Rule-11.5
+        out = &out[1];
+        break;
+      }
+      case 2U:
+      {
+        (void)memcpy(out, pHandle->dataPtrTableBuff[i], 2U);
+        out = &out[2];
+        break;
+      }
+      case 4U:
+      {
+        (void)memcpy(out, pHandle->dataPtrTableBuff[i], 4U);
+        out = &out[4];
+        break;
+      }
+      default:
+      {
+        /* Unknown size: keep the layout mfBytes was computed with */
+        out = &out[pHandle->dataSizeTableBuff[i]];
+        break;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Writes the HF values of one sample in the MCTL_ASYNC_DELTA format
+  *
+  * The first sample of a buffer is a keyframe: each value stored raw on 16 bits,
+  * so every buffer decodes on its own. The next samples store, per channel, the
+  * 16-bit wrapped difference with a prediction: the previous value for the
+  * second sample, 2*x[n-1] - x[n-2] (delta of the delta) afterwards, so that
+  * sine-like currents and ramps leave only a few LSB. The difference is zig-zag
+  * mapped (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...) and written as a little-endian
+  * base-128 varint: 1 byte for |diff| < 64, 2 bytes below 8192, 3 bytes otherwise.
+  * The output is not aligned; MCPA_gatherMF copies the MF values that follow
+  * byte-exact.
+  *
+  * @param  *pHandle Pointer to the MCPA Handle
+  * @param  index Position of the sample in the current buffer
+  *
+  * @return Position following the sample
+  */
+static uint16_t MCPA_logHFDelta(MCPA_Handle_t *pHandle, uint16_t index)
+{
+  uint8_t *out = &pHandle->currentBuffer[index];
+  uint16_t *prev1 = pHandle->deltaPrevTable;
+  uint16_t *prev2 = &pHandle->deltaPrevTable[pHandle->nbrOfDataLog];
+  uint8_t i;
+
+  for (i = 0U; i < pHandle->HFNumBuff; i++)
+  {
+    uint16_t value = *((uint16_t *) pHandle->dataPtrTableBuff[i]); //cstat !MISRAC2012-Rule-11.5
+    if (0U == pHandle->deltaHistory)
+    {
+      out[0] = (uint8_t)(value & 0xFFU);
+      out[1] = (uint8_t)(value >> 8U);
+      out = &out[2];
+    }
+    else
+    {
+      uint16_t predict = (1U == pHandle->deltaHistory) ? prev1[i]
+                                                       : (uint16_t)((2U * prev1[i]) - prev2[i]);
+      int16_t delta = (int16_t)(uint16_t)(value - predict);
+      uint32_t zigzag = (delta >= 0) ? ((uint32_t)delta << 1U)
+                                     : ((((uint32_t)(-(int32_t)delta)) << 1U) - 1U);
+      while (zigzag >= 0x80U)
+      {
+        *out = (uint8_t)(zigzag | 0x80U);
+        out++;
+        zigzag >>= 7U;
+      }
+      *out = (uint8_t)zigzag;
+      out++;
+    }
+    prev2[i] = prev1[i];
+    prev1[i] = value;
+  }
+  if (pHandle->deltaHistory < 2U)
+  {
+    pHandle->deltaHistory++;
+  }
+  return ((uint16_t)(out - pHandle->currentBuffer));
+}
+
+/**
+  * @brief  Closes the current buffer with the MARK and ASYNCID bytes and sends it
+  *
+  * @param  *pHandle Pointer to the MCPA Handle
+  */
+static void MCPA_sendBuffer(MCPA_Handle_t *pHandle)
+{
+  pHandle->currentBuffer[pHandle->bufferIndex] = pHandle->MarkBuff;
+  pHandle->currentBuffer[pHandle->bufferIndex + 1U] = pHandle->asyncIdBuff;
+  pHandle->pTransportLayer->fSendPacket(pHandle->pTransportLayer, pHandle->currentBuffer,
+                                        pHandle->bufferIndex + 2U, MCTL_ASYNC);
+}
+
 /**
   * @brief  Allocates and fills buffer with asynchronous data to be sent to controller
   *
@@ -52,8 +208,7 @@ void MCPA_dataLog(MCPA_Handle_t *pHandle)
   {
 #endif
     uint32_t *logValue;
-    uint16_t *logValue16;
-    uint8_t i;
+    uint16_t txTrigger;
 
     if (pHandle->HFIndex == pHandle->HFRateBuff) /*  */
     {
@@ -89,14 +244,27 @@ void MCPA_dataLog(MCPA_Handle_t *pHandle)
             pHandle->HFRateBuff          = pHandle->HFRate;
             pHandle->MFRateBuff          = pHandle->MFRate;
             pHandle->bufferTxTriggerBuff = pHandle->bufferTxTrigger;
+            pHandle->bufferTxTriggerDeltaBuff = pHandle->bufferTxTriggerDelta;
+            pHandle->hfBytesBuff         = pHandle->hfBytes;
+            pHandle->mfBytesBuff         = pHandle->mfBytes;
 
-            /* We store pointer here, so 4 bytes */
+            /* We store pointer here, so 4 bytes on target (sizeof keeps the host build right) */
             (void)memcpy(pHandle->dataPtrTableBuff, pHandle->dataPtrTable,
-                         ((uint32_t)pHandle->HFNum + (uint32_t)pHandle->MFNum) * 4U); /* We store pointer here,
-                                                                                         so 4 bytes */
+                         ((uint32_t)pHandle->HFNum + (uint32_t)pHandle->MFNum) * sizeof(void *));
             (void)memcpy(pHandle->dataSizeTableBuff, pHandle->dataSizeTable,
                          (uint32_t)pHandle->HFNum + (uint32_t)pHandle->MFNum); /* 1 size byte per ID */
           }
+          /* Format is chosen per buffer: a keyframe starts each delta coded buffer */
+          if ((MCTL_ASYNC_DELTA == pHandle->pTransportLayer->txAsyncFormat) && (pHandle->deltaPrevTable != MC_NULL)
+              && (pHandle->bufferTxTriggerDeltaBuff > 0U))
+          {
+            pHandle->asyncIdBuff = MCTL_ASYNC_DELTA;
+            pHandle->deltaHistory = 0U;
+          }
+          else
+          {
+            pHandle->asyncIdBuff = MCTL_ASYNC_RAW;
+          }
         }
       }
       else
@@ -104,15 +272,18 @@ void MCPA_dataLog(MCPA_Handle_t *pHandle)
         /* Nothing to do */
       }
 
-      /* */
-      if ((pHandle->bufferIndex > 0U)  && (pHandle->bufferIndex <= pHandle->bufferTxTriggerBuff))
+      txTrigger = (MCTL_ASYNC_DELTA == pHandle->asyncIdBuff) ? pHandle->bufferTxTriggerDeltaBuff
+                                                             : pHandle->bufferTxTriggerBuff;
+      if ((pHandle->bufferIndex > 0U)  && (pHandle->bufferIndex <= txTrigger))
       {
-        logValue16 = (uint16_t *)&pHandle->currentBuffer[pHandle->bufferIndex]; //cstat !MISRAC2012-Rule-11.3
-        for (i = 0U; i < pHandle->HFNumBuff; i++)
+        if (MCTL_ASYNC_DELTA == pHandle->asyncIdBuff)
+        {
+          pHandle->bufferIndex = MCPA_logHFDelta(pHandle, pHandle->bufferIndex);
+        }
+        else
         {
-          *logValue16 = *((uint16_t *) pHandle->dataPtrTableBuff[i]) ; //cstat !MISRAC2012-Rule-11.5
-          logValue16++;
-          pHandle->bufferIndex = pHandle->bufferIndex + 2U;
+          MCPA_gatherHF(pHandle, &pHandle->currentBuffer[pHandle->bufferIndex]);
+          pHandle->bufferIndex = pHandle->bufferIndex + pHandle->hfBytesBuff;
         }
         /* MFRateBuff=254 means we dump MF data once per buffer */
         /* MFRateBuff=255 means we do not dump MF data */
@@ -121,39 +292,9 @@ void MCPA_dataLog(MCPA_Handle_t *pHandle)
           if (pHandle->MFIndex == pHandle->MFRateBuff)
           {
             pHandle->MFIndex = 0U;
-            for (i = pHandle->HFNumBuff; i < (pHandle->MFNumBuff + pHandle->HFNumBuff); i++)
-            {
-              /* Dump MF data */
-              logValue = (uint32_t *)&pHandle->currentBuffer[pHandle->bufferIndex]; //cstat !MISRAC2012-Rule-11.3
-              *logValue = *((uint32_t *)pHandle->dataPtrTableBuff[i]); //cstat !MISRAC2012-Rule-11.5
-
-#ifdef NOT_IMPLEMENTED /* Code not implemented. */
-              switch (pHandle->dataSizeTableBuff[i])
-              {
-                case 1:
-                {
-                  logValue8 = (uint8_t *)&pHandle->currentBuffer[pHandle->bufferIndex];
-                  *logValue8 = *((uint8_t *)pHandle->dataPtrTableBuff[i]);
-                  break;
-                }
-                case 2:
-                {
-                  logValue16 = (uint16_t *)&pHandle->currentBuffer[pHandle->bufferIndex];
-                  *logValue16 = *((uint16_t *)pHandle->dataPtrTableBuff[i]);
-                  break;
-                }
-                case 4:
-                {
-                  logValue32 = (uint32_t *)&pHandle->currentBuffer[pHandle->bufferIndex];
-                  *logValue32 = *((uint32_t *)pHandle->dataPtrTableBuff[i]);
-                  break;
-                }
-                default:
-                  break;
-              }
-#endif
-              pHandle->bufferIndex = pHandle->bufferIndex+pHandle->dataSizeTableBuff[i];
-            }
+            /* Dump MF data */
+            MCPA_gatherMF(pHandle, &pHandle->currentBuffer[pHandle->bufferIndex]);
+            pHandle->bufferIndex = pHandle->bufferIndex + pHandle->mfBytesBuff;
           }
           else
           {
@@ -169,27 +310,19 @@ void MCPA_dataLog(MCPA_Handle_t *pHandle)
       {
         /* Nothing to do */
       }
-      if (pHandle->bufferIndex > pHandle->bufferTxTriggerBuff)
+      if (pHandle->bufferIndex > txTrigger)
       {
         if (pHandle->MFRateBuff == 254U) /* MFRateBuff = 254 means we dump MF data once per buffer */
         {
-          for (i = pHandle->HFNumBuff; i < (pHandle->MFNumBuff + pHandle->HFNumBuff); i++)
-          {
-            logValue = (uint32_t *)&pHandle->currentBuffer[pHandle->bufferIndex]; //cstat !MISRAC2012-Rule-11.3
-            *logValue = *((uint32_t *)pHandle->dataPtrTableBuff[i]); //cstat !MISRAC2012-Rule-11.5
-            pHandle->bufferIndex = pHandle->bufferIndex + pHandle->dataSizeTableBuff[i];
-          }
+          MCPA_gatherMF(pHandle, &pHandle->currentBuffer[pHandle->bufferIndex]);
+          pHandle->bufferIndex = pHandle->bufferIndex + pHandle->mfBytesBuff;
         }
         else
         {
           /* Nothing to do */
         }
         /* Buffer is ready to be send */
-        logValue16 = (uint16_t *)&pHandle->currentBuffer[pHandle->bufferIndex]; //cstat !MISRAC2012-Rule-11.3
-        *logValue16 = pHandle->MarkBuff; /* MarkBuff is actually 8 bits, but we add also 8 bits of the ASYNCID=0 after
-                                            the MARK. */
-        pHandle->pTransportLayer->fSendPacket(pHandle->pTransportLayer, pHandle->currentBuffer,
-                                              pHandle->bufferIndex + 2U, MCTL_ASYNC);
+        MCPA_sendBuffer(pHandle);
         pHandle->bufferIndex = 0U;
       }
       else
@@ -222,31 +355,19 @@ void MCPA_flushDataLog (MCPA_Handle_t *pHandle)
   else
   {
 #endif
-    uint32_t *logValue;
-    uint16_t *logValue16;
-    uint8_t i;
-
     if (pHandle->bufferIndex > 0U)
     {  /* If buffer is allocated, we must send it */
       if (pHandle->MFRateBuff == 254U) /* In case of flush, we must respect the packet format to allow
                                           proper decoding */
       {
-        for (i = pHandle->HFNumBuff; i < (pHandle->MFNumBuff + pHandle->HFNumBuff); i++)
-        {
-         logValue = (uint32_t *)&pHandle->currentBuffer[pHandle->bufferIndex]; //cstat !MISRAC2012-Rule-11.3
-         *logValue = *((uint32_t *)pHandle->dataPtrTableBuff[i]); //cstat !MISRAC2012-Rule-11.5
-         pHandle->bufferIndex = pHandle->bufferIndex+pHandle->dataSizeTableBuff[i];
-        }
+        MCPA_gatherMF(pHandle, &pHandle->currentBuffer[pHandle->bufferIndex]);
+        pHandle->bufferIndex = pHandle->bufferIndex + pHandle->mfBytesBuff;
       }
       else
       {
         /* Nothing to do */
       }
-      logValue16 = (uint16_t *)&pHandle->currentBuffer[pHandle->bufferIndex]; //cstat !MISRAC2012-Rule-11.3
-      *logValue16 = pHandle->MarkBuff; /* MarkBuff is actually 8 bits, but we add also 8 bits of the ASYNCID=0 after
-                                          the MARK */
-      pHandle->pTransportLayer->fSendPacket (pHandle->pTransportLayer, pHandle->currentBuffer,
-                                             pHandle->bufferIndex + 2U, MCTL_ASYNC);
+      MCPA_sendBuffer(pHandle);
       pHandle->bufferIndex = 0U;
     }
     else
@@ -265,16 +386,10 @@ void MCPA_flushDataLog (MCPA_Handle_t *pHandle)
   */
 void MCPA_stopDataLog(MCPA_Handle_t *pHandle)
 {
-  uint16_t *logValue16;
-
   pHandle->Mark = 0U;
   if (pHandle->bufferIndex > 0U)
   { /* If buffer is allocated, we must send it */
-    logValue16 = (uint16_t *)&pHandle->currentBuffer[pHandle->bufferIndex]; //cstat !MISRAC2012-Rule-11.3
-    *logValue16 = pHandle->MarkBuff; /* MarkBuff is actually 8 bits, but we add also 8 bits of the ASYNCID=0 after
-                                        the MARK */
-    pHandle->pTransportLayer->fSendPacket (pHandle->pTransportLayer, pHandle->currentBuffer,
-                                           pHandle->bufferIndex + 2U, MCTL_ASYNC);
+    MCPA_sendBuffer(pHandle);
   }
   else
   {
@@ -340,6 +455,9 @@ uint8_t MCPA_cfgLog(MCPA_Handle_t *pHandle, uint8_t *cfgdata)
           pCfgData++;
           logSize = logSize+pHandle->dataSizeTable[i];
         }
+        /* Copy plan used by MCPA_dataLog: HF values are fixed to 2 bytes, the rest is MF */
+        pHandle->hfBytes = (uint16_t)pHandle->HFNum * 2U;
+        pHandle->mfBytes = logSize - pHandle->hfBytes;
 
         /* Smallest packet must be able to contain logSize Markbyte AsyncID and TimeStamp */
         if (buffSize < (logSize + 2U + 4U))
@@ -350,6 +468,9 @@ uint8_t MCPA_cfgLog(MCPA_Handle_t *pHandle, uint8_t *cfgdata)
         {
           pHandle->bufferTxTrigger = buffSize-logSize - 2U; /* 2 is required to add the last Mark byte and NUL
                                                                ASYNCID */
+          /* Delta coded HF values take up to 3 bytes instead of 2 */
+          logSize = logSize + pHandle->HFNum;
+          pHandle->bufferTxTriggerDelta = (buffSize < (logSize + 2U + 4U)) ? 0U : (buffSize - logSize - 2U);
           pHandle->Mark = *((uint8_t *)pCfgData);
           if (0U == pHandle->Mark)
           {  /* Switch Off condition */
@@ -729,6 +729,114 @@ __weak int16_t PI_Controller(PID_Handle_t *pHandle, int32_t wProcessVarError)
   return (returnValue);
 }
 
+/*
+  * @brief  One axis of PI_Controller_dq()
+  *
+  * Same arithmetic as PI_Controller(). The overflow check of the integral sum is a QADD:
+  * it saturates a negative overflow to INT32_MIN where PI_Controller() uses -INT32_MAX,
+  * which the integral clamp turns into the same value whenever wLowerIntegralLimit is
+  * above INT32_MIN.
+  */
+static inline int16_t PI_ControllerAxis(PID_Handle_t *pHandle, int32_t wProcessVarError)
+{
+  int32_t wIntegralTerm = pHandle->wIntegralTerm;
+  int32_t wOutput_32;
+  int32_t wDischarge = 0;
+  int16_t hUpperOutputLimit = pHandle->hUpperOutputLimit;
+  int16_t hLowerOutputLimit = pHandle->hLowerOutputLimit;
+  int32_t wProportional_Term = pHandle->hKpGain * wProcessVarError;
+
+  if (0 == pHandle->hKiGain)
+  {
+    wIntegralTerm = 0;
+  }
+  else
+  {
+    wIntegralTerm = __QADD(wIntegralTerm, pHandle->hKiGain * wProcessVarError);
+    if (wIntegralTerm > pHandle->wUpperIntegralLimit)
+    {
+      wIntegralTerm = pHandle->wUpperIntegralLimit;
+    }
+    else if (wIntegralTerm < pHandle->wLowerIntegralLimit)
+    {
+      wIntegralTerm = pHandle->wLowerIntegralLimit;
+    }
+    else
+    {
+      /* Nothing to do */
+    }
+  }
+
+#ifndef FULL_MISRA_C_COMPLIANCY_PID_REGULATOR
+  //cstat !MISRAC2012-Rule-1.3_n !ATH-shift-neg !MISRAC2012-Rule-10.1_R6
+  wOutput_32 = (wProportional_Term >> pHandle->hKpDivisorPOW2) + (wIntegralTerm >> pHandle->hKiDivisorPOW2);
+#else
+  wOutput_32 = (wProportional_Term / (int32_t)pHandle->hKpDivisor)
+            + (wIntegralTerm / (int32_t)pHandle->hKiDivisor);
+#endif
+
+  if (wOutput_32 > hUpperOutputLimit)
+  {
+    wDischarge = hUpperOutputLimit - wOutput_32;
+    wOutput_32 = hUpperOutputLimit;
+  }
+  else if (wOutput_32 < hLowerOutputLimit)
+  {
+    wDischarge = hLowerOutputLimit - wOutput_32;
+    wOutput_32 = hLowerOutputLimit;
+  }
+  else
+  {
+    /* Nothing to do here */
+  }
+
+  pHandle->wIntegralTerm = wIntegralTerm + wDischarge;
+  return ((int16_t)wOutput_32);
+}
+
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__((section(".ccmram")))
+#endif
+#endif
+/**
+  * @brief  Computes the outputs of the q and d axis current PI regulators in one call
+  *
+  * @param  pHandleQ Handle on the q axis PID component
+  * @param  pHandleD Handle on the d axis PID component
+  * @param  wErrorQ q axis process variable error (reference minus measured Iq)
+  * @param  wErrorD d axis process variable error (reference minus measured Id)
+  * @retval computed q and d PI controller outputs
+  *
+  * Returns the same outputs and leaves the same integral terms as
+  * PI_Controller(pHandleQ, wErrorQ) followed by PI_Controller(pHandleD, wErrorD), bit for
+  * bit, provided the lower integral limits are above INT32_MIN (the MCSDK current loops use
+  * -INT16_MAX * Ki divisor). Both axes are computed in one body, so the loads of the two
+  * handles overlap and there is one call per current loop instead of two; the sign tests
+  * of the integral overflow check are replaced by a saturating add (QADD).
+  */
+__weak qd_t PI_Controller_dq(PID_Handle_t *pHandleQ, PID_Handle_t *pHandleD, int32_t wErrorQ, int32_t wErrorD)
+{
+  qd_t returnValue;
+#ifdef NULL_PTR_CHECK_PID_REG
+  if ((MC_NULL == pHandleQ) || (MC_NULL == pHandleD))
+  {
+    returnValue.q = 0;
+    returnValue.d = 0;
+  }
+  else
+  {
+#endif
+    returnValue.q = PI_ControllerAxis(pHandleQ, wErrorQ);
+    returnValue.d = PI_ControllerAxis(pHandleD, wErrorD);
+#ifdef NULL_PTR_CHECK_PID_REG
+  }
+#endif
+  return (returnValue);
+}
+
 #if defined (CCMRAM)
 #if defined (__ICCARM__)
 #pragma location = ".ccmram"
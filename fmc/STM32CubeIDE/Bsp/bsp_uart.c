@@ -1,23 +1,292 @@
 /*
  * bsp_uart.c
  *
+ * USART2 TX: 单生产者单消费者 (SPSC) 字节环 + DMA1 Ch2 零拷贝发送.
+ *
+ *   bsp_uart_write()  主循环, 只写 tx_head
+ *   DMA1 Ch2 TC 中断  只写 tx_tail, 每次把 ring 里一段连续区直接交给 DMA
+ *                     (绕回处拆成两段, 不拷贝)
+ *
+ * 生产者不碰 DMA 寄存器: 发现 DMA 空闲时只 pend 一次中断, 启动永远在
+ * 中断里做, 所以不需要关中断.
+ *
+ * USART2 RX: DMA1 Ch1 循环写 rx_dma[], 三种事件把新字节搬进 rx_ring:
+ *   HT / TC  (半满 / 全满, 连续输入时)
+ *   IDLE     (一帧结束, 比如敲完一行回车)
+ * 两个中断同一抢占优先级 (3), 互不打断, 搬运只有一个写者.
+ * rx_ring 比 DMA 区大, 主循环执行长命令 (bench run all) 时粘贴的内容也不丢.
+ *
  *  Created on: 2026年2月5日
  *      Author: SYRLIST
  */
 #include "bsp_uart.h"
 #include "main.h"
 #include "stm32g4xx.h"
+#include "stm32g4xx_ll_dma.h"
+#include "stm32g4xx_ll_usart.h"
+#include <string.h>
+
+#if (BSP_UART_TX_RING & (BSP_UART_TX_RING - 1U)) != 0U
+#error "BSP_UART_TX_RING must be a power of two"
+#endif
+#if (BSP_UART_RX_RING & (BSP_UART_RX_RING - 1U)) != 0U
+#error "BSP_UART_RX_RING must be a power of two"
+#endif
+
+#define TX_DMA_CH        LL_DMA_CHANNEL_2   /* CubeMX 分给 USART2_TX 的通道 */
+#define TX_DMA_IRQ_PRIO  5U                 /* 低于所有 MCSDK 中断 */
+#define TX_MASK          (BSP_UART_TX_RING - 1U)
+#define RX_DMA_CH        LL_DMA_CHANNEL_1   /* CubeMX 分给 USART2_RX 的通道 */
+#define RX_MASK          (BSP_UART_RX_RING - 1U)
+
+static uint8_t tx_ring[BSP_UART_TX_RING];
+static volatile uint32_t tx_head = 0U;      /* 生产者写, 自由增长 */
+static volatile uint32_t tx_tail = 0U;      /* 消费者写, 自由增长 */
+static volatile uint32_t tx_inflight = 0U;  /* 当前 DMA 段长度, 0 = 空闲 */
+static volatile uint8_t  tx_ready = 0U;
+
+static volatile bsp_uart_stats_t tx_stats;
+
+static uint8_t rx_dma[BSP_UART_RX_DMA];
+static uint32_t rx_last = 0U;               /* rx_dma[] 里已搬走的位置 (中断内用) */
+static uint8_t rx_ring[BSP_UART_RX_RING];
+static volatile uint32_t rx_head = 0U;      /* 中断写 */
+static volatile uint32_t rx_tail = 0U;      /* 主循环写 */
 
-void bsp_uart_init(void) { }
+static void uart_rx_init(void)
+{
+  LL_DMA_DisableChannel(DMA1, RX_DMA_CH);
+  LL_DMA_ClearFlag_GI1(DMA1);
+
+  LL_DMA_ConfigTransfer(DMA1, RX_DMA_CH,
+                        LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_MODE_CIRCULAR |
+                        LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                        LL_DMA_PDATAALIGN_BYTE | LL_DMA_MDATAALIGN_BYTE |
+                        LL_DMA_PRIORITY_LOW);
+  LL_DMA_SetPeriphRequest(DMA1, RX_DMA_CH, LL_DMAMUX_REQ_USART2_RX);
+  LL_DMA_ConfigAddresses(DMA1, RX_DMA_CH, (uint32_t)&USART2->RDR, (uint32_t)rx_dma,
+                         LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+  LL_DMA_SetDataLength(DMA1, RX_DMA_CH, BSP_UART_RX_DMA);
+  LL_DMA_EnableIT_HT(DMA1, RX_DMA_CH);
+  LL_DMA_EnableIT_TC(DMA1, RX_DMA_CH);
+
+  rx_last = 0U;
+  rx_head = 0U;
+  rx_tail = 0U;
+
+  /* 之前轮询留下的残留字节 / 错误标志清掉 */
+  WRITE_REG(USART2->ICR, USART_ICR_IDLECF | USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF);
+  LL_USART_EnableIT_IDLE(USART2);
+  LL_USART_EnableIT_ERROR(USART2);
+  LL_DMA_EnableChannel(DMA1, RX_DMA_CH);
+  LL_USART_EnableDMAReq_RX(USART2);
+
+  /* 优先级 CubeMX 已配 (3.0 / 3.1), 这里只打开 */
+  HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+  HAL_NVIC_EnableIRQ(USART2_IRQn);
+}
+
+void bsp_uart_init(void)
+{
+  LL_DMA_DisableChannel(DMA1, TX_DMA_CH);
+  LL_DMA_ClearFlag_GI2(DMA1);
+
+  /* MCSDK ASPEP 之前配过这个通道, 这里整体重配一次 */
+  LL_DMA_ConfigTransfer(DMA1, TX_DMA_CH,
+                        LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_NORMAL |
+                        LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                        LL_DMA_PDATAALIGN_BYTE | LL_DMA_MDATAALIGN_BYTE |
+                        LL_DMA_PRIORITY_LOW);
+  LL_DMA_SetPeriphRequest(DMA1, TX_DMA_CH, LL_DMAMUX_REQ_USART2_TX);
+  LL_DMA_SetPeriphAddress(DMA1, TX_DMA_CH, (uint32_t)&USART2->TDR);
+  LL_DMA_EnableIT_TC(DMA1, TX_DMA_CH);
+  LL_DMA_EnableIT_TE(DMA1, TX_DMA_CH);
+
+  LL_USART_DisableIT_TC(USART2);
+  LL_USART_EnableDMAReq_TX(USART2);
+
+  tx_head = 0U;
+  tx_tail = 0U;
+  tx_inflight = 0U;
+  memset((void *)&tx_stats, 0, sizeof(tx_stats));
+
+  HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, TX_DMA_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+  tx_ready = 1U;
+
+  uart_rx_init();
+}
+
+/* 轮询版, 只在 init 之前用 (启动早期日志) */
+static int uart_write_blocking(const uint8_t *data, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    while (!(USART2->ISR & USART_ISR_TXE_TXFNF)) {}
+    USART2->TDR = data[i];
+  }
+  return (int)len;
+}
 
 int bsp_uart_write(const uint8_t *data, size_t len)
 {
-    if (!data || len == 0) return 0;
-    for (size_t i = 0; i < len; i++) {
-        while (!(USART2->ISR & USART_ISR_TXE_TXFNF)) {}
-        USART2->TDR = data[i];
+  if (!data || len == 0) return 0;
+  if (!tx_ready) return uart_write_blocking(data, len);
+
+  uint32_t head = tx_head;
+  uint32_t used = head - tx_tail;
+  if ((uint32_t)len > (BSP_UART_TX_RING - used)) {
+    /* 整条丢, 不发半行 */
+    tx_stats.dropped += (uint32_t)len;
+    tx_stats.overflows++;
+    return 0;
+  }
+
+  uint32_t off = head & TX_MASK;
+  uint32_t first = BSP_UART_TX_RING - off;
+  if (first > (uint32_t)len) first = (uint32_t)len;
+  memcpy(&tx_ring[off], data, first);
+  memcpy(&tx_ring[0], data + first, (uint32_t)len - first);
+
+  __DMB();                      /* 数据先落地, 再发布 head */
+  tx_head = head + (uint32_t)len;
+
+  tx_stats.queued += (uint32_t)len;
+  used += (uint32_t)len;
+  if (used > tx_stats.max_used) tx_stats.max_used = used;
+
+  if (tx_inflight == 0U) {
+    NVIC_SetPendingIRQ(DMA1_Channel2_IRQn);
+  }
+  return (int)len;
+}
+
+void bsp_uart_poll(void)
+{
+  /* 兜底: 有数据但 DMA 空闲 (正常情况下 write 已经 pend 过) */
+  if (tx_ready && (tx_inflight == 0U) && (tx_head != tx_tail)) {
+    NVIC_SetPendingIRQ(DMA1_Channel2_IRQn);
+  }
+}
+
+/* 把 [tail, head) 里第一段连续区交给 DMA */
+static void tx_kick(void)
+{
+  uint32_t tail = tx_tail;
+  uint32_t avail = tx_head - tail;
+  if (avail == 0U) return;
+
+  uint32_t off = tail & TX_MASK;
+  uint32_t seg = BSP_UART_TX_RING - off;
+  if (seg > avail) seg = avail;
+
+  tx_inflight = seg;
+  LL_DMA_SetMemoryAddress(DMA1, TX_DMA_CH, (uint32_t)&tx_ring[off]);
+  LL_DMA_SetDataLength(DMA1, TX_DMA_CH, seg);
+  LL_DMA_EnableChannel(DMA1, TX_DMA_CH);
+  tx_stats.dma_segments++;
+}
+
+void bsp_uart_tx_dma_irq(void)
+{
+  if (LL_DMA_IsActiveFlag_TC2(DMA1) != 0U) {
+    LL_DMA_ClearFlag_TC2(DMA1);
+    LL_DMA_DisableChannel(DMA1, TX_DMA_CH);
+    tx_tail = tx_tail + tx_inflight;
+    tx_stats.sent += tx_inflight;
+    tx_inflight = 0U;
+  }
+  if (LL_DMA_IsActiveFlag_TE2(DMA1) != 0U) {
+    /* 传输错误: 这段放弃, 继续下一段 */
+    LL_DMA_ClearFlag_TE2(DMA1);
+    LL_DMA_DisableChannel(DMA1, TX_DMA_CH);
+    tx_tail = tx_tail + tx_inflight;
+    tx_stats.dma_errors++;
+    tx_inflight = 0U;
+  }
+  if (tx_inflight == 0U) {
+    tx_kick();
+  }
+}
+
+void bsp_uart_get_stats(bsp_uart_stats_t *out)
+{
+  __disable_irq();
+  memcpy(out, (const void *)&tx_stats, sizeof(*out));
+  __enable_irq();
+}
+
+uint32_t bsp_uart_tx_pending(void)
+{
+  return tx_head - tx_tail;
+}
+
+/* ── RX ── */
+
+/* 把 rx_dma[rx_last .. DMA 当前位置) 搬进 rx_ring, 只在 RX 中断里调用 */
+static void rx_harvest(void)
+{
+  uint32_t pos = BSP_UART_RX_DMA - LL_DMA_GetDataLength(DMA1, RX_DMA_CH);
+  if (pos >= BSP_UART_RX_DMA) pos = 0U;          /* CNDTR 刚重装 */
+
+  uint32_t head = rx_head;
+  uint32_t free_ = BSP_UART_RX_RING - (head - rx_tail);
+  while (rx_last != pos) {
+    if (free_ != 0U) {
+      rx_ring[head & RX_MASK] = rx_dma[rx_last];
+      head++;
+      free_--;
+      tx_stats.rx_bytes++;
+    } else {
+      tx_stats.rx_dropped++;
     }
-    return (int)len;
+    rx_last = (rx_last + 1U) & (BSP_UART_RX_DMA - 1U);
+  }
+  __DMB();
+  rx_head = head;
+  tx_stats.rx_events++;
+}
+
+void bsp_uart_rx_dma_irq(void)
+{
+  if (LL_DMA_IsActiveFlag_HT1(DMA1) != 0U) LL_DMA_ClearFlag_HT1(DMA1);
+  if (LL_DMA_IsActiveFlag_TC1(DMA1) != 0U) LL_DMA_ClearFlag_TC1(DMA1);
+  if (LL_DMA_IsActiveFlag_TE1(DMA1) != 0U) {
+    LL_DMA_ClearFlag_TE1(DMA1);
+    tx_stats.rx_errors++;
+  }
+  rx_harvest();
+}
+
+void bsp_uart_usart_irq(void)
+{
+  uint32_t isr = USART2->ISR;
+
+  if ((isr & (USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE)) != 0U) {
+    WRITE_REG(USART2->ICR, USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF);
+    tx_stats.rx_errors++;
+  }
+  if ((isr & USART_ISR_IDLE) != 0U) {
+    WRITE_REG(USART2->ICR, USART_ICR_IDLECF);
+    rx_harvest();
+  }
+}
+
+int bsp_uart_read(uint8_t *buf, size_t max)
+{
+  uint32_t tail = rx_tail;
+  uint32_t avail = rx_head - tail;
+  if (avail > max) avail = (uint32_t)max;
+  __DMB();
+
+  for (uint32_t i = 0; i < avail; i++) {
+    buf[i] = rx_ring[(tail + i) & RX_MASK];
+  }
+  __DMB();
+  rx_tail = tail + avail;
+  return (int)avail;
 }
 
-void bsp_uart_poll(void) { }
+uint32_t bsp_uart_rx_available(void)
+{
+  return rx_head - rx_tail;
+}
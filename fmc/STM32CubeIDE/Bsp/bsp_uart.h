@@ -10,12 +10,49 @@
 #pragma once
 #include <stdint.h>
 #include <stddef.h>
+
+/* TX 环形缓冲区, 必须是 2 的幂 */
+#define BSP_UART_TX_RING   4096U
+/* RX: DMA 循环区 (HT/TC 各半) + 软件 ring, 都是 2 的幂 */
+#define BSP_UART_RX_DMA    256U
+#define BSP_UART_RX_RING   1024U
+
+typedef struct {
+  uint32_t queued;        // 进入 ring 的字节数
+  uint32_t sent;          // DMA 已发完的字节数
+  uint32_t dropped;       // ring 满被丢掉的字节数
+  uint32_t overflows;     // 被丢掉的 write() 调用次数
+  uint32_t max_used;      // ring 占用高水位
+  uint32_t dma_segments;  // 启动过的 DMA 段数
+  uint32_t dma_errors;    // DMA 传输错误 (该段放弃)
+  uint32_t rx_bytes;      // 收到并进了 RX ring 的字节数
+  uint32_t rx_dropped;    // RX ring 满丢掉的字节数
+  uint32_t rx_events;     // IDLE / HT / TC 事件数
+  uint32_t rx_errors;     // ORE / FE / NE
+} bsp_uart_stats_t;
+
 void bsp_uart_init(void);
+
+// 只在主循环 (非 ISR) 上下文调用: 单生产者.
+// 非阻塞: 整条放得下就拷进 ring 返回 len, 放不下整条丢弃返回 0.
+// bsp_uart_init() 之前退化为轮询 TXE 的阻塞写.
 int  bsp_uart_write(const uint8_t *data, size_t len);
 
 // Call periodically from the main loop (non-ISR context)
 // to start/continue DMA transfers.
 void bsp_uart_poll(void);
 
+// DMA1 Channel2 (USART2_TX) 中断里调用: 消费者
+void bsp_uart_tx_dma_irq(void);
+
+// RX: DMA1 Ch1 循环接收, IDLE/HT/TC 中断把新字节搬进 RX ring.
+// 主循环用 bsp_uart_read() 批量取; 没数据时可以 __WFI.
+int  bsp_uart_read(uint8_t *buf, size_t max);
+uint32_t bsp_uart_rx_available(void);
+void bsp_uart_rx_dma_irq(void);    // DMA1_Channel1_IRQHandler
+void bsp_uart_usart_irq(void);     // USART2_IRQHandler (IDLE + 错误)
+
+void bsp_uart_get_stats(bsp_uart_stats_t *out);
+uint32_t bsp_uart_tx_pending(void);
 
 #endif /* BSP_UART_H_ */
@@ -0,0 +1,812 @@
+/*
+ * bench.c  - Benchmark registry + runner (DWT cycles)
+ *
+ * 原来 cli.c 里每个 bench_* 各自解析参数, 只跑一次, 手写 LOGI 格式.
+ * 现在统一成 bench_cases[] 表, runner 负责:
+ *   warmup 次数 -> reps 次计时 (可关中断) -> 排序取 min/median/p99/max
+ *   -> cycles/element -> 一行 CSV 或 JSON
+ *
+ * 加新 case: 写 run() (只放被测代码), 需要的话写 setup/teardown/check,
+ * 然后在 bench_cases[] 里加一行.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "bench.h"
+#include "log.h"
+#include "main.h"
+#include "cordic.h"
+#include "fmac.h"
+#include "fmac_rt.h"
+#include "fmac_mc.h"
+#include "crc16.h"
+#include "mc_api.h"
+#include "mc_config.h"
+#include "mc_math.h"
+#include "cordic_batch.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+#define PI M_PI
+
+#define CORDIC_MAX_N     2048U
+#define FMAC_TAPS        32U
+#define FMAC_INPUT_N     5000U
+#define FOC_CHAIN_MAX_N  1000U
+#define PI_MAX_N         2000U
+#define CIRCLE_MAX_N     2000U
+
+extern CORDIC_HandleTypeDef hcordic;
+extern FMAC_HandleTypeDef hfmac;
+
+/* ── 共享数据 (只有 CLI 上下文用, 不放栈上) ──
+ * 每次 run 前都会跑 setup 重新生成输入, 各组 case 的缓冲区可以重叠.
+ * RAM 只剩 96K (CCM 别名区不再给 .bss 用), 分开放放不下. */
+static union {
+  struct {
+    int16_t x[FMAC_INPUT_N];
+    int16_t y_soft[FMAC_INPUT_N];
+    int16_t y_hw[FMAC_INPUT_N];
+  } fir;
+  struct {
+    int32_t in[CORDIC_MAX_N];
+    int32_t out[CORDIC_MAX_N * 2U];
+    float   f[CORDIC_MAX_N];
+  } vec;
+  struct {
+    ab_t    iab[FOC_CHAIN_MAX_N];
+    int16_t theta[FOC_CHAIN_MAX_N];
+  } foc;
+  struct {
+    qd_t err[PI_MAX_N];
+  } pi;
+  struct {
+    qd_t    vqd[CIRCLE_MAX_N];
+    int32_t sq[CIRCLE_MAX_N];
+  } lim;
+} buf;
+
+static int16_t fmac_coeffs[FMAC_TAPS];  /* 32-tap 移动平均系数 */
+static int16_t fmac_preload_zeros[FMAC_TAPS];
+
+static uint32_t samples[BENCH_MAX_REPS];
+
+/* 防止被优化掉 */
+static volatile int32_t sink_i;
+static volatile float sink_f;
+
+static inline int32_t float_to_q31(float x)
+{
+  // x in [-1, 1)
+  if (x >= 0.999999f) x = 0.999999f;
+  if (x < -1.0f) x = -1.0f;
+  return (int32_t)(x * 2147483648.0f); // 2^31
+}
+
+static inline float q31_to_float(int32_t q)
+{
+  return (float)q / 2147483648.0f;
+}
+
+// angle: rad -> normalized to [-pi, pi] then to q31 where 1.0 == pi (常用映射)
+static inline int32_t rad_to_cordic_q31(float rad)
+{
+  while (rad >  PI) rad -= 2.0f*PI;
+  while (rad < -PI) rad += 2.0f*PI;
+  return float_to_q31(rad / PI);
+}
+
+/* ── CORDIC 配置 ─────────────────────────────────────────────────────
+ *
+ * CSR = FUNC 0 (cos, sin) | PREC 6 | NRES 1 | 32-bit in/out = 0x00080060
+ * 每次调用只需:  WDATA = angle;  cos = RDATA;  sin = RDATA;
+ * ──────────────────────────────────────────────────────────────────── */
+#define CORDIC_CSR_SINCOS_6ITER  0x00080060u
+
+static int cordic_hal_setup(uint32_t n)
+{
+  (void)n;
+  if (cordic_batch_busy()) {
+    return -1;                                /* 后台批处理占着 CORDIC */
+  }
+  CORDIC_ConfigTypeDef cfg = {0};
+  cfg.Function  = CORDIC_FUNCTION_COSINE;     // 输出 cos + sin
+  cfg.Precision = CORDIC_PRECISION_6CYCLES;
+  cfg.Scale     = CORDIC_SCALE_0;
+  cfg.NbWrite   = CORDIC_NBWRITE_1;
+  cfg.NbRead    = CORDIC_NBREAD_2;
+  cfg.InSize    = CORDIC_INSIZE_32BITS;
+  cfg.OutSize   = CORDIC_OUTSIZE_32BITS;
+
+  if (HAL_CORDIC_Configure(&hcordic, &cfg) != HAL_OK) {
+    LOGE("cordic cfg fail");
+    return -1;
+  }
+  return 0;
+}
+
+static int cordic_reg_setup(uint32_t n)
+{
+  (void)n;
+  if (cordic_batch_busy()) {
+    return -1;
+  }
+  CORDIC->CSR = CORDIC_CSR_SINCOS_6ITER;
+  return 0;
+}
+
+/* ── 空循环 (原 "bench <n>") ── */
+static void run_loop(uint32_t n)
+{
+  volatile uint32_t s = 0;
+  for (uint32_t i = 0; i < n; i++) s += i;
+}
+
+/* ── sin/cos 逐个调用 ── */
+static void run_sincos_soft(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    float a = (float)i * 0.001f;
+    sink_f = sinf(a);
+    sink_f = cosf(a);
+  }
+}
+
+static void run_sincos_hal(uint32_t n)
+{
+  int32_t in, out[2];
+  for (uint32_t i = 0; i < n; i++) {
+    in = rad_to_cordic_q31((float)i * 0.001f);
+    HAL_CORDIC_Calculate(&hcordic, &in, out, 1, 1000);
+    sink_f = q31_to_float(out[0]);
+    sink_f = q31_to_float(out[1]);
+  }
+}
+
+static void run_sincos_reg(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t in = rad_to_cordic_q31((float)i * 0.001f);
+    CORDIC->WDATA = (uint32_t)in;         /* 写入角度 → 硬件开始计算 */
+    sink_i = (int32_t)CORDIC->RDATA;      /* 读 cos (阻塞到计算完成) */
+    sink_i = (int32_t)CORDIC->RDATA;      /* 读 sin */
+  }
+}
+
+/* 纯寄存器版, Q31 整数相位累加, 测纯硬件吞吐 */
+static void run_sincos_pure(uint32_t n)
+{
+  uint32_t phase = 0;
+  const uint32_t step = (uint32_t)(0.001f / PI * 2147483648.0f);
+  for (uint32_t i = 0; i < n; i++) {
+    CORDIC->WDATA = phase;
+    sink_i = (int32_t)CORDIC->RDATA;
+    sink_i = (int32_t)CORDIC->RDATA;
+    phase += step;
+  }
+}
+
+/* 只测 float -> q31 (原 cordicbd 的 pack 部分) */
+static void run_q31_pack(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    sink_i = rad_to_cordic_q31((float)i * 0.001f);
+  }
+}
+
+/* ── sin/cos 向量 (输入生成放 setup 里) ── */
+static int vec_setup(uint32_t n)
+{
+  const uint32_t step_u = (uint32_t)((0.001f / PI) * 2147483648.0f);
+  uint32_t phase_u = 0;
+  float a = 0.0f;
+  for (uint32_t i = 0; i < n; i++) {
+    buf.vec.in[i] = (int32_t)phase_u;
+    phase_u += step_u;
+    buf.vec.f[i] = a;
+    a += 0.001f;
+  }
+  return cordic_hal_setup(n);
+}
+
+static void run_vec_soft(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    sink_f = sinf(buf.vec.f[i]);
+    sink_f = cosf(buf.vec.f[i]);
+  }
+}
+
+static void run_vec_hal(uint32_t n)
+{
+  HAL_CORDIC_Calculate(&hcordic, buf.vec.in, buf.vec.out, n, HAL_MAX_DELAY);
+  sink_i = buf.vec.out[0] ^ buf.vec.out[1];
+}
+
+/* ── sin/cos 向量: CPU 寄存器 vs cordic_batch DMA, 同一个 CSR ──
+ * 单参数时模长是 CORDIC 里留下的 ARG2 (MCM_PhaseComputation 会改它),
+ * 先写一次 (0, 1) 把它放回 1, 和 cordic_batch 一样 */
+static int vec_reg_setup(uint32_t n)
+{
+  if ((vec_setup(n) < 0) || (cordic_reg_setup(n) < 0)) {
+    return -1;
+  }
+  CORDIC->CSR = CORDIC_CSR_SINCOS_6ITER | CORDIC_CSR_NARGS;
+  CORDIC->WDATA = 0U;
+  CORDIC->WDATA = 0x7FFFFFFFU;
+  sink_i = (int32_t)CORDIC->RDATA;
+  sink_i = (int32_t)CORDIC->RDATA;
+  CORDIC->CSR = CORDIC_CSR_SINCOS_6ITER;
+  return 0;
+}
+
+static void run_vec_pure(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    CORDIC->WDATA = (uint32_t)buf.vec.in[i];
+    buf.vec.out[2U * i] = (int32_t)CORDIC->RDATA;
+    buf.vec.out[(2U * i) + 1U] = (int32_t)CORDIC->RDATA;
+  }
+}
+
+/* start 到完成中断回调全算上; 关中断测时由这里轮询代替中断 */
+static void run_vec_dma(uint32_t n)
+{
+  const cordic_batch_job_t job = {
+    .csr = CORDIC_CSR_SINCOS_6ITER, .in = buf.vec.in, .out = buf.vec.out, .n = n,
+  };
+  if (cordic_batch_start(&job) != 0) {
+    return;
+  }
+  while (cordic_batch_busy()) {
+    cordic_batch_dma_irq();
+  }
+}
+
+/* 参考: 模长作为第二个参数写进去, 不依赖 ARG2 */
+static int32_t vec_sincos_check(uint32_t n)
+{
+  int32_t bad = 0;
+  CORDIC->CSR = CORDIC_CSR_SINCOS_6ITER | CORDIC_CSR_NARGS;
+  for (uint32_t i = 0; i < n; i++) {
+    CORDIC->WDATA = (uint32_t)buf.vec.in[i];
+    CORDIC->WDATA = 0x7FFFFFFFU;
+    bad += ((int32_t)CORDIC->RDATA != buf.vec.out[2U * i]);
+    bad += ((int32_t)CORDIC->RDATA != buf.vec.out[(2U * i) + 1U]);
+  }
+  return bad;
+}
+
+/* ── FIR: 软件 32-tap 移动平均 vs FMAC ── */
+static uint32_t lcg_state = 1;
+static int16_t prng_q15(void)
+{
+  // 伪随机，范围大概在 [-0.5, 0.5)
+  lcg_state = 1664525u * lcg_state + 1013904223u;
+  int32_t v = (int32_t)(lcg_state >> 16) - 32768;
+  return (int16_t)(v >> 1);
+}
+
+static int fir_input_setup(uint32_t n)
+{
+  lcg_state = 1;
+  for (uint32_t i = 0; i < n; i++) buf.fir.x[i] = prng_q15();
+  return 0;
+}
+
+static void fir_soft_q15_ma32(const int16_t *x, int16_t *y, uint32_t n)
+{
+  // 32tap 移动平均：累加后右移 5 位, 等价于 1024 系数的 FMAC 结果
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t acc = 0;
+    for (uint32_t k = 0; k < FMAC_TAPS; k++) {
+      int32_t idx = (int32_t)i - (int32_t)k;
+      acc += (idx >= 0) ? x[idx] : 0;
+    }
+    acc >>= 5;
+    if (acc > 32767) acc = 32767;
+    if (acc < -32768) acc = -32768;
+    y[i] = (int16_t)acc;
+  }
+}
+
+static void run_fir_soft(uint32_t n)
+{
+  fir_soft_q15_ma32(buf.fir.x, buf.fir.y_soft, n);
+}
+
+/*
+ * FMAC 内部 RAM = 256 x 16-bit words
+ *   X1 (input buffer):  addr 0,   size 64  (32 delay + 32 watermark)
+ *   X2 (coefficients):  addr 64,  size 32
+ *   Y  (output buffer): addr 96,  size 64
+ * 配置 + preload + start 在 setup 里, 计时只含 append + poll.
+ */
+static uint16_t fmac_out_remain;
+
+static int fir_fmac_setup(uint32_t n)
+{
+  /* FMAC 只有一个, 实时滤波占用时不能抢 */
+  if ((fmac_rt_is_active() != 0U) || (fmac_mc_is_active() != 0U)) {
+    return -1;
+  }
+  (void)fir_input_setup(n);
+  memset(buf.fir.y_hw, 0, sizeof(int16_t) * (n + 1U));
+
+  FMAC_FilterConfigTypeDef cfg = {0};
+  cfg.InputBaseAddress  = 0;
+  cfg.InputBufferSize   = 64;
+  cfg.InputThreshold    = FMAC_THRESHOLD_1;
+  cfg.CoeffBaseAddress  = 64;
+  cfg.CoeffBufferSize   = FMAC_TAPS;
+  cfg.OutputBaseAddress = 96;
+  cfg.OutputBufferSize  = 64;
+  cfg.OutputThreshold   = FMAC_THRESHOLD_1;
+  cfg.pCoeffB           = fmac_coeffs;
+  cfg.CoeffBSize        = FMAC_TAPS;
+  cfg.Filter            = FMAC_FUNC_CONVO_FIR;
+  cfg.InputAccess       = FMAC_BUFFER_ACCESS_POLLING;
+  cfg.OutputAccess      = FMAC_BUFFER_ACCESS_POLLING;
+  cfg.Clip              = FMAC_CLIP_ENABLED;
+  cfg.P                 = FMAC_TAPS;
+
+  if (HAL_FMAC_FilterConfig(&hfmac, &cfg) != HAL_OK) {
+    LOGE("FMAC config fail");
+    return -1;
+  }
+  if (HAL_FMAC_FilterPreload(&hfmac, fmac_preload_zeros, FMAC_TAPS, NULL, 0) != HAL_OK) {
+    LOGE("FMAC preload fail");
+    return -1;
+  }
+  /* 请求 n+1 个输出: [0]=pipeline零, [1..n]=真实结果 */
+  fmac_out_remain = (uint16_t)(n + 1U);
+  if (HAL_FMAC_FilterStart(&hfmac, buf.fir.y_hw, &fmac_out_remain) != HAL_OK) {
+    LOGE("FMAC start fail");
+    return -1;
+  }
+  return 0;
+}
+
+static void run_fir_fmac(uint32_t n)
+{
+  uint16_t fed = 0;
+  while (fed < n) {
+    uint16_t chunk = (uint16_t)(n - fed);
+    HAL_StatusTypeDef st = HAL_FMAC_AppendFilterData(&hfmac, &buf.fir.x[fed], &chunk);
+    if (st == HAL_OK) {
+      fed += chunk;
+    } else if (st == HAL_BUSY) {
+      HAL_FMAC_PollFilterData(&hfmac, 10);
+    } else {
+      break;
+    }
+  }
+  HAL_FMAC_PollFilterData(&hfmac, 1000);
+}
+
+static void fir_fmac_teardown(void)
+{
+  HAL_FMAC_FilterStop(&hfmac);
+}
+
+/* FMAC pipeline 延迟 1 样本: y_hw[1..n] 对应 y_soft[0..n-1]
+ * 最后 ~FMAC_TAPS 个样本可能卡在 Y buffer 里输出为零, 跳过这些 */
+static int32_t fir_fmac_check(uint32_t n)
+{
+  fir_soft_q15_ma32(buf.fir.x, buf.fir.y_soft, n);
+  uint32_t valid = (n > FMAC_TAPS) ? (n - FMAC_TAPS) : 0U;
+  int32_t diff = 0;
+  for (uint32_t i = 0; i < valid; i++) {
+    if (buf.fir.y_hw[i + 1U] != buf.fir.y_soft[i]) diff++;
+  }
+  return diff;
+}
+
+/* ── ASPEP 数据 CRC: 输入借用 buf.fir.x 的字节视图, n = 字节数 ── */
+#define CRC_MAX_N   (sizeof(buf.fir.x))
+
+static int crc_setup(uint32_t n)
+{
+  uint8_t *p = (uint8_t *)buf.fir.x;
+  uint32_t seed = 0x1234567u;
+  for (uint32_t i = 0; i < n; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    p[i] = (uint8_t)(seed >> 24);
+  }
+  return 0;
+}
+
+static void run_crc_byte(uint32_t n)
+{
+  sink_i = crc16_sw_bytewise(CRC16_INIT, (const uint8_t *)buf.fir.x, n);
+}
+
+static void run_crc_sb8(uint32_t n)
+{
+  sink_i = crc16_sw(CRC16_INIT, (const uint8_t *)buf.fir.x, n);
+}
+
+static void run_crc_hw(uint32_t n)
+{
+  uint16_t crc = 0;
+  (void)crc16_hw((const uint8_t *)buf.fir.x, n, &crc);
+  sink_i = crc;
+}
+
+static int32_t crc_hw_check(uint32_t n)
+{
+  uint16_t hw = 0;
+  if (crc16_hw((const uint8_t *)buf.fir.x, n, &hw) != 0) return 1;
+  return (hw != crc16_sw(CRC16_INIT, (const uint8_t *)buf.fir.x, n)) ? 1 : 0;
+}
+
+/* ── FOC 电流环一拍: Clarke -> Park -> d/q PI -> 圆限幅 -> 反 Park ──
+ * 和 HF 任务调用的是同一批函数, 用来比较 flash / CCM SRAM 两种链接
+ * (ccm_hot.ld, 见 STM32G474RETX_FLASH.ld). PID 用拷贝, 不动电机的句柄.
+ * MCM_Park 走 CORDIC, 和 FOC ISR 抢同一个 CORDIC, 只在 IDLE 跑. */
+static PID_Handle_t foc_pid_q;
+static PID_Handle_t foc_pid_d;
+
+static int foc_chain_setup(uint32_t n)
+{
+  if (MC_GetSTMStateMotor1() != IDLE) {
+    return -1;
+  }
+  foc_pid_q = PIDIqHandle_M1;
+  foc_pid_d = PIDIdHandle_M1;
+  PID_SetIntegralTerm(&foc_pid_q, 0);
+  PID_SetIntegralTerm(&foc_pid_d, 0);
+
+  /* 幅值 8000 的三相电流, 电角度每步 0.01 rad, 加一点噪声 */
+  lcg_state = 1;
+  for (uint32_t i = 0; i < n; i++) {
+    float th = (float)i * 0.01f;
+    buf.foc.theta[i] = (int16_t)(int32_t)(th * (float)(32768.0 / PI));
+    buf.foc.iab[i].a = (int16_t)(8000.0f * cosf(th) + (float)(prng_q15() >> 6));
+    buf.foc.iab[i].b = (int16_t)(8000.0f * cosf(th - (float)(2.0 * PI / 3.0)) + (float)(prng_q15() >> 6));
+  }
+  return 0;
+}
+
+static void run_foc_chain(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    alphabeta_t iab = MCM_Clarke(buf.foc.iab[i]);
+    qd_t iqd = MCM_Park(iab, buf.foc.theta[i]);
+    qd_t vqd = PI_Controller_dq(&foc_pid_q, &foc_pid_d, (int32_t)4000 - (int32_t)iqd.q, -(int32_t)iqd.d);
+    vqd = Circle_Limitation(&CircleLimitationM1, vqd);
+    alphabeta_t vab = MCM_Rev_Park(vqd, buf.foc.theta[i]);
+    sink_i = (int32_t)vab.alpha ^ (int32_t)vab.beta;
+  }
+}
+
+/* ── 电流环 PI: 两次 PI_Controller 对 PI_Controller_dq ──
+ * 同一串误差 (随机游走 + 偶尔的大阶跃, 让积分和输出都碰到限幅),
+ * 每次 setup 从 M1 句柄的拷贝、积分清零开始. */
+static int pi_setup(uint32_t n)
+{
+  foc_pid_q = PIDIqHandle_M1;
+  foc_pid_d = PIDIdHandle_M1;
+  PID_SetIntegralTerm(&foc_pid_q, 0);
+  PID_SetIntegralTerm(&foc_pid_d, 0);
+
+  lcg_state = 7;
+  int32_t q = 0, d = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    q += prng_q15() >> 5;
+    d += prng_q15() >> 6;
+    if ((i % 200U) == 100U) {
+      q = (prng_q15() >= 0) ? 30000 : -30000;
+    }
+    q = (q > 32767) ? 32767 : ((q < -32767) ? -32767 : q);
+    d = (d > 32767) ? 32767 : ((d < -32767) ? -32767 : d);
+    buf.pi.err[i].q = (int16_t)q;
+    buf.pi.err[i].d = (int16_t)d;
+  }
+  return 0;
+}
+
+static void run_pi_2x(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    int16_t vq = PI_Controller(&foc_pid_q, buf.pi.err[i].q);
+    int16_t vd = PI_Controller(&foc_pid_d, buf.pi.err[i].d);
+    sink_i = (int32_t)vq ^ (int32_t)vd;
+  }
+}
+
+static void run_pi_dq(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    qd_t v = PI_Controller_dq(&foc_pid_q, &foc_pid_d, buf.pi.err[i].q, buf.pi.err[i].d);
+    sink_i = (int32_t)v.q ^ (int32_t)v.d;
+  }
+}
+
+/* 两种实现从同一状态出发, 逐拍比较输出和积分项 */
+static int32_t pi_dq_check(uint32_t n)
+{
+  PID_Handle_t q1 = PIDIqHandle_M1, d1 = PIDIdHandle_M1;
+  PID_SetIntegralTerm(&q1, 0);
+  PID_SetIntegralTerm(&d1, 0);
+  PID_Handle_t q2 = q1, d2 = d1;
+  int32_t bad = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    int16_t vq = PI_Controller(&q1, buf.pi.err[i].q);
+    int16_t vd = PI_Controller(&d1, buf.pi.err[i].d);
+    qd_t v = PI_Controller_dq(&q2, &d2, buf.pi.err[i].q, buf.pi.err[i].d);
+    if ((v.q != vq) || (v.d != vd) || (q1.wIntegralTerm != q2.wIntegralTerm) ||
+        (d1.wIntegralTerm != d2.wIntegralTerm)) {
+      bad++;
+    }
+  }
+  return bad;
+}
+
+/* ── 圆限幅 / 开方: MCM_Sqrt 对 CORDIC 流水 ──
+ * Vqd 一半在圆内, 一半超限 (其中一部分 |Vd| > MaxVd), 开方输入覆盖
+ * Circle_Limitation 实际会给的范围. Circle_Limitation_Cordic 和 sqrt_pipe
+ * 不关中断用 CORDIC, 和 FOC ISR 抢, 只在 IDLE 跑. */
+static int circle_setup(uint32_t n)
+{
+  if (MC_GetSTMStateMotor1() != IDLE) {
+    return -1;
+  }
+  const int32_t lim = (int32_t)CircleLimitationM1.MaxModule;
+  lcg_state = 11;
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t q = (int32_t)prng_q15() * 2 + 1;     /* 满量程, 避开 -32768 */
+    int32_t d = ((int32_t)prng_q15() * 2 + 1) >> (((i & 3U) == 3U) ? 0 : 2);
+    if ((i & 1U) == 0U) {
+      /* 缩到圆内 */
+      q = (q * (lim / 2)) >> 15;
+      d = (d * (lim / 2)) >> 15;
+    }
+    buf.lim.vqd[i].q = (int16_t)q;
+    buf.lim.vqd[i].d = (int16_t)d;
+    buf.lim.sq[i] = lim * lim - d * d;
+  }
+  return 0;
+}
+
+static void run_circle_sqrt(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    qd_t v = Circle_Limitation(&CircleLimitationM1, buf.lim.vqd[i]);
+    sink_i = (int32_t)v.q ^ (int32_t)v.d;
+  }
+}
+
+static void run_circle_cordic(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    qd_t v = Circle_Limitation_Cordic(&CircleLimitationM1, buf.lim.vqd[i]);
+    sink_i = (int32_t)v.q ^ (int32_t)v.d;
+  }
+}
+
+static int32_t circle_check(uint32_t n)
+{
+  int32_t bad = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    qd_t a = Circle_Limitation(&CircleLimitationM1, buf.lim.vqd[i]);
+    qd_t b = Circle_Limitation_Cordic(&CircleLimitationM1, buf.lim.vqd[i]);
+    if ((a.q != b.q) || (a.d != b.d)) {
+      bad++;
+    }
+  }
+  return bad;
+}
+
+static void run_sqrt_mcm(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    sink_i = MCM_Sqrt(buf.lim.sq[i]);
+  }
+}
+
+static void run_sqrt_pipe(uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    sink_i = MCM_Sqrt_Finish(MCM_Sqrt_Start(buf.lim.sq[i]));
+  }
+}
+
+static int32_t sqrt_check(uint32_t n)
+{
+  int32_t bad = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    if (buf.lim.sq[i] > 0) {
+      if (MCM_Sqrt(buf.lim.sq[i]) != MCM_Sqrt_Finish(MCM_Sqrt_Start(buf.lim.sq[i]))) {
+        bad++;
+      }
+    }
+  }
+  return bad;
+}
+
+/* ── 注册表 ── */
+static const bench_case_t bench_cases[] = {
+  /* name           desc                                   n     n_max          setup             run              teardown           check */
+  { "loop",        "volatile add loop",                    10000, 0xFFFFFFFFu,  NULL,             run_loop,        NULL,              NULL },
+  { "sincos_soft", "sinf+cosf per call",                   1000,  0xFFFFFFFFu,  NULL,             run_sincos_soft, NULL,              NULL },
+  { "sincos_hal",  "CORDIC HAL_CORDIC_Calculate per call", 1000,  0xFFFFFFFFu,  cordic_hal_setup, run_sincos_hal,  NULL,              NULL },
+  { "sincos_reg",  "CORDIC WDATA/RDATA + float->q31",      1000,  0xFFFFFFFFu,  cordic_reg_setup, run_sincos_reg,  NULL,              NULL },
+  { "sincos_pure", "CORDIC WDATA/RDATA, q31 phase",        1000,  0xFFFFFFFFu,  cordic_reg_setup, run_sincos_pure, NULL,              NULL },
+  { "q31_pack",    "rad -> CORDIC q31 conversion only",    1000,  0xFFFFFFFFu,  NULL,             run_q31_pack,    NULL,              NULL },
+  { "vec_soft",    "sinf+cosf over a vector",              2048,  CORDIC_MAX_N, vec_setup,        run_vec_soft,    NULL,              NULL },
+  { "vec_hal",     "CORDIC one HAL call over a vector",    2048,  CORDIC_MAX_N, vec_setup,        run_vec_hal,     NULL,              NULL },
+  { "vec_pure",    "CORDIC WDATA/RDATA over a vector",     2048,  CORDIC_MAX_N, vec_reg_setup,    run_vec_pure,    NULL,              vec_sincos_check },
+  { "vec_dma",     "cordic_batch DMA, start to callback",  2048,  CORDIC_MAX_N, vec_reg_setup,    run_vec_dma,     NULL,              vec_sincos_check },
+  { "fir_soft",    "32-tap MA, C",                         1000,  FMAC_INPUT_N, fir_input_setup,  run_fir_soft,    NULL,              NULL },
+  { "fir_fmac",    "32-tap MA, FMAC HAL polling",          1000,  FMAC_INPUT_N - 1U, fir_fmac_setup, run_fir_fmac, fir_fmac_teardown, fir_fmac_check },
+  { "crc_byte",    "CRC-16 one table, per byte",           2048,  CRC_MAX_N,    crc_setup,        run_crc_byte,    NULL,              NULL },
+  { "crc_sb8",     "CRC-16 slice-by-8",                    2048,  CRC_MAX_N,    crc_setup,        run_crc_sb8,     NULL,              NULL },
+  { "crc_hw",      "CRC-16 CRC unit, word writes",         2048,  CRC_MAX_N,    crc_setup,        run_crc_hw,      NULL,              crc_hw_check },
+  { "foc_chain",   "Clarke/Park/PI dq/circle/rev Park",    1000,  FOC_CHAIN_MAX_N, foc_chain_setup, run_foc_chain, NULL,              NULL },
+  { "pi_2x",       "current PI, 2x PI_Controller",         1000,  PI_MAX_N,     pi_setup,         run_pi_2x,       NULL,              pi_dq_check },
+  { "pi_dq",       "current PI, PI_Controller_dq",         1000,  PI_MAX_N,     pi_setup,         run_pi_dq,       NULL,              pi_dq_check },
+  { "circle_sqrt", "Circle_Limitation, MCM_Sqrt",          1000,  CIRCLE_MAX_N, circle_setup,     run_circle_sqrt, NULL,              circle_check },
+  { "circle_cordic", "Circle_Limitation_Cordic",           1000,  CIRCLE_MAX_N, circle_setup,     run_circle_cordic, NULL,            circle_check },
+  { "sqrt_mcm",    "MCM_Sqrt, IRQ masked",                 1000,  CIRCLE_MAX_N, circle_setup,     run_sqrt_mcm,    NULL,              sqrt_check },
+  { "sqrt_pipe",   "MCM_Sqrt_Start/Finish, CSR restored",  1000,  CIRCLE_MAX_N, circle_setup,     run_sqrt_pipe,   NULL,              sqrt_check },
+};
+
+#define BENCH_CASE_COUNT   (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+void bench_init(void)
+{
+  memset(fmac_preload_zeros, 0, sizeof(fmac_preload_zeros));
+  for (uint32_t i = 0; i < FMAC_TAPS; i++) {
+    fmac_coeffs[i] = (int16_t)1024;   /* round(32768 / 32) */
+  }
+  (void)cordic_hal_setup(0);
+}
+
+void bench_opt_default(bench_opt_t *opt)
+{
+  opt->n = 0;
+  opt->reps = BENCH_DEFAULT_REPS;
+  opt->warmup = BENCH_DEFAULT_WARMUP;
+  opt->irq_masked = 0;
+  opt->fmt = BENCH_FMT_CSV;
+}
+
+uint32_t bench_count(void)
+{
+  return (uint32_t)BENCH_CASE_COUNT;
+}
+
+const bench_case_t *bench_get(uint32_t idx)
+{
+  return (idx < BENCH_CASE_COUNT) ? &bench_cases[idx] : NULL;
+}
+
+const bench_case_t *bench_find(const char *name)
+{
+  for (uint32_t i = 0; i < BENCH_CASE_COUNT; i++) {
+    if (strcmp(bench_cases[i].name, name) == 0) return &bench_cases[i];
+  }
+  return NULL;
+}
+
+/* reps <= BENCH_MAX_REPS, 插入排序足够 */
+static void sort_u32(uint32_t *v, uint32_t n)
+{
+  for (uint32_t i = 1; i < n; i++) {
+    uint32_t x = v[i];
+    uint32_t j = i;
+    while ((j > 0U) && (v[j - 1U] > x)) {
+      v[j] = v[j - 1U];
+      j--;
+    }
+    v[j] = x;
+  }
+}
+
+/* 单次执行 setup -> run (计时) -> teardown, 返回 run 的周期数 */
+static int bench_once(const bench_case_t *c, uint32_t n, uint8_t masked, uint32_t *cyc)
+{
+  if ((c->setup != NULL) && (c->setup(n) < 0)) {
+    return -1;
+  }
+
+  uint32_t primask = __get_PRIMASK();
+  if (masked != 0U) __disable_irq();
+  uint32_t t0 = DWT->CYCCNT;
+  c->run(n);
+  uint32_t t1 = DWT->CYCCNT;
+  if (masked != 0U) __set_PRIMASK(primask);
+
+  if (c->teardown != NULL) c->teardown();
+  *cyc = t1 - t0;
+  return 0;
+}
+
+void bench_run(const bench_case_t *c, const bench_opt_t *opt, bench_result_t *res)
+{
+  memset(res, 0, sizeof(*res));
+  res->err = -1;
+
+  uint32_t n = (opt->n != 0U) ? opt->n : c->n_default;
+  if (n > c->n_max) n = c->n_max;
+  uint32_t reps = opt->reps;
+  if (reps == 0U) reps = 1U;
+  if (reps > BENCH_MAX_REPS) reps = BENCH_MAX_REPS;
+  res->n = n;
+  res->reps = reps;
+
+  /* 关中断会饿死 FOC ISR, 电机转着时不允许 */
+  uint8_t masked = opt->irq_masked;
+  if ((masked != 0U) && (MC_GetSTMStateMotor1() != IDLE)) {
+    masked = 0U;
+  }
+  res->irq_masked = masked;
+
+  uint32_t cyc;
+  for (uint32_t i = 0; i < opt->warmup; i++) {
+    if (bench_once(c, n, masked, &cyc) < 0) {
+      res->status = -1;
+      return;
+    }
+  }
+  for (uint32_t i = 0; i < reps; i++) {
+    if (bench_once(c, n, masked, &samples[i]) < 0) {
+      res->status = -1;
+      return;
+    }
+  }
+
+  sort_u32(samples, reps);
+  res->min = samples[0];
+  res->max = samples[reps - 1U];
+  res->median = samples[reps / 2U];
+  /* nearest-rank p99: ceil(0.99 * reps) - 1 */
+  res->p99 = samples[(reps * 99U + 99U) / 100U - 1U];
+  res->cpe_x100 = (n != 0U) ? (uint32_t)((uint64_t)res->median * 100U / n) : 0U;
+
+  if (c->check != NULL) {
+    res->err = c->check(n);
+  }
+}
+
+void bench_print_header(const bench_opt_t *opt)
+{
+  if (opt->fmt == BENCH_FMT_CSV) {
+    log_printf("#build,%s %s,sysclk=%lu\r\n", __DATE__, __TIME__,
+               (unsigned long)SystemCoreClock);
+    log_printf("#bench,name,n,reps,irq,min,median,p99,max,cyc_per_elem,err\r\n");
+  }
+}
+
+void bench_print(const bench_case_t *c, const bench_opt_t *opt, const bench_result_t *res)
+{
+  if (res->status < 0) {
+    LOGW("bench %s: skipped (setup refused, FMAC/CORDIC busy?)", c->name);
+    return;
+  }
+
+  const char *irq = (res->irq_masked != 0U) ? "off" : "on";
+  unsigned long cpe_i = (unsigned long)(res->cpe_x100 / 100U);
+  unsigned long cpe_f = (unsigned long)(res->cpe_x100 % 100U);
+
+  if (opt->fmt == BENCH_FMT_JSON) {
+    log_printf("{\"bench\":\"%s\",\"n\":%lu,\"reps\":%lu,\"irq\":\"%s\","
+               "\"min\":%lu,\"median\":%lu,\"p99\":%lu,\"max\":%lu,"
+               "\"cyc_per_elem\":%lu.%02lu,\"err\":%ld}\r\n",
+               c->name, (unsigned long)res->n, (unsigned long)res->reps, irq,
+               (unsigned long)res->min, (unsigned long)res->median,
+               (unsigned long)res->p99, (unsigned long)res->max,
+               cpe_i, cpe_f, (long)res->err);
+  } else {
+    log_printf("bench,%s,%lu,%lu,%s,%lu,%lu,%lu,%lu,%lu.%02lu,%ld\r\n",
+               c->name, (unsigned long)res->n, (unsigned long)res->reps, irq,
+               (unsigned long)res->min, (unsigned long)res->median,
+               (unsigned long)res->p99, (unsigned long)res->max,
+               cpe_i, cpe_f, (long)res->err);
+  }
+}
@@ -0,0 +1,77 @@
+/*
+ * bench.h  - Benchmark registry + runner (DWT cycles)
+ *
+ * Usage:
+ *   bench_init()                       -> call once from cli_init()
+ *   bench_find("fir_fmac")             -> look up a registered case
+ *   bench_run(c, &opt, &res)           -> warmup + reps, min/median/p99
+ *   bench_print(c, &opt, &res)         -> one CSV or JSON line
+ *
+ * 每个 case 声明 setup/run/teardown 和输入规模 n. 只有 run() 计时,
+ * setup/teardown 每次重复都执行但不计时 (生成输入, 配置外设等).
+ *
+ * 输出行不带 "[I] " 前缀, 以 "bench," / "{" 开头, 可以直接 grep 出来
+ * 跨固件版本 diff.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#define BENCH_MAX_REPS           200U
+#define BENCH_DEFAULT_REPS       21U
+#define BENCH_DEFAULT_WARMUP     2U
+
+typedef struct {
+  const char *name;
+  const char *desc;
+  uint32_t n_default;
+  uint32_t n_max;
+  int      (*setup)(uint32_t n);      /* 可为 NULL; 返回 <0 表示跳过 (外设被占用等) */
+  void     (*run)(uint32_t n);        /* 被计时的部分 */
+  void     (*teardown)(void);         /* 可为 NULL */
+  int32_t  (*check)(uint32_t n);      /* 可为 NULL; 全部重复结束后调用一次, 返回不一致个数 */
+} bench_case_t;
+
+typedef enum {
+  BENCH_FMT_CSV = 0,
+  BENCH_FMT_JSON
+} bench_fmt_t;
+
+typedef struct {
+  uint32_t    n;                      /* 0 = 用 case 的 n_default */
+  uint32_t    reps;
+  uint32_t    warmup;
+  uint8_t     irq_masked;             /* 1 = 每次 run() 期间关中断 */
+  bench_fmt_t fmt;
+} bench_opt_t;
+
+typedef struct {
+  uint32_t n;
+  uint32_t reps;
+  uint32_t min;
+  uint32_t median;
+  uint32_t p99;
+  uint32_t max;
+  uint32_t cpe_x100;                  /* cycles/element * 100 (median) */
+  int32_t  err;                       /* check() 结果, 没有 check 时为 -1 */
+  uint8_t  irq_masked;                /* 实际是否关了中断 (单次过长会退回不关) */
+  int      status;                    /* 0 ok, <0 setup 拒绝 */
+} bench_result_t;
+
+void bench_init(void);
+void bench_opt_default(bench_opt_t *opt);
+
+uint32_t bench_count(void);
+const bench_case_t *bench_get(uint32_t idx);
+const bench_case_t *bench_find(const char *name);
+
+void bench_run(const bench_case_t *c, const bench_opt_t *opt, bench_result_t *res);
+void bench_print_header(const bench_opt_t *opt);
+void bench_print(const bench_case_t *c, const bench_opt_t *opt, const bench_result_t *res);
+
+#endif /* BENCH_H_ */
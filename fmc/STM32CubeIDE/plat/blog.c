@@ -0,0 +1,109 @@
+/*
+ * blog.c  - Deferred binary log ring
+ *
+ * 多生产者 (任意中断优先级 + 主循环), 单消费者 (log_poll):
+ *   预留: LDREX/STREX 推进 blog_wr, 失败重试, 不关中断
+ *   提交: 先写时间戳和参数, __DMB, 最后写 w0 (非零)
+ *   消费: w0 == 0 说明最早那条还没提交 (被更高优先级打断), 下次再来;
+ *         读完把整条记录清零, 再推进 blog_rd. 记录长度不一, 绕回后下一条
+ *         的 w0 可能落在上一圈某条的参数字上, 只清 w0 会把旧参数当成已提交
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "blog.h"
+#include "stm32g4xx.h"
+
+#if (BLOG_RING_WORDS & (BLOG_RING_WORDS - 1U)) != 0U
+#error "BLOG_RING_WORDS must be a power of two"
+#endif
+
+#define BLOG_MASK   (BLOG_RING_WORDS - 1U)
+
+static volatile uint32_t blog_ring[BLOG_RING_WORDS];
+static volatile uint32_t blog_wr = 0U;     /* 生产者预留位置 (自由增长) */
+static volatile uint32_t blog_rd = 0U;     /* 消费者位置 */
+static volatile blog_stats_t blog_st;
+static uint32_t blog_drops_rep = 0U;       /* log_poll 已报告的丢弃数, 只有消费者用 */
+
+static inline void atomic_inc(volatile uint32_t *p)
+{
+  uint32_t v;
+  do {
+    v = __LDREXW(p) + 1U;
+  } while (__STREXW(v, p) != 0U);
+}
+
+void blog_write(uint32_t hdr, const uint32_t *args)
+{
+  uint32_t nargs = (hdr >> 8) & 0x0FU;
+  uint32_t len = 2U + nargs;
+  uint32_t w;
+  uint32_t used;
+
+  do {
+    w = __LDREXW(&blog_wr);
+    used = w + len - blog_rd;
+    if (used > BLOG_RING_WORDS) {
+      __CLREX();
+      atomic_inc(&blog_st.dropped);
+      return;
+    }
+  } while (__STREXW(w + len, &blog_wr) != 0U);
+
+  blog_ring[(w + 1U) & BLOG_MASK] = DWT->CYCCNT;
+  for (uint32_t i = 0; i < nargs; i++) {
+    blog_ring[(w + 2U + i) & BLOG_MASK] = args[i];
+  }
+  __DMB();
+  blog_ring[w & BLOG_MASK] = hdr;
+
+  atomic_inc(&blog_st.written);
+  if (used > blog_st.max_used) blog_st.max_used = used;   /* 统计用, 竞争无所谓 */
+}
+
+uint32_t blog_read(uint32_t *rec, uint32_t max_words)
+{
+  uint32_t r = blog_rd;
+  if (r == blog_wr) return 0U;
+
+  uint32_t hdr = blog_ring[r & BLOG_MASK];
+  if (hdr == 0U) return 0U;              /* 预留了但还没提交 */
+  __DMB();
+
+  uint32_t len = 2U + ((hdr >> 8) & 0x0FU);
+  for (uint32_t i = 0; i < len; i++) {
+    if (i < max_words) rec[i] = blog_ring[(r + i) & BLOG_MASK];
+    blog_ring[(r + i) & BLOG_MASK] = 0U;
+  }
+  __DMB();
+  blog_rd = r + len;
+  return (len <= max_words) ? len : max_words;
+}
+
+void blog_get_stats(blog_stats_t *out)
+{
+  out->written  = blog_st.written;
+  out->dropped  = blog_st.dropped;
+  out->max_used = blog_st.max_used;
+}
+
+uint32_t blog_drops_unreported(uint32_t *dropped)
+{
+  *dropped = blog_st.dropped;
+  return (*dropped != blog_drops_rep) ? 1U : 0U;
+}
+
+void blog_drops_reported(uint32_t dropped)
+{
+  blog_drops_rep = dropped;
+}
+
+void blog_reset(void)
+{
+  blog_st.written = 0U;
+  blog_st.dropped = 0U;
+  blog_st.max_used = 0U;
+  blog_drops_rep = 0U;
+}
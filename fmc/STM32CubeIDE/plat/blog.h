@@ -0,0 +1,93 @@
+/*
+ * blog.h  - Deferred binary log (format-string ID + raw args), ISR safe
+ *
+ * Usage:
+ *   BLOGI("sto: el_angle=%d speed=%d", a, s);   -> 任意上下文, 包括 ADC/TIM1 ISR
+ *   blog_read(rec, max)                          -> 主循环取走一条记录 (log_poll 用)
+ *   host: blog_decode fmc.elf capture.txt        -> 按 ELF 里的格式串还原文本
+ *
+ * 格式串放在 .logfmt 段 (链接脚本里是 INFO 段, 不占 flash), 记录里只存
+ * 它在段内的偏移. 记录 (32-bit 字):
+ *   w0  id[31:16] | level[13:12] | nargs[11:8] | BLOG_MARK[7:0]
+ *   w1  DWT->CYCCNT
+ *   w2.. 参数, 每个一个字: 整数按 32 位截断, float/double 存 float 位型,
+ *        %s 存地址 (只能解析 flash 里的常量串)
+ *
+ * 写入约 30-60 cycles: LDREX/STREX 预留空间, 写参数, 最后写 w0 提交.
+ * 多个中断优先级同时写也安全; 满了直接丢, 计数.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef BLOG_H_
+#define BLOG_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define BLOG_RING_WORDS          1024U   /* 2 的幂 */
+#define BLOG_MAX_ARGS            8U
+#define BLOG_MAX_REC_WORDS       (2U + BLOG_MAX_ARGS)
+#define BLOG_MARK                0xB5U
+
+#define BLOG_LVL_I               1U
+#define BLOG_LVL_W               2U
+#define BLOG_LVL_E               3U
+
+typedef struct {
+  uint32_t written;       /* 提交的记录数 */
+  uint32_t dropped;       /* 空间不足丢掉的记录数 */
+  uint32_t max_used;      /* 占用高水位 (字) */
+} blog_stats_t;
+
+void blog_write(uint32_t hdr, const uint32_t *args);
+/* 取一条已提交的记录到 rec[], 返回字数; 没有返回 0. 只能单消费者调用 */
+uint32_t blog_read(uint32_t *rec, uint32_t max_words);
+void blog_get_stats(blog_stats_t *out);
+/* 有还没报告的丢弃时返回 1, *dropped 为累计丢弃数; 报告 ("#D:") 后调
+ * blog_drops_reported(*dropped). 单消费者用, blog_reset 一起清零 */
+uint32_t blog_drops_unreported(uint32_t *dropped);
+void blog_drops_reported(uint32_t dropped);
+void blog_reset(void);
+
+/* ── 参数按类型转成 32-bit 字 ── */
+static inline uint32_t blog_arg_u(uint32_t v)        { return v; }
+static inline uint32_t blog_arg_p(const void *p)     { return (uint32_t)(uintptr_t)p; }
+static inline uint32_t blog_arg_f(float f)           { uint32_t u; memcpy(&u, &f, 4); return u; }
+static inline uint32_t blog_arg_d(double d)          { return blog_arg_f((float)d); }
+
+#define BLOG_U(x) _Generic((x),                   \
+    float: blog_arg_f, double: blog_arg_d,        \
+    char *: blog_arg_p, const char *: blog_arg_p, \
+    void *: blog_arg_p, const void *: blog_arg_p, \
+    default: blog_arg_u)(x)
+
+#define BLOG_NARGS(...)   BLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...)  N
+
+#define BLOG_A0()
+#define BLOG_A1(a)                       , BLOG_U(a)
+#define BLOG_A2(a, b)                    BLOG_A1(a) BLOG_A1(b)
+#define BLOG_A3(a, b, c)                 BLOG_A2(a, b) BLOG_A1(c)
+#define BLOG_A4(a, b, c, d)              BLOG_A3(a, b, c) BLOG_A1(d)
+#define BLOG_A5(a, b, c, d, e)           BLOG_A4(a, b, c, d) BLOG_A1(e)
+#define BLOG_A6(a, b, c, d, e, f)        BLOG_A5(a, b, c, d, e) BLOG_A1(f)
+#define BLOG_A7(a, b, c, d, e, f, g)     BLOG_A6(a, b, c, d, e, f) BLOG_A1(g)
+#define BLOG_A8(a, b, c, d, e, f, g, h)  BLOG_A7(a, b, c, d, e, f, g) BLOG_A1(h)
+#define BLOG_CAT_(a, b)   a##b
+#define BLOG_CAT(a, b)    BLOG_CAT_(a, b)
+
+/* _a[0] 是占位, 保证 0 参数时数组也合法 */
+#define BLOG(lvl, fmt, ...) do {                                                  \
+    static const char _blog_fmt[] __attribute__((section(".logfmt"), used)) = fmt; \
+    const uint32_t _blog_a[] = { 0U BLOG_CAT(BLOG_A, BLOG_NARGS(__VA_ARGS__))(__VA_ARGS__) }; \
+    blog_write(((uint32_t)(uintptr_t)_blog_fmt << 16) | ((uint32_t)(lvl) << 12) |  \
+               ((uint32_t)BLOG_NARGS(__VA_ARGS__) << 8) | BLOG_MARK, &_blog_a[1]); \
+  } while (0)
+
+#define BLOGI(fmt, ...)   BLOG(BLOG_LVL_I, fmt, ##__VA_ARGS__)
+#define BLOGW(fmt, ...)   BLOG(BLOG_LVL_W, fmt, ##__VA_ARGS__)
+#define BLOGE(fmt, ...)   BLOG(BLOG_LVL_E, fmt, ##__VA_ARGS__)
+
+#endif /* BLOG_H_ */
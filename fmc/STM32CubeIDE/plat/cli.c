@@ -5,50 +5,26 @@
  *      Author: SYRLIST
  */
 
-#include "fmac.h"
 #include "cli.h"
 #include "log.h"
 #include "main.h"
-#include "cordic.h"
 #include <string.h>
 #include <stdlib.h>
-#include <math.h>
 #include <ctype.h>
 #include "fmac_rt.h"
+#include "fmac_mc.h"
+#include "hf_prof.h"
 #include "tim.h"
 #include "adc.h"
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-#define CORDIC_MAX_N 5000
-#define FMAC_TAPS        32
-#define FMAC_INPUT_N     5000
-#define PI M_PI
+#include "bench.h"
+#include "bsp_uart.h"
+#include "obs_cap.h"
+#include "pwm_gov.h"
+#include "stack_mon.h"
+#include "fault_rec.h"
+#include "cordic_batch.h"
+#include "parameters_conversion.h"
 #define CLI_LINE_MAX 96
-extern CORDIC_HandleTypeDef hcordic;
-extern FMAC_HandleTypeDef hfmac;
-
-
-static inline uint32_t dwt_cycles(void) { return DWT->CYCCNT; }
-
-static void cordic_sincos_init(void)
-{
-  CORDIC_ConfigTypeDef cfg = {0};
-  cfg.Function  = CORDIC_FUNCTION_COSINE;     // 输出 cos + sin
-  cfg.Precision = CORDIC_PRECISION_6CYCLES;
-  cfg.Scale     = CORDIC_SCALE_0;
-  cfg.NbWrite   = CORDIC_NBWRITE_1;
-  cfg.NbRead    = CORDIC_NBREAD_2;
-  cfg.InSize    = CORDIC_INSIZE_32BITS;
-  cfg.OutSize   = CORDIC_OUTSIZE_32BITS;
-
-  if (HAL_CORDIC_Configure(&hcordic, &cfg) != HAL_OK) {
-    LOGE("cordic cfg fail");
-  }
-}
-
-
-
 
 static char line[CLI_LINE_MAX];
 static volatile uint16_t linelen = 0;
@@ -62,391 +38,11 @@ static void dwt_init(void)
   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
-
-
-static uint32_t bench_loop_cycles(uint32_t n)
-{
-  volatile uint32_t s = 0;
-  uint32_t t0 = DWT->CYCCNT;
-  for (uint32_t i = 0; i < n; i++) s += i;
-  uint32_t t1 = DWT->CYCCNT;
-  (void)s;
-  return (t1 - t0);
-}
-static inline int32_t float_to_q31(float x)
-{
-  // x in [-1, 1)
-  if (x >= 0.999999f) x = 0.999999f;
-  if (x < -1.0f) x = -1.0f;
-  return (int32_t)(x * 2147483648.0f); // 2^31
-}
-
-static inline float q31_to_float(int32_t q)
-{
-  return (float)q / 2147483648.0f;
-}
-
-// angle: rad -> normalized to [-pi, pi] then to q31 where 1.0 == pi (常用映射)
-static inline int32_t rad_to_cordic_q31(float rad)
-{
-  // wrap to [-pi, pi]
-  while (rad >  PI) rad -= 2.0f*PI;
-  while (rad < -PI) rad += 2.0f*PI;
-  // map rad/pi to [-1,1)
-  return float_to_q31(rad / PI);
-}
-
-
-static uint32_t bench_soft_sincos(uint32_t n)
-{
-  volatile float s=0, c=0;
-  (void)s;
-  (void)c;
-  uint32_t t0 = DWT->CYCCNT;
-  for (uint32_t i=0;i<n;i++){
-    float a = (float)i * 0.001f;
-    s = sinf(a);
-    c = cosf(a);
-  }
-  uint32_t t1 = DWT->CYCCNT;
-  return (t1 - t0);
-}
-
-
-static uint32_t bench_cordic_sincos(uint32_t n)
-{
-  // CORDIC sin/cos: input angle q31, output [cos, sin] q31（具体顺序依配置）
-  int32_t in, out[2];
-
-  uint32_t t0 = DWT->CYCCNT;
-  for (uint32_t i=0;i<n;i++){
-    float a = (float)i * 0.001f;
-    in = rad_to_cordic_q31(a);
-
-    // HAL API：根据Cube配置可能是 Calculate / CORDIC_Calculate 等
-    // 常用是：HAL_CORDIC_Calculate(&hcordic, &in, out, 1, HAL_MAX_DELAY);
-    HAL_CORDIC_Calculate(&hcordic, (int32_t*)&in, (int32_t*)out, 1, 1000);
-
-    // 防止被优化掉
-    volatile float cs = q31_to_float(out[0]);
-    volatile float sn = q31_to_float(out[1]);
-    (void)cs; (void)sn;
-  }
-  uint32_t t1 = DWT->CYCCNT;
-  return (t1 - t0);
-}
-/* ── CORDIC 直接寄存器版 ─────────────────────────────────────────────
- *
- * CORDIC CSR 配置 (一次写入, 之后只操作 WDATA/RDATA):
- *   FUNC[3:0]   = 0  (Cosine → 输出 cos, sin)
- *   PREC[3:0]   = 6  (6 次迭代, ~20-bit 精度)
- *   SCALE[2:0]  = 0
- *   NRES        = 1  (读 2 个结果: cos + sin)
- *   NARGS       = 0  (写 1 个参数: 角度)
- *   RESSIZE     = 0  (32-bit 输出)
- *   ARGSIZE     = 0  (32-bit 输入)
- *
- * CSR = (6 << 4) | (1 << 19) = 0x00080060
- *
- * 每次调用只需:  WDATA = angle;  cos = RDATA;  sin = RDATA;
- * 硬件延迟: 6 个时钟周期 (CORDIC pipeline)
- * ──────────────────────────────────────────────────────────────────── */
-#define CORDIC_CSR_SINCOS_6ITER  0x00080060u
-
-static void cordic_reg_init(void)
-{
-  CORDIC->CSR = CORDIC_CSR_SINCOS_6ITER;
-}
-
-static uint32_t bench_cordic_sincos_reg(uint32_t n)
-{
-  volatile int32_t cos_q31, sin_q31;
-
-  /* 确保 CSR 配置正确 */
-  CORDIC->CSR = CORDIC_CSR_SINCOS_6ITER;
-
-  uint32_t t0 = DWT->CYCCNT;
-  for (uint32_t i = 0; i < n; i++) {
-    float a = (float)i * 0.001f;
-    int32_t in = rad_to_cordic_q31(a);
-
-    CORDIC->WDATA = (uint32_t)in;     /* 写入角度 → 硬件开始计算 */
-    cos_q31 = (int32_t)CORDIC->RDATA; /* 读 cos (阻塞到计算完成) */
-    sin_q31 = (int32_t)CORDIC->RDATA; /* 读 sin */
-  }
-  uint32_t t1 = DWT->CYCCNT;
-
-  (void)cos_q31; (void)sin_q31;
-  return (t1 - t0);
-}
-
-/* 纯寄存器版, 跳过 float→q31 转换, 测纯硬件吞吐 */
-static uint32_t bench_cordic_pure_reg(uint32_t n)
-{
-  volatile int32_t c, s;
-  CORDIC->CSR = CORDIC_CSR_SINCOS_6ITER;
-
-  /* 用 Q31 整数相位累加, 零浮点开销 */
-  uint32_t phase = 0;
-  const uint32_t step = (uint32_t)(0.001f / PI * 2147483648.0f);
-
-  uint32_t t0 = DWT->CYCCNT;
-  for (uint32_t i = 0; i < n; i++) {
-    CORDIC->WDATA = phase;
-    c = (int32_t)CORDIC->RDATA;
-    s = (int32_t)CORDIC->RDATA;
-    phase += step;
-  }
-  uint32_t t1 = DWT->CYCCNT;
-
-  (void)c; (void)s;
-  return (t1 - t0);
-}
-
-static void bench_cordic_reg_breakdown(uint32_t n,
-                                       uint32_t *cyc_pack,
-                                       uint32_t *cyc_hw,
-                                       uint32_t *cyc_unpack)
-{
-  if (n == 0) { *cyc_pack = *cyc_hw = *cyc_unpack = 0; return; }
-
-  /* CORDIC 配置 */
-  CORDIC->CSR = CORDIC_CSR_SINCOS_6ITER;
-
-  volatile int32_t cos_q31, sin_q31;
-  volatile float cs, sn;
-
-  uint32_t pack = 0, hw = 0, unpack = 0;
-
-  for (uint32_t i = 0; i < n; i++) {
-    /* 1) float -> q31 (含你的 rad wrap + 缩放) */
-    uint32_t t0 = DWT->CYCCNT;
-    float a = (float)i * 0.001f;
-    int32_t in = rad_to_cordic_q31(a);
-    uint32_t t1 = DWT->CYCCNT;
-    pack += (t1 - t0);
-
-    /* 2) 纯硬件：写入 + 两次读出 */
-    t0 = DWT->CYCCNT;
-    CORDIC->WDATA = (uint32_t)in;
-    cos_q31 = (int32_t)CORDIC->RDATA;
-    sin_q31 = (int32_t)CORDIC->RDATA;
-    t1 = DWT->CYCCNT;
-    hw += (t1 - t0);
-
-    /* 3) q31 -> float */
-    t0 = DWT->CYCCNT;
-    cs = q31_to_float(cos_q31);
-    sn = q31_to_float(sin_q31);
-    t1 = DWT->CYCCNT;
-    unpack += (t1 - t0);
-  }
-
-  (void)cs; (void)sn;
-
-  *cyc_pack = pack;
-  *cyc_hw = hw;
-  *cyc_unpack = unpack;
-}
-
-static int16_t g_x[FMAC_INPUT_N];
-static int16_t g_y_soft[FMAC_INPUT_N];
-static int16_t g_y_hw[FMAC_INPUT_N];
-
-static uint32_t lcg_state = 1;
-static int16_t prng_q15(void)
-{
-  // 伪随机，范围大概在 [-0.5, 0.5)
-  lcg_state = 1664525u * lcg_state + 1013904223u;
-  int32_t v = (int32_t)(lcg_state >> 16) - 32768;
-  return (int16_t)(v >> 1);
-}
-
-static void gen_input(uint32_t n)
-{
-  if (n > FMAC_INPUT_N) n = FMAC_INPUT_N;
-  for (uint32_t i = 0; i < n; i++) g_x[i] = prng_q15();
-}
-
-static void fir_soft_q15_ma32(const int16_t *x, int16_t *y, uint32_t n)
-{
-  // 32tap 移动平均：y = (sum x[k]) / 32
-  // q15 * q15 的严格实现很麻烦；这里用“平均”避开系数乘法：累加后右移 5 位
-  for (uint32_t i = 0; i < n; i++) {
-    int32_t acc = 0;
-    for (uint32_t k = 0; k < FMAC_TAPS; k++) {
-      int32_t idx = (int32_t)i - (int32_t)k;
-      int16_t xv = (idx >= 0) ? x[idx] : 0;
-      acc += xv;
-    }
-    // 平均
-    acc >>= 5;
-    // 饱和到 q15
-    if (acc > 32767) acc = 32767;
-    if (acc < -32768) acc = -32768;
-    y[i] = (int16_t)acc;
-  }
-}
-
-static uint32_t bench_soft_fir(uint32_t n)
-{
-  uint32_t t0 = dwt_cycles();
-  fir_soft_q15_ma32(g_x, g_y_soft, n);
-  uint32_t t1 = dwt_cycles();
-  return (t1 - t0);
-}
-
-static int16_t fmac_coeffs[FMAC_TAPS];  /* 32-tap 移动平均系数 */
-static int16_t fmac_preload_zeros[FMAC_TAPS];
-
-static void fmac_fir_init(void)
-{
-	memset(fmac_preload_zeros, 0, sizeof(fmac_preload_zeros));
-  /* 32-tap 移动平均: 每个系数 = 1/32 = 1024 in Q15 */
-  for (int i = 0; i < FMAC_TAPS; i++) {
-    fmac_coeffs[i] = (int16_t)1024;   /* round(32768 / 32) */
-  }
-}
-
-/*
- * FMAC 内部 RAM = 256 x 16-bit words
- * 分配:
- *   X1 (input buffer):  addr 0,   size 64  (32 delay + 32 watermark)
- *   X2 (coefficients):  addr 64,  size 32
- *   Y  (output buffer): addr 96,  size 64
- *   Total = 160 / 256, OK
- */
-static uint32_t bench_fmac_fir(uint32_t n)
-{
-  if (n > (FMAC_INPUT_N - 1)) n = FMAC_INPUT_N - 1;
-
-  memset(g_y_hw, 0, sizeof(int16_t) * (n + 1));
-
-  FMAC_FilterConfigTypeDef cfg = {0};
-  cfg.InputBaseAddress  = 0;
-  cfg.InputBufferSize   = 64;
-  cfg.InputThreshold    = FMAC_THRESHOLD_1;
-  cfg.CoeffBaseAddress  = 64;
-  cfg.CoeffBufferSize   = FMAC_TAPS;
-  cfg.OutputBaseAddress = 96;
-  cfg.OutputBufferSize  = 64;
-  cfg.OutputThreshold   = FMAC_THRESHOLD_1;
-  cfg.pCoeffA           = NULL;
-  cfg.CoeffASize        = 0;
-  cfg.pCoeffB           = fmac_coeffs;
-  cfg.CoeffBSize        = FMAC_TAPS;
-  cfg.Filter            = FMAC_FUNC_CONVO_FIR;
-  cfg.InputAccess       = FMAC_BUFFER_ACCESS_POLLING;
-  cfg.OutputAccess      = FMAC_BUFFER_ACCESS_POLLING;
-  cfg.Clip              = FMAC_CLIP_ENABLED;
-  cfg.P                 = FMAC_TAPS;
-  cfg.Q                 = 0;
-  cfg.R                 = 0;
-
-  if (HAL_FMAC_FilterConfig(&hfmac, &cfg) != HAL_OK) {
-    LOGE("FMAC config fail");
-    return 0;
-  }
-
-  if (HAL_FMAC_FilterPreload(&hfmac, fmac_preload_zeros, FMAC_TAPS, NULL, 0) != HAL_OK) {
-    LOGE("FMAC preload fail");
-    return 0;
-  }
-
-  /* 请求 n+1 个输出: [0]=pipeline零, [1..n]=真实结果 */
-  uint16_t outRemain = (uint16_t)(n + 1);
-  if (HAL_FMAC_FilterStart(&hfmac, g_y_hw, &outRemain) != HAL_OK) {
-    LOGE("FMAC start fail");
-    return 0;
-  }
-
-  uint32_t t0 = DWT->CYCCNT;
-
-  uint16_t fed = 0;
-  while (fed < n) {
-    uint16_t chunk = (uint16_t)(n - fed);
-    HAL_StatusTypeDef st = HAL_FMAC_AppendFilterData(&hfmac, &g_x[fed], &chunk);
-    if (st == HAL_OK) {
-      fed += chunk;
-    } else if (st == HAL_BUSY) {
-      HAL_FMAC_PollFilterData(&hfmac, 10);
-    } else {
-      LOGE("FMAC append fail (%d) at %u", st, fed);
-      break;
-    }
-  }
-
-  HAL_FMAC_PollFilterData(&hfmac, 1000);
-
-  uint32_t t1 = DWT->CYCCNT;
-
-  HAL_FMAC_FilterStop(&hfmac);
-
-  volatile int16_t sink = g_y_hw[n];
-  (void)sink;
-
-  return (t1 - t0);
-}
-
-
-/* diff_count removed: fmaccmp now uses inline comparison with pipeline offset */
-static int32_t in_vec[CORDIC_MAX_N];
-static int32_t out_vec[CORDIC_MAX_N * 2];
-
-static uint32_t bench_cordic_vec(uint32_t n)
-{
-  if (n > CORDIC_MAX_N) n = CORDIC_MAX_N;
-
-  // 生成输入：用 Q31 相位累加，避免 while wrap 的开销
-  // Q31 表示 (rad / PI) in [-1,1)
-  const float step_rad = 0.001f;
-  uint32_t step_u = (uint32_t)((step_rad / PI) * 2147483648.0f); // 2^31 * step/PI
-  uint32_t phase_u = 0;
-
-  for (uint32_t i = 0; i < n; i++) {
-    in_vec[i] = (int32_t)phase_u;   // 直接解释为有符号 Q31
-    phase_u += step_u;              // uint32 自然回绕，无 UB
-  }
-
-  uint32_t t0 = DWT->CYCCNT;
-  HAL_CORDIC_Calculate(&hcordic, in_vec, out_vec, n, HAL_MAX_DELAY);
-  uint32_t t1 = DWT->CYCCNT;
-
-  // 防止优化
-  volatile int32_t sink = out_vec[0] ^ out_vec[1];
-  (void)sink;
-
-  return (t1 - t0);
-}
-static uint32_t bench_soft_vec(uint32_t n)
-{
-  if (n > CORDIC_MAX_N) n = CORDIC_MAX_N;
-
-  volatile float s = 0.0f, c = 0.0f;
-
-  // 计时区间只做 sinf/cosf（输入生成放外面）
-  float a = 0.0f;
-  const float step = 0.001f;
-
-  uint32_t t0 = DWT->CYCCNT;
-  for (uint32_t i = 0; i < n; i++) {
-    s = sinf(a);
-    c = cosf(a);
-    a += step;
-  }
-  uint32_t t1 = DWT->CYCCNT;
-
-  (void)s; (void)c;
-  return (t1 - t0);
-}
-
 void cli_init(void)
 {
   dwt_init();
-  cordic_sincos_init();
-  cordic_reg_init();
-  fmac_fir_init();
-  LOGI("cli ready: help / tick / bench <n> / cordic* / fmaccmp <n>");
+  bench_init();
+  LOGI("cli ready: help / tick / bench list / bench run <name|all>");
 }
 
 void cli_on_rx_byte(uint8_t b)
@@ -487,27 +83,39 @@ static void exec_cmd(char *cmd)
     LOGI("cmds:");
     LOGI("  help");
     LOGI("  tick");
-    LOGI("  bench <n>   (e.g. bench 10000)");
-    LOGI("  cordic <n>  (HAL vs soft. e.g. cordic 1000)");
-    LOGI("  cordicr <n> (REG vs HAL vs soft. e.g. cordicr 1000)");
-    LOGI("  cordicv <n> (vector, one HAL call. e.g. cordicv 5000)");
-    LOGI("  cordiccmp <n> (soft vs hw vec. e.g. cordiccmp 5000)");
-    LOGI("  cordicbd <n> (REG breakdown: pack/hw/unpack. e.g. cordicbd 1000)");
-    LOGI("  fmacdbg    (diagnostic: prints actual soft vs hw values)");
-    LOGI("  fmaccmp <n> (e.g. fmaccmp 5000)");
-    LOGI("  adcstart    (start ADC+FMAC @ 20kHz)");
+    LOGI("  bench list");
+    LOGI("  bench run <name|all> [n=<n>] [reps=<r>] [warm=<w>] [mask] [json]");
+    LOGI("              (min/median/p99 cycles, CSV or JSON; mask = IRQs off, motor idle only)");
+    LOGI("  adcstart [dma] (start ADC+FMAC; dma = ADC->FMAC->mem chain, no ISR cost)");
     LOGI("  adcstop     (stop ADC)");
     LOGI("  adcstat     (show noise statistics)");
     LOGI("  adcdump <n> (print raw vs filtered, default 32)");
+    LOGI("  fmacset [ma <taps>|fir <fc> <taps>|iir <fc> [1|2]|notch <f0> [q]|verify [n]]");
+    LOGI("  fmacmc [start|stop|verify [n]] (Ia/Ib/Vbus time-multiplexed FMAC FIR)");
+    LOGI("  hfprof [hist|reset] (ADC ISR per-stage cycles / MC_DURATION margin)");
+    LOGI("  gov [off|auto|fix <n>] (PWM / FOC rate profiles by speed and HF load)");
+    LOGI("  uartstat    (console TX/RX ring / DMA counters)");
+    LOGI("  stack [reset] (MSP peak from boot painting, ISR nesting, headroom)");
+    LOGI("  frec [dump|clear] (fault black box; #FH:/#F: lines for host frec_decode)");
+    LOGI("  cbatch [bench [n]|abort] (CORDIC DMA batch; el/us vs WDATA/RDATA loop)");
+    LOGI("  blog [test|reset] (binary log ring; decode #B: lines with host blog_decode)");
+    LOGI("  cap [start [n] [stream]|stop] (observer input trace, #O: lines for host obs_replay)");
     return;
   }
 
-  if (strcmp(cmd, "adcstart") == 0) {
+  if (strncmp(cmd, "adcstart", 8) == 0 && (cmd[8] == 0 || cmd[8] == ' ')) {
+      char *p = cmd + 8;
+      while (*p == ' ') p++;
+      fmac_rt_mode_t mode = (strcmp(p, "dma") == 0) ? FMAC_RT_MODE_DMA : FMAC_RT_MODE_ISR;
+
+      fmac_mc_stop();
       fmac_rt_set_active(0U);
+      fmac_rt_set_mode(mode);
       fmac_rt_reset_stats();
       fmac_rt_restart();
       fmac_rt_set_active(1U);
-      LOGI("ADC+FMAC capture enabled (source: ADC1_2 IRQ)");
+      LOGI("ADC+FMAC capture enabled (source: %s)",
+           (mode == FMAC_RT_MODE_DMA) ? "TIM1_UP DMA -> FMAC -> DMA" : "ADC1_2 IRQ");
       return;
     }
 
@@ -516,6 +124,9 @@ static void exec_cmd(char *cmd)
       fmac_rt_stats_t s = fmac_rt_get_stats();
       LOGI("ADC+FMAC stopped, %lu samples collected",
            (unsigned long)s.valid_count);
+      if (fmac_rt_get_mode() == FMAC_RT_MODE_DMA) {
+        LOGI("  dma block overruns: %lu", (unsigned long)fmac_rt_dma_overruns());
+      }
       return;
     }
 
@@ -523,7 +134,7 @@ static void exec_cmd(char *cmd)
       fmac_rt_stats_t s = fmac_rt_get_stats();
       if (s.valid_count == 0U) {
         LOGI("no settled samples yet (run adcstart and wait %u samples)",
-             (unsigned)FMAC_RT_SETTLE_SAMPLES);
+             (unsigned)fmac_rt_settle_samples());
         return;
       }
 
@@ -580,201 +191,517 @@ static void exec_cmd(char *cmd)
       return;
     }
 
-  if (strcmp(cmd, "tick") == 0) {
-    LOGI("tick=%lu", (unsigned long)HAL_GetTick());
+  if (strncmp(cmd, "fmacset", 7) == 0 && (cmd[7] == 0 || cmd[7] == ' ')) {
+    char *p = cmd + 7;
+    while (*p == ' ') p++;
+
+    if (strncmp(p, "verify", 6) == 0) {
+      uint32_t n = (uint32_t)strtoul(p + 6, NULL, 10);
+      if (n == 0) n = 2000;
+      int16_t max_abs = 0;
+      int32_t bad = fmac_rt_verify(n, &max_abs);
+      if (bad < 0) {
+        LOGW("fmacset verify: FMAC busy (adcstop / fmacmc stop)");
+      } else {
+        LOGI("fmacset verify n=%lu mismatch=%ld max_abs_diff=%d %s",
+             (unsigned long)n, (long)bad, (int)max_abs, (bad == 0) ? "BIT-EXACT" : "");
+      }
+      return;
+    }
+
+    fmac_design_t d;
+    fmac_design_status_t st = FMAC_DESIGN_OK;
+    int have = 1;
+    char *e;
+    if (strncmp(p, "ma", 2) == 0) {
+      st = fmac_design_boxcar(&d, (uint8_t)strtoul(p + 2, NULL, 10));
+    } else if (strncmp(p, "fir", 3) == 0) {
+      float fc = strtof(p + 3, &e);
+      st = fmac_design_fir_lowpass(&d, fmac_rt_fs_hz(), fc, (uint8_t)strtoul(e, NULL, 10));
+    } else if (strncmp(p, "iir", 3) == 0) {
+      float fc = strtof(p + 3, &e);
+      uint32_t order = (uint32_t)strtoul(e, NULL, 10);
+      if (order == 0) order = 2;
+      st = fmac_design_iir_lowpass(&d, fmac_rt_fs_hz(), fc, (uint8_t)order);
+    } else if (strncmp(p, "notch", 5) == 0) {
+      float f0 = strtof(p + 5, &e);
+      float q = strtof(e, NULL);
+      if (q <= 0.0f) q = 5.0f;
+      st = fmac_design_notch(&d, fmac_rt_fs_hz(), f0, q);
+    } else {
+      have = 0;   /* 只显示当前滤波器 */
+    }
+
+    if (have) {
+      if (st < 0) {
+        LOGW("fmacset: %s", fmac_design_status_str(st));
+        return;
+      }
+      if (st != FMAC_DESIGN_OK) {
+        LOGW("fmacset: %s", fmac_design_status_str(st));
+      }
+      if (fmac_rt_load_design(&d) != 0) {
+        LOGW("fmacset: FMAC busy (adcstop / fmacmc stop)");
+        return;
+      }
+    }
+
+    const fmac_design_t *cur = fmac_rt_get_design();
+    LOGI("── fmac_rt filter: %s P=%u Q=%u R=%u  dc_gain=%.4f  delay=%.2f samples ──",
+         (cur->kind == FMAC_DESIGN_IIR) ? "IIR-DF1" : "FIR",
+         (unsigned)cur->nb, (unsigned)cur->na, (unsigned)cur->r,
+         (double)fmac_design_dc_gain(cur), (double)fmac_design_group_delay(cur));
+    for (uint32_t i = 0; i < cur->nb; i++) {
+      LOGI("  b[%2lu] = %6d", (unsigned long)i, (int)cur->b[i]);
+    }
+    for (uint32_t i = 0; i < cur->na; i++) {
+      LOGI("  a[%2lu] = %6d", (unsigned long)(i + 1U), (int)cur->a[i]);
+    }
     return;
   }
-  if (strncmp(cmd, "cordicv", 7) == 0 && (cmd[7] == 0 || cmd[7] == ' ')) {
-    uint32_t n = 5000;
-    char *p = cmd + 7;          // <-- 正确：跳过 "cordicv"
 
-    while (*p == ' ') p++;      // 跳过空格
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-    if (n == 0) n = 5000;
+  if (strncmp(cmd, "fmacmc", 6) == 0 && (cmd[6] == 0 || cmd[6] == ' ')) {
+    static const char *const ch_name[FMAC_MC_CH_COUNT] = { "ia", "ib", "vbus" };
+    char *p = cmd + 6;
+    while (*p == ' ') p++;
 
-    uint32_t hw = bench_cordic_vec(n);
-    LOGI("cordicv n=%lu hw=%lu cyc (one-call)",
-         (unsigned long)n, (unsigned long)hw);
+    if (strcmp(p, "start") == 0) {
+      fmac_mc_start();
+      LOGI("fmacmc started (%u channels, ADC1_2 IRQ)", (unsigned)FMAC_MC_CH_COUNT);
+      return;
+    }
+    if (strcmp(p, "stop") == 0) {
+      fmac_mc_stop();
+      LOGI("fmacmc stopped after %lu runs", (unsigned long)fmac_mc_runs);
+      return;
+    }
+    if (strncmp(p, "verify", 6) == 0) {
+      uint32_t n = (uint32_t)strtoul(p + 6, NULL, 10);
+      if (n == 0) n = 2000;
+      /* fmac_mc 停着时 ISR 不写这个 stage, 前后差就是 verify 自己的 n 次 */
+      const hf_prof_stat_t *ps = &hf_prof.stage[HF_PROF_FMAC_MC];
+      uint32_t cnt0 = ps->count;
+      uint64_t sum0 = ps->sum;
+      int16_t max_abs = 0;
+      fmac_mc_cost_t cpu;
+      int32_t bad = fmac_mc_verify(n, &max_abs, &cpu);
+      if (bad < 0) {
+        LOGW("fmacmc verify: FMAC busy (fmacmc stop / adcstop)");
+        return;
+      }
+      LOGI("fmacmc verify n=%lu x %u ch mismatch=%ld max_abs_diff=%d %s",
+           (unsigned long)n, (unsigned)FMAC_MC_CH_COUNT, (long)bad, (int)max_abs,
+           (bad == 0) ? "BIT-EXACT" : "");
+      if (ps->count != cnt0) {
+        LOGI("  fmac_mc_run: avg %lu cyc, max %lu cyc (hfprof fmac_mc)",
+             (unsigned long)((ps->sum - sum0) / (ps->count - cnt0)), (unsigned long)ps->max);
+      }
+      LOGI("  cpu fir (smlad, same taps): avg %lu cyc, max %lu cyc, max |cpu-fmac|=%d",
+           (unsigned long)cpu.cpu_avg, (unsigned long)cpu.cpu_max, (int)cpu.cpu_max_diff);
+      return;
+    }
+
+    LOGI("── fmacmc %s runs=%lu ──", fmac_mc_is_active() ? "on" : "off",
+         (unsigned long)fmac_mc_runs);
+    LOGI("  ch        raw    filt");
+    for (uint32_t k = 0; k < FMAC_MC_CH_COUNT; k++) {
+      LOGI("  %-5s  %6d  %6d", ch_name[k], (int)fmac_mc_in[k], (int)fmac_mc_out[k]);
+    }
     return;
   }
 
-  if (strncmp(cmd, "cordicbd", 8) == 0 && (cmd[8] == 0 || isspace((unsigned char)cmd[8]))) {
-    uint32_t n = 1000;
-    char *p = cmd + 8;
-    while (*p && isspace((unsigned char)*p)) p++;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-    if (n == 0) n = 1000;
-
-    uint32_t pack=0, hw=0, unpack=0;
-    bench_cordic_reg_breakdown(n, &pack, &hw, &unpack);
-
-    uint32_t total = pack + hw + unpack;
-    LOGI("── cordicbd n=%lu ──", (unsigned long)n);
-    LOGI("  pack   (float->q31): %7lu cyc  (%lu/call)", (unsigned long)pack,   (unsigned long)(pack/n));
-    LOGI("  hw     (WDATA/RDATA): %7lu cyc  (%lu/call)", (unsigned long)hw,     (unsigned long)(hw/n));
-    LOGI("  unpack (q31->float): %7lu cyc  (%lu/call)", (unsigned long)unpack, (unsigned long)(unpack/n));
-    LOGI("  total             : %7lu cyc  (%lu/call)", (unsigned long)total,  (unsigned long)(total/n));
+  if (strncmp(cmd, "hfprof", 6) == 0 && (cmd[6] == 0 || cmd[6] == ' ')) {
+    static const char *const stage_name[HF_PROF_STAGE_COUNT] = {
+      "rcm_read", "rcm_exec", "curr_ctrl", "sto_pll", "mcpa_log", "fmac_feed", "fmac_mc",
+      "hf_m1", "hf_m2", "curr_ctrl2", "sto_pll2", "isr_total"
+    };
+    char *p = cmd + 6;
+    while (*p == ' ') p++;
+
+    if (strcmp(p, "reset") == 0) {
+      hf_prof_request_reset();   /* 下一次 ADC 中断里清零 */
+      LOGI("hfprof reset requested");
+      return;
+    }
+
+    static hf_prof_t snap;       /* 太大, 不放栈上 */
+    hf_prof_snapshot(&snap);
+    uint32_t mhz = SystemCoreClock / 1000000u;
+    uint32_t budget = hf_prof_budget_cycles();
+
+    if (strcmp(p, "hist") == 0) {
+      LOGI("── hfprof hist (bin k: [2^(k-1), 2^k) cyc) ──");
+      for (uint32_t s = 0; s < HF_PROF_STAGE_COUNT; s++) {
+        const hf_prof_stat_t *st = &snap.stage[s];
+        if (st->count == 0) continue;
+        LOGI("  %s:", stage_name[s]);
+        for (uint32_t k = 0; k < HF_PROF_HIST_BINS; k++) {
+          if (st->hist[k] == 0) continue;
+          uint32_t lo = (k == 0) ? 0 : (1u << (k - 1));
+          uint32_t pct_x10 = (uint32_t)((uint64_t)st->hist[k] * 1000u / st->count);
+          LOGI("    >=%5lu cyc : %9lu  %3lu.%lu%%", (unsigned long)lo,
+               (unsigned long)st->hist[k],
+               (unsigned long)(pct_x10 / 10), (unsigned long)(pct_x10 % 10));
+        }
+      }
+      return;
+    }
+
+    LOGI("── hfprof (budget %lu cyc = %lu us/PWM) ──",
+         (unsigned long)budget, (unsigned long)(budget / mhz));
+    LOGI("  stage              n    min    avg    max  avg_us  max%%");
+    for (uint32_t s = 0; s < HF_PROF_STAGE_COUNT; s++) {
+      const hf_prof_stat_t *st = &snap.stage[s];
+      if (st->count == 0) {
+        LOGI("  %-10s %9lu      -      -      -       -     -", stage_name[s], 0UL);
+        continue;
+      }
+      uint32_t avg = (uint32_t)(st->sum / st->count);
+      uint32_t avg_ns = avg * 1000u / mhz;
+      LOGI("  %-10s %9lu %6lu %6lu %6lu  %2lu.%03lu  %3lu",
+           stage_name[s], (unsigned long)st->count,
+           (unsigned long)st->min, (unsigned long)avg, (unsigned long)st->max,
+           (unsigned long)(avg_ns / 1000), (unsigned long)(avg_ns % 1000),
+           (unsigned long)(st->max * 100u / budget));
+    }
+    /* 每电机 CPU 占用 = HF 任务平均周期 / PWM 预算; 双电机时 ADC 中断每个 PWM 周期进两次 */
+    uint32_t isr_per_pwm = 0;
+    for (uint32_t m = 0; m < HF_PROF_MOTORS; m++) {
+      const hf_prof_stat_t *st = &snap.stage[HF_PROF_HF_M1 + m];
+      const hf_prof_margin_t *mg = &snap.margin[m];
+      if ((st->count == 0) && (mg->count == 0) && (mg->duration_faults == 0)) continue;
+      isr_per_pwm++;
+      uint32_t load_x10 = (st->count == 0) ? 0u
+                          : (uint32_t)((st->sum / st->count) * 1000u / budget);
+      LOGI("  M%lu load: %lu.%lu%% (avg hf_m%lu / budget), MC_DURATION hits: %lu",
+           (unsigned long)(m + 1), (unsigned long)(load_x10 / 10), (unsigned long)(load_x10 % 10),
+           (unsigned long)(m + 1), (unsigned long)mg->duration_faults);
+      if (mg->count != 0) {
+        LOGI("  M%lu MC_DURATION margin: min=%lu avg=%lu max=%lu cyc (min %lu us)",
+             (unsigned long)(m + 1),
+             (unsigned long)mg->min,
+             (unsigned long)(mg->sum / mg->count),
+             (unsigned long)mg->max,
+             (unsigned long)(mg->min / mhz));
+      }
+    }
+    if (snap.stage[HF_PROF_ISR_TOTAL].count != 0) {
+      const hf_prof_stat_t *st = &snap.stage[HF_PROF_ISR_TOTAL];
+      uint32_t load_x10 = (uint32_t)((st->sum / st->count) * 1000u * ((isr_per_pwm != 0) ? isr_per_pwm : 1u)
+                                     / budget);
+      LOGI("  ADC ISR load: %lu.%lu%% of one PWM period",
+           (unsigned long)(load_x10 / 10), (unsigned long)(load_x10 % 10));
+    }
     return;
   }
 
-  if (strncmp(cmd, "cordicr", 7) == 0 && (cmd[7] == 0 || cmd[7] == ' ')) {
-    uint32_t n = 1000;
-    char *p = cmd + 7;
+  if (strncmp(cmd, "gov", 3) == 0 && (cmd[3] == 0 || cmd[3] == ' ')) {
+    static const char *const mode_name[] = { "off", "auto", "fix" };
+    char *p = cmd + 3;
     while (*p == ' ') p++;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-    if (n == 0) n = 1000;
-
-    uint32_t soft = bench_soft_sincos(n);
-    uint32_t hal  = bench_cordic_sincos(n);
-    uint32_t reg  = bench_cordic_sincos_reg(n);
-    uint32_t pure = bench_cordic_pure_reg(n);
-
-    LOGI("── cordicr n=%lu ──", (unsigned long)n);
-    LOGI("  sinf+cosf  : %7lu cyc  (%lu/call)",
-         (unsigned long)soft, (unsigned long)(soft/n));
-    LOGI("  CORDIC HAL : %7lu cyc  (%lu/call)",
-         (unsigned long)hal, (unsigned long)(hal/n));
-    LOGI("  CORDIC REG : %7lu cyc  (%lu/call)",
-         (unsigned long)reg, (unsigned long)(reg/n));
-    LOGI("  CORDIC PURE: %7lu cyc  (%lu/call)  [no float conv]",
-         (unsigned long)pure, (unsigned long)(pure/n));
-    LOGI("  speedup REG vs soft : %lu.%02lux",
-         (unsigned long)(soft*100/reg/100), (unsigned long)(soft*100/reg%100));
-    LOGI("  speedup PURE vs soft: %lu.%02lux",
-         (unsigned long)(soft*100/pure/100), (unsigned long)(soft*100/pure%100));
+
+    if (strcmp(p, "off") == 0) {
+      pwm_gov_set_mode(PWM_GOV_OFF, 0U);
+    } else if (strcmp(p, "auto") == 0) {
+      pwm_gov_set_mode(PWM_GOV_AUTO, 0U);
+    } else if (strncmp(p, "fix", 3) == 0) {
+      uint32_t n = (uint32_t)strtoul(p + 3, NULL, 10);
+      if (n >= PWM_GOV_PROFILES) {
+        LOGW("gov fix: profile 0..%u", (unsigned)(PWM_GOV_PROFILES - 1U));
+        return;
+      }
+      pwm_gov_set_mode(PWM_GOV_FIXED, (uint8_t)n);
+    } else if (*p != 0) {
+      LOGW("gov: off|auto|fix <n>");
+      return;
+    }
+#if !PWM_GOV_ENABLE
+    LOGW("gov: not built (NBR_OF_MOTORS > 1)");
+#endif
+
+    pwm_gov_status_t st;
+    pwm_gov_get_status(&st);
+    LOGI("── gov %s, P%u active, floor P%u, %lu switches%s ──", mode_name[st.mode],
+         (unsigned)st.active, (unsigned)st.floor, (unsigned long)st.switches,
+         (st.locks != 0U) ? ", locked (fmac)" : "");
+    LOGI("  hf max %lu cyc (%lu%% of P%u budget), peak %lu cyc",
+         (unsigned long)st.hf_max, (unsigned long)st.load_pct, (unsigned)st.active,
+         (unsigned long)st.hf_peak);
+    LOGI("  P  pwm_hz  foc_hz   arr rcr  budget  load%%");
+    for (uint32_t i = 0; i < PWM_GOV_PROFILES; i++) {
+      const pwm_gov_profile_t *pf = &pwm_gov_profiles[i];
+      uint32_t budget = pwm_gov_budget_cycles((uint8_t)i);
+      LOGI("%c%lu %7lu %7lu %5u %3u %7lu %5lu", (i == st.active) ? '*' : ' ',
+           (unsigned long)i, (unsigned long)pf->pwm_hz, (unsigned long)pf->rate_hz,
+           (unsigned)(pf->period / 2U), (unsigned)pf->rep, (unsigned long)budget,
+           (unsigned long)(st.hf_max * 100u / budget));
+    }
     return;
   }
 
-  if (strncmp(cmd, "cordiccmp", 9) == 0 && (cmd[9] == 0 || cmd[9] == ' ')) {
-    uint32_t n = 5000;
-    char *p = cmd + 9;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-    if (n == 0) n = 5000;   // 防止 n 被解析成0
+  if (strcmp(cmd, "uartstat") == 0) {
+    bsp_uart_stats_t s;
+    bsp_uart_get_stats(&s);
+    LOGI("── uart tx (ring %u B, DMA1 Ch2) ──", (unsigned)BSP_UART_TX_RING);
+    LOGI("  queued=%lu sent=%lu pending=%lu",
+         (unsigned long)s.queued, (unsigned long)s.sent, (unsigned long)bsp_uart_tx_pending());
+    LOGI("  dropped=%lu B in %lu writes, max_used=%lu, segments=%lu, dma_err=%lu",
+         (unsigned long)s.dropped, (unsigned long)s.overflows, (unsigned long)s.max_used,
+         (unsigned long)s.dma_segments, (unsigned long)s.dma_errors);
+    LOGI("── uart rx (dma %u B circular, ring %u B, DMA1 Ch1) ──",
+         (unsigned)BSP_UART_RX_DMA, (unsigned)BSP_UART_RX_RING);
+    LOGI("  bytes=%lu dropped=%lu events=%lu errors=%lu",
+         (unsigned long)s.rx_bytes, (unsigned long)s.rx_dropped,
+         (unsigned long)s.rx_events, (unsigned long)s.rx_errors);
+    return;
+  }
+
+  if (strncmp(cmd, "blog", 4) == 0 && (cmd[4] == 0 || cmd[4] == ' ')) {
+    char *p = cmd + 4;
     while (*p == ' ') p++;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-    if (n == 0) n = 5000;
-
-    uint32_t soft = bench_soft_vec(n);
-    uint32_t hw   = bench_cordic_vec(n);
-
-    uint32_t sp_x10 = (hw == 0) ? 0 : (soft * 10u / hw);
-    LOGI("cordiccmp n=%lu soft=%lu cyc hw=%lu cyc speedup=%lu.%lux",
-         (unsigned long)n,
-         (unsigned long)soft,
-         (unsigned long)hw,
-         (unsigned long)(sp_x10/10),
-         (unsigned long)(sp_x10%10));
+
+    if (strcmp(p, "reset") == 0) {
+      blog_reset();
+      LOGI("blog counters cleared");
+      return;
+    }
+    if (strcmp(p, "test") == 0) {
+      /* 每种参数类型各来一条, 配合 blog_decode 检查还原结果 */
+      uint32_t t0 = DWT->CYCCNT;
+      BLOGI("blog test: no args");
+      uint32_t t1 = DWT->CYCCNT;
+      BLOGW("blog test: int=%d uint=%u hex=0x%08lx", -42, 42U, 0xC0FFEEUL);
+      BLOGE("blog test: float=%.3f str=%s", 3.14159f, "flash-const");
+      LOGI("blog test queued, BLOGI cost %lu cyc", (unsigned long)(t1 - t0));
+      return;
+    }
+
+    blog_stats_t st;
+    blog_get_stats(&st);
+    LOGI("── blog (ring %u words) ──", (unsigned)BLOG_RING_WORDS);
+    LOGI("  written=%lu dropped=%lu max_used=%lu words",
+         (unsigned long)st.written, (unsigned long)st.dropped, (unsigned long)st.max_used);
     return;
   }
 
-  if (strncmp(cmd, "cordic", 6) == 0 && (cmd[6] == 0 || cmd[6] == ' ')) {
-    uint32_t n = 5000;
-    char *p = cmd + 6;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-    if (n == 0) n = 5000;   // 防止 n 被解析成0
+  if (strncmp(cmd, "cap", 3) == 0 && (cmd[3] == 0 || cmd[3] == ' ')) {
+    char *p = cmd + 3;
     while (*p == ' ') p++;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-
-    uint32_t soft = bench_soft_sincos(n);
-    uint32_t hw   = bench_cordic_sincos(n);
-
-    // speedup = soft/hw (简单整数比)
-    uint32_t sp_x10 = (hw == 0) ? 0 : (soft * 10u / hw);
-    LOGI("cordic n=%lu soft=%lu cyc hw=%lu cyc speedup=%lu.%lux",
-         (unsigned long)n,
-         (unsigned long)soft,
-         (unsigned long)hw,
-         (unsigned long)(sp_x10/10),
-         (unsigned long)(sp_x10%10));
+
+    if (strncmp(p, "start", 5) == 0) {
+      char *e;
+      uint32_t n = (uint32_t)strtoul(p + 5, &e, 10);
+      while (*e == ' ') e++;
+      uint8_t stream = (strcmp(e, "stream") == 0) ? 1U : 0U;
+      /* 新 trace 的起点, obs_replay 在这里切段并取采样率 */
+      log_printf("#OS:%lu\r\n", (unsigned long)pwm_gov_rate_hz());
+      obs_cap_start(n, stream);
+      LOGI("cap started: %s, %lu records at %lu Hz", stream ? "stream" : "ram",
+           (unsigned long)((n != 0U) ? n : (stream ? 0U : OBS_CAP_RECORDS)),
+           (unsigned long)pwm_gov_rate_hz());
+      return;
+    }
+    if (strcmp(p, "stop") == 0) {
+      obs_cap_stop();
+      LOGI("cap stopped");
+      return;
+    }
+
+    obs_cap_stats_t st;
+    obs_cap_get_stats(&st);
+    LOGI("── cap (%s, ring %u records) %s ──", st.stream ? "stream" : "ram",
+         (unsigned)OBS_CAP_RECORDS, st.armed ? "recording" : "idle");
+    LOGI("  written=%lu dropped=%lu gaps=%lu max_used=%lu",
+         (unsigned long)st.written, (unsigned long)st.dropped,
+         (unsigned long)st.gaps, (unsigned long)st.max_used);
     return;
   }
-  if (strncmp(cmd, "fmacdbg", 7) == 0 && (cmd[7] == 0 || cmd[7] == ' ')) {
-    /* 诊断命令: 用已知输入打印 soft 和 hw 的实际值 */
-    /* FMAC 有 1 个样本的 pipeline 延迟: hw[0] 是 preload 零输出, 真实结果从 hw[1] 开始 */
-    uint32_t n = 64;
 
-    /* 简单输入: 全部设为 1000 (已知值, 好算) */
-    for (uint32_t i = 0; i < n; i++) g_x[i] = 1000;
+  if (strncmp(cmd, "stack", 5) == 0 && (cmd[5] == 0 || cmd[5] == ' ')) {
+    char *p = cmd + 5;
+    while (*p == ' ') p++;
 
-    bench_soft_fir(n);
-    bench_fmac_fir(n);
+    if (strcmp(p, "reset") == 0) {
+      stack_mon_reset();
+      LOGI("stack repainted below SP, ISR stats cleared");
+      return;
+    }
 
-    LOGI("── fmacdbg (input=1000 const, 32-tap MA) ──");
-    LOGI("  hw[0] is pipeline zero, real data starts at hw[1]");
-    LOGI("  idx  soft   hw[i+1]  diff");
-    for (uint32_t i = 0; i < 36 && i < n; i++) {
-      int16_t d = g_y_hw[i + 1] - g_y_soft[i];
-      LOGI("  [%2lu] %6d  %6d  %6d", (unsigned long)i,
-           (int)g_y_soft[i], (int)g_y_hw[i + 1], (int)d);
+    stack_mon_report_t r;
+    stack_mon_get(&r);
+    const uint32_t isr_used = r.top - r.isr.min_sp;
+    LOGI("── stack MSP 0x%08lx..0x%08lx (painted %lu B) ──",
+         (unsigned long)r.bottom, (unsigned long)r.top, (unsigned long)r.painted);
+    LOGI("  peak %lu B, now %lu B, _Min_Stack_Size %lu B",
+         (unsigned long)r.peak, (unsigned long)r.now, (unsigned long)r.reserve);
+    /* 余量为负: 峰值已经超出预留, 踩进了堆预留之上的空闲 RAM */
+    LOGI("  headroom: %ld B vs _Min_Stack_Size, %ld B vs painted area",
+         (long)r.reserve - (long)r.peak, (long)r.painted - (long)r.peak);
+    /* exc = IPSR: 15 SysTick, 16 + IRQn (ADC1_2 34, TIM1_UP 41, USART2 54) */
+    LOGI("  isr: %lu probes, max nesting %u (exc %u), deepest entry SP %lu B below _estack (exc %u)",
+         (unsigned long)r.isr.probes, (unsigned)r.isr.max_depth, (unsigned)r.isr.max_depth_exc,
+         (unsigned long)isr_used, (unsigned)r.isr.min_sp_exc);
+    if (r.peak >= r.painted) {
+      LOGW("stack: paint fully overwritten, overflow into heap/.bss possible");
     }
+    return;
+  }
 
-    /* 再测一个: 脉冲输入 */
-    memset(g_x, 0, sizeof(int16_t) * n);
-    g_x[0] = 16384;  /* 半量程脉冲 */
+  if (strncmp(cmd, "frec", 4) == 0 && (cmd[4] == 0 || cmd[4] == ' ')) {
+    char *p = cmd + 4;
+    while (*p == ' ') p++;
 
-    bench_soft_fir(n);
-    bench_fmac_fir(n);
+    if (strcmp(p, "clear") == 0) {
+      fault_rec_arm();
+      LOGI("frec: window dropped, recording");
+      return;
+    }
+
+    fault_rec_status_t st;
+    fault_rec_get_status(&st);
+    if (strcmp(p, "dump") == 0) {
+      if (st.frozen == 0U) {
+        LOGW("frec: nothing frozen");
+        return;
+      }
+      /* log_poll 接着发 "#FH:" 和 st.count 条 "#F:" */
+      fault_rec_dump_start();
+      LOGI("frec: dumping %lu records", (unsigned long)st.count);
+      return;
+    }
 
-    LOGI("── fmacdbg (impulse x[0]=16384) ──");
-    LOGI("  idx  soft   hw[i+1]  diff");
-    for (uint32_t i = 0; i < 36 && i < n; i++) {
-      int16_t d = g_y_hw[i + 1] - g_y_soft[i];
-      LOGI("  [%2lu] %6d  %6d  %6d", (unsigned long)i,
-           (int)g_y_soft[i], (int)g_y_hw[i + 1], (int)d);
+    LOGI("── frec (ring %u records x %u B) %s ──", (unsigned)FAULT_REC_RECORDS,
+         (unsigned)sizeof(fault_rec_rec_t), st.armed ? "recording" : (st.frozen ? "frozen" : "off"));
+    if (st.frozen != 0U) {
+      LOGI("  M%u faults=0x%04x state=%u src=%s, %lu records (of %lu written), %u resets since",
+           (unsigned)(st.hdr.motor + 1U), (unsigned)st.hdr.faults, (unsigned)st.hdr.state,
+           (st.hdr.source == FAULT_REC_SRC_BRK) ? "brk" : "mci", (unsigned long)st.count,
+           (unsigned long)st.hdr.written, (unsigned)st.hdr.boots);
+    } else {
+      LOGI("  %lu records in window", (unsigned long)st.count);
     }
     return;
   }
 
-  if (strncmp(cmd, "fmaccmp", 7) == 0 && (cmd[7] == 0 || cmd[7] == ' ')) {
-    uint32_t n = 1000;
-    char *p = cmd + 7;
+  if (strncmp(cmd, "cbatch", 6) == 0 && (cmd[6] == 0 || cmd[6] == ' ')) {
+    char *p = cmd + 6;
     while (*p == ' ') p++;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-    if (n == 0) n = 1000;
-    if (n > (FMAC_INPUT_N - 1)) n = FMAC_INPUT_N - 1;
-
-    gen_input(n);
-
-    uint32_t soft = bench_soft_fir(n);
-    uint32_t hw   = bench_fmac_fir(n);
-    uint32_t diff = 0;
-    int16_t max_abs = 0;
-
-    /* FMAC pipeline 延迟 1 样本: g_y_hw[1..n] 对应 g_y_soft[0..n-1]
-     * 最后 ~FMAC_TAPS 个样本可能卡在 Y buffer 里输出为零, 跳过这些 */
-    uint32_t valid = (n > FMAC_TAPS) ? (n - FMAC_TAPS) : 0;
-    for (uint32_t i = 0; i < valid; i++) {
-      int16_t d = g_y_hw[i + 1] - g_y_soft[i];
-      if (d < 0) d = -d;
-      if (d != 0) diff++;
-      if (d > max_abs) max_abs = d;
-    }
-
-    // speedup 用浮点只是打印，不参与滤波
-    float sp = (hw == 0 || hw == 0xFFFFFFFFu) ? 0.0f : ((float)soft / (float)hw);
-
-    LOGI("fmaccmp n=%lu soft=%lu cyc hw=%lu cyc speedup=%.2fx",
-         (unsigned long)n,
-         (unsigned long)soft,
-         (unsigned long)hw,
-         (double)sp);
-    LOGI("  compared=%lu/%lu  diff_count=%lu  max_abs_diff=%d",
-         (unsigned long)valid, (unsigned long)n,
-         (unsigned long)diff, (int)max_abs);
+    const uint32_t mhz = SystemCoreClock / 1000000U;
+
+    if (strcmp(p, "abort") == 0) {
+      cordic_batch_abort();
+      LOGI("cbatch: aborted");
+      return;
+    }
+    if (strncmp(p, "bench", 5) == 0 && (p[5] == 0 || p[5] == ' ')) {
+      /* 同一组角度, 同一个 CSR: CPU 逐个 WDATA/RDATA vs DMA 从 start 到回调 */
+      static const char *const names[2] = { "vec_pure", "vec_dma" };
+      uint32_t x100[2] = { 0U, 0U };
+      bench_opt_t opt;
+      bench_opt_default(&opt);
+      opt.n = (uint32_t)strtoul(p + 5, NULL, 10);
+      LOGI("── cbatch bench (median of %lu, irq on) ──", (unsigned long)opt.reps);
+      for (uint32_t i = 0; i < 2U; i++) {
+        const bench_case_t *c = bench_find(names[i]);
+        bench_result_t res;
+        bench_run(c, &opt, &res);
+        if ((res.status < 0) || (res.median == 0U)) {
+          LOGW("cbatch: %s skipped (batch busy?)", names[i]);
+          return;
+        }
+        x100[i] = (uint32_t)(((uint64_t)res.n * mhz * 100U) / res.median);
+        LOGI("  %-8s n=%-5lu %7lu cycles  %lu.%02lu el/us  err=%ld", names[i], (unsigned long)res.n,
+             (unsigned long)res.median, (unsigned long)(x100[i] / 100U), (unsigned long)(x100[i] % 100U),
+             (long)res.err);
+      }
+      const uint32_t ratio = (x100[0] != 0U) ? ((x100[1] * 100U) / x100[0]) : 0U;
+      LOGI("  dma / pure: %lu.%02lu x", (unsigned long)(ratio / 100U), (unsigned long)(ratio % 100U));
+      return;
+    }
+
+    cordic_batch_stats_t st;
+    cordic_batch_get_stats(&st);
+    LOGI("── cbatch (DMA2 ch1/ch2) %s ──", cordic_batch_busy() ? "busy" : "idle");
+    LOGI("  jobs %lu, elements %lu, pauses %lu, aborts %lu, dma errors %lu",
+         (unsigned long)st.jobs, (unsigned long)st.elements, (unsigned long)st.pauses,
+         (unsigned long)st.aborts, (unsigned long)st.errors);
+    if (st.last_cycles != 0U) {
+      const uint32_t x100 = (uint32_t)(((uint64_t)st.last_n * mhz * 100U) / st.last_cycles);
+      LOGI("  last job: %lu el in %lu cycles, %lu.%02lu el/us", (unsigned long)st.last_n,
+           (unsigned long)st.last_cycles, (unsigned long)(x100 / 100U), (unsigned long)(x100 % 100U));
+    }
     return;
   }
 
-  if (strncmp(cmd, "bench", 5) == 0) {
-    uint32_t n = 10000;
-    char *p = cmd + 5;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
-    if (n == 0) n = 5000;   // 防止 n 被解析成0
+  if (strcmp(cmd, "tick") == 0) {
+    LOGI("tick=%lu", (unsigned long)HAL_GetTick());
+    return;
+  }
 
+  if (strncmp(cmd, "bench", 5) == 0 && (cmd[5] == 0 || cmd[5] == ' ')) {
+    char *p = cmd + 5;
     while (*p == ' ') p++;
-    if (*p) n = (uint32_t)strtoul(p, NULL, 10);
 
-    uint32_t cyc = bench_loop_cycles(n);
-    LOGI("bench n=%lu cycles=%lu", (unsigned long)n, (unsigned long)cyc);
+    if (*p == 0 || strcmp(p, "list") == 0) {
+      LOGI("── bench cases ──");
+      for (uint32_t i = 0; i < bench_count(); i++) {
+        const bench_case_t *c = bench_get(i);
+        LOGI("  %-12s n=%-6lu %s", c->name, (unsigned long)c->n_default, c->desc);
+      }
+      return;
+    }
+    if (strncmp(p, "run", 3) != 0 || (p[3] != 0 && p[3] != ' ')) {
+      LOGW("usage: bench list | bench run <name|all> [n=] [reps=] [warm=] [mask] [json]");
+      return;
+    }
+    p += 3;
+
+    /* 解析: 第一个词是名字, 之后 key=value 或开关 */
+    bench_opt_t opt;
+    bench_opt_default(&opt);
+    const char *name = NULL;
+    char *tok = strtok(p, " ");
+    while (tok != NULL) {
+      if (strncmp(tok, "n=", 2) == 0) {
+        opt.n = (uint32_t)strtoul(tok + 2, NULL, 10);
+      } else if (strncmp(tok, "reps=", 5) == 0) {
+        opt.reps = (uint32_t)strtoul(tok + 5, NULL, 10);
+      } else if (strncmp(tok, "warm=", 5) == 0) {
+        opt.warmup = (uint32_t)strtoul(tok + 5, NULL, 10);
+      } else if (strcmp(tok, "mask") == 0) {
+        opt.irq_masked = 1U;
+      } else if (strcmp(tok, "json") == 0) {
+        opt.fmt = BENCH_FMT_JSON;
+      } else if (name == NULL) {
+        name = tok;
+      } else {
+        LOGW("bench: unknown option %s", tok);
+        return;
+      }
+      tok = strtok(NULL, " ");
+    }
+    if (name == NULL) name = "all";
+
+    const bench_case_t *one = NULL;
+    if (strcmp(name, "all") != 0) {
+      one = bench_find(name);
+      if (one == NULL) {
+        LOGW("bench: no case '%s' (bench list)", name);
+        return;
+      }
+    }
+
+    bench_result_t res;
+    bench_print_header(&opt);
+    for (uint32_t i = 0; i < bench_count(); i++) {
+      const bench_case_t *c = (one != NULL) ? one : bench_get(i);
+      bench_run(c, &opt, &res);
+      if ((opt.irq_masked != 0U) && (res.irq_masked == 0U) && (res.status == 0)) {
+        LOGW("bench %s: motor running, measured with IRQs enabled", c->name);
+      }
+      bench_print(c, &opt, &res);
+      if (one != NULL) break;
+    }
     return;
   }
 
@@ -795,3 +722,21 @@ void cli_poll(void)
 
   exec_cmd(local);
 }
+
+void cli_on_rx(const uint8_t *data, size_t len)
+{
+  size_t start = 0;
+
+  for (size_t i = 0; i < len; i++) {
+    cli_on_rx_byte(data[i]);
+    if (line_ready) {
+      /* 先回显到行尾, 再执行, 输出顺序和逐字敲入时一样 */
+      (void)bsp_uart_write(&data[start], i + 1U - start);
+      start = i + 1U;
+      cli_poll();
+    }
+  }
+  if (start < len) {
+    (void)bsp_uart_write(&data[start], len - start);
+  }
+}
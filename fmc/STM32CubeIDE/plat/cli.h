@@ -9,10 +9,14 @@
 #define CLI_H_
 #pragma once
 #include <stdint.h>
+#include <stddef.h>
 
 void cli_init(void);
 void cli_poll(void);                 // 主循环里反复调用
 void cli_on_rx_byte(uint8_t b);       // 在UART RX回调里调用
+// 主循环批量喂入 (bsp_uart_read 的结果): 回显, 每凑满一行就地执行,
+// 粘贴的多行命令逐行跑, 不会被拼到同一行
+void cli_on_rx(const uint8_t *data, size_t len);
 
 
 
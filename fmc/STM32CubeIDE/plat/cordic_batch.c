@@ -0,0 +1,305 @@
+/*
+ * cordic_batch.c  - CORDIC 后台批处理 (见 cordic_batch.h)
+ *
+ * Architecture:
+ *   cordic_batch_start()  -> resume(): 两个 DMA 通道装 [next, n), CSR 开 DMAREN/DMAWEN
+ *   claim (第一个)        -> pause():  停 DMA, 在 CORDIC 里的元素读完, next 前移
+ *   release (最后一个)    -> resume(): 从 next 接着跑; next == n 就挂起中断收尾
+ *   DMA2 Ch2 TC / TE      -> cordic_batch_dma_irq() -> 统计, job.done()
+ *
+ * 元素边界: 每元素写 nargs 个字, 读 nres 个字 (16 位格式各 1 个字).
+ * CORDIC 只有一组结果寄存器, DMA 写下一个元素前一定读完了上一个, 所以暂停时
+ * 最多一个元素在 CORDIC 里. 它的参数只写了一半时, 由 pause() 补写第二个参数,
+ * 不靠改写 CSR 会不会清掉半个参数.
+ *
+ * ARG2: 32 位单参数时 CORDIC 沿用上一次写进的 ARG2 (MCM_PhaseComputation 留下
+ * 的是 Bemf beta). cos/sin/phase/modulus 的 job 在每次 resume() 先把 ARG2 写回
+ * 复位值 1, 结果不依赖中间跑过哪个 CPU 用户.
+ *
+ * pause/resume 总是在关中断或 HF 中断里调用; 完成中断优先级最低, 只在关中断
+ * 时改状态, 回调在开中断后调用.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "cordic_batch.h"
+#include "main.h"
+#include "stm32g4xx_ll_bus.h"
+#include "stm32g4xx_ll_cordic.h"
+#include "stm32g4xx_ll_dma.h"
+#include <stddef.h>
+
+#define CB_DMA          DMA2
+#define CB_DMA_WR_CH    LL_DMA_CHANNEL_1   /* CORDIC_WRITE: job.in  -> CORDIC->WDATA */
+#define CB_DMA_RD_CH    LL_DMA_CHANNEL_2   /* CORDIC_READ:  CORDIC->RDATA -> job.out */
+
+#define CB_CSR_DMA      (CORDIC_CSR_DMAREN | CORDIC_CSR_DMAWEN | CORDIC_CSR_IEN)
+
+volatile cordic_batch_state_t cordic_batch_state = CORDIC_BATCH_IDLE;
+volatile uint8_t cordic_batch_claims = 0U;
+
+static cordic_batch_job_t job;
+static uint32_t nargs;                    /* 每元素写几个字 */
+static uint32_t nres;                     /* 每元素读几个字 */
+static uint32_t next;                     /* 当前这段 DMA 从哪个元素开始 */
+static uint32_t seg_n;                    /* 当前这段的元素数 */
+static bool seed_arg2;                    /* resume() 前把 ARG2 写回 1 */
+static uint32_t t_start;
+static cordic_batch_stats_t stats;
+
+static uint32_t words_in(uint32_t csr)
+{
+  if ((csr & CORDIC_CSR_ARGSIZE) != 0U) {
+    return 1U;
+  }
+  return ((csr & CORDIC_CSR_NARGS) != 0U) ? 2U : 1U;
+}
+
+static uint32_t words_out(uint32_t csr)
+{
+  if ((csr & CORDIC_CSR_RESSIZE) != 0U) {
+    return 1U;
+  }
+  return ((csr & CORDIC_CSR_NRES) != 0U) ? 2U : 1U;
+}
+
+/* 32 位单参数且函数用到 ARG2 (模长 / y) */
+static bool uses_arg2(uint32_t csr)
+{
+  const uint32_t func = csr & CORDIC_CSR_FUNC;
+  return ((csr & (CORDIC_CSR_ARGSIZE | CORDIC_CSR_NARGS)) == 0U) &&
+         ((func == LL_CORDIC_FUNCTION_COSINE) || (func == LL_CORDIC_FUNCTION_SINE) ||
+          (func == LL_CORDIC_FUNCTION_PHASE) || (func == LL_CORDIC_FUNCTION_MODULUS));
+}
+
+static void cb_dma_stop(void)
+{
+  LL_DMA_DisableChannel(CB_DMA, CB_DMA_WR_CH);
+  CORDIC->CSR &= ~CB_CSR_DMA;
+  LL_DMA_DisableChannel(CB_DMA, CB_DMA_RD_CH);
+}
+
+void cordic_batch_init(void)
+{
+  LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2);
+
+  LL_DMA_ConfigTransfer(CB_DMA, CB_DMA_WR_CH,
+                        LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_NORMAL |
+                        LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                        LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD |
+                        LL_DMA_PRIORITY_LOW);
+  LL_DMA_SetPeriphRequest(CB_DMA, CB_DMA_WR_CH, LL_DMAMUX_REQ_CORDIC_WRITE);
+  LL_DMA_SetPeriphAddress(CB_DMA, CB_DMA_WR_CH, (uint32_t)&CORDIC->WDATA);
+  LL_DMA_EnableIT_TE(CB_DMA, CB_DMA_WR_CH);
+
+  /* 读通道优先级高一档: 结果先取走, CORDIC 才接受下一个元素 */
+  LL_DMA_ConfigTransfer(CB_DMA, CB_DMA_RD_CH,
+                        LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_MODE_NORMAL |
+                        LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                        LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD |
+                        LL_DMA_PRIORITY_MEDIUM);
+  LL_DMA_SetPeriphRequest(CB_DMA, CB_DMA_RD_CH, LL_DMAMUX_REQ_CORDIC_READ);
+  LL_DMA_SetPeriphAddress(CB_DMA, CB_DMA_RD_CH, (uint32_t)&CORDIC->RDATA);
+  LL_DMA_EnableIT_TC(CB_DMA, CB_DMA_RD_CH);
+  LL_DMA_EnableIT_TE(CB_DMA, CB_DMA_RD_CH);
+
+  HAL_NVIC_SetPriority(DMA2_Channel1_IRQn, CORDIC_BATCH_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Channel1_IRQn);
+  HAL_NVIC_SetPriority(DMA2_Channel2_IRQn, CORDIC_BATCH_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Channel2_IRQn);
+}
+
+void cordic_batch_resume(void)
+{
+  if (next >= job.n) {
+    /* 最后一个元素在 pause() 里读完了: TC 不会再来, 自己挂起完成中断 */
+    cordic_batch_state = CORDIC_BATCH_DONE;
+    NVIC_SetPendingIRQ(DMA2_Channel2_IRQn);
+    return;
+  }
+  seg_n = job.n - next;
+
+  if (seed_arg2) {
+    /* 两参数写一次 (0, 1), 结果读掉 */
+    WRITE_REG(CORDIC->CSR, job.csr | CORDIC_CSR_NARGS);
+    LL_CORDIC_WriteData(CORDIC, 0U);
+    LL_CORDIC_WriteData(CORDIC, 0x7FFFFFFFU);
+    for (uint32_t k = 0U; k < nres; k++) {
+      (void)LL_CORDIC_ReadData(CORDIC);
+    }
+  }
+  WRITE_REG(CORDIC->CSR, job.csr);
+  LL_DMA_ClearFlag_GI1(CB_DMA);
+  LL_DMA_ClearFlag_GI2(CB_DMA);
+  LL_DMA_SetMemoryAddress(CB_DMA, CB_DMA_RD_CH, (uint32_t)&job.out[next * nres]);
+  LL_DMA_SetDataLength(CB_DMA, CB_DMA_RD_CH, seg_n * nres);
+  LL_DMA_SetMemoryAddress(CB_DMA, CB_DMA_WR_CH, (uint32_t)&job.in[next * nargs]);
+  LL_DMA_SetDataLength(CB_DMA, CB_DMA_WR_CH, seg_n * nargs);
+  LL_DMA_EnableChannel(CB_DMA, CB_DMA_RD_CH);
+  LL_DMA_EnableChannel(CB_DMA, CB_DMA_WR_CH);
+  cordic_batch_state = CORDIC_BATCH_RUNNING;
+  WRITE_REG(CORDIC->CSR, job.csr | CORDIC_CSR_DMAREN | CORDIC_CSR_DMAWEN);
+}
+
+/* 停 DMA 并停在元素边界: CORDIC 里的元素读完, next 指向第一个没算完的元素 */
+static void cb_stop_at_boundary(void)
+{
+  cb_dma_stop();
+
+  const uint32_t w_words = (seg_n * nargs) - LL_DMA_GetDataLength(CB_DMA, CB_DMA_WR_CH);
+  const uint32_t r_words = (seg_n * nres) - LL_DMA_GetDataLength(CB_DMA, CB_DMA_RD_CH);
+  uint32_t started = w_words / nargs;
+  uint32_t done = r_words / nres;
+
+  if ((w_words % nargs) != 0U) {
+    /* 只写了第一个参数: 补上第二个, 让这个元素算完 */
+    LL_CORDIC_WriteData(CORDIC, (uint32_t)job.in[((next + started) * nargs) + 1U]);
+    started++;
+  }
+  if (started > done) {
+    /* 在 CORDIC 里的元素: 剩下的结果字直接读, RDATA 等到算完.
+     * 读写差不止一个元素 (不该发生) 时只读掉丢弃, 从最后读完的元素重算 */
+    int32_t *o = (started == (done + 1U)) ? &job.out[(next + done) * nres] : NULL;
+    for (uint32_t k = r_words % nres; k < nres; k++) {
+      const int32_t v = (int32_t)LL_CORDIC_ReadData(CORDIC);
+      if (o != NULL) {
+        o[k] = v;
+      }
+    }
+    if (o != NULL) {
+      done++;
+    }
+  }
+  next += done;
+  seg_n = 0U;
+}
+
+void cordic_batch_pause(void)
+{
+  cb_stop_at_boundary();
+  stats.pauses++;
+  cordic_batch_state = CORDIC_BATCH_PAUSED;
+}
+
+int cordic_batch_start(const cordic_batch_job_t *j)
+{
+  if ((j == NULL) || (j->in == NULL) || (j->out == NULL) || (j->n == 0U) ||
+      ((j->csr & CB_CSR_DMA) != 0U)) {
+    return -2;
+  }
+  const uint32_t wi = words_in(j->csr);
+  const uint32_t wo = words_out(j->csr);
+  if ((j->n > (CORDIC_BATCH_MAX_WORDS / wi)) || (j->n > (CORDIC_BATCH_MAX_WORDS / wo))) {
+    return -2;
+  }
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (cordic_batch_state != CORDIC_BATCH_IDLE) {
+    __set_PRIMASK(primask);
+    return -1;
+  }
+  job = *j;
+  nargs = wi;
+  nres = wo;
+  seed_arg2 = uses_arg2(j->csr);
+  next = 0U;
+  seg_n = 0U;
+  t_start = DWT->CYCCNT;
+  cordic_batch_state = CORDIC_BATCH_PAUSED;
+  if (cordic_batch_claims == 0U) {
+    cordic_batch_resume();
+  }
+  __set_PRIMASK(primask);
+  return 0;
+}
+
+bool cordic_batch_busy(void)
+{
+  return cordic_batch_state != CORDIC_BATCH_IDLE;
+}
+
+static void finish(cordic_batch_status_t st)
+{
+  /* 关中断调用; 回调由调用者在开中断后做 */
+  cordic_batch_state = CORDIC_BATCH_IDLE;
+  if (st == CORDIC_BATCH_OK) {
+    stats.jobs++;
+    stats.elements += job.n;
+    stats.last_n = job.n;
+    stats.last_cycles = DWT->CYCCNT - t_start;
+  } else if (st == CORDIC_BATCH_ABORTED) {
+    stats.aborts++;
+  } else {
+    stats.errors++;
+  }
+}
+
+void cordic_batch_abort(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (cordic_batch_state == CORDIC_BATCH_IDLE) {
+    __set_PRIMASK(primask);
+    return;
+  }
+  if (cordic_batch_state == CORDIC_BATCH_RUNNING) {
+    cb_stop_at_boundary();
+  }
+  finish(CORDIC_BATCH_ABORTED);
+  const cordic_batch_job_t j = job;
+  __set_PRIMASK(primask);
+  if (j.done != NULL) {
+    j.done(&j, CORDIC_BATCH_ABORTED);
+  }
+}
+
+void cordic_batch_dma_irq(void)
+{
+  cordic_batch_status_t st = CORDIC_BATCH_OK;
+  bool end = false;
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if ((LL_DMA_IsActiveFlag_TE1(CB_DMA) != 0U) || (LL_DMA_IsActiveFlag_TE2(CB_DMA) != 0U)) {
+    LL_DMA_ClearFlag_GI1(CB_DMA);
+    LL_DMA_ClearFlag_GI2(CB_DMA);
+    if (cordic_batch_state != CORDIC_BATCH_IDLE) {
+      cb_dma_stop();
+      st = CORDIC_BATCH_DMA_ERROR;
+      end = true;
+    }
+  } else {
+    if (LL_DMA_IsActiveFlag_TC2(CB_DMA) != 0U) {
+      LL_DMA_ClearFlag_TC2(CB_DMA);
+      if ((cordic_batch_state == CORDIC_BATCH_RUNNING) &&
+          (LL_DMA_GetDataLength(CB_DMA, CB_DMA_RD_CH) == 0U)) {
+        cb_dma_stop();
+        cordic_batch_state = CORDIC_BATCH_DONE;
+      }
+    }
+    if (cordic_batch_state == CORDIC_BATCH_DONE) {
+      next = job.n;
+      st = CORDIC_BATCH_OK;
+      end = true;
+    }
+  }
+  if (end) {
+    finish(st);
+  }
+  const cordic_batch_job_t j = job;
+  __set_PRIMASK(primask);
+
+  if (end && (j.done != NULL)) {
+    j.done(&j, st);
+  }
+}
+
+void cordic_batch_get_stats(cordic_batch_stats_t *out)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  *out = stats;
+  __set_PRIMASK(primask);
+}
@@ -0,0 +1,110 @@
+/*
+ * cordic_batch.h  - CORDIC 后台批处理 (DMA2 Ch1 写 / Ch2 读)
+ *
+ * Usage:
+ *   cordic_batch_init()             -> call once after MX_CORDIC_Init()
+ *   cordic_batch_start(&job)        -> 整个数组交给 DMA, 立即返回
+ *   job.done(job, status)           -> DMA2 Ch2 中断里回调 (可为 NULL)
+ *   cordic_batch_busy() / abort()   -> 查询 / 放弃
+ *
+ *   job.in  --DMA2_Ch1 (CORDIC_WRITE)--> CORDIC->WDATA
+ *   CORDIC->RDATA --DMA2_Ch2 (CORDIC_READ)--> job.out   (TC/TE IRQ -> done)
+ *
+ * 仲裁: CPU 用 CORDIC 的地方 (HF 电流环, MCM_Trig_Functions, MCM_Sqrt,
+ * MCM_Modulus, MCM_PhaseComputation) 都包在 cordic_batch_claim()/release()
+ * 里. 第一个 claim 停 DMA, 把在 CORDIC 里的那个元素的结果读回 job.out,
+ * 记下下一个元素; 最后一个 release 从那个元素接着跑. 批处理对实时用户
+ * 只多一次暂停/恢复 (HF 里约 100 cycles), 没有批处理时只是一次计数.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef CORDIC_BATCH_H_
+#define CORDIC_BATCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "stm32g4xx.h"
+
+#define CORDIC_BATCH_IRQ_PRIO    5U          /* 和 fmac_rt 的 DMA 一样, 低于所有 MCSDK 中断 */
+#define CORDIC_BATCH_MAX_WORDS   0xFFFFU     /* DMA CNDTR 16 位: n x 每元素字数 */
+
+typedef enum {
+  CORDIC_BATCH_OK = 0,
+  CORDIC_BATCH_ABORTED,
+  CORDIC_BATCH_DMA_ERROR
+} cordic_batch_status_t;
+
+typedef struct cordic_batch_job cordic_batch_job_t;
+typedef void (*cordic_batch_cb_t)(const cordic_batch_job_t *job, cordic_batch_status_t status);
+
+struct cordic_batch_job {
+  uint32_t          csr;   /* FUNC/PRECISION/SCALE/NARGS/NRES/ARGSIZE/RESSIZE, 不带 DMA/IEN 位;
+                              32 位单参数 cos/sin: 模长固定为 1 */
+  const int32_t    *in;    /* 每元素 NARGS 个字 (16 位参数: 一个字装两个) */
+  int32_t          *out;   /* 每元素 NRES 个字 (16 位结果: 一个字装两个) */
+  uint32_t          n;     /* 元素个数 */
+  cordic_batch_cb_t done;  /* 完成 / 放弃 / 出错时调用一次, 中断上下文 */
+  void             *ctx;
+};
+
+typedef struct {
+  uint32_t jobs;           /* 正常完成的 job */
+  uint32_t elements;       /* 正常完成的元素 */
+  uint32_t pauses;         /* 被 CPU 用户打断的次数 */
+  uint32_t aborts;
+  uint32_t errors;         /* DMA 传输错误 */
+  uint32_t last_n;         /* 最后一个完成的 job: 元素数 / start 到完成的 cycles */
+  uint32_t last_cycles;
+} cordic_batch_stats_t;
+
+typedef enum {
+  CORDIC_BATCH_IDLE = 0,
+  CORDIC_BATCH_RUNNING,    /* DMA 在跑 */
+  CORDIC_BATCH_PAUSED,     /* 有 CPU 用户持有 CORDIC */
+  CORDIC_BATCH_DONE        /* 全部元素已在 job.out, 等中断回调 */
+} cordic_batch_state_t;
+
+void cordic_batch_init(void);
+
+/* 0 ok; -1 忙; -2 参数不对 (n 为 0, 指针为空, 超过 CNDTR, csr 带 DMA/IEN 位) */
+int cordic_batch_start(const cordic_batch_job_t *job);
+bool cordic_batch_busy(void);
+void cordic_batch_abort(void);
+void cordic_batch_get_stats(cordic_batch_stats_t *out);
+
+/* DMA2_Channel1 / DMA2_Channel2 IRQHandler; 关中断测时也可以在线程里轮询 */
+void cordic_batch_dma_irq(void);
+
+/* ── 仲裁, 只给 claim/release 用 ── */
+extern volatile cordic_batch_state_t cordic_batch_state;
+extern volatile uint8_t cordic_batch_claims;
+void cordic_batch_pause(void);
+void cordic_batch_resume(void);
+
+/* CPU 用 CORDIC 前调用, 可以嵌套, 任何上下文 */
+__STATIC_FORCEINLINE void cordic_batch_claim(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  cordic_batch_claims++;
+  if (cordic_batch_state == CORDIC_BATCH_RUNNING) {
+    cordic_batch_pause();
+  }
+  __set_PRIMASK(primask);
+}
+
+/* 和 claim 成对; 最后一个 release 让批处理接着跑 */
+__STATIC_FORCEINLINE void cordic_batch_release(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  cordic_batch_claims--;
+  if ((cordic_batch_claims == 0U) && (cordic_batch_state == CORDIC_BATCH_PAUSED)) {
+    cordic_batch_resume();
+  }
+  __set_PRIMASK(primask);
+}
+
+#endif /* CORDIC_BATCH_H_ */
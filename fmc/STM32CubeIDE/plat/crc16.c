@@ -0,0 +1,134 @@
+/*
+ * crc16.c  - CRC-16/MODBUS, HW CRC unit + slice-by-8 fallback
+ *
+ * 外设配置 (RM0440 CRC): POLYSIZE=16, POL=0x8005, INIT=0xFFFF,
+ *   REV_IN=按字节反转, REV_OUT=1.
+ * 反射 CRC 要求按字节流顺序、每字节 LSB 先进; 外设整字从 MSB 开始处理,
+ * 所以小端字先 __REV 再写 DR, 剩下不足 4 字节的用 8 位写.
+ *
+ * 外设是全局的, 用 LDREX/STREX 抢占标志: 抢不到说明被打断的低优先级
+ * 上下文正在用, 直接走软件, 结果一样.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "crc16.h"
+#include <string.h>
+#if CRC16_USE_HW
+#include "stm32g4xx.h"
+#endif
+
+static uint16_t crc_tab[8][256];
+static volatile crc16_stats_t crc_st;
+
+void crc16_init(void)
+{
+  for (uint32_t i = 0; i < 256U; i++) {
+    uint32_t c = i;
+    for (uint32_t k = 0; k < 8U; k++) {
+      c = (c & 1U) ? ((c >> 1) ^ CRC16_POLY_REFLECTED) : (c >> 1);
+    }
+    crc_tab[0][i] = (uint16_t)c;
+  }
+  for (uint32_t t = 1; t < 8U; t++) {
+    for (uint32_t i = 0; i < 256U; i++) {
+      uint16_t prev = crc_tab[t - 1U][i];
+      crc_tab[t][i] = (uint16_t)((prev >> 8) ^ crc_tab[0][prev & 0xFFU]);
+    }
+  }
+
+#if CRC16_USE_HW
+  RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+  (void)RCC->AHB1ENR;
+  CRC->POL  = 0x8005U;
+  CRC->INIT = CRC16_INIT;
+  CRC->CR   = CRC_CR_POLYSIZE_0 | CRC_CR_REV_IN_0 | CRC_CR_REV_OUT;
+#endif
+}
+
+uint16_t crc16_sw_bytewise(uint16_t crc, const uint8_t *data, size_t len)
+{
+  uint32_t c = crc;
+  for (size_t i = 0; i < len; i++) {
+    c = (c >> 8) ^ crc_tab[0][(c ^ data[i]) & 0xFFU];
+  }
+  return (uint16_t)c;
+}
+
+uint16_t crc16_sw(uint16_t crc, const uint8_t *data, size_t len)
+{
+  uint32_t c = crc;
+
+  while (len >= 8U) {
+    uint32_t w0;
+    uint32_t w1;
+    memcpy(&w0, data, 4);           /* M4 LDR 支持非对齐, 编译成单条加载 */
+    memcpy(&w1, data + 4, 4);
+    w0 ^= c;
+    c = crc_tab[7][w0 & 0xFFU]         ^ crc_tab[6][(w0 >> 8) & 0xFFU] ^
+        crc_tab[5][(w0 >> 16) & 0xFFU] ^ crc_tab[4][w0 >> 24] ^
+        crc_tab[3][w1 & 0xFFU]         ^ crc_tab[2][(w1 >> 8) & 0xFFU] ^
+        crc_tab[1][(w1 >> 16) & 0xFFU] ^ crc_tab[0][w1 >> 24];
+    data += 8;
+    len -= 8U;
+  }
+  return crc16_sw_bytewise((uint16_t)c, data, len);
+}
+
+#if CRC16_USE_HW
+static volatile uint32_t hw_owner = 0U;
+
+int crc16_hw(const uint8_t *data, size_t len, uint16_t *out)
+{
+  do {
+    if (__LDREXW(&hw_owner) != 0U) {
+      __CLREX();
+      return -1;
+    }
+  } while (__STREXW(1U, &hw_owner) != 0U);
+  __DMB();
+
+  CRC->CR |= CRC_CR_RESET;
+
+  /* 先把地址补到 4 字节对齐, 中间整字, 最后零头 */
+  while ((len != 0U) && (((uintptr_t)data & 3U) != 0U)) {
+    *(__IO uint8_t *)&CRC->DR = *data++;
+    len--;
+  }
+  const uint32_t *w = (const uint32_t *)data;
+  for (size_t n = len >> 2; n != 0U; n--) {
+    CRC->DR = __REV(*w++);
+  }
+  data = (const uint8_t *)w;
+  for (len &= 3U; len != 0U; len--) {
+    *(__IO uint8_t *)&CRC->DR = *data++;
+  }
+  *out = (uint16_t)CRC->DR;
+
+  __DMB();
+  hw_owner = 0U;
+  return 0;
+}
+#endif
+
+uint16_t crc16(const uint8_t *data, size_t len)
+{
+#if CRC16_USE_HW
+  uint16_t crc;
+  if (crc16_hw(data, len, &crc) == 0) {
+    crc_st.hw_calls++;
+    return crc;
+  }
+  crc_st.hw_busy++;
+#endif
+  crc_st.sw_calls++;    /* 统计用, 竞争无所谓 */
+  return crc16_sw(CRC16_INIT, data, len);
+}
+
+void crc16_get_stats(crc16_stats_t *out)
+{
+  out->hw_calls = crc_st.hw_calls;
+  out->sw_calls = crc_st.sw_calls;
+  out->hw_busy  = crc_st.hw_busy;
+}
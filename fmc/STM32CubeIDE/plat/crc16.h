@@ -0,0 +1,57 @@
+/*
+ * crc16.h  - CRC-16 for ASPEP data packets (HW CRC unit or slice-by-8)
+ *
+ * Usage:
+ *   crc16_init()                    -> 建表 + 配置 CRC 外设, ASPEP_start() 里调用
+ *   crc16(buf, len)                 -> 计算 buf 的 CRC (原地, 不拷贝)
+ *   crc16(buf, len + 2) == 0        -> 带 CRC 的包校验通过
+ *
+ * 算法: CRC-16/MODBUS (poly 0x8005 反射 = 0xA001, init 0xFFFF, refin/refout,
+ * xorout 0, check("123456789") = 0x4B37). CRC 低字节在前追加到数据后面,
+ * 对 "数据 + CRC" 再算一遍结果为 0.
+ *
+ * CRC16_USE_HW = 1 (固件默认): 用 G474 CRC 外设, 4 字节一写;
+ *   外设正被低优先级上下文占用时 (ADC 中断里的 MCPA 打断了 MF 任务),
+ *   这一次退回软件, 不等待也不关中断.
+ * CRC16_USE_HW = 0 (主机构建): 只用软件 slice-by-8 (8 张 256 项表, 4 KB RAM).
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef CRC16_H_
+#define CRC16_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef CRC16_USE_HW
+#define CRC16_USE_HW             1
+#endif
+
+#define CRC16_INIT               0xFFFFU
+#define CRC16_POLY_REFLECTED     0xA001U
+#define CRC16_CHECK              0x4B37U    /* crc16("123456789") */
+
+typedef struct {
+  uint32_t hw_calls;        /* 走外设的次数 */
+  uint32_t sw_calls;        /* 走 slice-by-8 的次数 */
+  uint32_t hw_busy;         /* 外设被占用退回软件的次数 (包含在 sw_calls 里) */
+} crc16_stats_t;
+
+void crc16_init(void);
+
+/* 按编译选项选路径; 任意上下文可调用 */
+uint16_t crc16(const uint8_t *data, size_t len);
+
+/* 各实现单独导出, 给 bench 和主机测试对比用 */
+uint16_t crc16_sw(uint16_t crc, const uint8_t *data, size_t len);        /* slice-by-8 */
+uint16_t crc16_sw_bytewise(uint16_t crc, const uint8_t *data, size_t len); /* 单表, 参考实现 */
+#if CRC16_USE_HW
+/* 外设空闲返回 0 并写 *out; 被占用返回 -1 */
+int      crc16_hw(const uint8_t *data, size_t len, uint16_t *out);
+#endif
+
+void crc16_get_stats(crc16_stats_t *out);
+
+#endif /* CRC16_H_ */
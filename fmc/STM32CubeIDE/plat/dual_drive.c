@@ -0,0 +1,172 @@
+/*
+ * dual_drive.c  - M2 功率级 (TIM8 + 共用 ADC1/ADC2) 的外设初始化
+ *
+ * Architecture:
+ *   TIM8 和 TIM1 同配置: 中心对齐, CH1..3 PWM1, CH4 PWM2 -> TRGO (OC4REF)
+ *   触发注入转换. 两个电机分时共用 ADC1/ADC2: 各自的 TIMx_UP 中断把
+ *   本电机的 JSQR 装进 ADC (R3_2_TIMx_UP_IRQHandler), 再把电机号压进
+ *   TSK_DualDriveFIFOUpdate 的 FIFO; ADC1_2 中断按同样顺序取出.
+ *   R3_2_TIMxInit 让 TIM1 比 TIM8 错开半个 PWM 周期, 两次采样不会撞.
+ *
+ * M2 沿用 M1 的 PWM 频率/死区/采样参数 (mc_parameters.c R3_2_ParamsM2).
+ * 硬件关断和 M1 一样: 驱动芯片的故障输出接 TIM8_BKIN2 (M2_DP), BRK2 直接关
+ * TIM8 输出, TIMx_BRK_M2_IRQHandler -> PWMC_DP_Handler 报 MC_DP_FAULT.
+ * 引脚是占位分配 (main.h M2_*), 换板子时只改 main.h; M2_PINS_PLACEHOLDER
+ * 不清零就编不过, 免得 M2 在没有硬件保护的引脚上跑起来.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "dual_drive.h"
+#include "main.h"
+#include "mc_type.h"
+#include "parameters_conversion.h"
+
+#if (NBR_OF_MOTORS > 1)
+
+#if (M2_PINS_PLACEHOLDER != 0)
+#error "M2 pins in main.h are placeholders: map M2_* (incl. M2_DP -> TIM8_BKIN2) to the board, then set M2_PINS_PLACEHOLDER 0"
+#endif
+
+static TIM_HandleTypeDef htim8;
+
+void dual_drive_tim8_init(void)
+{
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+  TIMEx_BreakInputConfigTypeDef sBreakInputConfig = {0};
+  TIM_OC_InitTypeDef sConfigOC = {0};
+  TIM_BreakDeadTimeConfigTypeDef sBreakDeadTimeConfig = {0};
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  __HAL_RCC_TIM8_CLK_ENABLE();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+
+  htim8.Instance = TIM8;
+  htim8.Init.Prescaler = ((TIM_CLOCK_DIVIDER) - 1);
+  htim8.Init.CounterMode = TIM_COUNTERMODE_CENTERALIGNED1;
+  htim8.Init.Period = ((PWM_PERIOD_CYCLES2) / 2);
+  htim8.Init.ClockDivision = TIM_CLOCKDIVISION_DIV2;
+  htim8.Init.RepetitionCounter = (REP_COUNTER2);
+  htim8.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  if (HAL_TIM_PWM_Init(&htim8) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_OC4REF;
+  sMasterConfig.MasterOutputTrigger2 = TIM_TRGO2_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim8, &sMasterConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sBreakInputConfig.Source = TIM_BREAKINPUTSOURCE_BKIN;
+  sBreakInputConfig.Enable = TIM_BREAKINPUTSOURCE_ENABLE;
+  sBreakInputConfig.Polarity = TIM_BREAKINPUTSOURCE_POLARITY_LOW;
+  if (HAL_TIMEx_ConfigBreakInput(&htim8, TIM_BREAKINPUT_BRK2, &sBreakInputConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfigOC.OCMode = TIM_OCMODE_PWM1;
+  sConfigOC.Pulse = ((PWM_PERIOD_CYCLES2) / 4);
+  sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+  sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
+  sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+  sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
+  sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+  if ((HAL_TIM_PWM_ConfigChannel(&htim8, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+      || (HAL_TIM_PWM_ConfigChannel(&htim8, &sConfigOC, TIM_CHANNEL_2) != HAL_OK)
+      || (HAL_TIM_PWM_ConfigChannel(&htim8, &sConfigOC, TIM_CHANNEL_3) != HAL_OK))
+  {
+    Error_Handler();
+  }
+  sConfigOC.OCMode = TIM_OCMODE_PWM2;
+  sConfigOC.Pulse = (((PWM_PERIOD_CYCLES2) / 2) - (HTMIN));
+  if (HAL_TIM_PWM_ConfigChannel(&htim8, &sConfigOC, TIM_CHANNEL_4) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* BRK2 <- M2_DP, 和 TIM1 一样的滤波; BRK 不用 (过压和 M1 一样走软件) */
+  sBreakDeadTimeConfig.OffStateRunMode = TIM_OSSR_ENABLE;
+  sBreakDeadTimeConfig.OffStateIDLEMode = TIM_OSSI_ENABLE;
+  sBreakDeadTimeConfig.LockLevel = TIM_LOCKLEVEL_OFF;
+  sBreakDeadTimeConfig.DeadTime = 0;
+  sBreakDeadTimeConfig.BreakState = TIM_BREAK_DISABLE;
+  sBreakDeadTimeConfig.BreakPolarity = TIM_BREAKPOLARITY_HIGH;
+  sBreakDeadTimeConfig.BreakFilter = 0;
+  sBreakDeadTimeConfig.BreakAFMode = TIM_BREAK_AFMODE_INPUT;
+  sBreakDeadTimeConfig.Break2State = TIM_BREAK2_ENABLE;
+  sBreakDeadTimeConfig.Break2Polarity = TIM_BREAK2POLARITY_HIGH;
+  sBreakDeadTimeConfig.Break2Filter = 3;
+  sBreakDeadTimeConfig.Break2AFMode = TIM_BREAK_AFMODE_INPUT;
+  sBreakDeadTimeConfig.AutomaticOutput = TIM_AUTOMATICOUTPUT_DISABLE;
+  if (HAL_TIMEx_ConfigBreakDeadTime(&htim8, &sBreakDeadTimeConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /* PC6/PC7/PC8 -> TIM8_CH1..3 */
+  GPIO_InitStruct.Pin = M2_PWM_UH_Pin | M2_PWM_VH_Pin | M2_PWM_WH_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  GPIO_InitStruct.Alternate = GPIO_AF4_TIM8;
+  HAL_GPIO_Init(M2_PWM_UH_GPIO_Port, &GPIO_InitStruct);
+
+  /* PC9 -> TIM8_BKIN2, 驱动芯片故障输出 (开漏, 低有效) */
+  GPIO_InitStruct.Pin = M2_DP_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  GPIO_InitStruct.Alternate = GPIO_AF6_TIM8;
+  HAL_GPIO_Init(M2_DP_GPIO_Port, &GPIO_InitStruct);
+
+  /* 半桥使能, 上电默认关 */
+  HAL_GPIO_WritePin(M2_PWM_EN_U_GPIO_Port, M2_PWM_EN_U_Pin | M2_PWM_EN_V_Pin | M2_PWM_EN_W_Pin,
+                    GPIO_PIN_RESET);
+  GPIO_InitStruct.Pin = M2_PWM_EN_U_Pin | M2_PWM_EN_V_Pin | M2_PWM_EN_W_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  GPIO_InitStruct.Alternate = 0;
+  HAL_GPIO_Init(M2_PWM_EN_U_GPIO_Port, &GPIO_InitStruct);
+
+  /* 优先级和 TIM1 一致: 两个 UP 同为 0 互不嵌套, FIFO 单生产者单消费者, 不用加锁 */
+  HAL_NVIC_SetPriority(TIM8_UP_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(TIM8_UP_IRQn);
+  HAL_NVIC_SetPriority(TIM8_BRK_IRQn, 4, 1);
+  HAL_NVIC_EnableIRQ(TIM8_BRK_IRQn);
+}
+
+void dual_drive_adc_init(ADC_TypeDef *adc)
+{
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  /* JSQR 由 R3_2 驱动每个周期重写, 这里只补通道的采样时间和单端模式 */
+  LL_ADC_SetChannelSamplingTime(adc, LL_ADC_CHANNEL_6, LL_ADC_SAMPLINGTIME_6CYCLES_5);
+  LL_ADC_SetChannelSamplingTime(adc, LL_ADC_CHANNEL_7, LL_ADC_SAMPLINGTIME_6CYCLES_5);
+  LL_ADC_SetChannelSamplingTime(adc, LL_ADC_CHANNEL_8, LL_ADC_SAMPLINGTIME_6CYCLES_5);
+  LL_ADC_SetChannelSingleDiff(adc, LL_ADC_CHANNEL_6, LL_ADC_SINGLE_ENDED);
+  LL_ADC_SetChannelSingleDiff(adc, LL_ADC_CHANNEL_7, LL_ADC_SINGLE_ENDED);
+  LL_ADC_SetChannelSingleDiff(adc, LL_ADC_CHANNEL_8, LL_ADC_SINGLE_ENDED);
+
+  /* PC0/PC1/PC2 -> ADC12_IN6/7/8 */
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  GPIO_InitStruct.Pin = M2_CURR_AMPL_U_Pin | M2_CURR_AMPL_V_Pin | M2_CURR_AMPL_W_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  HAL_GPIO_Init(M2_CURR_AMPL_U_GPIO_Port, &GPIO_InitStruct);
+}
+
+#else
+
+void dual_drive_tim8_init(void)
+{
+}
+
+void dual_drive_adc_init(ADC_TypeDef *adc)
+{
+  (void)adc;
+}
+
+#endif /* NBR_OF_MOTORS > 1 */
@@ -0,0 +1,23 @@
+/*
+ * dual_drive.h  - M2 功率级 (TIM8 + 共用 ADC1/ADC2) 的外设初始化
+ *
+ * Usage:
+ *   dual_drive_tim8_init()      -> tim.c "TIM1_Init 2", 紧跟 MX_TIM1_Init 的配置
+ *   dual_drive_adc_init(ADCx)   -> adc.c "ADC1_Init 2" / "ADC2_Init 2"
+ *
+ * fmc.ioc 里只有 M1, M2 的 TIM8/引脚/NVIC 在这里补上, 保持 CubeMX 生成的代码不动.
+ * NBR_OF_MOTORS=1 (默认) 时两个函数都是空的.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef DUAL_DRIVE_H_
+#define DUAL_DRIVE_H_
+
+#include "stm32g4xx.h"
+
+void dual_drive_tim8_init(void);
+void dual_drive_adc_init(ADC_TypeDef *adc);
+
+#endif /* DUAL_DRIVE_H_ */
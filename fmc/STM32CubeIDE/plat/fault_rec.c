@@ -0,0 +1,174 @@
+/*
+ * fault_rec.c  - 故障黑匣子 (见 fault_rec.h)
+ *
+ * Architecture:
+ *   FOC_HighFrequencyTask -> FAULT_REC_HF -> fault_rec_hf()   -> ring (每拍覆盖最老)
+ *   MCI_FaultProcessing / TIM1 BRK -> fault_rec_freeze()      -> 停录, 写头
+ *   main: fault_rec_init()  -> 头有效就保留窗口 (boots++), 否则重新开始录
+ *   log_poll (主循环) -> fault_rec_dump_next() -> "#FH:" / "#F:" hex 行
+ *
+ * HF 路径只有一次 armed 判断 + 一条记录的拷贝, 不关中断. 冻结可能来自
+ * 比 ADC 中断低的优先级 (安全任务), 关中断写头, 保证最后一条记录是完整的.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "fault_rec.h"
+#include "mc_config.h"
+#include <string.h>
+
+#if (FAULT_REC_RECORDS & (FAULT_REC_RECORDS - 1U)) != 0U
+#error "fault_rec: FAULT_REC_RECORDS must be a power of 2"
+#endif
+
+#define REC_MASK       (FAULT_REC_RECORDS - 1U)
+#define CHECK_SEED     0x5A5AA5A5u
+
+/* 复位后还在: .noinit 段不在 .bss 里, 启动代码不清零. 调试器也可以直接读 */
+__attribute__((section(".noinit"))) fault_rec_rec_t fault_rec_ring[FAULT_REC_RECORDS];
+__attribute__((section(".noinit"))) fault_rec_hdr_t fault_rec_hdr;
+
+volatile uint8_t fault_rec_armed = 0U;
+
+static uint32_t rec_n;                    /* 本次录制写过的记录数, 只在中断里写 */
+static uint32_t dump_pos;
+static uint8_t  dump_active;
+
+static uint32_t hdr_check(const fault_rec_hdr_t *h)
+{
+  uint32_t w[(sizeof(*h) / 4U) - 1U];
+  memcpy(w, h, sizeof(w));
+  uint32_t c = CHECK_SEED;
+  for (uint32_t i = 0; i < (sizeof(w) / 4U); i++) {
+    c = ((c << 5) | (c >> 27)) ^ w[i];
+  }
+  return c;
+}
+
+static bool hdr_valid(void)
+{
+  return (fault_rec_hdr.magic == FAULT_REC_MAGIC) && (fault_rec_hdr.check == hdr_check(&fault_rec_hdr));
+}
+
+static uint32_t window_count(uint32_t written)
+{
+  return (written < FAULT_REC_RECORDS) ? written : FAULT_REC_RECORDS;
+}
+
+void fault_rec_arm(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  fault_rec_armed = 0U;
+  memset(&fault_rec_hdr, 0, sizeof(fault_rec_hdr));
+  rec_n = 0U;
+  dump_active = 0U;
+  fault_rec_armed = 1U;
+  __set_PRIMASK(primask);
+}
+
+void fault_rec_init(void)
+{
+  if (hdr_valid()) {
+    /* 上次复位前冻结的窗口: 保留, 不录, 等 "frec clear" */
+    fault_rec_armed = 0U;
+    fault_rec_hdr.boots++;
+    fault_rec_hdr.check = hdr_check(&fault_rec_hdr);
+    dump_active = 0U;
+  } else {
+    fault_rec_arm();
+  }
+}
+
+void fault_rec_hf(uint16_t foc_ret)
+{
+  fault_rec_rec_t *r = &fault_rec_ring[rec_n & REC_MASK];
+  const FOCVars_t *v = &FOCVars[M1];
+
+  r->ia = v->Iab.a;
+  r->ib = v->Iab.b;
+  r->iq = v->Iqd.q;
+  r->id = v->Iqd.d;
+  r->vq = v->Vqd.q;
+  r->vd = v->Vqd.d;
+  r->el_angle = v->hElAngle;
+  r->obs_angle = STO_PLL_M1._Super.hElAngle;
+  r->obs_speed = STO_PLL_M1._Super.hElSpeedDpp;
+  r->vbus = BusVoltageSensor_M1._Super.AvBusVoltage_d;
+  r->faults = Mci[M1].CurrentFaults;
+  r->state = (uint8_t)Mci[M1].State;
+  r->flags = (foc_ret == MC_DURATION) ? FAULT_REC_F_DURATION : 0U;
+  rec_n++;
+}
+
+void fault_rec_freeze(const MCI_Handle_t *mci, uint16_t errors, uint8_t source)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (fault_rec_armed != 0U) {
+    /* 第一次故障说了算, 后面连锁的故障不覆盖 */
+    fault_rec_armed = 0U;
+    const uint8_t motor = ((NBR_OF_MOTORS > 1) && (mci == &Mci[NBR_OF_MOTORS - 1])) ? 1U : 0U;
+    fault_rec_hdr.written = rec_n;
+    fault_rec_hdr.faults = errors;
+    fault_rec_hdr.motor = motor;
+    fault_rec_hdr.source = source;
+    fault_rec_hdr.state = (uint16_t)Mci[motor].State;
+    fault_rec_hdr.boots = 0U;
+    fault_rec_hdr.magic = FAULT_REC_MAGIC;
+    fault_rec_hdr.check = hdr_check(&fault_rec_hdr);
+  }
+  __set_PRIMASK(primask);
+}
+
+void fault_rec_get_status(fault_rec_status_t *out)
+{
+  memset(out, 0, sizeof(*out));
+  out->armed = fault_rec_armed;
+  if ((fault_rec_armed == 0U) && hdr_valid()) {
+    out->frozen = 1U;
+    out->count = window_count(fault_rec_hdr.written);
+    out->hdr = fault_rec_hdr;
+  } else {
+    out->count = window_count(rec_n);
+  }
+}
+
+/* 只读冻结的窗口; 录制中 HF 一直在改 ring */
+bool fault_rec_get(uint32_t i, fault_rec_rec_t *rec)
+{
+  if ((fault_rec_armed != 0U) || !hdr_valid()) {
+    return false;
+  }
+  const uint32_t count = window_count(fault_rec_hdr.written);
+  if (i >= count) {
+    return false;
+  }
+  *rec = fault_rec_ring[(fault_rec_hdr.written - count + i) & REC_MASK];
+  return true;
+}
+
+void fault_rec_dump_start(void)
+{
+  dump_pos = 0U;
+  dump_active = ((fault_rec_armed == 0U) && hdr_valid()) ? 1U : 0U;
+}
+
+uint32_t fault_rec_dump_next(fault_rec_hdr_t *hdr, fault_rec_rec_t *rec)
+{
+  if (dump_active == 0U) {
+    return 0U;
+  }
+  if (dump_pos == 0U) {
+    *hdr = fault_rec_hdr;
+    dump_pos = 1U;
+    return 1U;
+  }
+  if (!fault_rec_get(dump_pos - 1U, rec)) {
+    dump_active = 0U;
+    return 0U;
+  }
+  dump_pos++;
+  return 2U;
+}
@@ -0,0 +1,119 @@
+/*
+ * fault_rec.h  - 黑匣子: 故障前最后 N 个 FOC 周期的 M1 快照
+ *
+ * Usage:
+ *   fault_rec_init()                 -> main() 开头; 上次复位前冻结的窗口保留, 否则开始录
+ *   FAULT_REC_HF(foc_ret)            -> FOC_HighFrequencyTask, FOC_CurrControllerM1 之后
+ *   FAULT_REC_FREEZE(pMCI, errors)   -> MCI_FaultProcessing (置位新故障时)
+ *   FAULT_REC_FREEZE_BRK(errors)     -> TIMx_BRK_Mx_IRQHandler (硬件保护, 不等中频任务)
+ *   fault_rec_dump_start()           -> CLI "frec dump", log_poll 发 "#FH:" + "#F:" 行
+ *   fault_rec_arm()                  -> CLI "frec clear", 丢掉窗口重新开始录
+ *   host: frec_decode capture.txt    -> CSV
+ *
+ * 一直在录: 每个 M1 HF 周期一条 24 字节记录, 覆盖最老的一条. 第一次故障
+ * (哪个电机的都算, 头里记 motor) 冻结, 之后的故障不再覆盖, 直到
+ * fault_rec_arm(). ring 和头都在 .noinit 段
+ * (链接脚本里 NOLOAD, 启动代码不清零), 看门狗 / 软件复位后还在, 掉电丢失.
+ * 头带校验字, 上电时的随机 RAM 不会被当成有效窗口.
+ *
+ * 编译时定义 FAULT_REC_ENABLE=0 去掉 HF 钩子.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef FAULT_REC_H_
+#define FAULT_REC_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mc_interface.h"
+
+#ifndef FAULT_REC_ENABLE
+#define FAULT_REC_ENABLE         1
+#endif
+
+/* 记录数, 2 的幂; 128 条 x 24 B = 3 KB = 16 kHz 下 8 ms */
+#ifndef FAULT_REC_RECORDS
+#define FAULT_REC_RECORDS        128U
+#endif
+
+#define FAULT_REC_MAGIC          0x46524543u   /* "FREC" */
+
+#define FAULT_REC_F_DURATION     0x01U   /* 这一拍 FOC_CurrControllerM1 返回 MC_DURATION */
+
+#define FAULT_REC_SRC_MCI        1U      /* MCI_FaultProcessing */
+#define FAULT_REC_SRC_BRK        2U      /* TIM1 BRK / BRK2 (硬件 OVP / 驱动保护) */
+
+/* 小端, 24 字节, "#F:" 行原样 hex */
+typedef struct {
+  int16_t  ia;            /* FOCVars[M1].Iab */
+  int16_t  ib;
+  int16_t  iq;            /* FOCVars[M1].Iqd */
+  int16_t  id;
+  int16_t  vq;            /* FOCVars[M1].Vqd (上一拍电流环的输出) */
+  int16_t  vd;
+  int16_t  el_angle;      /* FOCVars[M1].hElAngle, 本拍变换用的角度 */
+  int16_t  obs_angle;     /* STO_PLL_M1 角度 / 速度 */
+  int16_t  obs_speed;     /* hElSpeedDpp */
+  uint16_t vbus;          /* AvBusVoltage_d */
+  uint16_t faults;        /* Mci[M1].CurrentFaults */
+  uint8_t  state;         /* Mci[M1].State */
+  uint8_t  flags;         /* FAULT_REC_F_* */
+} fault_rec_rec_t;
+
+/* 冻结时写, 小端, 20 字节, "#FH:" 行 */
+typedef struct {
+  uint32_t magic;         /* FAULT_REC_MAGIC = 已冻结 */
+  uint32_t written;       /* 冻结前写过的记录数 (= HF 周期数) */
+  uint16_t faults;        /* 触发冻结的故障位 */
+  uint8_t  motor;         /* 0 = M1, 1 = M2 */
+  uint8_t  source;        /* FAULT_REC_SRC_* */
+  uint16_t state;         /* 冻结时该电机的 MCI 状态 */
+  uint16_t boots;         /* 冻结后经历的复位次数 */
+  uint32_t check;         /* 前面各字段的校验 */
+} fault_rec_hdr_t;
+
+typedef struct {
+  uint8_t  armed;         /* 正在录 */
+  uint8_t  frozen;        /* 有一个冻结的窗口 */
+  uint32_t count;         /* 窗口里的记录数 */
+  fault_rec_hdr_t hdr;
+} fault_rec_status_t;
+
+/* .noinit, 冻结的窗口; 头校验不对就当没有 */
+extern fault_rec_rec_t fault_rec_ring[FAULT_REC_RECORDS];
+extern fault_rec_hdr_t fault_rec_hdr;
+
+void fault_rec_init(void);
+void fault_rec_arm(void);
+/* mci = NULL: M1 (BRK 中断里还没有 MCI 上下文) */
+void fault_rec_freeze(const MCI_Handle_t *mci, uint16_t errors, uint8_t source);
+void fault_rec_get_status(fault_rec_status_t *out);
+
+/* 第 i 条 (0 = 最老), 窗口里没有返回 false */
+bool fault_rec_get(uint32_t i, fault_rec_rec_t *rec);
+
+/* 主循环上传: 开始后 fault_rec_dump_next 依次给出头和记录 */
+void fault_rec_dump_start(void);
+/* 返回 0 结束, 1 = *hdr 有效 (第一次), 2 = *rec 有效 */
+uint32_t fault_rec_dump_next(fault_rec_hdr_t *hdr, fault_rec_rec_t *rec);
+
+/* HF 中断里调用, 只在录的时候进来 */
+extern volatile uint8_t fault_rec_armed;
+void fault_rec_hf(uint16_t foc_ret);
+
+#if FAULT_REC_ENABLE
+#define FAULT_REC_HF(ret)            do { if (fault_rec_armed != 0U) { fault_rec_hf(ret); } } while (0)
+#define FAULT_REC_FREEZE(mci, err)   do { if (((err) != 0U) && (fault_rec_armed != 0U)) { \
+                                            fault_rec_freeze((mci), (err), FAULT_REC_SRC_MCI); } } while (0)
+#define FAULT_REC_FREEZE_BRK(err)    do { if (((err) != 0U) && (fault_rec_armed != 0U)) { \
+                                            fault_rec_freeze(NULL, (err), FAULT_REC_SRC_BRK); } } while (0)
+#else
+#define FAULT_REC_HF(ret)            ((void)0)
+#define FAULT_REC_FREEZE(mci, err)   ((void)0)
+#define FAULT_REC_FREEZE_BRK(err)    ((void)0)
+#endif
+
+#endif /* FAULT_REC_H_ */
@@ -0,0 +1,246 @@
+/*
+ * fmac_design.c  - FIR / IIR filter designs quantized for the G4 FMAC
+ *
+ * 设计用 float (CLI 上下文, 不在 ISR 里), 量化规则:
+ *   FIR: b_q = round(b * 32768), 舍入误差补到中心 tap, 直流增益严格为 1
+ *   IIR: 找最小 R 使 max|c| / 2^R < 1, 再 round(c * 32768 / 2^R)
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "fmac_design.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define Q15_ONE       32768.0f
+
+static int16_t q15_sat(int32_t v)
+{
+  if (v > 32767)  return 32767;
+  if (v < -32768) return -32768;
+  return (int16_t)v;
+}
+
+static int16_t q15_round(float v)
+{
+  return q15_sat((int32_t)lroundf(v));
+}
+
+/* 符号扩展到 26 位, 模拟累加器回绕 */
+static int32_t acc26(int32_t v)
+{
+  return (int32_t)((uint32_t)v << 6) >> 6;
+}
+
+fmac_design_status_t fmac_design_boxcar(fmac_design_t *d, uint8_t taps)
+{
+  if ((d == NULL) || (taps < 2U) || (taps > FMAC_DESIGN_MAX_B)) {
+    return FMAC_DESIGN_ERR_ARG;
+  }
+  memset(d, 0, sizeof(*d));
+  d->kind = FMAC_DESIGN_FIR;
+  d->nb = taps;
+  for (uint32_t i = 0; i < taps; i++) {
+    d->b[i] = (int16_t)(32768U / taps);
+  }
+  return FMAC_DESIGN_OK;
+}
+
+fmac_design_status_t fmac_design_fir_lowpass(fmac_design_t *d, float fs, float fc, uint8_t taps)
+{
+  if ((d == NULL) || (taps < 2U) || (taps > FMAC_DESIGN_MAX_B) ||
+      (fs <= 0.0f) || (fc <= 0.0f) || (fc >= 0.5f * fs)) {
+    return FMAC_DESIGN_ERR_ARG;
+  }
+
+  float h[FMAC_DESIGN_MAX_B];
+  float wc = 2.0f * fc / fs;              /* 归一化截止 (1 = Nyquist) */
+  float mid = 0.5f * (float)(taps - 1U);
+  float sum = 0.0f;
+
+  for (uint32_t n = 0; n < taps; n++) {
+    float t = (float)n - mid;
+    float s = (t == 0.0f) ? wc : sinf((float)M_PI * wc * t) / ((float)M_PI * t);
+    float w = 0.54f - 0.46f * cosf(2.0f * (float)M_PI * (float)n / (float)(taps - 1U));
+    h[n] = s * w;
+    sum += h[n];
+  }
+
+  memset(d, 0, sizeof(*d));
+  d->kind = FMAC_DESIGN_FIR;
+  d->nb = taps;
+
+  int32_t qsum = 0;
+  int32_t abs_sum = 0;
+  for (uint32_t n = 0; n < taps; n++) {
+    d->b[n] = q15_round(h[n] / sum * Q15_ONE);
+    qsum += d->b[n];
+  }
+  /* 舍入误差补到中心 tap, 保证 sum(b_q) = 32768 (直流增益 1) */
+  uint32_t c = (uint32_t)(taps - 1U) / 2U;
+  d->b[c] = q15_sat((int32_t)d->b[c] + (32768 - qsum));
+
+  for (uint32_t n = 0; n < taps; n++) {
+    abs_sum += (d->b[n] < 0) ? -(int32_t)d->b[n] : (int32_t)d->b[n];
+  }
+  return (abs_sum > 32768) ? FMAC_DESIGN_WARN_GAIN : FMAC_DESIGN_OK;
+}
+
+/* b[]/a[] 为标准形式 (a0 = 1, a[] = a1..aQ), 转成 FMAC 符号并量化 */
+static fmac_design_status_t quantize_iir(fmac_design_t *d, const float *b, uint8_t nb,
+                                         const float *a, uint8_t na)
+{
+  float m = 0.0f;
+  for (uint32_t i = 0; i < nb; i++) m = fmaxf(m, fabsf(b[i]));
+  for (uint32_t i = 0; i < na; i++) m = fmaxf(m, fabsf(a[i]));
+
+  uint32_t r = 0;
+  while ((r <= FMAC_DESIGN_MAX_R) && (lroundf(m * Q15_ONE / (float)(1U << r)) > 32767L)) {
+    r++;
+  }
+  if (r > FMAC_DESIGN_MAX_R) {
+    return FMAC_DESIGN_ERR_RANGE;
+  }
+
+  memset(d, 0, sizeof(*d));
+  d->kind = FMAC_DESIGN_IIR;
+  d->nb = nb;
+  d->na = na;
+  d->r = (uint8_t)r;
+
+  float scale = Q15_ONE / (float)(1U << r);
+  int32_t abs_sum = 0;
+  for (uint32_t i = 0; i < nb; i++) {
+    d->b[i] = q15_round(b[i] * scale);
+    abs_sum += (d->b[i] < 0) ? -(int32_t)d->b[i] : (int32_t)d->b[i];
+  }
+  for (uint32_t i = 0; i < na; i++) {
+    d->a[i] = q15_round(-a[i] * scale);
+    abs_sum += (d->a[i] < 0) ? -(int32_t)d->a[i] : (int32_t)d->a[i];
+  }
+
+  /* 量化后的稳定三角形 (标准符号) */
+  float a1 = -(float)d->a[0] / scale;
+  float a2 = (na > 1U) ? (-(float)d->a[1] / scale) : 0.0f;
+  if ((fabsf(a2) >= 1.0f) || (fabsf(a1) >= 1.0f + a2)) {
+    return FMAC_DESIGN_ERR_UNSTABLE;
+  }
+
+  /* |x|,|y| <= 1 时累加器最大 sum|c_q| / 32768, q4.22 上限 8 */
+  if (abs_sum >= 8 * 32768) {
+    return FMAC_DESIGN_ERR_ACC;
+  }
+  return FMAC_DESIGN_OK;
+}
+
+fmac_design_status_t fmac_design_iir_lowpass(fmac_design_t *d, float fs, float fc, uint8_t order)
+{
+  if ((d == NULL) || (fs <= 0.0f) || (fc <= 0.0f) || (fc >= 0.5f * fs) ||
+      (order < 1U) || (order > FMAC_DESIGN_MAX_A)) {
+    return FMAC_DESIGN_ERR_ARG;
+  }
+
+  /* 双线性变换, 预畸变 */
+  float k = tanf((float)M_PI * fc / fs);
+
+  if (order == 1U) {
+    float b[2] = { k / (1.0f + k), k / (1.0f + k) };
+    float a[1] = { (k - 1.0f) / (k + 1.0f) };
+    return quantize_iir(d, b, 2U, a, 1U);
+  }
+
+  float q = 0.70710678f;             /* Butterworth */
+  float norm = 1.0f / (1.0f + k / q + k * k);
+  float b[3] = { k * k * norm, 2.0f * k * k * norm, k * k * norm };
+  float a[2] = { 2.0f * (k * k - 1.0f) * norm, (1.0f - k / q + k * k) * norm };
+  return quantize_iir(d, b, 3U, a, 2U);
+}
+
+fmac_design_status_t fmac_design_notch(fmac_design_t *d, float fs, float f0, float q)
+{
+  if ((d == NULL) || (fs <= 0.0f) || (f0 <= 0.0f) || (f0 >= 0.5f * fs) || (q <= 0.0f)) {
+    return FMAC_DESIGN_ERR_ARG;
+  }
+
+  float w0 = 2.0f * (float)M_PI * f0 / fs;
+  float cw = cosf(w0);
+  float alpha = sinf(w0) / (2.0f * q);
+  float a0 = 1.0f + alpha;
+  float b[3] = { 1.0f / a0, -2.0f * cw / a0, 1.0f / a0 };
+  float a[2] = { -2.0f * cw / a0, (1.0f - alpha) / a0 };
+  return quantize_iir(d, b, 3U, a, 2U);
+}
+
+const char *fmac_design_status_str(fmac_design_status_t st)
+{
+  switch (st) {
+    case FMAC_DESIGN_OK:           return "ok";
+    case FMAC_DESIGN_WARN_GAIN:    return "sum|b|>1, may clip";
+    case FMAC_DESIGN_ERR_ARG:      return "bad argument";
+    case FMAC_DESIGN_ERR_RANGE:    return "coeff needs R>7";
+    case FMAC_DESIGN_ERR_UNSTABLE: return "unstable after Q15";
+    case FMAC_DESIGN_ERR_ACC:      return "accumulator overflow";
+    default:                       return "?";
+  }
+}
+
+float fmac_design_dc_gain(const fmac_design_t *d)
+{
+  float scale = (float)(1U << d->r) / Q15_ONE;
+  float sb = 0.0f;
+  float sa = 0.0f;
+  for (uint32_t i = 0; i < d->nb; i++) sb += (float)d->b[i];
+  for (uint32_t i = 0; i < d->na; i++) sa += (float)d->a[i];
+  return (sb * scale) / (1.0f - sa * scale);
+}
+
+float fmac_design_group_delay(const fmac_design_t *d)
+{
+  /* 直流处群延迟 = sum(k*b_k)/sum(b_k) - sum(k*a_std_k)/sum(a_std_k) */
+  float scale = (float)(1U << d->r) / Q15_ONE;
+  float nb_ = 0.0f, db = 0.0f;
+  for (uint32_t i = 0; i < d->nb; i++) {
+    nb_ += (float)i * (float)d->b[i];
+    db  += (float)d->b[i];
+  }
+  float na_ = 0.0f, da = 1.0f;
+  for (uint32_t i = 0; i < d->na; i++) {
+    float as = -(float)d->a[i] * scale;     /* 标准符号 a1..aQ */
+    na_ += (float)(i + 1U) * as;
+    da  += as;
+  }
+  return ((db != 0.0f) ? (nb_ / db) : 0.0f) - ((da != 0.0f) ? (na_ / da) : 0.0f);
+}
+
+void fmac_ref_reset(fmac_ref_t *s)
+{
+  memset(s, 0, sizeof(*s));
+}
+
+int16_t fmac_ref_step(fmac_ref_t *s, const fmac_design_t *d, int16_t x)
+{
+  memmove(&s->x[1], &s->x[0], (uint32_t)(d->nb - 1U) * sizeof(int16_t));
+  s->x[0] = x;
+
+  int32_t acc = 0;
+  for (uint32_t k = 0; k < d->nb; k++) {
+    acc = acc26(acc + (((int32_t)d->b[k] * s->x[k]) >> 8));
+  }
+  for (uint32_t j = 0; j < d->na; j++) {
+    acc = acc26(acc + (((int32_t)d->a[j] * s->y[j]) >> 8));
+  }
+
+  int16_t y = q15_sat((int32_t)(((int64_t)acc << d->r) >> 7));
+
+  if (d->na != 0U) {
+    memmove(&s->y[1], &s->y[0], (uint32_t)(d->na - 1U) * sizeof(int16_t));
+    s->y[0] = y;
+  }
+  return y;
+}
@@ -0,0 +1,75 @@
+/*
+ * fmac_design.h  - FIR / IIR filter designs quantized for the G4 FMAC
+ *
+ * Usage:
+ *   fmac_design_fir_lowpass()  -> windowed-sinc (Hamming) FIR
+ *   fmac_design_iir_lowpass()  -> 1st / 2nd order Butterworth, IIR direct form 1
+ *   fmac_design_notch()        -> biquad notch (RBJ)
+ *   fmac_ref_step()            -> C model of the FMAC fixed-point datapath,
+ *                                 used by "fmacset verify" and the host test
+ *
+ * 纯 C, 不依赖 HAL, 主机和固件共用同一份代码.
+ *
+ * FMAC 约定 (RM0440):
+ *   y[n] = 2^R * ( sum b[k]*x[n-k] + sum a[j]*y[n-j] )
+ *   注意 a[] 是 "加", 即标准形式的 -a; 系数都是 Q15, |c| 超出 1 的部分用 R 吸收.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef FMAC_DESIGN_H_
+#define FMAC_DESIGN_H_
+
+#include <stdint.h>
+
+#define FMAC_DESIGN_MAX_B        64U   /* 前馈系数 (P), FMAC 上限 127, 受 fmac_rt RAM 布局限制 */
+#define FMAC_DESIGN_MAX_A        2U    /* 反馈系数 (Q), 只做到 biquad */
+#define FMAC_DESIGN_MAX_R        7U
+
+typedef enum {
+  FMAC_DESIGN_FIR = 0,
+  FMAC_DESIGN_IIR
+} fmac_design_kind_t;
+
+typedef enum {
+  FMAC_DESIGN_OK           = 0,
+  FMAC_DESIGN_WARN_GAIN    = 1,    /* sum|b| > 1: 极端输入下输出会削顶 */
+  FMAC_DESIGN_ERR_ARG      = -1,   /* 截止频率/阶数/tap 数非法 */
+  FMAC_DESIGN_ERR_RANGE    = -2,   /* 系数需要 R > 7 */
+  FMAC_DESIGN_ERR_UNSTABLE = -3,   /* 量化后极点出单位圆 */
+  FMAC_DESIGN_ERR_ACC      = -4    /* 26-bit 累加器 (q4.22) 可能溢出 */
+} fmac_design_status_t;
+
+typedef struct {
+  fmac_design_kind_t kind;
+  uint8_t nb;                      /* P: b0..b[nb-1] */
+  uint8_t na;                      /* Q: a1..a[na], FIR 为 0 */
+  uint8_t r;                       /* R: 输出左移位数 */
+  int16_t b[FMAC_DESIGN_MAX_B];
+  int16_t a[FMAC_DESIGN_MAX_A];    /* FMAC 符号 (= -a_std) */
+} fmac_design_t;
+
+/* 参考模型状态: x[0]/y[0] 为最新 */
+typedef struct {
+  int16_t x[FMAC_DESIGN_MAX_B];
+  int16_t y[FMAC_DESIGN_MAX_A];
+} fmac_ref_t;
+
+fmac_design_status_t fmac_design_boxcar(fmac_design_t *d, uint8_t taps);
+fmac_design_status_t fmac_design_fir_lowpass(fmac_design_t *d, float fs, float fc, uint8_t taps);
+fmac_design_status_t fmac_design_iir_lowpass(fmac_design_t *d, float fs, float fc, uint8_t order);
+fmac_design_status_t fmac_design_notch(fmac_design_t *d, float fs, float f0, float q);
+
+const char *fmac_design_status_str(fmac_design_status_t st);
+
+/* 量化后的直流增益和群延迟 (样本, IIR 取直流处) */
+float fmac_design_dc_gain(const fmac_design_t *d);
+float fmac_design_group_delay(const fmac_design_t *d);
+
+/* FMAC 定点数据通路: q1.15 x q1.15 -> q2.30, 截掉 8 LSB 累加进 26-bit q4.22,
+ * 左移 R 后截到 q1.15 并饱和 (CLIPEN=1) */
+void fmac_ref_reset(fmac_ref_t *s);
+int16_t fmac_ref_step(fmac_ref_t *s, const fmac_design_t *d, int16_t x);
+
+#endif /* FMAC_DESIGN_H_ */
@@ -0,0 +1,322 @@
+/*
+ * fmac_mc.c  - Time-multiplexed FMAC FIR filtering for several feedback signals
+ *
+ * Architecture:
+ *   ADC1_2 ISR -> fmac_mc_run(in[]) -> for each channel:
+ *     PARAM=0, X1/X2/YBUFCFG <- 镜像      (切换窗口, 不走 HAL)
+ *     LOAD_X1 <- 最近 taps-1 个历史样本   (START 会复位 X1 指针, 历史必须重灌)
+ *     FIR     <- 新样本, 读 RDATA
+ *
+ * 系数常驻各自的 X2 窗口, 只在 fmac_mc_start()/fmac_mc_set_fir() 时装载.
+ * 每通道 ISR 开销约 taps+10 次总线写再加忙等 FMAC 算完, 3 通道 16/16/32 tap
+ * ≈ 300 cycles. 历史没法常驻: FMAC 一次只跑一个函数, 换通道必须停掉再 START,
+ * X1 指针随之复位. 所以这不是把 FIR "免费" 卸给 FMAC: CPU 用 SMLAD 两 tap 一条
+ * 算同样 64 个 tap 估计 150-200 cycles, 并不更贵. fmac_mc_verify 在同一输入上
+ * 两个都量 (CLI "fmacmc verify"), 以板上实测为准; FMAC 只在 tap 多, 或 CPU
+ * 那边要让出 CCM/总线时才划算.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "fmac_mc.h"
+#include "fmac_rt.h"
+#include "fmac_design.h"
+#include "hf_prof.h"
+#include "pwm_gov.h"
+#include "fmac.h"
+#include "main.h"
+#include "stm32g4xx_hal.h"
+#include <string.h>
+
+/* DWT 计数在 hf_prof_init() 里打开 */
+
+/* ── FMAC RAM 分区 ── */
+#define MC_X1_SIZE     (FMAC_MC_MAX_TAPS + 1U)
+#define MC_X2_SIZE     (FMAC_MC_MAX_TAPS)
+#define MC_Y_SIZE      2U
+#define MC_SLOT        (MC_X1_SIZE + MC_X2_SIZE + MC_Y_SIZE)   /* 67 */
+
+#if (MC_SLOT * FMAC_MC_CH_COUNT) > 256U
+#error "fmac_mc: FMAC RAM partition exceeds 256 words"
+#endif
+
+typedef struct {
+  uint32_t x1bufcfg;
+  uint32_t x2bufcfg;
+  uint32_t ybufcfg;
+  uint32_t param_load_x1;   /* START | LOAD_X1 | P=taps-1 */
+  uint32_t param_fir;       /* START | FIR     | P=taps */
+  uint8_t  taps;
+  uint8_t  pos;             /* hist[] 中最旧样本的位置 */
+  int16_t  hist[2U * FMAC_MC_MAX_TAPS];   /* 镜像双倍长度, 读取永远连续 */
+  int16_t  coeffs[FMAC_MC_MAX_TAPS];
+} fmac_mc_chan_t;
+
+static fmac_mc_chan_t mc_ch[FMAC_MC_CH_COUNT];
+static volatile uint8_t mc_active = 0U;
+
+volatile int16_t fmac_mc_in[FMAC_MC_CH_COUNT];
+volatile int16_t fmac_mc_out[FMAC_MC_CH_COUNT];
+volatile uint32_t fmac_mc_runs = 0U;
+
+/* 按通道号和 tap 数生成寄存器镜像 */
+static void mc_build_images(uint32_t k)
+{
+  fmac_mc_chan_t *c = &mc_ch[k];
+  uint32_t base = k * MC_SLOT;
+  uint32_t n = c->taps;
+
+  c->x1bufcfg = ((base) << FMAC_X1BUFCFG_X1_BASE_Pos)
+              | ((n + 1U) << FMAC_X1BUFCFG_X1_BUF_SIZE_Pos)
+              | FMAC_THRESHOLD_1;
+  c->x2bufcfg = ((base + MC_X1_SIZE) << FMAC_X2BUFCFG_X2_BASE_Pos)
+              | (n << FMAC_X2BUFCFG_X2_BUF_SIZE_Pos);
+  c->ybufcfg  = ((base + MC_X1_SIZE + MC_X2_SIZE) << FMAC_YBUFCFG_Y_BASE_Pos)
+              | (MC_Y_SIZE << FMAC_YBUFCFG_Y_BUF_SIZE_Pos)
+              | FMAC_THRESHOLD_1;
+  c->param_load_x1 = FMAC_PARAM_START | FMAC_FUNC_LOAD_X1 | ((n - 1U) << FMAC_PARAM_P_Pos);
+  c->param_fir     = FMAC_PARAM_START | FMAC_FUNC_CONVO_FIR | (n << FMAC_PARAM_P_Pos);
+}
+
+/* 把通道系数写进它的 X2 窗口 (非 ISR 路径) */
+static void mc_load_coeffs(uint32_t k)
+{
+  const fmac_mc_chan_t *c = &mc_ch[k];
+
+  FMAC->PARAM = 0U;
+  FMAC->X2BUFCFG = c->x2bufcfg;
+  FMAC->PARAM = FMAC_PARAM_START | FMAC_FUNC_LOAD_X2 | ((uint32_t)c->taps << FMAC_PARAM_P_Pos);
+  for (uint32_t i = 0; i < c->taps; i++) {
+    FMAC->WDATA = (uint32_t)(uint16_t)c->coeffs[i];
+  }
+  while ((FMAC->PARAM & FMAC_PARAM_START) != 0U) { }
+}
+
+static void mc_set_ma(uint32_t k, uint8_t taps)
+{
+  fmac_mc_chan_t *c = &mc_ch[k];
+  c->taps = taps;
+  for (uint32_t i = 0; i < taps; i++) {
+    c->coeffs[i] = (int16_t)(32768U / taps);
+  }
+  mc_build_images(k);
+}
+
+void fmac_mc_init(void)
+{
+  memset(mc_ch, 0, sizeof(mc_ch));
+  /* 默认: 电流 16-tap 移动平均, 母线电压 32-tap 移动平均 */
+  mc_set_ma(FMAC_MC_IA, 16U);
+  mc_set_ma(FMAC_MC_IB, 16U);
+  mc_set_ma(FMAC_MC_VBUS, 32U);
+  mc_active = 0U;
+}
+
+int fmac_mc_set_fir(fmac_mc_ch_t ch, const int16_t *b, uint8_t taps)
+{
+  if ((ch >= FMAC_MC_CH_COUNT) || (b == NULL) || (taps == 0U) ||
+      (taps > FMAC_MC_MAX_TAPS) || (mc_active != 0U)) {
+    return -1;
+  }
+
+  fmac_mc_chan_t *c = &mc_ch[ch];
+  c->taps = taps;
+  memcpy(c->coeffs, b, (uint32_t)taps * sizeof(int16_t));
+  memset(c->hist, 0, sizeof(c->hist));
+  c->pos = 0U;
+  mc_build_images(ch);
+  return 0;
+}
+
+/* 停掉 HAL 滤波, 装载全部系数窗口, 历史清零 */
+static void mc_load_all(void)
+{
+  (void)HAL_FMAC_FilterStop(&hfmac);
+  FMAC->CR = FMAC_CLIP_ENABLED;
+  for (uint32_t k = 0; k < FMAC_MC_CH_COUNT; k++) {
+    mc_load_coeffs(k);
+    memset(mc_ch[k].hist, 0, sizeof(mc_ch[k].hist));
+    mc_ch[k].pos = 0U;
+  }
+  fmac_mc_runs = 0U;
+}
+
+void fmac_mc_start(void)
+{
+  /* FMAC 只有一个, fmac_rt 的窗口会被覆盖 */
+  fmac_rt_set_active(0U);
+  mc_active = 0U;
+
+  mc_load_all();
+
+  /* 滤波器按 FOC 频率设计, 运行期间 pwm_gov 不切 profile */
+  pwm_gov_lock(PWM_GOV_LOCK_FMAC_MC, true);
+  __disable_irq();
+  mc_active = 1U;
+  __enable_irq();
+}
+
+void fmac_mc_stop(void)
+{
+  __disable_irq();
+  mc_active = 0U;
+  __enable_irq();
+  FMAC->PARAM = 0U;
+  pwm_gov_lock(PWM_GOV_LOCK_FMAC_MC, false);
+}
+
+uint8_t fmac_mc_is_active(void)
+{
+  return mc_active;
+}
+
+/* ──────────────────────────────────────────────────────────────────
+ *  fmac_mc_run — 在 ADC ISR 里调用, 必须快
+ *
+ *  只灌 taps-1 个历史: 灌满 taps 个时 FMAC 会立刻先吐一个旧输出
+ *  (fmacdbg 里看到的 hw[0] pipeline 零), 少一个则 FIR 等新样本才计算,
+ *  每通道恰好一进一出.
+ * ────────────────────────────────────────────────────────────────── */
+void fmac_mc_run(const int16_t in[FMAC_MC_CH_COUNT])
+{
+  for (uint32_t k = 0; k < FMAC_MC_CH_COUNT; k++) {
+    fmac_mc_chan_t *c = &mc_ch[k];
+    uint32_t n = c->taps;
+    const int16_t *h = &c->hist[c->pos];
+    int16_t x = in[k];
+
+    FMAC->PARAM    = 0U;
+    FMAC->X1BUFCFG = c->x1bufcfg;
+    FMAC->X2BUFCFG = c->x2bufcfg;
+    FMAC->YBUFCFG  = c->ybufcfg;
+
+    if (n > 1U) {
+      FMAC->PARAM = c->param_load_x1;
+      for (uint32_t i = 1U; i < n; i++) {
+        FMAC->WDATA = (uint32_t)(uint16_t)h[i];
+      }
+      while ((FMAC->PARAM & FMAC_PARAM_START) != 0U) { }
+    }
+
+    FMAC->PARAM = c->param_fir;
+    FMAC->WDATA = (uint32_t)(uint16_t)x;
+    while ((FMAC->SR & FMAC_SR_YEMPTY) != 0U) { }
+    fmac_mc_out[k] = (int16_t)(uint16_t)FMAC->RDATA;
+    fmac_mc_in[k]  = x;
+
+    /* 历史: 覆盖最旧, 镜像一份, 最旧位置前移 */
+    c->hist[c->pos]     = x;
+    c->hist[c->pos + n] = x;
+    c->pos = (uint8_t)((c->pos + 1U < n) ? (c->pos + 1U) : 0U);
+  }
+  FMAC->PARAM = 0U;
+  fmac_mc_runs++;
+}
+
+/* CPU 对照: x[] 由旧到新, brev[] 为倒序系数, 两 tap 一条 SMLAD.
+ * x 可能奇地址, M4 的 LDR 允许非对齐 */
+static int16_t mc_cpu_fir(const int16_t *x, const int16_t *brev, uint32_t n)
+{
+  int32_t acc = 0;
+  uint32_t i = 0U;
+  for (; (i + 1U) < n; i += 2U) {
+    uint32_t xx;
+    uint32_t bb;
+    memcpy(&xx, &x[i], sizeof(xx));
+    memcpy(&bb, &brev[i], sizeof(bb));
+    acc = (int32_t)__SMLAD(xx, bb, (uint32_t)acc);
+  }
+  if (i < n) {
+    acc += (int32_t)x[i] * (int32_t)brev[i];
+  }
+  return (int16_t)__SSAT(acc >> 15, 16);
+}
+
+/* ──────────────────────────────────────────────────────────────────
+ *  fmac_mc_verify — fmac_mc_run() vs fmac_ref_step() 逐通道逐样本比对
+ *
+ *  每个通道一条独立的伪随机输入 (LCG), 中间插满量程方波段测 clip.
+ *  参考模型用通道自己的系数 (FIR, R=0), 两边都从零历史开始,
+ *  窗口切换 + 历史重灌如果有错, 第一个 taps 样本之后就会不一致.
+ *  每次 run 之后, 同一段历史再用 mc_cpu_fir() 算一遍, 计 CPU 的周期数.
+ * ────────────────────────────────────────────────────────────────── */
+int32_t fmac_mc_verify(uint32_t n, int16_t *max_abs_diff, fmac_mc_cost_t *cpu)
+{
+  if ((mc_active != 0U) || (fmac_rt_is_active() != 0U)) {
+    return -1;
+  }
+
+  static fmac_design_t d[FMAC_MC_CH_COUNT];
+  static fmac_ref_t ref[FMAC_MC_CH_COUNT];
+  static int16_t brev[FMAC_MC_CH_COUNT][FMAC_MC_MAX_TAPS];
+  for (uint32_t k = 0; k < FMAC_MC_CH_COUNT; k++) {
+    memset(&d[k], 0, sizeof(d[k]));
+    d[k].kind = FMAC_DESIGN_FIR;
+    d[k].nb = mc_ch[k].taps;
+    memcpy(d[k].b, mc_ch[k].coeffs, (uint32_t)mc_ch[k].taps * sizeof(int16_t));
+    fmac_ref_reset(&ref[k]);
+    for (uint32_t i = 0; i < mc_ch[k].taps; i++) {
+      brev[k][i] = mc_ch[k].coeffs[mc_ch[k].taps - 1U - i];
+    }
+  }
+  mc_load_all();
+
+  uint32_t seed = 12345u;
+  int32_t mismatches = 0;
+  int32_t worst = 0;
+  int32_t cpu_worst = 0;
+  uint64_t cpu_sum = 0U;
+  uint32_t cpu_max = 0U;
+  int16_t in[FMAC_MC_CH_COUNT];
+  int16_t cpu_out[FMAC_MC_CH_COUNT];
+
+  for (uint32_t i = 0; i < n; i++) {
+    for (uint32_t k = 0; k < FMAC_MC_CH_COUNT; k++) {
+      seed = seed * 1664525u + 1013904223u;
+      in[k] = (int16_t)(seed >> 16);
+      if (((i + (k * 0x40U)) & 0x100U) != 0U) {
+        in[k] = (((i + k) & 0x80U) != 0U) ? 32767 : -32768;   /* 方波段: 测 clip */
+      }
+    }
+
+    HF_PROF_BEGIN(t_fmac_mc);
+    fmac_mc_run(in);
+    HF_PROF_END(HF_PROF_FMAC_MC, t_fmac_mc);
+
+    /* run 之后 hist[pos..pos+taps-1] 正是这次的窗口, 由旧到新 */
+    uint32_t t0 = DWT->CYCCNT;
+    for (uint32_t k = 0; k < FMAC_MC_CH_COUNT; k++) {
+      cpu_out[k] = mc_cpu_fir(&mc_ch[k].hist[mc_ch[k].pos], brev[k], mc_ch[k].taps);
+    }
+    uint32_t dt = DWT->CYCCNT - t0;
+    cpu_sum += dt;
+    if (dt > cpu_max) cpu_max = dt;
+
+    for (uint32_t k = 0; k < FMAC_MC_CH_COUNT; k++) {
+      int32_t diff = (int32_t)fmac_mc_out[k] - (int32_t)fmac_ref_step(&ref[k], &d[k], in[k]);
+      if (diff < 0) diff = -diff;
+      if (diff != 0) mismatches++;
+      if (diff > worst) worst = diff;
+      diff = (int32_t)cpu_out[k] - (int32_t)fmac_mc_out[k];
+      if (diff < 0) diff = -diff;
+      if (diff > cpu_worst) cpu_worst = diff;
+    }
+  }
+
+  /* 下一次 start 从零历史开始 */
+  for (uint32_t k = 0; k < FMAC_MC_CH_COUNT; k++) {
+    memset(mc_ch[k].hist, 0, sizeof(mc_ch[k].hist));
+    mc_ch[k].pos = 0U;
+  }
+  fmac_mc_runs = 0U;
+  if (max_abs_diff != NULL) {
+    *max_abs_diff = (int16_t)((worst > 32767) ? 32767 : worst);
+  }
+  if (cpu != NULL) {
+    cpu->cpu_avg = (n != 0U) ? (uint32_t)(cpu_sum / n) : 0U;
+    cpu->cpu_max = cpu_max;
+    cpu->cpu_max_diff = (int16_t)((cpu_worst > 32767) ? 32767 : cpu_worst);
+  }
+  return mismatches;
+}
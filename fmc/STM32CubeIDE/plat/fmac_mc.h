@@ -0,0 +1,71 @@
+/*
+ * fmac_mc.h  - Time-multiplexed FMAC FIR filtering for several feedback signals
+ *
+ * Usage:
+ *   fmac_mc_init()        -> call once after MX_FMAC_Init() (default coeffs)
+ *   fmac_mc_set_fir()     -> optional, replace one channel's coefficients
+ *   fmac_mc_start()       -> load all coefficient windows, enable the ISR hook
+ *   fmac_mc_run()         -> call from ADC ISR, filters every channel in one go
+ *   fmac_mc_stop()
+ *   fmac_mc_verify()      -> stopped only: every channel against fmac_ref_step(),
+ *                            plus the cost of the same FIR on the CPU
+ *
+ * FMAC RAM (256 words) 按通道分区, 每个通道独占一段 X1/X2/Y:
+ *   ch k: X1 @ k*67      (MAX_TAPS + 1)
+ *         X2 @ k*67 + 33 (MAX_TAPS)
+ *         Y  @ k*67 + 65 (2)
+ *   3 通道共 201 / 256.
+ *
+ * 和 fmac_rt 共用同一个 FMAC, 两者互斥 (start 时会停掉对方).
+ *
+ * 不是零开销: 每次切通道都要重灌历史, CPU 在 ISR 里写 WDATA 并忙等结果,
+ * 和 CPU 自己用 SMLAD 算同样的 FIR 是同一量级. 用 "fmacmc verify" 在板上
+ * 对比两者的周期数再决定用不用.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef FMAC_MC_H_
+#define FMAC_MC_H_
+
+#include <stdint.h>
+
+typedef enum {
+  FMAC_MC_IA = 0,     /* FOCVars.Iab.a, s16A */
+  FMAC_MC_IB,         /* FOCVars.Iab.b, s16A */
+  FMAC_MC_VBUS,       /* VBS LatestConv >> 1 (u16 → 正 Q15) */
+  FMAC_MC_CH_COUNT
+} fmac_mc_ch_t;
+
+#define FMAC_MC_MAX_TAPS         32U
+
+/* fmac_mc_verify 里 CPU 对照的开销: 同输入同系数的 Q15 FIR (SMLAD, 32-bit 累加),
+ * 3 通道一次; 和 FMAC 的差来自 FMAC 每个乘积先截 8 位 */
+typedef struct {
+  uint32_t cpu_avg;          /* cycles */
+  uint32_t cpu_max;
+  int16_t  cpu_max_diff;     /* max |cpu - fmac_mc_out| */
+} fmac_mc_cost_t;
+
+/* 最近一次 ISR 的输入/输出 (CLI 查看用) */
+extern volatile int16_t fmac_mc_in[FMAC_MC_CH_COUNT];
+extern volatile int16_t fmac_mc_out[FMAC_MC_CH_COUNT];
+extern volatile uint32_t fmac_mc_runs;
+
+void fmac_mc_init(void);
+/* 0 = ok, -1 = 参数非法或正在运行 */
+int fmac_mc_set_fir(fmac_mc_ch_t ch, const int16_t *b, uint8_t taps);
+void fmac_mc_start(void);
+void fmac_mc_stop(void);
+uint8_t fmac_mc_is_active(void);
+
+/* 在 ADC ISR 里调用: in[] 为各通道 Q15 输入, 结果写 fmac_mc_out[] */
+void fmac_mc_run(const int16_t in[FMAC_MC_CH_COUNT]);
+
+/* 用同一输入跑 n 次 fmac_mc_run() 和各通道的 fmac_ref_step(), 返回不一致的样本数
+ * (-1: fmac_mc 或 fmac_rt 正在用 FMAC). 每次 fmac_mc_run 的周期数记进 hf_prof 的
+ * HF_PROF_FMAC_MC, 和 ISR 里的开销同一口径; cpu 非 NULL 时填 CPU FIR 对照 */
+int32_t fmac_mc_verify(uint32_t n, int16_t *max_abs_diff, fmac_mc_cost_t *cpu);
+
+#endif /* FMAC_MC_H_ */
@@ -8,21 +8,31 @@
  * access (WDATA/RDATA) for minimal ISR latency - same principle as
  * CORDIC PURE benchmark (20 cyc/call vs HAL's 1327 cyc/call).
  *
+ * DMA mode:
+ *   JDR1 是左对齐无符号码 (adc<<4), FMAC 要 Q15 有符号; 转换是翻转 bit15.
+ *   ADC 硬件 offset 会同时改掉 MCSDK 的电流通道, 不能用, 所以 raw→Q15
+ *   在 DMA half/full 中断里按块做 (两样本一条 EOR), FIR 本身全由 FMAC+DMA 完成.
+ *
  *  Created on: 2026年2月
  *      Author: SYRLIST
  */
 
 #include "fmac_rt.h"
+#include "fmac_mc.h"
+#include "pwm_gov.h"
 #include "fmac.h"
 #include "main.h"
 #include "stm32g4xx_hal.h"
+#include "stm32g4xx_ll_dma.h"
+#include "stm32g4xx_ll_tim.h"
 #include <string.h>
 
 extern FMAC_HandleTypeDef hfmac;
 
-/* ── 滤波器系数 ── */
-static int16_t rt_coeffs[FMAC_RT_TAPS];
-static int16_t rt_preload_zeros[FMAC_RT_TAPS];
+/* ── 滤波器 (默认 16-tap boxcar, fmacset 可换) ── */
+static fmac_design_t rt_design;
+static int16_t rt_preload_zeros[FMAC_DESIGN_MAX_B];
+static uint32_t rt_settle = FMAC_RT_TAPS + 2U;
 
 /* ── 统计 ── */
 static volatile fmac_rt_stats_t stats;
@@ -32,47 +42,96 @@ static volatile uint8_t rt_active = 0U;
 volatile fmac_rt_sample_t fmac_rt_log[FMAC_RT_LOG_SIZE];
 volatile uint32_t fmac_rt_log_idx = 0;
 
+/* ── DMA 模式 (DMA1 Ch1/Ch2 已给 USART2) ── */
+#define RT_DMA_RAW_CH   LL_DMA_CHANNEL_3   /* TIM1_UP:   ADC1->JDR1  -> rt_dma_raw[] */
+#define RT_DMA_IN_CH    LL_DMA_CHANNEL_4   /* FMAC_WRITE: rt_dma_x[]  -> FMAC->WDATA */
+#define RT_DMA_OUT_CH   LL_DMA_CHANNEL_5   /* FMAC_READ:  FMAC->RDATA -> rt_dma_y[]  */
+#define RT_DMA_IRQ_PRIO 5U                 /* 低于所有 MCSDK 中断 */
+
+static volatile fmac_rt_mode_t rt_mode = FMAC_RT_MODE_ISR;
+static uint16_t rt_dma_raw[2U * FMAC_RT_DMA_BLOCK];
+static int16_t  rt_dma_x[2U * FMAC_RT_DMA_BLOCK];   /* 已转 Q15 的输入, 和 y 按半区对齐 */
+static int16_t  rt_dma_y[2U * FMAC_RT_DMA_BLOCK];
+static uint32_t rt_dma_fed = 0U;                    /* 已送进 FMAC 的块数 */
+static volatile uint32_t rt_dma_overrun = 0U;
+
 static void fmac_rt_configure_hw(void)
 {
+  const fmac_design_t *d = &rt_design;
+  uint32_t func = (d->kind == FMAC_DESIGN_IIR) ? FMAC_FUNC_IIR_DIRECT_FORM_1 : FMAC_FUNC_CONVO_FIR;
+
   FMAC_FilterConfigTypeDef cfg = {0};
   cfg.InputBaseAddress  = 0;
-  cfg.InputBufferSize   = FMAC_RT_TAPS + 2U;
+  cfg.InputBufferSize   = d->nb + 2U;
   cfg.InputThreshold    = FMAC_THRESHOLD_1;
-  cfg.CoeffBaseAddress  = FMAC_RT_TAPS + 2U;
-  cfg.CoeffBufferSize   = FMAC_RT_TAPS;
-  cfg.OutputBaseAddress = (2U * FMAC_RT_TAPS) + 2U;
-  cfg.OutputBufferSize  = 2;
+  cfg.CoeffBaseAddress  = d->nb + 2U;
+  cfg.CoeffBufferSize   = d->nb + d->na;
+  cfg.OutputBaseAddress = (2U * d->nb) + d->na + 2U;
+  cfg.OutputBufferSize  = d->na + 2U;
   cfg.OutputThreshold   = FMAC_THRESHOLD_1;
-  cfg.pCoeffA           = NULL;
-  cfg.CoeffASize        = 0;
-  cfg.pCoeffB           = rt_coeffs;
-  cfg.CoeffBSize        = FMAC_RT_TAPS;
-  cfg.Filter            = FMAC_FUNC_CONVO_FIR;
+  cfg.pCoeffA           = (d->na != 0U) ? (int16_t *)d->a : NULL;
+  cfg.CoeffASize        = d->na;
+  cfg.pCoeffB           = (int16_t *)d->b;
+  cfg.CoeffBSize        = d->nb;
+  cfg.Filter            = func;
   cfg.InputAccess       = FMAC_BUFFER_ACCESS_NONE;
   cfg.OutputAccess      = FMAC_BUFFER_ACCESS_NONE;
   cfg.Clip              = FMAC_CLIP_ENABLED;
-  cfg.P                 = FMAC_RT_TAPS;
-  cfg.Q                 = 0;
-  cfg.R                 = 0;
+  cfg.P                 = d->nb;
+  cfg.Q                 = d->na;
+  cfg.R                 = d->r;
 
   if (HAL_FMAC_FilterConfig(&hfmac, &cfg) != HAL_OK) {
     Error_Handler();
   }
 
-  if (HAL_FMAC_FilterPreload(&hfmac, rt_preload_zeros, FMAC_RT_TAPS, NULL, 0) != HAL_OK) {
+  /* 只预载 P-1 个零: 预载满 P 个会立刻多吐一个零输出, 输出永远滞后一拍 */
+  if (HAL_FMAC_FilterPreload(&hfmac, rt_preload_zeros, d->nb - 1U,
+                             (d->na != 0U) ? rt_preload_zeros : NULL, d->na) != HAL_OK) {
     Error_Handler();
   }
 
-  FMAC->PARAM = FMAC_PARAM_START | FMAC_FUNC_CONVO_FIR | (uint32_t)FMAC_RT_TAPS;
+  if (rt_mode == FMAC_RT_MODE_DMA) {
+    /* 阈值 1: X1 有空位就请求写, Y 有数据就请求读 */
+    FMAC->CR |= FMAC_CR_DMAREN | FMAC_CR_DMAWEN;
+  }
+
+  FMAC->PARAM = FMAC_PARAM_START | func | ((uint32_t)d->nb << FMAC_PARAM_P_Pos)
+              | ((uint32_t)d->na << FMAC_PARAM_Q_Pos) | ((uint32_t)d->r << FMAC_PARAM_R_Pos);
+}
+
+/* 一对 (raw, filt) 计入统计和 dump 环; ISR 模式逐样本, DMA 模式按块调用 */
+static inline void rt_account(int16_t raw_q15, int16_t filt_q15)
+{
+  /* Update stats (skip settle samples). */
+  stats.count++;
+  if (stats.count > rt_settle) {
+    stats.valid_count++;
+    stats.raw_sum   += raw_q15;
+    stats.filt_sum  += filt_q15;
+    stats.raw_sq_sum  += (int64_t)raw_q15 * raw_q15;
+    stats.filt_sq_sum += (int64_t)filt_q15 * filt_q15;
+
+    if (raw_q15 < stats.raw_min)   stats.raw_min = raw_q15;
+    if (raw_q15 > stats.raw_max)   stats.raw_max = raw_q15;
+    if (filt_q15 < stats.filt_min) stats.filt_min = filt_q15;
+    if (filt_q15 > stats.filt_max) stats.filt_max = filt_q15;
+  }
+
+  /* ── 存入环形缓冲区 ── */
+  uint32_t idx = fmac_rt_log_idx % FMAC_RT_LOG_SIZE;
+  fmac_rt_log[idx].raw  = raw_q15;
+  fmac_rt_log[idx].filt = filt_q15;
+  fmac_rt_log_idx++;
 }
 
 /* ──────────────────────────────────────────────────────────────────
  *  FMAC 内部 RAM 分配 (256 × 16-bit words):
  *
- *    X1 (input/delay):  addr 0,   size = TAPS + 2 = 18
- *    X2 (coefficients): addr 18,  size = TAPS     = 16
- *    Y  (output):       addr 34,  size = 2
- *    Total: 36 / 256
+ *    X1 (input/delay):  addr 0,        size = P + 2
+ *    X2 (coefficients): addr P+2,      size = P + Q   (b0..bP-1, a1..aQ)
+ *    Y  (output):       addr 2P+Q+2,   size = Q + 2
+ *    默认 P=16, Q=0: 36 / 256;  最大 P=64, Q=2: 136 / 256
  *
  *  16-tap 移动平均: 每个系数 = 1/16 in Q15 = 2048
  * ────────────────────────────────────────────────────────────────── */
@@ -80,14 +139,18 @@ static void fmac_rt_configure_hw(void)
 void fmac_rt_init(void)
 {
   /* 16-tap moving average: each coeff = 32768/16 = 2048 (Q15) */
-  for (uint32_t i = 0; i < FMAC_RT_TAPS; i++) {
-    rt_coeffs[i] = 2048;
-  }
+  (void)fmac_design_boxcar(&rt_design, FMAC_RT_TAPS);
+  rt_settle = FMAC_RT_TAPS + 2U;
   memset(rt_preload_zeros, 0, sizeof(rt_preload_zeros));
   fmac_rt_reset_stats();
   fmac_rt_log_idx = 0U;
   rt_active = 0U;
   fmac_rt_configure_hw();
+
+  HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, RT_DMA_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+  HAL_NVIC_SetPriority(DMA1_Channel5_IRQn, RT_DMA_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel5_IRQn);
 }
 
 /* ──────────────────────────────────────────────────────────────────
@@ -118,32 +181,142 @@ int16_t fmac_rt_feed(uint16_t adc_raw)
   /* 读滤波结果 */
   int16_t filt_q15 = (int16_t)(uint16_t)FMAC->RDATA;
 
-  /* Update stats (skip settle samples). */
-  stats.count++;
-  if (stats.count > FMAC_RT_SETTLE_SAMPLES) {
-    stats.valid_count++;
-    stats.raw_sum   += raw_q15;
-    stats.filt_sum  += filt_q15;
-    stats.raw_sq_sum  += (int64_t)raw_q15 * raw_q15;
-    stats.filt_sq_sum += (int64_t)filt_q15 * filt_q15;
+  rt_account(raw_q15, filt_q15);
 
-    if (raw_q15 < stats.raw_min)   stats.raw_min = raw_q15;
-    if (raw_q15 > stats.raw_max)   stats.raw_max = raw_q15;
-    if (filt_q15 < stats.filt_min) stats.filt_min = filt_q15;
-    if (filt_q15 > stats.filt_max) stats.filt_max = filt_q15;
+  return filt_q15;
+}
+
+/* ──────────────────────────────────────────────────────────────────
+ *  DMA 链
+ *
+ *  TIM1 RCR=1 → 每个 PWM 周期一次 UEV (下溢), 此时本周期的注入转换
+ *  早已完成, JDR1 和 ISR 模式下 fmac_rt_feed() 看到的是同一个样本.
+ *
+ *  x/y 半区严格对齐: 第 k 个送进 FMAC 的块放在 x[(k&1)*B],
+ *  FMAC 一进一出, 它的输出正好落在 y 的同一半区.
+ * ────────────────────────────────────────────────────────────────── */
+static void rt_dma_stop(void)
+{
+  LL_TIM_DisableDMAReq_UPDATE(TIM1);
+  LL_DMA_DisableChannel(DMA1, RT_DMA_RAW_CH);
+  LL_DMA_DisableChannel(DMA1, RT_DMA_IN_CH);
+  LL_DMA_DisableChannel(DMA1, RT_DMA_OUT_CH);
+  FMAC->CR &= ~(FMAC_CR_DMAREN | FMAC_CR_DMAWEN);
+  LL_DMA_ClearFlag_GI3(DMA1);
+  LL_DMA_ClearFlag_GI4(DMA1);
+  LL_DMA_ClearFlag_GI5(DMA1);
+}
+
+static void rt_dma_start(void)
+{
+  rt_dma_stop();
+  rt_dma_fed = 0U;
+
+  /* Ch5: FMAC Y → rt_dma_y[], 先于输入开启, 避免 Y 满阻塞 FMAC */
+  LL_DMA_ConfigTransfer(DMA1, RT_DMA_OUT_CH,
+                        LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_MODE_CIRCULAR |
+                        LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                        LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_HALFWORD |
+                        LL_DMA_PRIORITY_MEDIUM);
+  LL_DMA_SetPeriphRequest(DMA1, RT_DMA_OUT_CH, LL_DMAMUX_REQ_FMAC_READ);
+  LL_DMA_ConfigAddresses(DMA1, RT_DMA_OUT_CH, (uint32_t)&FMAC->RDATA,
+                         (uint32_t)rt_dma_y, LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+  LL_DMA_SetDataLength(DMA1, RT_DMA_OUT_CH, 2U * FMAC_RT_DMA_BLOCK);
+  LL_DMA_EnableIT_HT(DMA1, RT_DMA_OUT_CH);
+  LL_DMA_EnableIT_TC(DMA1, RT_DMA_OUT_CH);
+
+  /* Ch4: rt_dma_x[half] → FMAC X1, 每块重新装填 (normal) */
+  LL_DMA_ConfigTransfer(DMA1, RT_DMA_IN_CH,
+                        LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_NORMAL |
+                        LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                        LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_HALFWORD |
+                        LL_DMA_PRIORITY_MEDIUM);
+  LL_DMA_SetPeriphRequest(DMA1, RT_DMA_IN_CH, LL_DMAMUX_REQ_FMAC_WRITE);
+  LL_DMA_SetPeriphAddress(DMA1, RT_DMA_IN_CH, (uint32_t)&FMAC->WDATA);
+
+  /* Ch3: TIM1 UEV 触发, JDR1 → rt_dma_raw[] */
+  LL_DMA_ConfigTransfer(DMA1, RT_DMA_RAW_CH,
+                        LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_MODE_CIRCULAR |
+                        LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+                        LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_HALFWORD |
+                        LL_DMA_PRIORITY_LOW);
+  LL_DMA_SetPeriphRequest(DMA1, RT_DMA_RAW_CH, LL_DMAMUX_REQ_TIM1_UP);
+  LL_DMA_ConfigAddresses(DMA1, RT_DMA_RAW_CH, (uint32_t)&ADC1->JDR1,
+                         (uint32_t)rt_dma_raw, LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
+  LL_DMA_SetDataLength(DMA1, RT_DMA_RAW_CH, 2U * FMAC_RT_DMA_BLOCK);
+  LL_DMA_EnableIT_HT(DMA1, RT_DMA_RAW_CH);
+  LL_DMA_EnableIT_TC(DMA1, RT_DMA_RAW_CH);
+
+  FMAC->CR |= FMAC_CR_DMAREN | FMAC_CR_DMAWEN;
+  LL_DMA_EnableChannel(DMA1, RT_DMA_OUT_CH);
+  LL_DMA_EnableChannel(DMA1, RT_DMA_RAW_CH);
+  LL_TIM_EnableDMAReq_UPDATE(TIM1);
+}
+
+void fmac_rt_dma_raw_irq(void)
+{
+  const uint16_t *raw;
+  if (LL_DMA_IsActiveFlag_HT3(DMA1) != 0U) {
+    LL_DMA_ClearFlag_HT3(DMA1);
+    raw = &rt_dma_raw[0];
+  } else if (LL_DMA_IsActiveFlag_TC3(DMA1) != 0U) {
+    LL_DMA_ClearFlag_TC3(DMA1);
+    raw = &rt_dma_raw[FMAC_RT_DMA_BLOCK];
+  } else {
+    return;
   }
 
-  /* ── 存入环形缓冲区 ── */
-  uint32_t idx = fmac_rt_log_idx % FMAC_RT_LOG_SIZE;
-  fmac_rt_log[idx].raw  = raw_q15;
-  fmac_rt_log[idx].filt = filt_q15;
-  fmac_rt_log_idx++;
+  /* 上一块还在往 FMAC 写 (正常 ~1k 周期就写完, 块间隔 2 ms): 丢弃本块 */
+  if ((LL_DMA_IsEnabledChannel(DMA1, RT_DMA_IN_CH) != 0U) &&
+      (LL_DMA_GetDataLength(DMA1, RT_DMA_IN_CH) != 0U)) {
+    rt_dma_overrun++;
+    return;
+  }
 
-  return filt_q15;
+  /* adc<<4 → (adc-2048)<<4 就是翻转 bit15, 两个样本一起做 */
+  int16_t *x = &rt_dma_x[(rt_dma_fed & 1U) * FMAC_RT_DMA_BLOCK];
+  const uint32_t *src = (const uint32_t *)raw;
+  uint32_t *dst = (uint32_t *)x;
+  for (uint32_t i = 0; i < (FMAC_RT_DMA_BLOCK / 2U); i++) {
+    dst[i] = src[i] ^ 0x80008000u;
+  }
+
+  LL_DMA_DisableChannel(DMA1, RT_DMA_IN_CH);
+  LL_DMA_ClearFlag_GI4(DMA1);
+  LL_DMA_SetMemoryAddress(DMA1, RT_DMA_IN_CH, (uint32_t)x);
+  LL_DMA_SetDataLength(DMA1, RT_DMA_IN_CH, FMAC_RT_DMA_BLOCK);
+  LL_DMA_EnableChannel(DMA1, RT_DMA_IN_CH);
+  rt_dma_fed++;
+}
+
+void fmac_rt_dma_out_irq(void)
+{
+  uint32_t half;
+  if (LL_DMA_IsActiveFlag_HT5(DMA1) != 0U) {
+    LL_DMA_ClearFlag_HT5(DMA1);
+    half = 0U;
+  } else if (LL_DMA_IsActiveFlag_TC5(DMA1) != 0U) {
+    LL_DMA_ClearFlag_TC5(DMA1);
+    half = 1U;
+  } else {
+    return;
+  }
+
+  const int16_t *x = &rt_dma_x[half * FMAC_RT_DMA_BLOCK];
+  const int16_t *y = &rt_dma_y[half * FMAC_RT_DMA_BLOCK];
+  for (uint32_t i = 0; i < FMAC_RT_DMA_BLOCK; i++) {
+    rt_account(x[i], y[i]);
+  }
+}
+
+uint32_t fmac_rt_dma_overruns(void)
+{
+  return rt_dma_overrun;
 }
 
 void fmac_rt_restart(void)
 {
+  rt_dma_stop();
   (void)HAL_FMAC_FilterStop(&hfmac);
   fmac_rt_configure_hw();
 }
@@ -162,6 +335,7 @@ void fmac_rt_reset_stats(void)
   __disable_irq();
   memset((void*)&stats, 0, sizeof(stats));
   fmac_rt_log_idx = 0U;
+  rt_dma_overrun = 0U;
   stats.raw_min  =  32767;
   stats.raw_max  = -32768;
   stats.filt_min =  32767;
@@ -171,12 +345,117 @@ void fmac_rt_reset_stats(void)
 
 void fmac_rt_set_active(uint8_t active)
 {
+  /* 系数按当前 FOC 频率设计: 运行期间不让 pwm_gov 切 profile */
+  if (active != 0U) {
+    pwm_gov_lock(PWM_GOV_LOCK_FMAC_RT, true);
+  }
+
+  if (rt_mode == FMAC_RT_MODE_DMA) {
+    if (active != 0U) {
+      rt_dma_start();
+    } else {
+      rt_dma_stop();
+    }
+  }
+
   __disable_irq();
   rt_active = (active != 0U) ? 1U : 0U;
   __enable_irq();
+
+  if (active == 0U) {
+    pwm_gov_lock(PWM_GOV_LOCK_FMAC_RT, false);
+  }
 }
 
 uint8_t fmac_rt_is_active(void)
 {
   return rt_active;
 }
+
+void fmac_rt_set_mode(fmac_rt_mode_t mode)
+{
+  if (rt_active != 0U) {
+    return;
+  }
+  rt_mode = mode;
+}
+
+fmac_rt_mode_t fmac_rt_get_mode(void)
+{
+  return rt_mode;
+}
+
+float fmac_rt_fs_hz(void)
+{
+  return (float)pwm_gov_rate_hz();
+}
+
+int fmac_rt_load_design(const fmac_design_t *d)
+{
+  /* fmac_mc 运行时 FMAC 的窗口和系数都是它的 */
+  if ((rt_active != 0U) || (fmac_mc_is_active() != 0U) || (d == NULL) || (d->nb < 2U) || (d->nb > FMAC_DESIGN_MAX_B) ||
+      (d->na > FMAC_DESIGN_MAX_A)) {
+    return -1;
+  }
+  rt_design = *d;
+  rt_settle = (d->kind == FMAC_DESIGN_IIR) ? FMAC_RT_IIR_SETTLE : ((uint32_t)d->nb + 2U);
+  return 0;
+}
+
+const fmac_design_t *fmac_rt_get_design(void)
+{
+  return &rt_design;
+}
+
+uint32_t fmac_rt_settle_samples(void)
+{
+  return rt_settle;
+}
+
+/* ──────────────────────────────────────────────────────────────────
+ *  fmac_rt_verify — 硬件 vs fmac_ref_step() 逐样本比对
+ *
+ *  输入: 伪随机 (LCG) 叠加满量程方波, 覆盖饱和/符号边界.
+ *  两边都从零状态开始, 结果应当 bit-exact (diff = 0).
+ * ────────────────────────────────────────────────────────────────── */
+int32_t fmac_rt_verify(uint32_t n, int16_t *max_abs_diff)
+{
+  if ((rt_active != 0U) || (fmac_mc_is_active() != 0U)) {
+    return -1;
+  }
+
+  fmac_rt_mode_t mode = rt_mode;
+  rt_mode = FMAC_RT_MODE_ISR;
+  fmac_rt_restart();
+
+  fmac_ref_t ref;
+  fmac_ref_reset(&ref);
+  uint32_t seed = 12345u;
+  int32_t mismatches = 0;
+  int32_t worst = 0;
+
+  for (uint32_t i = 0; i < n; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    int16_t x = (int16_t)(seed >> 16);
+    if ((i & 0x100U) != 0U) {
+      x = ((i & 0x80U) != 0U) ? 32767 : -32768;   /* 方波段: 测 clip */
+    }
+
+    FMAC->WDATA = (uint32_t)(uint16_t)x;
+    while (FMAC->SR & FMAC_SR_YEMPTY) { }
+    int16_t hw = (int16_t)(uint16_t)FMAC->RDATA;
+    int16_t sw = fmac_ref_step(&ref, &rt_design, x);
+
+    int32_t d = (int32_t)hw - (int32_t)sw;
+    if (d < 0) d = -d;
+    if (d != 0) mismatches++;
+    if (d > worst) worst = d;
+  }
+
+  rt_mode = mode;
+  fmac_rt_restart();
+  if (max_abs_diff != NULL) {
+    *max_abs_diff = (int16_t)((worst > 32767) ? 32767 : worst);
+  }
+  return mismatches;
+}
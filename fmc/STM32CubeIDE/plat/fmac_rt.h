@@ -4,18 +4,35 @@
  * Usage:
  *   fmac_rt_init()       -> call once after MX_FMAC_Init()
  *   fmac_rt_restart()    -> clear FMAC delay line before a capture session
- *   fmac_rt_feed()       -> call from ADC ISR
+ *   fmac_rt_feed()       -> call from ADC ISR (FMAC_RT_MODE_ISR only)
  *   fmac_rt_get_stats()  -> fetch current statistics snapshot
+ *   fmac_rt_load_design() -> swap in a FIR/IIR design (inactive, fmac_mc stopped)
+ *
+ * DMA mode (fmac_rt_set_mode(FMAC_RT_MODE_DMA) before restart/set_active):
+ *   TIM1_UP  --DMA1_Ch3-->  rt_dma_raw[]  (JDR1, circular, HT/TC IRQ)
+ *   rt_dma_x[] --DMA1_Ch4--> FMAC->WDATA   (one block per HT/TC)
+ *   FMAC->RDATA --DMA1_Ch5--> rt_dma_y[]   (circular, HT/TC IRQ -> stats/log)
+ *   ADC1_2 ISR 里不再有任何 FIR 开销.
  */
 
 #ifndef FMAC_RT_H_
 #define FMAC_RT_H_
 
 #include <stdint.h>
+#include "fmac_design.h"
 
 /* Filter parameters */
-#define FMAC_RT_TAPS             16U
-#define FMAC_RT_SETTLE_SAMPLES   (FMAC_RT_TAPS + 2U)
+#define FMAC_RT_TAPS             16U          /* 默认 boxcar 长度 */
+#define FMAC_RT_IIR_SETTLE       256U         /* IIR 统计前跳过的样本数 */
+
+/* 数据通路 */
+typedef enum {
+  FMAC_RT_MODE_ISR = 0,   /* ADC ISR 里逐样本 fmac_rt_feed() */
+  FMAC_RT_MODE_DMA        /* DMA 链: ADC→FMAC→内存, 按块统计 */
+} fmac_rt_mode_t;
+
+/* DMA 模式下 half/full-transfer 的块大小 (样本), 16 kHz 下约 2 ms */
+#define FMAC_RT_DMA_BLOCK        32U
 
 /* 统计数据 */
 typedef struct {
@@ -39,12 +56,33 @@ void fmac_rt_restart(void);
  * 在 ADC ISR 里调用, 必须快 */
 int16_t fmac_rt_feed(uint16_t adc_raw);
 
+/* 采样率 = 当前 FOC 执行频率 (ADC1_2 ISR 和 TIM1_UP 都随 RCR 抽取), pwm_gov 切 profile 会变;
+ * fmacset fir/iir/notch 按设计时的值算系数 */
+float fmac_rt_fs_hz(void);
+
+/* 换滤波器: 捕获进行中或 fmac_mc 占着 FMAC 返回 -1; 之后需要 fmac_rt_restart() (adcstart 会做) */
+int fmac_rt_load_design(const fmac_design_t *d);
+const fmac_design_t *fmac_rt_get_design(void);
+uint32_t fmac_rt_settle_samples(void);
+
+/* 用同一输入喂硬件和 fmac_ref_step(), 返回不一致的样本数 (-1: 捕获进行中或 fmac_mc 占着 FMAC) */
+int32_t fmac_rt_verify(uint32_t n, int16_t *max_abs_diff);
+
 /* 获取/重置统计 */
 fmac_rt_stats_t fmac_rt_get_stats(void);
 void fmac_rt_reset_stats(void);
 void fmac_rt_set_active(uint8_t active);
 uint8_t fmac_rt_is_active(void);
 
+/* 模式切换只在 inactive 时生效, 之后需要 fmac_rt_restart() */
+void fmac_rt_set_mode(fmac_rt_mode_t mode);
+fmac_rt_mode_t fmac_rt_get_mode(void);
+
+/* DMA 模式中断入口 (DMA1_Channel3 / DMA1_Channel5 IRQHandler) */
+void fmac_rt_dma_raw_irq(void);
+void fmac_rt_dma_out_irq(void);
+uint32_t fmac_rt_dma_overruns(void);
+
 /* 采样环形缓冲区 (给 CLI dump 用) */
 #define FMAC_RT_LOG_SIZE  256
 typedef struct {
@@ -0,0 +1,102 @@
+/*
+ * hf_prof.c  - DWT cycle profiler for the ADC1_2 high-frequency ISR
+ *
+ * Architecture:
+ *   ADC1_2_IRQHandler -> HF_PROF_BEGIN/END per stage -> hf_prof (ISR-owned)
+ *   CLI "hfprof"      -> hf_prof_snapshot() (IRQ off, memcpy)  -> print
+ *
+ * Deadline margin:
+ *   R3_2_WriteTIMRegisters() reports MC_DURATION once the TIM1 update
+ *   interrupt has re-armed TRGO, i.e. the new CCRs missed the update event
+ *   at counter underflow (center-aligned, RCR=1). So right after
+ *   FOC_CurrControllerMx() the remaining budget is the distance from CNT to
+ *   the next underflow: CNT ticks when counting down, 2*ARR-CNT when up.
+ *   Each motor is measured on its own timer (M1: TIM1, M2: TIM8).
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "hf_prof.h"
+#include "main.h"
+#include "mc_type.h"
+#include "parameters_conversion.h"
+#include <string.h>
+
+#ifndef HF_PROF_PWM_TIM
+#define HF_PROF_PWM_TIM          TIM1
+#endif
+#ifndef HF_PROF_PWM_TIM_M2
+#define HF_PROF_PWM_TIM_M2       TIM8
+#endif
+
+/* 定时器 tick -> CPU 周期 (G474: 两者都是 170 MHz, 比例 1:1) */
+#define HF_PROF_CPU_MHZ          (SYSCLK_FREQ / 1000000uL)
+
+hf_prof_t hf_prof;
+volatile uint8_t hf_prof_reset_req = 0U;
+
+void hf_prof_clear(void)
+{
+  memset(&hf_prof, 0, sizeof(hf_prof));
+  for (uint32_t i = 0; i < HF_PROF_STAGE_COUNT; i++) {
+    hf_prof.stage[i].min = 0xFFFFFFFFu;
+  }
+  for (uint32_t m = 0; m < HF_PROF_MOTORS; m++) {
+    hf_prof.margin[m].min = 0xFFFFFFFFu;
+  }
+  hf_prof_reset_req = 0U;
+}
+
+void hf_prof_init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  hf_prof_clear();
+}
+
+void hf_prof_request_reset(void)
+{
+  /* 不在 CLI 上下文里直接清, 避免和 ISR 的读-改-写交错 */
+  hf_prof_reset_req = 1U;
+}
+
+void hf_prof_snapshot(hf_prof_t *out)
+{
+  __disable_irq();
+  memcpy(out, &hf_prof, sizeof(*out));
+  __enable_irq();
+}
+
+uint32_t hf_prof_budget_cycles(void)
+{
+  /* 按 TIM1 实际设置算: 中心对齐一个 PWM 周期 2*ARR tick, 每 (RCR+1)/2 个周期一次 HF,
+     pwm_gov 切换 profile 后预算跟着变 */
+  uint32_t arr = HF_PROF_PWM_TIM->ARR;
+  if (arr == 0U) {
+    return (uint32_t)(SYSCLK_FREQ / (uint32_t)ISR_FREQUENCY_HZ);
+  }
+  uint32_t ticks = arr * (HF_PROF_PWM_TIM->RCR + 1U);
+  return (ticks * HF_PROF_CPU_MHZ) / (uint32_t)ADV_TIM_CLK_MHz;
+}
+
+void hf_prof_mark_deadline(uint8_t motor, uint16_t foc_ret)
+{
+  hf_prof_margin_t *mg = &hf_prof.margin[(motor < HF_PROF_MOTORS) ? motor : 0U];
+
+  if (foc_ret == MC_DURATION) {
+    mg->duration_faults++;
+    return;
+  }
+
+  TIM_TypeDef *tim = (motor == 0U) ? HF_PROF_PWM_TIM : HF_PROF_PWM_TIM_M2;
+  uint32_t cnt = tim->CNT;
+  uint32_t arr = tim->ARR;
+  uint32_t ticks = ((tim->CR1 & TIM_CR1_DIR) != 0U) ? cnt : ((2U * arr) - cnt);
+  uint32_t cyc = (ticks * HF_PROF_CPU_MHZ) / (uint32_t)ADV_TIM_CLK_MHz;
+
+  mg->count++;
+  mg->sum += cyc;
+  if (cyc < mg->min) mg->min = cyc;
+  if (cyc > mg->max) mg->max = cyc;
+}
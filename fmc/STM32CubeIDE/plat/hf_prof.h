@@ -0,0 +1,116 @@
+/*
+ * hf_prof.h  - DWT cycle profiler for the ADC1_2 high-frequency ISR
+ *
+ * Usage:
+ *   hf_prof_init()                  -> call once after cli_init() (enables DWT)
+ *   HF_PROF_BEGIN(t) / HF_PROF_END(stage, t)
+ *                                   -> wrap a stage inside the ISR
+ *   HF_PROF_DEADLINE(motor, ret)    -> right after FOC_CurrControllerMx()
+ *   hf_prof_snapshot()              -> CLI side, consistent copy of all stats
+ *   hf_prof_request_reset()         -> CLI side, cleared on the next ISR entry
+ *
+ * 编译时定义 HF_PROF_ENABLE=0 可把所有打点宏编译成空, 零开销.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef HF_PROF_H_
+#define HF_PROF_H_
+
+#include <stdint.h>
+#include "stm32g4xx.h"
+
+#ifndef HF_PROF_ENABLE
+#define HF_PROF_ENABLE           1
+#endif
+
+/* 被测阶段 */
+typedef enum {
+  HF_PROF_RCM_READ = 0,   /* RCM_ReadOngoingConv (RCM_USE_DMA=0) */
+  HF_PROF_RCM_EXEC,       /* RCM_ExecNextConv    (RCM_USE_DMA=0) */
+  HF_PROF_CURR_CTRL,      /* FOC_CurrControllerM1  */
+  HF_PROF_STO_PLL,        /* STO_PLL_CalcElAngle(M1) */
+  HF_PROF_MCPA_LOG,       /* MCPA_dataLog          */
+  HF_PROF_FMAC_FEED,      /* fmac_rt_feed          */
+  HF_PROF_FMAC_MC,        /* fmac_mc_run (3 通道)   */
+  HF_PROF_HF_M1,          /* FOC_HighFrequencyTask(M1) */
+  HF_PROF_HF_M2,          /* FOC_HighFrequencyTask(M2), NBR_OF_MOTORS=2 */
+  HF_PROF_CURR_CTRL_M2,   /* FOC_CurrControllerM2  */
+  HF_PROF_STO_PLL_M2,     /* STO_PLL_CalcElAngle(M2) */
+  HF_PROF_ISR_TOTAL,      /* ADC1_2_IRQHandler 整体 */
+  HF_PROF_STAGE_COUNT
+} hf_prof_stage_t;
+
+/* 截止余量按电机分开统计: M1 对应 TIM1, M2 对应 TIM8 */
+#define HF_PROF_MOTORS           2U
+
+/* log2 直方图: bin k 统计 [2^(k-1), 2^k) 周期, bin 0 为 0 周期, 最后一格兜底 */
+#define HF_PROF_HIST_BINS        16U
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;           /* 累加 (算均值) */
+  uint32_t hist[HF_PROF_HIST_BINS];
+} hf_prof_stat_t;
+
+/* 距下一个 PWM 更新事件 (MC_DURATION 截止点) 剩余的 CPU 周期 */
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t duration_faults;   /* FOC_CurrControllerMx 返回 MC_DURATION 的次数 */
+} hf_prof_margin_t;
+
+typedef struct {
+  hf_prof_stat_t stage[HF_PROF_STAGE_COUNT];
+  hf_prof_margin_t margin[HF_PROF_MOTORS];
+} hf_prof_t;
+
+/* 只在 ISR 里写; CLI 通过 hf_prof_snapshot() 读 */
+extern hf_prof_t hf_prof;
+extern volatile uint8_t hf_prof_reset_req;
+
+void hf_prof_init(void);
+void hf_prof_clear(void);
+void hf_prof_request_reset(void);
+void hf_prof_snapshot(hf_prof_t *out);
+void hf_prof_mark_deadline(uint8_t motor, uint16_t foc_ret);
+
+/* 每个 FOC 周期的 CPU 周期预算 (按 TIM1 ARR/RCR) */
+uint32_t hf_prof_budget_cycles(void);
+
+static inline uint32_t hf_prof_hist_bin(uint32_t cyc)
+{
+  uint32_t bin = 32U - __CLZ(cyc);
+  return (bin < HF_PROF_HIST_BINS) ? bin : (HF_PROF_HIST_BINS - 1U);
+}
+
+/* ISR 里调用, 必须快: 无除法, 无分支预测敏感的循环 */
+static inline void hf_prof_record(hf_prof_stage_t s, uint32_t cyc)
+{
+  hf_prof_stat_t *st = &hf_prof.stage[s];
+  st->count++;
+  st->sum += cyc;
+  if (cyc < st->min) st->min = cyc;
+  if (cyc > st->max) st->max = cyc;
+  st->hist[hf_prof_hist_bin(cyc)]++;
+}
+
+#if HF_PROF_ENABLE
+#define HF_PROF_BEGIN(t)          uint32_t t = DWT->CYCCNT
+#define HF_PROF_END(stage, t)     hf_prof_record((stage), DWT->CYCCNT - (t))
+#define HF_PROF_ISR_ENTER(t)      do { if (hf_prof_reset_req != 0U) { hf_prof_clear(); } } while (0); \
+                                  HF_PROF_BEGIN(t)
+#define HF_PROF_DEADLINE(m, ret)  hf_prof_mark_deadline((m), (ret))
+#else
+#define HF_PROF_BEGIN(t)
+#define HF_PROF_END(stage, t)     ((void)0)
+#define HF_PROF_ISR_ENTER(t)
+#define HF_PROF_DEADLINE(m, ret)  ((void)0)
+#endif
+
+#endif /* HF_PROF_H_ */
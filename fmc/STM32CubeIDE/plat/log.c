@@ -6,6 +6,8 @@
  */
 #include "log.h"
 #include "bsp_uart.h"
+#include "obs_cap.h"
+#include "fault_rec.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -28,3 +30,103 @@ void log_printf(const char *fmt, ...)
   bsp_uart_write((const uint8_t*)buf, (size_t)n);
 }
 
+
+/* ── 二进制日志出口 ──
+ * 一条记录一行: "#B:" + 每字 8 位 hex, 主机 blog_decode 认这个前缀,
+ * 其它行原样透传. 丢记录时先发一行 "#D:<累计丢弃数>". */
+#define LOG_POLL_MAX_REC   8U      /* 每次最多发几条, 不霸占主循环 */
+#define LOG_LINE_MAX       (4U + 8U * BLOG_MAX_REC_WORDS + 3U)
+
+/* 观测器 trace: 一条记录一行 "#O:" + 16 字节 (内存顺序) 的 hex, 主机 obs_replay 认 */
+#define OBS_LINE_MAX       (3U + 2U * sizeof(obs_cap_rec_t) + 2U)
+
+static void log_poll_obs(void)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  for (uint32_t n = 0; n < LOG_POLL_MAX_REC; n++) {
+    if (bsp_uart_tx_pending() + OBS_LINE_MAX > BSP_UART_TX_RING) return;
+
+    obs_cap_rec_t rec;
+    if (obs_cap_read(&rec, 1U) == 0U) return;
+
+    const uint8_t *b = (const uint8_t *)&rec;
+    char line[OBS_LINE_MAX];
+    uint32_t k = 0;
+    line[k++] = '#'; line[k++] = 'O'; line[k++] = ':';
+    for (uint32_t i = 0; i < sizeof(rec); i++) {
+      line[k++] = hex[b[i] >> 4];
+      line[k++] = hex[b[i] & 0xFU];
+    }
+    line[k++] = '\r';
+    line[k++] = '\n';
+    bsp_uart_write((const uint8_t *)line, k);
+  }
+}
+
+/* 故障窗口: "#FH:" + 头, 然后每条记录一行 "#F:" + 24 字节 hex, 主机 frec_decode 认 */
+#define FREC_LINE_MAX      (4U + 2U * sizeof(fault_rec_rec_t) + 2U)
+
+static void log_poll_frec(void)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  for (uint32_t n = 0; n < LOG_POLL_MAX_REC; n++) {
+    if (bsp_uart_tx_pending() + FREC_LINE_MAX > BSP_UART_TX_RING) return;
+
+    fault_rec_hdr_t hdr;
+    fault_rec_rec_t rec;
+    const uint32_t what = fault_rec_dump_next(&hdr, &rec);
+    if (what == 0U) return;
+
+    const uint8_t *b = (what == 1U) ? (const uint8_t *)&hdr : (const uint8_t *)&rec;
+    const uint32_t len = (what == 1U) ? sizeof(hdr) : sizeof(rec);
+    char line[FREC_LINE_MAX];
+    uint32_t k = 0;
+    line[k++] = '#'; line[k++] = 'F';
+    if (what == 1U) line[k++] = 'H';
+    line[k++] = ':';
+    for (uint32_t i = 0; i < len; i++) {
+      line[k++] = hex[b[i] >> 4];
+      line[k++] = hex[b[i] & 0xFU];
+    }
+    line[k++] = '\r';
+    line[k++] = '\n';
+    bsp_uart_write((const uint8_t *)line, k);
+  }
+}
+
+void log_poll(void)
+{
+  static const char hex[] = "0123456789abcdef";
+  uint32_t dropped;
+
+  log_poll_obs();
+  log_poll_frec();
+
+  if (blog_drops_unreported(&dropped) != 0U) {
+    if (bsp_uart_tx_pending() + 24U > BSP_UART_TX_RING) return;
+    blog_drops_reported(dropped);
+    log_printf("#D:%lu\r\n", (unsigned long)dropped);
+  }
+
+  for (uint32_t n = 0; n < LOG_POLL_MAX_REC; n++) {
+    if (bsp_uart_tx_pending() + LOG_LINE_MAX > BSP_UART_TX_RING) return;   /* 等 DMA 发 */
+
+    uint32_t rec[BLOG_MAX_REC_WORDS];
+    uint32_t len = blog_read(rec, BLOG_MAX_REC_WORDS);
+    if (len == 0U) return;
+
+    char line[LOG_LINE_MAX];
+    uint32_t k = 0;
+    line[k++] = '#'; line[k++] = 'B'; line[k++] = ':';
+    for (uint32_t i = 0; i < len; i++) {
+      for (int sh = 28; sh >= 0; sh -= 4) {
+        line[k++] = hex[(rec[i] >> sh) & 0xFU];
+      }
+    }
+    line[k++] = '\r';
+    line[k++] = '\n';
+    bsp_uart_write((const uint8_t *)line, k);
+  }
+}
@@ -9,14 +9,32 @@
 #define LOG_H_
 #pragma once
 #include <stdarg.h>
+#include "blog.h"
+
+// LOG_BINARY=1: LOGI/LOGW/LOGE 也走二进制 ring (只存格式串 ID + 参数),
+// 文本由主机 blog_decode 按 ELF 还原. 默认 0, 保持 CLI 文本输出.
+// BLOGI/BLOGW/BLOGE 不受影响, 总是二进制, ISR 里只能用它们.
+#ifndef LOG_BINARY
+#define LOG_BINARY 0
+#endif
 
 void log_init(void);
 void log_printf(const char *fmt, ...);
 
+// 主循环调用: 把二进制记录以 "#B:" + hex 行, 观测器 trace 以 "#O:" 行
+// 发到串口 (UART ring 有空间时)
+void log_poll(void);
+
+#if LOG_BINARY
+#define LOGI(...) BLOGI(__VA_ARGS__)
+#define LOGW(...) BLOGW(__VA_ARGS__)
+#define LOGE(...) BLOGE(__VA_ARGS__)
+#else
 // 先给三个级别，后面再扩展
 #define LOGI(...) do { log_printf("[I] " __VA_ARGS__); log_printf("\r\n"); } while(0)
 #define LOGW(...) do { log_printf("[W] " __VA_ARGS__); log_printf("\r\n"); } while(0)
 #define LOGE(...) do { log_printf("[E] " __VA_ARGS__); log_printf("\r\n"); } while(0)
+#endif
 
 
 #endif /* LOG_H_ */
@@ -0,0 +1,147 @@
+/*
+ * obs_cap.c  - Per-HF-tick capture of the speed/position observer inputs
+ *
+ * Architecture:
+ *   FOC_HighFrequencyTask -> OBS_CAP_HF -> obs_cap_hf()  -> ring (生产者)
+ *   log_poll (主循环)     -> obs_cap_read() -> "#O:" hex 行 (消费者)
+ *
+ * 生产者只有 ADC1_2 中断一个, 消费者只有主循环一个: head 只由中断写,
+ * tail 只由主循环写, 不用关中断. 录制参数 (n / stream) 只在 armed=0 时改.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "obs_cap.h"
+#include "mc_config.h"
+#include <string.h>
+
+#if (OBS_CAP_RECORDS & (OBS_CAP_RECORDS - 1U)) != 0U
+#error "obs_cap: OBS_CAP_RECORDS must be a power of 2"
+#endif
+
+#define CAP_MASK       (OBS_CAP_RECORDS - 1U)
+
+/* 调试器也可以直接把它整块读出来 */
+obs_cap_rec_t obs_cap_ring[OBS_CAP_RECORDS];
+
+volatile uint8_t obs_cap_armed = 0U;
+
+static volatile uint32_t cap_head;        /* 中断写 */
+static volatile uint32_t cap_tail;        /* 主循环写 */
+static uint32_t cap_left;                 /* 还要录几条, 0 = 不限 (stream) */
+static uint8_t  cap_stream;
+static uint8_t  cap_gap;
+static int16_t (*cap_ref)(void);
+static obs_cap_stats_t cap_stats;
+
+void obs_cap_start(uint32_t n, uint8_t stream)
+{
+  obs_cap_armed = 0U;
+  cap_head = 0U;
+  cap_tail = 0U;
+  cap_gap = 0U;
+  cap_stream = (stream != 0U) ? 1U : 0U;
+  if ((cap_stream == 0U) && ((n == 0U) || (n > OBS_CAP_RECORDS))) {
+    n = OBS_CAP_RECORDS;
+  }
+  cap_left = n;
+  memset(&cap_stats, 0, sizeof(cap_stats));
+  obs_cap_armed = 1U;
+}
+
+void obs_cap_stop(void)
+{
+  obs_cap_armed = 0U;
+}
+
+void obs_cap_set_ref(int16_t (*ref)(void))
+{
+  cap_ref = ref;
+}
+
+void obs_cap_hf(alphabeta_t v_ab, bool acc_reached)
+{
+  const uint32_t head = cap_head;
+  const uint32_t used = head - cap_tail;
+
+  if (used >= OBS_CAP_RECORDS) {
+    if (cap_stream == 0U) {
+      obs_cap_armed = 0U;           /* RAM 模式: 满了就是录完了 */
+    } else {
+      cap_stats.dropped++;
+      cap_gap = 1U;
+    }
+    return;
+  }
+
+  const MCI_State_t state = Mci[M1].State;
+  uint8_t flags = 0U;
+  /* 和 FOC_HighFrequencyTask 里调用 STO_PLL_CalcElAngle 的条件一致 */
+  if ((IDLE != state) && (FAULT_NOW != state) && (FAULT_OVER != state)) {
+    flags |= OBS_CAP_F_RUN;
+  }
+  if (!acc_reached) {
+    flags |= OBS_CAP_F_RESET;
+  }
+  if (STO_PLL_M1.hForcedDirection != 0) {
+    flags |= OBS_CAP_F_DIR_SET;
+    if (STO_PLL_M1.hForcedDirection < 0) {
+      flags |= OBS_CAP_F_DIR_NEG;
+    }
+  }
+  if (cap_gap != 0U) {
+    flags |= OBS_CAP_F_GAP;
+    cap_gap = 0U;
+    cap_stats.gaps++;
+  }
+
+  obs_cap_rec_t *r = &obs_cap_ring[head & CAP_MASK];
+  r->i_alpha = FOCVars[M1].Ialphabeta.alpha;
+  r->i_beta = FOCVars[M1].Ialphabeta.beta;
+  r->v_alpha = v_ab.alpha;
+  r->v_beta = v_ab.beta;
+  r->vbus = VBS_GetAvBusVoltage_d(&(BusVoltageSensor_M1._Super));
+  if (cap_ref != NULL) {
+    r->ref_angle = cap_ref();
+    flags |= OBS_CAP_F_REF_EXT;
+  } else {
+    r->ref_angle = FOCVars[M1].hElAngle;
+  }
+  r->obs_angle = STO_PLL_M1._Super.hElAngle;
+  r->state = (uint8_t)state;
+  r->flags = flags;
+
+  cap_head = head + 1U;             /* 记录写完再发布 */
+  cap_stats.written++;
+  if ((used + 1U) > cap_stats.max_used) {
+    cap_stats.max_used = used + 1U;
+  }
+  if ((cap_left != 0U) && (--cap_left == 0U)) {
+    obs_cap_armed = 0U;
+  }
+}
+
+uint32_t obs_cap_read(obs_cap_rec_t *rec, uint32_t max)
+{
+  if ((cap_stream == 0U) && (obs_cap_armed != 0U)) {
+    return 0U;                      /* RAM 模式录完再发 */
+  }
+  uint32_t tail = cap_tail;
+  uint32_t n = cap_head - tail;
+  if (n > max) {
+    n = max;
+  }
+  for (uint32_t i = 0U; i < n; i++) {
+    rec[i] = obs_cap_ring[(tail + i) & CAP_MASK];
+  }
+  cap_tail = tail + n;
+  return n;
+}
+
+void obs_cap_get_stats(obs_cap_stats_t *out)
+{
+  *out = cap_stats;
+  out->armed = obs_cap_armed;
+  out->stream = cap_stream;
+}
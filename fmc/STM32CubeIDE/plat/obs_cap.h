@@ -0,0 +1,90 @@
+/*
+ * obs_cap.h  - Per-HF-tick capture of the speed/position observer inputs
+ *
+ * Usage:
+ *   obs_cap_start(n, stream)       -> CLI "cap start", 从下一个 HF 周期开始录
+ *   OBS_CAP_HF(v_ab, acc_reached)  -> FOC_HighFrequencyTask, STO_PLL 之后
+ *   obs_cap_read(rec, max)         -> 主循环取记录 (log_poll 发 "#O:" 行)
+ *   host: obs_replay trace         -> 记录喂给 STO_PLL / STO_CORDIC, 比角度误差
+ *
+ * 每个 HF 周期一条 16 字节记录, 内容就是 STO_PLL_CalcElAngle 这一拍看到的输入,
+ * 外加重放需要的控制流 (观测器有没有跑, 有没有 STO_ResetPLL, 方向, MCI 状态).
+ * 主机按记录顺序重放 FOC_HighFrequencyTask 里的观测器调用, 从电机启动前开始录
+ * 的 trace 上, STO_PLL 的重放角度和 obs_angle 逐拍一致.
+ *
+ * 两种模式共用一个 SPSC ring:
+ *   RAM:    录满 n 条 (或 ring 满) 停, 停了才放给主循环发, 录制期间串口不动
+ *   stream: 边录边发, ring 满就丢, 丢过之后的第一条带 OBS_CAP_F_GAP.
+ *           16 kHz x 16 B 远超串口带宽, 实际得到的是一段段连续的窗口
+ *
+ * 编译时定义 OBS_CAP_ENABLE=0 可把 OBS_CAP_HF 编译成空.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef OBS_CAP_H_
+#define OBS_CAP_H_
+
+#include <stdint.h>
+#include "mc_type.h"
+
+#ifndef OBS_CAP_ENABLE
+#define OBS_CAP_ENABLE           1
+#endif
+
+/* ring 记录数, 2 的幂; 512 条 = 8 KB = 16 kHz 下 32 ms */
+#ifndef OBS_CAP_RECORDS
+#define OBS_CAP_RECORDS          512U
+#endif
+
+#define OBS_CAP_F_RUN            0x01U   /* 这一拍调用了 STO_PLL_CalcElAngle */
+#define OBS_CAP_F_RESET          0x02U   /* 这一拍之后 STO_ResetPLL (加速段未到) */
+#define OBS_CAP_F_DIR_SET        0x04U   /* hForcedDirection != 0 */
+#define OBS_CAP_F_DIR_NEG        0x08U   /* hForcedDirection < 0 */
+#define OBS_CAP_F_GAP            0x10U   /* 之前丢过记录, 和上一条不连续 */
+#define OBS_CAP_F_REF_EXT        0x20U   /* ref_angle 来自 obs_cap_set_ref 的钩子 */
+
+/* 小端, 16 字节, 主机 trace 文件里原样保存 */
+typedef struct {
+  int16_t  i_alpha;       /* STO 输入电流 = FOCVars.Ialphabeta (本拍) */
+  int16_t  i_beta;
+  int16_t  v_alpha;       /* STO 输入电压 = FOCVars.Valphabeta (上一拍的输出) */
+  int16_t  v_beta;
+  uint16_t vbus;          /* VBS_GetAvBusVoltage_d */
+  int16_t  ref_angle;     /* 参考角: 默认 FOCVars.hElAngle, 或钩子 (编码器/仿真真值) */
+  int16_t  obs_angle;     /* 本拍之后 STO_PLL 的 hElAngle */
+  uint8_t  state;         /* Mci[M1].State */
+  uint8_t  flags;         /* OBS_CAP_F_* */
+} obs_cap_rec_t;
+
+typedef struct {
+  uint32_t written;       /* 写进 ring 的记录数 */
+  uint32_t dropped;       /* stream 模式 ring 满丢掉的 */
+  uint32_t gaps;          /* 不连续的次数 */
+  uint32_t max_used;      /* ring 占用高水位 */
+  uint8_t  armed;         /* 正在录 */
+  uint8_t  stream;
+} obs_cap_stats_t;
+
+/* n = 0: RAM 模式录满 ring, stream 模式一直录到 obs_cap_stop() */
+void obs_cap_start(uint32_t n, uint8_t stream);
+void obs_cap_stop(void);
+/* 参考角钩子, 在 HF 中断里调用; NULL 恢复 FOCVars.hElAngle */
+void obs_cap_set_ref(int16_t (*ref)(void));
+
+/* 取最多 max 条记录, 返回条数. 只能单消费者调用; RAM 模式录完之前返回 0 */
+uint32_t obs_cap_read(obs_cap_rec_t *rec, uint32_t max);
+void obs_cap_get_stats(obs_cap_stats_t *out);
+
+/* HF 中断里调用, 只在录制时进来 */
+extern volatile uint8_t obs_cap_armed;
+void obs_cap_hf(alphabeta_t v_ab, bool acc_reached);
+
+#if OBS_CAP_ENABLE
+#define OBS_CAP_HF(v_ab, acc_reached)  do { if (obs_cap_armed != 0U) { obs_cap_hf((v_ab), (acc_reached)); } } while (0)
+#else
+#define OBS_CAP_HF(v_ab, acc_reached)  ((void)0)
+#endif
+
+#endif /* OBS_CAP_H_ */
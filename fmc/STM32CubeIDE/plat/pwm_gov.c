@@ -0,0 +1,305 @@
+/*
+ * pwm_gov.c  - PWM 频率 / FOC 抽取率调速器
+ *
+ * Architecture:
+ *   ADC1_2 ISR: TSK_HighFrequencyTask
+ *     PWM_GOV_HF_ENTER -> pending 非空时先 pwm_gov_apply_pending()
+ *     PWM_GOV_HF_EXIT  -> pwm_gov_hf_record(本次 HF 周期数)
+ *   SysTick: MC_RunMotorControlTasks 中频节拍
+ *     pwm_gov_step()   -> 取走窗口最大值, 算负载, 选目标 profile
+ *                         IDLE: 关中断直接应用; RUN: 置 pending 交给 HF 任务
+ *
+ * 切换时的换算 (旧执行频率 fo, 新执行频率 fn):
+ *   - dpp 量 (每个 FOC 周期的电角度增量) x fo/fn: Speed_Buffer[], DppBufferSum,
+ *     hElSpeedDpp, InstantaneousElSpeedDpp, PLL 积分项
+ *   - 观测器 hC1..hC5 换表 (F1/F2 不变, 估计状态不用缩放)
+ *   - 电流环积分项是电压, 不变; 只换 Ki
+ *   - HF 斜坡按步数计时: 剩余 N 步 (N-1 次增量 + 最后一步置终值) 换成
+ *     (N-1) x fn/fo + 1 步, 步长按剩余差值重算, 剩余时长不变
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "pwm_gov.h"
+#include "main.h"
+#include "mc_type.h"
+#include "mc_math.h"
+#include "mc_config.h"
+#include "mc_config_common.h"
+#include "mc_interface.h"
+#include "parameters_conversion.h"
+
+#define PWM_GOV_RATE(pwm, rep)   ((uint16_t)((2UL * (pwm)) / ((rep) + 1UL)))
+#define PWM_GOV_PERIOD(pwm)      ((uint16_t)(((uint32_t)ADV_TIM_CLK_MHz * 1000000UL / (uint32_t)(pwm)) & 0xFFFEUL))
+
+/* 标称值 x num/den, 四舍五入; 比例为 1 时原样返回标称值 */
+#define PWM_GOV_SCALE(v, num, den) \
+  ((int16_t)(((double)(v) * (double)(num) / (double)(den)) + (((v) < 0) ? -0.5 : 0.5)))
+
+/* 观测器误差动态 (归一化到 F1/F2): a = C1/F1, g1 = C2/F1, c = C3/F1, g2 = C4/F2
+ *   z^2 - s z + p = 0,  s = 2 - a + g1,  p = 1 - a + g1 + c g2
+ * C1/C3/C5 是模型项, 按 Ts 换算是对的; C2/C4 (GAIN1/GAIN2) 是 workbench 在标称
+ * 频率下配的极点. 标称值 |g1| > 1, 按 Ts 线性放大到 8 kHz 后电流误差极点跑出单位圆,
+ * 所以抽取 2 倍的 profile 改成保持连续域极点: z -> z^2, 即 s' = s^2 - 2p, p' = p^2 */
+#define PWM_GOV_OBS_A            ((double)C1 / (double)F1)
+#define PWM_GOV_OBS_G1           ((double)C2 / (double)F1)
+#define PWM_GOV_OBS_C            ((double)C3 / (double)F1)
+#define PWM_GOV_OBS_G2           ((double)C4 / (double)F2)
+#define PWM_GOV_OBS_S            (2.0 - PWM_GOV_OBS_A + PWM_GOV_OBS_G1)
+#define PWM_GOV_OBS_P            (1.0 - PWM_GOV_OBS_A + PWM_GOV_OBS_G1 + (PWM_GOV_OBS_C * PWM_GOV_OBS_G2))
+#define PWM_GOV_OBS_S2           ((PWM_GOV_OBS_S * PWM_GOV_OBS_S) - (2.0 * PWM_GOV_OBS_P))
+#define PWM_GOV_OBS_P2           (PWM_GOV_OBS_P * PWM_GOV_OBS_P)
+#define PWM_GOV_C2_X2            PWM_GOV_SCALE((PWM_GOV_OBS_S2 - 2.0 + (2.0 * PWM_GOV_OBS_A)) * F1, 1, 1)
+#define PWM_GOV_C4_X2            PWM_GOV_SCALE((PWM_GOV_OBS_P2 - PWM_GOV_OBS_S2 + 1.0) * F2 / (2.0 * PWM_GOV_OBS_C), 1, 1)
+
+/* 按 Ts 线性换算的观测器增益 (P0 / P1) */
+#define PWM_GOV_C2_TS(hz, rc)    PWM_GOV_SCALE(C2, TF_REGULATION_RATE, PWM_GOV_RATE(hz, rc))
+#define PWM_GOV_C4_TS(hz, rc)    PWM_GOV_SCALE(C4, TF_REGULATION_RATE, PWM_GOV_RATE(hz, rc))
+
+/* 观测器模型项 ∝ 1/rate, PLL Kp ∝ Ts, PLL Ki ∝ Ts^2, 电流环 Ki ∝ Ts */
+#define PWM_GOV_PROFILE(hz, rc, g1, g2)                                                        \
+  {                                                                                            \
+    .pwm_hz  = (hz),                                                                           \
+    .rate_hz = PWM_GOV_RATE(hz, rc),                                                           \
+    .period  = PWM_GOV_PERIOD(hz),                                                             \
+    .rep     = (rc),                                                                           \
+    .c1      = PWM_GOV_SCALE(C1, TF_REGULATION_RATE, PWM_GOV_RATE(hz, rc)),                    \
+    .c2      = (g1),                                                                           \
+    .c3      = PWM_GOV_SCALE(C3, TF_REGULATION_RATE, PWM_GOV_RATE(hz, rc)),                    \
+    .c4      = (g2),                                                                           \
+    .c5      = PWM_GOV_SCALE(C5, TF_REGULATION_RATE, PWM_GOV_RATE(hz, rc)),                    \
+    .pll_kp  = PWM_GOV_SCALE(PLL_KP_GAIN, TF_REGULATION_RATE, PWM_GOV_RATE(hz, rc)),           \
+    .pll_ki  = PWM_GOV_SCALE(PLL_KI_GAIN, (double)TF_REGULATION_RATE * TF_REGULATION_RATE,     \
+                             (double)PWM_GOV_RATE(hz, rc) * PWM_GOV_RATE(hz, rc)),             \
+    .iq_ki   = PWM_GOV_SCALE(PID_TORQUE_KI_DEFAULT, TF_REGULATION_RATE, PWM_GOV_RATE(hz, rc)), \
+    .id_ki   = PWM_GOV_SCALE(PID_FLUX_KI_DEFAULT, TF_REGULATION_RATE, PWM_GOV_RATE(hz, rc)),   \
+  }
+
+/* 下标越大越慢. F1/F2 各 profile 相同 (C5 在 8 kHz 为标称的 2 倍, 仍在 int16 内) */
+const pwm_gov_profile_t pwm_gov_profiles[PWM_GOV_PROFILES] = {
+  PWM_GOV_PROFILE(20000UL, 1U, PWM_GOV_C2_TS(20000UL, 1U), PWM_GOV_C4_TS(20000UL, 1U)),
+  PWM_GOV_PROFILE(PWM_FREQUENCY, REP_COUNTER, C2, C4),
+  PWM_GOV_PROFILE(PWM_FREQUENCY, 3U, PWM_GOV_C2_X2, PWM_GOV_C4_X2),
+};
+
+volatile uint8_t pwm_gov_pending = PWM_GOV_NONE;
+
+/* HF 任务写, 中频任务在关中断时取走 */
+static volatile uint32_t win_max;
+static volatile uint32_t win_n;
+
+static pwm_gov_status_t gov;
+static volatile uint8_t gov_locks;      /* 主循环写, 中频/HF 任务读 */
+static uint16_t over_cnt;
+static uint16_t under_cnt;
+static bool low_speed;
+
+static int32_t scale_rate(int32_t v, uint32_t from_hz, uint32_t to_hz)
+{
+  return (int32_t)(((int64_t)v * (int64_t)from_hz) / (int64_t)to_hz);
+}
+
+static void apply_profile(uint8_t idx)
+{
+  const pwm_gov_profile_t *op = &pwm_gov_profiles[gov.active];
+  const pwm_gov_profile_t *np = &pwm_gov_profiles[idx];
+  STO_PLL_Handle_t *sto = &STO_PLL_M1;
+
+  /* 定时器: ARR 开预装载, 新周期和本次 HF 任务写的 CCR 在同一个更新事件生效; RCR 本来就有影子寄存器 */
+  LL_TIM_EnableARRPreload(TIM1);
+  LL_TIM_SetAutoReload(TIM1, (uint32_t)np->period / 2U);
+  LL_TIM_SetRepetitionCounter(TIM1, np->rep);
+  PWM_Handle_M1._Super.PWMperiod = np->period;
+  PWM_Handle_M1._Super.hT_Sqrt3 = (uint16_t)(((uint32_t)np->period * SQRT3FACTOR) / 16384U);
+  PWM_Handle_M1.Half_PWMPeriod = np->period / 2U;
+
+  /* dpp 量按执行频率换算 */
+  for (uint32_t i = 0U; i < (sizeof(sto->Speed_Buffer) / sizeof(sto->Speed_Buffer[0])); i++) {
+    sto->Speed_Buffer[i] = (int16_t)scale_rate(sto->Speed_Buffer[i], op->rate_hz, np->rate_hz);
+  }
+  sto->DppBufferSum = scale_rate(sto->DppBufferSum, op->rate_hz, np->rate_hz);
+  sto->SpeedBufferOldestEl = (int16_t)scale_rate(sto->SpeedBufferOldestEl, op->rate_hz, np->rate_hz);
+  sto->_Super.hElSpeedDpp = (int16_t)scale_rate(sto->_Super.hElSpeedDpp, op->rate_hz, np->rate_hz);
+  sto->_Super.InstantaneousElSpeedDpp =
+    (int16_t)scale_rate(sto->_Super.InstantaneousElSpeedDpp, op->rate_hz, np->rate_hz);
+  sto->PIRegulator.wIntegralTerm = scale_rate(sto->PIRegulator.wIntegralTerm, op->rate_hz, np->rate_hz);
+  sto->_Super.hMeasurementFrequency = (uint16_t)(np->rate_hz / PWM_FREQ_SCALING);
+  VirtualSpeedSensorM1._Super.hMeasurementFrequency = (uint16_t)(np->rate_hz / PWM_FREQ_SCALING);
+
+  /* 观测器常数换表; F1/F2 不变, 估计状态和 hF3/hC6 不用动 */
+  sto->hC1 = np->c1;
+  sto->hC2 = np->c2;
+  sto->hC3 = np->c3;
+  sto->hC4 = np->c4;
+  sto->hC5 = np->c5;
+
+  PID_SetKP(&sto->PIRegulator, np->pll_kp);
+  PID_SetKI(&sto->PIRegulator, np->pll_ki);
+  PID_SetKI(&PIDIqHandle_M1, np->iq_ki);
+  PID_SetKI(&PIDIdHandle_M1, np->id_ki);
+
+  /* HF 斜坡还没走完: 剩余时长不变 */
+  RampExtMngr_Handle_t *rmp = &RampExtMngrHFParamsM1;
+  if (rmp->RampRemainingStep > 1U) {
+    const uint32_t steps =
+      (uint32_t)scale_rate((int32_t)(rmp->RampRemainingStep - 1U), np->rate_hz, op->rate_hz) + 1U;
+    rmp->IncDecAmount = ((rmp->TargetFinal * (int32_t)rmp->ScalingFactor) - rmp->Ext) / (int32_t)steps;
+    rmp->RampRemainingStep = steps;
+  }
+  rmp->FrequencyHz = np->rate_hz;
+
+  gov.active = idx;
+  gov.switches++;
+}
+
+void pwm_gov_init(void)
+{
+  gov.mode = PWM_GOV_OFF;
+  gov.active = PWM_GOV_NOMINAL;
+  gov.floor = 0U;
+  gov.fixed = PWM_GOV_NOMINAL;
+  gov.switches = 0U;
+  gov.load_pct = 0U;
+  gov.hf_max = 0U;
+  gov.hf_peak = 0U;
+  over_cnt = 0U;
+  under_cnt = 0U;
+  low_speed = true;
+  win_max = 0U;
+  win_n = 0U;
+  pwm_gov_pending = PWM_GOV_NONE;
+#if PWM_GOV_ENABLE
+  /* HF_PROF_ENABLE=0 时也要有 CYCCNT */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+void pwm_gov_hf_record(uint32_t cyc)
+{
+  if (cyc > win_max) {
+    win_max = cyc;
+  }
+  win_n++;
+}
+
+void pwm_gov_apply_pending(void)
+{
+  const uint8_t idx = pwm_gov_pending;
+
+  if ((idx < PWM_GOV_PROFILES) && (0U == gov_locks)) {
+    apply_profile(idx);
+  }
+  pwm_gov_pending = PWM_GOV_NONE;
+}
+
+uint32_t pwm_gov_budget_cycles(uint8_t profile)
+{
+  return (uint32_t)(SYSCLK_FREQ / pwm_gov_profiles[profile].rate_hz);
+}
+
+uint32_t pwm_gov_rate_hz(void)
+{
+  return pwm_gov_profiles[gov.active].rate_hz;
+}
+
+/* AUTO: 速度选 P0/P1, 负载下限 floor 只能让它更慢 */
+static uint8_t auto_target(MCI_State_t state, uint32_t hf_max, uint32_t hf_n)
+{
+  if (hf_n != 0U) {
+    if (gov.load_pct >= PWM_GOV_LOAD_HIGH_PCT) {
+      under_cnt = 0U;
+      if ((++over_cnt >= PWM_GOV_DOWN_HOLD) && (gov.floor < (PWM_GOV_PROFILES - 1U))) {
+        gov.floor++;
+        over_cnt = 0U;
+      }
+    } else {
+      over_cnt = 0U;
+      /* HF 任务的周期数和执行频率基本无关: 快一级的负载 = 同样周期数 / 更小的预算 */
+      if ((gov.floor > 0U)
+          && (((uint64_t)hf_max * 100U) < ((uint64_t)PWM_GOV_LOAD_LOW_PCT * pwm_gov_budget_cycles(gov.floor - 1U)))) {
+        if (++under_cnt >= PWM_GOV_UP_HOLD) {
+          gov.floor--;
+          under_cnt = 0U;
+        }
+      } else {
+        under_cnt = 0U;
+      }
+    }
+  }
+
+  int32_t speed = 0;
+  if (RUN == state) {
+    speed = SPD_GetAvrgMecSpeedUnit(&STO_PLL_M1._Super);
+    speed = (speed < 0) ? -speed : speed;
+  }
+  const int32_t thr = low_speed ? (PWM_GOV_LOW_SPEED_RPM + PWM_GOV_SPEED_HYST_RPM)
+                                : (PWM_GOV_LOW_SPEED_RPM - PWM_GOV_SPEED_HYST_RPM);
+  low_speed = (speed < ((thr * (int32_t)SPEED_UNIT) / (int32_t)U_RPM));
+
+  const uint8_t want = low_speed ? 0U : PWM_GOV_NOMINAL;
+  return (want > gov.floor) ? want : gov.floor;
+}
+
+void pwm_gov_step(void)
+{
+  __disable_irq();
+  const uint32_t hf_max = win_max;
+  const uint32_t hf_n = win_n;
+  win_max = 0U;
+  win_n = 0U;
+  __enable_irq();
+
+  if (hf_n != 0U) {
+    gov.hf_max = hf_max;
+    gov.load_pct = (uint32_t)(((uint64_t)hf_max * 100U) / pwm_gov_budget_cycles(gov.active));
+    if (hf_max > gov.hf_peak) {
+      gov.hf_peak = hf_max;
+    }
+  }
+
+  if ((PWM_GOV_OFF == gov.mode) || (pwm_gov_pending != PWM_GOV_NONE)) {
+    return;
+  }
+  const MCI_State_t state = MCI_GetSTMState(&Mci[M1]);
+  if ((state != IDLE) && (state != RUN)) {
+    return;
+  }
+
+  const uint8_t target = (PWM_GOV_FIXED == gov.mode) ? gov.fixed : auto_target(state, hf_max, hf_n);
+  if ((target == gov.active) || (gov_locks != 0U)) {
+    return;
+  }
+  if (IDLE == state) {
+    /* PWM 关着, 直接换; 关中断防止和 HF 任务交错 */
+    __disable_irq();
+    apply_profile(target);
+    __enable_irq();
+  } else {
+    pwm_gov_pending = target;
+  }
+}
+
+void pwm_gov_set_mode(pwm_gov_mode_t mode, uint8_t profile)
+{
+  gov.mode = mode;
+  gov.fixed = (profile < PWM_GOV_PROFILES) ? profile : PWM_GOV_NOMINAL;
+  gov.floor = 0U;
+  gov.hf_peak = 0U;
+  over_cnt = 0U;
+  under_cnt = 0U;
+}
+
+void pwm_gov_get_status(pwm_gov_status_t *out)
+{
+  *out = gov;
+  out->locks = gov_locks;
+}
+
+void pwm_gov_lock(uint8_t user, bool lock)
+{
+  __disable_irq();
+  gov_locks = lock ? (uint8_t)(gov_locks | user) : (uint8_t)(gov_locks & (uint8_t)~user);
+  __enable_irq();
+}
@@ -0,0 +1,146 @@
+/*
+ * pwm_gov.h  - PWM 频率 / FOC 抽取率调速器 (按实测 HF 负载切换 profile)
+ *
+ * 几组预先验证过的 profile (PWM 频率 + TIM1 RCR), 运行时在它们之间切换:
+ *   P0  20 kHz PWM, RCR=1  -> FOC 20 kHz   低速, 电流纹波小
+ *   P1  16 kHz PWM, RCR=1  -> FOC 16 kHz   标称 (= drive_parameters.h)
+ *   P2  16 kHz PWM, RCR=3  -> FOC  8 kHz   HF 负载过高时的退路
+ * 每组的观测器常数 hC1..hC5, PLL 增益, 电流环 Ki 都按执行频率从 MCSDK
+ * 生成的标称值换算, 编译期定表 (P2 的观测器增益按离散极点换算, 见 pwm_gov.c).
+ *
+ * Usage:
+ *   pwm_gov_init()                   -> MCboot 里, FOC_Init 之后
+ *   PWM_GOV_HF_ENTER(t) / PWM_GOV_HF_EXIT(t)
+ *                                    -> 包住整个 TSK_HighFrequencyTask (含 MCPA)
+ *   PWM_GOV_MF_STEP()                -> 中频任务之后 (决策, 速度环节拍)
+ *   pwm_gov_set_mode() / pwm_gov_get_status()
+ *                                    -> CLI "gov"
+ *
+ * 切换规则:
+ *   - 只在 IDLE / RUN 切; START, 自举充电, 偏置校准期间保持不动
+ *   - 速度: |speed| 低于 PWM_GOV_LOW_SPEED_RPM 用 P0, 否则 P1 (带回差)
+ *   - 负载: 窗口内最大 HF 周期数超过预算的 PWM_GOV_LOAD_HIGH_PCT 持续
+ *     PWM_GOV_DOWN_HOLD 个中频周期 -> 下限往慢的方向退一级;
+ *     按实测周期数估算快一级的负载低于 PWM_GOV_LOAD_LOW_PCT 持续
+ *     PWM_GOV_UP_HOLD 个中频周期 -> 下限回升一级
+ *   - RUN 中切换: 中频任务只置 pending, 下一次 HF 任务开头写 ARR/RCR/句柄,
+ *     ARR 预装载使新的 ARR 和本次算出的 CCR 在同一个更新事件生效
+ *   - 锁: 系数按 FOC 频率算的用户 (fmac_rt / fmac_mc 的滤波器) 运行期间
+ *     pwm_gov_lock() 锁住 profile, 决策照做, 切换推迟到全部解锁;
+ *     锁之前已置的 pending 在 HF 任务里作废
+ *   - HF 斜坡 (启动切闭环的 Iq 斜坡) 没走完时, 剩余步数和步长按新频率换算
+ *
+ * 双电机 (NBR_OF_MOTORS > 1) 不启用: TIM1/TIM8 错开半个周期依赖两边周期相同.
+ * 切换会覆盖电流环 Ki 和 PLL 增益 (MCP 在线改过的值会被 profile 表值替换).
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef PWM_GOV_H_
+#define PWM_GOV_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "mc_stm_types.h"
+
+#ifndef PWM_GOV_ENABLE
+#if (NBR_OF_MOTORS > 1)
+#define PWM_GOV_ENABLE           0
+#else
+#define PWM_GOV_ENABLE           1
+#endif
+#endif
+
+#define PWM_GOV_PROFILES         3U
+#define PWM_GOV_NOMINAL          1U      /* P1 = drive_parameters.h 的编译期配置 */
+
+/* 速度门限 (机械 rpm) */
+#ifndef PWM_GOV_LOW_SPEED_RPM
+#define PWM_GOV_LOW_SPEED_RPM    400
+#endif
+#ifndef PWM_GOV_SPEED_HYST_RPM
+#define PWM_GOV_SPEED_HYST_RPM   40
+#endif
+
+/* 负载门限: HF 任务最大周期数 / 当前 FOC 周期的 CPU 周期预算 */
+#ifndef PWM_GOV_LOAD_HIGH_PCT
+#define PWM_GOV_LOAD_HIGH_PCT    75U
+#endif
+#ifndef PWM_GOV_LOAD_LOW_PCT
+#define PWM_GOV_LOAD_LOW_PCT     55U
+#endif
+/* 中频周期数 (SPEED_LOOP_FREQUENCY_HZ = 1 kHz 时即 ms) */
+#ifndef PWM_GOV_DOWN_HOLD
+#define PWM_GOV_DOWN_HOLD        10U
+#endif
+#ifndef PWM_GOV_UP_HOLD
+#define PWM_GOV_UP_HOLD          500U
+#endif
+
+typedef enum {
+  PWM_GOV_OFF = 0,    /* 保持当前 profile, 不做决策 (默认) */
+  PWM_GOV_AUTO,       /* 按速度和负载自动切换 */
+  PWM_GOV_FIXED       /* 固定到 pwm_gov_set_mode 给定的 profile */
+} pwm_gov_mode_t;
+
+/* 一组 profile: 定时器设置 + 该执行频率下的控制常数 */
+typedef struct {
+  uint32_t pwm_hz;
+  uint16_t rate_hz;       /* FOC 执行频率 = 2 * pwm_hz / (rep + 1) */
+  uint16_t period;        /* PWM 周期 (定时器 tick, 同 PWM_PERIOD_CYCLES), ARR = period / 2 */
+  uint8_t  rep;           /* TIM1 RCR */
+  int16_t  c1, c2, c3, c4, c5;
+  int16_t  pll_kp, pll_ki;
+  int16_t  iq_ki, id_ki;
+} pwm_gov_profile_t;
+
+typedef struct {
+  pwm_gov_mode_t mode;
+  uint8_t  active;        /* 当前生效的 profile */
+  uint8_t  floor;         /* 负载决定的最快 profile (下标越大越慢) */
+  uint8_t  fixed;         /* PWM_GOV_FIXED 的目标 */
+  uint8_t  locks;         /* PWM_GOV_LOCK_x, 非零时不切换 */
+  uint32_t switches;      /* 已完成的切换次数 */
+  uint32_t load_pct;      /* 上一个中频窗口: max HF 周期 / 预算 */
+  uint32_t hf_max;        /* 上一个中频窗口的最大 HF 周期数 */
+  uint32_t hf_peak;       /* 自 init / 切模式以来的最大 HF 周期数 */
+} pwm_gov_status_t;
+
+extern const pwm_gov_profile_t pwm_gov_profiles[PWM_GOV_PROFILES];
+extern volatile uint8_t pwm_gov_pending;   /* 0xFF: 无; 否则等 HF 任务应用的 profile */
+
+#define PWM_GOV_NONE             0xFFU
+
+/* pwm_gov_lock 的用户位 */
+#define PWM_GOV_LOCK_FMAC_RT     0x01U
+#define PWM_GOV_LOCK_FMAC_MC     0x02U
+
+void pwm_gov_init(void);
+void pwm_gov_step(void);
+void pwm_gov_apply_pending(void);
+void pwm_gov_hf_record(uint32_t cyc);
+void pwm_gov_set_mode(pwm_gov_mode_t mode, uint8_t profile);
+void pwm_gov_get_status(pwm_gov_status_t *out);
+
+/* 主循环调用: 锁住/放开当前 profile (user = PWM_GOV_LOCK_x) */
+void pwm_gov_lock(uint8_t user, bool lock);
+
+/* 当前 FOC 执行频率 (Hz) */
+uint32_t pwm_gov_rate_hz(void);
+
+/* 当前 profile 每个 FOC 周期的 CPU 周期预算 */
+uint32_t pwm_gov_budget_cycles(uint8_t profile);
+
+#if PWM_GOV_ENABLE
+#define PWM_GOV_HF_ENTER(t)      do { if (pwm_gov_pending != PWM_GOV_NONE) { pwm_gov_apply_pending(); } } while (0); \
+                                 uint32_t t = DWT->CYCCNT
+#define PWM_GOV_HF_EXIT(t)       pwm_gov_hf_record(DWT->CYCCNT - (t))
+#define PWM_GOV_MF_STEP()        pwm_gov_step()
+#else
+#define PWM_GOV_HF_ENTER(t)
+#define PWM_GOV_HF_EXIT(t)       ((void)0)
+#define PWM_GOV_MF_STEP()        ((void)0)
+#endif
+
+#endif /* PWM_GOV_H_ */
@@ -0,0 +1,87 @@
+/*
+ * stack_mon.c  - MSP 栈水位 (见 stack_mon.h)
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#include "stack_mon.h"
+#include <string.h>
+
+/* 链接脚本符号 (STM32G474RETX_FLASH.ld) */
+extern uint8_t _estack;
+extern uint8_t _end;
+extern uint8_t _Min_Heap_Size;
+extern uint8_t _Min_Stack_Size;
+
+stack_mon_isr_t stack_mon_isr;
+
+static uint32_t stack_top(void)
+{
+  return (uint32_t)&_estack;
+}
+
+/* 堆的预留之上都可能被栈用到 */
+static uint32_t stack_bottom(void)
+{
+  return ((uint32_t)&_end + (uint32_t)&_Min_Heap_Size + 3U) & ~3U;
+}
+
+static void isr_clear(void)
+{
+  stack_mon_isr.min_sp = stack_top();
+  stack_mon_isr.min_sp_exc = 0U;
+  stack_mon_isr.max_depth = 0U;
+  stack_mon_isr.max_depth_exc = 0U;
+  stack_mon_isr.probes = 0U;
+}
+
+/* 只写当前 SP 以下 STACK_MON_GUARD 之外的部分; 本函数自己不用栈上的局部数组 */
+__attribute__((noinline)) static void paint_below_sp(void)
+{
+  uint32_t *p = (uint32_t *)stack_bottom();
+  uint32_t *end = (uint32_t *)((__get_MSP() - STACK_MON_GUARD) & ~3U);
+  while (p < end) {
+    *p++ = STACK_MON_PAINT;
+  }
+}
+
+void stack_mon_paint(void)
+{
+  paint_below_sp();
+  isr_clear();
+}
+
+/* 线程模式下调用: 这时没有 ISR 在栈上, 当前 SP 以下都是空的. 涂色中途来的
+ * ISR 会在返回前用完它的帧, 被重新涂掉也没关系. */
+void stack_mon_reset(void)
+{
+  paint_below_sp();
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  isr_clear();
+  __set_PRIMASK(primask);
+}
+
+void stack_mon_get(stack_mon_report_t *out)
+{
+  memset(out, 0, sizeof(*out));
+  out->top = stack_top();
+  out->bottom = stack_bottom();
+  out->reserve = (uint32_t)&_Min_Stack_Size;
+  out->painted = out->top - out->bottom;
+  out->now = out->top - __get_MSP();
+
+  /* 从栈底往上找第一个被改写的字 */
+  const uint32_t *p = (const uint32_t *)out->bottom;
+  const uint32_t *end = (const uint32_t *)out->top;
+  while ((p < end) && (*p == STACK_MON_PAINT)) {
+    p++;
+  }
+  out->peak = out->top - (uint32_t)p;
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  out->isr = stack_mon_isr;
+  __set_PRIMASK(primask);
+}
@@ -0,0 +1,96 @@
+/*
+ * stack_mon.h  - MSP 栈水位: 上电涂色 + 扫描, ISR 嵌套深度
+ *
+ * 裸机只有一根 MSP 栈, 主循环 / CLI / 所有 ISR 共用, 从 _estack 往下长.
+ * 链接脚本只给它预留 _Min_Stack_Size, 实际能用到堆预留 (_end + _Min_Heap_Size)
+ * 为止; .su 文件只给单个函数的帧, 看不出 log_printf 的 256 B 缓冲叠在
+ * exec_cmd 上再被 ISR 嵌套压住时的真实深度.
+ *
+ * Usage:
+ *   stack_mon_paint()          -> main() 第一句 (USER CODE BEGIN 1), 涂满当前 SP 以下
+ *   STACK_MON_ISR_PROBE()      -> ISR 入口, 记录最低 SP 和嵌套层数 (NVIC/SCB 活动位)
+ *   stack_mon_get(&r)          -> CLI "stack": 从栈底扫描第一个被改写的字 = 峰值
+ *   stack_mon_reset()          -> CLI "stack reset": 重新涂当前 SP 以下, 清 ISR 统计
+ *
+ * 水位只会偏大不会偏小: 堆 (sbrk) 长进涂色区也算作栈用量.
+ * 编译时定义 STACK_MON_ENABLE=0 去掉 ISR 探针.
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+
+#ifndef STACK_MON_H_
+#define STACK_MON_H_
+
+#include <stdint.h>
+#include "stm32g4xx.h"
+
+#ifndef STACK_MON_ENABLE
+#define STACK_MON_ENABLE         1
+#endif
+
+#define STACK_MON_PAINT          0xC5C5C5C5u
+/* 涂色停在当前 SP 以下这么多字节, 留给 paint 自己的调用帧 */
+#define STACK_MON_GUARD          64U
+
+/* ISR 入口统计, 只在 ISR 里写 */
+typedef struct {
+  uint32_t min_sp;        /* ISR 入口见到的最低 SP */
+  uint16_t min_sp_exc;    /* 当时的异常号 (IPSR, 16 + IRQn) */
+  uint16_t max_depth;     /* 最多同时活动的异常数 */
+  uint16_t max_depth_exc; /* 达到 max_depth 的那个异常 */
+  uint32_t probes;
+} stack_mon_isr_t;
+
+typedef struct {
+  uint32_t top;           /* _estack */
+  uint32_t bottom;        /* 涂色区底 = _end + _Min_Heap_Size */
+  uint32_t reserve;       /* _Min_Stack_Size */
+  uint32_t painted;       /* 涂色区大小 (top - bottom) */
+  uint32_t peak;          /* 峰值用量 (B), top - 最低被改写地址 */
+  uint32_t now;           /* 调用时的用量 (B) */
+  stack_mon_isr_t isr;
+} stack_mon_report_t;
+
+extern stack_mon_isr_t stack_mon_isr;
+
+void stack_mon_paint(void);
+void stack_mon_reset(void);
+void stack_mon_get(stack_mon_report_t *out);
+
+/* 当前活动的异常数: NVIC IABR (102 个 IRQ) + SCB 里的系统异常活动位 */
+static inline uint32_t stack_mon_active_count(void)
+{
+  uint32_t n = (uint32_t)__builtin_popcount(SCB->SHCSR & (SCB_SHCSR_MEMFAULTACT_Msk | SCB_SHCSR_BUSFAULTACT_Msk |
+                                                          SCB_SHCSR_USGFAULTACT_Msk | SCB_SHCSR_SVCALLACT_Msk |
+                                                          SCB_SHCSR_MONITORACT_Msk | SCB_SHCSR_PENDSVACT_Msk |
+                                                          SCB_SHCSR_SYSTICKACT_Msk));
+  for (uint32_t i = 0; i < 4U; i++) {
+    n += (uint32_t)__builtin_popcount(NVIC->IABR[i]);
+  }
+  return n;
+}
+
+/* 嵌套的两个探针同时改同一字段时, 被打断的那个可能丢一次更新, 不影响更深一层的记录 */
+static inline void stack_mon_isr_probe(void)
+{
+  const uint32_t sp = __get_MSP();
+  const uint32_t depth = stack_mon_active_count();
+  stack_mon_isr.probes++;
+  if (sp < stack_mon_isr.min_sp) {
+    stack_mon_isr.min_sp = sp;
+    stack_mon_isr.min_sp_exc = (uint16_t)__get_IPSR();
+  }
+  if (depth > stack_mon_isr.max_depth) {
+    stack_mon_isr.max_depth = (uint16_t)depth;
+    stack_mon_isr.max_depth_exc = (uint16_t)__get_IPSR();
+  }
+}
+
+#if STACK_MON_ENABLE
+#define STACK_MON_ISR_PROBE()    stack_mon_isr_probe()
+#else
+#define STACK_MON_ISR_PROBE()    ((void)0)
+#endif
+
+#endif /* STACK_MON_H_ */
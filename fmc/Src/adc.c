@@ -21,7 +21,7 @@
 #include "adc.h"
 
 /* USER CODE BEGIN 0 */
-
+#include "dual_drive.h"
 /* USER CODE END 0 */
 
 ADC_HandleTypeDef hadc1;
@@ -116,7 +116,7 @@ void MX_ADC1_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN ADC1_Init 2 */
-
+  dual_drive_adc_init(ADC1);
   /* USER CODE END ADC1_Init 2 */
 
 }
@@ -200,7 +200,7 @@ void MX_ADC2_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN ADC2_Init 2 */
-
+  dual_drive_adc_init(ADC2);
   /* USER CODE END ADC2_Init 2 */
 
 }
@@ -22,12 +22,14 @@
 
 #include <stdint.h>
 #include "aspep.h"
+#include "crc16.h"
 
 /* Local definition */
 #define MIN(a,b) ( ((a) < (b)) ? (a) : (b) )
 
 /* Local functions */
 static bool ASPEP_CheckBeacon (ASPEP_Handle_t *pHandle);
+static void ASPEP_ApplyCapabilities(ASPEP_Handle_t *pHandle);
 static uint8_t ASPEP_TXframeProcess(ASPEP_Handle_t *pHandle, uint8_t packetType, void *txBuffer, uint16_t bufferLength);
 void ASPEP_sendBeacon(ASPEP_Handle_t *pHandle, ASPEP_Capabilities_def *capabilities);
 void ASPEP_sendPing(ASPEP_Handle_t *pHandle, uint8_t state, uint16_t PacketNumber);
@@ -187,6 +189,7 @@ void ASPEP_start(ASPEP_Handle_t *pHandle)
   else
   {
 #endif
+    crc16_init(); /* Data CRC tables and CRC peripheral */
     pHandle->fASPEP_HWInit(pHandle->ASPEPIp);
     pHandle->ASPEP_State = ASPEP_IDLE;
     pHandle->ASPEP_TL_State = WAITING_PACKET;
@@ -217,6 +220,7 @@ void ASPEP_sendBeacon(ASPEP_Handle_t *pHandle, ASPEP_Capabilities_def *capabilit
     uint32_t *packet = (uint32_t *)pHandle->ctrlBuffer.buffer; //cstat !MISRAC2012-Rule-11.3
     *packet = (BEACON
              | (((uint32_t)capabilities->version) << 4U)
+             | (((uint32_t)capabilities->MCPA_DELTA) << 6U)
              | (((uint32_t)capabilities->DATA_CRC) << 7U)
              | (((uint32_t)capabilities->RX_maxSize) << 8U)
              | (((uint32_t)capabilities->TXS_maxSize) << 14U)
@@ -358,18 +362,22 @@ bool ASPEP_CheckBeacon (ASPEP_Handle_t *pHandle)
 
   uint32_t packetHeader = *((uint32_t *)pHandle->rxHeader); //cstat !MISRAC2012-Rule-11.3
   ASPEP_Capabilities_def MasterCapabilities;
-  MasterCapabilities.version = (uint8_t)((packetHeader &0x70U)>> 4U);           /*Bits 4 to 6*/
+  MasterCapabilities.version = (uint8_t)((packetHeader & ASPEP_BEACON_VERSION_MSK) >> 4U); /*Bits 4 to 5*/
+  MasterCapabilities.MCPA_DELTA = (uint8_t)((packetHeader & ASPEP_BEACON_MCPA_DELTA) >> 6U); /*Bit 6 */
   MasterCapabilities.DATA_CRC = pHandle->rxHeader[0] >> 7U ;                     /*Bit 7 */
   MasterCapabilities.RX_maxSize = pHandle->rxHeader[1] &0x3FU;                  /*Bits 8 to  13*/
   MasterCapabilities.TXS_maxSize = (uint8_t)((packetHeader&0x01FC000U)  >> 14); /*Bits 14 to 20 */
   MasterCapabilities.TXA_maxSize = (uint8_t)((packetHeader&0xFE00000U) >> 21);  /*Bits 21 to 27  */
 
   pHandle->Capabilities.DATA_CRC = MIN(pHandle->Capabilities.DATA_CRC ,MasterCapabilities.DATA_CRC);
+  pHandle->Capabilities.MCPA_DELTA = MIN(pHandle->Capabilities.MCPA_DELTA, MasterCapabilities.MCPA_DELTA);
   pHandle->Capabilities.RX_maxSize = MIN(pHandle->Capabilities.RX_maxSize, MasterCapabilities.RX_maxSize);
   pHandle->Capabilities.TXS_maxSize = MIN(pHandle->Capabilities.TXS_maxSize, MasterCapabilities.TXS_maxSize);
   pHandle->Capabilities.TXA_maxSize = MIN(pHandle->Capabilities.TXA_maxSize, MasterCapabilities.TXA_maxSize);
 
   if ((MasterCapabilities.DATA_CRC != pHandle->Capabilities.DATA_CRC)
+   /* Controller asks for delta coded async data the performer does not offer */
+   || (MasterCapabilities.MCPA_DELTA != pHandle->Capabilities.MCPA_DELTA)
    /* Data packet the controller can send is bigger than performer can receive */
    || (MasterCapabilities.RX_maxSize > pHandle->Capabilities.RX_maxSize)
    /* Sync packet size alignement is required in order for the controller to be able to store it, and to not request a
@@ -391,6 +399,22 @@ bool ASPEP_CheckBeacon (ASPEP_Handle_t *pHandle)
   return (result);
 }
 
+/**
+  * @brief  Derives the payload limits and the async format from the negotiated capabilities.
+  *
+  * Applied on every accepted beacon, so that a controller renegotiating from the
+  * CONFIGURED or CONNECTED state gets the sizes and async format it asked for.
+  *
+  * @param  *pHandle Handler of the current instance of the ASPEP component
+  */
+static void ASPEP_ApplyCapabilities(ASPEP_Handle_t *pHandle)
+{
+  pHandle->_Super.txSyncMaxPayload = (pHandle->Capabilities.TXS_maxSize + (uint16_t)1U) * (uint16_t)32U;
+  pHandle->_Super.txAsyncMaxPayload = (pHandle->Capabilities.TXA_maxSize) * (uint16_t)64U;
+  pHandle->_Super.txAsyncFormat = (1U == pHandle->Capabilities.MCPA_DELTA) ? MCTL_ASYNC_DELTA : MCTL_ASYNC_RAW;
+  pHandle->maxRXPayload = (pHandle->Capabilities.RX_maxSize + (uint16_t)1U) * (uint16_t)32U;
+}
+
 /**
   * @brief  Checks if any error has occurred and calls the ASPEP_TXframeProcess function.
   *
@@ -431,9 +455,11 @@ uint8_t ASPEP_sendPacket(MCTL_Handle_t *pSupHandle, void *txBuffer, uint16_t txD
       *header = tmpHeader;
       if (1U == pHandle->Capabilities.DATA_CRC)
       {
-        /* TODO : Compute real CRC*/
-        packet[txDataLengthTemp] = (uint8_t)0xCA; /* Dummy CRC */
-        packet[txDataLengthTemp + 1U] = (uint8_t)0xFE; /* Dummy CRC */
+        /* CRC-16 computed in place over the payload, appended LSB first.
+         * Buffers are sized with ASPEP_DATACRC_SIZE spare bytes (mcp_config.h) */
+        uint16_t dataCRC = crc16(packet, txDataLengthTemp);
+        packet[txDataLengthTemp] = (uint8_t)(dataCRC & 0xFFU);
+        packet[txDataLengthTemp + 1U] = (uint8_t)(dataCRC >> 8U);
         txDataLengthTemp += (uint16_t)ASPEP_DATACRC_SIZE;
       }
       if (MCTL_SYNC == syncAsync)
@@ -634,10 +660,9 @@ void ASPEP_HWDataTransmittedIT(ASPEP_Handle_t *pHandle)
         /* If one Async buffer is still pending, assign it to the asyncNextBuffer pointer*/
         if ((pHandle->asyncBufferA.state == pending) || (pHandle->asyncBufferB.state == pending))
         {
-          //cstat !MISRAC2012-Rule-11.4
-          uint32_t temp = (uint32_t)&pHandle->asyncBufferA + (uint32_t)&pHandle->asyncBufferB
-                          - (uint32_t) pHandle->asyncNextBuffer; //cstat !MISRAC2012-Rule-11.4
-          pHandle->asyncNextBuffer = (MCTL_Buff_t *) temp; //cstat !MISRAC2012-Rule-11.4
+          /* The other one of the two flip-flop buffers */
+          pHandle->asyncNextBuffer = (pHandle->asyncNextBuffer == &pHandle->asyncBufferA) ? &pHandle->asyncBufferB
+                                                                                          : &pHandle->asyncBufferA;
         }
         else
         {
@@ -679,9 +704,7 @@ uint8_t *ASPEP_RXframeProcess(MCTL_Handle_t *pSupHandle, uint16_t *packetLength)
     ASPEP_Handle_t *pHandle = (ASPEP_Handle_t *)pSupHandle; //cstat !MISRAC2012-Rule-11.3
     uint32_t packetHeader = *((uint32_t *)pHandle->rxHeader); //cstat !MISRAC2012-Rule-11.3
     uint16_t packetNumber;
-#if VALID_CRC_DATA
     bool validCRCData = true;
-#endif
     *packetLength = 0;
     if (pHandle->NewPacketAvailable)
     {
@@ -695,9 +718,7 @@ uint8_t *ASPEP_RXframeProcess(MCTL_Handle_t *pSupHandle, uint16_t *packetLength)
             if (ASPEP_CheckBeacon(pHandle) == true)
             {
               /* Controller capabilities match performer capabilities.*/
-              pSupHandle->txSyncMaxPayload = (pHandle->Capabilities.TXS_maxSize + (uint16_t)1U) * (uint16_t)32U;
-              pSupHandle->txAsyncMaxPayload = (pHandle->Capabilities.TXA_maxSize) * (uint16_t)64U;
-              pHandle->maxRXPayload = (pHandle->Capabilities.RX_maxSize + (uint16_t)1U) * (uint16_t)32U;
+              ASPEP_ApplyCapabilities(pHandle);
               pHandle->ASPEP_State = ASPEP_CONFIGURED;
             }
             else
@@ -730,7 +751,7 @@ uint8_t *ASPEP_RXframeProcess(MCTL_Handle_t *pSupHandle, uint16_t *packetLength)
             }
             else
             {
-              /* Nothing to do */
+              ASPEP_ApplyCapabilities(pHandle);
             }
 
             ASPEP_sendBeacon (pHandle, &pHandle->Capabilities);
@@ -759,6 +780,7 @@ uint8_t *ASPEP_RXframeProcess(MCTL_Handle_t *pSupHandle, uint16_t *packetLength)
             }
             else
             {
+              ASPEP_ApplyCapabilities(pHandle);
               pHandle->ASPEP_State = ASPEP_CONFIGURED;
             }
             ASPEP_sendBeacon(pHandle, &pHandle->Capabilities);
@@ -770,21 +792,24 @@ uint8_t *ASPEP_RXframeProcess(MCTL_Handle_t *pSupHandle, uint16_t *packetLength)
           }
           else if (DATA_PACKET == pHandle->rxPacketType)
           {
-#if VALID_CRC_DATA
+            /* Payload and its CRC are in rxBuffer; CRC over both is 0 when intact.
+             * Zero length packets carry no payload and no data CRC. */
+            if ((1U == pHandle->Capabilities.DATA_CRC) && (pHandle->rxLengthASPEP > 0U))
+            {
+              validCRCData = (0U == crc16(pHandle->rxBuffer,
+                                          pHandle->rxLengthASPEP + (uint16_t)ASPEP_DATACRC_SIZE));
+            }
             if (validCRCData)
             {
-#endif
               pHandle->syncPacketCount++; /* this counter is incremented at each valid data packet received from controller */
               pSupHandle->MCP_PacketAvailable = true; /* Will be consumed in ASPEP_sendPacket */
               *packetLength = pHandle->rxLengthASPEP;
               result = pHandle->rxBuffer;
-#if VALID_CRC_DATA
             }
             else
             {
               ASPEP_sendNack (pHandle, ASPEP_BAD_CRC_DATA);
             }
-#endif
           }
           else
           {
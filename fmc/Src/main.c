@@ -30,6 +30,13 @@
 /* USER CODE BEGIN Includes */
 #include "fmac_rt.h"
 #include "cli.h"
+#include "fmac_mc.h"
+#include "hf_prof.h"
+#include "stack_mon.h"
+#include "fault_rec.h"
+#include "cordic_batch.h"
+#include "log.h"
+#include "bsp_uart.h"
 #include "stm32g4xx_ll_usart.h"
 /* USER CODE END Includes */
 
@@ -74,7 +81,8 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-
+  stack_mon_paint();   /* fill the free MSP stack for the CLI "stack" watermark */
+  fault_rec_init();    /* keep a fault window frozen before the last reset, else start recording */
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -90,7 +98,7 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
+  hf_prof_init();      /* DWT on, stage table cleared before MX_MotorControl_Init/MX_NVIC_Init enable the HF ISR */
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
@@ -109,13 +117,25 @@ int main(void)
   MX_NVIC_Init();
   /* USER CODE BEGIN 2 */
   LL_USART_DisableDMAReq_RX(USART2);
-  /* CLI uses USART2 in polling mode; keep MCSDK ASPEP IRQ path fully disabled. */
+  /* The CLI console owns USART2; tear down the MCSDK ASPEP setup first. */
   LL_USART_DisableIT_TC(USART2);
   LL_USART_DisableIT_IDLE(USART2);
   LL_USART_DisableIT_ERROR(USART2);
   HAL_NVIC_DisableIRQ(USART2_IRQn);
+  log_init();          /* USART2 TX -> DMA1 Ch2 ring, RX -> DMA1 Ch1 circular + IDLE */
+  HAL_DBGMCU_EnableDBGSleepMode();   /* keep SWD alive across __WFI */
   fmac_rt_init();
+  fmac_mc_init();
+  cordic_batch_init();  /* CORDIC DMA batch: DMA2 Ch1 -> WDATA, RDATA -> DMA2 Ch2 */
   cli_init();
+  {
+    fault_rec_status_t frec;
+    fault_rec_get_status(&frec);
+    if (frec.frozen != 0U) {
+      LOGW("fault window kept: M%u faults=0x%04x, %u resets ago ('frec dump')",
+           (unsigned)(frec.hdr.motor + 1U), (unsigned)frec.hdr.faults, (unsigned)frec.hdr.boots);
+    }
+  }
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -125,13 +145,22 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-	    if (USART2->ISR & USART_ISR_RXNE_RXFNE) {
-	        uint8_t b = (uint8_t)(USART2->RDR & 0xFF);
-	        while (!(USART2->ISR & USART_ISR_TXE_TXFNF)) {}
-	        USART2->TDR = b;
-	        cli_on_rx_byte(b);
+	    uint8_t rx[64];
+	    int n = bsp_uart_read(rx, sizeof(rx));
+	    if (n > 0) {
+	        cli_on_rx(rx, (size_t)n);    /* echo + run every completed line */
+	    }
+	    log_poll();
+	    bsp_uart_poll();
+
+	    /* Sleep until the next interrupt (RX IDLE/HT/TC, TX DMA, SysTick, ADC).
+	     * Checked with PRIMASK set so an RX event between the test and WFI
+	     * still wakes the core instead of waiting for the next tick. */
+	    __disable_irq();
+	    if (bsp_uart_rx_available() == 0U) {
+	        __WFI();
 	    }
-	    cli_poll();
+	    __enable_irq();
   }
   /* USER CODE END 3 */
 }
@@ -715,6 +715,84 @@ __weak float_t MC_GetAveragePowerMotor1_F(void)
   return (PQD_GetAvrgElMotorPowerW(pMPM[M1]));
 }
 
+#if (NBR_OF_MOTORS > 1)
+/**
+  * @brief  Initiates the start-up procedure for Motor 2
+  *
+  *  Same behaviour as MC_StartMotor1(), on the state machine of Motor 2.
+  * @retval returns true if the command is successfully executed, false otherwise.
+  */
+__weak bool MC_StartMotor2(void)
+{
+  return (MCI_StartMotor(pMCI[M2]));
+}
+
+/**
+  * @brief  Initiates the stop procedure for Motor 2.
+  *
+  *  Same behaviour as MC_StopMotor1(), on the state machine of Motor 2.
+  * @retval returns true if the command is successfully executed, false otherwise.
+  */
+__weak bool MC_StopMotor2(void)
+{
+  return (MCI_StopMotor(pMCI[M2]));
+}
+
+/**
+  * @brief Programs a speed ramp for Motor 2 for later or immediate execution.
+  *
+  * @param  hFinalSpeed Mechanical rotor speed reference at the end of the ramp.
+  *                     Expressed in the unit defined by #SPEED_UNIT.
+  * @param  hDurationms Duration of the ramp expressed in milliseconds.
+  */
+__weak void MC_ProgramSpeedRampMotor2(int16_t hFinalSpeed, uint16_t hDurationms)
+{
+  MCI_ExecSpeedRamp(pMCI[M2], hFinalSpeed, hDurationms);
+}
+
+/**
+  * @brief Returns the last computed average mechanical rotor speed for Motor 2,
+  *        expressed in the unit defined by #SPEED_UNIT.
+  */
+__weak int16_t MC_GetMecSpeedAverageMotor2(void)
+{
+  return (MCI_GetAvrgMecSpeedUnit(pMCI[M2]));
+}
+
+/**
+  * @brief  Acknowledge a Motor Control fault that occured on Motor 2.
+  * @retval returns true if the command is successfully executed, false otherwise.
+  */
+__weak bool MC_AcknowledgeFaultMotor2(void)
+{
+  return (MCI_FaultAcknowledged(pMCI[M2]));
+}
+
+/**
+  * @brief Returns a bitfield showing non acknowledged faults that occurred on Motor 2.
+  */
+__weak uint16_t MC_GetOccurredFaultsMotor2(void)
+{
+  return (MCI_GetOccurredFaults(pMCI[M2]));
+}
+
+/**
+  * @brief Returns a bitfield showing all current faults on Motor 2.
+  */
+__weak uint16_t MC_GetCurrentFaultsMotor2(void)
+{
+  return (MCI_GetCurrentFaults(pMCI[M2]));
+}
+
+/**
+  * @brief Returns the current state of Motor 2 state machine.
+  */
+__weak MCI_State_t MC_GetSTMStateMotor2(void)
+{
+  return (MCI_GetSTMState(pMCI[M2]));
+}
+#endif
+
 /**
  * @brief Not implemented MC_Profiler function.
  *  */ //cstat !MISRAC2012-Rule-2.7 !RED-unused-param  !MISRAC2012-Rule-2.7  !MISRAC2012-Rule-8.13
@@ -292,13 +292,280 @@ CircleLimitation_Handle_t CircleLimitationM1 =
   .MaxVd     = (uint16_t)((MAX_MODULE * 950) / 1000),
 };
 
+#if (NBR_OF_MOTORS > 1)
+/* Motor 2: same motor, power stage and tuning as Motor 1, PWM on TIM8 */
+PQD_MotorPowMeas_Handle_t PQD_MotorPowMeasM2 =
+{
+  .ConvFact = PQD_CONVERSION_FACTOR
+};
+
+/**
+  * @brief  PI / PID Speed loop parameters Motor 2.
+  */
+PID_Handle_t PIDSpeedHandle_M2 =
+{
+  .hDefKpGain          = (int16_t)PID_SPEED_KP_DEFAULT,
+  .hDefKiGain          = (int16_t)PID_SPEED_KI_DEFAULT,
+  .wUpperIntegralLimit = (int32_t)(IQMAX * SP_KIDIV),
+  .wLowerIntegralLimit = -(int32_t)(IQMAX * SP_KIDIV),
+  .hUpperOutputLimit   = (int16_t)IQMAX,
+  .hLowerOutputLimit   = -(int16_t)IQMAX,
+  .hKpDivisor          = (uint16_t)SP_KPDIV,
+  .hKiDivisor          = (uint16_t)SP_KIDIV,
+  .hKpDivisorPOW2      = (uint16_t)SP_KPDIV_LOG,
+  .hKiDivisorPOW2      = (uint16_t)SP_KIDIV_LOG,
+  .hDefKdGain          = 0x0000U,
+  .hKdDivisor          = 0x0000U,
+  .hKdDivisorPOW2      = 0x0000U,
+};
+
+/**
+  * @brief  PI / PID Iq loop parameters Motor 2.
+  */
+PID_Handle_t PIDIqHandle_M2 =
+{
+  .hDefKpGain          = (int16_t)PID_TORQUE_KP_DEFAULT,
+  .hDefKiGain          = (int16_t)PID_TORQUE_KI_DEFAULT,
+  .wUpperIntegralLimit = (int32_t)(INT16_MAX * TF_KIDIV),
+  .wLowerIntegralLimit = (int32_t)(-INT16_MAX * TF_KIDIV),
+  .hUpperOutputLimit   = INT16_MAX,
+  .hLowerOutputLimit   = -INT16_MAX,
+  .hKpDivisor          = (uint16_t)TF_KPDIV,
+  .hKiDivisor          = (uint16_t)TF_KIDIV,
+  .hKpDivisorPOW2      = (uint16_t)TF_KPDIV_LOG,
+  .hKiDivisorPOW2      = (uint16_t)TF_KIDIV_LOG,
+  .hDefKdGain          = 0x0000U,
+  .hKdDivisor          = 0x0000U,
+  .hKdDivisorPOW2      = 0x0000U,
+};
+
+/**
+  * @brief  PI / PID Id loop parameters Motor 2.
+  */
+PID_Handle_t PIDIdHandle_M2 =
+{
+  .hDefKpGain          = (int16_t)PID_FLUX_KP_DEFAULT,
+  .hDefKiGain          = (int16_t)PID_FLUX_KI_DEFAULT,
+  .wUpperIntegralLimit = (int32_t)(INT16_MAX * TF_KIDIV),
+  .wLowerIntegralLimit = (int32_t)(-INT16_MAX * TF_KIDIV),
+  .hUpperOutputLimit   = INT16_MAX,
+  .hLowerOutputLimit   = -INT16_MAX,
+  .hKpDivisor          = (uint16_t)TF_KPDIV,
+  .hKiDivisor          = (uint16_t)TF_KIDIV,
+  .hKpDivisorPOW2      = (uint16_t)TF_KPDIV_LOG,
+  .hKiDivisorPOW2      = (uint16_t)TF_KIDIV_LOG,
+  .hDefKdGain          = 0x0000U,
+  .hKdDivisor          = 0x0000U,
+  .hKdDivisorPOW2      = 0x0000U,
+};
+
+/**
+  * @brief  SpeednTorque Controller parameters Motor 2.
+  */
+SpeednTorqCtrl_Handle_t SpeednTorqCtrlM2 =
+{
+  .STCFrequencyHz             = MEDIUM_FREQUENCY_TASK_RATE,
+  .MaxAppPositiveMecSpeedUnit = (uint16_t)(MAX_APPLICATION_SPEED_UNIT),
+  .MinAppPositiveMecSpeedUnit = (uint16_t)(MIN_APPLICATION_SPEED_UNIT),
+  .MaxAppNegativeMecSpeedUnit = (int16_t)(-MIN_APPLICATION_SPEED_UNIT),
+  .MinAppNegativeMecSpeedUnit = (int16_t)(-MAX_APPLICATION_SPEED_UNIT),
+  .MaxPositiveTorque          = (int16_t)NOMINAL_CURRENT,
+  .MinNegativeTorque          = -(int16_t)NOMINAL_CURRENT,
+  .ModeDefault                = DEFAULT_CONTROL_MODE,
+  .MecSpeedRefUnitDefault     = (int16_t)(DEFAULT_TARGET_SPEED_UNIT),
+  .TorqueRefDefault           = (int16_t)DEFAULT_TORQUE_COMPONENT,
+  .IdrefDefault               = (int16_t)DEFAULT_FLUX_COMPONENT,
+};
+
+RevUpCtrl_Handle_t RevUpControlM2 =
+{
+  .hRUCFrequencyHz         = MEDIUM_FREQUENCY_TASK_RATE,
+  .hStartingMecAngle       = (int16_t)((int32_t)(STARTING_ANGLE_DEG)* 65536/360),
+  .bFirstAccelerationStage = (ENABLE_SL_ALGO_FROM_PHASE-1u),
+  .hMinStartUpValidSpeed   = OBS_MINIMUM_SPEED_UNIT,
+  .hMinStartUpFlySpeed     = (int16_t)(OBS_MINIMUM_SPEED_UNIT/2),
+  .OTFStartupEnabled       = false,
+
+  .OTFPhaseParams =
+  {
+    (uint16_t)500,
+    0,
+    (int16_t)PHASE5_FINAL_CURRENT,
+    (void*)MC_NULL
+  },
+
+  .ParamsData =
+  {
+    {(uint16_t)PHASE1_DURATION,(int16_t)(PHASE1_FINAL_SPEED_UNIT),(uint16_t)PHASE1_FINAL_CURRENT,&RevUpControlM2.ParamsData[1]},
+    {(uint16_t)PHASE2_DURATION,(int16_t)(PHASE2_FINAL_SPEED_UNIT),(uint16_t)PHASE2_FINAL_CURRENT,&RevUpControlM2.ParamsData[2]},
+    {(uint16_t)PHASE3_DURATION,(int16_t)(PHASE3_FINAL_SPEED_UNIT),(uint16_t)PHASE3_FINAL_CURRENT,&RevUpControlM2.ParamsData[3]},
+    {(uint16_t)PHASE4_DURATION,(int16_t)(PHASE4_FINAL_SPEED_UNIT),(uint16_t)PHASE4_FINAL_CURRENT,&RevUpControlM2.ParamsData[4]},
+    {(uint16_t)PHASE5_DURATION,(int16_t)(PHASE5_FINAL_SPEED_UNIT),(uint16_t)PHASE5_FINAL_CURRENT,(void*)MC_NULL},
+  },
+};
+
+PWMC_R3_2_Handle_t PWM_Handle_M2 =
+{
+  ._Super =
+  {
+    .pFctGetPhaseCurrents       = &R3_2_GetPhaseCurrents,
+    .pFctSetADCSampPointSectX   = &R3_2_SetADCSampPointSectX,
+    .pFctSetOffsetCalib         = &R3_2_SetOffsetCalib,
+    .pFctGetOffsetCalib         = &R3_2_GetOffsetCalib,
+    .pFctSwitchOffPwm           = &R3_2_SwitchOffPWM,
+    .pFctSwitchOnPwm            = &R3_2_SwitchOnPWM,
+    .pFctCurrReadingCalib       = &R3_2_CurrentReadingPolarization,
+    .pFctTurnOnLowSides         = &R3_2_TurnOnLowSides,
+    .pFctOCPSetReferenceVoltage = MC_NULL,
+    .pFctRLDetectionModeEnable  = &R3_2_RLDetectionModeEnable,
+    .pFctRLDetectionModeDisable = &R3_2_RLDetectionModeDisable,
+    .pFctRLDetectionModeSetDuty = &R3_2_RLDetectionModeSetDuty,
+    .pFctRLTurnOnLowSidesAndStart = &R3_2_RLTurnOnLowSidesAndStart,
+    .hT_Sqrt3                   = (PWM_PERIOD_CYCLES2*SQRT3FACTOR)/16384u,
+    .LowSideOutputs    = (LowSideOutputsFunction_t)LOW_SIDE_SIGNALS_ENABLING,
+    .pwm_en_u_port     = M2_PWM_EN_U_GPIO_Port,
+    .pwm_en_u_pin      = M2_PWM_EN_U_Pin,
+    .pwm_en_v_port     = M2_PWM_EN_V_GPIO_Port,
+    .pwm_en_v_pin      = M2_PWM_EN_V_Pin,
+    .pwm_en_w_port     = M2_PWM_EN_W_GPIO_Port,
+    .pwm_en_w_pin      = M2_PWM_EN_W_Pin,
+    .Sector                     = 0,
+    .lowDuty                    = (uint16_t)0,
+    .midDuty                    = (uint16_t)0,
+    .highDuty                   = (uint16_t)0,
+    .CntPhA                     = 0,
+    .CntPhB                     = 0,
+    .CntPhC                     = 0,
+    .SWerror                    = 0,
+    .TurnOnLowSidesAction       = false,
+    .OffCalibrWaitTimeCounter   = 0,
+    .Motor                      = M2,
+    .RLDetectionMode            = false,
+    .SingleShuntTopology        = false,
+    .Ia                         = 0,
+    .Ib                         = 0,
+    .Ic                         = 0,
+    .LPFIqd_const               = LPF_FILT_CONST,
+    .DTCompCnt                  = DTCOMPCNT,
+    .PWMperiod                  = PWM_PERIOD_CYCLES2,
+    .Ton                        = TON,
+    .Toff                       = TOFF,
+    .OverCurrentFlag            = false,
+    .OverVoltageFlag            = false,
+    .BrakeActionLock            = false,
+    .driverProtectionFlag       = false,
+  },
+
+  .Half_PWMPeriod               = PWM_PERIOD_CYCLES2/2u,
+  .PhaseAOffset                 = 32767,
+  .PhaseBOffset                 = 32767,
+  .PhaseCOffset                 = 32767,
+  .PolarizationCounter          = (uint8_t)0,
+  .PolarizationSector           = (uint8_t)0,
+  .pParams_str                  = &R3_2_ParamsM2
+};
+
+/**
+  * @brief  SpeedNPosition sensor parameters Motor 2 - State Observer + PLL.
+  */
+STO_PLL_Handle_t STO_PLL_M2 =
+{
+  ._Super =
+  {
+    .bElToMecRatio             = POLE_PAIR_NUM,
+    .SpeedUnit                 = SPEED_UNIT,
+    .hMaxReliableMecSpeedUnit  = (uint16_t)(1.15 * MAX_APPLICATION_SPEED_UNIT),
+    .hMinReliableMecSpeedUnit  = (uint16_t)(MIN_APPLICATION_SPEED_UNIT),
+    .bMaximumSpeedErrorsNumber = M1_SS_MEAS_ERRORS_BEFORE_FAULTS,
+    .hMaxReliableMecAccelUnitP = 65535,
+    .hMeasurementFrequency     = TF_REGULATION_RATE_SCALED,
+    .DPPConvFactor             = DPP_CONV_FACTOR,
+  },
+
+  .hC1                         = C1,
+  .hC2                         = C2,
+  .hC3                         = C3,
+  .hC4                         = C4,
+  .hC5                         = C5,
+  .hF1                         = F1,
+  .hF2                         = F2,
+
+  .PIRegulator =
+  {
+    .hDefKpGain                = PLL_KP_GAIN,
+    .hDefKiGain                = PLL_KI_GAIN,
+    .hDefKdGain                = 0x0000U,
+    .hKpDivisor                = PLL_KPDIV,
+    .hKiDivisor                = PLL_KIDIV,
+    .hKdDivisor                = 0x0000U,
+    .wUpperIntegralLimit       = INT32_MAX,
+    .wLowerIntegralLimit       = -INT32_MAX,
+    .hUpperOutputLimit         = INT16_MAX,
+    .hLowerOutputLimit         = -INT16_MAX,
+    .hKpDivisorPOW2            = PLL_KPDIV_LOG,
+    .hKiDivisorPOW2            = PLL_KIDIV_LOG,
+    .hKdDivisorPOW2            = 0x0000U,
+  },
+
+  .SpeedBufferSizeUnit         = STO_FIFO_DEPTH_UNIT,
+  .SpeedBufferSizeDpp          = STO_FIFO_DEPTH_DPP,
+  .VariancePercentage          = PERCENTAGE_FACTOR,
+  .SpeedValidationBand_H       = SPEED_BAND_UPPER_LIMIT,
+  .SpeedValidationBand_L       = SPEED_BAND_LOWER_LIMIT,
+  .MinStartUpValidSpeed        = OBS_MINIMUM_SPEED_UNIT,
+  .StartUpConsistThreshold     = NB_CONSECUTIVE_TESTS,
+  .BemfConsistencyCheck        = M1_BEMF_CONSISTENCY_TOL,
+  .BemfConsistencyGain         = M1_BEMF_CONSISTENCY_GAIN,
+  .MaxAppPositiveMecSpeedUnit  = (uint16_t)(MAX_APPLICATION_SPEED_UNIT * 1.15),
+  .F1LOG                       = F1_LOG,
+  .F2LOG                       = F2_LOG,
+  .SpeedBufferSizeDppLOG       = STO_FIFO_DEPTH_DPP_LOG,
+  .hForcedDirection            = 0x0000U
+};
+
+STO_Handle_t STO_M2 =
+{
+  ._Super                        = (SpeednPosFdbk_Handle_t *)&STO_PLL_M2, //cstat !MISRAC2012-Rule-11.3
+  .pFctForceConvergency1         = &STO_PLL_ForceConvergency1,
+  .pFctForceConvergency2         = &STO_PLL_ForceConvergency2,
+  .pFctStoOtfResetPLL            = &STO_OTF_ResetPLL,
+  .pFctSTO_SpeedReliabilityCheck = &STO_PLL_IsVarianceTight
+};
+
+/** RAMP for Motor2
+  *
+  */
+RampExtMngr_Handle_t RampExtMngrHFParamsM2 =
+{
+  .FrequencyHz = TF_REGULATION_RATE
+};
+
+/**
+  * @brief  CircleLimitation Component parameters Motor 2 - Base Component.
+  */
+CircleLimitation_Handle_t CircleLimitationM2 =
+{
+  .MaxModule = MAX_MODULE,
+  .MaxVd     = (uint16_t)((MAX_MODULE * 950) / 1000),
+};
+
+#endif
+
 FOCVars_t FOCVars[NBR_OF_MOTORS];
 RampExtMngr_Handle_t *pREMNG[NBR_OF_MOTORS];
+#if (NBR_OF_MOTORS > 1)
+SpeednTorqCtrl_Handle_t *pSTC[NBR_OF_MOTORS]    = {&SpeednTorqCtrlM1, &SpeednTorqCtrlM2};
+NTC_Handle_t *pTemperatureSensor[NBR_OF_MOTORS] = {&TempSensor_M1, &TempSensor_M2};
+PID_Handle_t *pPIDIq[NBR_OF_MOTORS]             = {&PIDIqHandle_M1, &PIDIqHandle_M2};
+PID_Handle_t *pPIDId[NBR_OF_MOTORS]             = {&PIDIdHandle_M1, &PIDIdHandle_M2};
+PQD_MotorPowMeas_Handle_t *pMPM[NBR_OF_MOTORS]  = {&PQD_MotorPowMeasM1, &PQD_MotorPowMeasM2};
+#else
 SpeednTorqCtrl_Handle_t *pSTC[NBR_OF_MOTORS]    = {&SpeednTorqCtrlM1};
 NTC_Handle_t *pTemperatureSensor[NBR_OF_MOTORS] = {&TempSensor_M1};
 PID_Handle_t *pPIDIq[NBR_OF_MOTORS]             = {&PIDIqHandle_M1};
 PID_Handle_t *pPIDId[NBR_OF_MOTORS]             = {&PIDIdHandle_M1};
 PQD_MotorPowMeas_Handle_t *pMPM[NBR_OF_MOTORS]  = {&PQD_MotorPowMeasM1};
+#endif
 
 MCI_Handle_t Mci[NBR_OF_MOTORS] =
 {
@@ -317,6 +584,23 @@ MCI_Handle_t Mci[NBR_OF_MOTORS] =
     .PastFaults = MC_NO_FAULTS,
     .CommandState = MCI_BUFFER_EMPTY,
   },
+#if (NBR_OF_MOTORS > 1)
+  {
+    .pSTC = &SpeednTorqCtrlM2,
+    .pFOCVars = &FOCVars[1],
+    .pPWM = &PWM_Handle_M2._Super,
+    .lastCommand = MCI_NOCOMMANDSYET,
+    .hFinalSpeed = 0,
+    .hFinalTorque = 0,
+    .pScale = &scaleParams_M1,
+    .hDurationms = 0,
+    .DirectCommand = MCI_NO_COMMAND,
+    .State = IDLE,
+    .CurrentFaults = MC_NO_FAULTS,
+    .PastFaults = MC_NO_FAULTS,
+    .CommandState = MCI_BUFFER_EMPTY,
+  },
+#endif
 
 };
 
@@ -55,6 +55,40 @@ VirtualSpeedSensor_Handle_t VirtualSpeedSensorM1 =
   .hTransitionSteps            = (int16_t)((TF_REGULATION_RATE * TRANSITION_DURATION) / 1000.0),
 };
 
+#if (NBR_OF_MOTORS > 1)
+/**
+  * @brief  SpeedNPosition sensor parameters Motor 2 - Base Class.
+  */
+VirtualSpeedSensor_Handle_t VirtualSpeedSensorM2 =
+{
+
+  ._Super =
+  {
+    .bElToMecRatio             = POLE_PAIR_NUM,
+    .hMaxReliableMecSpeedUnit  = (uint16_t)(1.15*MAX_APPLICATION_SPEED_UNIT),
+    .hMinReliableMecSpeedUnit  = (uint16_t)(MIN_APPLICATION_SPEED_UNIT),
+    .bMaximumSpeedErrorsNumber = M1_SS_MEAS_ERRORS_BEFORE_FAULTS,
+    .hMaxReliableMecAccelUnitP = 65535,
+    .hMeasurementFrequency     = TF_REGULATION_RATE_SCALED,
+    .DPPConvFactor             = DPP_CONV_FACTOR,
+  },
+
+  .hSpeedSamplingFreqHz        = MEDIUM_FREQUENCY_TASK_RATE,
+  .hTransitionSteps            = (int16_t)((TF_REGULATION_RATE * TRANSITION_DURATION) / 1000.0),
+};
+
+/**
+  * Virtual temperature sensor parameters Motor 2 (no NTC on the second power stage).
+  */
+NTC_Handle_t TempSensor_M2 =
+{
+  .bSensorType     = VIRTUAL_SENSOR,
+  .hExpectedTemp_d = (uint16_t)(((V0_V + (dV_dT * ((int32_t)M2_VIRTUAL_HEAT_SINK_TEMPERATURE_VALUE - T0_C)))
+                                 * 65536) / ADC_REFERENCE_VOLTAGE),
+  .hExpectedTemp_C = M2_VIRTUAL_HEAT_SINK_TEMPERATURE_VALUE,
+};
+#endif
+
 /**
   * temperature sensor parameters Motor 1.
   */
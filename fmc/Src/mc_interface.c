@@ -26,6 +26,7 @@
 #include "speed_torq_ctrl.h"
 #include "mc_interface.h"
 #include "motorcontrol.h"
+#include "fault_rec.h"
 
 #define ROUNDING_OFF
 
@@ -659,6 +660,9 @@ __weak void MCI_FaultProcessing(MCI_Handle_t *pHandle, uint16_t hSetErrors, uint
   else
   {
 #endif
+    /* Freeze the black-box window on the first newly raised fault */
+    FAULT_REC_FREEZE(pHandle, hSetErrors & (uint16_t)(~pHandle->CurrentFaults));
+
     /* Set current errors */
     pHandle->CurrentFaults = (pHandle->CurrentFaults | hSetErrors) & (~hResetErrors);
     pHandle->PastFaults |= hSetErrors;
@@ -128,6 +128,22 @@ __attribute__( ( section ( ".ccmram" ) ) )
   * @retval Stator values q and d in qd_t format
   */
 __weak qd_t MCM_Park(alphabeta_t Input, int16_t Theta)
+{
+  return (MCM_Park_Trig(Input, MCM_Trig_Functions(Theta)));
+}
+
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__( ( section ( ".ccmram" ) ) )
+#endif
+#endif
+/**
+  * @brief  Same as MCM_Park() but with cos/sin of the rotor angle already
+  *         available, e.g. collected with MCM_Trig_Finish().
+  */
+__weak qd_t MCM_Park_Trig(alphabeta_t Input, Trig_Components Local_Vector_Components)
 {
   qd_t Output;
   int32_t d_tmp_1;
@@ -136,9 +152,6 @@ __weak qd_t MCM_Park(alphabeta_t Input, int16_t Theta)
   int32_t q_tmp_2;
   int32_t wqd_tmp;
   int16_t hqd_tmp;
-  Trig_Components Local_Vector_Components;
-
-  Local_Vector_Components = MCM_Trig_Functions(Theta);
 
   /* No overflow guaranteed */
   q_tmp_1 = Input.alpha * ((int32_t )Local_Vector_Components.hCos);
@@ -243,16 +256,29 @@ __attribute__( ( section ( ".ccmram" ) ) )
   * @retval Stator voltage Valpha and Vbeta in qd_t format.
   */
 __weak alphabeta_t MCM_Rev_Park(qd_t Input, int16_t Theta)
+{
+  return (MCM_Rev_Park_Trig(Input, MCM_Trig_Functions(Theta)));
+}
+
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__( ( section ( ".ccmram" ) ) )
+#endif
+#endif
+/**
+  * @brief  Same as MCM_Rev_Park() but with cos/sin of the rotor angle already
+  *         available, so that one CORDIC run can serve both Park and reverse Park.
+  */
+__weak alphabeta_t MCM_Rev_Park_Trig(qd_t Input, Trig_Components Local_Vector_Components)
 {
   int32_t alpha_tmp1;
   int32_t alpha_tmp2;
   int32_t beta_tmp1;
   int32_t beta_tmp2;
-  Trig_Components Local_Vector_Components;
   alphabeta_t Output;
 
-  Local_Vector_Components = MCM_Trig_Functions(Theta);
-
   /* No overflow guaranteed */
   alpha_tmp1 = Input.q * ((int32_t)Local_Vector_Components.hCos);
   alpha_tmp2 = Input.d * ((int32_t)Local_Vector_Components.hSin);
@@ -314,6 +340,8 @@ __weak Trig_Components MCM_Trig_Functions(int16_t hAngle)
     Trig_Components Components;
   } CosSin;
   //cstat +MISRAC2012-Rule-19.2
+  /* A background CORDIC batch (cordic_batch.h) is paused meanwhile */
+  cordic_batch_claim();
   /* Configure CORDIC */
   /* Misra  violation Rule 11.4 A�Conversion�should�not�be�performed�between�a�
    * pointer�to�object and an integer type */
@@ -325,6 +353,55 @@ __weak Trig_Components MCM_Trig_Functions(int16_t hAngle)
   /* Misra  violation Rule�11.4 A�Conversion�should�not�be�performed between�a
    * pointer�to object and an integer type */
   CosSin.CordicRdata = LL_CORDIC_ReadData(CORDIC);
+  cordic_batch_release();
+  return (CosSin.Components); //cstat !UNION-type-punning
+}
+
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__( ( section ( ".ccmram" ) ) )
+#endif
+#endif
+/**
+  * @brief  Launches the CORDIC cosine/sine computation of @p hAngle and returns
+  *         immediately. The result is collected with MCM_Trig_Finish(), so the
+  *         CPU can do unrelated work (current reading, Clarke) meanwhile.
+  * @note   No other CORDIC user (MCM_Sqrt, MCM_Sqrt_Start, MCM_Modulus,
+  *         MCM_PhaseComputation) may run between MCM_Trig_Start() and
+  *         MCM_Trig_Finish(). The caller holds a cordic_batch_claim() (the
+  *         HF task does around the current controller).
+  * @param  hAngle: angle in q1.15 format.
+  */
+__weak void MCM_Trig_Start(int16_t hAngle)
+{
+  WRITE_REG(CORDIC->CSR, CORDIC_CONFIG_COSINE);
+  LL_CORDIC_WriteData(CORDIC, ((uint32_t)0x7FFF0000) + ((uint32_t)hAngle));
+}
+
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__( ( section ( ".ccmram" ) ) )
+#endif
+#endif
+/**
+  * @brief  Collects the result of the computation launched by MCM_Trig_Start().
+  *         Reading RDATA inserts bus wait states until the result is ready, so
+  *         the stall is only what is left of the CORDIC latency.
+  * @retval Trig_Components Cos(angle) and Sin(angle) in Trig_Components format.
+  */
+__weak Trig_Components MCM_Trig_Finish(void)
+{
+  //cstat -MISRAC2012-Rule-19.2
+  union u32toi16x2 {
+    uint32_t CordicRdata;
+    Trig_Components Components;
+  } CosSin;
+  //cstat +MISRAC2012-Rule-19.2
+  CosSin.CordicRdata = LL_CORDIC_ReadData(CORDIC);
   return (CosSin.Components); //cstat !UNION-type-punning
 }
 
@@ -346,21 +423,13 @@ __weak int32_t MCM_Sqrt(int32_t wInput)
 
   if (wInput > 0)
   {
-    uint32_t retVal;
-    /* Disable Irq as sqrt is used in MF and HF task */
+    /* Mask Irq as sqrt is used in MF and HF task; the caller's PRIMASK is kept */
+    uint32_t primask = __get_PRIMASK();
     __disable_irq();
-    /* Configure CORDIC */
-    WRITE_REG(CORDIC->CSR, CORDIC_CONFIG_SQRT);
-    LL_CORDIC_WriteData(CORDIC, ((uint32_t)wInput));
-    /* Read sqrt and return */
-#ifndef FULL_MISRA_C_COMPLIANCY_MC_MATH
-    retVal = (LL_CORDIC_ReadData(CORDIC)) >> 15; //cstat !MISRAC2012-Rule-1.3_n !ATH-shift-neg !MISRAC2012-Rule-10.1_R6
-#else
-    retVal = (LL_CORDIC_ReadData(CORDIC)) / 32768U;
-#endif
-    wtemprootnew = (int32_t)retVal;
-    __enable_irq();
-
+    cordic_batch_claim();
+    wtemprootnew = MCM_Sqrt_Finish(MCM_Sqrt_Start(wInput));
+    cordic_batch_release();
+    __set_PRIMASK(primask);
   }
   else
   {
@@ -33,6 +33,7 @@
 
 #define FREQ_RATIO 1                /* Dummy value for single drive */
 #define FREQ_RELATION HIGHEST_FREQ  /* Dummy value for single drive */
+#define FREQ_RELATION2 LOWEST_FREQ  /* Motor 2 side of the pair, unused with FREQ_RATIO 1 */
 
       /**
   * @brief  Current sensor parameters Motor 1 - three shunt - G4
@@ -127,6 +128,106 @@ const R3_2_Params_t R3_2_ParamsM1 =
 
 };
 
+#if (NBR_OF_MOTORS > 1)
+/**
+  * @brief  Current sensor parameters Motor 2 - three shunt - G4
+  *
+  *  Motor 2 shares ADC1/ADC2 with Motor 1: its injected sequences carry the
+  *  TIM8_TRGO trigger and are queued in JSQR by the TIM8 update interrupt, half
+  *  a PWM period away from the Motor 1 ones (see R3_2_TIMxInit).
+  *  Phase U on IN6 (PC0), V on IN7 (PC1), W on IN8 (PC2).
+  */
+//cstat !MISRAC2012-Rule-8.4
+const R3_2_Params_t R3_2_ParamsM2 =
+{
+/* Dual MC parameters --------------------------------------------------------*/
+  .FreqRatio             = FREQ_RATIO,
+  .IsHigherFreqTim       = FREQ_RELATION2,
+
+/* Current reading A/D Conversions initialization -----------------------------*/
+  .ADCConfig1 = {
+                  (uint32_t)(7U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(6U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(6U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(6U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(6U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(7U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                },
+  .ADCConfig2 = {
+                  (uint32_t)(8U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(8U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(8U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(7U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(7U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                 ,(uint32_t)(8U << ADC_JSQR_JSQ1_Pos)
+                | (LL_ADC_INJ_TRIG_EXT_TIM8_TRGO & ~ADC_INJ_TRIG_EXT_EDGE_DEFAULT)
+                },
+
+  .ADCDataReg1 = {
+                   ADC1
+                  ,ADC1
+                  ,ADC1
+                  ,ADC1
+                  ,ADC1
+                  ,ADC1
+                 },
+  .ADCDataReg2 = {
+                   ADC2
+                  ,ADC2
+                  ,ADC2
+                  ,ADC2
+                  ,ADC2
+                  ,ADC2
+                  },
+ //cstat +MISRAC2012-Rule-12.1 +MISRAC2012-Rule-10.1_R6
+
+  /* PWM generation parameters --------------------------------------------------*/
+  .RepetitionCounter     = REP_COUNTER2,
+  .Tafter                = TW_AFTER,
+  .Tbefore               = TW_BEFORE,
+  .Tcase2                = ((uint16_t)TDEAD + (uint16_t)TNOISE + (uint16_t)TW_BEFORE) / 2u,
+  .Tcase3                = (uint16_t)TW_BEFORE + (uint16_t)TDEAD + (uint16_t)TRISE,
+  .TIMx                  = TIM8,
+
+/* Internal OPAMP common settings --------------------------------------------*/
+  .OPAMPParams           = MC_NULL,
+
+/* Internal COMP settings ----------------------------------------------------*/
+  .CompOCPASelection     = MC_NULL,
+  .CompOCPAInvInput_MODE = NONE,
+  .CompOCPBSelection     = MC_NULL,
+  .CompOCPBInvInput_MODE = NONE,
+  .CompOCPCSelection     = MC_NULL,
+  .CompOCPCInvInput_MODE = NONE,
+  .DAC_OCP_ASelection    = MC_NULL,
+  .DAC_OCP_BSelection    = MC_NULL,
+  .DAC_OCP_CSelection    = MC_NULL,
+  .DAC_Channel_OCPA      = (uint32_t)0,
+  .DAC_Channel_OCPB      = (uint32_t)0,
+  .DAC_Channel_OCPC      = (uint32_t)0,
+  .CompOVPSelection      = MC_NULL,
+  .CompOVPInvInput_MODE  = NONE,
+  .DAC_OVP_Selection     = MC_NULL,
+  .DAC_Channel_OVP       = (uint32_t)0,
+
+/* DAC settings --------------------------------------------------------------*/
+  .DAC_OCP_Threshold     = 0,
+  .DAC_OVP_Threshold     = 23830,
+
+};
+#endif
+
 ScaleParams_t scaleParams_M1 =
 {
  .voltage = NOMINAL_BUS_VOLTAGE_V/(1.73205 * 32767), /* sqrt(3) = 1.73205 */
@@ -36,7 +36,8 @@
 #include "mc_app_hooks.h"
 
 /* USER CODE BEGIN Includes */
-
+#include "hf_prof.h"
+#include "pwm_gov.h"
 /* USER CODE END Includes */
 
 /* USER CODE BEGIN Private define */
@@ -54,6 +55,16 @@ static uint16_t hMFTaskCounterM1 = 0; //cstat !MISRAC2012-Rule-8.9_a
 static volatile uint16_t hBootCapDelayCounterM1 = ((uint16_t)0);
 static volatile uint16_t hStopPermanencyCounterM1 = ((uint16_t)0);
 static volatile uint8_t bMCBootCompleted = ((uint8_t)0);
+#if (NBR_OF_MOTORS > 1)
+static volatile uint16_t hBootCapDelayCounterM2 = ((uint16_t)0);
+static volatile uint16_t hStopPermanencyCounterM2 = ((uint16_t)0);
+
+/* Motors whose ADC injected conversion is queued: tail written by the TIMx update IRQs
+   (same priority, never nested), head by the ADC1_2 IRQ (TSK_HighFrequencyTask). */
+static volatile uint8_t FOC_array[2] = {0, 0};
+static volatile uint8_t FOC_array_head = 0; /* Next motor to be served by the HF task */
+static volatile uint8_t FOC_array_tail = 0; /* Next free slot */
+#endif
 
 #define M1_CHARGE_BOOT_CAP_TICKS          (((uint16_t)SYS_TICK_FREQUENCY * (uint16_t)10) / 1000U)
 #define M1_CHARGE_BOOT_CAP_DUTY_CYCLES ((uint32_t)0.000\
@@ -68,6 +79,9 @@ static volatile uint8_t bMCBootCompleted = ((uint8_t)0);
 
 /* Private functions ---------------------------------------------------------*/
 void TSK_MediumFrequencyTaskM1(void);
+#if (NBR_OF_MOTORS > 1)
+void TSK_MediumFrequencyTaskM2(void);
+#endif
 void TSK_MF_StopProcessing(uint8_t motor);
 MCI_Handle_t *GetMCI(uint8_t bMotor);
 void TSK_SafetyTask_PWMOFF(uint8_t motor);
@@ -101,6 +115,9 @@ __weak void MCboot( MCI_Handle_t* pMCIList[NBR_OF_MOTORS] )
     /*    FOC initialization         */
     /*************************************************/
     pMCIList[M1] = &Mci[M1];
+#if (NBR_OF_MOTORS > 1)
+    pMCIList[M2] = &Mci[M2];
+#endif
     FOC_Init();
 
     ASPEP_start(&aspepOverUartA);
@@ -112,11 +129,17 @@ __weak void MCboot( MCI_Handle_t* pMCIList[NBR_OF_MOTORS] )
     /*   PID component initialization: speed regulation   */
     /******************************************************/
     PID_HandleInit(&PIDSpeedHandle_M1);
+#if (NBR_OF_MOTORS > 1)
+    PID_HandleInit(&PIDSpeedHandle_M2);
+#endif
 
     /****************************************************/
     /*   Virtual speed sensor component initialization  */
     /****************************************************/
     VSS_Init(&VirtualSpeedSensorM1);
+#if (NBR_OF_MOTORS > 1)
+    VSS_Init(&VirtualSpeedSensorM2);
+#endif
 
     /********************************************************/
     /*   Bus voltage sensor component initialization        */
@@ -129,6 +152,10 @@ __weak void MCboot( MCI_Handle_t* pMCIList[NBR_OF_MOTORS] )
     /*******************************************************/
     (void)RCM_RegisterRegConv(&TempRegConv_M1);
     NTC_Init(&TempSensor_M1);
+#if (NBR_OF_MOTORS > 1)
+    /* M2 has no temperature input: virtual sensor, nothing to register */
+    NTC_Init(&TempSensor_M2);
+#endif
 
     /* Applicative hook in MCBoot() */
     MC_APP_BootHook();
@@ -139,6 +166,7 @@ __weak void MCboot( MCI_Handle_t* pMCIList[NBR_OF_MOTORS] )
     startTimers();
 
     /* USER CODE BEGIN MCboot 2 */
+    pwm_gov_init();
 
     /* USER CODE END MCboot 2 */
 
@@ -184,6 +212,10 @@ __weak void MC_RunMotorControlTasks(void)
 
       /* Applicative hook at end of Medium Frequency for Motor 1 */
       MC_APP_PostMediumFrequencyHook_M1();
+#if (NBR_OF_MOTORS > 1)
+      /* Both drives share the speed loop rate: M2 runs in the same slot */
+      TSK_MediumFrequencyTaskM2();
+#endif
 
       MCP_Over_UartA.rxBuffer = MCP_Over_UartA.pTransportLayer->fRXPacketProcess(MCP_Over_UartA.pTransportLayer,
                                                                                 &MCP_Over_UartA.rxLength);
@@ -210,6 +242,8 @@ __weak void MC_RunMotorControlTasks(void)
       }
 
       /* USER CODE BEGIN MC_Scheduler 1 */
+      /* PWM / FOC rate governor: decides at the speed loop rate, the HF task applies */
+      PWM_GOV_MF_STEP();
 
       /* USER CODE END MC_Scheduler 1 */
 
@@ -231,6 +265,24 @@ __weak void MC_RunMotorControlTasks(void)
     {
       /* Nothing to do */
     }
+#if (NBR_OF_MOTORS > 1)
+    if(hBootCapDelayCounterM2 > 0U)
+    {
+      hBootCapDelayCounterM2--;
+    }
+    else
+    {
+      /* Nothing to do */
+    }
+    if(hStopPermanencyCounterM2 > 0U)
+    {
+      hStopPermanencyCounterM2--;
+    }
+    else
+    {
+      /* Nothing to do */
+    }
+#endif
   /* USER CODE BEGIN MC_Scheduler 2 */
 
   /* USER CODE END MC_Scheduler 2 */
@@ -295,6 +347,77 @@ __weak bool TSK_StopPermanencyTimeHasElapsedM1(void)
   return (retVal);
 }
 
+#if (NBR_OF_MOTORS > 1)
+/**
+  * @brief  It set a counter intended to be used for counting the delay required
+  *         for drivers boot capacitors charging of motor 2.
+  * @param  hTickCount number of ticks to be counted.
+  * @retval void
+  */
+__weak void TSK_SetChargeBootCapDelayM2(uint16_t hTickCount)
+{
+  hBootCapDelayCounterM2 = hTickCount;
+}
+
+/**
+  * @brief  Use this function to know whether the time required to charge boot
+  *         capacitors of motor 2 has elapsed.
+  * @param  none
+  * @retval bool true if time has elapsed, false otherwise.
+  */
+__weak bool TSK_ChargeBootCapDelayHasElapsedM2(void)
+{
+  bool retVal = false;
+  if (((uint16_t)0) == hBootCapDelayCounterM2)
+  {
+    retVal = true;
+  }
+  return (retVal);
+}
+
+/**
+  * @brief  It set a counter intended to be used for counting the permanency
+  *         time in STOP state of motor 2.
+  * @param  hTickCount number of ticks to be counted.
+  * @retval void
+  */
+__weak void TSK_SetStopPermanencyTimeM2(uint16_t hTickCount)
+{
+  hStopPermanencyCounterM2 = hTickCount;
+}
+
+/**
+  * @brief  Use this function to know whether the permanency time in STOP state
+  *         of motor 2 has elapsed.
+  * @param  none
+  * @retval bool true if time is elapsed, false otherwise.
+  */
+__weak bool TSK_StopPermanencyTimeHasElapsedM2(void)
+{
+  bool retVal = false;
+  if (((uint16_t)0) == hStopPermanencyCounterM2)
+  {
+    retVal = true;
+  }
+  return (retVal);
+}
+
+/**
+  * @brief  Queues the motor whose injected conversion has just been armed.
+  *
+  *  Called from the TIMx update IRQ of each drive once R3_2_TIMx_UP_IRQHandler() has
+  * loaded its JSQR. The ADC1_2 IRQ pops the entries in the same order, so
+  * TSK_HighFrequencyTask() runs the FOC of the motor whose currents were just sampled.
+  * @param  Motor Motor reference number defined
+  *         \link Motors_reference_number here \endlink.
+  */
+__weak void TSK_DualDriveFIFOUpdate(uint8_t Motor)
+{
+  FOC_array[FOC_array_tail] = Motor;
+  FOC_array_tail = (FOC_array_tail + 1U) & 1U;
+}
+#endif
+
 #if defined (CCMRAM)
 #if defined (__ICCARM__)
 #pragma location = ".ccmram"
@@ -314,25 +437,45 @@ __attribute__((section (".ccmram")))
 __weak uint8_t TSK_HighFrequencyTask(void)
 {
   uint8_t bMotorNbr;
+#if (NBR_OF_MOTORS > 1)
+  bMotorNbr = FOC_array[FOC_array_head];
+  FOC_array_head = (FOC_array_head + 1U) & 1U;
+#else
   bMotorNbr = 0;
+#endif
 
   /* USER CODE BEGIN HighFrequencyTask 0 */
+  /* Pending PWM profile first: the CCRs computed below already use the new period */
+  PWM_GOV_HF_ENTER(t_gov);
 
   /* USER CODE END HighFrequencyTask 0 */
+  HF_PROF_BEGIN(t_hf);
   FOC_HighFrequencyTask(bMotorNbr);
+  HF_PROF_END((hf_prof_stage_t)((uint32_t)HF_PROF_HF_M1 + bMotorNbr), t_hf);
 
   /* USER CODE BEGIN HighFrequencyTask 1 */
 
   /* USER CODE END HighFrequencyTask 1 */
-  GLOBAL_TIMESTAMP++;
-  if (0U == MCPA_UART_A.Mark)
+  if (M1 == bMotorNbr)
   {
-    /* Nothing to do */
+    /* Time stamp and MCPA log follow the M1 PWM rate */
+    GLOBAL_TIMESTAMP++;
+    if (0U == MCPA_UART_A.Mark)
+    {
+      /* Nothing to do */
+    }
+    else
+    {
+      HF_PROF_BEGIN(t_mcpa);
+      MCPA_dataLog (&MCPA_UART_A);
+      HF_PROF_END(HF_PROF_MCPA_LOG, t_mcpa);
+    }
   }
   else
   {
-    MCPA_dataLog (&MCPA_UART_A);
+    /* Nothing to do */
   }
+  PWM_GOV_HF_EXIT(t_gov);
 
   return (bMotorNbr);
 
@@ -351,6 +494,9 @@ __weak void TSK_SafetyTask(void)
   if (1U == bMCBootCompleted)
   {
     TSK_SafetyTask_PWMOFF(M1);
+#if (NBR_OF_MOTORS > 1)
+    TSK_SafetyTask_PWMOFF(M2);
+#endif
   /* USER CODE BEGIN TSK_SafetyTask 1 */
 
   /* USER CODE END TSK_SafetyTask 1 */
@@ -372,28 +518,51 @@ __weak void TSK_SafetyTask_PWMOFF(uint8_t bMotor)
 
   /* USER CODE END TSK_SafetyTask_PWMOFF 0 */
   uint16_t CodeReturn = MC_NO_ERROR;
-  uint8_t lbmotor = M1;
+#if (NBR_OF_MOTORS > 1)
+  const uint16_t errMask[NBR_OF_MOTORS] = {VBUS_TEMP_ERR_MASK, VBUS_TEMP_ERR_MASK};
+#else
   const uint16_t errMask[NBR_OF_MOTORS] = {VBUS_TEMP_ERR_MASK};
+#endif
   /* Check for fault if FW protection is activated. It returns MC_OVER_TEMP or MC_NO_ERROR */
   if (M1 == bMotor)
   {
     uint16_t rawValueM1 = RCM_GetRegularConv(&TempRegConv_M1);
     CodeReturn |= errMask[bMotor] & NTC_CalcAvTemp(&TempSensor_M1, rawValueM1);
   }
+#if (NBR_OF_MOTORS > 1)
+  else if (M2 == bMotor)
+  {
+    /* Virtual sensor: the raw value is ignored */
+    CodeReturn |= errMask[bMotor] & NTC_CalcAvTemp(&TempSensor_M2, 0U);
+  }
+#endif
   else
   {
     /* Nothing to do */
   }
 
-/* Due to warning array subscript 1 is above array bounds of PWMC_Handle_t *[1] [-Warray-bounds] */
-   CodeReturn |= PWMC_IsFaultOccurred(pwmcHandle[lbmotor]);     /* check for fault. It return MC_OVER_CURR or MC_NO_FAULTS
+  if (bMotor < NBR_OF_MOTORS)
+  {
+    CodeReturn |= PWMC_IsFaultOccurred(pwmcHandle[bMotor]);   /* check for fault. It return MC_OVER_CURR or MC_NO_FAULTS
                                                      (for STM32F30x can return MC_OVER_VOLT in case of HW Overvoltage) */
+  }
+  else
+  {
+    /* Nothing to do */
+  }
 
   if (M1 == bMotor)
   {
     uint16_t rawValueM1 =  RCM_GetRegularConv(&VbusRegConv_M1);
     CodeReturn |= errMask[bMotor] & RVBS_CalcAvVbus(&BusVoltageSensor_M1, rawValueM1);
   }
+#if (NBR_OF_MOTORS > 1)
+  else if (M2 == bMotor)
+  {
+    /* Both drives sit on the same DC link: M2 takes the state M1 has just computed */
+    CodeReturn |= errMask[bMotor] & VBS_CheckVbus(&BusVoltageSensor_M1._Super);
+  }
+#endif
   else
   {
     /* Nothing to do */
@@ -431,6 +600,10 @@ __weak void TSK_HardwareFaultTask(void)
   /* USER CODE END TSK_HardwareFaultTask 0 */
    FOC_Clear(M1);
   MCI_FaultProcessing(&Mci[M1], MC_SW_ERROR, 0);
+#if (NBR_OF_MOTORS > 1)
+  FOC_Clear(M2);
+  MCI_FaultProcessing(&Mci[M2], MC_SW_ERROR, 0);
+#endif
 
   /* USER CODE BEGIN TSK_HardwareFaultTask 1 */
 
@@ -469,6 +642,17 @@ LL_GPIO_LockPin(M1_PWM_EN_W_GPIO_Port, M1_PWM_EN_W_Pin);
 LL_GPIO_LockPin(M1_CURR_AMPL_U_GPIO_Port, M1_CURR_AMPL_U_Pin);
 LL_GPIO_LockPin(M1_BUS_VOLTAGE_GPIO_Port, M1_BUS_VOLTAGE_Pin);
 LL_GPIO_LockPin(M1_CURR_AMPL_V_GPIO_Port, M1_CURR_AMPL_V_Pin);
+#if (NBR_OF_MOTORS > 1)
+LL_GPIO_LockPin(M2_PWM_UH_GPIO_Port, M2_PWM_UH_Pin);
+LL_GPIO_LockPin(M2_PWM_VH_GPIO_Port, M2_PWM_VH_Pin);
+LL_GPIO_LockPin(M2_PWM_WH_GPIO_Port, M2_PWM_WH_Pin);
+LL_GPIO_LockPin(M2_PWM_EN_U_GPIO_Port, M2_PWM_EN_U_Pin);
+LL_GPIO_LockPin(M2_PWM_EN_V_GPIO_Port, M2_PWM_EN_V_Pin);
+LL_GPIO_LockPin(M2_PWM_EN_W_GPIO_Port, M2_PWM_EN_W_Pin);
+LL_GPIO_LockPin(M2_CURR_AMPL_U_GPIO_Port, M2_CURR_AMPL_U_Pin);
+LL_GPIO_LockPin(M2_CURR_AMPL_V_GPIO_Port, M2_CURR_AMPL_V_Pin);
+LL_GPIO_LockPin(M2_CURR_AMPL_W_GPIO_Port, M2_CURR_AMPL_W_Pin);
+#endif
 }
 /* USER CODE BEGIN mc_task 0 */
 
@@ -36,7 +36,11 @@
 #include "mc_app_hooks.h"
 
 /* USER CODE BEGIN Includes */
-
+#include "hf_prof.h"
+#include "blog.h"
+#include "obs_cap.h"
+#include "fault_rec.h"
+#include "cordic_batch.h"
 /* USER CODE END Includes */
 
 /* USER CODE BEGIN Private define */
@@ -60,12 +64,18 @@ static volatile uint16_t hStopPermanencyCounterM1 = ((uint16_t)0);
 
 /* Private functions ---------------------------------------------------------*/
 void TSK_MediumFrequencyTaskM1(void);
+#if (NBR_OF_MOTORS > 1)
+void TSK_MediumFrequencyTaskM2(void);
+#endif
 void FOC_InitAdditionalMethods(uint8_t bMotor);
 void FOC_CalcCurrRef(uint8_t bMotor);
 void TSK_MF_StopProcessing(uint8_t motor);
 
 MCI_Handle_t *GetMCI(uint8_t bMotor);
 static uint16_t FOC_CurrControllerM1(void);
+#if (NBR_OF_MOTORS > 1)
+static uint16_t FOC_CurrControllerM2(void);
+#endif
 
 void TSK_SafetyTask_PWMOFF(uint8_t motor);
 
@@ -137,6 +147,37 @@ __weak void FOC_Init(void)
     MCI_ExecSpeedRamp(&Mci[M1],
     STC_GetMecSpeedRefUnitDefault(pSTC[M1]),0); /* First command to STC */
 
+#if (NBR_OF_MOTORS > 1)
+    /**********************************************************/
+    /*    Motor 2 on TIM8, current sensing on ADC1/ADC2       */
+    /**********************************************************/
+    pwmcHandle[M2] = &PWM_Handle_M2._Super;
+    R3_2_Init(&PWM_Handle_M2);
+
+    PID_HandleInit(&PIDSpeedHandle_M2);
+    STO_PLL_Init (&STO_PLL_M2);
+    STC_Init(pSTC[M2],&PIDSpeedHandle_M2, &STO_PLL_M2._Super);
+    RUC_Init(&RevUpControlM2, pSTC[M2], &VirtualSpeedSensorM2, &STO_M2, pwmcHandle[M2]);
+    PID_HandleInit(&PIDIqHandle_M2);
+    PID_HandleInit(&PIDIdHandle_M2);
+
+    /* Both drives hang on the same DC bus */
+    pMPM[M2]->pVBS = &(BusVoltageSensor_M1._Super);
+    pMPM[M2]->pFOCVars = &FOCVars[M2];
+
+    pREMNG[M2] = &RampExtMngrHFParamsM2;
+    REMNG_Init(pREMNG[M2]);
+
+    FOC_Clear(M2);
+    STC_Clear(pSTC[M2]);
+    FOCVars[M2].bDriveInput = EXTERNAL;
+    FOCVars[M2].Iqdref = STC_GetDefaultIqdref(pSTC[M2]);
+    FOCVars[M2].UserIdref = STC_GetDefaultIqdref(pSTC[M2]).d;
+
+    MCI_ExecSpeedRamp(&Mci[M2],
+    STC_GetMecSpeedRefUnitDefault(pSTC[M2]),0); /* First command to STC */
+#endif
+
     /* USER CODE BEGIN MCboot 2 */
 
     /* USER CODE END MCboot 2 */
@@ -153,7 +194,16 @@ void TSK_MF_StopProcessing(uint8_t motor)
   FOC_Clear(motor);
   STC_Clear(pSTC[motor]);
 
-  TSK_SetStopPermanencyTimeM1(STOPPERMANENCY_TICKS);
+#if (NBR_OF_MOTORS > 1)
+  if (M2 == motor)
+  {
+    TSK_SetStopPermanencyTimeM2(STOPPERMANENCY_TICKS2);
+  }
+  else
+#endif
+  {
+    TSK_SetStopPermanencyTimeM1(STOPPERMANENCY_TICKS);
+  }
   Mci[motor].State = STOP;
 }
 
@@ -461,6 +511,313 @@ __weak void TSK_MediumFrequencyTaskM1(void)
   /* USER CODE END MediumFrequencyTask M1 6 */
 }
 
+#if (NBR_OF_MOTORS > 1)
+/**
+  * @brief Executes medium frequency periodic Motor Control tasks
+  *
+  * This function performs some of the control duties on Motor 2 according to the
+  * present state of its state machine. In particular, duties requiring a periodic
+  * execution at a medium frequency rate (such as the speed controller for instance)
+  * are executed here.
+  */
+__weak void TSK_MediumFrequencyTaskM2(void)
+{
+  /* USER CODE BEGIN MediumFrequencyTask M2 0 */
+
+  /* USER CODE END MediumFrequencyTask M2 0 */
+
+  int16_t wAux = 0;
+  (void)STO_PLL_CalcAvrgMecSpeedUnit(&STO_PLL_M2, &wAux);
+  PQD_CalcElMotorPower(pMPM[M2]);
+
+  if (MCI_GetCurrentFaults(&Mci[M2]) == MC_NO_FAULTS)
+  {
+    if (MCI_GetOccurredFaults(&Mci[M2]) == MC_NO_FAULTS)
+    {
+      switch (Mci[M2].State)
+      {
+
+        case IDLE:
+        {
+          if ((MCI_START == Mci[M2].DirectCommand) || (MCI_MEASURE_OFFSETS == Mci[M2].DirectCommand))
+          {
+              RUC_Clear(&RevUpControlM2, MCI_GetImposedMotorDirection(&Mci[M2]));
+            if (pwmcHandle[M2]->offsetCalibStatus == false)
+            {
+              (void)PWMC_CurrentReadingCalibr(pwmcHandle[M2], CRC_START);
+              Mci[M2].State = OFFSET_CALIB;
+            }
+            else
+            {
+              /* Calibration already done. Enables only TIM channels */
+              pwmcHandle[M2]->OffCalibrWaitTimeCounter = 1u;
+              (void)PWMC_CurrentReadingCalibr(pwmcHandle[M2], CRC_EXEC);
+
+              R3_2_TurnOnLowSides(pwmcHandle[M2],M2_CHARGE_BOOT_CAP_DUTY_CYCLES);
+              TSK_SetChargeBootCapDelayM2(M2_CHARGE_BOOT_CAP_TICKS);
+              Mci[M2].State = CHARGE_BOOT_CAP;
+            }
+          }
+          else
+          {
+            /* Nothing to be done, FW stays in IDLE state */
+          }
+          break;
+        }
+
+        case OFFSET_CALIB:
+        {
+          if (MCI_STOP == Mci[M2].DirectCommand)
+          {
+            TSK_MF_StopProcessing(M2);
+          }
+          else
+          {
+            if (PWMC_CurrentReadingCalibr(pwmcHandle[M2], CRC_EXEC))
+            {
+              if (MCI_MEASURE_OFFSETS == Mci[M2].DirectCommand)
+              {
+                FOC_Clear(M2);
+                STC_Clear(pSTC[M2]);
+                Mci[M2].DirectCommand = MCI_NO_COMMAND;
+                Mci[M2].State = IDLE;
+              }
+              else
+              {
+                R3_2_TurnOnLowSides(pwmcHandle[M2],M2_CHARGE_BOOT_CAP_DUTY_CYCLES);
+                TSK_SetChargeBootCapDelayM2(M2_CHARGE_BOOT_CAP_TICKS);
+                Mci[M2].State = CHARGE_BOOT_CAP;
+              }
+            }
+            else
+            {
+              /* Nothing to be done, FW waits for offset calibration to finish */
+            }
+          }
+          break;
+        }
+
+        case CHARGE_BOOT_CAP:
+        {
+          if (MCI_STOP == Mci[M2].DirectCommand)
+          {
+            TSK_MF_StopProcessing(M2);
+          }
+          else
+          {
+            if (TSK_ChargeBootCapDelayHasElapsedM2())
+            {
+              R3_2_SwitchOffPWM(pwmcHandle[M2]);
+              FOCVars[M2].bDriveInput = EXTERNAL;
+              STC_SetSpeedSensor( pSTC[M2], &VirtualSpeedSensorM2._Super );
+
+              STO_PLL_Clear(&STO_PLL_M2);
+
+              FOC_Clear( M2 );
+
+                Mci[M2].State = START;
+              PWMC_SwitchOnPWM(pwmcHandle[M2]);
+            }
+            else
+            {
+              /* Nothing to be done, FW waits for bootstrap capacitor to charge */
+            }
+          }
+          break;
+        }
+
+        case START:
+        {
+          if (MCI_STOP == Mci[M2].DirectCommand)
+          {
+            TSK_MF_StopProcessing(M2);
+          }
+          else
+          {
+            /* Mechanical speed as imposed by the Virtual Speed Sensor during the Rev Up phase. */
+            int16_t hForcedMecSpeedUnit;
+            qd_t IqdRef;
+            bool ObserverConverged;
+
+            /* Execute the Rev Up procedure */
+            if(! RUC_Exec(&RevUpControlM2))
+            {
+            /* The time allowed for the startup sequence has expired */
+              MCI_FaultProcessing(&Mci[M2], MC_START_UP, 0);
+            }
+            else
+            {
+              /* Execute the torque open loop current start-up ramp:
+               * Compute the Iq reference current as configured in the Rev Up sequence */
+              IqdRef.q = STC_CalcTorqueReference(pSTC[M2]);
+              IqdRef.d = FOCVars[M2].UserIdref;
+              /* Iqd reference current used by the High Frequency Loop to generate the PWM output */
+              FOCVars[M2].Iqdref = IqdRef;
+           }
+
+            (void)VSS_CalcAvrgMecSpeedUnit(&VirtualSpeedSensorM2, &hForcedMecSpeedUnit);
+
+            /* Check that startup stage where the observer has to be used has been reached */
+            if (true == RUC_FirstAccelerationStageReached(&RevUpControlM2))
+            {
+              ObserverConverged = STO_PLL_IsObserverConverged(&STO_PLL_M2, &hForcedMecSpeedUnit);
+              STO_SetDirection(&STO_PLL_M2, (int8_t)MCI_GetImposedMotorDirection(&Mci[M2]));
+
+              (void)VSS_SetStartTransition(&VirtualSpeedSensorM2, ObserverConverged);
+            }
+            else
+            {
+              ObserverConverged = false;
+            }
+            if (ObserverConverged)
+            {
+              qd_t StatorCurrent = MCM_Park(FOCVars[M2].Ialphabeta, SPD_GetElAngle(&STO_PLL_M2._Super));
+
+              /* Start switch over ramp. This ramp will transition from the revup to the closed loop FOC */
+              REMNG_Init(pREMNG[M2]);
+              (void)REMNG_ExecRamp(pREMNG[M2], FOCVars[M2].Iqdref.q, 0);
+              (void)REMNG_ExecRamp(pREMNG[M2], StatorCurrent.q, TRANSITION_DURATION);
+
+              Mci[M2].State = SWITCH_OVER;
+            }
+          }
+          break;
+        }
+
+        case SWITCH_OVER:
+        {
+          if (MCI_STOP == Mci[M2].DirectCommand)
+          {
+            TSK_MF_StopProcessing(M2);
+          }
+          else
+          {
+            int16_t hForcedMecSpeedUnit;
+
+            /* Compute the virtual speed and positions of the rotor.
+               The function returns true if the virtual speed is in the reliability range */
+            bool FlagEnableClosedLoop = VSS_CalcAvrgMecSpeedUnit(&VirtualSpeedSensorM2, &hForcedMecSpeedUnit);
+            /* Check if the transition ramp has completed. */
+            bool FlagTransitionPhaseCompleted = VSS_TransitionEnded(&VirtualSpeedSensorM2);
+            FlagEnableClosedLoop = FlagEnableClosedLoop || FlagTransitionPhaseCompleted;
+
+            /* If any of the above conditions is true, the loop is considered closed.
+               The state machine transitions to the RUN state */
+            if (true == FlagEnableClosedLoop)
+            {
+#if PID_SPEED_INTEGRAL_INIT_DIV == 0
+              PID_SetIntegralTerm(&PIDSpeedHandle_M2, 0);
+#else
+              PID_SetIntegralTerm(&PIDSpeedHandle_M2,
+                                  (((int32_t)FOCVars[M2].Iqdref.q * (int16_t)PID_GetKIDivisor(&PIDSpeedHandle_M2))
+                                  / PID_SPEED_INTEGRAL_INIT_DIV));
+#endif
+              /* USER CODE BEGIN MediumFrequencyTask M2 1 */
+
+              /* USER CODE END MediumFrequencyTask M2 1 */
+              STC_SetSpeedSensor(pSTC[M2], &STO_PLL_M2._Super); /* Observer has converged */
+              FOC_InitAdditionalMethods(M2);
+              FOC_CalcCurrRef(M2);
+              STC_ForceSpeedReferenceToCurrentSpeed(pSTC[M2]); /* Init the reference speed to current speed */
+              MCI_ExecBufferedCommands(&Mci[M2]); /* Exec the speed ramp after changing of the speed sensor */
+              Mci[M2].State = RUN;
+            }
+            else if ((FlagTransitionPhaseCompleted == true) && (FlagEnableClosedLoop == false))
+            {
+              /* The transition time from Open-Loop to Close-Loop allowed has expired */
+              MCI_FaultProcessing(&Mci[M2], MC_START_UP, 0);
+            }
+          }
+          break;
+        }
+
+        case RUN:
+        {
+          if (MCI_STOP == Mci[M2].DirectCommand)
+          {
+            TSK_MF_StopProcessing(M2);
+          }
+          else
+          {
+            /* USER CODE BEGIN MediumFrequencyTask M2 2 */
+
+            /* USER CODE END MediumFrequencyTask M2 2 */
+
+            MCI_ExecBufferedCommands(&Mci[M2]);
+
+              FOC_CalcCurrRef(M2);
+              if(!SPD_Check((SpeednPosFdbk_Handle_t *)&STO_PLL_M2))
+              {
+                MCI_FaultProcessing(&Mci[M2], MC_SPEED_FDBK, 0);
+              }
+              else
+              {
+                /* Nothing to do */
+              }
+          }
+          break;
+        }
+
+        case STOP:
+        {
+          if (TSK_StopPermanencyTimeHasElapsedM2())
+          {
+
+            STC_SetSpeedSensor(pSTC[M2], &VirtualSpeedSensorM2._Super);    /* Sensor-less */
+            VSS_Clear(&VirtualSpeedSensorM2); /* Reset measured speed in IDLE */
+            /* USER CODE BEGIN MediumFrequencyTask M2 5 */
+
+            /* USER CODE END MediumFrequencyTask M2 5 */
+            Mci[M2].DirectCommand = MCI_NO_COMMAND;
+            Mci[M2].State = IDLE;
+          }
+          else
+          {
+            /* Nothing to do, FW waits for to stop */
+          }
+          break;
+        }
+
+        case FAULT_OVER:
+        {
+          if (MCI_ACK_FAULTS == Mci[M2].DirectCommand)
+          {
+            Mci[M2].DirectCommand = MCI_NO_COMMAND;
+            Mci[M2].State = IDLE;
+          }
+          else
+          {
+            /* Nothing to do, FW stays in FAULT_OVER state until acknowledgement */
+          }
+          break;
+        }
+
+        case FAULT_NOW:
+        {
+          Mci[M2].State = FAULT_OVER;
+          break;
+        }
+
+        default:
+          break;
+       }
+    }
+    else
+    {
+      Mci[M2].State = FAULT_OVER;
+    }
+  }
+  else
+  {
+    Mci[M2].State = FAULT_NOW;
+  }
+  /* USER CODE BEGIN MediumFrequencyTask M2 6 */
+
+  /* USER CODE END MediumFrequencyTask M2 6 */
+}
+
+#endif
+
 /**
   * @brief  It re-initializes the current and voltage variables. Moreover
   *         it clears qd currents PI controllers, voltage sensor and SpeednTorque
@@ -587,69 +944,154 @@ __weak uint8_t FOC_HighFrequencyTask(uint8_t bMotorNbr)
 
   /* USER CODE END HighFrequencyTask 0 */
 
-  RCM_ReadOngoingConv();
-  RCM_ExecNextConv();
   Observer_Inputs_t STO_Inputs; /* Only if sensorless main */
 
-  STO_Inputs.Valfa_beta = FOCVars[M1].Valphabeta;  /* Only if sensorless */
-  if (SWITCH_OVER == Mci[M1].State)
+  if (M1 == bMotorNbr)
   {
-    if (!REMNG_RampCompleted(pREMNG[M1]))
+#if (RCM_USE_DMA == 0)
+    HF_PROF_BEGIN(t_rcm_read);
+    RCM_ReadOngoingConv();
+    HF_PROF_END(HF_PROF_RCM_READ, t_rcm_read);
+    HF_PROF_BEGIN(t_rcm_exec);
+    RCM_ExecNextConv();
+    HF_PROF_END(HF_PROF_RCM_EXEC, t_rcm_exec);
+#endif
+    STO_Inputs.Valfa_beta = FOCVars[M1].Valphabeta;  /* Only if sensorless */
+    if (SWITCH_OVER == Mci[M1].State)
     {
-      FOCVars[M1].Iqdref.q = (int16_t)REMNG_Calc(pREMNG[M1]);
+      if (!REMNG_RampCompleted(pREMNG[M1]))
+      {
+        FOCVars[M1].Iqdref.q = (int16_t)REMNG_Calc(pREMNG[M1]);
+      }
+      else
+      {
+        /* Nothing to do */
+      }
     }
     else
     {
       /* Nothing to do */
     }
-  }
-  else
-  {
-    /* Nothing to do */
-  }
-  /* USER CODE BEGIN HighFrequencyTask SINGLEDRIVE_1 */
-
-  /* USER CODE END HighFrequencyTask SINGLEDRIVE_1 */
-  hFOCreturn = FOC_CurrControllerM1();
-  /* USER CODE BEGIN HighFrequencyTask SINGLEDRIVE_2 */
-
-  /* USER CODE END HighFrequencyTask SINGLEDRIVE_2 */
-  if(hFOCreturn == MC_DURATION)
-  {
-    MCI_FaultProcessing(&Mci[M1], MC_DURATION, 0);
-  }
-  else
-  {
-    bool IsAccelerationStageReached = RUC_FirstAccelerationStageReached(&RevUpControlM1);
-    if ((IDLE != Mci[M1].State) && (FAULT_NOW != Mci[M1].State) && (FAULT_OVER != Mci[M1].State))
+    /* USER CODE BEGIN HighFrequencyTask SINGLEDRIVE_1 */
+    HF_PROF_BEGIN(t_curr_ctrl);
+    /* The current loop owns the CORDIC: a background batch pauses here */
+    cordic_batch_claim();
+    /* USER CODE END HighFrequencyTask SINGLEDRIVE_1 */
+    hFOCreturn = FOC_CurrControllerM1();
+    /* USER CODE BEGIN HighFrequencyTask SINGLEDRIVE_2 */
+    cordic_batch_release();
+    HF_PROF_END(HF_PROF_CURR_CTRL, t_curr_ctrl);
+    HF_PROF_DEADLINE(M1, hFOCreturn);
+    FAULT_REC_HF(hFOCreturn);
+    if (hFOCreturn == MC_DURATION)
     {
-      STO_Inputs.Ialfa_beta = FOCVars[M1].Ialphabeta; /* Only if sensorless */
-      STO_Inputs.Vbus = VBS_GetAvBusVoltage_d(&(BusVoltageSensor_M1._Super)); /* Only for sensorless */
-      (void)STO_PLL_CalcElAngle(&STO_PLL_M1, &STO_Inputs);
+      BLOGE("MC_DURATION: CCR update missed UEV, TIM1 CNT=%u DIR=%u",
+            (uint32_t)TIM1->CNT, (uint32_t)((TIM1->CR1 & TIM_CR1_DIR) != 0U));
+    }
+    /* USER CODE END HighFrequencyTask SINGLEDRIVE_2 */
+    if(hFOCreturn == MC_DURATION)
+    {
+      MCI_FaultProcessing(&Mci[M1], MC_DURATION, 0);
     }
     else
     {
-      /* Nothing to do */
+      bool IsAccelerationStageReached = RUC_FirstAccelerationStageReached(&RevUpControlM1);
+      if ((IDLE != Mci[M1].State) && (FAULT_NOW != Mci[M1].State) && (FAULT_OVER != Mci[M1].State))
+      {
+        STO_Inputs.Ialfa_beta = FOCVars[M1].Ialphabeta; /* Only if sensorless */
+        STO_Inputs.Vbus = VBS_GetAvBusVoltage_d(&(BusVoltageSensor_M1._Super)); /* Only for sensorless */
+        HF_PROF_BEGIN(t_sto_pll);
+        (void)STO_PLL_CalcElAngle(&STO_PLL_M1, &STO_Inputs);
+        HF_PROF_END(HF_PROF_STO_PLL, t_sto_pll);
+      }
+      else
+      {
+        /* Nothing to do */
+      }
+      STO_PLL_CalcAvrgElSpeedDpp(&STO_PLL_M1); /* Only in case of Sensor-less */
+      if (false == IsAccelerationStageReached)
+      {
+        STO_ResetPLL(&STO_PLL_M1);
+      }
+      else
+      {
+        /* Nothing to do */
+      }
+      /* Only for sensor-less */
+      if((START == Mci[M1].State) || (SWITCH_OVER == Mci[M1].State))
+      {
+        int16_t hObsAngle = SPD_GetElAngle(&STO_PLL_M1._Super);
+        (void)VSS_CalcElAngle(&VirtualSpeedSensorM1, &hObsAngle);
+      }
+      /* USER CODE BEGIN HighFrequencyTask SINGLEDRIVE_3 */
+      OBS_CAP_HF(STO_Inputs.Valfa_beta, IsAccelerationStageReached);
+      /* USER CODE END HighFrequencyTask SINGLEDRIVE_3 */
     }
-    STO_PLL_CalcAvrgElSpeedDpp(&STO_PLL_M1); /* Only in case of Sensor-less */
-    if (false == IsAccelerationStageReached)
+  }
+#if (NBR_OF_MOTORS > 1)
+  else /* bMotorNbr != M1 */
+  {
+    STO_Inputs.Valfa_beta = FOCVars[M2].Valphabeta;  /* Only if sensorless */
+    if (SWITCH_OVER == Mci[M2].State)
     {
-      STO_ResetPLL(&STO_PLL_M1);
+      if (!REMNG_RampCompleted(pREMNG[M2]))
+      {
+        FOCVars[M2].Iqdref.q = (int16_t)REMNG_Calc(pREMNG[M2]);
+      }
+      else
+      {
+        /* Nothing to do */
+      }
     }
     else
     {
       /* Nothing to do */
     }
-    /* Only for sensor-less */
-    if((START == Mci[M1].State) || (SWITCH_OVER == Mci[M1].State))
+    HF_PROF_BEGIN(t_curr_ctrl);
+    cordic_batch_claim();
+    hFOCreturn = FOC_CurrControllerM2();
+    cordic_batch_release();
+    HF_PROF_END(HF_PROF_CURR_CTRL_M2, t_curr_ctrl);
+    HF_PROF_DEADLINE(M2, hFOCreturn);
+    if(hFOCreturn == MC_DURATION)
     {
-      int16_t hObsAngle = SPD_GetElAngle(&STO_PLL_M1._Super);
-      (void)VSS_CalcElAngle(&VirtualSpeedSensorM1, &hObsAngle);
+      BLOGE("MC_DURATION M2: CCR update missed UEV, TIM8 CNT=%u DIR=%u",
+            (uint32_t)TIM8->CNT, (uint32_t)((TIM8->CR1 & TIM_CR1_DIR) != 0U));
+      MCI_FaultProcessing(&Mci[M2], MC_DURATION, 0);
+    }
+    else
+    {
+      bool IsAccelerationStageReached = RUC_FirstAccelerationStageReached(&RevUpControlM2);
+      if ((IDLE != Mci[M2].State) && (FAULT_NOW != Mci[M2].State) && (FAULT_OVER != Mci[M2].State))
+      {
+        STO_Inputs.Ialfa_beta = FOCVars[M2].Ialphabeta; /* Only if sensorless */
+        STO_Inputs.Vbus = VBS_GetAvBusVoltage_d(&(BusVoltageSensor_M1._Super)); /* Only for sensorless */
+        HF_PROF_BEGIN(t_sto_pll);
+        (void)STO_PLL_CalcElAngle(&STO_PLL_M2, &STO_Inputs);
+        HF_PROF_END(HF_PROF_STO_PLL_M2, t_sto_pll);
+      }
+      else
+      {
+        /* Nothing to do */
+      }
+      STO_PLL_CalcAvrgElSpeedDpp(&STO_PLL_M2); /* Only in case of Sensor-less */
+      if (false == IsAccelerationStageReached)
+      {
+        STO_ResetPLL(&STO_PLL_M2);
+      }
+      else
+      {
+        /* Nothing to do */
+      }
+      /* Only for sensor-less */
+      if((START == Mci[M2].State) || (SWITCH_OVER == Mci[M2].State))
+      {
+        int16_t hObsAngle = SPD_GetElAngle(&STO_PLL_M2._Super);
+        (void)VSS_CalcElAngle(&VirtualSpeedSensorM2, &hObsAngle);
+      }
     }
-    /* USER CODE BEGIN HighFrequencyTask SINGLEDRIVE_3 */
-
-    /* USER CODE END HighFrequencyTask SINGLEDRIVE_3 */
   }
+#endif
 
   return (bMotorNbr);
 
@@ -676,28 +1118,41 @@ inline uint16_t FOC_CurrControllerM1(void)
   qd_t Iqd, Vqd;
   ab_t Iab;
   alphabeta_t Ialphabeta, Valphabeta;
+  Trig_Components ElAngleTrig;
   int16_t hElAngle;
   uint16_t hCodeError = MC_NO_FAULTS;
   SpeednPosFdbk_Handle_t *speedHandle;
   speedHandle = STC_GetSpeedSensor(pSTC[M1]);
   hElAngle = SPD_GetElAngle(speedHandle);
   hElAngle += SPD_GetInstElSpeedDpp(speedHandle)*PARK_ANGLE_COMPENSATION_FACTOR;
+  /* CORDIC computes cos/sin while the currents are read and Clarke-transformed */
+  MCM_Trig_Start(hElAngle);
   PWMC_GetPhaseCurrents(pwmcHandle[M1], &Iab);
   Ialphabeta = MCM_Clarke(Iab);
-  Iqd = MCM_Park(Ialphabeta, hElAngle);
+  ElAngleTrig = MCM_Trig_Finish();
+  Iqd = MCM_Park_Trig(Ialphabeta, ElAngleTrig);
   if (PWMC_GetPWMState(pwmcHandle[M1]) == true)
   {
-    Vqd.q = PI_Controller(pPIDIq[M1], (int32_t)(FOCVars[M1].Iqdref.q) - Iqd.q);
-    Vqd.d = PI_Controller(pPIDId[M1], (int32_t)(FOCVars[M1].Iqdref.d) - Iqd.d);
+    Vqd = PI_Controller_dq(pPIDIq[M1], pPIDId[M1], (int32_t)(FOCVars[M1].Iqdref.q) - Iqd.q,
+                           (int32_t)(FOCVars[M1].Iqdref.d) - Iqd.d);
   }
   else
   {
     Vqd.q = 0;
     Vqd.d = 0;
   }
+#if (CIRCLE_LIMITATION_CORDIC == 1)
+  Vqd = Circle_Limitation_Cordic(&CircleLimitationM1, Vqd);
+#else
   Vqd = Circle_Limitation(&CircleLimitationM1, Vqd);
+#endif
+#if (0 == REV_PARK_ANGLE_COMPENSATION_FACTOR)
+  /* Same angle as Park: reuse the cos/sin pair of the single CORDIC run */
+  Valphabeta = MCM_Rev_Park_Trig(Vqd, ElAngleTrig);
+#else
   hElAngle += SPD_GetInstElSpeedDpp(speedHandle)*REV_PARK_ANGLE_COMPENSATION_FACTOR;
   Valphabeta = MCM_Rev_Park(Vqd, hElAngle);
+#endif
 
   if (PWMC_GetPWMState(pwmcHandle[M1]) == true)
   {
@@ -719,6 +1174,85 @@ inline uint16_t FOC_CurrControllerM1(void)
   return (hCodeError);
 }
 
+#if (NBR_OF_MOTORS > 1)
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__((section (".ccmram")))
+#endif
+#endif
+/**
+  * @brief It executes the core of FOC drive that is the controllers for Iqd
+  *        currents regulation. Reference frame transformations are carried out
+  *        accordingly to the active speed sensor. It must be called periodically
+  *        when new motor currents have been converted
+  * @param this related object of class CFOC.
+  * @retval int16_t It returns MC_NO_FAULTS if the FOC has been ended before
+  *         next PWM Update event, MC_DURATION otherwise
+  */
+inline uint16_t FOC_CurrControllerM2(void)
+{
+  qd_t Iqd, Vqd;
+  ab_t Iab;
+  alphabeta_t Ialphabeta, Valphabeta;
+  Trig_Components ElAngleTrig;
+  int16_t hElAngle;
+  uint16_t hCodeError = MC_NO_FAULTS;
+  SpeednPosFdbk_Handle_t *speedHandle;
+  speedHandle = STC_GetSpeedSensor(pSTC[M2]);
+  hElAngle = SPD_GetElAngle(speedHandle);
+  hElAngle += SPD_GetInstElSpeedDpp(speedHandle)*PARK_ANGLE_COMPENSATION_FACTOR;
+  /* CORDIC computes cos/sin while the currents are read and Clarke-transformed */
+  MCM_Trig_Start(hElAngle);
+  PWMC_GetPhaseCurrents(pwmcHandle[M2], &Iab);
+  Ialphabeta = MCM_Clarke(Iab);
+  ElAngleTrig = MCM_Trig_Finish();
+  Iqd = MCM_Park_Trig(Ialphabeta, ElAngleTrig);
+  if (PWMC_GetPWMState(pwmcHandle[M2]) == true)
+  {
+    Vqd = PI_Controller_dq(pPIDIq[M2], pPIDId[M2], (int32_t)(FOCVars[M2].Iqdref.q) - Iqd.q,
+                           (int32_t)(FOCVars[M2].Iqdref.d) - Iqd.d);
+  }
+  else
+  {
+    Vqd.q = 0;
+    Vqd.d = 0;
+  }
+#if (CIRCLE_LIMITATION_CORDIC == 1)
+  Vqd = Circle_Limitation_Cordic(&CircleLimitationM2, Vqd);
+#else
+  Vqd = Circle_Limitation(&CircleLimitationM2, Vqd);
+#endif
+#if (0 == REV_PARK_ANGLE_COMPENSATION_FACTOR)
+  /* Same angle as Park: reuse the cos/sin pair of the single CORDIC run */
+  Valphabeta = MCM_Rev_Park_Trig(Vqd, ElAngleTrig);
+#else
+  hElAngle += SPD_GetInstElSpeedDpp(speedHandle)*REV_PARK_ANGLE_COMPENSATION_FACTOR;
+  Valphabeta = MCM_Rev_Park(Vqd, hElAngle);
+#endif
+
+  if (PWMC_GetPWMState(pwmcHandle[M2]) == true)
+  {
+    hCodeError = PWMC_SetPhaseVoltage(pwmcHandle[M2], Valphabeta);
+  }
+  else
+  {
+    /* Nothing to do. No PWM setting to prevent possible ChargeBootCap conflict */
+
+  }
+
+  FOCVars[M2].Vqd = Vqd;
+  FOCVars[M2].Iab = Iab;
+  FOCVars[M2].Ialphabeta = Ialphabeta;
+  FOCVars[M2].Iqd = Iqd;
+  FOCVars[M2].Valphabeta = Valphabeta;
+  FOCVars[M2].hElAngle = hElAngle;
+
+  return (hCodeError);
+}
+#endif
+
 /* USER CODE BEGIN mc_task 0 */
 
 /* USER CODE END mc_task 0 */
@@ -26,6 +26,7 @@
 #include "mcp.h"
 #include "mcpa.h"
 #include "mcp_config.h"
+#include "register_interface.h"
 
 static uint8_t MCPSyncTxBuff[MCP_TX_SYNCBUFFER_SIZE] __attribute__((aligned(4))); //cstat !MISRAC2012-Rule-1.4_a
 static uint8_t MCPSyncRXBuff[MCP_RX_SYNCBUFFER_SIZE] __attribute__((aligned(4))); //cstat !MISRAC2012-Rule-1.4_a
@@ -39,8 +40,12 @@ static void *dataPtrTableA[MCPA_OVER_UARTA_STREAM];
 static void *dataPtrTableBuffA[MCPA_OVER_UARTA_STREAM];
 static uint8_t dataSizeTableA[MCPA_OVER_UARTA_STREAM];
 static uint8_t dataSizeTableBuffA[MCPA_OVER_UARTA_STREAM]; /* buffered version of dataSizeTableA */
+static uint16_t deltaPrevTableA[2 * MCPA_OVER_UARTA_STREAM]; /* last two HF values, predictor of the delta format */
 
-MCP_user_cb_t MCP_UserCallBack[MCP_USER_CALLBACK_MAX];
+MCP_user_cb_t MCP_UserCallBack[MCP_USER_CALLBACK_MAX] =
+{
+  [MCP_USER_CMD_REG_PAGE] = &RI_RegPageCommand,
+};
 
 /** @addtogroup MCSDK
   * @{
@@ -70,11 +75,12 @@ ASPEP_Handle_t aspepOverUartA =
   .ASPEPIp = &UASPEP_A,
   .Capabilities =
   {
-    .DATA_CRC = 0U,
+    .DATA_CRC = ASPEP_DATA_CRC,
     .RX_maxSize =  (MCP_RX_SYNC_PAYLOAD_MAX >> 5U) - 1U,
     .TXS_maxSize = (MCP_TX_SYNC_PAYLOAD_MAX >> 5U) - 1U,
     .TXA_maxSize =  (MCP_TX_ASYNC_PAYLOAD_MAX_A >> 6U),
     .version = 0x0U,
+    .MCPA_DELTA = ASPEP_MCPA_DELTA,
   },
   .syncBuffer =
   {
@@ -108,6 +114,7 @@ MCPA_Handle_t MCPA_UART_A =
   .dataPtrTableBuff = dataPtrTableBuffA,
   .dataSizeTable = dataSizeTableA,
   .dataSizeTableBuff = dataSizeTableBuffA,
+  .deltaPrevTable = deltaPrevTableA,
   .nbrOfDataLog = MCPA_OVER_UARTA_STREAM,
 };
 
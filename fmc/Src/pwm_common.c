@@ -51,6 +51,11 @@ __weak void startTimers(void)
   /* Motor 1 timer slave mode ITR1 (TIMER2) sensitive */
   LL_TIM_SetTriggerInput(TIM1, LL_TIM_TS_ITR1);
   LL_TIM_SetSlaveMode(TIM1, LL_TIM_SLAVEMODE_TRIGGER);
+#if (NBR_OF_MOTORS > 1)
+  /* Motor 2 timer started by the same TIM2 update event */
+  LL_TIM_SetTriggerInput(TIM8, LL_TIM_TS_ITR1);
+  LL_TIM_SetSlaveMode(TIM8, LL_TIM_SLAVEMODE_TRIGGER);
+#endif
 
   isTIM2ClockOn = LL_APB1_GRP1_IsEnabledClock(LL_APB1_GRP1_PERIPH_TIM2);
   if ((uint32_t)0 == isTIM2ClockOn)
@@ -52,6 +52,17 @@
   *
   * To retrieve the result of a conversion the user must use  RCM_GetRegularConv() API.
   *
+  * When #RCM_USE_DMA is set, the high frequency task does not schedule regular conversions anymore.
+  * The conversions registered on an ADC are chained in its regular sequencer (rank = order of
+  * registration) and the whole sequence is started by a hardware trigger (#RCM_DMA_TRIGGER). A
+  * circular DMA channel writes each sequence alternately in one half of a double buffer, and
+  * RCM_GetRegularConv() reads the half that is not being written, based on the DMA remaining count.
+  * Nothing has to be locked: the DMA only writes the other half and the read is a single half-word.
+  * Injected conversions keep priority over the regular sequence, as for software started conversions.
+  * Only ADC1 (DMA1 channel 6) and ADC2 (DMA1 channel 7) have a DMA sequence. A conversion registered on
+  * another ADC falls back to a software started conversion: RCM_ExecRegularConv() polls it and stores the
+  * result, RCM_GetRegularConv() returns the last one. Such an ADC must not be used for current sensing.
+  *
   * Example: of conversion registration:
   *
   * RegConv_t UserConv =
@@ -94,10 +105,60 @@
 /* Global variables ----------------------------------------------------------*/
 
 static RegConv_t *RCM_handle_array[RCM_MAX_CONV];
+#if (RCM_USE_DMA == 0)
 static uint8_t RCM_array_index = 0U; /*!< handled by RCM to point on the element for conversion. */
+#endif
 static uint8_t RCM_conversion_nb = 0U; /*!< total number of valid element in the array */
 
+#if (RCM_USE_DMA == 1)
+/**
+  * @brief ADC regular sequence served by a DMA channel
+  */
+typedef struct
+{
+  ADC_TypeDef *regADC;  /*!< ADC owning the sequence */
+  uint32_t dmaChannel;  /*!< DMA1 channel, LL_DMA_CHANNEL_x */
+  uint32_t dmaRequest;  /*!< DMAMUX request line of the ADC */
+} RCM_DMAPort_t;
+
+#define RCM_DMA_PORT_NB  2U
+
+static const RCM_DMAPort_t RCM_DMAPort[RCM_DMA_PORT_NB] =
+{
+  {ADC1, LL_DMA_CHANNEL_6, LL_DMAMUX_REQ_ADC1},
+  {ADC2, LL_DMA_CHANNEL_7, LL_DMAMUX_REQ_ADC2},
+};
+
+static const uint32_t RCM_DMARank[RCM_MAX_CONV] =
+{
+  LL_ADC_REG_RANK_1, LL_ADC_REG_RANK_2, LL_ADC_REG_RANK_3, LL_ADC_REG_RANK_4
+};
+
+static const uint32_t RCM_DMASeqLength[RCM_MAX_CONV] =
+{
+  LL_ADC_REG_SEQ_SCAN_DISABLE, LL_ADC_REG_SEQ_SCAN_ENABLE_2RANKS,
+  LL_ADC_REG_SEQ_SCAN_ENABLE_3RANKS, LL_ADC_REG_SEQ_SCAN_ENABLE_4RANKS
+};
+
+#if (RCM_DMA_TRIGGER == RCM_DMA_TRIG_TIM6_TRGO)
+#define RCM_DMA_TRIG_SOURCE  LL_ADC_REG_TRIG_EXT_TIM6_TRGO
+#else
+#define RCM_DMA_TRIG_SOURCE  LL_ADC_REG_TRIG_EXT_TIM1_TRGO2
+#endif
+
+/*!< Two sequences per ADC: the DMA fills one half while the other holds the last complete sequence */
+static uint16_t RCM_DMABuffer[RCM_DMA_PORT_NB][2U * RCM_MAX_CONV];
+static uint8_t RCM_DMAConvNb[RCM_DMA_PORT_NB];  /*!< length of the regular sequence of each ADC */
+static uint8_t RCM_DMAPortOf[RCM_MAX_CONV];     /*!< ADC port of each conversion, indexed by id,
+                                                     #RCM_DMA_PORT_NB for a polled conversion */
+static uint8_t RCM_DMARankOf[RCM_MAX_CONV];     /*!< rank of each conversion in its sequence */
+#endif
+
 /* Private function prototypes -----------------------------------------------*/
+#if (RCM_USE_DMA == 1)
+static uint8_t RCM_DMAGetPort(const ADC_TypeDef *regADC);
+static void RCM_DMAAddConv(const RegConv_t *regConv);
+#endif
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -164,10 +225,24 @@ bool RCM_RegisterRegConv(RegConv_t *regConv)
       {
         /* Nothing to do */
       }
+#if (RCM_USE_DMA == 0)
       LL_ADC_REG_SetSequencerLength(regConv->regADC, LL_ADC_REG_SEQ_SCAN_DISABLE);
+#endif
       /* Configure the sampling time (should already be configured by for non user conversions) */
       LL_ADC_SetChannelSamplingTime (regConv->regADC, __LL_ADC_DECIMAL_NB_TO_CHANNEL(regConv->channel),
                                      regConv->samplingTime);
+#if (RCM_USE_DMA == 1)
+      if (RCM_DMAGetPort(regConv->regADC) < RCM_DMA_PORT_NB)
+      {
+        RCM_DMAAddConv(regConv);
+      }
+      else
+      {
+        /* No DMA sequence on this ADC: software started, polled by RCM_ExecRegularConv() */
+        RCM_DMAPortOf[regConv->id] = RCM_DMA_PORT_NB;
+        LL_ADC_REG_SetSequencerLength(regConv->regADC, LL_ADC_REG_SEQ_SCAN_DISABLE);
+      }
+#endif
     }
     else
     {
@@ -197,6 +272,9 @@ __attribute__((section (".ccmram")))
  */
 void RCM_ExecNextConv(void)
 {
+#if (RCM_USE_DMA == 1)
+  /* Sequences are started by the hardware trigger */
+#else
   if (RCM_conversion_nb > 0u)
   {
 
@@ -214,6 +292,7 @@ void RCM_ExecNextConv(void)
   {
      /* no conversion registered */
   }
+#endif
 }
 
 #if defined (CCMRAM)
@@ -234,6 +313,9 @@ __attribute__((section (".ccmram")))
  */
 void RCM_ReadOngoingConv(void)
 {
+#if (RCM_USE_DMA == 1)
+  /* Results are stored by the DMA */
+#else
   uint32_t result;
 
   if (RCM_conversion_nb > 0u)
@@ -264,6 +346,7 @@ void RCM_ReadOngoingConv(void)
   {
      /* no conversion registered */
   }
+#endif
 }
 
 /*
@@ -272,6 +355,9 @@ void RCM_ReadOngoingConv(void)
  * If the ADC is already in use for phase currents or phase voltage sensing, the regular conversion can not
  * be executed instantaneously, therefore this function shall not be used.
  * If it is possible to execute the conversion instantaneously, it will be executed, and result returned.
+ * With #RCM_USE_DMA, a conversion that belongs to a triggered sequence returns its last result
+ * without waiting; one on an ADC without DMA sequence is polled and its result stored for
+ * RCM_GetRegularConv().
  *
  * @note: This function is not part of the public API and users should not call it.
  */
@@ -287,6 +373,14 @@ uint16_t RCM_ExecRegularConv(RegConv_t *regConv)
   {
 #endif
 
+#if (RCM_USE_DMA == 1)
+  if (RCM_DMAPortOf[regConv->id] < RCM_DMA_PORT_NB)
+  {
+    result = RCM_ReadDMAConv(regConv);
+  }
+  else
+  {
+#endif
   LL_ADC_REG_SetSequencerRanks(regConv->regADC,
                                LL_ADC_REG_RANK_1,
                                __LL_ADC_DECIMAL_NB_TO_CHANNEL(regConv->channel));
@@ -304,6 +398,10 @@ uint16_t RCM_ExecRegularConv(RegConv_t *regConv)
 
   /* Reading of ADC Converted Value */
   result = LL_ADC_REG_ReadConversionData12L(regConv->regADC);
+#if (RCM_USE_DMA == 1)
+  regConv->data = result;
+  }
+#endif
 #ifdef NULL_PTR_CHECK_REG_CON_MNG
   }
 #endif
@@ -314,10 +412,14 @@ uint16_t RCM_ExecRegularConv(RegConv_t *regConv)
 /*
  * This function is used to wait for the result of a regular conversion.
  * @note: This shall be used only right after a call to RCM_ExecNextConv routine.
+ *        Nothing to wait for with #RCM_USE_DMA.
  *
  */
 void RCM_WaitForConv(void)
 {
+#if (RCM_USE_DMA == 1)
+  /* Nothing to do */
+#else
   if (RCM_conversion_nb > 0u)
   {
     while (LL_ADC_IsActiveFlag_EOC(RCM_handle_array[RCM_array_index]->regADC) == 0U )
@@ -329,8 +431,143 @@ void RCM_WaitForConv(void)
   {
      /* no conversion registered */
   }
+#endif
 }
 
+#if (RCM_USE_DMA == 1)
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__((section (".ccmram")))
+#endif
+#endif
+/**
+  * @brief  Returns the result of a registered conversion from the last complete DMA sequence.
+  *
+  * The DMA remaining count tells which half of the buffer is being written; the other half holds
+  * the last complete sequence. Can be called from any context. For a conversion on an ADC without
+  * DMA sequence, the last result polled by RCM_ExecRegularConv() is returned.
+  *
+  * @param  regConv Pointer to a conversion registered with RCM_RegisterRegConv().
+  * @retval uint16_t Left aligned 12 bits conversion result.
+  */
+uint16_t RCM_ReadDMAConv(const RegConv_t *regConv)
+{
+  uint16_t result;
+#ifdef NULL_PTR_CHECK_REG_CON_MNG
+  if (MC_NULL == regConv)
+  {
+    result = 0U;
+  }
+  else
+  {
+#endif
+    uint8_t port = RCM_DMAPortOf[regConv->id];
+    if (port < RCM_DMA_PORT_NB)
+    {
+      uint32_t convNb = RCM_DMAConvNb[port];
+      uint32_t written = (2U * convNb) - LL_DMA_GetDataLength(DMA1, RCM_DMAPort[port].dmaChannel);
+      uint32_t half = (written < convNb) ? 1U : 0U;
+
+      result = RCM_DMABuffer[port][(half * convNb) + RCM_DMARankOf[regConv->id]];
+    }
+    else
+    {
+      result = regConv->data;
+    }
+#ifdef NULL_PTR_CHECK_REG_CON_MNG
+  }
+#endif
+  return (result);
+}
+
+/*
+ * Returns the index of the DMA port serving regADC, RCM_DMA_PORT_NB if there is none.
+ */
+static uint8_t RCM_DMAGetPort(const ADC_TypeDef *regADC)
+{
+  uint8_t port = 0U;
+
+  while ((port < RCM_DMA_PORT_NB) && (RCM_DMAPort[port].regADC != regADC))
+  {
+    port++;
+  }
+  return (port);
+}
+
+/*
+ * Appends a registered conversion to the regular sequence of its ADC and restarts the sequence.
+ *
+ * The ADC regular configuration can only be changed while no regular conversion is ongoing, so
+ * the sequence is stopped, extended by one rank and the DMA channel reprogrammed for twice the
+ * new length. Both buffer halves are preset with the data of the conversions, until the first
+ * trigger.
+ */
+static void RCM_DMAAddConv(const RegConv_t *regConv)
+{
+  ADC_TypeDef *regADC = regConv->regADC;
+  uint8_t port = RCM_DMAGetPort(regADC);
+  uint32_t dmaChannel = RCM_DMAPort[port].dmaChannel;
+  uint8_t rank = RCM_DMAConvNb[port];
+  uint8_t convNb = rank + 1U;
+  uint8_t i;
+
+  RCM_DMAPortOf[regConv->id] = port;
+  RCM_DMARankOf[regConv->id] = rank;
+  RCM_DMAConvNb[port] = convNb;
+
+  if (LL_ADC_REG_IsConversionOngoing(regADC) != 0U)
+  {
+    LL_ADC_REG_StopConversion(regADC);
+    while (LL_ADC_REG_IsStopConversionOngoing(regADC) != 0U)
+    {
+      /* wait for the end of the regular sequence */
+    }
+  }
+  LL_DMA_DisableChannel(DMA1, dmaChannel);
+
+  for (i = 0U; i < RCM_conversion_nb; i++)
+  {
+    if (RCM_DMAPortOf[i] == port)
+    {
+      RCM_DMABuffer[port][RCM_DMARankOf[i]] = RCM_handle_array[i]->data;
+      RCM_DMABuffer[port][convNb + RCM_DMARankOf[i]] = RCM_handle_array[i]->data;
+    }
+  }
+
+  LL_ADC_REG_SetSequencerRanks(regADC, RCM_DMARank[rank], __LL_ADC_DECIMAL_NB_TO_CHANNEL(regConv->channel));
+  LL_ADC_REG_SetSequencerLength(regADC, RCM_DMASeqLength[rank]);
+  LL_ADC_REG_SetContinuousMode(regADC, LL_ADC_REG_CONV_SINGLE);
+  LL_ADC_REG_SetOverrun(regADC, LL_ADC_REG_OVR_DATA_OVERWRITTEN);
+  LL_ADC_REG_SetDMATransfer(regADC, LL_ADC_REG_DMA_TRANSFER_UNLIMITED);
+  LL_ADC_REG_SetTriggerSource(regADC, RCM_DMA_TRIG_SOURCE);
+  LL_ADC_ClearFlag_OVR(regADC);
+
+  LL_DMA_ConfigTransfer(DMA1, dmaChannel, LL_DMA_DIRECTION_PERIPH_TO_MEMORY | LL_DMA_MODE_CIRCULAR
+                        | LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_HALFWORD
+                        | LL_DMA_MDATAALIGN_HALFWORD | LL_DMA_PRIORITY_LOW);
+  LL_DMA_SetPeriphRequest(DMA1, dmaChannel, RCM_DMAPort[port].dmaRequest);
+  LL_DMA_ConfigAddresses(DMA1, dmaChannel, LL_ADC_DMA_GetRegAddr(regADC, LL_ADC_DMA_REG_REGULAR_DATA),
+                         (uint32_t)RCM_DMABuffer[port], LL_DMA_DIRECTION_PERIPH_TO_MEMORY); //cstat !MISRAC2012-Rule-11.4
+  LL_DMA_SetDataLength(DMA1, dmaChannel, 2U * (uint32_t)convNb);
+  LL_DMA_EnableChannel(DMA1, dmaChannel);
+
+#if (RCM_DMA_TRIGGER == RCM_DMA_TRIG_TIM6_TRGO)
+  /* TIM6 time base is set by MX_TIM6_Init */
+  LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM6);
+  LL_TIM_SetTriggerOutput(TIM6, LL_TIM_TRGO_UPDATE);
+  LL_TIM_EnableCounter(TIM6);
+#else
+  /* TIM1 update, once per PWM period with the repetition counter of the PWM timer */
+  LL_TIM_SetTriggerOutput2(TIM1, LL_TIM_TRGO2_UPDATE);
+#endif
+
+  /* Arms the sequence: it now starts on each trigger */
+  LL_ADC_REG_StartConversion(regADC);
+}
+#endif
+
 /**
   * @}
   */
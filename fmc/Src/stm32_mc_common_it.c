@@ -35,7 +35,8 @@
 #include "mcp_config.h"
 
 /* USER CODE BEGIN Includes */
-
+#include "bsp_uart.h"
+#include "stack_mon.h"
 /* USER CODE END Includes */
 
 /** @addtogroup MCSDK
@@ -70,7 +71,12 @@ void SysTick_Handler(void);
 void USART2_IRQHandler(void)
 {
   /* USER CODE BEGIN USART2_IRQHandler 0 */
-
+  STACK_MON_ISR_PROBE();
+  /* USART2 belongs to the CLI console (ASPEP is torn down in main.c). Only the
+   * RX IDLE/error events reach here; the ASPEP path below would also act on
+   * the TC flag left by the console TX DMA, so it must not run. */
+  bsp_uart_usart_irq();
+  return;
   /* USER CODE END USART2_IRQHandler 0 */
   uint32_t flags;
   uint32_t activeIdleFlag;
@@ -169,7 +175,7 @@ void SysTick_Handler(void)
 #ifdef MC_HAL_IS_USED
 static uint8_t SystickDividerCounter = SYSTICK_DIVIDER;
   /* USER CODE BEGIN SysTick_IRQn 0 */
-
+  STACK_MON_ISR_PROBE();
   /* USER CODE END SysTick_IRQn 0 */
   if (SystickDividerCounter == SYSTICK_DIVIDER)
   {
@@ -22,6 +22,10 @@
 #include "stm32g4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "fmac_rt.h"
+#include "bsp_uart.h"
+#include "stack_mon.h"
+#include "cordic_batch.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -73,4 +77,54 @@ extern DMA_HandleTypeDef hdma_usart2_rx;
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA1 channel1 global interrupt (USART2 RX console, HT/TC).
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  STACK_MON_ISR_PROBE();
+  bsp_uart_rx_dma_irq();
+}
+
+/**
+  * @brief This function handles DMA1 channel2 global interrupt (USART2 TX log ring).
+  */
+void DMA1_Channel2_IRQHandler(void)
+{
+  STACK_MON_ISR_PROBE();
+  bsp_uart_tx_dma_irq();
+}
+
+/**
+  * @brief This function handles DMA1 channel3 global interrupt (fmac_rt: JDR1 raw blocks).
+  */
+void DMA1_Channel3_IRQHandler(void)
+{
+  fmac_rt_dma_raw_irq();
+}
+
+/**
+  * @brief This function handles DMA1 channel5 global interrupt (fmac_rt: filtered blocks).
+  */
+void DMA1_Channel5_IRQHandler(void)
+{
+  fmac_rt_dma_out_irq();
+}
+
+/**
+  * @brief This function handles DMA2 channel1 global interrupt (cordic_batch: WDATA transfer error).
+  */
+void DMA2_Channel1_IRQHandler(void)
+{
+  cordic_batch_dma_irq();
+}
+
+/**
+  * @brief This function handles DMA2 channel2 global interrupt (cordic_batch: results, TC/TE).
+  */
+void DMA2_Channel2_IRQHandler(void)
+{
+  cordic_batch_dma_irq();
+}
+
 /* USER CODE END 1 */
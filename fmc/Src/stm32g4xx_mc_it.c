@@ -31,6 +31,10 @@
 
 /* USER CODE BEGIN Includes */
 #include "fmac_rt.h"
+#include "fmac_mc.h"
+#include "hf_prof.h"
+#include "stack_mon.h"
+#include "fault_rec.h"
 
 /* USER CODE END Includes */
 
@@ -57,6 +61,10 @@
 void ADC1_2_IRQHandler(void);
 void TIMx_UP_M1_IRQHandler(void);
 void TIMx_BRK_M1_IRQHandler(void);
+#if (NBR_OF_MOTORS > 1)
+void TIMx_UP_M2_IRQHandler(void);
+void TIMx_BRK_M2_IRQHandler(void);
+#endif
 
 #if defined (CCMRAM)
 #if defined (__ICCARM__)
@@ -72,27 +80,47 @@ __attribute__((section (".ccmram")))
 void ADC1_2_IRQHandler(void)
 {
   /* USER CODE BEGIN ADC1_2_IRQn 0 */
-
+  STACK_MON_ISR_PROBE();
+  HF_PROF_ISR_ENTER(t_isr);
   /* USER CODE END ADC1_2_IRQn 0 */
 
-    /* Clear Flags M1 */
+    /* Clear Flags M1 (M2 shares ADC1/ADC2: one JEOS per served motor) */
     LL_ADC_ClearFlag_JEOS(ADC1);
 
   /* Highfrequency task */
-  (void)TSK_HighFrequencyTask();
+  uint8_t bMotorNbr = TSK_HighFrequencyTask();
 
   /* USER CODE BEGIN HighFreq */
-  if (fmac_rt_is_active() != 0U)
+  /* The FMAC paths filter M1 signals: skip the M2 half of a dual-drive period */
+  if (M1 != bMotorNbr)
+  {
+    /* Nothing to do */
+  }
+  else if ((fmac_rt_is_active() != 0U) && (fmac_rt_get_mode() == FMAC_RT_MODE_ISR))
   {
     /* ADC data is left aligned (12-bit in bits [15:4]). */
     uint16_t adc_raw = (uint16_t)((ADC1->JDR1 >> 4) & 0x0FFFU);
+    HF_PROF_BEGIN(t_fmac);
     (void)fmac_rt_feed(adc_raw);
+    HF_PROF_END(HF_PROF_FMAC_FEED, t_fmac);
+  }
+
+  if ((M1 == bMotorNbr) && (fmac_mc_is_active() != 0U))
+  {
+    /* Ia/Ib already signed s16A; Vbus u16 left aligned -> positive Q15. */
+    int16_t mc_in[FMAC_MC_CH_COUNT];
+    mc_in[FMAC_MC_IA]   = FOCVars[M1].Iab.a;
+    mc_in[FMAC_MC_IB]   = FOCVars[M1].Iab.b;
+    mc_in[FMAC_MC_VBUS] = (int16_t)(BusVoltageSensor_M1._Super.LatestConv >> 1);
+    HF_PROF_BEGIN(t_fmac_mc);
+    fmac_mc_run(mc_in);
+    HF_PROF_END(HF_PROF_FMAC_MC, t_fmac_mc);
   }
 
   /* USER CODE END HighFreq  */
 
   /* USER CODE BEGIN ADC1_2_IRQn 1 */
-
+  HF_PROF_END(HF_PROF_ISR_TOTAL, t_isr);
   /* USER CODE END ADC1_2_IRQn 1 */
 }
 
@@ -110,11 +138,14 @@ __attribute__((section (".ccmram")))
 void TIMx_UP_M1_IRQHandler(void)
 {
  /* USER CODE BEGIN TIMx_UP_M1_IRQn 0 */
-
+  STACK_MON_ISR_PROBE();
  /* USER CODE END  TIMx_UP_M1_IRQn 0 */
 
   LL_TIM_ClearFlag_UPDATE(TIM1);
   (void)R3_2_TIMx_UP_IRQHandler(&PWM_Handle_M1);
+#if (NBR_OF_MOTORS > 1)
+  TSK_DualDriveFIFOUpdate(M1);
+#endif
 
  /* USER CODE BEGIN TIMx_UP_M1_IRQn 1 */
 
@@ -124,7 +155,9 @@ void TIMx_UP_M1_IRQHandler(void)
 void TIMx_BRK_M1_IRQHandler(void)
 {
   /* USER CODE BEGIN TIMx_BRK_M1_IRQn 0 */
-
+  /* Freeze the fault window before the flags are cleared: BRK = HW OVP, BRK2 = driver protection */
+  FAULT_REC_FREEZE_BRK((uint16_t)((LL_TIM_IsActiveFlag_BRK(TIM1) != 0U) ? MC_OVER_VOLT : 0U)
+                       | (uint16_t)((LL_TIM_IsActiveFlag_BRK2(TIM1) != 0U) ? MC_DP_FAULT : 0U));
   /* USER CODE END TIMx_BRK_M1_IRQn 0 */
 
   if (0U == LL_TIM_IsActiveFlag_BRK(TIM1))
@@ -155,6 +188,69 @@ void TIMx_BRK_M1_IRQHandler(void)
   /* USER CODE END TIMx_BRK_M1_IRQn 1 */
 }
 
+#if (NBR_OF_MOTORS > 1)
+#if defined (CCMRAM)
+#if defined (__ICCARM__)
+#pragma location = ".ccmram"
+#elif defined (__CC_ARM) || defined(__GNUC__)
+__attribute__((section (".ccmram")))
+#endif
+#endif
+/**
+  * @brief  This function handles second motor TIMx Update interrupt request.
+  * @param  None
+  */
+void TIMx_UP_M2_IRQHandler(void)
+{
+ /* USER CODE BEGIN TIMx_UP_M2_IRQn 0 */
+  STACK_MON_ISR_PROBE();
+ /* USER CODE END  TIMx_UP_M2_IRQn 0 */
+
+  LL_TIM_ClearFlag_UPDATE(TIM8);
+  (void)R3_2_TIMx_UP_IRQHandler(&PWM_Handle_M2);
+  TSK_DualDriveFIFOUpdate(M2);
+
+ /* USER CODE BEGIN TIMx_UP_M2_IRQn 1 */
+
+ /* USER CODE END  TIMx_UP_M2_IRQn 1 */
+}
+
+void TIMx_BRK_M2_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIMx_BRK_M2_IRQn 0 */
+  FAULT_REC_FREEZE_BRK((uint16_t)((LL_TIM_IsActiveFlag_BRK(TIM8) != 0U) ? MC_OVER_VOLT : 0U)
+                       | (uint16_t)((LL_TIM_IsActiveFlag_BRK2(TIM8) != 0U) ? MC_DP_FAULT : 0U));
+  /* USER CODE END TIMx_BRK_M2_IRQn 0 */
+
+  if (0U == LL_TIM_IsActiveFlag_BRK(TIM8))
+  {
+    /* Nothing to do */
+  }
+  else
+  {
+    LL_TIM_ClearFlag_BRK(TIM8);
+    PWMC_OVP_Handler(&PWM_Handle_M2._Super, TIM8);
+  }
+
+  if (0U == LL_TIM_IsActiveFlag_BRK2(TIM8))
+  {
+    /* Nothing to do */
+  }
+  else
+  {
+    LL_TIM_ClearFlag_BRK2(TIM8);
+    PWMC_DP_Handler(&PWM_Handle_M2._Super);
+  }
+
+  /* Systick is not executed due low priority so is necessary to call MC_Scheduler here */
+  MC_RunMotorControlTasks();
+
+  /* USER CODE BEGIN TIMx_BRK_M2_IRQn 1 */
+
+  /* USER CODE END TIMx_BRK_M2_IRQn 1 */
+}
+#endif
+
 /* USER CODE BEGIN 1 */
 
 /* USER CODE END 1 */
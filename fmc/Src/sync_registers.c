@@ -30,76 +30,376 @@
 #include "mcpa.h"
 #include "mc_configuration_registers.h"
 
-uint8_t RI_SetRegisterGlobal(uint16_t regID, uint8_t typeID, uint8_t *data, uint16_t *size, int16_t dataAvailable)
+/*
+ * Scalar registers (TYPE_DATA_8BIT/16BIT/32BIT) are described by the RI_RegDesc_t tables below instead of
+ * one switch per type. Each table is sorted by regID (type bits included), so a lookup is a binary search
+ * bounded by log2(nbrOfReg) compares; access rights and the conversion to protocol units live in the
+ * descriptor. String and raw registers keep their switch: they have variable sizes and few entries.
+ */
+
+/* Accessors shared by the PID instances */
+static int32_t RI_GetPidKp(void *obj) { return ((int32_t)PID_GetKP((PID_Handle_t *)obj)); }
+static int32_t RI_GetPidKi(void *obj) { return ((int32_t)PID_GetKI((PID_Handle_t *)obj)); }
+static int32_t RI_GetPidKd(void *obj) { return ((int32_t)PID_GetKD((PID_Handle_t *)obj)); }
+static void RI_SetPidKp(void *obj, int32_t value) { PID_SetKP((PID_Handle_t *)obj, (int16_t)value); }
+static void RI_SetPidKi(void *obj, int32_t value) { PID_SetKI((PID_Handle_t *)obj, (int16_t)value); }
+static void RI_SetPidKd(void *obj, int32_t value) { PID_SetKD((PID_Handle_t *)obj, (int16_t)value); }
+static int32_t RI_GetPidKpDiv(void *obj) { return ((int32_t)PID_GetKPDivisorPOW2((PID_Handle_t *)obj)); }
+static int32_t RI_GetPidKiDiv(void *obj) { return ((int32_t)PID_GetKIDivisorPOW2((PID_Handle_t *)obj)); }
+static int32_t RI_GetPidKdDiv(void *obj) { return ((int32_t)PID_GetKDDivisorPOW2((PID_Handle_t *)obj)); }
+static void RI_SetPidKpDiv(void *obj, int32_t value) { PID_SetKPDivisorPOW2((PID_Handle_t *)obj, (uint16_t)value); }
+static void RI_SetPidKiDiv(void *obj, int32_t value) { PID_SetKIDivisorPOW2((PID_Handle_t *)obj, (uint16_t)value); }
+static void RI_SetPidKdDiv(void *obj, int32_t value) { PID_SetKDDivisorPOW2((PID_Handle_t *)obj, (uint16_t)value); }
+
+/* Accessors of the MC interface */
+static int32_t RI_GetStatus(void *obj) { return ((int32_t)MCI_GetSTMState((MCI_Handle_t *)obj)); }
+static int32_t RI_GetControlMode(void *obj) { return ((int32_t)MCI_GetControlMode((MCI_Handle_t *)obj)); }
+static int32_t RI_GetIa(void *obj) { return ((int32_t)MCI_GetIab((MCI_Handle_t *)obj).a); }
+static int32_t RI_GetIb(void *obj) { return ((int32_t)MCI_GetIab((MCI_Handle_t *)obj).b); }
+static int32_t RI_GetIalpha(void *obj) { return ((int32_t)MCI_GetIalphabeta((MCI_Handle_t *)obj).alpha); }
+static int32_t RI_GetIbeta(void *obj) { return ((int32_t)MCI_GetIalphabeta((MCI_Handle_t *)obj).beta); }
+static int32_t RI_GetIq(void *obj) { return ((int32_t)MCI_GetIqd((MCI_Handle_t *)obj).q); }
+static int32_t RI_GetId(void *obj) { return ((int32_t)MCI_GetIqd((MCI_Handle_t *)obj).d); }
+static int32_t RI_GetIqRef(void *obj) { return ((int32_t)MCI_GetIqdref((MCI_Handle_t *)obj).q); }
+static int32_t RI_GetIdRef(void *obj) { return ((int32_t)MCI_GetIqdref((MCI_Handle_t *)obj).d); }
+static int32_t RI_GetVq(void *obj) { return ((int32_t)MCI_GetVqd((MCI_Handle_t *)obj).q); }
+static int32_t RI_GetVd(void *obj) { return ((int32_t)MCI_GetVqd((MCI_Handle_t *)obj).d); }
+static int32_t RI_GetValpha(void *obj) { return ((int32_t)MCI_GetValphabeta((MCI_Handle_t *)obj).alpha); }
+static int32_t RI_GetVbeta(void *obj) { return ((int32_t)MCI_GetValphabeta((MCI_Handle_t *)obj).beta); }
+static int32_t RI_GetFaults(void *obj) { return ((int32_t)MCI_GetFaultState((MCI_Handle_t *)obj)); }
+
+static void RI_SetControlMode(void *obj, int32_t value)
 {
-  uint8_t retVal = MCP_CMD_OK;
-  switch(typeID)
+  MCI_Handle_t *pMCIN = (MCI_Handle_t *)obj;
+  uint8_t regdata8 = (uint8_t)value;
+
+  if ((uint8_t)MCM_TORQUE_MODE == regdata8)
   {
-    case TYPE_DATA_8BIT:
-    {
-      switch (regID)
-      {
-        case MC_REG_STATUS:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
+    MCI_ExecTorqueRamp(pMCIN, MCI_GetTeref(pMCIN), 0);
+  }
+  else if ((uint8_t)MCM_SPEED_MODE == regdata8)
+  {
+    MCI_ExecSpeedRamp(pMCIN, MCI_GetMecSpeedRefUnit(pMCIN), 0);
+  }
+  else
+  {
+    /* Nothing to do */
+  }
+}
 
-        default:
-        {
-          retVal = MCP_ERROR_UNKNOWN_REG;
-          break;
-        }
-      }
-      *size = 1;
+static void RI_SetIqRef(void *obj, int32_t value)
+{
+  qd_t currComp = MCI_GetIqdref((MCI_Handle_t *)obj);
+  currComp.q = (int16_t)value;
+  MCI_SetCurrentReferences((MCI_Handle_t *)obj, currComp);
+}
+
+static void RI_SetIdRef(void *obj, int32_t value)
+{
+  qd_t currComp = MCI_GetIqdref((MCI_Handle_t *)obj);
+  currComp.d = (int16_t)value;
+  MCI_SetCurrentReferences((MCI_Handle_t *)obj, currComp);
+}
+
+/* Speeds are exchanged in rpm */
+static int32_t RI_GetSpeedMeas(void *obj)
+{
+  return ((((int32_t)MCI_GetAvrgMecSpeedUnit((MCI_Handle_t *)obj)) * U_RPM) / SPEED_UNIT);
+}
+
+static int32_t RI_GetSpeedRef(void *obj)
+{
+  return ((((int32_t)MCI_GetMecSpeedRefUnit((MCI_Handle_t *)obj)) * U_RPM) / SPEED_UNIT);
+}
+
+static void RI_SetSpeedRef(void *obj, int32_t value)
+{
+  MCI_ExecSpeedRamp((MCI_Handle_t *)obj, ((((int16_t)value) * ((int16_t)SPEED_UNIT)) / (int16_t)U_RPM), 0);
+}
+
+/* Motor power is exchanged as the bit pattern of a float, in W */
+static int32_t RI_GetMotorPower(void *obj)
+{
+  FloatToU32 ReadVal; //cstat !MISRAC2012-Rule-19.2
+  (void)obj; /* pMPM[] is not an address constant, it cannot be the descriptor object */
+  ReadVal.Float_Val = PQD_GetAvrgElMotorPowerW(pMPM[M1]);
+  return ((int32_t)ReadVal.U32_Val); //cstat !UNION-type-punning
+}
+
+/* Accessors of the sensors and of the STO PLL observer */
+static int32_t RI_GetRucStageNbr(void *obj) { return ((int32_t)RUC_GetNumberOfPhases((RevUpCtrl_Handle_t *)obj)); }
+static int32_t RI_GetBusVoltage(void *obj)
+{
+  return ((int32_t)VBS_GetAvBusVoltage_V((BusVoltageSensor_Handle_t *)obj));
+}
+static int32_t RI_GetHeatsTemp(void *obj) { return ((int32_t)NTC_GetAvTemp_C((NTC_Handle_t *)obj)); }
+//cstat !MISRAC2012-Rule-11.3
+static int32_t RI_GetElAngle(void *obj) { return ((int32_t)SPD_GetElAngle((SpeednPosFdbk_Handle_t *)obj)); }
+//cstat !MISRAC2012-Rule-11.3
+static int32_t RI_GetRotSpeed(void *obj) { return ((int32_t)SPD_GetS16Speed((SpeednPosFdbk_Handle_t *)obj)); }
+static int32_t RI_GetStoPllIalpha(void *obj)
+{
+  return ((int32_t)STO_PLL_GetEstimatedCurrent((STO_PLL_Handle_t *)obj).alpha);
+}
+static int32_t RI_GetStoPllIbeta(void *obj)
+{
+  return ((int32_t)STO_PLL_GetEstimatedCurrent((STO_PLL_Handle_t *)obj).beta);
+}
+static int32_t RI_GetStoPllBemfAlpha(void *obj)
+{
+  return ((int32_t)STO_PLL_GetEstimatedBemf((STO_PLL_Handle_t *)obj).alpha);
+}
+static int32_t RI_GetStoPllBemfBeta(void *obj)
+{
+  return ((int32_t)STO_PLL_GetEstimatedBemf((STO_PLL_Handle_t *)obj).beta);
+}
+static int32_t RI_GetStoPllEstBemf(void *obj) { return (STO_PLL_GetEstimatedBemfLevel((STO_PLL_Handle_t *)obj)); }
+static int32_t RI_GetStoPllObsBemf(void *obj) { return (STO_PLL_GetObservedBemfLevel((STO_PLL_Handle_t *)obj)); }
+
+static int32_t RI_GetStoPllC1(void *obj)
+{
+  int16_t hC1;
+  int16_t hC2;
+  STO_PLL_GetObserverGains((STO_PLL_Handle_t *)obj, &hC1, &hC2);
+  return ((int32_t)hC1);
+}
+
+static int32_t RI_GetStoPllC2(void *obj)
+{
+  int16_t hC1;
+  int16_t hC2;
+  STO_PLL_GetObserverGains((STO_PLL_Handle_t *)obj, &hC1, &hC2);
+  return ((int32_t)hC2);
+}
+
+static void RI_SetStoPllC1(void *obj, int32_t value)
+{
+  int16_t hC1;
+  int16_t hC2;
+  STO_PLL_GetObserverGains((STO_PLL_Handle_t *)obj, &hC1, &hC2);
+  STO_PLL_SetObserverGains((STO_PLL_Handle_t *)obj, (int16_t)value, hC2);
+}
+
+static void RI_SetStoPllC2(void *obj, int32_t value)
+{
+  int16_t hC1;
+  int16_t hC2;
+  STO_PLL_GetObserverGains((STO_PLL_Handle_t *)obj, &hC1, &hC2);
+  STO_PLL_SetObserverGains((STO_PLL_Handle_t *)obj, hC1, (int16_t)value);
+}
+
+/* Entries without RI_REG_R/RI_REG_W are IDs this firmware knows but does not implement: writes are refused with
+ * MCP_ERROR_RO_REG, reads with MCP_ERROR_UNKNOWN_REG. DAC_USERx are accepted and ignored (no DAC output). */
+static const RI_RegDesc_t RI_RegTableGlobal[] =
+{
+  { MC_REG_FAULTS_FLAGS,      0U,        MC_NULL, MC_NULL, MC_NULL },
+  { MC_REG_STATUS,            0U,        MC_NULL, MC_NULL, MC_NULL },
+  { MC_REG_BUS_VOLTAGE,       0U,        MC_NULL, MC_NULL, MC_NULL },
+  { MC_REG_HEATS_TEMP,        0U,        MC_NULL, MC_NULL, MC_NULL },
+  { MC_REG_DAC_USER1,         RI_REG_RW, MC_NULL, MC_NULL, MC_NULL },
+  { MC_REG_DAC_USER2,         RI_REG_RW, MC_NULL, MC_NULL, MC_NULL },
+};
+
+static const RI_RegDesc_t RI_RegTableM1[] =
+{
+  { MC_REG_FAULTS_FLAGS,      RI_REG_R,  &Mci[M1],                  &RI_GetFaults,          MC_NULL },
+  { MC_REG_STATUS,            RI_REG_R,  &Mci[M1],                  &RI_GetStatus,          MC_NULL },
+  { MC_REG_SPEED_MEAS,        RI_REG_R,  &Mci[M1],                  &RI_GetSpeedMeas,       MC_NULL },
+  { MC_REG_CONTROL_MODE,      RI_REG_RW, &Mci[M1],                  &RI_GetControlMode,     &RI_SetControlMode },
+  { MC_REG_SPEED_KP,          RI_REG_RW, &PIDSpeedHandle_M1,        &RI_GetPidKp,           &RI_SetPidKp },
+  { MC_REG_SPEED_REF,         RI_REG_RW, &Mci[M1],                  &RI_GetSpeedRef,        &RI_SetSpeedRef },
+  { MC_REG_RUC_STAGE_NBR,     RI_REG_R,  &RevUpControlM1,           &RI_GetRucStageNbr,     MC_NULL },
+  { MC_REG_SPEED_KI,          RI_REG_RW, &PIDSpeedHandle_M1,        &RI_GetPidKi,           &RI_SetPidKi },
+  { MC_REG_STOPLL_EST_BEMF,   RI_REG_R,  &STO_PLL_M1,               &RI_GetStoPllEstBemf,   MC_NULL },
+  { MC_REG_SPEED_KD,          RI_REG_RW, &PIDSpeedHandle_M1,        &RI_GetPidKd,           &RI_SetPidKd },
+  { MC_REG_STOPLL_OBS_BEMF,   RI_REG_R,  &STO_PLL_M1,               &RI_GetStoPllObsBemf,   MC_NULL },
+  { MC_REG_I_Q_KP,            RI_REG_RW, &PIDIqHandle_M1,           &RI_GetPidKp,           &RI_SetPidKp },
+  { MC_REG_I_Q_KI,            RI_REG_RW, &PIDIqHandle_M1,           &RI_GetPidKi,           &RI_SetPidKi },
+  { MC_REG_I_Q_KD,            RI_REG_RW, &PIDIqHandle_M1,           &RI_GetPidKd,           &RI_SetPidKd },
+  { MC_REG_I_D_KP,            RI_REG_RW, &PIDIdHandle_M1,           &RI_GetPidKp,           &RI_SetPidKp },
+  { MC_REG_I_D_KI,            RI_REG_RW, &PIDIdHandle_M1,           &RI_GetPidKi,           &RI_SetPidKi },
+  { MC_REG_I_D_KD,            RI_REG_RW, &PIDIdHandle_M1,           &RI_GetPidKd,           &RI_SetPidKd },
+  { MC_REG_STOPLL_C1,         RI_REG_RW, &STO_PLL_M1,               &RI_GetStoPllC1,        &RI_SetStoPllC1 },
+  { MC_REG_STOPLL_C2,         RI_REG_RW, &STO_PLL_M1,               &RI_GetStoPllC2,        &RI_SetStoPllC2 },
+  { MC_REG_STOPLL_KI,         RI_REG_RW, &STO_PLL_M1.PIRegulator,   &RI_GetPidKi,           &RI_SetPidKi },
+  { MC_REG_STOPLL_KP,         RI_REG_RW, &STO_PLL_M1.PIRegulator,   &RI_GetPidKp,           &RI_SetPidKp },
+  { MC_REG_BUS_VOLTAGE,       RI_REG_R,  &BusVoltageSensor_M1._Super, &RI_GetBusVoltage,    MC_NULL },
+  { MC_REG_HEATS_TEMP,        RI_REG_R,  &TempSensor_M1,            &RI_GetHeatsTemp,       MC_NULL },
+  { MC_REG_FLUXWK_BUS_MEAS,   0U,        MC_NULL,                   MC_NULL,                MC_NULL },
+  { MC_REG_I_A,               RI_REG_R,  &Mci[M1],                  &RI_GetIa,              MC_NULL },
+  { MC_REG_I_B,               RI_REG_R,  &Mci[M1],                  &RI_GetIb,              MC_NULL },
+  { MC_REG_I_ALPHA_MEAS,      RI_REG_R,  &Mci[M1],                  &RI_GetIalpha,          MC_NULL },
+  { MC_REG_I_BETA_MEAS,       RI_REG_R,  &Mci[M1],                  &RI_GetIbeta,           MC_NULL },
+  { MC_REG_I_Q_MEAS,          RI_REG_R,  &Mci[M1],                  &RI_GetIq,              MC_NULL },
+  { MC_REG_I_D_MEAS,          RI_REG_R,  &Mci[M1],                  &RI_GetId,              MC_NULL },
+  { MC_REG_I_Q_REF,           RI_REG_RW, &Mci[M1],                  &RI_GetIqRef,           &RI_SetIqRef },
+  { MC_REG_I_D_REF,           RI_REG_RW, &Mci[M1],                  &RI_GetIdRef,           &RI_SetIdRef },
+  { MC_REG_V_Q,               RI_REG_R,  &Mci[M1],                  &RI_GetVq,              MC_NULL },
+  { MC_REG_V_D,               RI_REG_R,  &Mci[M1],                  &RI_GetVd,              MC_NULL },
+  { MC_REG_V_ALPHA,           RI_REG_R,  &Mci[M1],                  &RI_GetValpha,          MC_NULL },
+  { MC_REG_V_BETA,            RI_REG_R,  &Mci[M1],                  &RI_GetVbeta,           MC_NULL },
+  { MC_REG_STOPLL_EL_ANGLE,   RI_REG_R,  &STO_PLL_M1,               &RI_GetElAngle,         MC_NULL },
+  { MC_REG_STOPLL_ROT_SPEED,  RI_REG_R,  &STO_PLL_M1,               &RI_GetRotSpeed,        MC_NULL },
+  { MC_REG_STOPLL_I_ALPHA,    RI_REG_R,  &STO_PLL_M1,               &RI_GetStoPllIalpha,    MC_NULL },
+  { MC_REG_STOPLL_I_BETA,     RI_REG_R,  &STO_PLL_M1,               &RI_GetStoPllIbeta,     MC_NULL },
+  { MC_REG_STOPLL_BEMF_ALPHA, RI_REG_R,  &STO_PLL_M1,               &RI_GetStoPllBemfAlpha, MC_NULL },
+  { MC_REG_STOPLL_BEMF_BETA,  RI_REG_R,  &STO_PLL_M1,               &RI_GetStoPllBemfBeta,  MC_NULL },
+  { MC_REG_DAC_USER1,         RI_REG_RW, MC_NULL,                   MC_NULL,                MC_NULL },
+  { MC_REG_DAC_USER2,         RI_REG_RW, MC_NULL,                   MC_NULL,                MC_NULL },
+  { MC_REG_SPEED_KP_DIV,      RI_REG_RW, &PIDSpeedHandle_M1,        &RI_GetPidKpDiv,        &RI_SetPidKpDiv },
+  { MC_REG_SPEED_KI_DIV,      RI_REG_RW, &PIDSpeedHandle_M1,        &RI_GetPidKiDiv,        &RI_SetPidKiDiv },
+  { MC_REG_SPEED_KD_DIV,      RI_REG_RW, &PIDSpeedHandle_M1,        &RI_GetPidKdDiv,        &RI_SetPidKdDiv },
+  { MC_REG_I_D_KP_DIV,        RI_REG_RW, &PIDIdHandle_M1,           &RI_GetPidKpDiv,        &RI_SetPidKpDiv },
+  { MC_REG_I_D_KI_DIV,        RI_REG_RW, &PIDIdHandle_M1,           &RI_GetPidKiDiv,        &RI_SetPidKiDiv },
+  { MC_REG_I_D_KD_DIV,        RI_REG_RW, &PIDIdHandle_M1,           &RI_GetPidKdDiv,        &RI_SetPidKdDiv },
+  { MC_REG_I_Q_KP_DIV,        RI_REG_RW, &PIDIqHandle_M1,           &RI_GetPidKpDiv,        &RI_SetPidKpDiv },
+  { MC_REG_I_Q_KI_DIV,        RI_REG_RW, &PIDIqHandle_M1,           &RI_GetPidKiDiv,        &RI_SetPidKiDiv },
+  { MC_REG_I_Q_KD_DIV,        RI_REG_RW, &PIDIqHandle_M1,           &RI_GetPidKdDiv,        &RI_SetPidKdDiv },
+  { MC_REG_STOPLL_KI_DIV,     RI_REG_RW, &STO_PLL_M1.PIRegulator,   &RI_GetPidKiDiv,        &RI_SetPidKiDiv },
+  { MC_REG_STOPLL_KP_DIV,     RI_REG_RW, &STO_PLL_M1.PIRegulator,   &RI_GetPidKpDiv,        &RI_SetPidKpDiv },
+  { MC_REG_PULSE_VALUE,       0U,        MC_NULL,                   MC_NULL,                MC_NULL },
+  { MC_REG_MOTOR_POWER,       RI_REG_R,  MC_NULL,                   &RI_GetMotorPower,      MC_NULL },
+};
+
+static const RI_RegMap_t RI_RegMapGlobal =
+{
+  .table = RI_RegTableGlobal,
+  .nbrOfReg = (uint16_t)(sizeof(RI_RegTableGlobal) / sizeof(RI_RegTableGlobal[0])),
+};
+
+static const RI_RegMap_t RI_RegMapM1 =
+{
+  .table = RI_RegTableM1,
+  .nbrOfReg = (uint16_t)(sizeof(RI_RegTableM1) / sizeof(RI_RegTableM1[0])),
+};
+
+/* Indexed by the motor field of the MCP ID, as the SetRegFcts/GetRegFcts tables of mcp.c */
+static const RI_RegMap_t *const RI_RegMaps[NBR_OF_MOTORS + 1] = { &RI_RegMapGlobal, &RI_RegMapM1 };
+
+/**
+  * @brief  Looks up a scalar register descriptor.
+  *
+  * @param  pMap Register table of the motor (or of the global registers)
+  * @param  regID Register ID, type bits included
+  *
+  * @retval Descriptor of @p regID or MC_NULL if it is not in the table.
+  */
+const RI_RegDesc_t *RI_FindReg(const RI_RegMap_t *pMap, uint16_t regID)
+{
+  const RI_RegDesc_t *result = MC_NULL;
+  uint16_t low = 0U;
+  uint16_t high = pMap->nbrOfReg;
+
+  while (low < high)
+  {
+    uint16_t mid = (low + high) >> 1U;
+    uint16_t midID = pMap->table[mid].regID;
+    if (midID < regID)
+    {
+      low = mid + 1U;
+    }
+    else if (midID > regID)
+    {
+      high = mid;
+    }
+    else
+    {
+      result = &pMap->table[mid];
       break;
     }
+  }
+  return (result);
+}
 
-    case TYPE_DATA_16BIT:
-    {
-      switch (regID)
-      {
+/**
+  * @brief  Returns the register map of a motor (0 is the global one), MC_NULL if @p motorID is out of range.
+  */
+const RI_RegMap_t *RI_GetRegMap(uint8_t motorID)
+{
+  return ((motorID <= NBR_OF_MOTORS) ? RI_RegMaps[motorID] : MC_NULL);
+}
 
-        case MC_REG_BUS_VOLTAGE:
-        case MC_REG_HEATS_TEMP:
-        case MC_REG_MOTOR_POWER:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
+static inline uint16_t RI_ScalarSize(uint8_t typeID)
+{
+  return ((TYPE_DATA_8BIT == typeID) ? 1U : ((TYPE_DATA_16BIT == typeID) ? 2U : 4U));
+}
 
-        case MC_REG_DAC_USER1:
-        case MC_REG_DAC_USER2:
-        break;
+/* Reads one scalar register into data[0..size-1], little endian. The caller checked the access rights. */
+static inline void RI_ReadScalar(const RI_RegDesc_t *pReg, uint8_t *data, uint16_t regSize)
+{
+  int32_t value = (pReg->get != MC_NULL) ? pReg->get(pReg->obj) : 0;
+  (void)memcpy(data, &value, regSize);
+}
 
-        default:
-        {
-          retVal = MCP_ERROR_UNKNOWN_REG;
-          break;
-        }
-      }
-      *size = 2;
-      break;
+static inline void RI_WriteScalar(const RI_RegDesc_t *pReg, const uint8_t *data, uint16_t regSize)
+{
+  uint32_t value = 0U;
+  (void)memcpy(&value, data, regSize);
+  if (pReg->set != MC_NULL)
+  {
+    pReg->set(pReg->obj, (int32_t)value);
+  }
+}
+
+static uint8_t RI_SetScalar(const RI_RegMap_t *pMap, uint16_t regID, uint8_t typeID, const uint8_t *data,
+                            uint16_t *size)
+{
+  uint8_t retVal = MCP_CMD_OK;
+  const RI_RegDesc_t *pReg = RI_FindReg(pMap, regID);
+
+  /* The size is consumed even for an unknown register, to jump to the next one in the buffer */
+  *size = RI_ScalarSize(typeID);
+  if (MC_NULL == pReg)
+  {
+    retVal = MCP_ERROR_UNKNOWN_REG;
+  }
+  else if (0U == (pReg->access & RI_REG_W))
+  {
+    retVal = MCP_ERROR_RO_REG;
+  }
+  else
+  {
+    RI_WriteScalar(pReg, data, *size);
+  }
+  return (retVal);
+}
+
+static uint8_t RI_GetScalar(const RI_RegMap_t *pMap, uint16_t regID, uint8_t typeID, uint8_t *data,
+                            uint16_t *size, int16_t freeSpace)
+{
+  uint8_t retVal = MCP_CMD_OK;
+  uint16_t regSize = RI_ScalarSize(typeID);
+
+  if (freeSpace < (int16_t)regSize)
+  {
+    retVal = MCP_ERROR_NO_TXSYNC_SPACE;
+  }
+  else
+  {
+    const RI_RegDesc_t *pReg = RI_FindReg(pMap, regID);
+    if ((MC_NULL == pReg) || (0U == (pReg->access & RI_REG_R)))
+    {
+      retVal = MCP_ERROR_UNKNOWN_REG;
+    }
+    else
+    {
+      RI_ReadScalar(pReg, data, regSize);
     }
+    *size = regSize;
+  }
+  return (retVal);
+}
 
+uint8_t RI_SetRegisterGlobal(uint16_t regID, uint8_t typeID, uint8_t *data, uint16_t *size, int16_t dataAvailable)
+{
+  uint8_t retVal = MCP_CMD_OK;
+  switch(typeID)
+  {
+    case TYPE_DATA_8BIT:
+    case TYPE_DATA_16BIT:
     case TYPE_DATA_32BIT:
     {
-
-      switch (regID)
-      {
-        case MC_REG_FAULTS_FLAGS:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        default:
-        {
-          retVal = MCP_ERROR_UNKNOWN_REG;
-          break;
-        }
-      }
-      *size = 4;
+      retVal = RI_SetScalar(&RI_RegMapGlobal, regID, typeID, data, size);
       break;
     }
 
@@ -173,355 +473,43 @@ uint8_t RI_SetRegisterMotor1(uint16_t regID, uint8_t typeID, uint8_t *data, uint
   switch(typeID)
   {
     case TYPE_DATA_8BIT:
+    case TYPE_DATA_16BIT:
+    case TYPE_DATA_32BIT:
     {
-      switch (regID)
-      {
-        case MC_REG_STATUS:
-          {
-            retVal = MCP_ERROR_RO_REG;
-            break;
-          }
-        case MC_REG_CONTROL_MODE:
-        {
-          uint8_t regdata8 = *data;
-
-          if ((uint8_t)MCM_TORQUE_MODE == regdata8)
-          {
-
-            MCI_ExecTorqueRamp(pMCIN, MCI_GetTeref(pMCIN), 0);
-          }
-          else
-          {
-            /* Nothing to do */
-          }
-
-          if ((uint8_t)MCM_SPEED_MODE == regdata8)
-          {
-            MCI_ExecSpeedRamp(pMCIN, MCI_GetMecSpeedRefUnit(pMCIN), 0);
-          }
-          else
-          {
-            /* Nothing to do */
-          }
-          break;
-        }
-
-        case MC_REG_RUC_STAGE_NBR:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        default:
-        {
-          retVal = MCP_ERROR_UNKNOWN_REG;
-          break;
-        }
-      }
-      *size = 1;
+      retVal = RI_SetScalar(&RI_RegMapM1, regID, typeID, data, size);
       break;
     }
 
-    case TYPE_DATA_16BIT:
+    case TYPE_DATA_STRING:
     {
-      uint16_t regdata16 = *(uint16_t *)data; //cstat !MISRAC2012-Rule-11.3
-      switch (regID)
-      {
-
-        case MC_REG_SPEED_KP:
-        {
-          PID_SetKP(&PIDSpeedHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_SPEED_KI:
-        {
-          PID_SetKI(&PIDSpeedHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_SPEED_KD:
-        {
-          PID_SetKD(&PIDSpeedHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_I_Q_KP:
-        {
-          PID_SetKP(&PIDIqHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_I_Q_KI:
-        {
-          PID_SetKI(&PIDIqHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_I_Q_KD:
-        {
-          PID_SetKD(&PIDIqHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_I_D_KP:
-        {
-          PID_SetKP(&PIDIdHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_I_D_KI:
-        {
-          PID_SetKI(&PIDIdHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_I_D_KD:
-        {
-          PID_SetKD(&PIDIdHandle_M1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_BUS_VOLTAGE:
-        case MC_REG_HEATS_TEMP:
-        case MC_REG_MOTOR_POWER:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        case MC_REG_I_A:
-        case MC_REG_I_B:
-        case MC_REG_I_ALPHA_MEAS:
-        case MC_REG_I_BETA_MEAS:
-        case MC_REG_I_Q_MEAS:
-        case MC_REG_I_D_MEAS:
-        case MC_REG_FLUXWK_BUS_MEAS:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        case MC_REG_I_Q_REF:
-        {
-          qd_t currComp;
-          currComp = MCI_GetIqdref(pMCIN);
-          currComp.q = (int16_t)regdata16;
-          MCI_SetCurrentReferences(pMCIN,currComp);
-          break;
-        }
-
-        case MC_REG_I_D_REF:
-        {
-          qd_t currComp;
-          currComp = MCI_GetIqdref(pMCIN);
-          currComp.d = (int16_t)regdata16;
-          MCI_SetCurrentReferences(pMCIN,currComp);
-          break;
-        }
-
-        case MC_REG_V_Q:
-        case MC_REG_V_D:
-        case MC_REG_V_ALPHA:
-        case MC_REG_V_BETA:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        case MC_REG_STOPLL_C1:
-        {
-          int16_t hC1;
-          int16_t hC2;
-          STO_PLL_GetObserverGains(&STO_PLL_M1, &hC1, &hC2);
-          STO_PLL_SetObserverGains(&STO_PLL_M1, (int16_t)regdata16, hC2);
-          break;
-        }
-
-        case MC_REG_STOPLL_C2:
-        {
-          int16_t hC1;
-          int16_t hC2;
-          STO_PLL_GetObserverGains(&STO_PLL_M1, &hC1, &hC2);
-          STO_PLL_SetObserverGains(&STO_PLL_M1, hC1, (int16_t)regdata16);
-          break;
-        }
-
-        case MC_REG_STOPLL_KI:
-        {
-          PID_SetKI (&(&STO_PLL_M1)->PIRegulator, (int16_t)regdata16);
-          break;
-        }
+      const char_t *charData = (const char_t *)data;
+      char_t *dummy = (char_t *)data;
+      retVal = MCP_ERROR_RO_REG;
+      /* Used to compute String length stored in RXBUFF even if Reg does not exist */
+      /* It allows to jump to the next command in the buffer */
+      (void)RI_MovString(charData, dummy, size, dataAvailable);
+      break;
+    }
 
-        case MC_REG_STOPLL_KP:
-        {
-          PID_SetKP (&(&STO_PLL_M1)->PIRegulator, (int16_t)regdata16);
-          break;
-        }
+    case TYPE_DATA_RAW:
+    {
+      uint16_t rawSize = *(uint16_t *)data; //cstat !MISRAC2012-Rule-11.3
+      /* The size consumed by the structure is the structure size + 2 bytes used to store the size */
+      *size = rawSize + 2U;
+      uint8_t *rawData = data; /* rawData points to the first data (after size extraction) */
+      rawData++;
+      rawData++;
 
-        case MC_REG_STOPLL_EL_ANGLE:
-        case MC_REG_STOPLL_ROT_SPEED:
-        case MC_REG_STOPLL_I_ALPHA:
-        case MC_REG_STOPLL_I_BETA:
-        case MC_REG_STOPLL_BEMF_ALPHA:
-        case MC_REG_STOPLL_BEMF_BETA:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        case MC_REG_DAC_USER1:
-        case MC_REG_DAC_USER2:
-          break;
-
-        case MC_REG_SPEED_KP_DIV:
-        {
-          PID_SetKPDivisorPOW2(&PIDSpeedHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_SPEED_KI_DIV:
-        {
-          PID_SetKIDivisorPOW2(&PIDSpeedHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_SPEED_KD_DIV:
-        {
-          PID_SetKDDivisorPOW2(&PIDSpeedHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_I_D_KP_DIV:
-        {
-          PID_SetKPDivisorPOW2(&PIDIdHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_I_D_KI_DIV:
-        {
-          PID_SetKIDivisorPOW2(&PIDIdHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_I_D_KD_DIV:
-        {
-          PID_SetKDDivisorPOW2(&PIDIdHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_I_Q_KP_DIV:
-        {
-          PID_SetKPDivisorPOW2(&PIDIqHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_I_Q_KI_DIV:
-        {
-          PID_SetKIDivisorPOW2(&PIDIqHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_I_Q_KD_DIV:
-        {
-          PID_SetKDDivisorPOW2(&PIDIqHandle_M1, regdata16);
-          break;
-        }
-
-        case MC_REG_STOPLL_KI_DIV:
-        {
-          PID_SetKIDivisorPOW2 (&(&STO_PLL_M1)->PIRegulator,regdata16);
-          break;
-        }
-
-        case MC_REG_STOPLL_KP_DIV:
-        {
-          PID_SetKPDivisorPOW2 (&(&STO_PLL_M1)->PIRegulator,regdata16);
-          break;
-        }
-
-        case MC_REG_PULSE_VALUE:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        default:
-        {
-          retVal = MCP_ERROR_UNKNOWN_REG;
-          break;
-        }
-      }
-      *size = 2;
-      break;
-    }
-
-    case TYPE_DATA_32BIT:
-    {
-      uint32_t regdata32 = *(uint32_t *)data; //cstat !MISRAC2012-Rule-11.3
-
-      switch (regID)
-      {
-        case MC_REG_FAULTS_FLAGS:
-        case MC_REG_SPEED_MEAS:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        case MC_REG_SPEED_REF:
-        {
-          MCI_ExecSpeedRamp(pMCIN,((((int16_t)regdata32) * ((int16_t)SPEED_UNIT)) / (int16_t)U_RPM), 0);
-          break;
-        }
-
-        case MC_REG_STOPLL_EST_BEMF:
-        case MC_REG_STOPLL_OBS_BEMF:
-        {
-          retVal = MCP_ERROR_RO_REG;
-          break;
-        }
-
-        default:
-        {
-          retVal = MCP_ERROR_UNKNOWN_REG;
-          break;
-        }
-      }
-      *size = 4;
-      break;
-    }
-
-    case TYPE_DATA_STRING:
-    {
-      const char_t *charData = (const char_t *)data;
-      char_t *dummy = (char_t *)data;
-      retVal = MCP_ERROR_RO_REG;
-      /* Used to compute String length stored in RXBUFF even if Reg does not exist */
-      /* It allows to jump to the next command in the buffer */
-      (void)RI_MovString(charData, dummy, size, dataAvailable);
-      break;
-    }
-
-    case TYPE_DATA_RAW:
-    {
-      uint16_t rawSize = *(uint16_t *)data; //cstat !MISRAC2012-Rule-11.3
-      /* The size consumed by the structure is the structure size + 2 bytes used to store the size */
-      *size = rawSize + 2U;
-      uint8_t *rawData = data; /* rawData points to the first data (after size extraction) */
-      rawData++;
-      rawData++;
-
-      if (*size > (uint16_t)dataAvailable)
-      {
-        /* The decoded size of the raw structure can not match with transmitted buffer, error in buffer
-           construction */
-        *size = 0;
-        retVal = MCP_ERROR_BAD_RAW_FORMAT; /* This error stop the parsing of the CMD buffer */
-      }
-      else
-      {
-        switch (regID)
+      if (*size > (uint16_t)dataAvailable)
+      {
+        /* The decoded size of the raw structure can not match with transmitted buffer, error in buffer
+           construction */
+        *size = 0;
+        retVal = MCP_ERROR_BAD_RAW_FORMAT; /* This error stop the parsing of the CMD buffer */
+      }
+      else
+      {
+        switch (regID)
         {
           case MC_REG_APPLICATION_CONFIG:
           case MC_REG_MOTOR_CONFIG:
@@ -529,639 +517,186 @@ uint8_t RI_SetRegisterMotor1(uint16_t regID, uint8_t typeID, uint8_t *data, uint
           case MC_REG_FOCFW_CONFIG:
           {
             retVal = MCP_ERROR_RO_REG;
-            break;
-          }
-
-          case MC_REG_SPEED_RAMP:
-          {
-            int32_t rpm;
-            uint16_t duration;
-
-            rpm = *(int32_t *)rawData; //cstat !MISRAC2012-Rule-11.3
-            duration = *(uint16_t *)&rawData[4]; //cstat !MISRAC2012-Rule-11.3
-            MCI_ExecSpeedRamp(pMCIN, (int16_t)((rpm * SPEED_UNIT) / U_RPM), duration);
-            break;
-          }
-
-          case MC_REG_TORQUE_RAMP:
-          {
-            uint32_t torque;
-            uint16_t duration;
-
-            torque = *(uint32_t *)rawData; //cstat !MISRAC2012-Rule-11.3
-            duration = *(uint16_t *)&rawData[4]; //cstat !MISRAC2012-Rule-11.3
-            MCI_ExecTorqueRamp(pMCIN, (int16_t)torque, duration);
-            break;
-          }
-
-          case MC_REG_REVUP_DATA:
-          {
-            int32_t rpm;
-            RevUpCtrl_PhaseParams_t revUpPhase;
-            uint8_t i;
-            uint8_t nbrOfPhase = (((uint8_t)rawSize) / 8U);
-
-            if (((0U != ((rawSize) % 8U))) || ((nbrOfPhase > RUC_MAX_PHASE_NUMBER) != 0))
-            {
-              retVal = MCP_ERROR_BAD_RAW_FORMAT;
-            }
-            else
-            {
-              for (i = 0; i <nbrOfPhase; i++)
-              {
-              rpm = *(int32_t *) &rawData[i * 8U]; //cstat !MISRAC2012-Rule-11.3
-              revUpPhase.hFinalMecSpeedUnit = (((int16_t)rpm) * ((int16_t)SPEED_UNIT)) / ((int16_t)U_RPM);
-              revUpPhase.hFinalTorque = *((int16_t *) &rawData[4U + (i * 8U)]); //cstat !MISRAC2012-Rule-11.3
-              revUpPhase.hDurationms  = *((uint16_t *) &rawData[6U +(i * 8U)]); //cstat !MISRAC2012-Rule-11.3
-              (void)RUC_SetPhase(&RevUpControlM1, i, &revUpPhase);
-              }
-            }
-            break;
-          }
-
-          case MC_REG_CURRENT_REF:
-          {
-            qd_t currComp;
-            currComp.q = *((int16_t *) rawData); //cstat !MISRAC2012-Rule-11.3
-            currComp.d = *((int16_t *) &rawData[2]); //cstat !MISRAC2012-Rule-11.3
-            MCI_SetCurrentReferences(pMCIN, currComp);
-            break;
-          }
-          case MC_REG_ASYNC_UARTA:
-          {
-            retVal =  MCPA_cfgLog (&MCPA_UART_A, rawData);
-            break;
-          }
-
-          default:
-          {
-            retVal = MCP_ERROR_UNKNOWN_REG;
-            break;
-          }
-        }
-      }
-      break;
-    }
-
-    default:
-    {
-      retVal = MCP_ERROR_BAD_DATA_TYPE;
-      *size =0; /* From this point we are not able anymore to decode the RX buffer */
-      break;
-    }
-  }
-  return (retVal);
-}
-
-uint8_t RI_GetRegisterGlobal(uint16_t regID,uint8_t typeID,uint8_t * data,uint16_t *size,int16_t freeSpace){
-    uint8_t retVal = MCP_CMD_OK;
-    switch (typeID)
-    {
-      case TYPE_DATA_8BIT:
-      {
-        if (freeSpace > 0)
-        {
-          switch (regID)
-          {
-            default:
-            {
-              retVal = MCP_ERROR_UNKNOWN_REG;
-              break;
-            }
-          }
-          *size = 1;
-        }
-        else
-        {
-          retVal = MCP_ERROR_NO_TXSYNC_SPACE;
-        }
-        break;
-      }
-
-      case TYPE_DATA_16BIT:
-      {
-        if (freeSpace >= 2)
-        {
-          switch (regID)
-          {
-            case MC_REG_DAC_USER1:
-            case MC_REG_DAC_USER2:
-              break;
-
-            default:
-            {
-              retVal = MCP_ERROR_UNKNOWN_REG;
-              break;
-            }
-          }
-          *size = 2;
-        }
-        else
-        {
-          retVal = MCP_ERROR_NO_TXSYNC_SPACE;
-        }
-        break;
-      }
-
-      case TYPE_DATA_32BIT:
-      {
-        if (freeSpace >= 4)
-        {
-          switch (regID)
-          {
-
-            default:
-            {
-              retVal = MCP_ERROR_UNKNOWN_REG;
-              break;
-            }
-          }
-          *size = 4;
-        }
-        else
-        {
-          retVal = MCP_ERROR_NO_TXSYNC_SPACE;
-        }
-        break;
-      }
-
-      case TYPE_DATA_STRING:
-      {
-        char_t *charData = (char_t *)data;
-        switch (regID)
-        {
-          case MC_REG_FW_NAME:
-            retVal = RI_MovString (FIRMWARE_NAME ,charData, size, freeSpace);
-            break;
-
-          case MC_REG_CTRL_STAGE_NAME:
-          {
-            retVal = RI_MovString (CTL_BOARD ,charData, size, freeSpace);
-            break;
-          }
-          default:
-          {
-
-            retVal = MCP_ERROR_UNKNOWN_REG;
-            *size= 0 ; /* */
-
-            break;
-          }
-        }
-        break;
-
-      }
-      case TYPE_DATA_RAW:
-      {
-        /* First 2 bytes of the answer is reserved to the size */
-        uint16_t *rawSize = (uint16_t *)data; //cstat !MISRAC2012-Rule-11.3
-        uint8_t * rawData = data;
-        rawData++;
-        rawData++;
-
-        switch (regID)
-        {
-          case MC_REG_GLOBAL_CONFIG:
-          {
-            *rawSize = (uint16_t)sizeof(GlobalConfig_reg_t);
-            if (((*rawSize) + 2U) > (uint16_t)freeSpace)
-            {
-              retVal = MCP_ERROR_NO_TXSYNC_SPACE;
-            }
-            else
-            {
-              (void)memcpy(rawData, &globalConfig_reg, sizeof(GlobalConfig_reg_t));
-            }
-            break;
-          }
-          case MC_REG_ASYNC_UARTA:
-          case MC_REG_ASYNC_UARTB:
-          case MC_REG_ASYNC_STLNK:
-          default:
-          {
-            retVal = MCP_ERROR_UNKNOWN_REG;
-            break;
-          }
-        }
-
-        /* Size of the answer is size of the data + 2 bytes containing data size */
-        *size = (*rawSize) + 2U;
-        break;
-      }
-
-      default:
-      {
-        retVal = MCP_ERROR_BAD_DATA_TYPE;
-        break;
-      }
-    }
-  return (retVal);
-}
-
-  uint8_t RI_GetRegisterMotor1(uint16_t regID,uint8_t typeID,uint8_t * data,uint16_t *size,int16_t freeSpace) {
-    uint8_t retVal = MCP_CMD_OK;
-    uint8_t motorID=0;
-    MCI_Handle_t *pMCIN = &Mci[motorID];
-    BusVoltageSensor_Handle_t* BusVoltageSensor= &BusVoltageSensor_M1._Super;
-    switch (typeID)
-    {
-      case TYPE_DATA_8BIT:
-      {
-        if (freeSpace > 0)
-        {
-          switch (regID)
-          {
-            case MC_REG_STATUS:
-            {
-              *data = (uint8_t)MCI_GetSTMState(pMCIN);
-              break;
-            }
-
-            case MC_REG_CONTROL_MODE:
-            {
-              *data = (uint8_t)MCI_GetControlMode(pMCIN);
-              break;
-            }
-
-            case MC_REG_RUC_STAGE_NBR:
-            {
-              *data = (uint8_t)RUC_GetNumberOfPhases(&RevUpControlM1);
-              break;
-            }
-
-            default:
-            {
-              retVal = MCP_ERROR_UNKNOWN_REG;
-              break;
-            }
-          }
-          *size = 1;
-        }
-        else
-        {
-          retVal = MCP_ERROR_NO_TXSYNC_SPACE;
-        }
-        break;
-      }
-
-      case TYPE_DATA_16BIT:
-      {
-        uint16_t *regdataU16 = (uint16_t *)data; //cstat !MISRAC2012-Rule-11.3
-        int16_t *regdata16 = (int16_t *) data; //cstat !MISRAC2012-Rule-11.3
-
-        if (freeSpace >= 2)
-        {
-          switch (regID)
-          {
-
-            case MC_REG_SPEED_KP:
-            {
-              *regdata16 = PID_GetKP(&PIDSpeedHandle_M1);
-              break;
-            }
-
-            case MC_REG_SPEED_KI:
-            {
-              *regdata16 = PID_GetKI(&PIDSpeedHandle_M1);
-              break;
-            }
-
-            case MC_REG_SPEED_KD:
-            {
-              *regdata16 = PID_GetKD(&PIDSpeedHandle_M1);
-              break;
-            }
-
-            case MC_REG_I_Q_KP:
-            {
-              *regdata16 = PID_GetKP(&PIDIqHandle_M1);
-              break;
-            }
-
-            case MC_REG_I_Q_KI:
-            {
-              *regdata16 = PID_GetKI(&PIDIqHandle_M1);
-              break;
-            }
-
-            case MC_REG_I_Q_KD:
-            {
-              *regdata16 = PID_GetKD(&PIDIqHandle_M1);
-              break;
-            }
-
-            case MC_REG_I_D_KP:
-            {
-              *regdata16 = PID_GetKP(&PIDIdHandle_M1);
-              break;
-            }
-
-            case MC_REG_I_D_KI:
-            {
-              *regdata16 = PID_GetKI(&PIDIdHandle_M1);
-              break;
-            }
-
-            case MC_REG_I_D_KD:
-            {
-              *regdata16 = PID_GetKD(&PIDIdHandle_M1);
-              break;
-            }
-
-            case MC_REG_BUS_VOLTAGE:
-            {
-              *regdataU16 = VBS_GetAvBusVoltage_V(BusVoltageSensor);
-              break;
-            }
-
-            case MC_REG_HEATS_TEMP:
-            {
-              *regdata16 = NTC_GetAvTemp_C(&TempSensor_M1);
-              break;
-            }
-
-            case MC_REG_I_A:
-            {
-              *regdata16 = MCI_GetIab(pMCIN).a;
-              break;
-            }
-
-            case MC_REG_I_B:
-            {
-              *regdata16 = MCI_GetIab(pMCIN).b;
-              break;
-            }
-
-            case MC_REG_I_ALPHA_MEAS:
-            {
-              *regdata16 = MCI_GetIalphabeta(pMCIN).alpha;
-              break;
-            }
-
-            case MC_REG_I_BETA_MEAS:
-            {
-              *regdata16 = MCI_GetIalphabeta(pMCIN).beta;
-              break;
-            }
-
-            case MC_REG_I_Q_MEAS:
-            {
-              *regdata16 = MCI_GetIqd(pMCIN).q;
-              break;
-            }
-
-            case MC_REG_I_D_MEAS:
-            {
-              *regdata16 = MCI_GetIqd(pMCIN).d;
-              break;
-            }
-
-            case MC_REG_I_Q_REF:
-            {
-              *regdata16 = MCI_GetIqdref(pMCIN).q;
-              break;
-            }
-
-            case MC_REG_I_D_REF:
-            {
-              *regdata16 = MCI_GetIqdref(pMCIN).d;
-              break;
-            }
-
-            case MC_REG_V_Q:
-            {
-              *regdata16 = MCI_GetVqd(pMCIN).q;
-              break;
-            }
-
-            case MC_REG_V_D:
-            {
-              *regdata16 = MCI_GetVqd(pMCIN).d;
-              break;
-            }
-
-            case MC_REG_V_ALPHA:
-            {
-              *regdata16 = MCI_GetValphabeta(pMCIN).alpha;
-              break;
-            }
-
-            case MC_REG_V_BETA:
-            {
-              *regdata16 = MCI_GetValphabeta(pMCIN).beta;
-              break;
-            }
-
-            case MC_REG_STOPLL_EL_ANGLE:
-            {
-              //cstat !MISRAC2012-Rule-11.3
-              *regdata16 = SPD_GetElAngle((SpeednPosFdbk_Handle_t *)&STO_PLL_M1);
-              break;
-            }
-
-            case MC_REG_STOPLL_ROT_SPEED:
-            {
-              //cstat !MISRAC2012-Rule-11.3
-              *regdata16 = SPD_GetS16Speed((SpeednPosFdbk_Handle_t *)&STO_PLL_M1);
-              break;
-            }
-
-            case MC_REG_STOPLL_I_ALPHA:
-            {
-              *regdata16 = STO_PLL_GetEstimatedCurrent(&STO_PLL_M1).alpha;
-              break;
-            }
-
-            case MC_REG_STOPLL_I_BETA:
-            {
-              *regdata16 = STO_PLL_GetEstimatedCurrent(&STO_PLL_M1).beta;
-              break;
-            }
-
-            case MC_REG_STOPLL_BEMF_ALPHA:
-            {
-              *regdata16 = STO_PLL_GetEstimatedBemf(&STO_PLL_M1).alpha;
-              break;
-            }
-
-            case MC_REG_STOPLL_BEMF_BETA:
-            {
-              *regdata16 = STO_PLL_GetEstimatedBemf(&STO_PLL_M1).beta;
-              break;
-            }
-
-            case MC_REG_STOPLL_C1:
-            {
-              int16_t hC1;
-              int16_t hC2;
-              STO_PLL_GetObserverGains(&STO_PLL_M1, &hC1, &hC2);
-              *regdata16 = hC1;
-              break;
-            }
-
-            case MC_REG_STOPLL_C2:
-            {
-              int16_t hC1;
-              int16_t hC2;
-              STO_PLL_GetObserverGains(&STO_PLL_M1, &hC1, &hC2);
-              *regdata16 = hC2;
-              break;
-            }
-
-            case MC_REG_STOPLL_KI:
-            {
-              *regdata16 = PID_GetKI (&(&STO_PLL_M1)->PIRegulator);
-              break;
-            }
-
-            case MC_REG_STOPLL_KP:
-            {
-              *regdata16 = PID_GetKP (&(&STO_PLL_M1)->PIRegulator);
-              break;
-            }
-
-            case MC_REG_DAC_USER1:
-            case MC_REG_DAC_USER2:
-              break;
-
-            case MC_REG_SPEED_KP_DIV:
-            {
-              *regdataU16 = (uint16_t)PID_GetKPDivisorPOW2(&PIDSpeedHandle_M1);
-              break;
-            }
-
-            case MC_REG_SPEED_KI_DIV:
-            {
-              *regdataU16 = (uint16_t)PID_GetKIDivisorPOW2(&PIDSpeedHandle_M1);
-              break;
-            }
+            break;
+          }
 
-            case MC_REG_SPEED_KD_DIV:
-            {
-              *regdataU16 = PID_GetKDDivisorPOW2(&PIDSpeedHandle_M1);
-              break;
-            }
-            case MC_REG_I_D_KP_DIV:
-            {
-              *regdataU16 = PID_GetKPDivisorPOW2(&PIDIdHandle_M1);
-              break;
-            }
+          case MC_REG_SPEED_RAMP:
+          {
+            int32_t rpm;
+            uint16_t duration;
 
-            case MC_REG_I_D_KI_DIV:
-            {
-              *regdataU16 = PID_GetKIDivisorPOW2(&PIDIdHandle_M1);
-              break;
-            }
+            rpm = *(int32_t *)rawData; //cstat !MISRAC2012-Rule-11.3
+            duration = *(uint16_t *)&rawData[4]; //cstat !MISRAC2012-Rule-11.3
+            MCI_ExecSpeedRamp(pMCIN, (int16_t)((rpm * SPEED_UNIT) / U_RPM), duration);
+            break;
+          }
 
-            case MC_REG_I_D_KD_DIV:
-            {
-              *regdataU16 = PID_GetKDDivisorPOW2(&PIDIdHandle_M1);
-              break;
-            }
+          case MC_REG_TORQUE_RAMP:
+          {
+            uint32_t torque;
+            uint16_t duration;
 
-            case MC_REG_I_Q_KP_DIV:
-            {
-              *regdataU16 = PID_GetKPDivisorPOW2(&PIDIqHandle_M1);
-              break;
-            }
+            torque = *(uint32_t *)rawData; //cstat !MISRAC2012-Rule-11.3
+            duration = *(uint16_t *)&rawData[4]; //cstat !MISRAC2012-Rule-11.3
+            MCI_ExecTorqueRamp(pMCIN, (int16_t)torque, duration);
+            break;
+          }
 
-            case MC_REG_I_Q_KI_DIV:
-            {
-              *regdataU16 = PID_GetKIDivisorPOW2(&PIDIqHandle_M1);
-              break;
-            }
+          case MC_REG_REVUP_DATA:
+          {
+            int32_t rpm;
+            RevUpCtrl_PhaseParams_t revUpPhase;
+            uint8_t i;
+            uint8_t nbrOfPhase = (((uint8_t)rawSize) / 8U);
 
-            case MC_REG_I_Q_KD_DIV:
+            if (((0U != ((rawSize) % 8U))) || ((nbrOfPhase > RUC_MAX_PHASE_NUMBER) != 0))
             {
-              *regdataU16 = PID_GetKDDivisorPOW2(&PIDIqHandle_M1);
-              break;
+              retVal = MCP_ERROR_BAD_RAW_FORMAT;
             }
-
-            case MC_REG_STOPLL_KI_DIV:
+            else
             {
-              *regdataU16 = PID_GetKIDivisorPOW2(&(&STO_PLL_M1)->PIRegulator);
-              break;
+              for (i = 0; i <nbrOfPhase; i++)
+              {
+              rpm = *(int32_t *) &rawData[i * 8U]; //cstat !MISRAC2012-Rule-11.3
+              revUpPhase.hFinalMecSpeedUnit = (((int16_t)rpm) * ((int16_t)SPEED_UNIT)) / ((int16_t)U_RPM);
+              revUpPhase.hFinalTorque = *((int16_t *) &rawData[4U + (i * 8U)]); //cstat !MISRAC2012-Rule-11.3
+              revUpPhase.hDurationms  = *((uint16_t *) &rawData[6U +(i * 8U)]); //cstat !MISRAC2012-Rule-11.3
+              (void)RUC_SetPhase(&RevUpControlM1, i, &revUpPhase);
+              }
             }
+            break;
+          }
 
-            case MC_REG_STOPLL_KP_DIV:
-            {
-              *regdataU16 = PID_GetKPDivisorPOW2(&(&STO_PLL_M1)->PIRegulator);
-              break;
-            }
+          case MC_REG_CURRENT_REF:
+          {
+            qd_t currComp;
+            currComp.q = *((int16_t *) rawData); //cstat !MISRAC2012-Rule-11.3
+            currComp.d = *((int16_t *) &rawData[2]); //cstat !MISRAC2012-Rule-11.3
+            MCI_SetCurrentReferences(pMCIN, currComp);
+            break;
+          }
+          case MC_REG_ASYNC_UARTA:
+          {
+            retVal =  MCPA_cfgLog (&MCPA_UART_A, rawData);
+            break;
+          }
 
-            default:
-            {
-              retVal = MCP_ERROR_UNKNOWN_REG;
-              break;
-            }
+          default:
+          {
+            retVal = MCP_ERROR_UNKNOWN_REG;
+            break;
           }
-          *size = 2;
-        }
-        else
-        {
-          retVal = MCP_ERROR_NO_TXSYNC_SPACE;
         }
-        break;
       }
+      break;
+    }
 
+    default:
+    {
+      retVal = MCP_ERROR_BAD_DATA_TYPE;
+      *size =0; /* From this point we are not able anymore to decode the RX buffer */
+      break;
+    }
+  }
+  return (retVal);
+}
+
+uint8_t RI_GetRegisterGlobal(uint16_t regID,uint8_t typeID,uint8_t * data,uint16_t *size,int16_t freeSpace){
+    uint8_t retVal = MCP_CMD_OK;
+    switch (typeID)
+    {
+      case TYPE_DATA_8BIT:
+      case TYPE_DATA_16BIT:
       case TYPE_DATA_32BIT:
       {
-        uint32_t *regdataU32 = (uint32_t *)data; //cstat !MISRAC2012-Rule-11.3
-        int32_t *regdata32 = (int32_t *)data; //cstat !MISRAC2012-Rule-11.3
+        retVal = RI_GetScalar(&RI_RegMapGlobal, regID, typeID, data, size, freeSpace);
+        break;
+      }
 
-        if (freeSpace >= 4)
+      case TYPE_DATA_STRING:
+      {
+        char_t *charData = (char_t *)data;
+        switch (regID)
         {
-          switch (regID)
+          case MC_REG_FW_NAME:
+            retVal = RI_MovString (FIRMWARE_NAME ,charData, size, freeSpace);
+            break;
+
+          case MC_REG_CTRL_STAGE_NAME:
+          {
+            retVal = RI_MovString (CTL_BOARD ,charData, size, freeSpace);
+            break;
+          }
+          default:
           {
-            case MC_REG_FAULTS_FLAGS:
-            {
-              *regdataU32 = MCI_GetFaultState(pMCIN);
-              break;
-            }
-            case MC_REG_SPEED_MEAS:
-            {
-              *regdata32 = (((int32_t)MCI_GetAvrgMecSpeedUnit(pMCIN) * U_RPM) / SPEED_UNIT);
-              break;
-            }
 
-            case MC_REG_SPEED_REF:
-            {
-              *regdata32 = (((int32_t)MCI_GetMecSpeedRefUnit(pMCIN) * U_RPM) / SPEED_UNIT);
-              break;
-            }
+            retVal = MCP_ERROR_UNKNOWN_REG;
+            *size= 0 ; /* */
 
-            case MC_REG_STOPLL_EST_BEMF:
-            {
-              *regdata32 = STO_PLL_GetEstimatedBemfLevel(&STO_PLL_M1);
-              break;
-            }
+            break;
+          }
+        }
+        break;
 
-            case MC_REG_STOPLL_OBS_BEMF:
-            {
-              *regdata32 = STO_PLL_GetObservedBemfLevel(&STO_PLL_M1);
-              break;
-            }
+      }
+      case TYPE_DATA_RAW:
+      {
+        /* First 2 bytes of the answer is reserved to the size */
+        uint16_t *rawSize = (uint16_t *)data; //cstat !MISRAC2012-Rule-11.3
+        uint8_t * rawData = data;
+        rawData++;
+        rawData++;
 
-            case MC_REG_MOTOR_POWER:
+        switch (regID)
+        {
+          case MC_REG_GLOBAL_CONFIG:
+          {
+            *rawSize = (uint16_t)sizeof(GlobalConfig_reg_t);
+            if (((*rawSize) + 2U) > (uint16_t)freeSpace)
             {
-              FloatToU32 ReadVal; //cstat !MISRAC2012-Rule-19.2
-              ReadVal.Float_Val = PQD_GetAvrgElMotorPowerW(pMPM[M1]);
-              *regdataU32 = ReadVal.U32_Val; //cstat !UNION-type-punning
-              break;
+              retVal = MCP_ERROR_NO_TXSYNC_SPACE;
             }
-
-            default:
+            else
             {
-              retVal = MCP_ERROR_UNKNOWN_REG;
-              break;
+              (void)memcpy(rawData, &globalConfig_reg, sizeof(GlobalConfig_reg_t));
             }
+            break;
+          }
+          case MC_REG_ASYNC_UARTA:
+          case MC_REG_ASYNC_UARTB:
+          case MC_REG_ASYNC_STLNK:
+          default:
+          {
+            retVal = MCP_ERROR_UNKNOWN_REG;
+            break;
           }
-          *size = 4;
-        }
-        else
-        {
-          retVal = MCP_ERROR_NO_TXSYNC_SPACE;
         }
+
+        /* Size of the answer is size of the data + 2 bytes containing data size */
+        *size = (*rawSize) + 2U;
+        break;
+      }
+
+      default:
+      {
+        retVal = MCP_ERROR_BAD_DATA_TYPE;
+        break;
+      }
+    }
+  return (retVal);
+}
+
+  uint8_t RI_GetRegisterMotor1(uint16_t regID,uint8_t typeID,uint8_t * data,uint16_t *size,int16_t freeSpace) {
+    uint8_t retVal = MCP_CMD_OK;
+    uint8_t motorID=0;
+    MCI_Handle_t *pMCIN = &Mci[motorID];
+    switch (typeID)
+    {
+      case TYPE_DATA_8BIT:
+      case TYPE_DATA_16BIT:
+      case TYPE_DATA_32BIT:
+      {
+        retVal = RI_GetScalar(&RI_RegMapM1, regID, typeID, data, size, freeSpace);
         break;
       }
 
@@ -1345,6 +880,143 @@ uint8_t RI_GetRegisterGlobal(uint16_t regID,uint8_t typeID,uint8_t * data,uint16
     return (retVal);
   }
 
+/*
+ * Register pages: a list of scalar registers defined once, then read or written with a single MCP user
+ * command (MCP_USER_CMD_REG_PAGE). The IDs are resolved to descriptors when the page is defined, so a
+ * page access is one accessor call per register, without lookups and without IDs on the link.
+ *
+ *   RI_PAGE_DEFINE: [op][page][ID 0]..[ID n-1]   (u16 MCP IDs, motor field included)
+ *   RI_PAGE_READ:   [op][page]                   answer: the values, in page order
+ *   RI_PAGE_WRITE:  [op][page][values]           values in page order, all registers writable
+ */
+static RI_RegPage_t RI_RegPages[RI_PAGE_NBR];
+
+static uint8_t RI_RegPageDefine(RI_RegPage_t *pPage, const uint8_t *ids, uint16_t length)
+{
+  uint8_t retVal = MCP_CMD_OK;
+  uint16_t nbrOfReg = length / MCP_ID_SIZE;
+  uint16_t pageSize = 0U;
+  uint16_t i;
+
+  if ((0U != (length % MCP_ID_SIZE)) || (nbrOfReg > RI_PAGE_MAX_REG))
+  {
+    retVal = MCP_ERROR_BAD_RAW_FORMAT;
+  }
+  else
+  {
+    for (i = 0U; (i < nbrOfReg) && (MCP_CMD_OK == retVal); i++)
+    {
+      uint16_t dataID = (uint16_t)ids[2U * i] | ((uint16_t)ids[(2U * i) + 1U] << 8U);
+      uint8_t typeID = (uint8_t)dataID & TYPE_MASK;
+      const RI_RegMap_t *pMap = RI_GetRegMap((uint8_t)(dataID & MOTOR_MASK));
+      const RI_RegDesc_t *pReg = MC_NULL;
+
+      if ((pMap != MC_NULL) && (typeID >= TYPE_DATA_8BIT) && (typeID <= TYPE_DATA_32BIT))
+      {
+        pReg = RI_FindReg(pMap, dataID & REG_MASK);
+      }
+      if ((MC_NULL == pReg) || (0U == (pReg->access & RI_REG_R)))
+      {
+        retVal = MCP_ERROR_UNKNOWN_REG;
+      }
+      else
+      {
+        pPage->reg[i] = pReg;
+        pageSize += RI_ScalarSize(typeID);
+      }
+    }
+  }
+
+  /* A page that failed to define is left empty rather than half defined */
+  pPage->nbrOfReg = (MCP_CMD_OK == retVal) ? (uint8_t)nbrOfReg : 0U;
+  pPage->size = (MCP_CMD_OK == retVal) ? pageSize : 0U;
+  return (retVal);
+}
+
+/**
+  * @brief  MCP user command reading or writing a register page, see RI_RegPages.
+  *
+  * Registered as MCP_UserCallBack[MCP_USER_CMD_REG_PAGE] (mcp_config.c).
+  */
+uint8_t RI_RegPageCommand(uint16_t rxLength, uint8_t *rxBuffer, int16_t txSyncFreeSpace, uint16_t *txLength,
+                          uint8_t *txBuffer)
+{
+  uint8_t retVal = MCP_CMD_OK;
+  RI_RegPage_t *pPage;
+  uint16_t i;
+
+  *txLength = 0U;
+  if ((rxLength < 2U) || (rxBuffer[1] >= RI_PAGE_NBR))
+  {
+    retVal = MCP_ERROR_BAD_RAW_FORMAT;
+  }
+  else
+  {
+    pPage = &RI_RegPages[rxBuffer[1]];
+    switch (rxBuffer[0])
+    {
+      case RI_PAGE_DEFINE:
+      {
+        retVal = RI_RegPageDefine(pPage, &rxBuffer[2], rxLength - 2U);
+        break;
+      }
+
+      case RI_PAGE_READ:
+      {
+        if ((int16_t)pPage->size > txSyncFreeSpace)
+        {
+          retVal = MCP_ERROR_NO_TXSYNC_SPACE;
+        }
+        else
+        {
+          uint8_t *txData = txBuffer;
+          for (i = 0U; i < pPage->nbrOfReg; i++)
+          {
+            uint16_t regSize = RI_ScalarSize((uint8_t)pPage->reg[i]->regID & TYPE_MASK);
+            RI_ReadScalar(pPage->reg[i], txData, regSize);
+            txData = &txData[regSize];
+          }
+          *txLength = pPage->size;
+        }
+        break;
+      }
+
+      case RI_PAGE_WRITE:
+      {
+        if ((rxLength - 2U) != pPage->size)
+        {
+          retVal = MCP_ERROR_BAD_RAW_FORMAT;
+        }
+        else
+        {
+          /* All or nothing: check the rights before the first write */
+          for (i = 0U; (i < pPage->nbrOfReg) && (MCP_CMD_OK == retVal); i++)
+          {
+            retVal = (0U == (pPage->reg[i]->access & RI_REG_W)) ? MCP_ERROR_RO_REG : MCP_CMD_OK;
+          }
+          if (MCP_CMD_OK == retVal)
+          {
+            const uint8_t *rxData = &rxBuffer[2];
+            for (i = 0U; i < pPage->nbrOfReg; i++)
+            {
+              uint16_t regSize = RI_ScalarSize((uint8_t)pPage->reg[i]->regID & TYPE_MASK);
+              RI_WriteScalar(pPage->reg[i], rxData, regSize);
+              rxData = &rxData[regSize];
+            }
+          }
+        }
+        break;
+      }
+
+      default:
+      {
+        retVal = MCP_CMD_UNKNOWN;
+        break;
+      }
+    }
+  }
+  return (retVal);
+}
 uint8_t RI_MovString(const char_t *srcString, char_t *destString, uint16_t *size, int16_t maxSize)
 {
   uint8_t retVal = MCP_CMD_OK;
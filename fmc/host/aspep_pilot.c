@@ -0,0 +1,140 @@
+/* Controller side of ASPEP, see aspep_pilot.h */
+#include <string.h>
+
+#include "aspep_pilot.h"
+
+static uint8_t crc4_nibbles(uint32_t header, int nibbles)
+{
+  uint8_t crc = 0;
+  for (int n = 0; n < nibbles; n++) {
+    crc ^= (uint8_t)((header >> (4 * n)) & 0xFu);
+    for (int b = 0; b < 4; b++) {
+      crc = (uint8_t)((crc & 0x8u) ? ((uint32_t)crc << 1) ^ 0x17u : ((uint32_t)crc << 1));
+    }
+  }
+  return crc & 0xFu;
+}
+
+uint32_t aspep_pilot_header_crc(uint32_t header)
+{
+  header &= 0x0FFFFFFFu;
+  return header | ((uint32_t)crc4_nibbles(header, 7) << 28);
+}
+
+bool aspep_pilot_header_ok(uint32_t header)
+{
+  return aspep_pilot_header_crc(header) == header;
+}
+
+/* CRC-16/MODBUS, bytewise over a table built on first use */
+static uint16_t crc16_modbus(const uint8_t *p, uint32_t len)
+{
+  static uint16_t table[256];
+  static bool ready;
+  if (!ready) {
+    for (uint32_t i = 0; i < 256u; i++) {
+      uint16_t c = (uint16_t)i;
+      for (int b = 0; b < 8; b++) c = (uint16_t)((c & 1u) ? ((c >> 1) ^ 0xA001u) : (c >> 1));
+      table[i] = c;
+    }
+    ready = true;
+  }
+  uint16_t crc = 0xFFFFu;
+  for (uint32_t i = 0; i < len; i++) crc = (uint16_t)((crc >> 8) ^ table[(crc ^ p[i]) & 0xFFu]);
+  return crc;
+}
+
+static uint16_t put_header(uint8_t *out, uint32_t header)
+{
+  header = aspep_pilot_header_crc(header);
+  memcpy(out, &header, 4);
+  return ASPEP_PILOT_HEADER_SIZE;
+}
+
+uint16_t aspep_pilot_beacon(uint8_t *out, const aspep_pilot_caps_t *caps)
+{
+  return put_header(out, ASPEP_PILOT_BEACON
+                         | ((uint32_t)(caps->version & 0x3u) << 4)
+                         | ((uint32_t)(caps->mcpa_delta & 0x1u) << 6)
+                         | ((uint32_t)(caps->data_crc & 0x1u) << 7)
+                         | ((uint32_t)(caps->rx_max & 0x3Fu) << 8)
+                         | ((uint32_t)(caps->txs_max & 0x7Fu) << 14)
+                         | ((uint32_t)(caps->txa_max & 0x7Fu) << 21));
+}
+
+uint16_t aspep_pilot_ping(uint8_t *out, uint16_t number)
+{
+  return put_header(out, ASPEP_PILOT_PING | ((uint32_t)number << 12));
+}
+
+uint16_t aspep_pilot_data(uint8_t *out, const uint8_t *payload, uint16_t len, bool data_crc)
+{
+  uint16_t n = put_header(out, ASPEP_PILOT_DATA | ((uint32_t)len << 4));
+  memcpy(&out[n], payload, len);
+  n += len;
+  if (data_crc && (len > 0u)) {
+    uint16_t crc = crc16_modbus(payload, len);
+    out[n++] = (uint8_t)(crc & 0xFFu);
+    out[n++] = (uint8_t)(crc >> 8);
+  }
+  return n;
+}
+
+void aspep_pilot_caps_of(uint32_t beacon, aspep_pilot_caps_t *caps)
+{
+  caps->version = (uint8_t)((beacon >> 4) & 0x3u);
+  caps->mcpa_delta = (uint8_t)((beacon >> 6) & 0x1u);
+  caps->data_crc = (uint8_t)((beacon >> 7) & 0x1u);
+  caps->rx_max = (uint8_t)((beacon >> 8) & 0x3Fu);
+  caps->txs_max = (uint8_t)((beacon >> 14) & 0x7Fu);
+  caps->txa_max = (uint8_t)((beacon >> 21) & 0x7Fu);
+}
+
+uint8_t aspep_pilot_nack_error(uint32_t nack)
+{
+  return (uint8_t)((nack >> 8) & 0xFFu);
+}
+
+void aspep_pilot_rx_reset(aspep_pilot_rx_t *rx)
+{
+  rx->got = 0;
+  rx->need = ASPEP_PILOT_HEADER_SIZE;
+  rx->in_payload = false;
+}
+
+aspep_pilot_ev_t aspep_pilot_rx_byte(aspep_pilot_rx_t *rx, uint8_t b)
+{
+  if (rx->need == 0u) aspep_pilot_rx_reset(rx);
+
+  if (!rx->in_payload) {
+    ((uint8_t *)&rx->header)[rx->got++] = b;   /* little-endian host */
+    if (rx->got < ASPEP_PILOT_HEADER_SIZE) return ASPEP_PILOT_EV_NONE;
+    rx->got = 0;
+    if (!aspep_pilot_header_ok(rx->header)) return ASPEP_PILOT_EV_BAD_HEADER;
+    switch (rx->header & 0xFu) {
+      case ASPEP_PILOT_BEACON: return ASPEP_PILOT_EV_BEACON;
+      case ASPEP_PILOT_PING:   return ASPEP_PILOT_EV_PING;
+      case ASPEP_PILOT_NACK:   return ASPEP_PILOT_EV_NACK;
+      case ASPEP_PILOT_SYNC:
+      case ASPEP_PILOT_ASYNC:
+        rx->len = (uint16_t)((rx->header >> 4) & 0x1FFFu);
+        if (rx->len > ASPEP_PILOT_MAX_PAYLOAD) return ASPEP_PILOT_EV_BAD_HEADER;
+        rx->need = (uint16_t)(rx->len + ((rx->data_crc && (rx->len > 0u)) ? 2u : 0u));
+        if (rx->need == 0u) {
+          return ((rx->header & 0xFu) == ASPEP_PILOT_SYNC) ? ASPEP_PILOT_EV_SYNC : ASPEP_PILOT_EV_ASYNC;
+        }
+        rx->in_payload = true;
+        return ASPEP_PILOT_EV_NONE;
+      default:
+        return ASPEP_PILOT_EV_BAD_HEADER;
+    }
+  }
+
+  rx->payload[rx->got++] = b;
+  if (rx->got < rx->need) return ASPEP_PILOT_EV_NONE;
+  rx->need = 0;
+  if ((rx->len > 0u) && rx->data_crc && (crc16_modbus(rx->payload, (uint32_t)rx->len + 2u) != 0u)) {
+    return ASPEP_PILOT_EV_BAD_DATA_CRC;
+  }
+  return ((rx->header & 0xFu) == ASPEP_PILOT_SYNC) ? ASPEP_PILOT_EV_SYNC : ASPEP_PILOT_EV_ASYNC;
+}
@@ -0,0 +1,77 @@
+/* Controller ("Motor Pilot") side of ASPEP, written from the protocol rather
+ * than from aspep.c so that the two sides check each other.
+ *
+ * Frames: a 32-bit little-endian header, CRC-4 in bits 28..31, packet type in
+ * bits 0..3. Data packets carry the payload length in bits 4..16 and, when
+ * negotiated, a CRC-16/MODBUS after the payload (LSB first). The header CRC
+ * runs over the 7 data nibbles, least significant nibble first, each nibble
+ * MSB first; the generator is the one encoded by the aspep.c lookup tables
+ * (x^4 + x^2 + x + 1).
+ *
+ * The encoders build frames into a caller buffer; the decoder takes the
+ * performer's byte stream one byte at a time and reports whole packets.
+ */
+#ifndef ASPEP_PILOT_H
+#define ASPEP_PILOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ASPEP_PILOT_HEADER_SIZE  4u
+#define ASPEP_PILOT_MAX_PAYLOAD  4096u
+
+#define ASPEP_PILOT_DATA         0x9u    /* controller -> performer data packet */
+#define ASPEP_PILOT_PING         0x6u
+#define ASPEP_PILOT_BEACON       0x5u
+#define ASPEP_PILOT_NACK         0xFu
+#define ASPEP_PILOT_SYNC         0xAu    /* performer -> controller answer (MCTL_SYNC) */
+#define ASPEP_PILOT_ASYNC        0x9u    /* performer -> controller datalog (MCTL_ASYNC) */
+
+typedef struct {
+  uint8_t version;
+  uint8_t mcpa_delta;
+  uint8_t data_crc;
+  uint8_t rx_max;      /* max controller -> performer payload: (rx_max + 1) * 32 */
+  uint8_t txs_max;     /* max sync answer payload: (txs_max + 1) * 32 */
+  uint8_t txa_max;     /* max async payload: txa_max * 64 */
+} aspep_pilot_caps_t;
+
+typedef enum {
+  ASPEP_PILOT_EV_NONE,
+  ASPEP_PILOT_EV_BEACON,
+  ASPEP_PILOT_EV_PING,
+  ASPEP_PILOT_EV_NACK,
+  ASPEP_PILOT_EV_SYNC,
+  ASPEP_PILOT_EV_ASYNC,
+  ASPEP_PILOT_EV_BAD_HEADER,     /* header CRC or type; the decoder restarts on the next byte */
+  ASPEP_PILOT_EV_BAD_DATA_CRC,
+} aspep_pilot_ev_t;
+
+typedef struct {
+  bool data_crc;                 /* as negotiated */
+  uint32_t header;               /* last header decoded */
+  uint16_t len;                  /* payload length of the last data packet */
+  uint8_t payload[ASPEP_PILOT_MAX_PAYLOAD + 2u];
+  /* private */
+  uint16_t got;
+  uint16_t need;
+  bool in_payload;
+} aspep_pilot_rx_t;
+
+/* Returns header with its CRC nibble filled in */
+uint32_t aspep_pilot_header_crc(uint32_t header);
+bool aspep_pilot_header_ok(uint32_t header);
+
+/* Frame encoders, return the frame length */
+uint16_t aspep_pilot_beacon(uint8_t *out, const aspep_pilot_caps_t *caps);
+uint16_t aspep_pilot_ping(uint8_t *out, uint16_t number);
+uint16_t aspep_pilot_data(uint8_t *out, const uint8_t *payload, uint16_t len, bool data_crc);
+
+/* Beacon / ping / NACK fields */
+void aspep_pilot_caps_of(uint32_t beacon, aspep_pilot_caps_t *caps);
+uint8_t aspep_pilot_nack_error(uint32_t nack);
+
+void aspep_pilot_rx_reset(aspep_pilot_rx_t *rx);
+aspep_pilot_ev_t aspep_pilot_rx_byte(aspep_pilot_rx_t *rx, uint8_t b);
+
+#endif /* ASPEP_PILOT_H */
@@ -0,0 +1,290 @@
+/* blog_decode: render the firmware's deferred binary log (plat/blog.h).
+ *
+ *   blog_decode fmc.elf [capture.txt] [--hz 170000000] [--only]
+ *
+ * Reads a serial capture (stdin if no file). Lines starting with "#B:" are
+ * records; the format string is looked up by its offset in the ELF's .logfmt
+ * section, %s arguments by address in the ELF's loadable sections (flash
+ * constants only). "#D:<n>" lines report dropped records. Every other line is
+ * passed through unchanged unless --only is given.
+ *
+ * Each argument is one 32-bit word: integers are truncated to 32 bits, floats
+ * are stored as float bit patterns, so %ll / %Lf print only the low word.
+ */
+#include <elf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOG_MARK      0xB5u
+#define MAX_WORDS      10
+#define MAX_SECTIONS   64
+
+typedef struct {
+  uint32_t addr;
+  uint32_t size;
+  const uint8_t *data;
+} section_t;
+
+static uint8_t *elf_buf;
+static const char *logfmt;
+static uint32_t logfmt_size;
+static section_t loadable[MAX_SECTIONS];
+static int n_loadable;
+
+static int load_elf(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  elf_buf = malloc((size_t)len);
+  if ((elf_buf == NULL) || (fread(elf_buf, 1, (size_t)len, f) != (size_t)len)) {
+    fclose(f);
+    fprintf(stderr, "%s: read failed\n", path);
+    return -1;
+  }
+  fclose(f);
+
+  const Elf32_Ehdr *eh = (const Elf32_Ehdr *)elf_buf;
+  if ((len < (long)sizeof(*eh)) || (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0) ||
+      (eh->e_ident[EI_CLASS] != ELFCLASS32) || (eh->e_ident[EI_DATA] != ELFDATA2LSB)) {
+    fprintf(stderr, "%s: not a 32-bit little-endian ELF\n", path);
+    return -1;
+  }
+
+  const Elf32_Shdr *sh = (const Elf32_Shdr *)(elf_buf + eh->e_shoff);
+  const char *shstr = (const char *)(elf_buf + sh[eh->e_shstrndx].sh_offset);
+  for (int i = 0; i < eh->e_shnum; i++) {
+    const char *name = shstr + sh[i].sh_name;
+    if (strcmp(name, ".logfmt") == 0) {
+      logfmt = (const char *)(elf_buf + sh[i].sh_offset);
+      logfmt_size = sh[i].sh_size;
+    } else if ((sh[i].sh_flags & SHF_ALLOC) && (sh[i].sh_type == SHT_PROGBITS) &&
+               (n_loadable < MAX_SECTIONS)) {
+      loadable[n_loadable].addr = sh[i].sh_addr;
+      loadable[n_loadable].size = sh[i].sh_size;
+      loadable[n_loadable].data = elf_buf + sh[i].sh_offset;
+      n_loadable++;
+    }
+  }
+  if (logfmt == NULL) {
+    fprintf(stderr, "%s: no .logfmt section (built without blog?)\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+static const char *lookup_str(uint32_t addr)
+{
+  for (int i = 0; i < n_loadable; i++) {
+    const section_t *s = &loadable[i];
+    if ((addr >= s->addr) && (addr < s->addr + s->size)) {
+      const char *p = (const char *)s->data + (addr - s->addr);
+      if (memchr(p, 0, s->addr + s->size - addr) != NULL) return p;
+    }
+  }
+  return NULL;
+}
+
+static float word_to_float(uint32_t w)
+{
+  float f;
+  memcpy(&f, &w, sizeof(f));
+  return f;
+}
+
+/* printf with the target's 32-bit argument words */
+static void render(const char *fmt, const uint32_t *a, int n, char *out, size_t cap)
+{
+  size_t k = 0;
+  int ai = 0;
+  out[0] = 0;
+
+#define NEXT_ARG() ((ai < n) ? a[ai++] : (ai++, 0u))
+#define EMIT(...)                                                      \
+  do {                                                                 \
+    if (k < cap) {                                                     \
+      int m_ = snprintf(out + k, cap - k, __VA_ARGS__);                \
+      if (m_ > 0) k = (k + (size_t)m_ < cap) ? k + (size_t)m_ : cap - 1; \
+    }                                                                  \
+  } while (0)
+
+  for (const char *p = fmt; *p != 0; p++) {
+    if (*p != '%') {
+      EMIT("%c", *p);
+      continue;
+    }
+    if (p[1] == '%') {
+      EMIT("%%");
+      p++;
+      continue;
+    }
+
+    char spec[32];
+    size_t s = 0;
+    spec[s++] = '%';
+    p++;
+    while ((*p != 0) && (strchr("-+ #0", *p) != NULL) && (s < 8)) spec[s++] = *p++;
+    if (*p == '*') {
+      s += (size_t)snprintf(spec + s, sizeof(spec) - s, "%d", (int)(int32_t)NEXT_ARG());
+      p++;
+    } else {
+      while ((*p >= '0') && (*p <= '9') && (s < 16)) spec[s++] = *p++;
+    }
+    if (*p == '.') {
+      spec[s++] = *p++;
+      if (*p == '*') {
+        s += (size_t)snprintf(spec + s, sizeof(spec) - s, "%d", (int)(int32_t)NEXT_ARG());
+        p++;
+      } else {
+        while ((*p >= '0') && (*p <= '9') && (s < 24)) spec[s++] = *p++;
+      }
+    }
+    while ((*p != 0) && (strchr("hlLqjzt", *p) != NULL)) p++;   /* 长度修饰: 参数都是 32 位 */
+    if (*p == 0) break;
+
+    char conv = *p;
+    spec[s++] = conv;
+    spec[s] = 0;
+
+    uint32_t w = NEXT_ARG();
+    if (ai > n) {
+      EMIT("<?>");
+      continue;
+    }
+    switch (conv) {
+      case 'd': case 'i':
+        EMIT(spec, (int)(int32_t)w);
+        break;
+      case 'u': case 'x': case 'X': case 'o':
+        EMIT(spec, (unsigned)w);
+        break;
+      case 'c':
+        EMIT(spec, (int)w);
+        break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        EMIT(spec, (double)word_to_float(w));
+        break;
+      case 's': {
+        const char *str = lookup_str(w);
+        if (str != NULL) {
+          EMIT(spec, str);
+        } else {
+          EMIT("<str@0x%08x>", (unsigned)w);
+        }
+        break;
+      }
+      case 'p':
+        EMIT("0x%08x", (unsigned)w);
+        break;
+      default:
+        EMIT("<%%%c?>", conv);
+        break;
+    }
+  }
+#undef NEXT_ARG
+#undef EMIT
+}
+
+static int parse_hex_words(const char *p, uint32_t *w, int max)
+{
+  int n = 0;
+  while ((n < max) && (strlen(p) >= 8)) {
+    char tmp[9];
+    memcpy(tmp, p, 8);
+    tmp[8] = 0;
+    char *end;
+    w[n++] = (uint32_t)strtoul(tmp, &end, 16);
+    if (*end != 0) return -1;
+    p += 8;
+  }
+  return (*p == 0) ? n : -1;
+}
+
+int main(int argc, char **argv)
+{
+  const char *elf_path = NULL;
+  const char *cap_path = NULL;
+  double hz = 170e6;
+  int only = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "--hz") == 0) && (i + 1 < argc)) {
+      hz = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--only") == 0) {
+      only = 1;
+    } else if (strcmp(argv[i], "--help") == 0) {
+      printf("usage: blog_decode fmc.elf [capture.txt] [--hz SYSCLK] [--only]\n");
+      return 0;
+    } else if (elf_path == NULL) {
+      elf_path = argv[i];
+    } else {
+      cap_path = argv[i];
+    }
+  }
+  if (elf_path == NULL) {
+    fprintf(stderr, "usage: blog_decode fmc.elf [capture.txt] [--hz SYSCLK] [--only]\n");
+    return 2;
+  }
+  if (load_elf(elf_path) != 0) return 1;
+
+  FILE *in = stdin;
+  if ((cap_path != NULL) && ((in = fopen(cap_path, "r")) == NULL)) {
+    perror(cap_path);
+    return 1;
+  }
+
+  static const char lvl_tag[4] = { '?', 'I', 'W', 'E' };
+  char line[1024];
+  char text[1024];
+  uint64_t t64 = 0;
+  uint32_t t_prev = 0;
+  int have_t = 0;
+  unsigned long bad = 0;
+
+  while (fgets(line, sizeof(line), in) != NULL) {
+    line[strcspn(line, "\r\n")] = 0;
+    /* 终端回显和日志可能粘在同一行, 从前缀处开始解析 */
+    char *b = strstr(line, "#B:");
+    char *d = strstr(line, "#D:");
+
+    if (d != NULL) {
+      printf("[blog] %s records dropped on target (cumulative)\n", d + 3);
+      continue;
+    }
+    if (b == NULL) {
+      if (!only) printf("%s\n", line);
+      continue;
+    }
+
+    uint32_t w[MAX_WORDS];
+    int n = parse_hex_words(b + 3, w, MAX_WORDS);
+    uint32_t nargs = (n >= 2) ? ((w[0] >> 8) & 0x0Fu) : 0u;
+    uint32_t id = w[0] >> 16;
+    if ((n < 2) || ((w[0] & 0xFFu) != BLOG_MARK) || ((int)(2u + nargs) != n) ||
+        (id >= logfmt_size)) {
+      bad++;
+      printf("[blog] bad record: %s\n", b);
+      continue;
+    }
+
+    if (have_t) {
+      t64 += (uint32_t)(w[1] - t_prev);
+    }
+    t_prev = w[1];
+    have_t = 1;
+
+    render(logfmt + id, &w[2], (int)nargs, text, sizeof(text));
+    printf("[%c] %12.6f %s\n", lvl_tag[(w[0] >> 12) & 3u], (double)t64 / hz, text);
+  }
+
+  if (in != stdin) fclose(in);
+  if (bad != 0) fprintf(stderr, "blog_decode: %lu malformed record(s)\n", bad);
+  return 0;
+}
@@ -0,0 +1,7 @@
+# ctest helper: run CMD (a ;-list) and require exit code EXPECT, e.g.
+#   cmake -DCMD="map_check;a.map;b.ld" -DEXPECT=1 -P expect_exit.cmake
+# WILL_FAIL would also pass on a usage / parse error (exit 2).
+execute_process(COMMAND ${CMD} RESULT_VARIABLE rc)
+if(NOT rc STREQUAL "${EXPECT}")
+  message(FATAL_ERROR "exit ${rc}, expected ${EXPECT}")
+endif()
@@ -0,0 +1,119 @@
+/* frec_decode: turn a fault black box dump (CLI "frec dump") into CSV.
+ *
+ *   frec_decode [capture.txt] [--hz 16000]
+ *
+ * Reads a serial capture (stdin if no file). "#FH:" is the 20-byte window
+ * header, each "#F:" line one 24-byte fault_rec_rec_t (plat/fault_rec.h),
+ * little endian, oldest record first. Every other line is skipped.
+ *
+ * Output: the header as "#" comment lines, then one CSV row per HF tick.
+ * "tick" counts back from the last record (0 = the tick the fault was raised
+ * in, for MCI faults), t_ms uses --hz (the FOC rate, default 16 kHz). Values
+ * stay in MCSDK units (s16A / s16V / s16 degrees, digit per PWM for speed,
+ * u16 volts for vbus); the angles are also given in degrees.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HDR_SIZE       20
+#define REC_SIZE       24
+#define MAX_RECORDS    4096
+
+static uint8_t recs[MAX_RECORDS][REC_SIZE];
+
+static int hex_bytes(const char *s, uint8_t *out, int n)
+{
+  for (int i = 0; i < n; i++) {
+    unsigned v;
+    if (sscanf(s + 2 * i, "%2x", &v) != 1) {
+      return -1;
+    }
+    out[i] = (uint8_t)v;
+  }
+  return 0;
+}
+
+static uint16_t u16(const uint8_t *b)
+{
+  return (uint16_t)(b[0] | (b[1] << 8));
+}
+
+static uint32_t u32(const uint8_t *b)
+{
+  return (uint32_t)u16(b) | ((uint32_t)u16(b + 2) << 16);
+}
+
+static double deg(uint16_t a)
+{
+  return (double)(int16_t)a * 180.0 / 32768.0;
+}
+
+int main(int argc, char **argv)
+{
+  const char *path = NULL;
+  double hz = 16000.0;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "--hz") == 0) && (i + 1 < argc)) {
+      hz = atof(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: %s [capture.txt] [--hz 16000]\n", argv[0]);
+      return 2;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (hz <= 0.0) {
+    fprintf(stderr, "--hz must be positive\n");
+    return 2;
+  }
+
+  FILE *f = (path != NULL) ? fopen(path, "r") : stdin;
+  if (f == NULL) {
+    perror(path);
+    return 2;
+  }
+
+  char line[256];
+  uint8_t hdr[HDR_SIZE];
+  int have_hdr = 0;
+  int n = 0;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (strncmp(line, "#FH:", 4) == 0) {
+      if (hex_bytes(line + 4, hdr, HDR_SIZE) == 0) {
+        /* A new dump replaces anything before it */
+        have_hdr = 1;
+        n = 0;
+      }
+    } else if ((strncmp(line, "#F:", 3) == 0) && have_hdr && (n < MAX_RECORDS)) {
+      if (hex_bytes(line + 3, recs[n], REC_SIZE) == 0) {
+        n++;
+      }
+    }
+  }
+  if (f != stdin) {
+    fclose(f);
+  }
+  if (!have_hdr) {
+    fprintf(stderr, "no \"#FH:\" line (run \"frec dump\" on the target)\n");
+    return 1;
+  }
+
+  static const char *const src[] = {"?", "mci", "brk"};
+  const uint8_t source = hdr[11];
+  printf("# magic 0x%08x, M%u faults 0x%04x from %s, state %u\n", u32(hdr), (unsigned)hdr[10] + 1u,
+         u16(hdr + 8), src[(source < 3u) ? source : 0u], u16(hdr + 12));
+  printf("# %d records of %u written, %u resets since the freeze\n", n, u32(hdr + 4), u16(hdr + 14));
+  printf("tick,t_ms,ia,ib,iq,id,vq,vd,el_angle,el_deg,obs_angle,obs_deg,obs_speed,vbus,faults,state,flags\n");
+  for (int i = 0; i < n; i++) {
+    const uint8_t *r = recs[i];
+    const int tick = i - (n - 1);
+    printf("%d,%.4f,%d,%d,%d,%d,%d,%d,%d,%.2f,%d,%.2f,%d,%u,0x%04x,%u,%u\n", tick, tick * 1000.0 / hz,
+           (int16_t)u16(r), (int16_t)u16(r + 2), (int16_t)u16(r + 4), (int16_t)u16(r + 6), (int16_t)u16(r + 8),
+           (int16_t)u16(r + 10), (int16_t)u16(r + 12), deg(u16(r + 12)), (int16_t)u16(r + 14), deg(u16(r + 14)),
+           (int16_t)u16(r + 16), u16(r + 18), u16(r + 20), r[22], r[23]);
+  }
+  return 0;
+}
@@ -0,0 +1,226 @@
+/*
+ * host_cordic.c
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  G474 CORDIC 的行为模型（RM0440 §17）：
+ *  按 CSR 的 FUNC/SCALE/NARGS/NRES/ARGSIZE/RESSIZE 解码参数与结果，
+ *  支持 COSINE / SINE / PHASE / MODULUS / SQRT，其它函数返回 0。
+ *  精度按双精度计算后四舍五入到 q1.15 / q1.31，与硬件 6 次迭代结果差 1~2 LSB。
+ *
+ *  DMA 请求 (CSR.DMAREN / DMAWEN)：主机上没有总线主设备，
+ *  host_cordic_dma_service() 代替 DMA 控制器搬一个字。
+ */
+#include <math.h>
+#include "stm32g4xx_ll_cordic.h"
+#include "stm32g4xx_ll_dmamux.h"
+
+/* ── 模型状态 ── */
+static uint32_t s_arg1;
+static uint32_t s_arg2 = 0x7FFFFFFFu;     /* 复位值：模长 = 1 */
+static uint8_t  s_args_pending;           /* 32 位 NARGS=2 时已收到的参数个数 */
+static uint32_t s_res[2];
+static uint8_t  s_res_left;               /* 还需读几次 RDATA */
+static uint8_t  s_res_idx;
+
+static double q31_to_d(uint32_t v) { return (double)(int32_t)v / 2147483648.0; }
+static double q15_to_d(uint16_t v) { return (double)(int16_t)v / 32768.0; }
+
+static int32_t d_to_q31(double x)
+{
+  double r = nearbyint(x * 2147483648.0);
+  if (r >  2147483647.0) { r =  2147483647.0; }
+  if (r < -2147483648.0) { r = -2147483648.0; }
+  return (int32_t)r;
+}
+
+static int16_t d_to_q15(double x)
+{
+  double r = nearbyint(x * 32768.0);
+  if (r >  32767.0) { r =  32767.0; }
+  if (r < -32768.0) { r = -32768.0; }
+  return (int16_t)r;
+}
+
+static void cordic_compute(CORDIC_TypeDef *CORDICx, double a1, double a2)
+{
+  const uint32_t csr   = CORDICx->CSR;
+  const uint32_t func  = csr & CORDIC_CSR_FUNC;
+  const uint32_t scale = (csr & CORDIC_CSR_SCALE) >> CORDIC_CSR_SCALE_Pos;
+  double r1 = 0.0;
+  double r2 = 0.0;
+
+  switch (func)
+  {
+    case LL_CORDIC_FUNCTION_COSINE:
+      r1 = a2 * cos(a1 * M_PI);
+      r2 = a2 * sin(a1 * M_PI);
+      break;
+    case LL_CORDIC_FUNCTION_SINE:
+      r1 = a2 * sin(a1 * M_PI);
+      r2 = a2 * cos(a1 * M_PI);
+      break;
+    case LL_CORDIC_FUNCTION_PHASE:
+      r1 = atan2(a2, a1) / M_PI;
+      r2 = sqrt((a1 * a1) + (a2 * a2));
+      break;
+    case LL_CORDIC_FUNCTION_MODULUS:
+      r1 = sqrt((a1 * a1) + (a2 * a2));
+      r2 = atan2(a2, a1) / M_PI;
+      break;
+    case LL_CORDIC_FUNCTION_SQUAREROOT:
+    {
+      const double k = ldexp(1.0, (int)scale);
+      r1 = (a1 > 0.0) ? (sqrt(a1 * k) / k) : 0.0;
+      break;
+    }
+    default:
+      break;
+  }
+
+  if ((csr & CORDIC_CSR_RESSIZE) != 0U)
+  {
+    s_res[0] = (uint16_t)d_to_q15(r1) | ((uint32_t)(uint16_t)d_to_q15(r2) << 16);
+    s_res_left = 1U;
+  }
+  else
+  {
+    s_res[0] = (uint32_t)d_to_q31(r1);
+    s_res[1] = (uint32_t)d_to_q31(r2);
+    s_res_left = ((csr & CORDIC_CSR_NRES) != 0U) ? 2U : 1U;
+  }
+  s_res_idx = 0U;
+  CORDICx->CSR = csr | CORDIC_CSR_RRDY;
+}
+
+void host_cordic_write(CORDIC_TypeDef *CORDICx, uint32_t InData)
+{
+  const uint32_t csr = CORDICx->CSR;
+
+  CORDICx->WDATA = InData;
+
+  if ((csr & CORDIC_CSR_ARGSIZE) != 0U)
+  {
+    /* 16 位：一次写入两个参数，低半字 ARG1，高半字 ARG2 */
+    cordic_compute(CORDICx, q15_to_d((uint16_t)InData), q15_to_d((uint16_t)(InData >> 16)));
+    return;
+  }
+
+  if (((csr & CORDIC_CSR_NARGS) != 0U) && (s_args_pending == 0U))
+  {
+    s_arg1 = InData;
+    s_args_pending = 1U;
+    return;
+  }
+
+  if (s_args_pending != 0U)
+  {
+    s_arg2 = InData;
+    s_args_pending = 0U;
+  }
+  else
+  {
+    s_arg1 = InData;
+  }
+  cordic_compute(CORDICx, q31_to_d(s_arg1), q31_to_d(s_arg2));
+}
+
+uint32_t host_cordic_read(const CORDIC_TypeDef *CORDICx)
+{
+  CORDIC_TypeDef *c = (CORDIC_TypeDef *)CORDICx;
+  uint32_t v;
+
+  if (s_res_left == 0U)
+  {
+    return c->RDATA;                       /* 无新结果：重复上一次 */
+  }
+  v = s_res[s_res_idx++];
+  s_res_left--;
+  c->RDATA = v;
+  if (s_res_left == 0U)
+  {
+    c->CSR &= ~CORDIC_CSR_RRDY;
+  }
+  return v;
+}
+
+/* ── DMA 通道模型 (DMAMUX 通道 0~7 -> DMA1，8~15 -> DMA2) ──
+ * CNDTR 或 CMAR 与模型最后看到的不同，说明软件重新装过通道 */
+static struct
+{
+  uint32_t cmar;
+  uint32_t reload;
+  uint32_t last;
+} s_dma[16];
+
+static DMA_TypeDef *dma_of(uint32_t c)
+{
+  return (c < 8U) ? DMA1 : DMA2;
+}
+
+static DMA_Channel_TypeDef *dma_channel(uint32_t c)
+{
+  const uint32_t base = (c < 8U) ? DMA1_Channel1_BASE : DMA2_Channel1_BASE;
+  return (DMA_Channel_TypeDef *)(base + ((c % 8U) * (DMA1_Channel2_BASE - DMA1_Channel1_BASE)));
+}
+
+/* 找挂着 request 且已使能的通道，搬一个 32 位字 (内存递增)；传完置 TCIF/GIF */
+static uint32_t dma_transfer(uint32_t request)
+{
+  for (uint32_t c = 0U; c < 16U; c++)
+  {
+    DMA_Channel_TypeDef *ch = dma_channel(c);
+    if (((DMAMUX1[c].CCR & DMAMUX_CxCR_DMAREQ_ID) != request) || ((ch->CCR & DMA_CCR_EN) == 0U))
+    {
+      continue;
+    }
+    if ((ch->CNDTR != s_dma[c].last) || (ch->CMAR != s_dma[c].cmar))
+    {
+      s_dma[c].reload = ch->CNDTR;
+      s_dma[c].cmar = ch->CMAR;
+    }
+    if ((ch->CNDTR == 0U) || (ch->CNDTR > s_dma[c].reload))
+    {
+      return 0U;
+    }
+    uint32_t *mem = (uint32_t *)(uintptr_t)ch->CMAR;
+    const uint32_t idx = s_dma[c].reload - ch->CNDTR;
+    if (request == LL_DMAMUX_REQ_CORDIC_WRITE)
+    {
+      host_cordic_write(CORDIC, mem[idx]);
+    }
+    else
+    {
+      mem[idx] = host_cordic_read(CORDIC);
+    }
+    ch->CNDTR--;
+    s_dma[c].last = ch->CNDTR;
+    if (ch->CNDTR == 0U)
+    {
+      dma_of(c)->ISR |= (DMA_ISR_GIF1 | DMA_ISR_TCIF1) << ((c % 8U) * 4U);
+    }
+    return 1U;
+  }
+  return 0U;
+}
+
+uint32_t host_cordic_dma_service(void)
+{
+  /* IFCR 是写 1 清零：在这里作用到 ISR 上 */
+  DMA1->ISR &= ~DMA1->IFCR;
+  DMA1->IFCR = 0U;
+  DMA2->ISR &= ~DMA2->IFCR;
+  DMA2->IFCR = 0U;
+
+  const uint32_t csr = CORDIC->CSR;
+  if (((csr & CORDIC_CSR_DMAREN) != 0U) && ((csr & CORDIC_CSR_RRDY) != 0U))
+  {
+    return dma_transfer(LL_DMAMUX_REQ_CORDIC_READ);
+  }
+  if (((csr & CORDIC_CSR_DMAWEN) != 0U) && (s_res_left == 0U))
+  {
+    return dma_transfer(LL_DMAMUX_REQ_CORDIC_WRITE);
+  }
+  return 0U;
+}
@@ -0,0 +1,211 @@
+/*
+ * host_periph.c
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "main.h"
+#include "parameters_conversion.h"
+#include "mc_config.h"
+#include "host_periph.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE MAP_FIXED
+#endif
+
+volatile uint32_t host_primask;
+
+static const struct
+{
+    uintptr_t base;
+    size_t    size;
+} s_regions[] =
+{
+    { PERIPH_BASE, (ADC1_BASE - PERIPH_BASE) + 0x00070000u },   /* APB1 … DAC4 */
+    { SCS_BASE & ~0xFFFFFu, 0x00100000u },                      /* ITM/DWT/SCS/CoreDebug */
+};
+
+static int s_mapped;
+
+/* 规则通道输入：ADC1 / ADC2 每个通道的转换结果 (左对齐 12 位) */
+#define HOST_ADC_CH_NB   19u
+static uint16_t s_adc_in[2][HOST_ADC_CH_NB];
+
+/* DMA1 通道模型：reload 是软件写入的传输长度 (循环模式重装值)，
+ * last 是模型自己最后写回的 CNDTR，CNDTR 与它不同说明软件重新配置过通道 */
+static struct
+{
+    uint32_t reload;
+    uint32_t last;
+} s_dma[8];
+
+void host_periph_init(void)
+{
+    if (s_mapped != 0)
+    {
+        return;
+    }
+    for (size_t i = 0; i < (sizeof(s_regions) / sizeof(s_regions[0])); i++)
+    {
+        void *p = mmap((void *)s_regions[i].base, s_regions[i].size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE, -1, 0);
+        if (p != (void *)s_regions[i].base)
+        {
+            fprintf(stderr, "host_periph: cannot map 0x%08lx\n", (unsigned long)s_regions[i].base);
+            exit(2);
+        }
+    }
+    s_mapped = 1;
+
+    /* ADC 已上电并校准：RCM_RegisterRegConv 跳过等待循环 */
+    ADC1->CR  = ADC_CR_ADEN | ADC_CR_ADVREGEN;
+    ADC2->CR  = ADC_CR_ADEN | ADC_CR_ADVREGEN;
+    ADC3->CR  = ADC_CR_ADEN | ADC_CR_ADVREGEN;
+    ADC1->ISR = ADC_ISR_ADRDY;
+    ADC2->ISR = ADC_ISR_ADRDY;
+    ADC3->ISR = ADC_ISR_ADRDY;
+    host_periph_set_vbus(NOMINAL_BUS_VOLTAGE_V);
+    host_periph_set_temp(T0_C);
+}
+
+__attribute__((constructor)) static void host_periph_ctor(void)
+{
+    host_periph_init();
+}
+
+static uint32_t volts_to_dr(double v)
+{
+    double raw = (v / ADC_REFERENCE_VOLTAGE) * 65536.0;
+    if (raw < 0.0)     { raw = 0.0; }
+    if (raw > 65535.0) { raw = 65535.0; }
+    return (uint32_t)raw & 0xFFF0u;
+}
+
+static uint32_t adc_index(const ADC_TypeDef *adc)
+{
+    return (adc == ADC2) ? 1u : 0u;
+}
+
+void host_periph_set_adc(ADC_TypeDef *adc, uint8_t channel, uint16_t raw)
+{
+    if (channel < HOST_ADC_CH_NB)
+    {
+        s_adc_in[adc_index(adc)][channel] = raw;
+    }
+    /* 软件触发的单次转换 (RCM_USE_DMA=0) 直接读 DR */
+    adc->DR   = raw;
+    adc->ISR |= ADC_ISR_EOC;
+}
+
+void host_periph_set_vbus(double vbus)
+{
+    host_periph_set_adc(ADC1, VbusRegConv_M1.channel, (uint16_t)volts_to_dr(vbus * VBUS_PARTITIONING_FACTOR));
+}
+
+void host_periph_set_temp(double celsius)
+{
+    host_periph_set_adc(ADC2, TempRegConv_M1.channel, (uint16_t)volts_to_dr(V0_V + (dV_dT * (celsius - T0_C))));
+}
+
+/* port/stm32g4xx_ll_adc.h：启动不碰其他 "rs" 位，停止立即完成 */
+void host_adc_reg_start(ADC_TypeDef *ADCx)
+{
+    ADCx->CR |= ADC_CR_ADSTART;
+}
+
+void host_adc_reg_stop(ADC_TypeDef *ADCx)
+{
+    ADCx->CR &= ~(ADC_CR_ADSTART | ADC_CR_ADSTP);
+}
+
+/* 一次 DMA 请求：找 DMAMUX 上挂着 request 且已使能的 DMA1 通道，外设→内存、16 位、内存递增 */
+static void dma_request(uint32_t request, uint16_t data)
+{
+    for (uint32_t c = 0u; c < 8u; c++)
+    {
+        DMA_Channel_TypeDef *ch = (DMA_Channel_TypeDef *)(DMA1_Channel1_BASE
+                                  + (c * (DMA1_Channel2_BASE - DMA1_Channel1_BASE)));
+        if (((DMAMUX1[c].CCR & DMAMUX_CxCR_DMAREQ_ID) != request) || ((ch->CCR & DMA_CCR_EN) == 0u))
+        {
+            continue;
+        }
+        if (ch->CNDTR != s_dma[c].last)
+        {
+            s_dma[c].reload = ch->CNDTR;
+        }
+        if ((ch->CNDTR == 0u) || (ch->CNDTR > s_dma[c].reload))
+        {
+            return;
+        }
+        uint16_t *mem = (uint16_t *)(uintptr_t)ch->CMAR;
+        mem[s_dma[c].reload - ch->CNDTR] = data;
+        uint32_t left = ch->CNDTR - 1u;
+        if ((left == 0u) && ((ch->CCR & DMA_CCR_CIRC) != 0u))
+        {
+            left = s_dma[c].reload;
+        }
+        ch->CNDTR = left;
+        s_dma[c].last = left;
+        return;
+    }
+}
+
+/* 规则序列：按 SQR1 的 rank 依次转换 (RCM 最多 4 个 rank)，每个结果进 DR，DMAEN 时发 DMA 请求 */
+static void adc_regular_trigger(ADC_TypeDef *adc, uint32_t request)
+{
+    static const uint32_t sq_pos[4] = { ADC_SQR1_SQ1_Pos, ADC_SQR1_SQ2_Pos, ADC_SQR1_SQ3_Pos, ADC_SQR1_SQ4_Pos };
+
+    if (((adc->CR & ADC_CR_ADSTART) == 0u)
+        || ((adc->CFGR & (ADC_CFGR_EXTEN | ADC_CFGR_EXTSEL)) != LL_ADC_REG_TRIG_EXT_TIM1_TRGO2))
+    {
+        return;
+    }
+    uint32_t len = ((adc->SQR1 & ADC_SQR1_L) >> ADC_SQR1_L_Pos) + 1u;
+    if (len > 4u)
+    {
+        len = 4u;
+    }
+    for (uint32_t r = 0u; r < len; r++)
+    {
+        uint32_t channel = (adc->SQR1 >> sq_pos[r]) & 0x1Fu;
+        uint16_t data = (channel < HOST_ADC_CH_NB) ? s_adc_in[adc_index(adc)][channel] : 0u;
+        adc->DR   = data;
+        adc->ISR |= ADC_ISR_EOC;
+        if ((adc->CFGR & ADC_CFGR_DMAEN) != 0u)
+        {
+            dma_request(request, data);
+        }
+    }
+    adc->ISR |= ADC_ISR_EOS;
+}
+
+void host_periph_tim1_update(void)
+{
+    if ((TIM1->CR2 & TIM_CR2_MMS2) == LL_TIM_TRGO2_UPDATE)
+    {
+        adc_regular_trigger(ADC1, LL_DMAMUX_REQ_ADC1);
+        adc_regular_trigger(ADC2, LL_DMAMUX_REQ_ADC2);
+    }
+}
+
+/* NVIC 只是映射内存：优先级与使能照写，测试可以回读 */
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)SubPriority;
+    NVIC_SetPriority(IRQn, PreemptPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    NVIC_EnableIRQ(IRQn);
+}
+
+/* MCP 的 REBOOT 命令：主机上直接结束进程 */
+void HAL_NVIC_SystemReset(void)
+{
+    fprintf(stderr, "host_periph: system reset requested\n");
+    exit(3);
+}
@@ -0,0 +1,28 @@
+/*
+ * host_periph.h
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  在主机进程里把 G474 的外设地址空间映射成普通内存，
+ *  让 CMSIS / LL / MCSDK 的寄存器读写原样执行。
+ */
+#ifndef HOST_PERIPH_H_
+#define HOST_PERIPH_H_
+
+#include <stdint.h>
+#include "stm32g4xx.h"
+
+/* 映射 0x40000000 (APB/AHB/ADC) 与 0xE0000000 (SCS/DWT)，失败时退出进程 */
+void host_periph_init(void);
+
+/* 规则通道模型：每个通道一个输入值 (左对齐 12 位)，同时写 DR 与 EOC 给软件触发的转换 */
+void host_periph_set_adc(ADC_TypeDef *adc, uint8_t channel, uint16_t raw);
+void host_periph_set_vbus(double vbus);     /* ADC1 VbusRegConv_M1 通道 */
+void host_periph_set_temp(double celsius);  /* ADC2 TempRegConv_M1 通道 */
+
+/* TIM1 更新事件：MMS2 = update 时 TRGO2 启动 ADC1/ADC2 规则序列，
+ * DMAEN 时结果经 DMAMUX 请求写进 DMA1 通道 (RCM_USE_DMA)。host_pwm_sample 每个 PWM 周期调用 */
+void host_periph_tim1_update(void);
+
+#endif /* HOST_PERIPH_H_ */
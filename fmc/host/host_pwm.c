@@ -0,0 +1,286 @@
+/*
+ * host_pwm.c
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  R3_2_* 的主机实现，替代 r3_2_g4xx_pwm_curr_fdbk.c。
+ *  扇区选相、偏置校准、Ia/Ib/Ic 回填等行为与原驱动保持一致，
+ *  TIM/ADC/OPAMP/COMP 的寄存器配置全部省略。
+ */
+#include <math.h>
+#include "main.h"
+#include "mc_type.h"
+#include "parameters_conversion.h"
+#include "mc_config.h"
+#include "r3_2_g4xx_pwm_curr_fdbk.h"
+#include "pwm_common.h"
+#include "host_pwm.h"
+#include "host_periph.h"
+
+host_pwm_t host_pwm_motor[HOST_PWM_MOTORS];
+
+/* R3_2_* 拿到的是 PWMC 句柄，按句柄里的电机号找对应的模型 */
+static host_pwm_t *pwm_of(const PWMC_Handle_t *pHdl)
+{
+    return &host_pwm_motor[(pHdl->Motor < HOST_PWM_MOTORS) ? pHdl->Motor : 0u];
+}
+
+void host_pwm_reset_motor(uint8_t motor)
+{
+    host_pwm_t *hp = &host_pwm_motor[motor];
+
+    hp->outputs_on      = false;
+    hp->low_sides_on    = false;
+    /* 运放偏置不完全对称，校准流程才有意义；M2 换一组，两路不会互相掩盖 */
+    hp->adc_offset[0]   = (motor == 0u) ? (32768u + 160u) : (32768u - 128u);
+    hp->adc_offset[1]   = (motor == 0u) ? (32768u - 96u)  : (32768u + 80u);
+    hp->adc_offset[2]   = (motor == 0u) ? (32768u + 48u)  : (32768u + 16u);
+    hp->inject_duration = 0u;
+    hp->duration_faults = 0u;
+    for (int i = 0; i < 3; i++)
+    {
+        hp->adc_raw[i] = hp->adc_offset[i];
+    }
+}
+
+void host_pwm_reset(void)
+{
+    host_pwm_reset_motor(0u);
+}
+
+void host_pwm_sample_motor(uint8_t motor, const double i_abc[3])
+{
+    host_pwm_t *hp = &host_pwm_motor[motor];
+
+    for (int i = 0; i < 3; i++)
+    {
+        /* Ia = Offset − ADC  ⇒  ADC = Offset − Ia·CONV；12 位左对齐量化 */
+        double raw = (double)hp->adc_offset[i] - (i_abc[i] * (double)CURRENT_CONV_FACTOR);
+        if (raw < 0.0)     { raw = 0.0; }
+        if (raw > 65535.0) { raw = 65535.0; }
+        hp->adc_raw[i] = (uint16_t)raw & 0xFFF0u;
+    }
+    if (motor == 0u)
+    {
+        host_periph_tim1_update();
+    }
+}
+
+void host_pwm_sample(const double i_abc[3])
+{
+    host_pwm_sample_motor(0u, i_abc);
+}
+
+bool host_pwm_get_duty_motor(uint8_t motor, double duty[3])
+{
+    const PWMC_R3_2_Handle_t *h = (const PWMC_R3_2_Handle_t *)pwmcHandle[motor];
+    const double arr = (double)h->Half_PWMPeriod;
+
+    if (!host_pwm_motor[motor].outputs_on)
+    {
+        duty[0] = duty[1] = duty[2] = 0.0;
+        return false;
+    }
+    /* PWM1 + 中心对齐：CNT < CCR 时高边导通 */
+    duty[0] = fmin((double)h->_Super.CntPhA / arr, 1.0);
+    duty[1] = fmin((double)h->_Super.CntPhB / arr, 1.0);
+    duty[2] = fmin((double)h->_Super.CntPhC / arr, 1.0);
+    return true;
+}
+
+bool host_pwm_get_duty(double duty[3])
+{
+    return host_pwm_get_duty_motor(0u, duty);
+}
+
+uint32_t host_pwm_hf_pwm_cycles(void)
+{
+    return (LL_TIM_GetRepetitionCounter(TIM1) + 1u) / 2u;
+}
+
+double host_pwm_period_s(void)
+{
+    return (1.0 / (double)PWM_FREQUENCY) * (double)LL_TIM_GetAutoReload(TIM1)
+           / (double)(PWM_PERIOD_CYCLES / 2u);
+}
+
+uint32_t host_pwm_hf_ticks(void)
+{
+    return LL_TIM_GetAutoReload(TIM1) * (LL_TIM_GetRepetitionCounter(TIM1) + 1u);
+}
+
+/* ── R3_2 接口 ── */
+
+void R3_2_Init(PWMC_R3_2_Handle_t *pHandle)
+{
+    pHandle->Half_PWMPeriod = pHandle->_Super.PWMperiod / 2u;
+    pHandle->ADCTriggerEdge = (uint16_t)LL_ADC_INJ_TRIG_EXT_RISING;
+    pHandle->PhaseAOffset   = 0u;
+    pHandle->PhaseBOffset   = 0u;
+    pHandle->PhaseCOffset   = 0u;
+    /* 周期和重复计数器照 MX_TIMx_Init 写进定时器，host_pwm_period_s 等从这里读 */
+    LL_TIM_SetAutoReload(pHandle->pParams_str->TIMx, pHandle->Half_PWMPeriod);
+    LL_TIM_SetRepetitionCounter(pHandle->pParams_str->TIMx, pHandle->pParams_str->RepetitionCounter);
+    host_pwm_reset_motor(pHandle->_Super.Motor);
+}
+
+void R3_2_CurrentReadingPolarization(PWMC_Handle_t *pHdl)
+{
+    PWMC_R3_2_Handle_t *pHandle = (PWMC_R3_2_Handle_t *)pHdl;
+    host_pwm_t *hp = pwm_of(pHdl);
+    uint32_t acc[3] = { 0u, 0u, 0u };
+    const double zero[3] = { 0.0, 0.0, 0.0 };
+
+    /* 输出关闭时电流为零，直接平均 NB_CONVERSIONS 次零点采样 */
+    host_pwm_sample_motor(pHdl->Motor, zero);
+    for (uint32_t n = 0u; n < NB_CONVERSIONS; n++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            acc[i] += hp->adc_raw[i];
+        }
+    }
+    pHandle->PhaseAOffset = acc[0] / NB_CONVERSIONS;
+    pHandle->PhaseBOffset = acc[1] / NB_CONVERSIONS;
+    pHandle->PhaseCOffset = acc[2] / NB_CONVERSIONS;
+    pHandle->_Super.offsetCalibStatus = true;
+    pHandle->_Super.CntPhA = pHandle->Half_PWMPeriod >> 1u;
+    pHandle->_Super.CntPhB = pHandle->Half_PWMPeriod >> 1u;
+    pHandle->_Super.CntPhC = pHandle->Half_PWMPeriod >> 1u;
+    pHandle->_Super.Sector = SECTOR_5;
+    pHandle->_Super.BrakeActionLock = false;
+}
+
+void R3_2_SetOffsetCalib(PWMC_Handle_t *pHdl, PolarizationOffsets_t *offsets)
+{
+    PWMC_R3_2_Handle_t *pHandle = (PWMC_R3_2_Handle_t *)pHdl;
+
+    pHandle->PhaseAOffset = (uint32_t)offsets->phaseAOffset;
+    pHandle->PhaseBOffset = (uint32_t)offsets->phaseBOffset;
+    pHandle->PhaseCOffset = (uint32_t)offsets->phaseCOffset;
+    pHdl->offsetCalibStatus = true;
+}
+
+void R3_2_GetOffsetCalib(PWMC_Handle_t *pHdl, PolarizationOffsets_t *offsets)
+{
+    PWMC_R3_2_Handle_t *pHandle = (PWMC_R3_2_Handle_t *)pHdl;
+
+    offsets->phaseAOffset = (int32_t)pHandle->PhaseAOffset;
+    offsets->phaseBOffset = (int32_t)pHandle->PhaseBOffset;
+    offsets->phaseCOffset = (int32_t)pHandle->PhaseCOffset;
+}
+
+static int16_t sat_s16(int32_t v)
+{
+    if (v < -INT16_MAX) { return -INT16_MAX; }
+    if (v >  INT16_MAX) { return  INT16_MAX; }
+    return (int16_t)v;
+}
+
+void R3_2_GetPhaseCurrents(PWMC_Handle_t *pHdl, ab_t *Iab)
+{
+    PWMC_R3_2_Handle_t *pHandle = (PWMC_R3_2_Handle_t *)pHdl;
+    const host_pwm_t *hp = pwm_of(pHdl);
+    const int16_t ia = sat_s16((int32_t)pHandle->PhaseAOffset - (int32_t)hp->adc_raw[0]);
+    const int16_t ib = sat_s16((int32_t)pHandle->PhaseBOffset - (int32_t)hp->adc_raw[1]);
+    const int16_t ic = sat_s16((int32_t)pHandle->PhaseCOffset - (int32_t)hp->adc_raw[2]);
+
+    /* 与原驱动相同：每个扇区只有两相可测，第三相由 Ia+Ib+Ic=0 推出 */
+    switch (pHandle->_Super.Sector)
+    {
+        case SECTOR_4:
+        case SECTOR_5:
+            Iab->a = ia;
+            Iab->b = ib;
+            break;
+        case SECTOR_6:
+        case SECTOR_1:
+            Iab->b = ib;
+            Iab->a = sat_s16(-(int32_t)ib - (int32_t)ic);
+            break;
+        case SECTOR_2:
+        case SECTOR_3:
+            Iab->a = ia;
+            Iab->b = sat_s16(-(int32_t)ia - (int32_t)ic);
+            break;
+        default:
+            break;
+    }
+
+    pHandle->_Super.Ia = Iab->a;
+    pHandle->_Super.Ib = Iab->b;
+    pHandle->_Super.Ic = -Iab->a - Iab->b;
+}
+
+void R3_2_GetPhaseCurrents_OVM(PWMC_Handle_t *pHdl, ab_t *Iab)
+{
+    R3_2_GetPhaseCurrents(pHdl, Iab);
+}
+
+uint16_t R3_2_SetADCSampPointSectX(PWMC_Handle_t *pHdl)
+{
+    PWMC_R3_2_Handle_t *pHandle = (PWMC_R3_2_Handle_t *)pHdl;
+    host_pwm_t *hp = pwm_of(pHdl);
+
+    /* 中点采样窗口足够时固定采 AB 相，否则保留 SetPhaseVoltage 给出的扇区 */
+    if ((uint16_t)(pHandle->Half_PWMPeriod - pHdl->lowDuty) > pHandle->pParams_str->Tafter)
+    {
+        pHandle->_Super.Sector = SECTOR_5;
+    }
+
+    if (hp->inject_duration > 0u)
+    {
+        hp->inject_duration--;
+        hp->duration_faults++;
+        return MC_DURATION;
+    }
+    return MC_NO_ERROR;
+}
+
+uint16_t R3_2_SetADCSampPointSectX_OVM(PWMC_Handle_t *pHdl)
+{
+    return R3_2_SetADCSampPointSectX(pHdl);
+}
+
+void R3_2_TurnOnLowSides(PWMC_Handle_t *pHdl, uint32_t ticks)
+{
+    pHdl->TurnOnLowSidesAction = true;
+    pHdl->CntPhA = (uint16_t)ticks;
+    pHdl->CntPhB = (uint16_t)ticks;
+    pHdl->CntPhC = (uint16_t)ticks;
+    pwm_of(pHdl)->outputs_on   = true;
+    pwm_of(pHdl)->low_sides_on = true;
+}
+
+void R3_2_SwitchOnPWM(PWMC_Handle_t *pHdl)
+{
+    PWMC_R3_2_Handle_t *pHandle = (PWMC_R3_2_Handle_t *)pHdl;
+
+    pHdl->TurnOnLowSidesAction = false;
+    pHdl->CntPhA = pHandle->Half_PWMPeriod / 2u;
+    pHdl->CntPhB = pHandle->Half_PWMPeriod / 2u;
+    pHdl->CntPhC = pHandle->Half_PWMPeriod / 2u;
+    pwm_of(pHdl)->outputs_on   = true;
+    pwm_of(pHdl)->low_sides_on = false;
+    pHdl->PWMState = true;
+}
+
+void R3_2_SwitchOffPWM(PWMC_Handle_t *pHdl)
+{
+    pHdl->PWMState = false;
+    pHdl->TurnOnLowSidesAction = false;
+    pwm_of(pHdl)->outputs_on   = false;
+    pwm_of(pHdl)->low_sides_on = false;
+}
+
+void *R3_2_TIMx_UP_IRQHandler(PWMC_R3_2_Handle_t *pHandle)
+{
+    return &(pHandle->_Super.Motor);
+}
+
+/* RL 检测（Motor Profiler）在仿真中不支持，保留空实现以满足 mc_config.c 的函数表 */
+void R3_2_RLDetectionModeEnable(PWMC_Handle_t *pHdl)       { pHdl->RLDetectionMode = true; }
+void R3_2_RLDetectionModeDisable(PWMC_Handle_t *pHdl)      { pHdl->RLDetectionMode = false; }
+uint16_t R3_2_RLDetectionModeSetDuty(PWMC_Handle_t *pHdl, uint16_t hDuty) { (void)pHdl; (void)hDuty; return MC_NO_ERROR; }
+void R3_2_RLTurnOnLowSidesAndStart(PWMC_Handle_t *pHdl)    { R3_2_TurnOnLowSides(pHdl, 0u); }
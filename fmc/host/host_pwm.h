@@ -0,0 +1,52 @@
+/*
+ * host_pwm.h
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  R3_2 三电阻采样层的主机替身：
+ *  固件侧仍然调用 R3_2_* / PWMC_*，这里把占空比交给 plant，把 plant 的相电流
+ *  经过 “偏置 − I·CURRENT_CONV_FACTOR、12 位量化” 的 ADC 模型交回给 FOC。
+ *  每个电机一份状态（按 PWMC_Handle_t.Motor 选），NBR_OF_MOTORS=2 时 M2 对应 TIM8。
+ */
+#ifndef HOST_PWM_H_
+#define HOST_PWM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+    bool     outputs_on;        /* MOE：SwitchOnPWM 之后为 true                  */
+    bool     low_sides_on;      /* TurnOnLowSides（自举电容充电）                */
+    uint16_t adc_offset[3];     /* 各相采样链路的真实零点（左对齐 16 位）        */
+    uint16_t adc_raw[3];        /* 本周期 JDR1 值，由 host_pwm_sample 写入       */
+    uint32_t inject_duration;   /* >0 时让接下来 N 次 SetADCSampPointSectX 返回 MC_DURATION */
+    uint32_t duration_faults;   /* 已注入的次数                                  */
+} host_pwm_t;
+
+#define HOST_PWM_MOTORS 2
+
+extern host_pwm_t host_pwm_motor[HOST_PWM_MOTORS];
+#define host_pwm (host_pwm_motor[0])    /* M1，单电机代码沿用原名 */
+
+/* 复位一个电机的 ADC/输出模型（R3_2_Init 调用） */
+void host_pwm_reset_motor(uint8_t motor);
+void host_pwm_reset(void);
+
+/* 把三相电流（A）经 ADC 模型转换成该电机的 JDR 原始值；M1 同时算一次 TIM1 更新事件（规则序列触发） */
+void host_pwm_sample_motor(uint8_t motor, const double i_abc[3]);
+void host_pwm_sample(const double i_abc[3]);
+
+/* 当前生效的三相高边占空比 0..1；输出关闭时返回 false */
+bool host_pwm_get_duty_motor(uint8_t motor, double duty[3]);
+bool host_pwm_get_duty(double duty[3]);
+
+/* 按 TIM1 的 ARR/RCR（R3_2_Init 写入，pwm_gov 运行时改写）：
+ * 一次 HF 任务覆盖的 PWM 周期数 (RCR+1)/2、PWM 周期时长、HF 周期的定时器 tick 数。
+ * 时长按标称 ARR 折算 1/PWM_FREQUENCY，标称设置下和原来逐位一致 */
+uint32_t host_pwm_hf_pwm_cycles(void);
+double   host_pwm_period_s(void);
+uint32_t host_pwm_hf_ticks(void);
+
+#endif /* HOST_PWM_H_ */
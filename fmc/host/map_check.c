@@ -0,0 +1,253 @@
+/* map_check: verify the CCM SRAM placement of the HF ISR call graph in a GNU ld map.
+ *
+ *   map_check fmc.map ccm_hot.ld [--verbose]
+ *
+ * The hot list is read from ccm_hot.ld, the same file STM32G474RETX_FLASH.ld
+ * INCLUDEs into .ccmram: every "*(pattern ...)" line gives input section name
+ * globs. Each input section of the map ("Linker script and memory map" part)
+ * that matches one of them must have its address in CCM SRAM (I/D-bus,
+ * 0x10000000, 32K). The hot mutable state (FOCVars, PID / observer / PWM
+ * handles, table below) must be in SRAM1/SRAM2 and not in the CCM alias.
+ *
+ * Exit 0 when everything is in place, 1 when a hot section is misplaced,
+ * 2 on usage / parse errors. Needs -ffunction-sections / -fdata-sections in
+ * the firmware build, otherwise the hot functions have no own input section.
+ */
+#include <fnmatch.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CCM_BASE       0x10000000u
+#define CCM_SIZE       0x8000u
+#define SRAM_BASE      0x20000000u
+#define SRAM12_SIZE    0x18000u     /* SRAM1 80K + SRAM2 16K; CCM alias above */
+#define FLASH_BASE_    0x08000000u
+#define FLASH_SIZE_    0x80000u
+
+#define MAX_PATTERNS   256
+#define MAX_LINE       1024
+
+static char *patterns[MAX_PATTERNS];
+static int n_patterns;
+
+/* Hot data: written or read on every HF tick */
+static const char *const hot_data[] = {
+  ".bss.FOCVars",
+  ".data.PIDIqHandle_M[12]",
+  ".data.PIDIdHandle_M[12]",
+  ".data.PIDSpeedHandle_M[12]",
+  ".data.STO_PLL_M[12]",
+  ".data.PWM_Handle_M[12]",
+  ".data.CircleLimitationM[12]",
+  ".data.RampExtMngrHFParamsM[12]",
+  ".data.SpeednTorqCtrlM[12]",
+  ".data.VirtualSpeedSensorM[12]",
+  ".data.BusVoltageSensor_M[12]",
+};
+#define N_HOT_DATA     (sizeof(hot_data) / sizeof(hot_data[0]))
+
+static const char *region(uint64_t addr)
+{
+  if ((addr >= CCM_BASE) && (addr < CCM_BASE + CCM_SIZE)) {
+    return "CCMSRAM";
+  }
+  if ((addr >= FLASH_BASE_) && (addr < FLASH_BASE_ + FLASH_SIZE_)) {
+    return "FLASH";
+  }
+  if ((addr >= SRAM_BASE) && (addr < SRAM_BASE + 0x14000u)) {
+    return "SRAM1";
+  }
+  if ((addr >= SRAM_BASE + 0x14000u) && (addr < SRAM_BASE + SRAM12_SIZE)) {
+    return "SRAM2";
+  }
+  if ((addr >= SRAM_BASE + SRAM12_SIZE) && (addr < SRAM_BASE + SRAM12_SIZE + CCM_SIZE)) {
+    return "CCM-alias";
+  }
+  return "?";
+}
+
+/* "*(.text.a .text.b*)" -> ".text.a", ".text.b*"; comments and other lines ignored */
+static int load_patterns(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  char line[MAX_LINE];
+  int in_comment = 0;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    char *p = line;
+    while ((*p == ' ') || (*p == '\t')) {
+      p++;
+    }
+    if (in_comment) {
+      if (strstr(p, "*/") != NULL) {
+        in_comment = 0;
+      }
+      continue;
+    }
+    if (strncmp(p, "/*", 2) == 0) {
+      in_comment = (strstr(p + 2, "*/") == NULL);
+      continue;
+    }
+    if (strncmp(p, "*(", 2) != 0) {
+      continue;
+    }
+    p += 2;
+    char *end = strchr(p, ')');
+    if (end == NULL) {
+      fprintf(stderr, "%s: unterminated pattern: %s", path, line);
+      fclose(f);
+      return -1;
+    }
+    *end = '\0';
+    for (char *tok = strtok(p, " \t"); tok != NULL; tok = strtok(NULL, " \t")) {
+      if (n_patterns == MAX_PATTERNS) {
+        fprintf(stderr, "%s: more than %d patterns\n", path, MAX_PATTERNS);
+        fclose(f);
+        return -1;
+      }
+      patterns[n_patterns++] = strdup(tok);
+    }
+  }
+  fclose(f);
+  return n_patterns;
+}
+
+static int is_hot(const char *name)
+{
+  for (int i = 0; i < n_patterns; i++) {
+    if (fnmatch(patterns[i], name, 0) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int is_hot_data(const char *name)
+{
+  for (size_t i = 0; i < N_HOT_DATA; i++) {
+    if (fnmatch(hot_data[i], name, 0) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* "0x08008e40 0x80 ./path/obj.o" -> address, size, object */
+static int parse_placement(const char *s, uint64_t *addr, uint64_t *size, char *obj, size_t obj_len)
+{
+  char o[MAX_LINE] = "";
+  if (sscanf(s, " %" SCNx64 " %" SCNx64 " %1023[^\r\n]", addr, size, o) < 2) {
+    return -1;
+  }
+  const char *base = strrchr(o, '/');
+  if (base == NULL) {
+    base = strrchr(o, '\\');
+  }
+  snprintf(obj, obj_len, "%s", (base != NULL) ? base + 1 : o);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s fmc.map ccm_hot.ld [--verbose]\n", argv[0]);
+    return 2;
+  }
+  const int verbose = (argc > 3) && (strcmp(argv[3], "--verbose") == 0);
+
+  if (load_patterns(argv[2]) <= 0) {
+    fprintf(stderr, "%s: no input section patterns\n", argv[2]);
+    return 2;
+  }
+
+  FILE *f = fopen(argv[1], "r");
+  if (f == NULL) {
+    perror(argv[1]);
+    return 2;
+  }
+
+  char line[MAX_LINE];
+  char name[MAX_LINE];
+  char obj[MAX_LINE];
+  int in_map = 0;
+  name[0] = '\0';
+  unsigned hot = 0, hot_bad = 0, data = 0, data_bad = 0;
+  uint64_t ccm_bytes = 0;
+
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (!in_map) {
+      in_map = (strncmp(line, "Linker script and memory map", 28) == 0);
+      continue;
+    }
+
+    const char *placement;
+    if (name[0] != '\0') {
+      /* Long section name: address/size/object on the following line */
+      placement = line;
+    } else if ((line[0] == ' ') && (line[1] == '.')) {
+      /* " .text.foo  0x... 0x... obj" or " .text.foo_with_a_long_name" */
+      if (sscanf(line + 1, "%1023s", name) != 1) {
+        continue;
+      }
+      placement = line + 1 + strlen(name);
+      if (strspn(placement, " \t\r\n") == strlen(placement)) {
+        continue;
+      }
+    } else {
+      continue;
+    }
+
+    uint64_t addr, size;
+    if (parse_placement(placement, &addr, &size, obj, sizeof(obj)) < 0) {
+      name[0] = '\0';
+      continue;
+    }
+    if (size != 0u) {
+      if (is_hot(name)) {
+        const int ok = (addr >= CCM_BASE) && (addr + size <= CCM_BASE + CCM_SIZE);
+        hot++;
+        if (ok) {
+          ccm_bytes += size;
+        } else {
+          hot_bad++;
+        }
+        if (!ok || verbose) {
+          printf("%s %-40s 0x%08llx %6llu %-9s %s\n", ok ? "ok  " : "FAIL", name,
+                 (unsigned long long)addr, (unsigned long long)size, region(addr), obj);
+        }
+      } else if (is_hot_data(name)) {
+        const int ok = (addr >= SRAM_BASE) && (addr + size <= SRAM_BASE + SRAM12_SIZE);
+        data++;
+        if (!ok) {
+          data_bad++;
+        }
+        if (!ok || verbose) {
+          printf("%s %-40s 0x%08llx %6llu %-9s %s\n", ok ? "ok  " : "FAIL", name,
+                 (unsigned long long)addr, (unsigned long long)size, region(addr), obj);
+        }
+      }
+    }
+    name[0] = '\0';
+  }
+  fclose(f);
+
+  if (!in_map) {
+    fprintf(stderr, "%s: no \"Linker script and memory map\" part\n", argv[1]);
+    return 2;
+  }
+  if (hot == 0u) {
+    fprintf(stderr, "%s: no input section matches %s (built without -ffunction-sections?)\n",
+            argv[1], argv[2]);
+    return 2;
+  }
+
+  printf("hot code: %u sections, %u outside CCM SRAM, %llu bytes in CCM SRAM\n", hot, hot_bad,
+         (unsigned long long)ccm_bytes);
+  printf("hot data: %u sections, %u outside SRAM1/SRAM2\n", data, data_bad);
+  return ((hot_bad != 0u) || (data_bad != 0u)) ? 1 : 0;
+}
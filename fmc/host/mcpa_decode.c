@@ -0,0 +1,90 @@
+/* Reference decoder for MCPA async buffers, see mcpa_decode.h. */
+#include "mcpa_decode.h"
+
+#include <string.h>
+
+#define ASYNC_RAW    0u
+#define ASYNC_DELTA  1u
+
+static int read_mf(const mcpa_layout_t *lay, const uint8_t *buf, size_t end, size_t *pos,
+                   uint32_t *mf_out, size_t mf_cap, mcpa_buffer_info_t *info)
+{
+  if ((size_t)(info->n_mf + 1u) * lay->mf_num > mf_cap) return -1;
+  for (unsigned i = 0; i < lay->mf_num; i++) {
+    uint32_t v = 0;
+    if (*pos + lay->mf_size[i] > end) return -1;
+    memcpy(&v, &buf[*pos], lay->mf_size[i]);
+    *pos += lay->mf_size[i];
+    mf_out[info->n_mf * lay->mf_num + i] = v;
+  }
+  info->n_mf++;
+  return 0;
+}
+
+int mcpa_decode(const mcpa_layout_t *lay, const uint8_t *buf, size_t len,
+                uint16_t *hf_out, size_t hf_cap, uint32_t *mf_out, size_t mf_cap,
+                mcpa_buffer_info_t *info)
+{
+  memset(info, 0, sizeof(*info));
+  if ((len < 6u) || (lay->hf_num + lay->mf_num > MCPA_DECODE_MAX_CH)) return -1;
+
+  memcpy(&info->timestamp, buf, 4);
+  info->mark = buf[len - 2u];
+  info->async_id = buf[len - 1u];
+  if (info->async_id > ASYNC_DELTA) return -1;
+
+  size_t mf_block = 0;
+  if (lay->mf_rate == 254u) {
+    for (unsigned i = 0; i < lay->mf_num; i++) mf_block += lay->mf_size[i];
+  }
+  if (len < 6u + mf_block) return -1;
+  size_t end = len - 2u - mf_block;    /* end of the sample area */
+  size_t pos = 4;
+  unsigned mf_index = 0;
+  uint16_t prev[MCPA_DECODE_MAX_CH];
+  uint16_t prev2[MCPA_DECODE_MAX_CH];
+
+  while (pos < end) {
+    if ((size_t)(info->n_samples + 1u) * lay->hf_num > hf_cap) return -1;
+    uint16_t *out = &hf_out[info->n_samples * lay->hf_num];
+
+    for (unsigned i = 0; i < lay->hf_num; i++) {
+      if ((info->async_id == ASYNC_RAW) || (info->n_samples == 0u)) {
+        if (pos + 2u > end) return -1;
+        out[i] = (uint16_t)(buf[pos] | (buf[pos + 1u] << 8));
+        pos += 2u;
+      } else {
+        uint32_t z = 0;
+        unsigned shift = 0;
+        uint8_t b;
+        do {
+          if ((pos >= end) || (shift > 14u)) return -1;
+          b = buf[pos++];
+          z |= (uint32_t)(b & 0x7Fu) << shift;
+          shift += 7u;
+        } while (b & 0x80u);
+        int32_t delta = (z & 1u) ? -(int32_t)((z + 1u) >> 1) : (int32_t)(z >> 1);
+        uint16_t predict = (info->n_samples == 1u) ? prev[i] : (uint16_t)(2u * prev[i] - prev2[i]);
+        out[i] = (uint16_t)(predict + (uint16_t)delta);
+      }
+      prev2[i] = prev[i];
+      prev[i] = out[i];
+    }
+    info->n_samples++;
+
+    if (lay->mf_rate < 254u) {
+      if (mf_index == lay->mf_rate) {
+        mf_index = 0;
+        if (read_mf(lay, buf, end, &pos, mf_out, mf_cap, info) != 0) return -1;
+      } else {
+        mf_index++;
+      }
+    }
+  }
+  if (pos != end) return -1;
+
+  if (mf_block != 0u) {
+    if (read_mf(lay, buf, len - 2u, &pos, mf_out, mf_cap, info) != 0) return -1;
+  }
+  return 0;
+}
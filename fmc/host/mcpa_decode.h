@@ -0,0 +1,43 @@
+/* Reference decoder for MCPA async buffers (raw and MCTL_ASYNC_DELTA).
+ *
+ * A buffer is the ASPEP async payload produced by MCPA_dataLog():
+ *   timestamp (u32) | samples ... | [MF block when mf_rate == 254] | MARK | ASYNCID
+ * Each sample is hf_num HF values followed, every (mf_rate + 1) samples, by the
+ * MF values (mf_rate < 254). ASYNCID 0 stores HF values as raw u16; ASYNCID 1
+ * stores the first sample raw and the others as zig-zag varint residuals of a
+ * per-channel prediction: x[n-1] for the second sample, 2*x[n-1] - x[n-2] after.
+ *
+ * The layout comes from the datalog configuration the controller sent
+ * (MCPA_cfgLog); it is not repeated in the buffers.
+ */
+#ifndef MCPA_DECODE_H
+#define MCPA_DECODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MCPA_DECODE_MAX_CH 16
+
+typedef struct {
+  uint8_t hf_num;
+  uint8_t mf_num;
+  uint8_t mf_size[MCPA_DECODE_MAX_CH];   /* bytes per MF value (1, 2 or 4) */
+  uint8_t mf_rate;                       /* 0..253, 254 once per buffer, 255 never */
+} mcpa_layout_t;
+
+typedef struct {
+  uint32_t timestamp;
+  uint8_t mark;
+  uint8_t async_id;
+  uint32_t n_samples;                    /* HF samples decoded */
+  uint32_t n_mf;                         /* MF records decoded */
+} mcpa_buffer_info_t;
+
+/* Decodes one buffer. hf_out receives n_samples * hf_num values (sample major),
+ * mf_out receives n_mf * mf_num values. Returns 0, or -1 on a malformed buffer
+ * or when an output array is too small. */
+int mcpa_decode(const mcpa_layout_t *lay, const uint8_t *buf, size_t len,
+                uint16_t *hf_out, size_t hf_cap, uint32_t *mf_out, size_t mf_cap,
+                mcpa_buffer_info_t *info);
+
+#endif /* MCPA_DECODE_H */
@@ -0,0 +1,376 @@
+/* obs_replay: feed captured observer inputs into speed/position observers.
+ *
+ *   obs_replay TRACE [--obs sto_pll,sto_cordic] [--thr DEG] [--hold MS]
+ *              [--hz N] [--cr-accel DPP] [--csv FILE] [--check]
+ *
+ * TRACE is a binary trace (fmc_sim --capture) or a serial capture holding the
+ * firmware's "#O:" lines (CLI "cap start"), see obs_trace.h. Every record is
+ * one FOC_HighFrequencyTask tick and is replayed the way the firmware calls
+ * the observer: CalcElAngle when OBS_CAP_F_RUN, CalcAvrgElSpeedDpp, then the
+ * PLL reset when OBS_CAP_F_RESET. Entering START clears the observer
+ * (STO_PLL_Clear in TSK_MediumFrequencyTaskM1), and so does a gap in the
+ * trace. Observers use the motor constants of Inc/ (mc_config.c for STO_PLL).
+ *
+ * Per observer it reports:
+ *   - angle error against ref_angle over the RUN records (mean, rms, max);
+ *     ref_angle is FOCVars.hElAngle, or the encoder / plant angle when the
+ *     trace says so (OBS_CAP_F_REF_EXT)
+ *   - convergence time: from START (or segment start) until |error| stays
+ *     below --thr for --hold ms
+ *   - host cost per CalcElAngle call (TSC ticks on x86, ns elsewhere); on the
+ *     target "hfprof" gives the sto_pll cycles
+ *   - for the observer the firmware ran (sto_pll), the ticks whose replayed
+ *     angle differs from the captured obs_angle. Zero when the trace starts
+ *     before the motor start; otherwise the replay starts cold and differs
+ *     until it has converged.
+ *
+ * --check exits 1 unless the live observer replays bit-exact and every
+ * observer converges in every segment that reaches RUN.
+ *
+ * A new observer is one more entry in observers[].
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "mc_type.h"
+#include "mc_config.h"
+#include "parameters_conversion.h"
+#include "sto_cordic_speed_pos_fdbk.h"
+#include "obs_trace.h"
+
+/* --- observers ------------------------------------------------------------ */
+
+typedef struct {
+  const char *name;
+  int live;                                 /* run by the firmware: obs_angle is its output */
+  void (*init)(void);
+  void (*clear)(void);
+  void (*set_dir)(int8_t dir);              /* NULL: no forced direction */
+  int16_t (*calc)(Observer_Inputs_t *in);
+  void (*avrg)(void);
+  void (*reset_pll)(void);                  /* NULL: nothing to reset */
+  int16_t (*angle)(void);                   /* what SPD_GetElAngle returns after the tick */
+} observer_t;
+
+static STO_PLL_Handle_t pll;
+
+static void pll_init(void)
+{
+  pll = STO_PLL_M1;                         /* configuration from mc_config.c, never run */
+  STO_PLL_Init(&pll);
+}
+static void pll_clear(void) { STO_PLL_Clear(&pll); }
+static void pll_set_dir(int8_t dir) { pll.hForcedDirection = dir; }
+static int16_t pll_calc(Observer_Inputs_t *in) { return STO_PLL_CalcElAngle(&pll, in); }
+static void pll_avrg(void) { STO_PLL_CalcAvrgElSpeedDpp(&pll); }
+static void pll_reset(void) { STO_ResetPLL(&pll); }
+static int16_t pll_angle(void) { return SPD_GetElAngle(&pll._Super); }
+
+/* STO + CORDIC is not generated for this board: same observer constants as
+ * STO_PLL, the PLL replaced by the CORDIC phase of the estimated B-emf */
+static STO_CR_Handle_t cr;
+static int16_t cr_accel;                    /* MaxInstantElAcceleration, dpp per tick */
+
+static void cr_init(void)
+{
+  memset(&cr, 0, sizeof(cr));
+  cr._Super = STO_PLL_M1._Super;
+  cr.hC1 = (int16_t)C1;
+  cr.hC2 = (int16_t)C2;
+  cr.hC3 = (int16_t)C3;
+  cr.hC4 = (int16_t)C4;
+  cr.hC5 = (int16_t)C5;
+  cr.hF1 = (int16_t)F1;
+  cr.hF2 = (int16_t)F2;
+  cr.SpeedBufferSizeUnit = STO_FIFO_DEPTH_UNIT;
+  cr.SpeedBufferSizedpp = STO_FIFO_DEPTH_DPP;
+  cr.VariancePercentage = PERCENTAGE_FACTOR;
+  cr.SpeedValidationBand_H = SPEED_BAND_UPPER_LIMIT;
+  cr.SpeedValidationBand_L = SPEED_BAND_LOWER_LIMIT;
+  cr.MinStartUpValidSpeed = OBS_MINIMUM_SPEED_UNIT;
+  cr.StartUpConsistThreshold = NB_CONSECUTIVE_TESTS;
+  cr.MaxInstantElAcceleration = cr_accel;
+  cr.BemfConsistencyCheck = M1_BEMF_CONSISTENCY_TOL;
+  cr.BemfConsistencyGain = M1_BEMF_CONSISTENCY_GAIN;
+  cr.MaxAppPositiveMecSpeedUnit = (uint16_t)(MAX_APPLICATION_SPEED_UNIT * 1.15);
+  cr.F1LOG = F1_LOG;
+  cr.F2LOG = F2_LOG;
+  cr.SpeedBufferSizedppLOG = STO_FIFO_DEPTH_DPP_LOG;
+  STO_CR_Init(&cr);
+}
+static void cr_clear(void) { STO_CR_Clear(&cr); }
+static int16_t cr_calc(Observer_Inputs_t *in) { return STO_CR_CalcElAngle(&cr, in); }
+static void cr_avrg(void) { STO_CR_CalcAvrgElSpeedDpp(&cr); }
+static int16_t cr_angle(void) { return SPD_GetElAngle(&cr._Super); }
+
+static const observer_t observers[] = {
+  { "sto_pll",    1, pll_init, pll_clear, pll_set_dir, pll_calc, pll_avrg, pll_reset, pll_angle },
+  { "sto_cordic", 0, cr_init,  cr_clear,  NULL,        cr_calc,  cr_avrg,  NULL,      cr_angle },
+};
+#define N_OBSERVERS (sizeof(observers) / sizeof(observers[0]))
+
+/* --- timing --------------------------------------------------------------- */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define COST_UNIT "tsc"
+static inline uint64_t cost_now(void) { return __rdtsc(); }
+#else
+#define COST_UNIT "ns"
+static inline uint64_t cost_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+/* --- replay --------------------------------------------------------------- */
+
+typedef struct {
+  uint64_t calls;
+  uint64_t cost;
+  uint64_t mismatches;
+  uint64_t run_n;
+  double err_abs;
+  double err_sq;
+  double err_max;
+  uint32_t segments;                        /* segments that reached RUN */
+  uint32_t converged;
+  double conv_sum_ms;
+  double conv_max_ms;
+} result_t;
+
+static struct {
+  const char *trace;
+  const char *csv;
+  const char *only;
+  uint32_t hz;
+  double thr_deg;
+  double hold_ms;
+  int check;
+} opt;
+
+static double err_deg(int16_t a, int16_t ref)
+{
+  return (double)(int16_t)(a - ref) * (360.0 / 65536.0);
+}
+
+/* Closes the bookkeeping of one segment */
+static void segment_end(result_t *r, int reached_run, int conv_k, uint32_t seg_k, uint32_t hz)
+{
+  if (!reached_run) return;
+  r->segments++;
+  if (conv_k >= 0) {
+    double ms = (double)((uint32_t)conv_k - seg_k) * 1000.0 / hz;
+    r->converged++;
+    r->conv_sum_ms += ms;
+    if (ms > r->conv_max_ms) r->conv_max_ms = ms;
+  }
+}
+
+static void replay(const observer_t *o, const obs_trace_t *t, int16_t *angle_out, result_t *r)
+{
+  const uint32_t hold_n = (uint32_t)ceil(opt.hold_ms * t->hz / 1000.0);
+  uint8_t prev_state = 0xFFu;
+  uint32_t seg_k = 0;                       /* segment start (or START entry) */
+  uint32_t in_band_k = 0;                   /* first tick of the current |e| < thr run */
+  int in_band = 0;
+  int conv_k = -1;
+  int reached_run = 0;
+
+  memset(r, 0, sizeof(*r));
+  o->init();
+
+  for (uint32_t k = 0; k < t->n; k++) {
+    const obs_cap_rec_t *rec = &t->rec[k];
+    const int gap = (k == 0u) || ((rec->flags & OBS_CAP_F_GAP) != 0u);
+    const int start = (rec->state == (uint8_t)START) && (prev_state != (uint8_t)START);
+
+    if (gap || start) {
+      if (k != 0u) segment_end(r, reached_run, conv_k, seg_k, t->hz);
+      if (k != 0u) o->clear();
+      seg_k = k;
+      in_band = 0;
+      conv_k = -1;
+      reached_run = 0;
+    }
+    prev_state = rec->state;
+
+    if (o->set_dir != NULL) {
+      int8_t dir = 0;
+      if ((rec->flags & OBS_CAP_F_DIR_SET) != 0u) dir = ((rec->flags & OBS_CAP_F_DIR_NEG) != 0u) ? -1 : 1;
+      o->set_dir(dir);
+    }
+
+    if ((rec->flags & OBS_CAP_F_RUN) != 0u) {
+      Observer_Inputs_t in;
+      in.Ialfa_beta.alpha = rec->i_alpha;
+      in.Ialfa_beta.beta = rec->i_beta;
+      in.Valfa_beta.alpha = rec->v_alpha;
+      in.Valfa_beta.beta = rec->v_beta;
+      in.Vbus = rec->vbus;
+      uint64_t c0 = cost_now();
+      (void)o->calc(&in);
+      uint64_t c = cost_now() - c0;
+      r->calls++;
+      r->cost += c;
+    }
+    o->avrg();
+    if (((rec->flags & OBS_CAP_F_RESET) != 0u) && (o->reset_pll != NULL)) o->reset_pll();
+
+    const int16_t angle = o->angle();
+    angle_out[k] = angle;
+    if (o->live && (angle != rec->obs_angle)) r->mismatches++;
+
+    const double e = err_deg(angle, rec->ref_angle);
+    if (rec->state == (uint8_t)RUN) {
+      reached_run = 1;
+      r->run_n++;
+      r->err_abs += fabs(e);
+      r->err_sq += e * e;
+      if (fabs(e) > r->err_max) r->err_max = fabs(e);
+    }
+    if (fabs(e) < opt.thr_deg) {
+      if (!in_band) {
+        in_band = 1;
+        in_band_k = k;
+      }
+      if ((conv_k < 0) && ((k - in_band_k + 1u) >= hold_n)) conv_k = (int)in_band_k;
+    } else {
+      in_band = 0;
+    }
+  }
+  segment_end(r, reached_run, conv_k, seg_k, t->hz);
+}
+
+static void usage(const char *argv0)
+{
+  fprintf(stderr,
+          "usage: %s TRACE [--obs name,...] [--thr DEG] [--hold MS] [--hz N]\n"
+          "       [--cr-accel DPP] [--csv FILE] [--check]\n"
+          "observers:", argv0);
+  for (size_t i = 0; i < N_OBSERVERS; i++) fprintf(stderr, " %s", observers[i].name);
+  fprintf(stderr, "\n");
+}
+
+static int selected(const char *name)
+{
+  if (opt.only == NULL) return 1;
+  size_t n = strlen(name);
+  for (const char *p = opt.only; (p = strstr(p, name)) != NULL; p += n) {
+    if (((p == opt.only) || (p[-1] == ',')) && ((p[n] == '\0') || (p[n] == ','))) return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  /* a tenth of the top speed change per tick, in electrical dpp */
+  const double max_dpp = (double)MAX_APPLICATION_SPEED_RPM / 60.0 * POLE_PAIR_NUM * 65536.0 / TF_REGULATION_RATE;
+  cr_accel = (int16_t)(max_dpp / 10.0 + 1.0);
+  opt.hz = TF_REGULATION_RATE;
+  opt.thr_deg = 10.0;
+  opt.hold_ms = 20.0;
+
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (!strcmp(a, "--obs") && v) { opt.only = v; i++; }
+    else if (!strcmp(a, "--thr") && v) { opt.thr_deg = atof(v); i++; }
+    else if (!strcmp(a, "--hold") && v) { opt.hold_ms = atof(v); i++; }
+    else if (!strcmp(a, "--hz") && v) { opt.hz = (uint32_t)atoi(v); i++; }
+    else if (!strcmp(a, "--cr-accel") && v) { cr_accel = (int16_t)atoi(v); i++; }
+    else if (!strcmp(a, "--csv") && v) { opt.csv = v; i++; }
+    else if (!strcmp(a, "--check")) { opt.check = 1; }
+    else if ((a[0] != '-') && (opt.trace == NULL)) { opt.trace = a; }
+    else { usage(argv[0]); return 2; }
+  }
+  if (opt.trace == NULL) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  obs_trace_t t;
+  if (obs_trace_load(opt.trace, opt.hz, &t) != 0) return 2;
+
+  uint32_t run_n = 0, gaps = 0;
+  int ext_ref = 0;
+  for (uint32_t k = 0; k < t.n; k++) {
+    if (t.rec[k].state == (uint8_t)RUN) run_n++;
+    if ((k != 0u) && ((t.rec[k].flags & OBS_CAP_F_GAP) != 0u)) gaps++;
+    if ((t.rec[k].flags & OBS_CAP_F_REF_EXT) != 0u) ext_ref = 1;
+  }
+  printf("trace      %s: %u records (%.3f s at %u Hz), %u in RUN, %u gaps\n", opt.trace, t.n,
+         (double)t.n / t.hz, t.hz, run_n, gaps);
+  printf("reference  %s\n", ext_ref ? "external angle (encoder / plant)" : "FOCVars.hElAngle");
+
+  int16_t *angles[N_OBSERVERS] = { 0 };
+  result_t res[N_OBSERVERS];
+  int fail = 0;
+
+  printf("\n%-11s %7s %7s %7s %9s %11s %9s %8s %8s\n", "observer", "mean|e|", "rms", "max|e|",
+         "converged", "conv ms avg", "conv max", COST_UNIT "/call", "vs live");
+  for (size_t i = 0; i < N_OBSERVERS; i++) {
+    const observer_t *o = &observers[i];
+    if (!selected(o->name)) continue;
+    angles[i] = malloc((size_t)t.n * sizeof(int16_t));
+    if (angles[i] == NULL) {
+      fprintf(stderr, "out of memory\n");
+      return 2;
+    }
+    result_t *r = &res[i];
+    replay(o, &t, angles[i], r);
+
+    char live[16] = "-";
+    if (o->live) snprintf(live, sizeof(live), "%llu", (unsigned long long)r->mismatches);
+    printf("%-11s %7.2f %7.2f %7.2f %4u/%-4u %11.1f %9.1f %8.1f %8s\n", o->name,
+           (r->run_n != 0u) ? (r->err_abs / r->run_n) : 0.0,
+           (r->run_n != 0u) ? sqrt(r->err_sq / r->run_n) : 0.0, r->err_max,
+           r->converged, r->segments,
+           (r->converged != 0u) ? (r->conv_sum_ms / r->converged) : 0.0, r->conv_max_ms,
+           (r->calls != 0u) ? ((double)r->cost / r->calls) : 0.0, live);
+
+    if (o->live && (r->mismatches != 0u)) fail = 1;
+    if (r->converged != r->segments) fail = 1;
+  }
+  printf("\nerrors in electrical degrees over RUN; converged: |e| < %.1f deg for %.0f ms\n",
+         opt.thr_deg, opt.hold_ms);
+
+  if (opt.csv != NULL) {
+    FILE *f = fopen(opt.csv, "w");
+    if (f == NULL) {
+      perror(opt.csv);
+      return 2;
+    }
+    fprintf(f, "k,t,state,flags,ref,live");
+    for (size_t i = 0; i < N_OBSERVERS; i++) {
+      if (angles[i] != NULL) fprintf(f, ",%s,%s_err_deg", observers[i].name, observers[i].name);
+    }
+    fprintf(f, "\n");
+    for (uint32_t k = 0; k < t.n; k++) {
+      const obs_cap_rec_t *rec = &t.rec[k];
+      fprintf(f, "%u,%.6f,%u,0x%02x,%d,%d", k, (double)k / t.hz, rec->state, rec->flags,
+              rec->ref_angle, rec->obs_angle);
+      for (size_t i = 0; i < N_OBSERVERS; i++) {
+        if (angles[i] != NULL) fprintf(f, ",%d,%.2f", angles[i][k], err_deg(angles[i][k], rec->ref_angle));
+      }
+      fprintf(f, "\n");
+    }
+    fclose(f);
+  }
+
+  for (size_t i = 0; i < N_OBSERVERS; i++) free(angles[i]);
+  obs_trace_free(&t);
+
+  if (opt.check && fail) {
+    printf("FAIL: live observer not bit-exact or an observer did not converge\n");
+    return 1;
+  }
+  return 0;
+}
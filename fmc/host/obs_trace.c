@@ -0,0 +1,137 @@
+/* Observer input traces, see obs_trace.h */
+#include <stdlib.h>
+#include <string.h>
+
+#include "obs_trace.h"
+
+_Static_assert(sizeof(obs_cap_rec_t) == 16, "obs_cap_rec_t is the 16-byte trace record");
+
+static const char magic[4] = { 'O', 'C', 'A', 'P' };
+
+int obs_trace_write_header(FILE *f, uint32_t hz)
+{
+  uint8_t h[16] = { 0 };
+  memcpy(h, magic, 4);
+  h[4] = (uint8_t)OBS_TRACE_VERSION;
+  h[6] = (uint8_t)sizeof(obs_cap_rec_t);
+  memcpy(&h[8], &hz, 4);
+  return (fwrite(h, 1, sizeof(h), f) == sizeof(h)) ? 0 : -1;
+}
+
+static int push(obs_trace_t *t, uint32_t *cap, const obs_cap_rec_t *r)
+{
+  if (t->n == *cap) {
+    uint32_t c = (*cap != 0u) ? (*cap * 2u) : 4096u;
+    obs_cap_rec_t *p = realloc(t->rec, (size_t)c * sizeof(*p));
+    if (p == NULL) return -1;
+    t->rec = p;
+    *cap = c;
+  }
+  t->rec[t->n++] = *r;
+  return 0;
+}
+
+static int hexval(char c)
+{
+  if ((c >= '0') && (c <= '9')) return c - '0';
+  if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+  if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+  return -1;
+}
+
+static int load_text(FILE *f, const char *path, uint32_t default_hz, obs_trace_t *t)
+{
+  char line[512];
+  uint32_t cap = 0;
+  uint32_t bad = 0;
+  int new_segment = 0;
+
+  t->hz = default_hz;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    const char *p = strstr(line, "#OS:");
+    if (p != NULL) {
+      t->hz = (uint32_t)strtoul(p + 4, NULL, 10);
+      new_segment = 1;
+      continue;
+    }
+    p = strstr(line, "#O:");
+    if (p == NULL) continue;
+    p += 3;
+
+    obs_cap_rec_t r;
+    uint8_t *b = (uint8_t *)&r;
+    size_t i;
+    for (i = 0; i < sizeof(r); i++) {
+      int hi = hexval(p[2 * i]);
+      int lo = (hi < 0) ? -1 : hexval(p[2 * i + 1]);
+      if (lo < 0) break;
+      b[i] = (uint8_t)((hi << 4) | lo);
+    }
+    if (i != sizeof(r)) {
+      bad++;                                /* line cut by a UART overrun */
+      new_segment = 1;
+      continue;
+    }
+    if (new_segment) {
+      r.flags |= OBS_CAP_F_GAP;
+      new_segment = 0;
+    }
+    if (push(t, &cap, &r) != 0) {
+      fprintf(stderr, "%s: out of memory\n", path);
+      return -1;
+    }
+  }
+  if (bad != 0u) {
+    fprintf(stderr, "%s: %u malformed #O: lines skipped\n", path, bad);
+  }
+  return 0;
+}
+
+int obs_trace_load(const char *path, uint32_t default_hz, obs_trace_t *t)
+{
+  memset(t, 0, sizeof(*t));
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+
+  uint8_t h[16];
+  int rc = 0;
+  if ((fread(h, 1, sizeof(h), f) == sizeof(h)) && (memcmp(h, magic, 4) == 0)) {
+    uint16_t ver = (uint16_t)(h[4] | (h[5] << 8));
+    uint16_t rsz = (uint16_t)(h[6] | (h[7] << 8));
+    if ((ver != OBS_TRACE_VERSION) || (rsz != sizeof(obs_cap_rec_t))) {
+      fprintf(stderr, "%s: trace version %u / record size %u not supported\n", path, ver, rsz);
+      rc = -1;
+    } else {
+      memcpy(&t->hz, &h[8], 4);
+      uint32_t cap = 0;
+      obs_cap_rec_t r;
+      while (fread(&r, sizeof(r), 1, f) == 1) {
+        if (push(t, &cap, &r) != 0) {
+          fprintf(stderr, "%s: out of memory\n", path);
+          rc = -1;
+          break;
+        }
+      }
+    }
+  } else {
+    rewind(f);
+    rc = load_text(f, path, default_hz, t);
+  }
+  fclose(f);
+  if ((rc == 0) && (t->n == 0u)) {
+    fprintf(stderr, "%s: no records\n", path);
+    rc = -1;
+  }
+  if (rc != 0) obs_trace_free(t);
+  return rc;
+}
+
+void obs_trace_free(obs_trace_t *t)
+{
+  free(t->rec);
+  t->rec = NULL;
+  t->n = 0;
+}
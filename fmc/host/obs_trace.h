@@ -0,0 +1,37 @@
+/* Observer input traces (plat/obs_cap.h records) on the host.
+ *
+ * Two sources:
+ *   - binary trace file: 16-byte header then obs_cap_rec_t records as stored
+ *     by the firmware (little endian). fmc_sim --capture writes these.
+ *       magic "OCAP" | u16 version | u16 record size | u32 HF rate [Hz] | u32 0
+ *   - serial capture text: "#O:<32 hex digits>" per record, "#OS:<hz>" at each
+ *     "cap start". Other lines (CLI echo, logs) are skipped.
+ *
+ * A new capture ("#OS:") starts a new segment: its first record gets
+ * OBS_CAP_F_GAP, the same flag the firmware sets after dropped records.
+ */
+#ifndef OBS_TRACE_H
+#define OBS_TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "obs_cap.h"
+
+#define OBS_TRACE_VERSION 1u
+
+typedef struct {
+  uint32_t hz;               /* HF (observer) rate */
+  uint32_t n;
+  obs_cap_rec_t *rec;
+} obs_trace_t;
+
+/* Binary header; records follow with fwrite(rec, sizeof(obs_cap_rec_t), n, f) */
+int obs_trace_write_header(FILE *f, uint32_t hz);
+
+/* Loads either format. default_hz is used for text captures without "#OS:".
+ * Returns 0, or -1 (message on stderr). */
+int obs_trace_load(const char *path, uint32_t default_hz, obs_trace_t *t);
+void obs_trace_free(obs_trace_t *t);
+
+#endif /* OBS_TRACE_H */
@@ -0,0 +1,125 @@
+/*
+ * pmsm_plant.c
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ */
+#include <math.h>
+#include "main.h"
+#include "parameters_conversion.h"
+#include "pmsm_plant.h"
+
+#define TWO_PI      6.283185307179586
+#define SQRT3       1.7320508075688772
+
+void pmsm_default_params(pmsm_params_t *p)
+{
+    /* Ke：V_rms(线) / kRPM → 相峰值 / (电 rad/s) */
+    const double ke_ll_rms = MOTOR_VOLTAGE_CONSTANT / 1000.0;
+    const double w_per_rpm = (TWO_PI / 60.0) * POLE_PAIR_NUM;
+
+    p->rs           = RS;
+    p->ls           = LS;
+    p->psi          = ke_ll_rms * sqrt(2.0) / SQRT3 / w_per_rpm;
+    p->pole_pairs   = POLE_PAIR_NUM;
+    p->j            = 2.0e-5;
+    p->b            = 2.0e-5;
+    p->t_load       = 0.0;
+    p->vbus         = NOMINAL_BUS_VOLTAGE_V;
+    p->dead_time_s  = HW_DEAD_TIME_NS * 1.0e-9;
+    p->pwm_period_s = 1.0 / (double)PWM_FREQUENCY;
+    p->substeps     = 8u;
+}
+
+void pmsm_reset(pmsm_state_t *s)
+{
+    s->id = 0.0;
+    s->iq = 0.0;
+    s->wm = 0.0;
+    s->theta = 0.0;
+    s->te = 0.0;
+    s->i_abc[0] = s->i_abc[1] = s->i_abc[2] = 0.0;
+    s->t = 0.0;
+}
+
+static void dq_to_abc(double id, double iq, double c, double sn, double i_abc[3])
+{
+    const double ialpha = (id * c) - (iq * sn);
+    const double ibeta  = (id * sn) + (iq * c);
+
+    i_abc[0] = ialpha;
+    i_abc[1] = (-0.5 * ialpha) + ((SQRT3 / 2.0) * ibeta);
+    i_abc[2] = -i_abc[0] - i_abc[1];
+}
+
+void pmsm_step(const pmsm_params_t *p, pmsm_state_t *s, const double duty[3], bool bridge_on)
+{
+    const double dt = p->pwm_period_s / (double)p->substeps;
+    const double dt_ratio = p->dead_time_s / p->pwm_period_s;
+    /* 周期起点精确求一次 sin/cos，子步内用小角度旋转递推，周期末再按 theta 重新对齐 */
+    double c = cos(s->theta);
+    double sn = sin(s->theta);
+
+    for (uint32_t k = 0u; k < p->substeps; k++)
+    {
+        const double we = s->wm * p->pole_pairs;
+
+        if (bridge_on)
+        {
+            double v[3];
+            for (int i = 0; i < 3; i++)
+            {
+                /* 平均值模型 + 死区：死区期间端电压由续流二极管决定，误差 ∝ sign(i) */
+                const double dterr = (s->i_abc[i] > 0.0) ? dt_ratio : ((s->i_abc[i] < 0.0) ? -dt_ratio : 0.0);
+                double d = duty[i] - dterr;
+                if (d < 0.0) { d = 0.0; }
+                if (d > 1.0) { d = 1.0; }
+                v[i] = d * p->vbus;
+            }
+            const double valpha = ((2.0 * v[0]) - v[1] - v[2]) / 3.0;
+            const double vbeta  = (v[1] - v[2]) / SQRT3;
+            const double vd = ( valpha * c) + (vbeta * sn);
+            const double vq = (-valpha * sn) + (vbeta * c);
+
+            const double did = (vd - (p->rs * s->id) + (we * p->ls * s->iq)) / p->ls;
+            const double diq = (vq - (p->rs * s->iq) - (we * p->ls * s->id) - (we * p->psi)) / p->ls;
+            s->id += did * dt;
+            s->iq += diq * dt;
+        }
+        else
+        {
+            /* 桥臂全关：母线电压高于反电动势时二极管很快把电流续流到零 */
+            s->id = 0.0;
+            s->iq = 0.0;
+        }
+
+        s->te = 1.5 * p->pole_pairs * p->psi * s->iq;
+        double dwm = (s->te - (p->b * s->wm)) / p->j;
+        if (s->wm > 0.0)      { dwm -= p->t_load / p->j; }
+        else if (s->wm < 0.0) { dwm += p->t_load / p->j; }
+        s->wm += dwm * dt;
+
+        const double dth = s->wm * p->pole_pairs * dt;
+        const double cd = 1.0 - (0.5 * dth * dth);
+        const double c_next = (c * cd) - (sn * dth);
+        sn = (sn * cd) + (c * dth);
+        c = c_next;
+        s->theta += dth;
+        dq_to_abc(s->id, s->iq, c, sn, s->i_abc);
+    }
+    s->theta = fmod(s->theta, TWO_PI);
+    if (s->theta < 0.0) { s->theta += TWO_PI; }
+    s->t += p->pwm_period_s;
+}
+
+int16_t pmsm_el_angle_s16(const pmsm_state_t *s)
+{
+    double a = s->theta + (TWO_PI / 4.0);
+    return (int16_t)(int32_t)lrint(fmod(a, TWO_PI) * (65536.0 / TWO_PI));
+}
+
+double pmsm_speed_rpm(const pmsm_params_t *p, const pmsm_state_t *s)
+{
+    (void)p;
+    return s->wm * 60.0 / TWO_PI;
+}
@@ -0,0 +1,52 @@
+/*
+ * pmsm_plant.h
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  表贴式 PMSM + 两电平逆变器的离散模型（dq 坐标，标准右手系）。
+ *  默认参数取自 pmsm_motor_parameters.h / power_stage_parameters.h / drive_parameters.h，
+ *  机械参数（J、B、负载）固件里没有，给出一组小云台电机的典型值。
+ */
+#ifndef PMSM_PLANT_H_
+#define PMSM_PLANT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+    double rs;              /* Ω                        */
+    double ls;              /* H  (Ld = Lq)             */
+    double psi;             /* Wb，电角速度下的永磁磁链 */
+    double pole_pairs;
+    double j;               /* kg·m²                    */
+    double b;               /* N·m·s/rad 粘滞摩擦       */
+    double t_load;          /* N·m 恒定负载             */
+    double vbus;            /* V                        */
+    double dead_time_s;     /* 死区，按电流方向折算电压误差 */
+    double pwm_period_s;
+    uint32_t substeps;      /* 每个 PWM 周期的积分步数  */
+} pmsm_params_t;
+
+typedef struct
+{
+    double id, iq;          /* A                        */
+    double wm;              /* 机械角速度 rad/s         */
+    double theta;           /* d 轴电角度 rad, [0, 2π)  */
+    double te;              /* 电磁转矩 N·m             */
+    double i_abc[3];        /* 三相电流 A               */
+    double t;               /* 仿真时间 s               */
+} pmsm_state_t;
+
+void pmsm_default_params(pmsm_params_t *p);
+void pmsm_reset(pmsm_state_t *s);
+
+/* 推进一个 PWM 周期。duty 为三相高边导通比；bridge_on=false 时桥臂全关（电流续流到零） */
+void pmsm_step(const pmsm_params_t *p, pmsm_state_t *s, const double duty[3], bool bridge_on);
+
+/* 转换为 MCSDK 的 s16degree 电角度（q 轴超前 d 轴 90°，与 MCM_Park 约定一致） */
+int16_t pmsm_el_angle_s16(const pmsm_state_t *s);
+double  pmsm_speed_rpm(const pmsm_params_t *p, const pmsm_state_t *s);
+
+#endif /* PMSM_PLANT_H_ */
@@ -0,0 +1,134 @@
+/*
+ * core_cm4.h  (host port)
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  主机构建用的 CMSIS 垫片：
+ *  先占住 cmsis_gcc.h 的 include guard，再用 C 实现 Cortex-M4 内建函数，
+ *  最后 include_next 真正的 core_cm4.h，让寄存器定义保持与固件一致。
+ */
+#ifndef HOST_PORT_CORE_CM4_H
+#define HOST_PORT_CORE_CM4_H
+
+#include <stdint.h>
+
+#define __CMSIS_GCC_H                 /* 屏蔽 ARM 内联汇编版本 */
+
+#define __ASM                         __asm
+#define __INLINE                      inline
+#define __STATIC_INLINE               static inline
+#define __STATIC_FORCEINLINE          __attribute__((always_inline)) static inline
+#define __NO_RETURN                   __attribute__((__noreturn__))
+#define __USED                        __attribute__((used))
+#define __WEAK                        __attribute__((weak))
+#define __PACKED                      __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT               struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION                union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                  __attribute__((aligned(x)))
+#define __RESTRICT                    __restrict
+#define __COMPILER_BARRIER()          __asm volatile("" ::: "memory")
+
+#define __UNALIGNED_UINT16_WRITE(addr, val) \
+  do { uint16_t __v = (uint16_t)(val); __builtin_memcpy((void *)(addr), &__v, 2); } while (0)
+#define __UNALIGNED_UINT32_WRITE(addr, val) \
+  do { uint32_t __v = (uint32_t)(val); __builtin_memcpy((void *)(addr), &__v, 4); } while (0)
+static inline uint16_t host_unaligned_u16(const void *p) { uint16_t v; __builtin_memcpy(&v, p, 2); return v; }
+static inline uint32_t host_unaligned_u32(const void *p) { uint32_t v; __builtin_memcpy(&v, p, 4); return v; }
+#define __UNALIGNED_UINT16_READ(addr) host_unaligned_u16((const void *)(addr))
+#define __UNALIGNED_UINT32_READ(addr) host_unaligned_u32((const void *)(addr))
+#define __UNALIGNED_UINT32(x)         host_unaligned_u32((const void *)(x))
+
+/* ── 中断/屏障：单线程仿真，全部退化为编译器屏障 ── */
+extern volatile uint32_t host_primask;
+
+__STATIC_FORCEINLINE void __enable_irq(void)  { __COMPILER_BARRIER(); host_primask = 0U; }
+__STATIC_FORCEINLINE void __disable_irq(void) { host_primask = 1U; __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void) { return host_primask; }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t m) { host_primask = m & 1U; __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE uint32_t __get_BASEPRI(void) { return 0U; }
+__STATIC_FORCEINLINE void __set_BASEPRI(uint32_t v) { (void)v; __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE void __set_BASEPRI_MAX(uint32_t v) { (void)v; __COMPILER_BARRIER(); }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void) { return 0U; }
+__STATIC_FORCEINLINE uint32_t __get_CONTROL(void) { return 0U; }
+__STATIC_FORCEINLINE void __set_CONTROL(uint32_t v) { (void)v; }
+__STATIC_FORCEINLINE uint32_t __get_MSP(void) { return 0U; }
+__STATIC_FORCEINLINE void __set_MSP(uint32_t v) { (void)v; }
+__STATIC_FORCEINLINE uint32_t __get_PSP(void) { return 0U; }
+__STATIC_FORCEINLINE void __set_PSP(uint32_t v) { (void)v; }
+__STATIC_FORCEINLINE uint32_t __get_FPSCR(void) { return 0U; }
+__STATIC_FORCEINLINE void __set_FPSCR(uint32_t v) { (void)v; }
+
+#define __NOP()                       __COMPILER_BARRIER()
+#define __WFI()                       __COMPILER_BARRIER()
+#define __WFE()                       __COMPILER_BARRIER()
+#define __SEV()                       __COMPILER_BARRIER()
+#define __BKPT(value)                 __builtin_trap()
+__STATIC_FORCEINLINE void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+/* ── 位操作 ── */
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t v)   { return __builtin_bswap32(v); }
+__STATIC_FORCEINLINE uint32_t __REV16(uint32_t v) { return ((v & 0xFF00FF00U) >> 8) | ((v & 0x00FF00FFU) << 8); }
+__STATIC_FORCEINLINE int16_t __REVSH(int16_t v)   { return (int16_t)__builtin_bswap16((uint16_t)v); }
+__STATIC_FORCEINLINE uint32_t __ROR(uint32_t a, uint32_t n) { n &= 31U; return (n == 0U) ? a : ((a >> n) | (a << (32U - n))); }
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t v)   { return (v == 0U) ? 32U : (uint8_t)__builtin_clz(v); }
+__STATIC_FORCEINLINE uint32_t __RBIT(uint32_t v)
+{
+  uint32_t r = 0U;
+  for (int i = 0; i < 32; i++) { r = (r << 1) | (v & 1U); v >>= 1; }
+  return r;
+}
+
+/* ── 饱和运算 ── */
+__STATIC_FORCEINLINE int32_t __SSAT(int32_t val, uint32_t sat)
+{
+  if ((sat >= 1U) && (sat <= 32U))
+  {
+    const int32_t max = (int32_t)((1LL << (sat - 1U)) - 1);
+    const int32_t min = -1 - max;
+    if (val > max) { return max; }
+    if (val < min) { return min; }
+  }
+  return val;
+}
+__STATIC_FORCEINLINE uint32_t __USAT(int32_t val, uint32_t sat)
+{
+  if (sat <= 31U)
+  {
+    const uint32_t max = ((1U << sat) - 1U);
+    if (val > (int32_t)max) { return max; }
+    if (val < 0) { return 0U; }
+  }
+  return (uint32_t)val;
+}
+__STATIC_FORCEINLINE int32_t __QADD(int32_t a, int32_t b)
+{
+  const int64_t s = (int64_t)a + b;
+  return (s > INT32_MAX) ? INT32_MAX : ((s < INT32_MIN) ? INT32_MIN : (int32_t)s);
+}
+/* 两个有符号半字相乘再累加: lo*lo + hi*hi + acc */
+__STATIC_FORCEINLINE uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3)
+{
+  return (uint32_t)((int32_t)(int16_t)op1 * (int16_t)op2
+                    + (int32_t)(int16_t)(op1 >> 16) * (int16_t)(op2 >> 16) + (int32_t)op3);
+}
+__STATIC_FORCEINLINE int32_t __QSUB(int32_t a, int32_t b)
+{
+  const int64_t s = (int64_t)a - b;
+  return (s > INT32_MAX) ? INT32_MAX : ((s < INT32_MIN) ? INT32_MIN : (int32_t)s);
+}
+
+/* ── 独占访问：单线程下恒成功 ── */
+__STATIC_FORCEINLINE uint8_t  __LDREXB(volatile uint8_t *a)  { return *a; }
+__STATIC_FORCEINLINE uint16_t __LDREXH(volatile uint16_t *a) { return *a; }
+__STATIC_FORCEINLINE uint32_t __LDREXW(volatile uint32_t *a) { return *a; }
+__STATIC_FORCEINLINE uint32_t __STREXB(uint8_t v, volatile uint8_t *a)   { *a = v; return 0U; }
+__STATIC_FORCEINLINE uint32_t __STREXH(uint16_t v, volatile uint16_t *a) { *a = v; return 0U; }
+__STATIC_FORCEINLINE uint32_t __STREXW(uint32_t v, volatile uint32_t *a) { *a = v; return 0U; }
+__STATIC_FORCEINLINE void __CLREX(void) { }
+
+#include_next <core_cm4.h>
+
+#endif /* HOST_PORT_CORE_CM4_H */
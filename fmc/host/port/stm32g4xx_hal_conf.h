@@ -0,0 +1,16 @@
+/*
+ * stm32g4xx_hal_conf.h  (host port)
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  HAL 头用引号包含同目录的 LL 头 (stm32g4xx_hal_adc.h -> "stm32g4xx_ll_adc.h")，
+ *  会绕过 port/。在 HAL 配置之前先把 port 版本的 LL 头拉进来，之后的包含都被头文件保护挡掉。
+ */
+#ifndef HOST_PORT_STM32G4xx_HAL_CONF_H
+#define HOST_PORT_STM32G4xx_HAL_CONF_H
+
+#include <stm32g4xx_ll_adc.h>
+#include_next <stm32g4xx_hal_conf.h>
+
+#endif /* HOST_PORT_STM32G4xx_HAL_CONF_H */
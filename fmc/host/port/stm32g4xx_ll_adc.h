@@ -0,0 +1,35 @@
+/*
+ * stm32g4xx_ll_adc.h  (host port)
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  主机上 ADC 寄存器只是普通内存：
+ *  - LL_ADC_REG_StartConversion 用 MODIFY_REG 清 "rs" 位，硬件上写 0 无效，内存里会把 ADEN 清掉；
+ *  - ADSTP 不会被硬件清零。
+ *  这两个函数重定向到 host_periph.c：启动只置 ADSTART，停止立即完成 (ADSTART / ADSTP 清零)，
+ *  RCM 重排规则序列时的等待循环才能退出。
+ */
+#ifndef HOST_PORT_STM32G4xx_LL_ADC_H
+#define HOST_PORT_STM32G4xx_LL_ADC_H
+
+#define LL_ADC_REG_StartConversion  LL_ADC_REG_StartConversion_reg
+#define LL_ADC_REG_StopConversion   LL_ADC_REG_StopConversion_reg
+#include_next <stm32g4xx_ll_adc.h>
+#undef LL_ADC_REG_StartConversion
+#undef LL_ADC_REG_StopConversion
+
+void host_adc_reg_start(ADC_TypeDef *ADCx);
+void host_adc_reg_stop(ADC_TypeDef *ADCx);
+
+__STATIC_INLINE void LL_ADC_REG_StartConversion(ADC_TypeDef *ADCx)
+{
+  host_adc_reg_start(ADCx);
+}
+
+__STATIC_INLINE void LL_ADC_REG_StopConversion(ADC_TypeDef *ADCx)
+{
+  host_adc_reg_stop(ADCx);
+}
+
+#endif /* HOST_PORT_STM32G4xx_LL_ADC_H */
@@ -0,0 +1,36 @@
+/*
+ * stm32g4xx_ll_cordic.h  (host port)
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  主机上 CORDIC 没有硬件，WDATA/RDATA 只是普通内存。
+ *  这里把 LL_CORDIC_WriteData/ReadData 重定向到 host_cordic.c 的软件模型，
+ *  其余 LL 函数（CSR 配置、RRDY 查询）仍然走真实头文件。
+ */
+#ifndef HOST_PORT_STM32G4xx_LL_CORDIC_H
+#define HOST_PORT_STM32G4xx_LL_CORDIC_H
+
+#define LL_CORDIC_WriteData   LL_CORDIC_WriteData_reg
+#define LL_CORDIC_ReadData    LL_CORDIC_ReadData_reg
+#include_next <stm32g4xx_ll_cordic.h>
+#undef LL_CORDIC_WriteData
+#undef LL_CORDIC_ReadData
+
+void     host_cordic_write(CORDIC_TypeDef *CORDICx, uint32_t InData);
+uint32_t host_cordic_read(const CORDIC_TypeDef *CORDICx);
+/* CSR.DMAREN 且 RRDY 时读一个结果、否则 DMAWEN 且无结果待读时写一个参数，
+ * 经 DMAMUX 上挂着 CORDIC_READ / CORDIC_WRITE 的 DMA1/DMA2 通道；返回搬了几个字 (0/1) */
+uint32_t host_cordic_dma_service(void);
+
+__STATIC_INLINE void LL_CORDIC_WriteData(CORDIC_TypeDef *CORDICx, uint32_t InData)
+{
+  host_cordic_write(CORDICx, InData);
+}
+
+__STATIC_INLINE uint32_t LL_CORDIC_ReadData(const CORDIC_TypeDef *CORDICx)
+{
+  return host_cordic_read(CORDICx);
+}
+
+#endif /* HOST_PORT_STM32G4xx_LL_CORDIC_H */
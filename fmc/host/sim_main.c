@@ -0,0 +1,342 @@
+/*
+ * sim_main.c
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  FOC 闭环主机仿真：
+ *    - 每个 PWM 周期：plant 采样 → TSK_HighFrequencyTask()（即 ADC1_2 JEOS 中断）→ plant 积分一个周期
+ *    - 每 PWM_FREQUENCY/SYS_TICK_FREQUENCY 个周期：MC_RunMotorControlTasks()（即 SysTick）
+ *  固件侧代码（mc_tasks*.c、mc_math.c、PID、STO_PLL、SVPWM …）原样编译，
+ *  只有 R3_2 驱动、CORDIC 数据口和外设地址空间被主机替身接管。
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "main.h"
+#include "mc_type.h"
+#include "mc_config.h"
+#include "mc_tasks.h"
+#include "mc_api.h"
+#include "mc_interface.h"
+#include "parameters_conversion.h"
+#include "host_periph.h"
+#include "host_pwm.h"
+#include "pmsm_plant.h"
+#include "obs_cap.h"
+#include "obs_trace.h"
+#include "pwm_gov.h"
+
+#define SIM_TICK_DIV    ((uint32_t)(PWM_FREQUENCY / SYS_TICK_FREQUENCY))
+/* SysTick 周期折成 TIM1 tick：pwm_gov 改了 PWM 周期或抽取率后仍按时间调度 */
+#define SIM_TICK_TICKS  ((uint64_t)SIM_TICK_DIV * PWM_PERIOD_CYCLES)
+
+MCI_Handle_t *pMCI[NBR_OF_MOTORS];
+
+typedef struct
+{
+    double      seconds;
+    double      rpm;             /* 0：保持 drive_parameters.h 的默认目标 */
+    double      load;
+    double      vbus;
+    int32_t     tq_kp, tq_ki;    /* <0：不覆盖 */
+    int32_t     sp_kp, sp_ki;
+    double      inject_at;       /* <0：不注入 MC_DURATION */
+    uint32_t    inject_n;
+    const char *trace;
+    uint32_t    trace_div;
+    const char *capture;         /* 观测器输入 trace（obs_replay 用） */
+    pwm_gov_mode_t gov;
+    uint8_t     gov_profile;
+    int         expect_run;
+    int         quiet;
+} sim_opts_t;
+
+static const char *state_name(MCI_State_t s)
+{
+    switch (s)
+    {
+        case IDLE:             return "IDLE";
+        case ICLWAIT:          return "ICLWAIT";
+        case ALIGNMENT:        return "ALIGNMENT";
+        case CHARGE_BOOT_CAP:  return "CHARGE_BOOT_CAP";
+        case OFFSET_CALIB:     return "OFFSET_CALIB";
+        case START:            return "START";
+        case SWITCH_OVER:      return "SWITCH_OVER";
+        case RUN:              return "RUN";
+        case STOP:             return "STOP";
+        case FAULT_NOW:        return "FAULT_NOW";
+        case FAULT_OVER:       return "FAULT_OVER";
+        case WAIT_STOP_MOTOR:  return "WAIT_STOP_MOTOR";
+        default:               return "?";
+    }
+}
+
+static void usage(const char *argv0)
+{
+    printf("usage: %s [options]\n"
+           "  --seconds T        simulated time (default 4)\n"
+           "  --rpm N            speed target after start-up (default %d)\n"
+           "  --load Nm          constant load torque\n"
+           "  --vbus V           bus voltage (default %u)\n"
+           "  --torque-kp/ki N   override PID Iq/Id gains\n"
+           "  --speed-kp/ki N    override speed PID gains\n"
+           "  --inject-duration T:N  force N MC_DURATION returns at time T\n"
+           "  --trace FILE       CSV trace (every --trace-div PWM cycles, default 16)\n"
+           "  --capture FILE     observer input trace for obs_replay, plant angle as reference\n"
+           "  --gov auto|fix:N   PWM / FOC rate governor (default off: nominal profile P%u)\n"
+           "  --expect-run       exit 1 unless RUN within 10%% of target at the end\n"
+           "  --quiet\n", argv0, DEFAULT_TARGET_SPEED_RPM, NOMINAL_BUS_VOLTAGE_V, (unsigned)PWM_GOV_NOMINAL);
+}
+
+static int parse_opts(int argc, char **argv, sim_opts_t *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->seconds = 4.0;
+    o->vbus = NOMINAL_BUS_VOLTAGE_V;
+    o->tq_kp = o->tq_ki = o->sp_kp = o->sp_ki = -1;
+    o->inject_at = -1.0;
+    o->trace_div = 16u;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if      (!strcmp(a, "--seconds") && v)   { o->seconds = atof(v); i++; }
+        else if (!strcmp(a, "--rpm") && v)       { o->rpm = atof(v); i++; }
+        else if (!strcmp(a, "--load") && v)      { o->load = atof(v); i++; }
+        else if (!strcmp(a, "--vbus") && v)      { o->vbus = atof(v); i++; }
+        else if (!strcmp(a, "--torque-kp") && v) { o->tq_kp = atoi(v); i++; }
+        else if (!strcmp(a, "--torque-ki") && v) { o->tq_ki = atoi(v); i++; }
+        else if (!strcmp(a, "--speed-kp") && v)  { o->sp_kp = atoi(v); i++; }
+        else if (!strcmp(a, "--speed-ki") && v)  { o->sp_ki = atoi(v); i++; }
+        else if (!strcmp(a, "--trace") && v)     { o->trace = v; i++; }
+        else if (!strcmp(a, "--trace-div") && v) { o->trace_div = (uint32_t)atoi(v); i++; }
+        else if (!strcmp(a, "--capture") && v)   { o->capture = v; i++; }
+        else if (!strcmp(a, "--gov") && v)
+        {
+            unsigned n;
+            if      (!strcmp(v, "auto"))                { o->gov = PWM_GOV_AUTO; }
+            else if (!strcmp(v, "off"))                 { o->gov = PWM_GOV_OFF; }
+            else if (sscanf(v, "fix:%u", &n) == 1 && n < PWM_GOV_PROFILES)
+            {
+                o->gov = PWM_GOV_FIXED;
+                o->gov_profile = (uint8_t)n;
+            }
+            else                                        { return -1; }
+            i++;
+        }
+        else if (!strcmp(a, "--inject-duration") && v)
+        {
+            if (sscanf(v, "%lf:%u", &o->inject_at, &o->inject_n) != 2) { return -1; }
+            i++;
+        }
+        else if (!strcmp(a, "--expect-run"))    { o->expect_run = 1; }
+        else if (!strcmp(a, "--quiet"))         { o->quiet = 1; }
+        else                                    { return -1; }
+    }
+    if (o->trace_div == 0u) { o->trace_div = 1u; }
+    return 0;
+}
+
+/* obs_cap 的参考角钩子：采样时刻的 plant 真值电角度 */
+static const pmsm_state_t *sim_plant;
+
+static int16_t sim_ref_angle(void)
+{
+    return pmsm_el_angle_s16(sim_plant);
+}
+
+static double wrap_deg(double d)
+{
+    while (d > 180.0)   { d -= 360.0; }
+    while (d <= -180.0) { d += 360.0; }
+    return d;
+}
+
+int main(int argc, char **argv)
+{
+    sim_opts_t opt;
+    pmsm_params_t prm;
+    pmsm_state_t  st;
+    FILE *trace = NULL;
+    FILE *capture = NULL;
+
+    if (parse_opts(argc, argv, &opt) != 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    host_periph_init();
+    pmsm_default_params(&prm);
+    prm.t_load = opt.load;
+    prm.vbus = opt.vbus;
+    pmsm_reset(&st);
+    host_periph_set_vbus(prm.vbus);
+
+    MCboot(pMCI);
+
+    if (opt.tq_kp >= 0) { PID_SetKP(&PIDIqHandle_M1, (int16_t)opt.tq_kp); PID_SetKP(&PIDIdHandle_M1, (int16_t)opt.tq_kp); }
+    if (opt.tq_ki >= 0) { PID_SetKI(&PIDIqHandle_M1, (int16_t)opt.tq_ki); PID_SetKI(&PIDIdHandle_M1, (int16_t)opt.tq_ki); }
+    if (opt.sp_kp >= 0) { PID_SetKP(&PIDSpeedHandle_M1, (int16_t)opt.sp_kp); }
+    if (opt.sp_ki >= 0) { PID_SetKI(&PIDSpeedHandle_M1, (int16_t)opt.sp_ki); }
+    pwm_gov_set_mode(opt.gov, opt.gov_profile);
+
+    if (opt.trace != NULL)
+    {
+        trace = fopen(opt.trace, "w");
+        if (trace == NULL)
+        {
+            perror(opt.trace);
+            return 2;
+        }
+        fprintf(trace, "t,state,rpm,rpm_est,id_A,iq_A,iqref,vq,theta_err_deg\n");
+    }
+
+    if (opt.capture != NULL)
+    {
+        capture = fopen(opt.capture, "wb");
+        if ((capture == NULL) || (obs_trace_write_header(capture, TF_REGULATION_RATE) != 0))
+        {
+            perror(opt.capture);
+            return 2;
+        }
+        /* 从启动前开始录：重放的 STO_PLL 和固件逐拍一致 */
+        sim_plant = &st;
+        obs_cap_set_ref(&sim_ref_angle);
+        obs_cap_start(0u, 1u);
+    }
+
+    (void)MC_StartMotor1();
+
+    /* 时间以 TIM1 tick 计（标称 PWM 周期 = PWM_PERIOD_CYCLES），k 数 HF 任务次数 */
+    const uint64_t end_ticks = (uint64_t)(opt.seconds * PWM_FREQUENCY) * PWM_PERIOD_CYCLES;
+    const uint64_t inject_ticks = (opt.inject_at >= 0.0)
+                                  ? (uint64_t)(opt.inject_at * PWM_FREQUENCY) * PWM_PERIOD_CYCLES : UINT64_MAX;
+    uint64_t ticks = 0u;
+    uint64_t systick_acc = 0u;
+    uint64_t k = 0u;
+    bool ramp_sent = false;
+    MCI_State_t last_state = IDLE;
+    double err_acc = 0.0;
+    uint64_t err_n = 0u;
+    double duty[3];
+    struct timespec t0, t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (; ticks < end_ticks; k++)
+    {
+        /* ── JEOS：采样时刻的电流交给 ADC 模型，然后跑 HF 任务 ── */
+        host_pwm_sample(st.i_abc);
+        if (ticks >= inject_ticks)
+        {
+            host_pwm.inject_duration = opt.inject_n;
+            opt.inject_n = 0u;
+        }
+        (void)TSK_HighFrequencyTask();
+        if (capture != NULL)
+        {
+            obs_cap_rec_t rec[4];
+            const uint32_t n = obs_cap_read(rec, 4u);
+            (void)fwrite(rec, sizeof(rec[0]), n, capture);
+        }
+
+        /* ── 新的 CCR（和 pwm_gov 换的 ARR/RCR）在下一个更新事件生效：plant 积分到下一次 HF ── */
+        const bool on = host_pwm_get_duty(duty);
+        const uint32_t n_pwm = host_pwm_hf_pwm_cycles();
+        prm.pwm_period_s = host_pwm_period_s();
+        for (uint32_t i = 0u; i < n_pwm; i++)
+        {
+            pmsm_step(&prm, &st, duty, on);
+        }
+        ticks += host_pwm_hf_ticks();
+        systick_acc += host_pwm_hf_ticks();
+
+        if (systick_acc >= SIM_TICK_TICKS)
+        {
+            systick_acc -= SIM_TICK_TICKS;
+            MC_RunMotorControlTasks();
+        }
+
+        const MCI_State_t s = MC_GetSTMStateMotor1();
+        if (s != last_state)
+        {
+            if (!opt.quiet)
+            {
+                printf("%8.4f s  %-16s -> %s\n", st.t, state_name(last_state), state_name(s));
+            }
+            last_state = s;
+        }
+        if ((s == RUN) && !ramp_sent && (opt.rpm != 0.0))
+        {
+            MC_ProgramSpeedRampMotor1((int16_t)(opt.rpm * SPEED_UNIT / U_RPM), 500u);
+            ramp_sent = true;
+        }
+
+        const double est = (double)(int16_t)(SPD_GetElAngle(&STO_PLL_M1._Super) - pmsm_el_angle_s16(&st));
+        const double err_deg = wrap_deg(est * (360.0 / 65536.0));
+        if (s == RUN)
+        {
+            err_acc += fabs(err_deg);
+            err_n++;
+        }
+        if ((trace != NULL) && ((k % opt.trace_div) == 0u))
+        {
+            fprintf(trace, "%.6f,%d,%.2f,%d,%.4f,%.4f,%d,%d,%.2f\n",
+                    st.t, (int)s, pmsm_speed_rpm(&prm, &st),
+                    SPEED_UNIT_2_RPM(MC_GetMecSpeedAverageMotor1()),
+                    st.id, st.iq, FOCVars[M1].Iqdref.q, FOCVars[M1].Vqd.q, err_deg);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (trace != NULL)
+    {
+        fclose(trace);
+    }
+    if (capture != NULL)
+    {
+        obs_cap_stats_t cs;
+        obs_cap_stop();
+        obs_cap_get_stats(&cs);
+        fclose(capture);
+        printf("capture    %u records (%u dropped) -> %s\n", cs.written, cs.dropped, opt.capture);
+    }
+
+    const double wall = (double)(t1.tv_sec - t0.tv_sec) + ((double)(t1.tv_nsec - t0.tv_nsec) * 1e-9);
+    const double rpm = pmsm_speed_rpm(&prm, &st);
+    const double target = (opt.rpm != 0.0) ? opt.rpm : (double)DEFAULT_TARGET_SPEED_RPM;
+    const MCI_State_t s = MC_GetSTMStateMotor1();
+
+    printf("state      %s  faults 0x%04x  duration_injected %u\n", state_name(s),
+           MC_GetOccurredFaultsMotor1(), host_pwm.duration_faults);
+    printf("speed      plant %.1f rpm  observer %d rpm  target %.0f rpm\n",
+           rpm, SPEED_UNIT_2_RPM(MC_GetMecSpeedAverageMotor1()), target);
+    printf("currents   id %.3f A  iq %.3f A  Te %.4f Nm\n", st.id, st.iq, st.te);
+    if (opt.gov != PWM_GOV_OFF)
+    {
+        pwm_gov_status_t gs;
+        pwm_gov_get_status(&gs);
+        printf("gov        P%u (%u Hz PWM, %u Hz FOC)  floor P%u  %u switches\n", (unsigned)gs.active,
+               (unsigned)pwm_gov_profiles[gs.active].pwm_hz, (unsigned)pwm_gov_profiles[gs.active].rate_hz,
+               (unsigned)gs.floor, gs.switches);
+    }
+    printf("angle err  mean |e| %.2f deg over %llu RUN cycles\n",
+           (err_n != 0u) ? (err_acc / (double)err_n) : 0.0, (unsigned long long)err_n);
+    printf("throughput %llu cycles in %.3f s  ->  %.2f M cycles/s (%.0fx real time)\n",
+           (unsigned long long)k, wall, (double)k / wall / 1e6,
+           opt.seconds / wall);
+
+    if (opt.expect_run)
+    {
+        if ((s != RUN) || (fabs(rpm - target) > (0.1 * target)))
+        {
+            printf("FAIL: expected RUN near %.0f rpm\n", target);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,566 @@
+/* ASPEP/MCP loopback: the firmware protocol stack against a host Motor Pilot.
+ *
+ * aspep.c, mcp.c, sync_registers.c and mcpa.c run unmodified under the real
+ * scheduler (TSK_HighFrequencyTask every PWM period, SysTick every
+ * PWM_FREQUENCY / SYS_TICK_FREQUENCY periods, MCP answered from MC_Scheduler).
+ * Only the UART/DMA layer is replaced by uaspep_loop.c, a byte-timed in-memory
+ * line; the controller side is aspep_pilot.c.
+ *
+ *   test_aspep_loop                 connect, sync commands, MCPA log under sync load
+ *   test_aspep_loop --bench         packets/s and round-trip times, MCPA off/delta/raw
+ *   test_aspep_loop --fuzz N        N corrupted headers, each answer and the recovery checked
+ *
+ * --baud B sets the line rate (default 1843200, the MCSDK ASPEP rate), --gap T
+ * the PWM periods the pilot waits between a data header and its payload, --seed S
+ * the fuzzer seed. The performer only polls the RX DMA in SysTick, so a payload
+ * sent right behind its header overruns the USART: the default gap is one
+ * SysTick period.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mc_type.h"
+#include "mc_config.h"
+#include "mc_tasks.h"
+#include "mcp.h"
+#include "mcp_config.h"
+#include "mcpa.h"
+#include "aspep.h"
+#include "register_interface.h"
+#include "parameters_conversion.h"
+#include "host_periph.h"
+#include "host_pwm.h"
+#include "pmsm_plant.h"
+#include "uaspep_loop.h"
+#include "aspep_pilot.h"
+#include "mcpa_decode.h"
+#include "test_util.h"
+
+MCI_Handle_t *pMCI[NBR_OF_MOTORS];
+
+#define TICK_DIV      ((uint64_t)(PWM_FREQUENCY / SYS_TICK_FREQUENCY))
+#define MS(ms)        ((uint64_t)(ms) * PWM_FREQUENCY / 1000u)
+#define M1_ID(reg)    ((uint16_t)((reg) | 1u))
+#define MCP_M1(cmd)   ((uint16_t)((cmd) | 1u))
+
+static uint32_t opt_baud = 1843200u;
+static uint64_t opt_gap = TICK_DIV;
+
+/* ── simulated time: one PWM period per tick ── */
+static uint64_t now;
+
+/* ── pilot state ── */
+static aspep_pilot_rx_t prx;
+static aspep_pilot_caps_t caps_ours;
+static uint16_t ping_number;
+
+static struct {
+  uint32_t beacon, ping, nack, sync, async, bad_header, bad_crc;
+  uint32_t last_ctrl;              /* header of the last beacon / ping / nack */
+  uint64_t async_bytes;
+} ev;
+
+static uint8_t sync_ans[ASPEP_PILOT_MAX_PAYLOAD];
+static uint16_t sync_len;
+
+/* MCPA stream as the pilot configured it */
+static struct {
+  bool on;
+  mcpa_layout_t lay;
+  uint32_t next_ts;                /* timestamp expected for the next buffer */
+  bool have_ts;
+  uint64_t samples, lost, decode_errors;
+} log_rx;
+
+static void on_async(const uint8_t *p, uint16_t len)
+{
+  static uint16_t hf[4096];
+  static uint32_t mf[1024];
+  mcpa_buffer_info_t info;
+
+  ev.async_bytes += len;
+  if (!log_rx.on) return;
+  if (mcpa_decode(&log_rx.lay, p, len, hf, sizeof(hf) / 2, mf, sizeof(mf) / 4, &info) != 0) {
+    log_rx.decode_errors++;
+    return;
+  }
+  if (log_rx.have_ts && (info.timestamp != log_rx.next_ts)) {
+    log_rx.lost += (uint32_t)(info.timestamp - log_rx.next_ts);
+  }
+  log_rx.samples += info.n_samples;
+  log_rx.next_ts = info.timestamp + info.n_samples;
+  log_rx.have_ts = true;
+}
+
+static void pilot_poll(void)
+{
+  uint8_t buf[512];
+  uint32_t n;
+  while ((n = uaspep_loop_read(buf, sizeof(buf))) > 0u) {
+    for (uint32_t i = 0; i < n; i++) {
+      switch (aspep_pilot_rx_byte(&prx, buf[i])) {
+        case ASPEP_PILOT_EV_BEACON: ev.beacon++; ev.last_ctrl = prx.header; break;
+        case ASPEP_PILOT_EV_PING:   ev.ping++;   ev.last_ctrl = prx.header; break;
+        case ASPEP_PILOT_EV_NACK:   ev.nack++;   ev.last_ctrl = prx.header; break;
+        case ASPEP_PILOT_EV_SYNC:
+          ev.sync++;
+          sync_len = prx.len;
+          memcpy(sync_ans, prx.payload, prx.len);
+          break;
+        case ASPEP_PILOT_EV_ASYNC:
+          ev.async++;
+          on_async(prx.payload, prx.len);
+          break;
+        case ASPEP_PILOT_EV_BAD_HEADER:   ev.bad_header++; break;
+        case ASPEP_PILOT_EV_BAD_DATA_CRC: ev.bad_crc++; break;
+        default: break;
+      }
+    }
+  }
+}
+
+static void tick(void)
+{
+  static const double no_current[3];
+
+  host_pwm_sample(no_current);
+  (void)TSK_HighFrequencyTask();
+  uaspep_loop_step();
+  if ((now % TICK_DIV) == (TICK_DIV - 1u)) {
+    /* SysTick_Handler: RX DMA TC poll, then the MC tasks */
+    uaspep_loop_systick();
+    MC_RunMotorControlTasks();
+  }
+  now++;
+  pilot_poll();
+}
+
+static void ticks(uint64_t n)
+{
+  while (n-- > 0u) tick();
+}
+
+/* An answer may wait behind a full async frame on the line */
+static uint64_t answer_timeout(void)
+{
+  uint64_t frame = ((uint64_t)MCP_TX_ASYNCBUFFER_SIZE_A * 10u * PWM_FREQUENCY) / opt_baud;
+  return frame + MS(5);
+}
+
+/* Header first; a data payload follows once the header has left and the gap elapsed */
+static void pilot_send(const uint8_t *frame, uint16_t len)
+{
+  while (!uaspep_loop_write(frame, ASPEP_PILOT_HEADER_SIZE)) tick();
+  if (len > ASPEP_PILOT_HEADER_SIZE) {
+    while (uaspep_loop_write_pending() > 0u) tick();
+    ticks(opt_gap);
+    while (!uaspep_loop_write(&frame[ASPEP_PILOT_HEADER_SIZE], (uint16_t)(len - ASPEP_PILOT_HEADER_SIZE))) tick();
+  }
+}
+
+/* Ticks until *counter moves past start, false on timeout */
+static bool wait_event(const uint32_t *counter, uint32_t start, uint64_t timeout)
+{
+  for (uint64_t t = 0; t < timeout; t++) {
+    if (*counter != start) return true;
+    tick();
+  }
+  return *counter != start;
+}
+
+/* Beacon exchange until both sides agree, then ping; adopts the performer's capabilities */
+static bool pilot_connect(const aspep_pilot_caps_t *want)
+{
+  uint8_t f[4];
+  aspep_pilot_caps_t caps = *want;
+
+  for (int round = 0; round < 3; round++) {
+    uint32_t b0 = ev.beacon;
+    pilot_send(f, aspep_pilot_beacon(f, &caps));
+    if (!wait_event(&ev.beacon, b0, answer_timeout())) return false;
+    aspep_pilot_caps_t got;
+    aspep_pilot_caps_of(ev.last_ctrl, &got);
+    if (memcmp(&got, &caps, sizeof(caps)) == 0) {
+      uint32_t p0 = ev.ping;
+      pilot_send(f, aspep_pilot_ping(f, ++ping_number));
+      if (!wait_event(&ev.ping, p0, answer_timeout())) return false;
+      caps_ours = caps;
+      prx.data_crc = (caps.data_crc != 0u);
+      return true;
+    }
+    caps = got;
+  }
+  return false;
+}
+
+/* One MCP request; returns the status byte or -1 on NACK / timeout. *rtt in ticks */
+static int transact(uint16_t mcp_header, const uint8_t *args, uint16_t arg_len, uint64_t *rtt)
+{
+  static uint8_t payload[MCP_RX_SYNC_PAYLOAD_MAX], frame[MCP_RX_SYNC_PAYLOAD_MAX + 8u];
+  memcpy(payload, &mcp_header, 2);
+  if (arg_len > 0u) memcpy(&payload[2], args, arg_len);
+  uint16_t len = aspep_pilot_data(frame, payload, (uint16_t)(arg_len + 2u), caps_ours.data_crc != 0u);
+
+  uint32_t s0 = ev.sync, n0 = ev.nack;
+  uint64_t t0 = now;
+  pilot_send(frame, len);
+  for (uint64_t t = 0; t < answer_timeout(); t++) {
+    if (ev.sync != s0) {
+      if (rtt != NULL) *rtt = now - t0;
+      return (sync_len > 0u) ? sync_ans[sync_len - 1u] : -1;
+    }
+    if (ev.nack != n0) return -1;
+    tick();
+  }
+  return -1;
+}
+
+static int get_regs(const uint16_t *ids, int n, uint64_t *rtt)
+{
+  return transact(MCP_M1(GET_DATA_ELEMENT), (const uint8_t *)ids, (uint16_t)(2 * n), rtt);
+}
+
+static int set_u16(uint16_t id, uint16_t v)
+{
+  uint8_t a[4];
+  memcpy(a, &id, 2);
+  memcpy(&a[2], &v, 2);
+  return transact(MCP_M1(SET_DATA_ELEMENT), a, 4, NULL);
+}
+
+/* MC_REG_ASYNC_UARTA: 2 HF currents every PWM period, speed every 16 samples; buff_size 0 stops */
+static int mcpa_config(uint16_t buff_size)
+{
+  uint8_t a[32];
+  uint16_t id = M1_ID(MC_REG_ASYNC_UARTA), hf0 = M1_ID(MC_REG_I_A), hf1 = M1_ID(MC_REG_I_B);
+  uint16_t mf0 = M1_ID(MC_REG_SPEED_MEAS), raw = 6u + 6u + 1u;
+  memcpy(&a[0], &id, 2);
+  memcpy(&a[2], &raw, 2);
+  memcpy(&a[4], &buff_size, 2);
+  a[6] = 0;     /* HFRate */
+  a[7] = 2;     /* HFNum */
+  a[8] = 15;    /* MFRate */
+  a[9] = 1;     /* MFNum */
+  memcpy(&a[10], &hf0, 2);
+  memcpy(&a[12], &hf1, 2);
+  memcpy(&a[14], &mf0, 2);
+  a[16] = (buff_size != 0u) ? 0x5Au : 0u;   /* Mark */
+
+  /* Stopping flushes the last buffer: the layout stays valid for it */
+  if (buff_size != 0u) {
+    memset(&log_rx, 0, sizeof(log_rx));
+    log_rx.lay.hf_num = 2;
+    log_rx.lay.mf_num = 1;
+    log_rx.lay.mf_size[0] = 4;
+    log_rx.lay.mf_rate = 15;
+  }
+  int rc = transact(MCP_M1(SET_DATA_ELEMENT), a, 17, NULL);
+  if (buff_size != 0u) log_rx.on = (rc == MCP_CMD_OK);
+  return rc;
+}
+
+static const aspep_pilot_caps_t caps_default = {
+  .version = 0,
+  .mcpa_delta = 1,
+  .data_crc = 1,
+  .rx_max = (MCP_RX_SYNC_PAYLOAD_MAX >> 5) - 1u,
+  .txs_max = (MCP_TX_SYNC_PAYLOAD_MAX >> 5) - 1u,
+  .txa_max = MCP_TX_ASYNC_PAYLOAD_MAX_A >> 6,
+};
+
+static const uint16_t bench_ids[] = {
+  M1_ID(MC_REG_SPEED_KP), M1_ID(MC_REG_SPEED_KI), M1_ID(MC_REG_BUS_VOLTAGE), M1_ID(MC_REG_SPEED_MEAS),
+};
+
+/* ── default run ── */
+static void test_loop(void)
+{
+  uint64_t rtt;
+
+  CHECK(pilot_connect(&caps_default), "connect");
+  CHECK(aspepOverUartA.ASPEP_State == ASPEP_CONNECTED, "state %d", aspepOverUartA.ASPEP_State);
+  CHECK(aspepOverUartA._Super.txAsyncFormat == MCTL_ASYNC_DELTA, "async format %u",
+        aspepOverUartA._Super.txAsyncFormat);
+  CHECK((ev.last_ctrl & 0x30u) == 0x30u, "ping answer without the C bits: %08x", ev.last_ctrl);
+
+  CHECK(transact(MCP_M1(GET_MCP_VERSION), NULL, 0, &rtt) == MCP_CMD_OK, "version");
+  CHECK(sync_len == 5u, "version answer %u bytes", sync_len);
+
+  uint16_t kp = (uint16_t)PID_GetKP(&PIDSpeedHandle_M1);
+  CHECK(set_u16(M1_ID(MC_REG_SPEED_KP), (uint16_t)(kp + 7u)) == MCP_CMD_OK, "set KP");
+  CHECK(get_regs(bench_ids, 1, &rtt) == MCP_CMD_OK, "get KP");
+  uint16_t v;
+  memcpy(&v, sync_ans, 2);
+  CHECK(v == (uint16_t)(kp + 7u), "KP read back %u, wrote %u", v, kp + 7u);
+  CHECK(set_u16(M1_ID(MC_REG_SPEED_KP), kp) == MCP_CMD_OK, "restore KP");
+
+  /* sync traffic while the datalog streams */
+  CHECK(mcpa_config(512) == MCP_CMD_OK, "MCPA start");
+  uint64_t max_rtt = 0;
+  for (int i = 0; i < 200; i++) {
+    CHECK(get_regs(bench_ids, 4, &rtt) == MCP_CMD_OK, "GET %d under MCPA load", i);
+    CHECK(sync_len == 2u + 2u + 2u + 4u + 1u, "GET answer %u bytes", sync_len);
+    if (rtt > max_rtt) max_rtt = rtt;
+  }
+  CHECK(mcpa_config(0) == MCP_CMD_OK, "MCPA stop");
+  ticks(MS(5));
+  uint32_t a0 = ev.async;
+  ticks(MS(20));
+  CHECK(ev.async == a0, "async buffers after MCPA stop");
+  CHECK(log_rx.samples > 0u, "no MCPA samples");
+  CHECK(log_rx.decode_errors == 0u, "%llu MCPA buffers did not decode", (unsigned long long)log_rx.decode_errors);
+  CHECK(log_rx.lost == 0u, "%llu MCPA samples lost at %u baud", (unsigned long long)log_rx.lost, opt_baud);
+
+  /* Renegotiating from CONNECTED applies the new capabilities */
+  aspep_pilot_caps_t raw = caps_default;
+  raw.mcpa_delta = 0;
+  CHECK(pilot_connect(&raw), "reconnect without delta");
+  CHECK(aspepOverUartA._Super.txAsyncFormat == MCTL_ASYNC_RAW, "async format %u after renegotiation",
+        aspepOverUartA._Super.txAsyncFormat);
+
+  CHECK(ev.bad_header == 0u && ev.bad_crc == 0u, "performer frames: %u bad headers, %u bad CRCs",
+        ev.bad_header, ev.bad_crc);
+  CHECK(uaspep_loop_stats.overruns == 0u, "%llu overruns", (unsigned long long)uaspep_loop_stats.overruns);
+  CHECK(uaspep_loop_stats.tx_dropped == 0u, "%llu TX frames dropped",
+        (unsigned long long)uaspep_loop_stats.tx_dropped);
+  printf("loop: %u sync, %u async (%llu samples), max RTT %.2f ms under MCPA at %u baud\n", ev.sync, ev.async,
+         (unsigned long long)log_rx.samples, (double)max_rtt * 1000.0 / PWM_FREQUENCY, opt_baud);
+}
+
+/* ── benchmark ── */
+static double wall_s(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench_row(const char *name, int mcpa_delta, bool log, double seconds)
+{
+  aspep_pilot_caps_t caps = caps_default;
+  caps.mcpa_delta = (uint8_t)mcpa_delta;
+  memset(&log_rx, 0, sizeof(log_rx));
+  CHECK(pilot_connect(&caps), "%s: connect", name);
+  if (log) CHECK(mcpa_config(1024) == MCP_CMD_OK, "%s: MCPA start", name);
+
+  uint32_t s0 = ev.sync, a0 = ev.async;
+  uint64_t b0 = ev.async_bytes, t0 = now, rtt, rtt_sum = 0, rtt_max = 0, n = 0;
+  double w0 = wall_s();
+  while ((now - t0) < (uint64_t)(seconds * PWM_FREQUENCY)) {
+    if (get_regs(bench_ids, 4, &rtt) != MCP_CMD_OK) {
+      CHECK(0, "%s: GET failed", name);
+      break;
+    }
+    rtt_sum += rtt;
+    if (rtt > rtt_max) rtt_max = rtt;
+    n++;
+  }
+  double wall = wall_s() - w0;
+  double sim = (double)(now - t0) / PWM_FREQUENCY;
+  uint32_t pkts = (ev.sync - s0) + (ev.async - a0);
+  const double us = 1e6 / PWM_FREQUENCY;
+
+  printf("%-6s %9.0f %9.0f %10.1f %9.0f %9.0f %11.0f %6llu\n", name, (double)(ev.sync - s0) / sim,
+         (double)(ev.async - a0) / sim, (double)(ev.async_bytes - b0) / sim / 1024.0,
+         (n != 0u) ? (double)rtt_sum / (double)n * us : 0.0, (double)rtt_max * us, (double)pkts / wall,
+         (unsigned long long)log_rx.lost);
+  if (log) {
+    CHECK(mcpa_config(0) == MCP_CMD_OK, "%s: MCPA stop", name);
+    ticks(MS(20));
+    CHECK(log_rx.decode_errors == 0u, "%s: MCPA decode errors", name);
+  }
+}
+
+static void bench(void)
+{
+  printf("%u baud, header/payload gap %.0f us, GET of 4 registers back to back, MCPA 2 HF + 1 MF\n",
+         opt_baud, (double)opt_gap * 1e6 / PWM_FREQUENCY);
+  printf("%-6s %9s %9s %10s %9s %9s %11s %6s\n", "mcpa", "sync/s", "async/s", "async KiB/s", "rtt us",
+         "max us", "host pkt/s", "lost");
+  /* The performer keeps the lowest capabilities it was offered: delta rows first */
+  bench_row("off", 1, false, 2.0);
+  bench_row("delta", 1, true, 2.0);
+  bench_row("raw", 0, true, 2.0);
+}
+
+/* ── fuzzer ── */
+static uint32_t rng = 1u;
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static uint32_t flip_bits(uint32_t h)
+{
+  int n = 1 + (int)(rnd() % 3u);
+  for (int i = 0; i < n; i++) h ^= 1u << (rnd() % 32u);
+  return h;
+}
+
+/* Pings until one is answered, reconnecting if the performer fell back to IDLE */
+static bool recover(uint64_t *took)
+{
+  uint8_t f[4];
+  uint64_t t0 = now;
+  for (int attempt = 0; attempt < 200; attempt++) {
+    uint32_t p0 = ev.ping;
+    pilot_send(f, aspep_pilot_ping(f, ++ping_number));
+    if (wait_event(&ev.ping, p0, answer_timeout())) {
+      if ((ev.last_ctrl & 0x30u) == 0u && !pilot_connect(&caps_default)) continue;
+      *took = now - t0;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void fuzz(uint32_t iterations)
+{
+  static const char *const kind_name[] = { "random", "ping bits", "data bits", "bad type", "too long", "data crc" };
+  uint32_t count[6] = { 0 }, nack_by_code[16] = { 0 }, downgrades = 0;
+  uint64_t worst = 0, took = 0;
+  uint8_t f[MCP_RX_SYNC_PAYLOAD_MAX + 8u];
+
+  CHECK(pilot_connect(&caps_default), "connect");
+  CHECK(mcpa_config(512) == MCP_CMD_OK, "MCPA start");
+
+  for (uint32_t it = 0; (it < iterations) && (failures == 0); it++) {
+    int kind = (int)(rnd() % 6u);
+    int expect = -1;          /* NACK code expected, -1: anything */
+    uint32_t h;
+    uint16_t len = ASPEP_PILOT_HEADER_SIZE;
+    count[kind]++;
+
+    switch (kind) {
+      case 0:
+        h = rnd();
+        break;
+      case 1:
+        aspep_pilot_ping(f, ++ping_number);
+        memcpy(&h, f, 4);
+        h = flip_bits(h);
+        break;
+      case 2: {
+        static const uint8_t zeros[4];
+        aspep_pilot_data(f, zeros, sizeof(zeros), false);
+        memcpy(&h, f, 4);
+        h = flip_bits(h);
+        break;
+      }
+      case 3: {
+        static const uint8_t bad[] = { 0x0, 0x1, 0x2, 0x3, 0x4, 0x7, 0x8, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF };
+        h = aspep_pilot_header_crc((rnd() & 0x0FFFFFF0u) | bad[rnd() % sizeof(bad)]);
+        expect = ASPEP_BAD_PACKET_TYPE;
+        break;
+      }
+      case 4:
+        h = aspep_pilot_header_crc(ASPEP_PILOT_DATA
+                                   | ((uint32_t)(aspepOverUartA.maxRXPayload + 1u + (rnd() % 64u)) << 4));
+        expect = ASPEP_BAD_PACKET_SIZE;
+        break;
+      default: {
+        uint8_t p[6];
+        uint16_t hdr = MCP_M1(GET_DATA_ELEMENT);
+        memcpy(p, &hdr, 2);
+        memcpy(&p[2], bench_ids, 4);
+        len = aspep_pilot_data(f, p, sizeof(p), true);
+        f[4u + (rnd() % (len - 4u))] ^= (uint8_t)(1u << (rnd() % 8u));
+        memcpy(&h, f, 4);
+        expect = (caps_ours.data_crc != 0u) ? ASPEP_BAD_CRC_DATA : -1;
+        break;
+      }
+    }
+    memcpy(f, &h, 4);
+    if (!aspep_pilot_header_ok(h)) expect = ASPEP_BAD_CRC_HEADER;
+
+    uint32_t n0 = ev.nack;
+    pilot_send(f, len);
+    if (expect >= 0) {
+      bool got = wait_event(&ev.nack, n0, answer_timeout());
+      CHECK(got, "iteration %u (%s, %08x): no NACK", it, kind_name[kind], h);
+      if (got) {
+        uint8_t code = aspep_pilot_nack_error(ev.last_ctrl);
+        nack_by_code[code & 0xFu]++;
+        CHECK(code == expect, "iteration %u (%s, %08x): NACK %u, expected %d", it, kind_name[kind], h, code, expect);
+      }
+    } else {
+      ticks(MS(2));
+    }
+
+    CHECK(recover(&took), "iteration %u (%s, %08x): link did not recover", it, kind_name[kind], h);
+    if (took > worst) worst = took;
+    if (memcmp(&caps_ours, &caps_default, sizeof(caps_ours)) != 0) downgrades++;
+
+    if ((it % 64u) == 63u) {
+      uint16_t kp = (uint16_t)(100u + (it & 0xFFu));
+      CHECK(set_u16(M1_ID(MC_REG_SPEED_KP), kp) == MCP_CMD_OK, "iteration %u: SET after recovery", it);
+      CHECK(get_regs(bench_ids, 1, NULL) == MCP_CMD_OK, "iteration %u: GET after recovery", it);
+      uint16_t v;
+      memcpy(&v, sync_ans, 2);
+      CHECK(v == kp, "iteration %u: KP %u, wrote %u", it, v, kp);
+    }
+  }
+  CHECK(get_regs(bench_ids, 4, NULL) == MCP_CMD_OK, "GET at the end");
+  CHECK(ev.bad_header == 0u && ev.bad_crc == 0u, "performer frames: %u bad headers, %u bad CRCs",
+        ev.bad_header, ev.bad_crc);
+  CHECK(log_rx.decode_errors == 0u, "MCPA decode errors");
+
+  printf("fuzz: %u iterations (", iterations);
+  for (int k = 0; k < 6; k++) printf("%s%s %u", (k != 0) ? ", " : "", kind_name[k], count[k]);
+  printf(")\nfuzz: NACK header crc %u, type %u, size %u, data crc %u; %llu idle resyncs, %llu overruns\n",
+         nack_by_code[ASPEP_BAD_CRC_HEADER], nack_by_code[ASPEP_BAD_PACKET_TYPE], nack_by_code[ASPEP_BAD_PACKET_SIZE],
+         nack_by_code[ASPEP_BAD_CRC_DATA], (unsigned long long)uaspep_loop_stats.idle_resets,
+         (unsigned long long)uaspep_loop_stats.overruns);
+  printf("fuzz: worst recovery %.2f ms, %u iterations ended on downgraded capabilities\n",
+         (double)worst * 1000.0 / PWM_FREQUENCY, downgrades);
+}
+
+int main(int argc, char **argv)
+{
+  int mode = 0;
+  uint32_t fuzz_n = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--bench") == 0) {
+      mode = 1;
+    } else if ((strcmp(argv[i], "--fuzz") == 0) && (i + 1 < argc)) {
+      mode = 2;
+      fuzz_n = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--baud") == 0) && (i + 1 < argc)) {
+      opt_baud = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--gap") == 0) && (i + 1 < argc)) {
+      opt_gap = strtoull(argv[++i], NULL, 0);
+    } else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc)) {
+      rng = (uint32_t)strtoul(argv[++i], NULL, 0) | 1u;
+    } else {
+      printf("usage: %s [--bench | --fuzz N] [--baud B] [--gap T] [--seed S]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  pmsm_params_t prm;
+  pmsm_default_params(&prm);
+  host_periph_init();
+  host_periph_set_vbus(prm.vbus);
+  uaspep_loop_init(&aspepOverUartA, opt_baud);
+  MCboot(pMCI);
+  aspep_pilot_rx_reset(&prx);
+  ticks(MS(10));
+
+  if (mode == 1) {
+    bench();
+  } else if (mode == 2) {
+    fuzz(fuzz_n);
+  } else {
+    test_loop();
+  }
+
+  return test_exit("test_aspep_loop");
+}
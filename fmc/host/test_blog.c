@@ -0,0 +1,178 @@
+/* Host test for the deferred binary log ring (plat/blog.c).
+ *
+ * blog.c is compiled into this file with DWT pointing at a fake whose read
+ * stands in for an interrupt: blog_write reads CYCCNT after its reservation
+ * and before the commit, so the hook there can run a higher-priority writer
+ * and the consumer while that reservation is still open. Records of 2..10
+ * words wrap the ring many times with non-zero arguments, so the word a new
+ * header lands on is usually an old argument; the consumer must still stop at
+ * the open reservation and hand out every record once, in reservation order.
+ * Then the drop watermark: dropped records are reported once, and
+ * blog_reset() clears the watermark with the counters.
+ */
+#include <stdint.h>
+#include <stdio.h>
+
+#include "stm32g4xx.h"
+
+static DWT_Type *test_dwt(void);
+#undef DWT
+#define DWT (test_dwt())
+
+#include "blog.c"
+
+#include "test_util.h"
+
+#define N_RECORDS  20000u
+
+static DWT_Type fake_dwt;
+static uint32_t irq_pending;    /* run the "interrupt" inside the next blog_write */
+static uint32_t seq_wr;         /* next sequence number to write */
+static uint32_t seq_rd;         /* next sequence number the consumer must see */
+static uint32_t open_reads;     /* records read while a reservation was open */
+
+static uint32_t lcg = 2026u;
+static uint32_t rnd(void)
+{
+  lcg = lcg * 1664525u + 1013904223u;
+  return lcg >> 8;
+}
+
+static uint32_t arg_of(uint32_t seq, uint32_t i)
+{
+  return 0xA5000000u | ((seq & 0xFFFFu) << 4) | i;
+}
+
+/* Sequence number in the id field, argument count varies with it */
+static uint32_t hdr_of(uint32_t seq)
+{
+  return ((seq & 0xFFFFu) << 16) | (BLOG_LVL_I << 12) | ((seq % 9u) << 8) | BLOG_MARK;
+}
+
+static void write_one(void)
+{
+  const uint32_t seq = seq_wr++;
+  uint32_t args[BLOG_MAX_ARGS];
+  for (uint32_t i = 0u; i < BLOG_MAX_ARGS; i++) {
+    args[i] = arg_of(seq, i);
+  }
+  fake_dwt.CYCCNT = seq;
+  blog_write(hdr_of(seq), args);
+}
+
+/* Consume one record and check it is the next one written; 0 = nothing committed */
+static uint32_t read_one(void)
+{
+  uint32_t rec[BLOG_MAX_REC_WORDS];
+  const uint32_t len = blog_read(rec, BLOG_MAX_REC_WORDS);
+  if (len == 0u) {
+    return 0u;
+  }
+  const uint32_t seq = seq_rd++;
+  const uint32_t nargs = seq % 9u;
+  CHECK(len == 2u + nargs, "seq %u: %u words, expected %u", (unsigned)seq, (unsigned)len, (unsigned)(2u + nargs));
+  CHECK(rec[0] == hdr_of(seq), "seq %u: header 0x%08x, expected 0x%08x", (unsigned)seq, (unsigned)rec[0],
+        (unsigned)hdr_of(seq));
+  CHECK(rec[1] == seq, "seq %u: timestamp %u", (unsigned)seq, (unsigned)rec[1]);
+  for (uint32_t i = 0u; (i < nargs) && (2u + i < len); i++) {
+    CHECK(rec[2u + i] == arg_of(seq, i), "seq %u: arg %u 0x%08x", (unsigned)seq, (unsigned)i,
+          (unsigned)rec[2u + i]);
+  }
+  return len;
+}
+
+/* Runs between the reservation and the commit of the interrupted blog_write */
+static DWT_Type *test_dwt(void)
+{
+  if (irq_pending != 0u) {
+    irq_pending = 0u;
+    const uint32_t open_seq = seq_wr - 1u;
+    if ((rnd() & 1u) != 0u) {
+      write_one();                    /* nested writer, behind the open reservation */
+      fake_dwt.CYCCNT = open_seq;
+    }
+    while (read_one() != 0u) {
+      open_reads++;
+    }
+    CHECK(seq_rd == open_seq, "consumer passed the open reservation: next %u, open %u", (unsigned)seq_rd,
+          (unsigned)open_seq);
+  }
+  return &fake_dwt;
+}
+
+static void test_wrap_open_reservation(void)
+{
+  blog_reset();
+  while (seq_wr < N_RECORDS) {
+    /* keep room: a drop would break the sequence */
+    if (blog_wr - blog_rd > BLOG_RING_WORDS - 3u * BLOG_MAX_REC_WORDS) {
+      while (read_one() != 0u) {
+      }
+    }
+    irq_pending = ((rnd() % 5u) == 0u) ? 1u : 0u;
+    write_one();
+    for (uint32_t n = rnd() % 3u; n != 0u; n--) {
+      (void)read_one();
+    }
+  }
+  while (read_one() != 0u) {
+  }
+
+  blog_stats_t st;
+  blog_get_stats(&st);
+  CHECK(seq_rd == seq_wr, "read %u of %u records", (unsigned)seq_rd, (unsigned)seq_wr);
+  CHECK(st.written == seq_wr && st.dropped == 0u, "written %u dropped %u", (unsigned)st.written,
+        (unsigned)st.dropped);
+  CHECK(blog_rd == blog_wr && blog_wr > 8u * BLOG_RING_WORDS, "ring at %u/%u", (unsigned)blog_rd, (unsigned)blog_wr);
+  CHECK(open_reads > 0u, "no record read while a reservation was open");
+  printf("%u records, %u ring laps, %u read under an open reservation, max used %u words\n", (unsigned)seq_rd,
+         (unsigned)(blog_wr / BLOG_RING_WORDS), (unsigned)open_reads, (unsigned)st.max_used);
+}
+
+/* log_poll's "#D:" logic: report when blog_drops_unreported says so */
+static uint32_t poll_drops(void)
+{
+  uint32_t dropped;
+  if (blog_drops_unreported(&dropped) == 0u) {
+    return 0u;
+  }
+  blog_drops_reported(dropped);
+  return 1u;
+}
+
+static void fill_until_drops(uint32_t drops)
+{
+  blog_stats_t st;
+  do {
+    write_one();
+    blog_get_stats(&st);
+  } while (st.dropped < drops);
+}
+
+static void test_drop_watermark(void)
+{
+  uint32_t dropped;
+
+  blog_reset();
+  CHECK(blog_drops_unreported(&dropped) == 0u && dropped == 0u, "drops after reset");
+
+  fill_until_drops(5u);
+  CHECK(poll_drops() == 1u, "5 drops not reported");
+  CHECK(poll_drops() == 0u, "drops reported twice");
+
+  /* Counters back to 0: the next 5 drops must be reported, not matched against the old 5 */
+  blog_reset();
+  CHECK(poll_drops() == 0u, "report right after reset");
+  fill_until_drops(5u);
+  CHECK(blog_drops_unreported(&dropped) == 1u && dropped == 5u, "5 drops after reset: pending %u",
+        (unsigned)dropped);
+  CHECK(poll_drops() == 1u, "drops after reset not reported");
+}
+
+int main(void)
+{
+  test_wrap_open_reservation();
+  test_drop_watermark();
+
+  return test_exit("test_blog");
+}
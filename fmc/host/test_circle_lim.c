@@ -0,0 +1,106 @@
+/* Host test for Circle_Limitation_Cordic (MCLib/Any/Src/circle_limitation.c)
+ * and the MCM_Sqrt_Start/MCM_Sqrt_Finish pair (Inc/mc_math.h).
+ *
+ * Circle_Limitation_Cordic must give the same Vqd as Circle_Limitation over a
+ * Vq/Vd grid, for the mc_config.c handle and for odd ones (MaxVd = 0,
+ * MaxVd = MaxModule, MaxVd > MaxModule, small circles), so every branch of
+ * the MCSDK function is compared. Both run on the host CORDIC model.
+ *
+ * The CORDIC sharing rules: a user that configured the CSR once (cos/sin,
+ * like the CLI benches) still gets its results after a square root ran, and
+ * MCM_Sqrt leaves PRIMASK as it found it.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mc_type.h"
+#include "mc_math.h"
+#include "circle_limitation.h"
+#include "test_util.h"
+
+#define GRID_STEP      97
+
+extern volatile uint32_t host_primask;
+
+static const CircleLimitation_Handle_t handles[] = {
+  { 32767u, (uint16_t)((32767 * 950) / 1000) },   /* mc_config.c */
+  { 32767u, 32767u },
+  { 32767u, 0u },
+  { 28000u, 30000u },                              /* MaxVd > MaxModule */
+  { 12000u, 6000u },
+  { 300u, 200u },
+};
+
+static void test_grid(void)
+{
+  uint32_t calls = 0u, over = 0u, vd_sat = 0u;
+
+  for (size_t h = 0u; h < (sizeof(handles) / sizeof(handles[0])); h++) {
+    const CircleLimitation_Handle_t *p = &handles[h];
+    int bad = 0;
+    for (int32_t q = -32767; q <= 32767; q += GRID_STEP) {
+      for (int32_t d = -32767; d <= 32767; d += GRID_STEP) {
+        qd_t v = {(int16_t)q, (int16_t)d};
+        const qd_t ref = Circle_Limitation(p, v);
+        const qd_t out = Circle_Limitation_Cordic(p, v);
+        calls++;
+        over += (ref.q != v.q) || (ref.d != v.d);
+        vd_sat += (ref.d != v.d);
+        if (((ref.q != out.q) || (ref.d != out.d)) && (bad++ < 3)) {
+          CHECK(0, "MaxModule %u MaxVd %u, Vqd %ld/%ld: %d/%d vs %d/%d", p->MaxModule, p->MaxVd, (long)q,
+                (long)d, out.q, out.d, ref.q, ref.d);
+        }
+      }
+    }
+  }
+  CHECK(over > calls / 4u, "only %u of %u calls over the limit", over, calls);
+  CHECK(vd_sat > calls / 20u, "Vd saturated in only %u of %u calls", vd_sat, calls);
+  printf("%u calls, %u over the limit, %u with Vd saturated\n", calls, over, vd_sat);
+}
+
+/* A configure-once cos/sin user, as the CLI benches: CSR written once, then WDATA/RDATA only */
+static void test_shared_csr(void)
+{
+  const CircleLimitation_Handle_t *p = &handles[0];
+  const qd_t v = {30000, -20000};
+  const int16_t angle = 12345;
+
+  WRITE_REG(CORDIC->CSR, CORDIC_CONFIG_COSINE);
+  const uint32_t csr = READ_REG(CORDIC->CSR);
+  const Trig_Components ref = MCM_Trig_Functions(angle);
+
+  const qd_t out = Circle_Limitation_Cordic(p, v);
+  CHECK((out.q != v.q) && (READ_REG(CORDIC->CSR) & ~CORDIC_CSR_RRDY) == (csr & ~CORDIC_CSR_RRDY),
+        "CSR 0x%08x after Circle_Limitation_Cordic, 0x%08x before", (unsigned)READ_REG(CORDIC->CSR),
+        (unsigned)csr);
+  (void)MCM_Sqrt(123456789);
+  CHECK((READ_REG(CORDIC->CSR) & ~CORDIC_CSR_RRDY) == (csr & ~CORDIC_CSR_RRDY), "CSR 0x%08x after MCM_Sqrt",
+        (unsigned)READ_REG(CORDIC->CSR));
+
+  LL_CORDIC_WriteData(CORDIC, ((uint32_t)0x7FFF0000) + ((uint32_t)(uint16_t)angle));
+  const uint32_t r = LL_CORDIC_ReadData(CORDIC);
+  CHECK((int16_t)r == ref.hCos && (int16_t)(r >> 16) == ref.hSin, "cos/sin %d/%d after the roots, %d/%d before",
+        (int16_t)r, (int16_t)(r >> 16), ref.hCos, ref.hSin);
+}
+
+static void test_primask(void)
+{
+  host_primask = 1u;
+  int32_t r = MCM_Sqrt(1000000);
+  CHECK(host_primask == 1u, "MCM_Sqrt unmasked interrupts of a masked caller");
+  host_primask = 0u;
+  r += MCM_Sqrt(1000000);
+  CHECK(host_primask == 0u, "MCM_Sqrt left interrupts masked");
+  CHECK(r == 2000, "sqrt(1e6) = %ld", (long)(r / 2));
+  CHECK(MCM_Sqrt(0) == 0 && MCM_Sqrt(-5) == 0, "non-positive input");
+}
+
+int main(void)
+{
+  test_grid();
+  test_shared_csr();
+  test_primask();
+
+  return test_exit("test_circle_lim");
+}
@@ -0,0 +1,324 @@
+/* Host test for the CORDIC DMA batch (plat/cordic_batch.c).
+ *
+ * host_cordic_dma_service() moves one word per call between the CORDIC model
+ * and the DMA2 channels, so the test decides where a job stands when a CPU
+ * user claims the CORDIC: between elements, after the first argument of a
+ * two-argument element, with one of two result words read, or with the last
+ * element still in the CORDIC. Between random runs of DMA words the CPU users
+ * (MCM_Trig_Functions, MCM_Sqrt, MCM_Modulus, MCM_PhaseComputation) run inside
+ * a claim, sometimes nested. Every job must give the outputs of the register
+ * path element by element, the CPU users their own results, and the callback
+ * exactly one call.
+ *
+ * Also: argument checks, busy, start while claimed, abort, PRIMASK.
+ * Buffers handed to the DMA are static: CMAR is 32 bits (-no-pie image).
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "mc_type.h"
+#include "mc_math.h"
+#include "cordic_batch.h"
+#include "test_util.h"
+
+#define MAX_N          256u
+#define JOBS           300
+
+extern volatile uint32_t host_primask;
+
+/* sin/cos 32-bit, two results per element: the bench configuration */
+#define CSR_SINCOS_32  0x00080060u
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t rnd(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (uint32_t)(rng_state >> 16);
+}
+
+static int32_t in[MAX_N * 2u];
+static int32_t out[MAX_N * 2u];
+static int32_t ref[MAX_N * 2u];
+
+static struct {
+  uint32_t calls;
+  cordic_batch_status_t status;
+  const void *ctx;
+} cb;
+
+static void on_done(const cordic_batch_job_t *job, cordic_batch_status_t status)
+{
+  cb.calls++;
+  cb.status = status;
+  cb.ctx = job->ctx;
+}
+
+static uint32_t nargs_of(uint32_t csr)
+{
+  return (((csr & CORDIC_CSR_ARGSIZE) == 0u) && ((csr & CORDIC_CSR_NARGS) != 0u)) ? 2u : 1u;
+}
+
+static uint32_t nres_of(uint32_t csr)
+{
+  return (((csr & CORDIC_CSR_RESSIZE) == 0u) && ((csr & CORDIC_CSR_NRES) != 0u)) ? 2u : 1u;
+}
+
+/* Random inputs for csr and the register-path results in ref[]. 32-bit cos/sin with one
+ * argument: the batch uses modulus 1, the reference writes it as a second argument */
+static void make_job(cordic_batch_job_t *job, uint32_t csr, uint32_t n)
+{
+  const uint32_t wi = nargs_of(csr), wo = nres_of(csr);
+  const uint32_t func = csr & CORDIC_CSR_FUNC;
+  const int m1 = ((csr & (CORDIC_CSR_ARGSIZE | CORDIC_CSR_NARGS)) == 0u) &&
+                 ((func == LL_CORDIC_FUNCTION_COSINE) || (func == LL_CORDIC_FUNCTION_SINE));
+  for (uint32_t i = 0u; i < n * wi; i++) {
+    in[i] = (int32_t)rnd();
+    if ((csr & CORDIC_CSR_ARGSIZE) != 0u) {
+      in[i] = (int32_t)((rnd() & 0xFFFFu) | 0x7FFF0000u);        /* angle | modulus 1 */
+    } else if (wi == 2u) {
+      in[i] >>= 2;                                                 /* x, y of PHASE */
+    }
+  }
+  WRITE_REG(CORDIC->CSR, m1 ? (csr | CORDIC_CSR_NARGS) : csr);
+  for (uint32_t i = 0u; i < n; i++) {
+    for (uint32_t k = 0u; k < wi; k++) {
+      LL_CORDIC_WriteData(CORDIC, (uint32_t)in[(i * wi) + k]);
+    }
+    if (m1) {
+      LL_CORDIC_WriteData(CORDIC, 0x7FFFFFFFu);
+    }
+    for (uint32_t k = 0u; k < wo; k++) {
+      ref[(i * wo) + k] = (int32_t)LL_CORDIC_ReadData(CORDIC);
+    }
+  }
+  memset(out, 0x55, sizeof(out));
+  memset(&cb, 0, sizeof(cb));
+  *job = (cordic_batch_job_t){ .csr = csr, .in = in, .out = out, .n = n, .done = on_done, .ctx = &cb };
+}
+
+static uint32_t mismatches(uint32_t csr, uint32_t n)
+{
+  uint32_t bad = 0u;
+  for (uint32_t i = 0u; i < n * nres_of(csr); i++) {
+    bad += (out[i] != ref[i]);
+  }
+  return bad;
+}
+
+/* DMA words until the transfer stops, then the completion interrupt */
+static void run_to_end(void)
+{
+  while (host_cordic_dma_service() != 0u) {
+  }
+  cordic_batch_dma_irq();
+}
+
+static void test_whole_jobs(void)
+{
+  static const uint32_t csrs[] = { CSR_SINCOS_32, CORDIC_CONFIG_PHASE, CORDIC_CONFIG_COSINE, CORDIC_CONFIG_SQRT };
+  cordic_batch_job_t job;
+
+  for (size_t c = 0u; c < (sizeof(csrs) / sizeof(csrs[0])); c++) {
+    make_job(&job, csrs[c], MAX_N);
+    CHECK(cordic_batch_start(&job) == 0, "csr 0x%08x: start refused", (unsigned)csrs[c]);
+    run_to_end();
+    CHECK(!cordic_batch_busy(), "csr 0x%08x: still busy", (unsigned)csrs[c]);
+    CHECK(cb.calls == 1u && cb.status == CORDIC_BATCH_OK && cb.ctx == &cb, "csr 0x%08x: %u callbacks, status %d",
+          (unsigned)csrs[c], cb.calls, (int)cb.status);
+    const uint32_t bad = mismatches(csrs[c], MAX_N);
+    CHECK(bad == 0u, "csr 0x%08x: %u words differ from the register path", (unsigned)csrs[c], bad);
+    CHECK((READ_REG(CORDIC->CSR) & (CORDIC_CSR_DMAREN | CORDIC_CSR_DMAWEN)) == 0u, "DMA requests left enabled");
+  }
+}
+
+/* CPU users with inputs and expected results taken while no batch ran */
+#define USERS 16u
+static int16_t u_angle[USERS];
+static int32_t u_sqrt[USERS];
+static int16_t u_ab[USERS][2];
+static int32_t u_bemf[USERS][2];
+static Trig_Components e_trig[USERS];
+static int32_t e_sqrt[USERS];
+static int16_t e_mod[USERS];
+static int16_t e_phase[USERS];
+
+static void users_setup(void)
+{
+  for (uint32_t i = 0u; i < USERS; i++) {
+    u_angle[i] = (int16_t)rnd();
+    u_sqrt[i] = (int32_t)(rnd() >> 1);
+    u_ab[i][0] = (int16_t)((int16_t)rnd() / 2);
+    u_ab[i][1] = (int16_t)((int16_t)rnd() / 2);
+    u_bemf[i][0] = (int32_t)rnd() >> 2;
+    u_bemf[i][1] = (int32_t)rnd() >> 2;
+    e_trig[i] = MCM_Trig_Functions(u_angle[i]);
+    e_sqrt[i] = MCM_Sqrt(u_sqrt[i]);
+    e_mod[i] = MCM_Modulus(u_ab[i][0], u_ab[i][1]);
+    e_phase[i] = MCM_PhaseComputation(u_bemf[i][0], u_bemf[i][1]);
+  }
+}
+
+static uint32_t user_bad;
+
+static void cpu_user(void)
+{
+  const uint32_t i = rnd() % USERS;
+  switch (rnd() % 4u) {
+    case 0u: {
+      const Trig_Components t = MCM_Trig_Functions(u_angle[i]);
+      user_bad += (t.hCos != e_trig[i].hCos) || (t.hSin != e_trig[i].hSin);
+      break;
+    }
+    case 1u:
+      user_bad += (MCM_Sqrt(u_sqrt[i]) != e_sqrt[i]);
+      break;
+    case 2u:
+      user_bad += (MCM_Modulus(u_ab[i][0], u_ab[i][1]) != e_mod[i]);
+      break;
+    default:
+      user_bad += (MCM_PhaseComputation(u_bemf[i][0], u_bemf[i][1]) != e_phase[i]);
+      break;
+  }
+}
+
+static void test_interleaved(void)
+{
+  static const uint32_t csrs[] = { CSR_SINCOS_32, CORDIC_CONFIG_PHASE, CORDIC_CONFIG_COSINE };
+  uint32_t half_args = 0u, half_res = 0u, last_in_pause = 0u;
+  cordic_batch_stats_t s0, s1;
+  cordic_batch_job_t job;
+
+  users_setup();
+  cordic_batch_get_stats(&s0);
+  for (int j = 0; j < JOBS; j++) {
+    const uint32_t csr = csrs[rnd() % 3u];
+    const uint32_t n = 1u + (rnd() % 40u);
+    make_job(&job, csr, n);
+    CHECK(cordic_batch_start(&job) == 0, "job %d: start refused", j);
+
+    for (int guard = 0; cordic_batch_busy() && (guard < 100000); guard++) {
+      const uint32_t words = rnd() % 6u;
+      uint32_t moved = 0u;
+      for (uint32_t k = 0u; k < words; k++) {
+        moved += host_cordic_dma_service();
+      }
+      if ((words != 0u) && (moved == 0u)) {
+        cordic_batch_dma_irq();                   /* transfer complete: the DMA2 Ch2 interrupt */
+        continue;
+      }
+
+      half_args += ((DMA2_Channel1->CNDTR % nargs_of(csr)) != 0u);
+      half_res += ((DMA2_Channel2->CNDTR % nres_of(csr)) != 0u);
+      cordic_batch_claim();
+      cpu_user();
+      if ((rnd() % 4u) == 0u) {
+        /* A higher priority user nested in the first one (HF task in MF code) */
+        cordic_batch_claim();
+        cpu_user();
+        cordic_batch_release();
+      }
+      cordic_batch_release();
+
+      if (cordic_batch_state == CORDIC_BATCH_DONE) {
+        /* The claim read the last result: no TC will come, resume pended the interrupt */
+        CHECK(NVIC_GetPendingIRQ(DMA2_Channel2_IRQn) != 0u, "job %d: completion interrupt not pended", j);
+        NVIC->ISPR[((uint32_t)DMA2_Channel2_IRQn) >> 5] = 0u;
+        last_in_pause++;
+        cordic_batch_dma_irq();
+      }
+    }
+    CHECK(!cordic_batch_busy(), "job %d: never completed", j);
+    CHECK(cb.calls == 1u && cb.status == CORDIC_BATCH_OK, "job %d: %u callbacks, status %d", j, cb.calls,
+          (int)cb.status);
+    const uint32_t bad = mismatches(csr, n);
+    if (bad != 0u) {
+      CHECK(0, "job %d (csr 0x%08x, n %u): %u words differ", j, (unsigned)csr, n, bad);
+      break;
+    }
+  }
+  cordic_batch_get_stats(&s1);
+  CHECK(user_bad == 0u, "%u CPU user results differ", user_bad);
+  CHECK(s1.jobs - s0.jobs == (uint32_t)JOBS, "%u jobs completed", s1.jobs - s0.jobs);
+  /* The stepping must reach the element-boundary cases, otherwise it proves little */
+  CHECK(half_args > 0u && half_res > 0u && last_in_pause > 0u,
+        "claims with half arguments %u, half results %u, last element in the claim %u", half_args, half_res,
+        last_in_pause);
+  printf("%d jobs, %u pauses, claims with half arguments %u / half results %u, last element in the claim %u\n",
+         JOBS, s1.pauses - s0.pauses, half_args, half_res, last_in_pause);
+}
+
+static void test_api(void)
+{
+  cordic_batch_job_t job;
+  make_job(&job, CSR_SINCOS_32, 100u);
+
+  cordic_batch_job_t bad = job;
+  bad.n = 0u;
+  CHECK(cordic_batch_start(&bad) == -2, "n = 0 accepted");
+  bad = job;
+  bad.out = NULL;
+  CHECK(cordic_batch_start(&bad) == -2, "NULL out accepted");
+  bad = job;
+  bad.csr |= CORDIC_CSR_DMAREN;
+  CHECK(cordic_batch_start(&bad) == -2, "csr with DMAREN accepted");
+  bad = job;
+  bad.n = (CORDIC_BATCH_MAX_WORDS / 2u) + 1u;
+  CHECK(cordic_batch_start(&bad) == -2, "n over the CNDTR range accepted");
+  CHECK(cordic_batch_start(NULL) == -2, "NULL job accepted");
+
+  /* Start while a CPU user holds the CORDIC: nothing moves until the release */
+  host_primask = 0u;
+  cordic_batch_claim();
+  CHECK(host_primask == 0u, "claim left interrupts masked");
+  CHECK(cordic_batch_start(&job) == 0, "start refused");
+  CHECK(cordic_batch_start(&job) == -1, "second start accepted");
+  CHECK(host_cordic_dma_service() == 0u, "DMA ran while claimed");
+  host_primask = 1u;
+  cordic_batch_release();
+  CHECK(host_primask == 1u, "release unmasked interrupts of a masked caller");
+  host_primask = 0u;
+  run_to_end();
+  CHECK(cb.calls == 1u && cb.status == CORDIC_BATCH_OK && mismatches(CSR_SINCOS_32, 100u) == 0u,
+        "start while claimed: %u callbacks, status %d", cb.calls, (int)cb.status);
+
+  /* Abort mid-job: one ABORTED callback, the CORDIC is usable right away */
+  cordic_batch_stats_t s0, s1;
+  cordic_batch_get_stats(&s0);
+  make_job(&job, CORDIC_CONFIG_PHASE, 100u);
+  const Trig_Components t0 = MCM_Trig_Functions(1234);
+  CHECK(cordic_batch_start(&job) == 0, "start refused");
+  for (int k = 0; k < 51; k++) {
+    (void)host_cordic_dma_service();
+  }
+  cordic_batch_abort();
+  CHECK(!cordic_batch_busy() && cb.calls == 1u && cb.status == CORDIC_BATCH_ABORTED,
+        "abort: busy %d, %u callbacks, status %d", (int)cordic_batch_busy(), cb.calls, (int)cb.status);
+  CHECK(host_cordic_dma_service() == 0u, "DMA ran after abort");
+  const Trig_Components t1 = MCM_Trig_Functions(1234);
+  CHECK(t0.hCos == t1.hCos && t0.hSin == t1.hSin, "cos/sin after abort %d/%d, %d/%d before", t1.hCos, t1.hSin,
+        t0.hCos, t0.hSin);
+  cordic_batch_abort();
+  cordic_batch_dma_irq();
+  CHECK(cb.calls == 1u, "abort or interrupt on an idle batch called back");
+  cordic_batch_get_stats(&s1);
+  CHECK(s1.aborts == s0.aborts + 1u && s1.jobs == s0.jobs, "stats: aborts %u -> %u, jobs %u -> %u", s0.aborts,
+        s1.aborts, s0.jobs, s1.jobs);
+  CHECK(cordic_batch_claims == 0u, "claims left at %u", (unsigned)cordic_batch_claims);
+}
+
+int main(void)
+{
+  cordic_batch_init();
+
+  test_whole_jobs();
+  test_interleaved();
+  test_api();
+
+  return test_exit("test_cordic_batch");
+}
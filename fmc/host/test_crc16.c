@@ -0,0 +1,178 @@
+/* Host test + benchmark for plat/crc16.c (ASPEP data CRC).
+ *
+ *   test_crc16            correctness only
+ *   test_crc16 --bench    also time bytewise vs slice-by-8 over ASPEP-sized buffers
+ *
+ * The firmware's HW path cannot run here, so it is checked through a bit-level
+ * model of the G474 CRC unit (MSB-first engine, REV_IN by byte, REV_OUT) fed
+ * exactly the way crc16_hw() feeds it: byte writes up to alignment, __REV'd
+ * words, byte writes for the tail. On target, "bench run crc_hw" times the
+ * real unit and checks it against slice-by-8.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc16.h"
+#include "test_util.h"
+
+/* ── CRC unit model (RM0440 CRC, POLYSIZE=16) ── */
+typedef struct {
+  uint16_t state;
+} crc_unit_t;
+
+static uint32_t rev_bits(uint32_t v, int nbits)
+{
+  uint32_t r = 0;
+  for (int i = 0; i < nbits; i++) {
+    r = (r << 1) | ((v >> i) & 1u);
+  }
+  return r;
+}
+
+/* REV_IN=01: bits reversed inside each byte, then processed MSB first */
+static void unit_write(crc_unit_t *u, uint32_t data, int nbytes)
+{
+  uint32_t in = 0;
+  for (int b = 0; b < nbytes; b++) {
+    in |= rev_bits((data >> (8 * b)) & 0xFFu, 8) << (8 * b);
+  }
+  for (int i = 8 * nbytes - 1; i >= 0; i--) {
+    uint32_t fb = ((u->state >> 15) ^ (in >> i)) & 1u;
+    u->state = (uint16_t)(u->state << 1);
+    if (fb) u->state ^= 0x8005u;
+  }
+}
+
+/* __REV */
+static uint32_t bswap32(uint32_t w)
+{
+  return ((w & 0xFFu) << 24) | ((w & 0xFF00u) << 8) | ((w >> 8) & 0xFF00u) | (w >> 24);
+}
+
+static uint16_t crc_unit_model(const uint8_t *data, size_t len)
+{
+  crc_unit_t u = { CRC16_INIT };
+  while ((len != 0) && (((uintptr_t)data & 3u) != 0)) {
+    unit_write(&u, *data++, 1);
+    len--;
+  }
+  for (; len >= 4; len -= 4, data += 4) {
+    uint32_t w;
+    memcpy(&w, data, 4);
+    unit_write(&u, bswap32(w), 4);
+  }
+  for (; len != 0; len--) {
+    unit_write(&u, *data++, 1);
+  }
+  return (uint16_t)rev_bits(u.state, 16);   /* REV_OUT */
+}
+
+/* Straight bitwise CRC-16/MODBUS, independent of the tables */
+static uint16_t crc_bitwise(const uint8_t *p, size_t n)
+{
+  uint16_t c = CRC16_INIT;
+  for (size_t i = 0; i < n; i++) {
+    c ^= p[i];
+    for (int k = 0; k < 8; k++) c = (c & 1u) ? (uint16_t)((c >> 1) ^ CRC16_POLY_REFLECTED) : (uint16_t)(c >> 1);
+  }
+  return c;
+}
+
+static uint32_t lcg = 12345u;
+static uint8_t rnd8(void)
+{
+  lcg = lcg * 1664525u + 1013904223u;
+  return (uint8_t)(lcg >> 24);
+}
+
+#define BUF_MAX  2304   /* > MCP_TX_ASYNCBUFFER_SIZE_A */
+
+static void test_known_values(void)
+{
+  const uint8_t check[] = "123456789";
+  CHECK(crc16(check, 9) == CRC16_CHECK, "check value 0x%04x", crc16(check, 9));
+  CHECK(crc16_sw_bytewise(CRC16_INIT, check, 9) == CRC16_CHECK, "bytewise check value");
+  CHECK(crc_unit_model(check, 9) == CRC16_CHECK, "unit model check value 0x%04x", crc_unit_model(check, 9));
+  CHECK(crc16(check, 0) == CRC16_INIT, "empty buffer");
+}
+
+static void test_random(void)
+{
+  static uint8_t raw[BUF_MAX + 8];
+  for (int iter = 0; iter < 2000; iter++) {
+    size_t off = (size_t)(iter & 7);
+    size_t len = (iter < 64) ? (size_t)iter : (size_t)(rnd8() | (rnd8() << 8)) % (BUF_MAX - 2);
+    uint8_t *p = raw + off;
+    for (size_t i = 0; i < len; i++) p[i] = rnd8();
+
+    uint16_t ref = crc_bitwise(p, len);
+    uint16_t sb8 = crc16_sw(CRC16_INIT, p, len);
+    uint16_t byt = crc16_sw_bytewise(CRC16_INIT, p, len);
+    uint16_t hw  = crc_unit_model(p, len);
+    CHECK(sb8 == ref, "slice-by-8 len=%zu off=%zu: %04x != %04x", len, off, sb8, ref);
+    CHECK(byt == ref, "bytewise len=%zu: %04x != %04x", len, byt, ref);
+    CHECK(hw == ref, "unit model len=%zu off=%zu: %04x != %04x", len, off, hw, ref);
+
+    /* the same split into two calls (incremental use) */
+    size_t cut = len / 3;
+    CHECK(crc16_sw(crc16_sw(CRC16_INIT, p, cut), p + cut, len - cut) == ref, "incremental len=%zu", len);
+
+    /* ASPEP framing: CRC appended LSB first, receiver sees residue 0 */
+    p[len] = (uint8_t)(ref & 0xFFu);
+    p[len + 1] = (uint8_t)(ref >> 8);
+    CHECK(crc16(p, len + 2) == 0, "residue len=%zu", len);
+    if (len > 0) {
+      p[rnd8() % len] ^= (uint8_t)(1u << (rnd8() & 7));
+      CHECK(crc16(p, len + 2) != 0, "single bit flip not detected len=%zu", len);
+    }
+  }
+}
+
+static double now_s(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static volatile uint16_t sink;
+
+static void bench(void)
+{
+  static uint8_t buf[BUF_MAX];
+  static const size_t sizes[] = { 16, 64, 256, 2048 };
+  for (size_t i = 0; i < sizeof(buf); i++) buf[i] = rnd8();
+
+  printf("%-10s %6s %12s %12s %8s\n", "impl", "bytes", "ns/packet", "ns/byte", "speedup");
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    size_t n = sizes[s];
+    long reps = (long)(40000000 / n);
+    double t[2];
+    for (int impl = 0; impl < 2; impl++) {
+      double t0 = now_s();
+      for (long r = 0; r < reps; r++) {
+        buf[0] = (uint8_t)r;
+        sink = (impl == 0) ? crc16_sw_bytewise(CRC16_INIT, buf, n) : crc16_sw(CRC16_INIT, buf, n);
+      }
+      t[impl] = (now_s() - t0) / (double)reps;
+    }
+    printf("%-10s %6zu %12.1f %12.3f %8s\n", "bytewise", n, t[0] * 1e9, t[0] * 1e9 / (double)n, "1.00");
+    printf("%-10s %6zu %12.1f %12.3f %8.2f\n", "slice8", n, t[1] * 1e9, t[1] * 1e9 / (double)n, t[0] / t[1]);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  crc16_init();
+  test_known_values();
+  test_random();
+
+  if ((argc > 1) && (strcmp(argv[1], "--bench") == 0)) {
+    bench();
+  }
+
+  return test_exit("test_crc16");
+}
@@ -0,0 +1,154 @@
+/* Host test for the dual-drive build (NBR_OF_MOTORS=2).
+ *
+ * Each PWM period is replayed the way the two timers interleave on the target:
+ * TIM1 update queues M1 in the motor FIFO (TSK_DualDriveFIFOUpdate), the ADC end
+ * of conversion runs TSK_HighFrequencyTask, then half a period later the same for
+ * TIM8 / M2. Each motor drives its own PMSM plant. Checks that the FIFO serves
+ * the motors in the queued order, that both drives reach RUN and track their own
+ * speed targets, that a fault on M2 leaves M1 running, and that hf_prof counts
+ * one FOC_HighFrequencyTask per motor per period.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "main.h"
+#include "mc_type.h"
+#include "mc_config.h"
+#include "mc_tasks.h"
+#include "mc_api.h"
+#include "mc_interface.h"
+#include "parameters_conversion.h"
+#include "hf_prof.h"
+#include "host_periph.h"
+#include "host_pwm.h"
+#include "pmsm_plant.h"
+#include "test_util.h"
+
+#if (NBR_OF_MOTORS != 2)
+#error "test_dual_drive needs NBR_OF_MOTORS=2"
+#endif
+
+#define SIM_TICK_DIV    ((uint32_t)(PWM_FREQUENCY / SYS_TICK_FREQUENCY))
+
+MCI_Handle_t *pMCI[NBR_OF_MOTORS];
+
+static pmsm_params_t prm;
+static pmsm_state_t plant[NBR_OF_MOTORS];
+static uint32_t order_errors;
+
+/* One PWM period of both drives, M1 half first */
+static void step(uint64_t k)
+{
+  double duty[3];
+
+  for (uint8_t m = M1; m < NBR_OF_MOTORS; m++) {
+    TSK_DualDriveFIFOUpdate(m);
+    host_pwm_sample_motor(m, plant[m].i_abc);
+    if (TSK_HighFrequencyTask() != m) {
+      order_errors++;
+    }
+  }
+  for (uint8_t m = M1; m < NBR_OF_MOTORS; m++) {
+    const bool on = host_pwm_get_duty_motor(m, duty);
+    pmsm_step(&prm, &plant[m], duty, on);
+  }
+  if ((k % SIM_TICK_DIV) == (SIM_TICK_DIV - 1u)) {
+    MC_RunMotorControlTasks();
+  }
+}
+
+static void run(double seconds)
+{
+  static uint64_t k;
+  const uint64_t n = (uint64_t)(seconds * PWM_FREQUENCY);
+  for (uint64_t i = 0u; i < n; i++, k++) {
+    step(k);
+  }
+}
+
+static double speed_rpm(uint8_t m)
+{
+  return pmsm_speed_rpm(&prm, &plant[m]);
+}
+
+static void test_start_both(void)
+{
+  (void)MC_StartMotor1();
+  (void)MC_StartMotor2();
+  /* Rev-up ends ~2.2 s after the start command (same as fmc_sim) */
+  run(3.0);
+
+  CHECK(order_errors == 0u, "FIFO served the wrong motor %u times", order_errors);
+  CHECK(MC_GetSTMStateMotor1() == RUN, "M1 state %d, faults 0x%04x", (int)MC_GetSTMStateMotor1(),
+        MC_GetOccurredFaultsMotor1());
+  CHECK(MC_GetSTMStateMotor2() == RUN, "M2 state %d, faults 0x%04x", (int)MC_GetSTMStateMotor2(),
+        MC_GetOccurredFaultsMotor2());
+
+  /* Different targets: a shared handle or a crossed FIFO would pull them together */
+  const double target1 = (double)DEFAULT_TARGET_SPEED_RPM;
+  const double target2 = 0.6 * (double)DEFAULT_TARGET_SPEED_RPM;
+  MC_ProgramSpeedRampMotor1((int16_t)(target1 * SPEED_UNIT / U_RPM), 500u);
+  MC_ProgramSpeedRampMotor2((int16_t)(target2 * SPEED_UNIT / U_RPM), 500u);
+  run(2.0);
+
+  CHECK(fabs(speed_rpm(M1) - target1) < 0.1 * target1, "M1 plant %.1f rpm, target %.0f", speed_rpm(M1), target1);
+  CHECK(fabs(speed_rpm(M2) - target2) < 0.1 * target2, "M2 plant %.1f rpm, target %.0f", speed_rpm(M2), target2);
+  const double obs2 = (double)SPEED_UNIT_2_RPM(MC_GetMecSpeedAverageMotor2());
+  CHECK(fabs(obs2 - target2) < 0.1 * target2, "M2 observer %.1f rpm, target %.0f", obs2, target2);
+  printf("M1 %.1f rpm (target %.0f), M2 %.1f rpm (target %.0f)\n", speed_rpm(M1), target1, speed_rpm(M2), target2);
+}
+
+static void test_hf_prof_per_motor(void)
+{
+  hf_prof_clear();
+  run(0.25);
+
+  const uint32_t n = (uint32_t)(0.25 * PWM_FREQUENCY);
+  const uint32_t n1 = hf_prof.stage[HF_PROF_HF_M1].count;
+  const uint32_t n2 = hf_prof.stage[HF_PROF_HF_M2].count;
+  CHECK((n1 == n) && (n2 == n), "hf_m1 %u, hf_m2 %u, want %u each", n1, n2, n);
+  /* each motor's current loop and observer land in its own slots */
+  CHECK(hf_prof.stage[HF_PROF_CURR_CTRL].count == n1 && hf_prof.stage[HF_PROF_CURR_CTRL_M2].count == n2,
+        "curr_ctrl %u / %u, want %u / %u", hf_prof.stage[HF_PROF_CURR_CTRL].count,
+        hf_prof.stage[HF_PROF_CURR_CTRL_M2].count, n1, n2);
+  CHECK(hf_prof.stage[HF_PROF_STO_PLL].count == n1 && hf_prof.stage[HF_PROF_STO_PLL_M2].count == n2,
+        "sto_pll %u / %u, want %u / %u", hf_prof.stage[HF_PROF_STO_PLL].count,
+        hf_prof.stage[HF_PROF_STO_PLL_M2].count, n1, n2);
+  CHECK(hf_prof.margin[M1].count == n && hf_prof.margin[M2].count == n, "deadline marks %u / %u",
+        hf_prof.margin[M1].count, hf_prof.margin[M2].count);
+}
+
+static void test_fault_isolation(void)
+{
+  /* MC_DURATION on M2 only: M2 faults, M1 keeps running */
+  host_pwm_motor[M2].inject_duration = 1u;
+  run(0.1);
+
+  CHECK((MC_GetOccurredFaultsMotor2() & MC_DURATION) != 0u, "M2 faults 0x%04x", MC_GetOccurredFaultsMotor2());
+  CHECK(MC_GetSTMStateMotor2() == FAULT_OVER, "M2 state %d", (int)MC_GetSTMStateMotor2());
+  CHECK(MC_GetSTMStateMotor1() == RUN, "M1 state %d", (int)MC_GetSTMStateMotor1());
+  CHECK(MC_GetOccurredFaultsMotor1() == 0u, "M1 faults 0x%04x", MC_GetOccurredFaultsMotor1());
+  CHECK(hf_prof.margin[M2].duration_faults == 1u && hf_prof.margin[M1].duration_faults == 0u,
+        "MC_DURATION hits M1 %u, M2 %u", hf_prof.margin[M1].duration_faults, hf_prof.margin[M2].duration_faults);
+  CHECK(order_errors == 0u, "FIFO served the wrong motor %u times", order_errors);
+}
+
+int main(void)
+{
+  host_periph_init();
+  pmsm_default_params(&prm);
+  for (uint8_t m = M1; m < NBR_OF_MOTORS; m++) {
+    pmsm_reset(&plant[m]);
+  }
+  host_periph_set_vbus(prm.vbus);
+
+  MCboot(pMCI);
+  CHECK((pMCI[M1] == &Mci[M1]) && (pMCI[M2] == &Mci[M2]), "MCboot must fill both interfaces");
+
+  test_start_both();
+  test_hf_prof_per_motor();
+  test_fault_isolation();
+
+  return test_exit("test_dual_drive");
+}
@@ -0,0 +1,173 @@
+/* Host test for the fault black box (plat/fault_rec.c).
+ *
+ * Runs M1 to RUN with the recorder armed, then makes one HF task return
+ * MC_DURATION (host_pwm inject_duration). MCI_FaultProcessing must freeze the
+ * window with the MC_DURATION tick as its last record; later ticks and the
+ * faults that follow must not move it. A reset is emulated by calling
+ * fault_rec_init() again (the .noinit data is simply left in place): the
+ * window is kept and its reset count goes up, a corrupted header re-arms.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "mc_type.h"
+#include "mc_config.h"
+#include "mc_tasks.h"
+#include "mc_api.h"
+#include "mc_interface.h"
+#include "parameters_conversion.h"
+#include "fault_rec.h"
+#include "host_periph.h"
+#include "host_pwm.h"
+#include "test_sim.h"
+#include "test_util.h"
+
+#if (FAULT_REC_ENABLE != 1)
+#error "test_fault_rec needs FAULT_REC_ENABLE=1"
+#endif
+
+static void test_recording(void)
+{
+  fault_rec_status_t st;
+
+  fault_rec_init();
+  fault_rec_get_status(&st);
+  CHECK(st.armed == 1u && st.frozen == 0u && st.count == 0u, "power-up: armed %u frozen %u count %u", st.armed,
+        st.frozen, (unsigned)st.count);
+
+  (void)MC_StartMotor1();
+  test_sim_run(3.0);
+  CHECK(MC_GetSTMStateMotor1() == RUN, "state %d, faults 0x%04x", (int)MC_GetSTMStateMotor1(),
+        MC_GetOccurredFaultsMotor1());
+
+  fault_rec_get_status(&st);
+  CHECK(st.armed == 1u && st.count == FAULT_REC_RECORDS, "recording: armed %u count %u", st.armed,
+        (unsigned)st.count);
+  fault_rec_rec_t r;
+  CHECK(!fault_rec_get(0u, &r), "window readable while recording");
+}
+
+static void test_freeze(void)
+{
+  fault_rec_status_t st;
+  fault_rec_rec_t r;
+
+  host_pwm.inject_duration = 1u;
+  for (uint32_t i = 0u; (i < 10u) && (host_pwm.duration_faults == 0u); i++) {
+    test_sim_step();
+  }
+  CHECK(host_pwm.duration_faults == 1u, "MC_DURATION not injected");
+
+  fault_rec_get_status(&st);
+  CHECK(st.armed == 0u && st.frozen == 1u, "after MC_DURATION: armed %u frozen %u", st.armed, st.frozen);
+  CHECK(st.hdr.faults == MC_DURATION && st.hdr.source == FAULT_REC_SRC_MCI && st.hdr.motor == 0u,
+        "header faults 0x%04x source %u motor %u", st.hdr.faults, st.hdr.source, st.hdr.motor);
+  CHECK(st.hdr.state == RUN, "header state %u", st.hdr.state);
+  CHECK(st.count == FAULT_REC_RECORDS && st.hdr.boots == 0u, "count %u boots %u", (unsigned)st.count,
+        st.hdr.boots);
+
+  /* Last record is the MC_DURATION tick, everything before is a clean RUN */
+  CHECK(fault_rec_get(st.count - 1u, &r), "last record");
+  CHECK(r.flags == FAULT_REC_F_DURATION && r.state == RUN && r.faults == 0u, "last: flags %u state %u faults 0x%04x",
+        r.flags, r.state, r.faults);
+  CHECK(!fault_rec_get(st.count, &r), "record past the window");
+
+  uint32_t bad = 0u;
+  int32_t max_step = 0;
+  fault_rec_rec_t prev;
+  for (uint32_t i = 0u; i + 1u < st.count; i++) {
+    CHECK(fault_rec_get(i, &r), "record %u", (unsigned)i);
+    if ((r.flags != 0u) || (r.state != RUN) || (r.faults != 0u) || (r.vbus == 0u)) {
+      bad++;
+    }
+    /* Consecutive ticks: the observer angle moves by about one tick of its own speed */
+    if (i > 0u) {
+      const int32_t d = (int16_t)(r.obs_angle - prev.obs_angle) - prev.obs_speed;
+      if (abs(d) > max_step) {
+        max_step = abs(d);
+      }
+    }
+    prev = r;
+  }
+  CHECK(bad == 0u, "%u records before the fault not clean", (unsigned)bad);
+  CHECK(max_step < 64, "observer angle steps off its speed by %d", (int)max_step);
+  printf("frozen: %u records of %u written, iq %d vq %d speed %d dpp, angle step error %d\n", (unsigned)st.count,
+         (unsigned)st.hdr.written, r.iq, r.vq, r.obs_speed, (int)max_step);
+
+  /* The fault stays raised and the drive goes to FAULT_NOW: the window must not move */
+  const fault_rec_hdr_t h = st.hdr;
+  fault_rec_rec_t last;
+  (void)fault_rec_get(st.count - 1u, &last);
+  test_sim_run(0.2);
+  fault_rec_get_status(&st);
+  CHECK(st.frozen == 1u && memcmp(&st.hdr, &h, sizeof(h)) == 0, "header changed after freeze");
+  CHECK(fault_rec_get(st.count - 1u, &r) && memcmp(&r, &last, sizeof(r)) == 0, "window moved after freeze");
+  CHECK(MC_GetSTMStateMotor1() == FAULT_NOW || MC_GetSTMStateMotor1() == FAULT_OVER, "state %d",
+        (int)MC_GetSTMStateMotor1());
+}
+
+static void test_dump(void)
+{
+  fault_rec_status_t st;
+  fault_rec_hdr_t h;
+  fault_rec_rec_t r, ref;
+
+  fault_rec_get_status(&st);
+  fault_rec_dump_start();
+  CHECK(fault_rec_dump_next(&h, &r) == 1u && memcmp(&h, &st.hdr, sizeof(h)) == 0, "dump header");
+  uint32_t n = 0u;
+  while (fault_rec_dump_next(&h, &r) == 2u) {
+    CHECK(fault_rec_get(n, &ref) && memcmp(&r, &ref, sizeof(r)) == 0, "dump record %u", (unsigned)n);
+    n++;
+  }
+  CHECK(n == st.count, "dumped %u records, window %u", (unsigned)n, (unsigned)st.count);
+  CHECK(fault_rec_dump_next(&h, &r) == 0u, "dump restarted by itself");
+}
+
+static void test_reset(void)
+{
+  fault_rec_status_t before, st;
+  fault_rec_rec_t r0, r;
+
+  fault_rec_get_status(&before);
+  (void)fault_rec_get(0u, &r0);
+
+  /* Two resets: window kept, not recording, reset count in the header */
+  fault_rec_init();
+  fault_rec_init();
+  fault_rec_get_status(&st);
+  CHECK(st.frozen == 1u && st.armed == 0u && st.hdr.boots == 2u, "after reset: frozen %u armed %u boots %u",
+        st.frozen, st.armed, st.hdr.boots);
+  CHECK(st.hdr.written == before.hdr.written && st.hdr.faults == before.hdr.faults, "header lost over reset");
+  CHECK(fault_rec_get(0u, &r) && memcmp(&r, &r0, sizeof(r)) == 0, "window lost over reset");
+
+  /* Power-up garbage: one flipped bit and the header does not check */
+  fault_rec_hdr.faults ^= 0x0100u;
+  fault_rec_init();
+  fault_rec_get_status(&st);
+  CHECK(st.armed == 1u && st.frozen == 0u && st.count == 0u, "corrupted header: armed %u frozen %u count %u",
+        st.armed, st.frozen, (unsigned)st.count);
+
+  /* "frec clear" on a frozen window */
+  fault_rec_freeze(&Mci[M1], MC_OVER_VOLT, FAULT_REC_SRC_BRK);
+  fault_rec_get_status(&st);
+  CHECK(st.frozen == 1u && st.hdr.faults == MC_OVER_VOLT && st.hdr.source == FAULT_REC_SRC_BRK, "manual freeze");
+  fault_rec_arm();
+  fault_rec_get_status(&st);
+  CHECK(st.armed == 1u && st.frozen == 0u, "clear: armed %u frozen %u", st.armed, st.frozen);
+}
+
+int main(void)
+{
+  test_sim_init();
+
+  test_recording();
+  test_freeze();
+  test_dump();
+  test_reset();
+
+  return test_exit("test_fault_rec");
+}
@@ -0,0 +1,220 @@
+/* Host test for plat/fmac_design.c: Q15 designs and the FMAC datapath model.
+ *
+ * Expectations are independent of the code under test: the FIR taps and the
+ * IIR step responses are reference values from a double-precision design
+ * (same textbook formulas: Hamming windowed sinc, bilinear Butterworth with
+ * prewarp, RBJ notch; recurrence run in double), and fmac_ref_step() must
+ * give an impulse response equal to the designed taps and a DC gain of 1.0 in
+ * Q15. On target, "fmacset verify" compares the model against the FMAC itself.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fmac_design.h"
+#include "test_util.h"
+
+#define FS        16000.0f
+#define N_SAMPLES 4096
+
+/* fc = 1000 Hz, 31 taps: round(h / sum(h) * 32768) of the double-precision design */
+static const int16_t fir31_ref[31] = {
+  -21, -47, -89, -146, -203, -228, -176, 0, 334, 836, 1480, 2205, 2922, 3532, 3941, 4085,
+  3941, 3532, 2922, 2205, 1480, 836, 334, 0, -176, -228, -203, -146, -89, -47, -21
+};
+
+/* Double-precision step responses, rounded: y[n] for a step of amplitude A at n = 0 */
+typedef struct {
+  int n;
+  int y;
+} step_ref_t;
+
+#define STEP_REF_N 15
+static const step_ref_t iir2_300_ref[STEP_REF_N] = {   /* A = 8000 */
+  {0, 26}, {1, 124}, {2, 308}, {3, 562}, {5, 1226}, {8, 2444}, {12, 4137}, {20, 6765},
+  {30, 8167}, {50, 8162}, {80, 7987}, {120, 8000}, {200, 8000}, {400, 8000}, {1000, 8000}
+};
+static const step_ref_t iir1_500_ref[STEP_REF_N] = {   /* A = -12000 */
+  {0, -1076}, {1, -3035}, {2, -4642}, {3, -5962}, {5, -7933}, {8, -9752}, {12, -10980}, {20, -11790},
+  {30, -11971}, {50, -11999}, {80, -12000}, {120, -12000}, {200, -12000}, {400, -12000}, {1000, -12000}
+};
+static const step_ref_t notch_1k_ref[STEP_REF_N] = {   /* f0 = 1000 Hz, Q = 5, A = 8000 */
+  {0, 7705}, {1, 7180}, {2, 6814}, {3, 6649}, {5, 6928}, {8, 8201}, {12, 8964}, {20, 7289},
+  {30, 8296}, {50, 7823}, {80, 7996}, {120, 8000}, {200, 8000}, {400, 8000}, {1000, 8000}
+};
+
+static void model_filter(const fmac_design_t *d, const int16_t *x, int16_t *y, int n)
+{
+  fmac_ref_t s;
+  fmac_ref_reset(&s);
+  for (int i = 0; i < n; i++) {
+    y[i] = fmac_ref_step(&s, d, x[i]);
+  }
+}
+
+/* -1.0 is exact in Q15: (b * -32768) >> 8 >> 7 = -b with R = 0, so y[k] = -b[k] */
+static void check_impulse(const char *name, const fmac_design_t *d)
+{
+  int16_t x[FMAC_DESIGN_MAX_B + 8] = { -32768 };
+  int16_t y[FMAC_DESIGN_MAX_B + 8];
+  const int n = d->nb + 8;
+  CHECK(d->r == 0, "%s: R=%d", name, d->r);
+  model_filter(d, x, y, n);
+  for (int k = 0; k < n; k++) {
+    const int expect = (k < d->nb) ? -d->b[k] : 0;
+    CHECK(y[k] == expect, "%s impulse y[%d]=%d expect %d", name, k, y[k], expect);
+  }
+}
+
+/* Steady-state output over input for a DC input of amp, in Q15 (32768 = 1.0) */
+static int32_t dc_gain_q15(const fmac_design_t *d, int16_t amp)
+{
+  static int16_t x[N_SAMPLES], y[N_SAMPLES];
+  for (int i = 0; i < N_SAMPLES; i++) x[i] = amp;
+  model_filter(d, x, y, N_SAMPLES);
+  return (int32_t)lround(32768.0 * (double)y[N_SAMPLES - 1] / (double)amp);
+}
+
+/* Step response against the double-precision reference, |err| <= tol_lsb + tol_rel * |ref| */
+static void check_step(const char *name, const fmac_design_t *d, int16_t amp, const step_ref_t *ref,
+                       int tol_lsb, double tol_rel)
+{
+  static int16_t x[N_SAMPLES], y[N_SAMPLES];
+  for (int i = 0; i < N_SAMPLES; i++) x[i] = amp;
+  model_filter(d, x, y, N_SAMPLES);
+  for (int i = 0; i < STEP_REF_N; i++) {
+    const int got = y[ref[i].n];
+    const double tol = tol_lsb + tol_rel * fabs((double)ref[i].y);
+    CHECK(fabs((double)(got - ref[i].y)) <= tol, "%s step y[%d]=%d, double %d (tol %.0f)", name, ref[i].n, got,
+          ref[i].y, tol);
+  }
+}
+
+static void gen_sine(int16_t *x, int n, float f, float amp)
+{
+  for (int i = 0; i < n; i++) {
+    x[i] = (int16_t)lrintf(amp * sinf(2.0f * 3.14159265f * f * (float)i / FS));
+  }
+}
+
+/* peak |y| over the second half (past the transient) */
+static int steady_peak(const int16_t *y, int n)
+{
+  int peak = 0;
+  for (int i = n / 2; i < n; i++) {
+    int v = y[i] < 0 ? -y[i] : y[i];
+    if (v > peak) peak = v;
+  }
+  return peak;
+}
+
+static void test_boxcar(void)
+{
+  fmac_design_t d;
+  int16_t x[64], y[64];
+  CHECK(fmac_design_boxcar(&d, 16) == FMAC_DESIGN_OK, "boxcar status");
+  CHECK(d.b[0] == 2048 && d.b[15] == 2048, "boxcar coeffs %d", d.b[0]);
+  check_impulse("boxcar16", &d);
+  CHECK(dc_gain_q15(&d, 16000) == 32768, "boxcar dc gain %ld/32768", (long)dc_gain_q15(&d, 16000));
+
+  for (int i = 0; i < 64; i++) x[i] = 1000;
+  model_filter(&d, x, y, 64);
+  for (int k = 0; k < 64; k++) {
+    int expect = (k < 16) ? (int)floor(62.5 * (k + 1)) : 1000;
+    CHECK(y[k] == expect, "boxcar step y[%d]=%d expect %d", k, y[k], expect);
+  }
+}
+
+static void test_fir(void)
+{
+  fmac_design_t d;
+  static int16_t x[N_SAMPLES], y[N_SAMPLES];
+  fmac_design_status_t st = fmac_design_fir_lowpass(&d, FS, 1000.0f, 31);
+  CHECK(st >= 0, "fir status %d", st);
+
+  /* Rounding residual goes to the centre tap, all others match the double design */
+  for (int i = 0; i < d.nb; i++) {
+    const int tol = (i == (d.nb - 1) / 2) ? d.nb / 4 : 0;
+    CHECK(abs(d.b[i] - fir31_ref[i]) <= tol, "fir b[%d]=%d, double %d", i, d.b[i], fir31_ref[i]);
+  }
+  check_impulse("fir31", &d);
+
+  int32_t sum = 0;
+  for (int i = 0; i < d.nb; i++) sum += d.b[i];
+  CHECK(sum == 32768, "fir sum(b)=%ld", (long)sum);
+  for (int i = 0; i < d.nb / 2; i++) {
+    CHECK(abs(d.b[i] - d.b[d.nb - 1 - i]) <= 1, "fir symmetry b[%d]", i);
+  }
+  CHECK(fabsf(fmac_design_group_delay(&d) - 15.0f) < 0.05f, "fir delay %f",
+        (double)fmac_design_group_delay(&d));
+
+  CHECK(labs(dc_gain_q15(&d, 10000) - 32768) <= 8, "fir dc gain %ld/32768", (long)dc_gain_q15(&d, 10000));
+
+  gen_sine(x, N_SAMPLES, 6000.0f, 16000.0f);
+  model_filter(&d, x, y, N_SAMPLES);
+  CHECK(steady_peak(y, N_SAMPLES) < 160, "fir stopband peak %d", steady_peak(y, N_SAMPLES));
+}
+
+static void test_iir(void)
+{
+  fmac_design_t d;
+  static int16_t x[N_SAMPLES], y[N_SAMPLES];
+
+  CHECK(fmac_design_iir_lowpass(&d, FS, 300.0f, 2) == FMAC_DESIGN_OK, "iir2 status");
+  CHECK(d.kind == FMAC_DESIGN_IIR && d.nb == 3 && d.na == 2 && d.r == 1,
+        "iir2 shape P=%d Q=%d R=%d", d.nb, d.na, d.r);
+  CHECK(fabsf(fmac_design_dc_gain(&d) - 1.0f) < 0.01f, "iir2 dc gain %f",
+        (double)fmac_design_dc_gain(&d));
+
+  /* FMAC truncates q4.22 -> q1.15 inside the feedback loop; at fc=300 Hz the
+   * loop gain 1/(1-sum a) ~ 300 turns that -0.5 LSB bias into ~1.5 % low DC */
+  CHECK(labs(dc_gain_q15(&d, 8000) - 32768) <= 820, "iir2 dc gain %ld/32768", (long)dc_gain_q15(&d, 8000));
+  check_step("iir2", &d, 8000, iir2_300_ref, 2, 0.015);
+
+  gen_sine(x, N_SAMPLES, 3000.0f, 16000.0f);
+  model_filter(&d, x, y, N_SAMPLES);
+  CHECK(steady_peak(y, N_SAMPLES) < 320, "iir2 stopband peak %d", steady_peak(y, N_SAMPLES));
+
+  CHECK(fmac_design_iir_lowpass(&d, FS, 500.0f, 1) == FMAC_DESIGN_OK, "iir1 status");
+  CHECK(d.nb == 2 && d.na == 1, "iir1 shape");
+  CHECK(labs(dc_gain_q15(&d, -12000) - 32768) <= 160, "iir1 dc gain %ld/32768", (long)dc_gain_q15(&d, -12000));
+  check_step("iir1", &d, -12000, iir1_500_ref, 4, 0.0);
+}
+
+static void test_notch(void)
+{
+  fmac_design_t d;
+  static int16_t x[N_SAMPLES], y[N_SAMPLES];
+
+  CHECK(fmac_design_notch(&d, FS, 1000.0f, 5.0f) == FMAC_DESIGN_OK, "notch status");
+  gen_sine(x, N_SAMPLES, 1000.0f, 16000.0f);
+  model_filter(&d, x, y, N_SAMPLES);
+  CHECK(steady_peak(y, N_SAMPLES) < 480, "notch f0 peak %d", steady_peak(y, N_SAMPLES));
+
+  gen_sine(x, N_SAMPLES, 200.0f, 16000.0f);
+  model_filter(&d, x, y, N_SAMPLES);
+  CHECK(steady_peak(y, N_SAMPLES) > 14400, "notch passband peak %d", steady_peak(y, N_SAMPLES));
+  check_step("notch", &d, 8000, notch_1k_ref, 12, 0.0);
+}
+
+static void test_errors(void)
+{
+  fmac_design_t d;
+  CHECK(fmac_design_fir_lowpass(&d, FS, 8000.0f, 31) == FMAC_DESIGN_ERR_ARG, "fir fc>=fs/2");
+  CHECK(fmac_design_fir_lowpass(&d, FS, 1000.0f, 65) == FMAC_DESIGN_ERR_ARG, "fir taps>64");
+  CHECK(fmac_design_boxcar(&d, 1) == FMAC_DESIGN_ERR_ARG, "boxcar taps<2");
+  CHECK(fmac_design_iir_lowpass(&d, FS, 300.0f, 3) == FMAC_DESIGN_ERR_ARG, "iir order 3");
+  CHECK(fmac_design_notch(&d, FS, 1000.0f, 0.0f) == FMAC_DESIGN_ERR_ARG, "notch q=0");
+}
+
+int main(void)
+{
+  test_boxcar();
+  test_fir();
+  test_iir();
+  test_notch();
+  test_errors();
+
+  return test_exit("test_fmac_design");
+}
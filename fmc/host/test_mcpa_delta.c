@@ -0,0 +1,210 @@
+/* Host test for the MCPA delta coded async format.
+ *
+ * Drives the firmware's MCPA_cfgLog / MCPA_dataLog (MCLib mcpa.c, same source
+ * as the target) through a capture-only transport layer, decodes every buffer with
+ * host/mcpa_decode.c and checks the values sample for sample, for raw and
+ * delta buffers and each MF dump mode. Prints the bytes per sample of both
+ * formats on motor-like signals.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcp.h"
+#include "mcpa.h"
+#include "register_interface.h"
+#include "mcpa_decode.h"
+#include "test_util.h"
+
+#define N_STEPS    20000
+#define HF_MAX     8
+#define BUF_SIZE   1024u     /* datalog buffer size asked by the controller */
+#define CAP_MAX    (4u * 1024u * 1024u)
+
+/* ── capture-only transport layer ── */
+static uint8_t tx_buf[2048 + 8] __attribute__((aligned(4)));
+static uint8_t *cap;           /* [u16 len][payload] ... */
+static size_t cap_len;
+static uint32_t cap_packets;
+
+static bool mock_get_buffer(MCTL_Handle_t *h, void **buffer, uint8_t syncAsync)
+{
+  (void)h;
+  (void)syncAsync;
+  *buffer = tx_buf;
+  return true;
+}
+
+static uint8_t mock_send(MCTL_Handle_t *h, void *txBuffer, uint16_t len, uint8_t syncAsync)
+{
+  (void)h;
+  (void)syncAsync;
+  if (cap_len + 2u + len <= CAP_MAX) {
+    memcpy(&cap[cap_len], &len, 2);
+    memcpy(&cap[cap_len + 2u], txBuffer, len);
+    cap_len += 2u + len;
+    cap_packets++;
+  }
+  return 0;
+}
+
+/* ── signals ── */
+static int16_t hf_sig[HF_MAX];
+static uint32_t mf_sig;
+static uint32_t lcg = 1u;
+
+static int32_t noise(int32_t amp)
+{
+  lcg = lcg * 1664525u + 1013904223u;
+  return (int32_t)(lcg >> 16) % (2 * amp + 1) - amp;
+}
+
+/* phase currents / voltages at 50 Hz electrical, 16 kHz HF, a few LSB of noise;
+ * channel 3 (when present) is full-scale noise to hit the 3-byte varints */
+static void update_signals(int step, int hf_num, int with_fast)
+{
+  double t = step / 16000.0;
+  for (int i = 0; i < hf_num; i++) {
+    double ph = 2.0 * M_PI * 50.0 * t - i * 2.0 * M_PI / 3.0;
+    hf_sig[i] = (int16_t)(12000.0 * sin(ph) + noise(6));
+  }
+  if (with_fast && (hf_num > 3)) hf_sig[3] = (int16_t)noise(32767);
+  mf_sig = (uint32_t)step;
+}
+
+typedef struct {
+  size_t bytes;
+  uint32_t samples;
+} run_result_t;
+
+static run_result_t run(uint8_t format, int hf_num, uint8_t mf_rate, int with_fast)
+{
+  static void *ptr_tab[HF_MAX + 1], *ptr_tab_b[HF_MAX + 1];
+  static uint8_t size_tab[HF_MAX + 1], size_tab_b[HF_MAX + 1];
+  static uint16_t prev_tab[2 * (HF_MAX + 1)];
+  static uint16_t fed[N_STEPS][HF_MAX];
+  static uint16_t dec_hf[BUF_SIZE * HF_MAX];
+  static uint32_t dec_mf[BUF_SIZE];
+  run_result_t rr = { 0, 0 };
+
+  MCTL_Handle_t tl = { 0 };
+  tl.fGetBuffer = mock_get_buffer;
+  tl.fSendPacket = mock_send;
+  tl.txAsyncMaxPayload = 2048;
+  tl.txAsyncFormat = format;
+
+  MCPA_Handle_t h = { 0 };
+  h.pTransportLayer = &tl;
+  h.dataPtrTable = ptr_tab;
+  h.dataPtrTableBuff = ptr_tab_b;
+  h.dataSizeTable = size_tab;
+  h.dataSizeTableBuff = size_tab_b;
+  h.deltaPrevTable = prev_tab;
+  h.nbrOfDataLog = HF_MAX + 1;
+
+  /* buffSize, HFRate, HFNum, MFRate, MFNum, IDs, Mark */
+  uint8_t cfg[6 + 2 * (HF_MAX + 1) + 1];
+  uint16_t buff_size = BUF_SIZE;
+  memcpy(cfg, &buff_size, 2);
+  cfg[2] = 0;
+  cfg[3] = (uint8_t)hf_num;
+  cfg[4] = mf_rate;
+  cfg[5] = 1;
+  for (int i = 0; i < hf_num; i++) {
+    uint16_t id = (uint16_t)(MC_REG_I_A | 1u);
+    memcpy(&cfg[6 + 2 * i], &id, 2);
+  }
+  uint16_t mf_id = (uint16_t)(MC_REG_SPEED_MEAS | 1u);
+  memcpy(&cfg[6 + 2 * hf_num], &mf_id, 2);
+  cfg[6 + 2 * (hf_num + 1)] = 0x5A;   /* Mark */
+  CHECK(MCPA_cfgLog(&h, cfg) == MCP_CMD_OK, "cfgLog");
+
+  for (int i = 0; i < hf_num; i++) ptr_tab[i] = &hf_sig[i];
+  ptr_tab[hf_num] = &mf_sig;
+  size_tab[hf_num] = 4;
+
+  cap_len = 0;
+  cap_packets = 0;
+  for (int step = 0; step < N_STEPS; step++) {
+    update_signals(step, hf_num, with_fast);
+    for (int i = 0; i < hf_num; i++) fed[step][i] = (uint16_t)hf_sig[i];
+    GLOBAL_TIMESTAMP = (uint32_t)step;
+    MCPA_dataLog(&h);
+  }
+  MCPA_flushDataLog(&h);
+
+  mcpa_layout_t lay = { 0 };
+  lay.hf_num = (uint8_t)hf_num;
+  lay.mf_num = 1;
+  lay.mf_size[0] = 4;
+  lay.mf_rate = mf_rate;
+
+  uint32_t sample = 0;
+  for (size_t pos = 0; pos < cap_len;) {
+    uint16_t len;
+    memcpy(&len, &cap[pos], 2);
+    const uint8_t *pkt = &cap[pos + 2u];
+    pos += 2u + len;
+    rr.bytes += len;
+
+    mcpa_buffer_info_t info;
+    int rc = mcpa_decode(&lay, pkt, len, dec_hf, sizeof(dec_hf) / 2, dec_mf, sizeof(dec_mf) / 4, &info);
+    CHECK(rc == 0, "decode fmt=%u mf_rate=%u packet len=%u", format, mf_rate, len);
+    if (rc != 0) break;
+    CHECK(len <= BUF_SIZE, "packet longer than buffSize: %u", len);
+    CHECK(info.async_id == format, "async id %u", info.async_id);
+    CHECK(info.mark == 0x5A, "mark %02x", info.mark);
+    CHECK(info.timestamp == sample, "timestamp %u != %u", info.timestamp, sample);
+
+    for (uint32_t s = 0; (s < info.n_samples) && (sample + s < N_STEPS); s++) {
+      for (int i = 0; i < hf_num; i++) {
+        if (dec_hf[s * hf_num + i] != fed[sample + s][i]) {
+          CHECK(0, "fmt=%u sample %u ch %d: %u != %u", format, sample + s, i,
+                dec_hf[s * hf_num + i], fed[sample + s][i]);
+          s = info.n_samples;
+          break;
+        }
+      }
+    }
+    /* MF value is the step it was sampled in */
+    for (uint32_t m = 0; m < info.n_mf; m++) {
+      uint32_t expect = (mf_rate == 254u) ? (sample + info.n_samples - 1u)
+                                          : (sample + m * (mf_rate + 1u) + mf_rate);
+      CHECK(dec_mf[m] == expect, "mf_rate=%u mf %u: %u != %u", mf_rate, m, dec_mf[m], expect);
+    }
+    if (mf_rate == 255u) CHECK(info.n_mf == 0, "MF dumped with mf_rate 255");
+    sample += info.n_samples;
+  }
+  CHECK(sample == N_STEPS, "fmt=%u mf_rate=%u: %u samples decoded, %d fed", format, mf_rate, sample, N_STEPS);
+  rr.samples = sample;
+  return rr;
+}
+
+int main(void)
+{
+  cap = malloc(CAP_MAX);
+  if (cap == NULL) return 1;
+
+  static const uint8_t mf_rates[] = { 0, 3, 254, 255 };
+  for (size_t r = 0; r < sizeof(mf_rates); r++) {
+    (void)run(MCTL_ASYNC_RAW, 4, mf_rates[r], 1);
+    (void)run(MCTL_ASYNC_DELTA, 4, mf_rates[r], 1);
+  }
+
+  printf("%-5s %-6s %10s %10s %8s\n", "hf", "format", "bytes", "B/sample", "ratio");
+  for (int hf = 2; hf <= HF_MAX; hf += 2) {
+    run_result_t raw = run(MCTL_ASYNC_RAW, hf, 255, 0);
+    run_result_t dlt = run(MCTL_ASYNC_DELTA, hf, 255, 0);
+    double ratio = (double)raw.bytes / (double)dlt.bytes;
+    printf("%-5d %-6s %10zu %10.2f %8s\n", hf, "raw", raw.bytes, (double)raw.bytes / raw.samples, "1.00");
+    printf("%-5d %-6s %10zu %10.2f %8.2f\n", hf, "delta", dlt.bytes, (double)dlt.bytes / dlt.samples, ratio);
+    /* slope up to 236 LSB/sample, curvature < 5 LSB/sample^2: the 2nd order
+     * residual is mostly noise and fits one byte */
+    CHECK(ratio > 1.8, "hf=%d: delta only %.2fx smaller", hf, ratio);
+  }
+
+  free(cap);
+  return test_exit("test_mcpa_delta");
+}
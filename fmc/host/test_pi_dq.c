@@ -0,0 +1,193 @@
+/* Host golden-model test for PI_Controller_dq (MCLib/Any/Src/pid_regulator.c).
+ *
+ * The golden model is the MCSDK PI_Controller itself, called for q then d on
+ * a copy of the two handles. Both run over random error sequences with random
+ * gains, divisors and limits; every step must give the same outputs and leave
+ * the same integral terms. Sequences include long saturated stretches and
+ * integral limits at +-INT32_MAX, so the integral overflow check, the integral
+ * clamp and the anti-windup discharge are all exercised.
+ *
+ * pid_regulator.c is compiled into this test with -fwrapv: PI_Controller
+ * detects the integral overflow after a wrapping 32-bit add, as on the
+ * Cortex-M4. The FULL_MISRA_C_COMPLIANCY_PID_REGULATOR build (divisions
+ * instead of shifts) is the test_pi_dq_misra target.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pid_regulator.h"
+#include "test_util.h"
+
+#define SEQUENCES      2000
+#define STEPS          500
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t rnd(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (uint32_t)(rng_state >> 16);
+}
+
+static int32_t rnd_range(int32_t lo, int32_t hi)
+{
+  return lo + (int32_t)(rnd() % (uint32_t)(hi - lo + 1));
+}
+
+/* Random handle in the shapes the MCSDK uses, plus wide limits */
+static void random_handle(PID_Handle_t *h)
+{
+  memset(h, 0, sizeof(*h));
+  const uint16_t kp_pow2 = (uint16_t)rnd_range(4, 15);
+  const uint16_t ki_pow2 = (uint16_t)rnd_range(4, 15);
+  /* Gains spread over magnitudes, not only near INT16_MAX */
+  h->hDefKpGain = (int16_t)(rnd_range(0, INT16_MAX) >> rnd_range(0, 10));
+  h->hDefKiGain = ((rnd() % 8u) == 0u) ? 0 : (int16_t)(rnd_range(0, INT16_MAX) >> rnd_range(0, 10));
+  if ((rnd() % 16u) == 0u) {
+    h->hDefKpGain = (int16_t)-h->hDefKpGain;
+    h->hDefKiGain = (int16_t)-h->hDefKiGain;
+  }
+  h->hKpDivisor = (uint16_t)(1u << kp_pow2);
+  h->hKiDivisor = (uint16_t)(1u << ki_pow2);
+  h->hKpDivisorPOW2 = kp_pow2;
+  h->hKiDivisorPOW2 = ki_pow2;
+
+  switch (rnd() % 3u) {
+    case 0u:
+      /* mc_config.c current loops: +-INT16_MAX x Ki divisor */
+      h->wUpperIntegralLimit = INT16_MAX * (int32_t)h->hKiDivisor;
+      h->wLowerIntegralLimit = -INT16_MAX * (int32_t)h->hKiDivisor;
+      break;
+    case 1u:
+      /* Widest limits the kernel is exact for: the 32-bit overflow check decides */
+      h->wUpperIntegralLimit = INT32_MAX;
+      h->wLowerIntegralLimit = -INT32_MAX;
+      break;
+    default: {
+      const int32_t a = (int32_t)(rnd() & 0x7FFFFFFFu);
+      const int32_t b = (int32_t)(rnd() & 0x7FFFFFFFu);
+      h->wUpperIntegralLimit = a;
+      h->wLowerIntegralLimit = -b;
+      break;
+    }
+  }
+
+  int16_t lo = (int16_t)rnd_range(-INT16_MAX, 0);
+  int16_t hi = (int16_t)rnd_range(0, INT16_MAX);
+  if ((rnd() % 2u) == 0u) {
+    lo = -INT16_MAX;
+    hi = INT16_MAX;
+  }
+  h->hLowerOutputLimit = lo;
+  h->hUpperOutputLimit = hi;
+  PID_HandleInit(h);
+  PID_SetIntegralTerm(h, rnd_range(h->wLowerIntegralLimit / 2, h->wUpperIntegralLimit / 2));
+}
+
+/* Current loop error: Iqdref - Iqd, both int16 */
+static int32_t next_error(int32_t prev, uint32_t mode)
+{
+  switch (mode) {
+    case 0u:
+      return rnd_range(-65535, 65535);
+    case 1u:
+      /* Tracking: small errors around zero */
+      return rnd_range(-300, 300);
+    case 2u: {
+      /* Random walk with steps */
+      int32_t e = prev + rnd_range(-500, 500);
+      if ((rnd() % 64u) == 0u) {
+        e = rnd_range(-65535, 65535);
+      }
+      return (e > 65535) ? 65535 : ((e < -65535) ? -65535 : e);
+    }
+    default:
+      /* Held at one sign: integral runs into its limit / overflows */
+      return (prev >= 0) ? rnd_range(30000, 65535) : rnd_range(-65535, -30000);
+  }
+}
+
+static void test_random(void)
+{
+  uint32_t steps = 0u, sat_out = 0u, overflow = 0u;
+
+  for (int s = 0; (s < SEQUENCES) && (failures < 10); s++) {
+    PID_Handle_t q_ref, d_ref, q_dq, d_dq;
+    random_handle(&q_ref);
+    random_handle(&d_ref);
+    q_dq = q_ref;
+    d_dq = d_ref;
+
+    const uint32_t mode = rnd() % 4u;
+    int32_t eq = rnd_range(-65535, 65535);
+    int32_t ed = rnd_range(-65535, 65535);
+    for (int i = 0; i < STEPS; i++) {
+      eq = next_error(eq, mode);
+      ed = next_error(ed, mode);
+
+      const int64_t sum = (int64_t)q_ref.wIntegralTerm + (int64_t)q_ref.hKiGain * eq;
+      overflow += (q_ref.hKiGain != 0) && ((sum > INT32_MAX) || (sum < INT32_MIN));
+
+      const int16_t vq = PI_Controller(&q_ref, eq);
+      const int16_t vd = PI_Controller(&d_ref, ed);
+      const qd_t v = PI_Controller_dq(&q_dq, &d_dq, eq, ed);
+      steps++;
+      sat_out += (vq == q_ref.hUpperOutputLimit) || (vq == q_ref.hLowerOutputLimit);
+
+      if ((v.q != vq) || (v.d != vd) || (q_dq.wIntegralTerm != q_ref.wIntegralTerm) ||
+          (d_dq.wIntegralTerm != d_ref.wIntegralTerm)) {
+        CHECK(0, "sequence %d step %d: e %ld/%ld -> q %d/%d I %ld/%ld, d %d/%d I %ld/%ld", s, i, (long)eq,
+              (long)ed, v.q, vq, (long)q_dq.wIntegralTerm, (long)q_ref.wIntegralTerm, v.d, vd,
+              (long)d_dq.wIntegralTerm, (long)d_ref.wIntegralTerm);
+        break;
+      }
+    }
+  }
+  /* The sequences must reach the saturating branches, otherwise they prove little */
+  CHECK((sat_out > steps / 10u) && (sat_out < steps - steps / 10u), "output saturated in %u of %u steps",
+        sat_out, steps);
+  CHECK(overflow > 0u, "integral sum never overflowed 32 bits");
+  printf("%u steps, q output saturated %u, q integral overflow %u\n", steps, sat_out, overflow);
+}
+
+/* Integral overflow in both directions, wide limits */
+static void test_overflow(void)
+{
+  PID_Handle_t q_ref, d_ref;
+  memset(&q_ref, 0, sizeof(q_ref));
+  q_ref.hDefKpGain = 0;
+  q_ref.hDefKiGain = INT16_MAX;
+  q_ref.wUpperIntegralLimit = INT32_MAX;
+  q_ref.wLowerIntegralLimit = -INT32_MAX;
+  q_ref.hUpperOutputLimit = INT16_MAX;
+  q_ref.hLowerOutputLimit = -INT16_MAX;
+  q_ref.hKpDivisor = 1u;
+  q_ref.hKiDivisor = 1u << 15;
+  q_ref.hKiDivisorPOW2 = 15u;
+  PID_HandleInit(&q_ref);
+  d_ref = q_ref;
+  PID_SetIntegralTerm(&q_ref, INT32_MAX - 1000);
+  PID_SetIntegralTerm(&d_ref, -INT32_MAX + 1000);
+  PID_Handle_t q_dq = q_ref, d_dq = d_ref;
+
+  const int16_t vq = PI_Controller(&q_ref, 65535);
+  const int16_t vd = PI_Controller(&d_ref, -65535);
+  const qd_t v = PI_Controller_dq(&q_dq, &d_dq, 65535, -65535);
+  CHECK(v.q == vq && v.d == vd, "outputs %d/%d vs %d/%d", v.q, v.d, vq, vd);
+  CHECK(q_dq.wIntegralTerm == q_ref.wIntegralTerm, "positive overflow: %ld vs %ld", (long)q_dq.wIntegralTerm,
+        (long)q_ref.wIntegralTerm);
+  CHECK(d_dq.wIntegralTerm == d_ref.wIntegralTerm, "negative overflow: %ld vs %ld", (long)d_dq.wIntegralTerm,
+        (long)d_ref.wIntegralTerm);
+}
+
+int main(void)
+{
+  test_overflow();
+  test_random();
+
+  return test_exit("test_pi_dq");
+}
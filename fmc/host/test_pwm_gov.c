@@ -0,0 +1,302 @@
+/* Host test for the PWM / FOC rate governor (plat/pwm_gov.c).
+ *
+ * Checks the profile table (nominal profile equal to the MCSDK constants, the
+ * others scaled with the execution rate, stable observer error poles), then runs the motor
+ * in closed loop with the governor in AUTO. Each step covers (RCR+1)/2 PWM
+ * periods of the current TIM1 setting and SysTick is scheduled on timer ticks,
+ * so a profile switch changes the plant time step the way it changes the timer.
+ * The host has no running DWT: HF load is emulated by feeding pwm_gov_hf_record
+ * after each HF task. A lock (what a running FMAC filter takes) must hold the
+ * profile, and a switch in the middle of the HF ramp must keep its remaining time.
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "main.h"
+#include "mc_type.h"
+#include "mc_config.h"
+#include "mc_config_common.h"
+#include "mc_tasks.h"
+#include "mc_api.h"
+#include "mc_interface.h"
+#include "parameters_conversion.h"
+#include "hf_prof.h"
+#include "pwm_gov.h"
+#include "host_periph.h"
+#include "host_pwm.h"
+#include "test_sim.h"
+#include "test_util.h"
+
+#if (PWM_GOV_ENABLE != 1)
+#error "test_pwm_gov needs PWM_GOV_ENABLE=1"
+#endif
+
+static uint32_t hf_load;        /* emulated HF task cycles, 0 = none */
+
+static void record_hf_load(void)
+{
+  if (hf_load != 0u) {
+    pwm_gov_hf_record(hf_load);
+  }
+}
+
+static void ramp_to(double rpm)
+{
+  MC_ProgramSpeedRampMotor1((int16_t)(rpm * SPEED_UNIT / U_RPM), 500u);
+}
+
+static uint8_t active(void)
+{
+  pwm_gov_status_t st;
+  pwm_gov_get_status(&st);
+  return st.active;
+}
+
+/* Observer error dynamics z^2 - s z + p of a profile, normalised to F1/F2 */
+static void obs_poly(const pwm_gov_profile_t *p, double *s, double *q)
+{
+  const double a = (double)p->c1 / F1;
+  const double g1 = (double)p->c2 / F1;
+  const double c = (double)p->c3 / F1;
+  const double g2 = (double)p->c4 / F2;
+  *s = 2.0 - a + g1;
+  *q = 1.0 - a + g1 + c * g2;
+}
+
+/* Largest pole magnitude */
+static double obs_radius(const pwm_gov_profile_t *p)
+{
+  double s, q;
+  obs_poly(p, &s, &q);
+  const double d = s * s - 4.0 * q;
+  if (d < 0.0) {
+    return sqrt(q);
+  }
+  return (fabs(s) + sqrt(d)) / 2.0;
+}
+
+static void test_table(void)
+{
+  const pwm_gov_profile_t *nom = &pwm_gov_profiles[PWM_GOV_NOMINAL];
+
+  CHECK(nom->pwm_hz == PWM_FREQUENCY && nom->rate_hz == TF_REGULATION_RATE && nom->rep == REP_COUNTER,
+        "nominal timing %u Hz / %u Hz / RCR %u", (unsigned)nom->pwm_hz, nom->rate_hz, nom->rep);
+  CHECK(nom->period == PWM_PERIOD_CYCLES, "nominal period %u, want %u", nom->period, PWM_PERIOD_CYCLES);
+  CHECK(nom->c1 == C1 && nom->c2 == C2 && nom->c3 == C3 && nom->c4 == C4 && nom->c5 == C5,
+        "nominal observer constants differ from parameters_conversion.h");
+  CHECK(nom->pll_kp == PLL_KP_GAIN && nom->pll_ki == PLL_KI_GAIN, "nominal PLL gains %d/%d", nom->pll_kp,
+        nom->pll_ki);
+  CHECK(nom->iq_ki == PID_TORQUE_KI_DEFAULT && nom->id_ki == PID_FLUX_KI_DEFAULT, "nominal current Ki");
+  /* Same values as the handles MCboot initialised */
+  CHECK(STO_PLL_M1.hC2 == nom->c2 && STO_PLL_M1.hC4 == nom->c4, "STO_PLL_M1 not nominal");
+
+  for (uint32_t i = 0u; i < PWM_GOV_PROFILES; i++) {
+    const pwm_gov_profile_t *p = &pwm_gov_profiles[i];
+    const double r = (double)TF_REGULATION_RATE / (double)p->rate_hz;
+
+    CHECK(p->rate_hz == (2u * p->pwm_hz) / (p->rep + 1u), "P%u rate %u", i, p->rate_hz);
+    CHECK(p->period == (((uint32_t)ADV_TIM_CLK_MHz * 1000000u / p->pwm_hz) & 0xFFFEu), "P%u period", i);
+    CHECK(i == 0u || pwm_gov_profiles[i - 1u].rate_hz >= p->rate_hz, "profiles must get slower, P%u", i);
+    /* Model terms: within 1 LSB of nominal x ratio, none saturated */
+    CHECK(fabs(p->c1 - C1 * r) <= 1.0 && fabs(p->c3 - C3 * r) <= 1.0 && fabs(p->c5 - C5 * r) <= 1.0,
+          "P%u observer constants %d %d %d", i, p->c1, p->c3, p->c5);
+    CHECK(obs_radius(p) < 0.9, "P%u observer error poles at |z| %.3f", i, obs_radius(p));
+    if (p->rep == REP_COUNTER) {
+      CHECK(fabs(p->c2 - C2 * r) <= 1.0 && fabs(p->c4 - C4 * r) <= 1.0, "P%u observer gains %d %d", i, p->c2,
+            p->c4);
+    } else {
+      /* Decimated by 2: the nominal poles squared, z^2 - (s^2 - 2p) z + p^2 */
+      double s, q, s2, q2;
+      obs_poly(nom, &s, &q);
+      obs_poly(p, &s2, &q2);
+      CHECK(fabs(s2 - (s * s - 2.0 * q)) < 1e-3 && fabs(q2 - q * q) < 1e-3, "P%u observer gains %d %d", i, p->c2,
+            p->c4);
+    }
+    CHECK(fabs(p->pll_kp - PLL_KP_GAIN * r) <= 1.0 && fabs(p->pll_ki - PLL_KI_GAIN * r * r) <= 1.0,
+          "P%u PLL %d/%d", i, p->pll_kp, p->pll_ki);
+    CHECK(fabs(p->iq_ki - PID_TORQUE_KI_DEFAULT * r) <= 1.0, "P%u Iq Ki %d", i, p->iq_ki);
+    printf("P%u %5u Hz PWM RCR %u -> %5u Hz FOC  C1..C5 %5d %6d %5d %5d %5d  |z| %.3f  PLL %d/%d  Ki %d\n", i,
+           (unsigned)p->pwm_hz, p->rep, p->rate_hz, p->c1, p->c2, p->c3, p->c4, p->c5, obs_radius(p), p->pll_kp,
+           p->pll_ki, p->iq_ki);
+  }
+}
+
+static void test_off_holds_nominal(void)
+{
+  /* Default mode OFF: nominal timer setting, nothing switches on its own */
+  (void)MC_StartMotor1();
+  test_sim_run(3.0);
+  CHECK(MC_GetSTMStateMotor1() == RUN, "state %d, faults 0x%04x", (int)MC_GetSTMStateMotor1(),
+        MC_GetOccurredFaultsMotor1());
+  CHECK(active() == PWM_GOV_NOMINAL, "OFF switched to P%u", active());
+  CHECK(LL_TIM_GetAutoReload(TIM1) == PWM_PERIOD_CYCLES / 2u && LL_TIM_GetRepetitionCounter(TIM1) == REP_COUNTER,
+        "TIM1 ARR %u RCR %u", (unsigned)LL_TIM_GetAutoReload(TIM1), (unsigned)LL_TIM_GetRepetitionCounter(TIM1));
+  CHECK(hf_prof_budget_cycles() == PWM_PERIOD_CYCLES, "budget %u", hf_prof_budget_cycles());
+}
+
+static void test_low_speed(void)
+{
+  pwm_gov_set_mode(PWM_GOV_AUTO, 0u);
+  ramp_to(250.0);
+  test_sim_run(1.5);
+
+  const pwm_gov_profile_t *p0 = &pwm_gov_profiles[0];
+  CHECK(active() == 0u, "250 rpm: P%u, want P0", active());
+  CHECK(LL_TIM_GetAutoReload(TIM1) == p0->period / 2u, "TIM1 ARR %u, want %u",
+        (unsigned)LL_TIM_GetAutoReload(TIM1), p0->period / 2u);
+  CHECK(PWM_Handle_M1.Half_PWMPeriod == p0->period / 2u && PWM_Handle_M1._Super.PWMperiod == p0->period,
+        "PWM handle period");
+  CHECK(STO_PLL_M1._Super.hMeasurementFrequency == p0->rate_hz / PWM_FREQ_SCALING, "STO measurement frequency");
+  CHECK(MC_GetSTMStateMotor1() == RUN, "state %d", (int)MC_GetSTMStateMotor1());
+  CHECK(fabs(test_sim_speed_rpm() - 250.0) < 25.0, "plant %.1f rpm at P0", test_sim_speed_rpm());
+  const double obs = (double)SPEED_UNIT_2_RPM(MC_GetMecSpeedAverageMotor1());
+  CHECK(fabs(obs - 250.0) < 25.0, "observer %.1f rpm at P0", obs);
+  printf("P0: plant %.1f rpm, observer %.0f rpm\n", test_sim_speed_rpm(), obs);
+}
+
+static void test_high_speed(void)
+{
+  ramp_to(1200.0);
+  test_sim_run(1.5);
+
+  CHECK(active() == PWM_GOV_NOMINAL, "1200 rpm: P%u, want P1", active());
+  CHECK(LL_TIM_GetAutoReload(TIM1) == PWM_PERIOD_CYCLES / 2u, "TIM1 ARR %u", (unsigned)LL_TIM_GetAutoReload(TIM1));
+  CHECK(STO_PLL_M1.hC1 == C1 && STO_PLL_M1.hC4 == C4 && STO_PLL_M1.PIRegulator.hKiGain == PLL_KI_GAIN,
+        "back at P1 the observer must hold the nominal constants");
+  CHECK(fabs(test_sim_speed_rpm() - 1200.0) < 60.0, "plant %.1f rpm at P1", test_sim_speed_rpm());
+}
+
+static void test_load_backoff(void)
+{
+  /* 85 % of the P1 budget: step down to the decimated profile */
+  hf_load = (pwm_gov_budget_cycles(PWM_GOV_NOMINAL) * 85u) / 100u;
+  test_sim_run(0.1);
+
+  const pwm_gov_profile_t *p2 = &pwm_gov_profiles[2];
+  CHECK(active() == 2u, "overloaded: P%u, want P2", active());
+  CHECK(LL_TIM_GetRepetitionCounter(TIM1) == p2->rep, "TIM1 RCR %u", (unsigned)LL_TIM_GetRepetitionCounter(TIM1));
+  CHECK(hf_prof_budget_cycles() == 2u * PWM_PERIOD_CYCLES, "budget %u at P2", hf_prof_budget_cycles());
+  CHECK(STO_PLL_M1.hC2 == p2->c2 && STO_PLL_M1.hC4 == p2->c4, "observer gains at P2");
+
+  /* Stays there while the load lasts: 85 % of P1 is ~43 % of P2, above the 55 % of P1 */
+  ramp_to(800.0);
+  test_sim_run(1.5);
+  CHECK(active() == 2u, "still loaded: P%u", active());
+  CHECK(MC_GetSTMStateMotor1() == RUN, "state %d, faults 0x%04x", (int)MC_GetSTMStateMotor1(),
+        MC_GetOccurredFaultsMotor1());
+  CHECK(fabs(test_sim_speed_rpm() - 800.0) < 40.0, "plant %.1f rpm at P2", test_sim_speed_rpm());
+  const double obs = (double)SPEED_UNIT_2_RPM(MC_GetMecSpeedAverageMotor1());
+  CHECK(fabs(obs - 800.0) < 40.0, "observer %.1f rpm at P2", obs);
+  printf("P2: plant %.1f rpm, observer %.0f rpm\n", test_sim_speed_rpm(), obs);
+
+  /* Load back to a plain FOC task: speed choice again, but only after PWM_GOV_UP_HOLD */
+  hf_load = 1000u;
+  test_sim_run(0.2);
+  CHECK(active() == 2u, "must hold P2 for PWM_GOV_UP_HOLD, got P%u", active());
+  test_sim_run(0.8);
+  CHECK(active() == PWM_GOV_NOMINAL, "unloaded: P%u, want P1", active());
+  CHECK(MC_GetSTMStateMotor1() == RUN && MC_GetOccurredFaultsMotor1() == 0u, "state %d, faults 0x%04x",
+        (int)MC_GetSTMStateMotor1(), MC_GetOccurredFaultsMotor1());
+  CHECK(fabs(test_sim_speed_rpm() - 800.0) < 40.0, "plant %.1f rpm after P2 -> P1", test_sim_speed_rpm());
+
+  pwm_gov_status_t st;
+  pwm_gov_get_status(&st);
+  printf("switches %u, last load %u%%\n", st.switches, st.load_pct);
+}
+
+static void test_lock(void)
+{
+  pwm_gov_status_t st;
+
+  /* A running FMAC filter holds the profile: 250 rpm wants P0 */
+  pwm_gov_lock(PWM_GOV_LOCK_FMAC_RT, true);
+  ramp_to(250.0);
+  test_sim_run(1.5);
+  pwm_gov_get_status(&st);
+  CHECK(st.locks == PWM_GOV_LOCK_FMAC_RT, "locks 0x%02x", st.locks);
+  CHECK(active() == PWM_GOV_NOMINAL && pwm_gov_pending == PWM_GOV_NONE, "locked: P%u, pending %u", active(),
+        pwm_gov_pending);
+  CHECK(fabs(test_sim_speed_rpm() - 250.0) < 25.0, "plant %.1f rpm locked at P1", test_sim_speed_rpm());
+
+  /* A switch decided before the lock is dropped by the HF task */
+  pwm_gov_pending = 0u;
+  test_sim_step();
+  CHECK(active() == PWM_GOV_NOMINAL && pwm_gov_pending == PWM_GOV_NONE, "pending applied under lock: P%u",
+        active());
+
+  pwm_gov_lock(PWM_GOV_LOCK_FMAC_RT, false);
+  test_sim_run(0.1);
+  CHECK(active() == 0u, "unlocked at 250 rpm: P%u, want P0", active());
+  CHECK(MC_GetSTMStateMotor1() == RUN, "state %d, faults 0x%04x", (int)MC_GetSTMStateMotor1(),
+        MC_GetOccurredFaultsMotor1());
+}
+
+/* Steps until the HF ramp completes, value after half of them */
+static uint32_t ramp_steps(RampExtMngr_Handle_t *r, int32_t *mid)
+{
+  uint32_t n = 0u;
+  const uint32_t half = r->RampRemainingStep / 2u;
+  while (!REMNG_RampCompleted(r)) {
+    const int32_t v = REMNG_Calc(r);
+    if (++n == half) {
+      *mid = v;
+    }
+  }
+  return n;
+}
+
+static void test_ramp_rescale(void)
+{
+  RampExtMngr_Handle_t *r = &RampExtMngrHFParamsM1;
+  int32_t mid = 0;
+
+  /* Idle at P0: switches are applied right away by pwm_gov_step */
+  (void)MC_StopMotor1();
+  test_sim_run(0.5);
+  CHECK(MC_GetSTMStateMotor1() == IDLE, "state %d", (int)MC_GetSTMStateMotor1());
+  CHECK(active() == 0u && r->FrequencyHz == pwm_gov_profiles[0].rate_hz, "P%u, ramp at %u Hz", active(),
+        (unsigned)r->FrequencyHz);
+
+  /* 100 ms ramp at 20 kHz, 40 ms done, then the switch to 8 kHz: 60 ms = 480 steps left */
+  REMNG_Init(r);
+  r->FrequencyHz = pwm_gov_profiles[0].rate_hz;
+  (void)REMNG_ExecRamp(r, 0, 0u);
+  (void)REMNG_ExecRamp(r, 3000, 100u);
+  for (uint32_t i = 0u; i < 800u; i++) {
+    (void)REMNG_Calc(r);
+  }
+  const int32_t at_switch = r->Ext / (int32_t)r->ScalingFactor;
+  pwm_gov_set_mode(PWM_GOV_FIXED, 2u);
+  pwm_gov_step();
+  CHECK(active() == 2u && r->FrequencyHz == pwm_gov_profiles[2].rate_hz, "P%u, ramp at %u Hz", active(),
+        (unsigned)r->FrequencyHz);
+  const uint32_t n = ramp_steps(r, &mid);
+  CHECK(n == 481u, "%u steps left at 8 kHz, want 481", (unsigned)n);
+  CHECK(abs(mid - (at_switch + 3000) / 2) <= 10, "halfway %d, from %d", (int)mid, (int)at_switch);
+  CHECK(r->Ext / (int32_t)r->ScalingFactor == 3000, "ramp ends at %d", (int)(r->Ext / (int32_t)r->ScalingFactor));
+  printf("ramp: %d at the switch, %u steps at 8 kHz, %d halfway\n", (int)at_switch, (unsigned)n, (int)mid);
+
+  /* Finished ramps are left alone */
+  pwm_gov_set_mode(PWM_GOV_FIXED, PWM_GOV_NOMINAL);
+  pwm_gov_step();
+  CHECK(active() == PWM_GOV_NOMINAL && r->RampRemainingStep == 0u, "P%u, %u steps", active(),
+        (unsigned)r->RampRemainingStep);
+}
+
+int main(void)
+{
+  test_sim_init();
+  test_sim_after_hf = record_hf_load;
+
+  test_table();
+  test_off_holds_nominal();
+  test_low_speed();
+  test_high_speed();
+  test_load_backoff();
+  test_lock();
+  test_ramp_rescale();
+
+  return test_exit("test_pwm_gov");
+}
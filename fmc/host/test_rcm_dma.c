@@ -0,0 +1,147 @@
+/* Host test for the DMA backend of the regular conversion manager (RCM_USE_DMA).
+ *
+ * Registers conversions on ADC1 and ADC2 without MCboot, checks the regular
+ * sequences and DMA channels they program, then runs TIM1 updates through the
+ * host ADC/DMA model (host_periph.c) and reads the results back with
+ * RCM_GetRegularConv. The double buffer half selection is checked by placing
+ * the DMA remaining count at each position of a sequence. A conversion on
+ * ADC3 (no DMA sequence) takes the polled path of RCM_ExecRegularConv.
+ */
+#include <stdint.h>
+#include <stdio.h>
+
+#include "mc_type.h"
+#include "mc_config.h"
+#include "regular_conversion_manager.h"
+#include "host_periph.h"
+#include "host_pwm.h"
+#include "test_util.h"
+
+#if (RCM_USE_DMA != 1)
+#error "test_rcm_dma needs RCM_USE_DMA=1"
+#endif
+
+MCI_Handle_t *pMCI[NBR_OF_MOTORS];
+
+/* Four conversions (RCM_MAX_CONV): three on ADC1, one on ADC2, one polled on ADC3 */
+static RegConv_t conv_a = { .regADC = ADC1, .channel = 1, .samplingTime = LL_ADC_SAMPLINGTIME_47CYCLES_5, .data = 0x1110 };
+static RegConv_t conv_b = { .regADC = ADC2, .channel = 5, .samplingTime = LL_ADC_SAMPLINGTIME_47CYCLES_5, .data = 0x2220 };
+static RegConv_t conv_p = { .regADC = ADC3, .channel = 7, .samplingTime = LL_ADC_SAMPLINGTIME_24CYCLES_5, .data = 0x5550 };
+static RegConv_t conv_c = { .regADC = ADC1, .channel = 2, .samplingTime = LL_ADC_SAMPLINGTIME_6CYCLES_5, .data = 0x3330 };
+static RegConv_t conv_d = { .regADC = ADC1, .channel = 11, .samplingTime = LL_ADC_SAMPLINGTIME_6CYCLES_5, .data = 0x4440 };
+
+static void tick(void)
+{
+  static const double no_current[3] = { 0.0, 0.0, 0.0 };
+  host_pwm_sample(no_current);
+}
+
+static void test_register(void)
+{
+  CHECK(RCM_RegisterRegConv(&conv_a), "register a");
+  CHECK(RCM_RegisterRegConv(&conv_b), "register b");
+  /* ADC3 has no DMA port: registered as a polled conversion */
+  CHECK(RCM_RegisterRegConv(&conv_p), "register p on ADC3");
+  /* ADC1 is armed now: the next ones stop and extend its sequence */
+  CHECK(RCM_RegisterRegConv(&conv_c), "register c");
+  CHECK(!RCM_RegisterRegConv(&conv_d), "fifth registration must fail");
+
+  CHECK(LL_ADC_REG_GetSequencerLength(ADC1) == LL_ADC_REG_SEQ_SCAN_ENABLE_2RANKS, "ADC1 sequence length");
+  CHECK(__LL_ADC_CHANNEL_TO_DECIMAL_NB(LL_ADC_REG_GetSequencerRanks(ADC1, LL_ADC_REG_RANK_1)) == 1u, "ADC1 rank 1");
+  CHECK(__LL_ADC_CHANNEL_TO_DECIMAL_NB(LL_ADC_REG_GetSequencerRanks(ADC1, LL_ADC_REG_RANK_2)) == 2u, "ADC1 rank 2");
+  CHECK(LL_ADC_REG_GetSequencerLength(ADC2) == LL_ADC_REG_SEQ_SCAN_DISABLE, "ADC2 sequence length");
+  CHECK(LL_ADC_GetChannelSamplingTime(ADC1, __LL_ADC_DECIMAL_NB_TO_CHANNEL(2)) == LL_ADC_SAMPLINGTIME_6CYCLES_5,
+        "ADC1 channel 2 sampling time");
+
+  /* The polled conversion stays off the DMA and the hardware trigger */
+  CHECK(LL_ADC_GetChannelSamplingTime(ADC3, __LL_ADC_DECIMAL_NB_TO_CHANNEL(7)) == LL_ADC_SAMPLINGTIME_24CYCLES_5,
+        "ADC3 channel 7 sampling time");
+  CHECK(LL_ADC_REG_GetDMATransfer(ADC3) == LL_ADC_REG_DMA_TRANSFER_NONE, "ADC3 DMA transfer");
+  CHECK(LL_ADC_REG_IsConversionOngoing(ADC3) == 0u, "ADC3 not armed");
+
+  ADC_TypeDef *adc[2] = { ADC1, ADC2 };
+  const uint32_t dma_ch[2] = { LL_DMA_CHANNEL_6, LL_DMA_CHANNEL_7 };
+  const uint32_t request[2] = { LL_DMAMUX_REQ_ADC1, LL_DMAMUX_REQ_ADC2 };
+  const uint32_t length[2] = { 4u, 2u };
+  for (int i = 0; i < 2; i++) {
+    CHECK(LL_ADC_REG_GetTriggerSource(adc[i]) == LL_ADC_REG_TRIG_EXT_TIM1_TRGO2, "ADC%d trigger", i + 1);
+    CHECK(LL_ADC_REG_GetDMATransfer(adc[i]) == LL_ADC_REG_DMA_TRANSFER_UNLIMITED, "ADC%d DMA unlimited", i + 1);
+    CHECK(LL_ADC_REG_GetOverrun(adc[i]) == LL_ADC_REG_OVR_DATA_OVERWRITTEN, "ADC%d overrun mode", i + 1);
+    CHECK(LL_ADC_REG_GetContinuousMode(adc[i]) == LL_ADC_REG_CONV_SINGLE, "ADC%d single", i + 1);
+    CHECK(LL_ADC_REG_IsConversionOngoing(adc[i]) != 0u, "ADC%d armed", i + 1);
+    CHECK(LL_DMA_IsEnabledChannel(DMA1, dma_ch[i]) != 0u, "DMA channel for ADC%d enabled", i + 1);
+    CHECK(LL_DMA_GetMode(DMA1, dma_ch[i]) == LL_DMA_MODE_CIRCULAR, "DMA ADC%d circular", i + 1);
+    CHECK(LL_DMA_GetMemoryIncMode(DMA1, dma_ch[i]) == LL_DMA_MEMORY_INCREMENT, "DMA ADC%d memory increment", i + 1);
+    CHECK(LL_DMA_GetPeriphRequest(DMA1, dma_ch[i]) == request[i], "DMA ADC%d request", i + 1);
+    CHECK(LL_DMA_GetDataLength(DMA1, dma_ch[i]) == length[i], "DMA ADC%d length %u, want %u", i + 1,
+          (unsigned)LL_DMA_GetDataLength(DMA1, dma_ch[i]), (unsigned)length[i]);
+    CHECK(LL_DMA_GetPeriphAddress(DMA1, dma_ch[i]) == (uint32_t)(uintptr_t)&adc[i]->DR, "DMA ADC%d source", i + 1);
+  }
+  CHECK((TIM1->CR2 & TIM_CR2_MMS2) == LL_TIM_TRGO2_UPDATE, "TIM1 TRGO2 on update");
+}
+
+static void test_results(void)
+{
+  /* Until the first trigger the registration data is returned */
+  CHECK(RCM_GetRegularConv(&conv_a) == 0x1110u, "a before trigger: 0x%04x", RCM_GetRegularConv(&conv_a));
+  CHECK(RCM_GetRegularConv(&conv_c) == 0x3330u, "c before trigger: 0x%04x", RCM_GetRegularConv(&conv_c));
+  CHECK(RCM_GetRegularConv(&conv_p) == 0x5550u, "p before conversion: 0x%04x", RCM_GetRegularConv(&conv_p));
+
+  for (uint16_t k = 1u; k <= 5u; k++) {
+    host_periph_set_adc(ADC1, 1, (uint16_t)(0x1000u + (k << 4)));
+    host_periph_set_adc(ADC1, 2, (uint16_t)(0x2000u + (k << 4)));
+    host_periph_set_adc(ADC2, 5, (uint16_t)(0x4000u + (k << 4)));
+    tick();
+    CHECK(RCM_GetRegularConv(&conv_a) == 0x1000u + (k << 4), "a after %u triggers: 0x%04x", k, RCM_GetRegularConv(&conv_a));
+    CHECK(RCM_GetRegularConv(&conv_c) == 0x2000u + (k << 4), "c after %u triggers: 0x%04x", k, RCM_GetRegularConv(&conv_c));
+    CHECK(RCM_GetRegularConv(&conv_b) == 0x4000u + (k << 4), "b after %u triggers: 0x%04x", k, RCM_GetRegularConv(&conv_b));
+    CHECK(RCM_ExecRegularConv(&conv_c) == RCM_GetRegularConv(&conv_c), "ExecRegularConv returns the DMA result");
+
+    /* ADC3 converts only on request, the trigger leaves it alone */
+    host_periph_set_adc(ADC3, 7, (uint16_t)(0x5000u + (k << 4)));
+    const uint16_t last_p = (k == 1u) ? 0x5550u : (uint16_t)(0x5000u + ((k - 1u) << 4));
+    CHECK(RCM_GetRegularConv(&conv_p) == last_p, "p before request %u: 0x%04x", k, RCM_GetRegularConv(&conv_p));
+    CHECK(RCM_ExecRegularConv(&conv_p) == 0x5000u + (k << 4), "p polled %u", k);
+    CHECK(RCM_GetRegularConv(&conv_p) == 0x5000u + (k << 4), "p stored %u: 0x%04x", k, RCM_GetRegularConv(&conv_p));
+  }
+
+  /* No trigger without TRGO2: the last results stay */
+  LL_TIM_SetTriggerOutput2(TIM1, LL_TIM_TRGO2_RESET);
+  host_periph_set_adc(ADC1, 1, 0xABC0u);
+  tick();
+  CHECK(RCM_GetRegularConv(&conv_a) == 0x1050u, "a without trigger: 0x%04x", RCM_GetRegularConv(&conv_a));
+  LL_TIM_SetTriggerOutput2(TIM1, LL_TIM_TRGO2_UPDATE);
+}
+
+static void test_half_select(void)
+{
+  /* ADC1 sequence is 2 ranks: half 0 = buf[0..1], half 1 = buf[2..3] */
+  uint16_t *buf = (uint16_t *)(uintptr_t)LL_DMA_GetMemoryAddress(DMA1, LL_DMA_CHANNEL_6);
+  const uint32_t saved = LL_DMA_GetDataLength(DMA1, LL_DMA_CHANNEL_6);
+  for (int r = 0; r < 2; r++) {
+    buf[r] = (uint16_t)(0xA000u + (r << 4));
+    buf[2 + r] = (uint16_t)(0xB000u + (r << 4));
+  }
+  const RegConv_t *rank[2] = { &conv_a, &conv_c };
+  for (uint32_t remaining = 4u; remaining >= 1u; remaining--) {
+    /* remaining 4..3: half 0 being written, read half 1; 2..1: half 1 being written, read half 0 */
+    const uint16_t base = (remaining > 2u) ? 0xB000u : 0xA000u;
+    DMA1_Channel6->CNDTR = remaining;
+    for (int r = 0; r < 2; r++) {
+      uint16_t got = RCM_GetRegularConv(rank[r]);
+      CHECK(got == (uint16_t)(base + (r << 4)), "remaining %u rank %d: 0x%04x", (unsigned)remaining, r, got);
+    }
+  }
+  DMA1_Channel6->CNDTR = saved;
+}
+
+int main(void)
+{
+  host_periph_init();
+
+  test_register();
+  test_results();
+  test_half_select();
+
+  return test_exit("test_rcm_dma");
+}
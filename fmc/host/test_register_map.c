@@ -0,0 +1,223 @@
+/* Host test for the table-driven MCP register map (Src/sync_registers.c).
+ *
+ * Checks the descriptor tables (sorted, rights consistent with the accessors),
+ * drives GET_DATA_ELEMENT / SET_DATA_ELEMENT through the firmware's
+ * MCP_ReceivedPacket, and the register page user command: define, read,
+ * write, and the error answers.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mc_type.h"
+#include "mc_config.h"
+#include "mc_tasks.h"
+#include "mcp.h"
+#include "mcp_config.h"
+#include "register_interface.h"
+#include "host_periph.h"
+#include "test_util.h"
+
+MCI_Handle_t *pMCI[NBR_OF_MOTORS];
+
+/* ── MCP packet helpers ── */
+static MCTL_Handle_t tl;
+static MCP_Handle_t mcp;
+static uint8_t rx_buf[MCP_RX_SYNC_PAYLOAD_MAX];
+static uint8_t tx_buf[MCP_TX_SYNC_PAYLOAD_MAX];
+static uint8_t *pkt;
+
+static void pkt_begin(uint16_t header)
+{
+  pkt = rx_buf;
+  memcpy(pkt, &header, 2);
+  pkt += 2;
+}
+
+static void pkt_u8(uint8_t v) { *pkt++ = v; }
+static void pkt_u16(uint16_t v) { memcpy(pkt, &v, 2); pkt += 2; }
+
+/* Sends the packet, returns the MCP status (last answer byte); the payload is tx_buf[0..len-2] */
+static uint8_t pkt_send(uint16_t *len)
+{
+  mcp.pTransportLayer = &tl;
+  mcp.rxBuffer = rx_buf;
+  mcp.txBuffer = tx_buf;
+  mcp.rxLength = (uint16_t)(pkt - rx_buf);
+  MCP_ReceivedPacket(&mcp);
+  if (len != NULL) *len = mcp.txLength;
+  return tx_buf[mcp.txLength - 1u];
+}
+
+#define M1_ID(reg)   ((uint16_t)((reg) | 1u))
+#define PAGE_HEADER  ((uint16_t)(MCP_USER_CMD | (MCP_USER_CMD_REG_PAGE << 3) | 1u))
+
+static uint16_t get_u16(const uint8_t *p) { uint16_t v; memcpy(&v, p, 2); return v; }
+static uint32_t get_u32(const uint8_t *p) { uint32_t v; memcpy(&v, p, 4); return v; }
+
+static void test_tables(void)
+{
+  for (uint8_t m = 0; m <= NBR_OF_MOTORS; m++) {
+    const RI_RegMap_t *map = RI_GetRegMap(m);
+    CHECK(map != NULL, "no map for motor %u", m);
+    if (map == NULL) continue;
+    for (uint16_t i = 0; i < map->nbrOfReg; i++) {
+      const RI_RegDesc_t *r = &map->table[i];
+      uint8_t type = (uint8_t)(r->regID & TYPE_MASK);
+      if (i > 0) CHECK(map->table[i - 1].regID < r->regID, "motor %u: table not sorted at %u", m, i);
+      CHECK((type >= TYPE_DATA_8BIT) && (type <= TYPE_DATA_32BIT), "motor %u: %04x not scalar", m, r->regID);
+      CHECK((r->access & ~RI_REG_RW) == 0u, "motor %u: %04x bad access", m, r->regID);
+      if (r->set != NULL) CHECK(r->access & RI_REG_W, "motor %u: %04x setter on a read-only reg", m, r->regID);
+      CHECK(RI_FindReg(map, r->regID) == r, "motor %u: lookup of %04x", m, r->regID);
+    }
+  }
+  CHECK(RI_GetRegMap(NBR_OF_MOTORS + 1) == NULL, "map past the last motor");
+}
+
+static void test_get_set(void)
+{
+  uint16_t len;
+
+  /* batched SET: speed KP, Iq KI, Id KP divisor; one global OK */
+  pkt_begin(SET_DATA_ELEMENT);
+  pkt_u16(M1_ID(MC_REG_SPEED_KP));  pkt_u16(1234);
+  pkt_u16(M1_ID(MC_REG_I_Q_KI));    pkt_u16((uint16_t)-77);
+  pkt_u16(M1_ID(MC_REG_I_D_KP_DIV)); pkt_u16(10);
+  CHECK(pkt_send(&len) == MCP_CMD_OK && len == 1u, "batched set");
+  CHECK(PID_GetKP(&PIDSpeedHandle_M1) == 1234, "speed KP %d", PID_GetKP(&PIDSpeedHandle_M1));
+  CHECK(PID_GetKI(&PIDIqHandle_M1) == -77, "Iq KI %d", PID_GetKI(&PIDIqHandle_M1));
+  CHECK(PID_GetKPDivisorPOW2(&PIDIdHandle_M1) == 10, "Id KP div %u", PID_GetKPDivisorPOW2(&PIDIdHandle_M1));
+
+  /* read-only and unknown registers report per access, the valid one is still applied */
+  pkt_begin(SET_DATA_ELEMENT);
+  pkt_u16(M1_ID(MC_REG_BUS_VOLTAGE)); pkt_u16(1);
+  pkt_u16(M1_ID(MC_REG_SPEED_KI));    pkt_u16(321);
+  pkt_u16(M1_ID((5u << ELT_IDENTIFIER_POS) | TYPE_DATA_8BIT)); pkt_u8(0);
+  CHECK(pkt_send(&len) == MCP_CMD_NOK && len == 4u, "set with errors: len %u", len);
+  CHECK(tx_buf[0] == MCP_ERROR_RO_REG && tx_buf[1] == MCP_CMD_OK && tx_buf[2] == MCP_ERROR_UNKNOWN_REG,
+        "set answers %u %u %u", tx_buf[0], tx_buf[1], tx_buf[2]);
+  CHECK(PID_GetKI(&PIDSpeedHandle_M1) == 321, "speed KI %d", PID_GetKI(&PIDSpeedHandle_M1));
+
+  /* batched GET, answer packed in request order */
+  pkt_begin(GET_DATA_ELEMENT);
+  pkt_u16(M1_ID(MC_REG_STATUS));
+  pkt_u16(M1_ID(MC_REG_SPEED_KP));
+  pkt_u16(M1_ID(MC_REG_FAULTS_FLAGS));
+  pkt_u16(M1_ID(MC_REG_BUS_VOLTAGE));
+  CHECK(pkt_send(&len) == MCP_CMD_OK && len == 1u + 2u + 4u + 2u + 1u, "batched get len %u", len);
+  CHECK(tx_buf[0] == (uint8_t)MCI_GetSTMState(&Mci[M1]), "status");
+  CHECK(get_u16(&tx_buf[1]) == 1234u, "speed KP read back %u", get_u16(&tx_buf[1]));
+  CHECK(get_u32(&tx_buf[3]) == MCI_GetFaultState(&Mci[M1]), "faults");
+  CHECK(get_u16(&tx_buf[7]) == VBS_GetAvBusVoltage_V(&BusVoltageSensor_M1._Super), "bus voltage");
+
+  /* every scalar ID answers OK or UNKNOWN_REG on read */
+  for (unsigned t = 1; t <= 3; t++) {
+    for (unsigned e = 0; e < 1024; e++) {
+      pkt_begin(GET_DATA_ELEMENT);
+      pkt_u16((uint16_t)((e << ELT_IDENTIFIER_POS) | (t << TYPE_POS) | 1u));
+      uint8_t st = pkt_send(NULL);
+      CHECK(st == MCP_CMD_OK || st == MCP_ERROR_UNKNOWN_REG, "get %04x: %u", (e << 6) | (t << 3), st);
+    }
+  }
+}
+
+static void test_pages(void)
+{
+  uint16_t len;
+
+  /* telemetry page: Ia, Ib, speed, Iq ref, status */
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_DEFINE); pkt_u8(1);
+  pkt_u16(M1_ID(MC_REG_I_A));
+  pkt_u16(M1_ID(MC_REG_I_B));
+  pkt_u16(M1_ID(MC_REG_SPEED_MEAS));
+  pkt_u16(M1_ID(MC_REG_I_Q_REF));
+  pkt_u16(M1_ID(MC_REG_STATUS));
+  CHECK(pkt_send(&len) == MCP_CMD_OK && len == 1u, "define page");
+
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_READ); pkt_u8(1);
+  CHECK(pkt_send(&len) == MCP_CMD_OK && len == 2u + 2u + 4u + 2u + 1u + 1u, "read page len %u", len);
+  CHECK((int16_t)get_u16(&tx_buf[0]) == MCI_GetIab(&Mci[M1]).a, "page Ia");
+  CHECK((int16_t)get_u16(&tx_buf[8]) == MCI_GetIqdref(&Mci[M1]).q, "page Iq ref");
+  CHECK(tx_buf[10] == (uint8_t)MCI_GetSTMState(&Mci[M1]), "page status");
+
+  /* the page and GET_DATA_ELEMENT agree byte for byte */
+  uint8_t page_copy[16];
+  memcpy(page_copy, tx_buf, 11);
+  pkt_begin(GET_DATA_ELEMENT);
+  pkt_u16(M1_ID(MC_REG_I_A));
+  pkt_u16(M1_ID(MC_REG_I_B));
+  pkt_u16(M1_ID(MC_REG_SPEED_MEAS));
+  pkt_u16(M1_ID(MC_REG_I_Q_REF));
+  pkt_u16(M1_ID(MC_REG_STATUS));
+  CHECK(pkt_send(&len) == MCP_CMD_OK && len == 12u && memcmp(page_copy, tx_buf, 11) == 0, "page vs get");
+
+  /* tuning page written in one command */
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_DEFINE); pkt_u8(2);
+  pkt_u16(M1_ID(MC_REG_I_Q_KP));
+  pkt_u16(M1_ID(MC_REG_I_Q_KI));
+  pkt_u16(M1_ID(MC_REG_STOPLL_KP_DIV));
+  CHECK(pkt_send(NULL) == MCP_CMD_OK, "define tuning page");
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_WRITE); pkt_u8(2);
+  pkt_u16(2000); pkt_u16(150); pkt_u16(4);
+  CHECK(pkt_send(NULL) == MCP_CMD_OK, "write tuning page");
+  CHECK(PID_GetKP(&PIDIqHandle_M1) == 2000 && PID_GetKI(&PIDIqHandle_M1) == 150, "Iq gains");
+  CHECK(PID_GetKPDivisorPOW2(&STO_PLL_M1.PIRegulator) == 4, "PLL KP div");
+
+  /* writes are all or nothing: page 1 holds read-only registers */
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_WRITE); pkt_u8(1);
+  for (int i = 0; i < 11; i++) pkt_u8(0);
+  CHECK(pkt_send(NULL) == MCP_ERROR_RO_REG, "write read-only page");
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_WRITE); pkt_u8(2);
+  pkt_u16(1);
+  CHECK(pkt_send(NULL) == MCP_ERROR_BAD_RAW_FORMAT, "short page write");
+  CHECK(PID_GetKP(&PIDIqHandle_M1) == 2000, "short write applied");
+
+  /* malformed defines leave the page empty */
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_DEFINE); pkt_u8(2);
+  pkt_u16(M1_ID(MC_REG_I_Q_KP));
+  pkt_u16(M1_ID(MC_REG_FW_NAME));
+  CHECK(pkt_send(NULL) == MCP_ERROR_UNKNOWN_REG, "string reg in a page");
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_READ); pkt_u8(2);
+  CHECK(pkt_send(&len) == MCP_CMD_OK && len == 1u, "failed define not emptied");
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_DEFINE); pkt_u8(0);
+  for (unsigned i = 0; i <= RI_PAGE_MAX_REG; i++) pkt_u16(M1_ID(MC_REG_I_A));
+  CHECK(pkt_send(NULL) == MCP_ERROR_BAD_RAW_FORMAT, "page too long");
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_READ); pkt_u8(RI_PAGE_NBR);
+  CHECK(pkt_send(NULL) == MCP_ERROR_BAD_RAW_FORMAT, "page index");
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(7); pkt_u8(0);
+  CHECK(pkt_send(NULL) == MCP_CMD_UNKNOWN, "page op");
+
+  /* global and motor registers mix in a page */
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_DEFINE); pkt_u8(3);
+  pkt_u16((uint16_t)MC_REG_DAC_USER1);
+  pkt_u16(M1_ID(MC_REG_SPEED_REF));
+  CHECK(pkt_send(NULL) == MCP_CMD_OK, "mixed page");
+  pkt_begin(PAGE_HEADER);
+  pkt_u8(RI_PAGE_READ); pkt_u8(3);
+  CHECK(pkt_send(&len) == MCP_CMD_OK && len == 2u + 4u + 1u, "mixed page len %u", len);
+}
+
+int main(void)
+{
+  host_periph_init();
+  MCboot(pMCI);
+  tl.txSyncMaxPayload = MCP_TX_SYNC_PAYLOAD_MAX;
+
+  test_tables();
+  test_get_set();
+  test_pages();
+
+  return test_exit("test_register_map");
+}
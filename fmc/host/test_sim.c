@@ -0,0 +1,68 @@
+/* Closed-loop harness shared by the host tests, see test_sim.h */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "mc_config.h"
+#include "mc_tasks.h"
+#include "mc_interface.h"
+#include "parameters_conversion.h"
+#include "host_periph.h"
+#include "host_pwm.h"
+#include "test_sim.h"
+
+#define SIM_TICK_TICKS  ((uint64_t)(PWM_FREQUENCY / SYS_TICK_FREQUENCY) * PWM_PERIOD_CYCLES)
+
+MCI_Handle_t *pMCI[NBR_OF_MOTORS];
+
+pmsm_params_t test_sim_prm;
+pmsm_state_t test_sim_plant;
+void (*test_sim_after_hf)(void);
+
+static uint64_t systick_acc;
+
+void test_sim_init(void)
+{
+  host_periph_init();
+  pmsm_default_params(&test_sim_prm);
+  pmsm_reset(&test_sim_plant);
+  host_periph_set_vbus(test_sim_prm.vbus);
+
+  MCboot(pMCI);
+}
+
+void test_sim_step(void)
+{
+  double duty[3];
+
+  host_pwm_sample(test_sim_plant.i_abc);
+  (void)TSK_HighFrequencyTask();
+  if (test_sim_after_hf != NULL) {
+    test_sim_after_hf();
+  }
+  const bool on = host_pwm_get_duty(duty);
+  const uint32_t n_pwm = host_pwm_hf_pwm_cycles();
+  test_sim_prm.pwm_period_s = host_pwm_period_s();
+  for (uint32_t i = 0u; i < n_pwm; i++) {
+    pmsm_step(&test_sim_prm, &test_sim_plant, duty, on);
+  }
+  systick_acc += host_pwm_hf_ticks();
+  if (systick_acc >= SIM_TICK_TICKS) {
+    systick_acc -= SIM_TICK_TICKS;
+    MC_RunMotorControlTasks();
+  }
+}
+
+void test_sim_run(double seconds)
+{
+  const double t_end = test_sim_plant.t + seconds;
+  while (test_sim_plant.t < t_end) {
+    test_sim_step();
+  }
+}
+
+double test_sim_speed_rpm(void)
+{
+  return pmsm_speed_rpm(&test_sim_prm, &test_sim_plant);
+}
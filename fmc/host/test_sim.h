@@ -0,0 +1,23 @@
+/* Closed-loop harness shared by the host tests that run M1 on the PMSM plant:
+ * test_sim_step() runs one HF task and the PWM periods until the next one
+ * ((RCR+1)/2 of the current TIM1 setting), SysTick is scheduled on timer ticks,
+ * so a change of the TIM1 setting changes the plant time step as on target.
+ */
+#ifndef TEST_SIM_H
+#define TEST_SIM_H
+
+#include "pmsm_plant.h"
+
+extern pmsm_params_t test_sim_prm;
+extern pmsm_state_t test_sim_plant;
+
+/* Optional, called after every HF task (e.g. to feed an emulated HF load) */
+extern void (*test_sim_after_hf)(void);
+
+/* Peripheral map, default plant, Vbus, MCboot */
+void test_sim_init(void);
+void test_sim_step(void);
+void test_sim_run(double seconds);
+double test_sim_speed_rpm(void);
+
+#endif /* TEST_SIM_H */
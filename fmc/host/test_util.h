@@ -0,0 +1,33 @@
+/* Shared by the host tests: CHECK() counts and prints a failure and goes on,
+ * test_exit() prints the "<name>: ok" / "<name>: N failure(s)" line for ctest.
+ * One test per executable, so the counter lives in the test's translation unit.
+ */
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdio.h>
+
+static int failures;
+
+#define CHECK(cond, ...)                                     \
+  do {                                                       \
+    if (!(cond)) {                                           \
+      failures++;                                            \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__);            \
+      printf(__VA_ARGS__);                                   \
+      printf("\n");                                          \
+    }                                                        \
+  } while (0)
+
+/* Return value for main() */
+static inline int test_exit(const char *name)
+{
+  if (failures != 0) {
+    printf("%s: %d failure(s)\n", name, failures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+#endif /* TEST_UTIL_H */
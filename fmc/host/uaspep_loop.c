@@ -0,0 +1,267 @@
+/*
+ * uaspep_loop.c
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  UASPEP_* 的主机实现，替代 usart_aspep_driver.c 的 DMA/USART 配置，
+ *  中断时序见 uaspep_loop.h。
+ */
+#include <string.h>
+#include "parameters_conversion.h"
+#include "uaspep_loop.h"
+
+#define LOOP_FIFO_SIZE  8192u       /* 2 的幂 */
+#define LOOP_FIFO_MASK  (LOOP_FIFO_SIZE - 1u)
+
+typedef struct
+{
+    uint8_t  buf[LOOP_FIFO_SIZE];
+    uint32_t head;                  /* 写入计数 */
+    uint32_t tail;                  /* 读出计数 */
+} loop_fifo_t;
+
+/* 一个方向的线路：字节按 baud/10 的速率离开 fifo */
+typedef struct
+{
+    loop_fifo_t fifo;
+    uint64_t    acc;                /* 波特率积分，单位 1/(10·PWM_FREQUENCY) 字节 */
+} loop_wire_t;
+
+static struct
+{
+    ASPEP_Handle_t *aspep;
+    uint32_t    baud;
+    loop_wire_t to_fw;              /* Pilot → 固件 */
+    loop_wire_t to_pilot;           /* 固件 → Pilot（含已到达、等 Pilot 读的字节） */
+    loop_fifo_t pilot_in;           /* 已到达 Pilot 的字节 */
+
+    /* RX：DMA + RDR */
+    uint8_t    *rx_dst;
+    uint16_t    rx_remaining;
+    bool        rx_tc;              /* DMA TC 标志，等 SysTick 轮询 */
+    bool        rdr_full;
+    uint8_t     rdr;
+    bool        it_error;           /* USART 错误中断使能 */
+    bool        it_idle;            /* USART IDLE 中断使能 */
+    bool        idle_armed;         /* 清 IDLE 之后又收到过字节 */
+
+    /* TX：DMA 使能期间 CFG_TRANSMISSION 被忽略 */
+    bool        tx_busy;
+} loop;
+
+uaspep_loop_stats_t uaspep_loop_stats;
+
+static uint32_t fifo_used(const loop_fifo_t *f)
+{
+    return f->head - f->tail;
+}
+
+static bool fifo_put(loop_fifo_t *f, const uint8_t *data, uint32_t len)
+{
+    if ((LOOP_FIFO_SIZE - fifo_used(f)) < len)
+    {
+        return false;
+    }
+    for (uint32_t i = 0u; i < len; i++)
+    {
+        f->buf[(f->head + i) & LOOP_FIFO_MASK] = data[i];
+    }
+    f->head += len;
+    return true;
+}
+
+static uint8_t fifo_get(loop_fifo_t *f)
+{
+    uint8_t b = f->buf[f->tail & LOOP_FIFO_MASK];
+    f->tail++;
+    return b;
+}
+
+/* 本周期线路上能走的字节数 */
+static uint32_t wire_budget(loop_wire_t *w)
+{
+    const uint64_t unit = 10u * (uint64_t)PWM_FREQUENCY;
+    w->acc += loop.baud;
+    uint32_t n = (uint32_t)(w->acc / unit);
+    w->acc -= (uint64_t)n * unit;
+    return n;
+}
+
+/* ── ASPEP 硬件回调 ── */
+static void loop_hw_init(void *pHWHandle)
+{
+    (void)pHWHandle;
+    loop.rx_dst       = NULL;
+    loop.rx_remaining = 0u;
+    loop.rx_tc        = false;
+    loop.rdr_full     = false;
+    loop.it_error     = true;   /* UASPEP_RX_INIT */
+    loop.it_idle      = false;
+    loop.tx_busy      = false;
+}
+
+static void loop_hw_sync(void *pHWHandle)
+{
+    (void)pHWHandle;
+    /* UASPEP_IDLE_ENABLE：清 IDLE，下一次空闲要等新的字节之后 */
+    loop.idle_armed = false;
+    loop.it_idle = true;
+}
+
+static void loop_deliver(uint8_t b);
+
+static void loop_cfg_recept(void *pHWHandle, void *buffer, uint16_t length)
+{
+    (void)pHWHandle;
+    loop.rx_dst = (uint8_t *)buffer;
+    loop.rx_remaining = length;
+    loop.rx_tc = false;
+    /* RXNE 还挂着时，通道一使能 DMA 就把 RDR 取走 */
+    if (loop.rdr_full && (length > 0u))
+    {
+        loop.rdr_full = false;
+        loop_deliver(loop.rdr);
+    }
+}
+
+static void loop_cfg_trans(void *pHWHandle, void *data, uint16_t length)
+{
+    (void)pHWHandle;
+    if (loop.tx_busy || !fifo_put(&loop.to_pilot.fifo, (const uint8_t *)data, length))
+    {
+        uaspep_loop_stats.tx_dropped++;
+        return;
+    }
+    loop.tx_busy = true;
+}
+
+/* ── USART RX：DMA 优先，其次 RDR，再来就是 overrun ── */
+static void loop_deliver(uint8_t b)
+{
+    loop.idle_armed = true;
+    if (loop.rx_remaining > 0u)
+    {
+        *loop.rx_dst++ = b;
+        if (--loop.rx_remaining == 0u)
+        {
+            loop.rx_tc = true;
+        }
+    }
+    else if (!loop.rdr_full)
+    {
+        loop.rdr = b;
+        loop.rdr_full = true;
+    }
+    else
+    {
+        uaspep_loop_stats.overruns++;
+        if (loop.it_error)
+        {
+            /* USART2_IRQHandler：关错误中断，改等 IDLE */
+            loop.it_error = false;
+            loop.it_idle = true;
+        }
+    }
+}
+
+static void loop_idle_irq(void)
+{
+    /* USART2_IRQHandler 的 IDLE 分支 */
+    loop.it_idle = false;
+    loop.it_error = true;
+    loop.rdr_full = false;      /* 读掉残留字节 */
+    loop.rx_tc = false;         /* 只处理之后的新包 */
+    uaspep_loop_stats.idle_resets++;
+    ASPEP_HWReset(loop.aspep);
+}
+
+void uaspep_loop_init(ASPEP_Handle_t *pHandle, uint32_t baud)
+{
+    memset(&loop, 0, sizeof(loop));
+    memset(&uaspep_loop_stats, 0, sizeof(uaspep_loop_stats));
+    loop.aspep = pHandle;
+    loop.baud = baud;
+    pHandle->fASPEP_HWInit = &loop_hw_init;
+    pHandle->fASPEP_HWSync = &loop_hw_sync;
+    pHandle->fASPEP_cfg_recept = &loop_cfg_recept;
+    pHandle->fASPEP_cfg_trans = &loop_cfg_trans;
+}
+
+bool uaspep_loop_write(const uint8_t *data, uint16_t len)
+{
+    return fifo_put(&loop.to_fw.fifo, data, len);
+}
+
+uint32_t uaspep_loop_write_pending(void)
+{
+    return fifo_used(&loop.to_fw.fifo);
+}
+
+uint32_t uaspep_loop_read(uint8_t *data, uint32_t max)
+{
+    uint32_t n = 0u;
+    while ((n < max) && (fifo_used(&loop.pilot_in) > 0u))
+    {
+        data[n++] = fifo_get(&loop.pilot_in);
+    }
+    return n;
+}
+
+void uaspep_loop_step(void)
+{
+    /* Pilot → 固件；本周期有空余时间片说明线路空闲过 */
+    uint32_t n = wire_budget(&loop.to_fw);
+    uint32_t sent = 0u;
+    while ((sent < n) && (fifo_used(&loop.to_fw.fifo) > 0u))
+    {
+        loop_deliver(fifo_get(&loop.to_fw.fifo));
+        sent++;
+    }
+    uaspep_loop_stats.rx_bytes += sent;
+    if ((sent < n) && loop.it_idle && loop.idle_armed)
+    {
+        loop_idle_irq();
+    }
+
+    /* 固件 → Pilot；TC 中断里可能马上装填下一包，同一周期继续发 */
+    n = wire_budget(&loop.to_pilot);
+    while (n > 0u)
+    {
+        if (fifo_used(&loop.to_pilot.fifo) > 0u)
+        {
+            uint8_t b = fifo_get(&loop.to_pilot.fifo);
+            (void)fifo_put(&loop.pilot_in, &b, 1u);
+            uaspep_loop_stats.tx_bytes++;
+            n--;
+        }
+        else if (loop.tx_busy)
+        {
+            loop.tx_busy = false;
+            ASPEP_HWDataTransmittedIT(loop.aspep);
+            if (!loop.tx_busy)
+            {
+                break;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+    /* 预算刚好用完时，TC 也在本周期末触发 */
+    if (loop.tx_busy && (fifo_used(&loop.to_pilot.fifo) == 0u))
+    {
+        loop.tx_busy = false;
+        ASPEP_HWDataTransmittedIT(loop.aspep);
+    }
+}
+
+void uaspep_loop_systick(void)
+{
+    if (loop.rx_tc)
+    {
+        loop.rx_tc = false;
+        ASPEP_HWDataReceivedIT(loop.aspep);
+    }
+}
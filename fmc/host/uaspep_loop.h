@@ -0,0 +1,50 @@
+/*
+ * uaspep_loop.h
+ *
+ *  Created on: 2026年2月
+ *      Author: SYRLIST
+ *
+ *  UASPEP（usart_aspep_driver.c）的主机替身：内存里的一条 UART 线路。
+ *  固件侧的 aspep.c / mcp.c / mcpa.c 原样运行，只把 ASPEP_Handle_t 的四个
+ *  硬件回调换成这里的实现；另一端由主机上的 Motor Pilot（aspep_pilot.c）读写。
+ *
+ *  线路模型按 PWM 周期推进，行为对齐 G474 + usart_aspep_driver.c：
+ *    - 10 bit/字节，每个方向按波特率限速
+ *    - RX：DMA 收满后只置 TC，由 SysTick 轮询调用 ASPEP_HWDataReceivedIT
+ *      （stm32_mc_common_it.c）；DMA 未装填时 RDR 只存 1 字节（FIFO 关闭），
+ *      再来的字节记为 overrun，错误中断转开 IDLE 中断
+ *    - IDLE 中断：丢弃 RDR、调用 ASPEP_HWReset，与 USART2_IRQHandler 一致
+ *    - TX：DMA 忙时 CFG_TRANSMISSION 什么也不做；最后一个字节离开线路时
+ *      触发 TC → ASPEP_HWDataTransmittedIT
+ */
+#ifndef UASPEP_LOOP_H_
+#define UASPEP_LOOP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "aspep.h"
+
+typedef struct
+{
+    uint64_t rx_bytes;        /* Pilot → 固件 */
+    uint64_t tx_bytes;        /* 固件 → Pilot */
+    uint64_t overruns;        /* DMA 未装填时丢失的字节 */
+    uint64_t idle_resets;     /* IDLE 中断里的 ASPEP_HWReset 次数 */
+    uint64_t tx_dropped;      /* DMA 忙时被忽略的 CFG_TRANSMISSION */
+} uaspep_loop_stats_t;
+
+extern uaspep_loop_stats_t uaspep_loop_stats;
+
+/* 替换 pHandle 的硬件回调，必须在 MCboot()（ASPEP_start）之前调用 */
+void uaspep_loop_init(ASPEP_Handle_t *pHandle, uint32_t baud);
+
+/* ── Pilot 侧 ── */
+bool     uaspep_loop_write(const uint8_t *data, uint16_t len);    /* 线路排队，满时返回 false */
+uint32_t uaspep_loop_write_pending(void);                         /* 还没发到固件的字节数 */
+uint32_t uaspep_loop_read(uint8_t *data, uint32_t max);           /* 已到达 Pilot 的字节 */
+
+/* ── 固件侧时序 ── */
+void uaspep_loop_step(void);       /* 每个 PWM 周期：线路推进一个周期，处理 TC / IDLE 中断 */
+void uaspep_loop_systick(void);    /* SysTick_Handler 里对 RX DMA TC 的轮询 */
+
+#endif /* UASPEP_LOOP_H_ */